@@ -0,0 +1,209 @@
+#include "benchmarks.h"
+#include "../generators/graph/voxel_generator_graph.h"
+#include "../meshers/blocky/voxel_blocky_library.h"
+#include "../meshers/blocky/voxel_mesher_blocky.h"
+#include "../meshers/cubes/voxel_mesher_cubes.h"
+#include "../meshers/transvoxel/voxel_mesher_transvoxel.h"
+#include "../storage/voxel_buffer_internal.h"
+#include "../streams/voxel_block_serializer.h"
+#include "../util/string_funcs.h"
+
+#include <core/io/file_access.h>
+#include <core/os/time.h>
+#include <core/string/print_string.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace zylann::voxel::benchmarks {
+
+namespace {
+
+const unsigned int WARMUP_REPS = 2;
+const unsigned int MEASURED_REPS = 16;
+const char *CSV_OUTPUT_PATH = "user://voxel_benchmarks.csv";
+
+// All inputs are produced from deterministic closed-form fields instead of engine RNG,
+// so results are reproducible across runs and machines.
+
+inline float get_test_sdf(int x, int y, int z) {
+	return 0.4f * (Math::sin(0.17f * x) + Math::cos(0.23f * y) + Math::sin(0.11f * z)) - 0.05f;
+}
+
+void fill_sdf_buffer(VoxelBufferInternal &vb) {
+	const Vector3i size = vb.get_size();
+	vb.decompress_channel(VoxelBufferInternal::CHANNEL_SDF);
+	for (int z = 0; z < size.z; ++z) {
+		for (int x = 0; x < size.x; ++x) {
+			for (int y = 0; y < size.y; ++y) {
+				vb.set_voxel_f(get_test_sdf(x, y, z), x, y, z, VoxelBufferInternal::CHANNEL_SDF);
+			}
+		}
+	}
+}
+
+void fill_type_buffer(VoxelBufferInternal &vb) {
+	const Vector3i size = vb.get_size();
+	vb.decompress_channel(VoxelBufferInternal::CHANNEL_TYPE);
+	for (int z = 0; z < size.z; ++z) {
+		for (int x = 0; x < size.x; ++x) {
+			for (int y = 0; y < size.y; ++y) {
+				vb.set_voxel(get_test_sdf(x, y, z) < 0.f ? 1 : 0, x, y, z, VoxelBufferInternal::CHANNEL_TYPE);
+			}
+		}
+	}
+}
+
+void fill_color_buffer(VoxelBufferInternal &vb) {
+	const Vector3i size = vb.get_size();
+	vb.decompress_channel(VoxelBufferInternal::CHANNEL_COLOR);
+	for (int z = 0; z < size.z; ++z) {
+		for (int x = 0; x < size.x; ++x) {
+			for (int y = 0; y < size.y; ++y) {
+				// A mix of empty and two opaque colors
+				const float d = get_test_sdf(x, y, z);
+				vb.set_voxel(d < 0.f ? (d < -0.5f ? 0xffff : 0x00ff) : 0, x, y, z, VoxelBufferInternal::CHANNEL_COLOR);
+			}
+		}
+	}
+}
+
+class BenchmarkRecorder {
+public:
+	BenchmarkRecorder() {
+		_csv_lines.push_back("name,reps,min_usec,median_usec,mean_usec,max_usec");
+	}
+
+	template <typename F>
+	void run(const char *name, F f) {
+		for (unsigned int i = 0; i < WARMUP_REPS; ++i) {
+			f();
+		}
+
+		std::vector<uint64_t> times;
+		times.reserve(MEASURED_REPS);
+		for (unsigned int i = 0; i < MEASURED_REPS; ++i) {
+			const uint64_t time_before = Time::get_singleton()->get_ticks_usec();
+			f();
+			times.push_back(Time::get_singleton()->get_ticks_usec() - time_before);
+		}
+		std::sort(times.begin(), times.end());
+
+		uint64_t sum = 0;
+		for (unsigned int i = 0; i < times.size(); ++i) {
+			sum += times[i];
+		}
+		const uint64_t mean = sum / times.size();
+		const uint64_t median = times[times.size() / 2];
+
+		const std::string line = format(
+				"{},{},{},{},{},{}", name, MEASURED_REPS, times.front(), median, mean, times.back());
+		print_line(String(line.c_str()));
+		_csv_lines.push_back(String(line.c_str()));
+	}
+
+	void write_csv(const char *fpath) {
+		Ref<FileAccess> f = FileAccess::open(fpath, FileAccess::WRITE);
+		if (f.is_null()) {
+			print_line(String("Could not write benchmark results to {0}").format(varray(fpath)));
+			return;
+		}
+		for (unsigned int i = 0; i < _csv_lines.size(); ++i) {
+			f->store_line(_csv_lines[i]);
+		}
+		print_line(String("Benchmark results written to {0}").format(varray(fpath)));
+	}
+
+private:
+	std::vector<String> _csv_lines;
+};
+
+void benchmark_mesher(BenchmarkRecorder &recorder, const char *name, Ref<VoxelMesher> mesher,
+		void (*fill_func)(VoxelBufferInternal &)) {
+	const int block_size = 16;
+	const int padded_size = block_size + mesher->get_minimum_padding() + mesher->get_maximum_padding();
+
+	VoxelBufferInternal voxels;
+	voxels.create(padded_size, padded_size, padded_size);
+	fill_func(voxels);
+
+	recorder.run(name, [&mesher, &voxels]() {
+		VoxelMesher::Output output;
+		VoxelMesher::Input input{ voxels, nullptr, nullptr, Vector3i(), 0 };
+		mesher->build(output, input);
+	});
+}
+
+} // namespace
+
+void run_voxel_benchmarks() {
+	print_line("------------ Voxel benchmarks begin -------------");
+
+	BenchmarkRecorder recorder;
+
+	// Transvoxel
+	{
+		Ref<VoxelMesherTransvoxel> mesher;
+		mesher.instantiate();
+		benchmark_mesher(recorder, "transvoxel_build_16", mesher, fill_sdf_buffer);
+	}
+
+	// Blocky
+	{
+		Ref<VoxelBlockyLibrary> library;
+		library.instantiate();
+		library->set_voxel_count(2);
+		library->create_voxel(0, "air");
+		Ref<VoxelBlockyModel> solid = library->create_voxel(1, "solid");
+		solid->set_geometry_type(VoxelBlockyModel::GEOMETRY_CUBE);
+		library->bake();
+
+		Ref<VoxelMesherBlocky> mesher;
+		mesher.instantiate();
+		mesher->set_library(library);
+		benchmark_mesher(recorder, "blocky_build_16", mesher, fill_type_buffer);
+	}
+
+	// Cubes
+	{
+		Ref<VoxelMesherCubes> mesher;
+		mesher.instantiate();
+		mesher->set_greedy_meshing_enabled(true);
+		benchmark_mesher(recorder, "cubes_greedy_build_16", mesher, fill_color_buffer);
+	}
+
+	// Block serialization
+	{
+		VoxelBufferInternal voxels;
+		voxels.create(16, 16, 16);
+		fill_sdf_buffer(voxels);
+
+		recorder.run("serialize_and_compress_16", [&voxels]() {
+			BlockSerializer::SerializeResult result = BlockSerializer::serialize_and_compress(voxels);
+			ZN_ASSERT(result.success);
+		});
+	}
+
+	// Graph generation
+	{
+		Ref<VoxelGeneratorGraph> generator;
+		generator.instantiate();
+		generator->load_plane_preset();
+		const VoxelGraphRuntime::CompilationResult compilation_result = generator->compile(false);
+		ZN_ASSERT(compilation_result.success);
+
+		VoxelBufferInternal voxels;
+		voxels.create(16, 16, 16);
+
+		recorder.run("generator_graph_plane_16", [&generator, &voxels]() {
+			VoxelGenerator::VoxelQueryData query{ voxels, Vector3i(0, -8, 0), 0 };
+			generator->generate_block(query);
+		});
+	}
+
+	recorder.write_csv(CSV_OUTPUT_PATH);
+
+	print_line("------------ Voxel benchmarks end -------------");
+}
+
+} // namespace zylann::voxel::benchmarks
@@ -0,0 +1,8 @@
+#ifndef VOXEL_BENCHMARKS_H
+#define VOXEL_BENCHMARKS_H
+
+namespace zylann::voxel::benchmarks {
+void run_voxel_benchmarks();
+}
+
+#endif // VOXEL_BENCHMARKS_H
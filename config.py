@@ -11,6 +11,10 @@ def configure(env):
     env_vars.Add(BoolVariable("voxel_tests", 
         "Build with tests for the voxel module, which will run on startup of the engine", False))
 
+    env_vars.Add(BoolVariable("voxel_benchmarks",
+        "Build with microbenchmarks for the voxel module, which will run on startup of the engine "
+        "and write CSV results to the user directory", False))
+
     env_vars.Add(BoolVariable("voxel_fast_noise_2", "Build FastNoise2 support", True))
 
     env_vars.Update(env)
@@ -209,4 +209,37 @@ const Vector3i g_ordered_moore_area_3d[MOORE_AREA_3D_COUNT] = { //
 	Vector3i(1, 1, 1)
 };
 
+
+namespace {
+PackedSideInfo build_packed_side_info(unsigned int side) {
+	PackedSideInfo info{};
+	const Vector3i normal = g_side_normals[side];
+	info.normal_x = normal.x;
+	info.normal_y = normal.y;
+	info.normal_z = normal.z;
+	info.axis = normal.x != 0 ? Vector3i::AXIS_X : (normal.y != 0 ? Vector3i::AXIS_Y : Vector3i::AXIS_Z);
+	info.axis_sign = normal[info.axis];
+	for (unsigned int j = 0; j < 4; ++j) {
+		info.corners[j] = g_side_corners[side][j];
+		const unsigned int edge = g_side_edges[side][j];
+		info.edges[j] = edge;
+		info.edge_corners[2 * j] = g_edge_corners[edge][0];
+		info.edge_corners[2 * j + 1] = g_edge_corners[edge][1];
+		info.tangents[j] = g_side_tangents[side][j];
+	}
+	return info;
+}
+} // namespace
+
+// Built from the canonical tables above at static initialization (same translation unit, so
+// order is guaranteed), keeping a single source of truth
+const PackedSideInfo g_packed_side_info[SIDE_COUNT] = {
+	build_packed_side_info(0),
+	build_packed_side_info(1),
+	build_packed_side_info(2),
+	build_packed_side_info(3),
+	build_packed_side_info(4),
+	build_packed_side_info(5),
+};
+
 } //namespace zylann::voxel::Cube
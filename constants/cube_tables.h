@@ -4,6 +4,8 @@
 #include "../util/math/vector3f.h"
 #include "../util/math/vector3i.h"
 
+#include <cstdint>
+
 namespace zylann::voxel::Cube {
 
 // Index convention used in some lookup tables
@@ -79,6 +81,31 @@ extern const Vector3i g_edge_inormals[EDGE_COUNT];
 
 extern const unsigned int g_edge_corners[EDGE_COUNT][2];
 
+// Everything the blocky mesher's per-face loop reads about one side, packed into a single
+// 64-byte cache line. The scattered reads across `g_side_normals`, `g_side_edges`,
+// `g_side_corners` and `g_edge_corners` used to show up as L1 misses in meshing profiles; this
+// collapses them into one line per face, with the edge->corner indirection pre-resolved.
+struct alignas(64) PackedSideInfo {
+	int8_t normal_x;
+	int8_t normal_y;
+	int8_t normal_z;
+	// Axis the side's normal lies on (Vector3i::AXIS_*), and its sign
+	uint8_t axis;
+	int8_t axis_sign;
+	uint8_t padding[3];
+	// = g_side_corners[side]
+	uint8_t corners[4];
+	// = g_side_edges[side]
+	uint8_t edges[4];
+	// Corners of each of the 4 side edges above, flattened: edge j -> [2j], [2j+1]
+	uint8_t edge_corners[8];
+	// = g_side_tangents[side]
+	float tangents[4];
+};
+static_assert(sizeof(PackedSideInfo) == 64, "One cache line per side");
+
+extern const PackedSideInfo g_packed_side_info[SIDE_COUNT];
+
 const unsigned int MOORE_NEIGHBORING_3D_COUNT = 26;
 extern const Vector3i g_moore_neighboring_3d[MOORE_NEIGHBORING_3D_COUNT];
 
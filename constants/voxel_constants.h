@@ -7,6 +7,9 @@ namespace zylann::voxel::constants {
 
 // These constants are chosen so you don't accidentally blow up resource usage
 static const float MINIMUM_LOD_DISTANCE = 16.f;
+// Blocks closer than this to a viewer have updates players directly feel (the block under the
+// shovel); tasks for them classify as latency-critical in the thread pool
+static const float LATENCY_CRITICAL_DISTANCE = 96.f;
 static const float MAXIMUM_LOD_DISTANCE = 128.f;
 
 static const unsigned int MIN_BLOCK_SIZE = 16;
@@ -24,6 +24,7 @@ VoxelStringNames::VoxelStringNames() {
 	_emerge_block = StaticCString::create("_emerge_block");
 	_immerge_block = StaticCString::create("_immerge_block");
 	_generate_block = StaticCString::create("_generate_block");
+	_generate_blocks = StaticCString::create("_generate_blocks");
 	_get_used_channels_mask = StaticCString::create("_get_used_channels_mask");
 
 	block_loaded = StaticCString::create("block_loaded");
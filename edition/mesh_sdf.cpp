@@ -4,6 +4,7 @@
 #include "../util/math/conv.h"
 #include "../util/profiling.h"
 #include "../util/string_funcs.h" // Debug
+#include <algorithm>
 
 namespace zylann::voxel::mesh_sdf {
 
@@ -300,6 +301,145 @@ float get_distance_to_triangle_squared_precalc(const Triangle &t, const Vector3f
 	}
 }
 
+namespace {
+
+inline Vector3f get_triangle_aabb_min(const Triangle &t) {
+	return math::min(t.v1, math::min(t.v2, t.v3));
+}
+
+inline Vector3f get_triangle_aabb_max(const Triangle &t) {
+	return math::max(t.v1, math::max(t.v2, t.v3));
+}
+
+inline float get_distance_to_aabb_squared(const Vector3f aabb_min, const Vector3f aabb_max, const Vector3f pos) {
+	const Vector3f closest( //
+			math::clamp(pos.x, aabb_min.x, aabb_max.x), //
+			math::clamp(pos.y, aabb_min.y, aabb_max.y), //
+			math::clamp(pos.z, aabb_min.z, aabb_max.z));
+	return (closest - pos).length_squared();
+}
+
+} // namespace
+
+uint32_t TriangleBvh::build_node(unsigned int begin, unsigned int end) {
+	Node node;
+	node.aabb_min = get_triangle_aabb_min(*sorted_triangles[begin]);
+	node.aabb_max = get_triangle_aabb_max(*sorted_triangles[begin]);
+	for (unsigned int i = begin + 1; i < end; ++i) {
+		node.aabb_min = math::min(node.aabb_min, get_triangle_aabb_min(*sorted_triangles[i]));
+		node.aabb_max = math::max(node.aabb_max, get_triangle_aabb_max(*sorted_triangles[i]));
+	}
+
+	const uint32_t node_index = nodes.size();
+	nodes.push_back(node);
+
+	const unsigned int count = end - begin;
+	bool is_leaf = count <= LEAF_TRIANGLE_COUNT;
+
+	if (!is_leaf) {
+		// Median split over centroids, along the longest axis of the node
+		const Vector3f node_size = node.aabb_max - node.aabb_min;
+		unsigned int axis = 0;
+		if (node_size.y > node_size.x) {
+			axis = 1;
+		}
+		if (node_size.z > node_size[axis]) {
+			axis = 2;
+		}
+
+		const unsigned int mid = begin + count / 2;
+		std::nth_element(sorted_triangles.begin() + begin, sorted_triangles.begin() + mid,
+				sorted_triangles.begin() + end, [axis](const Triangle *a, const Triangle *b) {
+					return (a->v1[axis] + a->v2[axis] + a->v3[axis]) < (b->v1[axis] + b->v2[axis] + b->v3[axis]);
+				});
+
+		// A degenerate split (all centroids equal) would recurse forever
+		is_leaf = (mid == begin || mid == end);
+
+		if (!is_leaf) {
+			// Note, the vector can reallocate in recursive calls, so the node is accessed by index
+			const uint32_t left_index = build_node(begin, mid);
+			const uint32_t right_index = build_node(mid, end);
+			nodes[node_index].a = left_index;
+			nodes[node_index].b = right_index;
+			nodes[node_index].count = 0;
+		}
+	}
+
+	if (is_leaf) {
+		nodes[node_index].a = begin;
+		nodes[node_index].count = count;
+	}
+
+	return node_index;
+}
+
+void TriangleBvh::build(Span<const Triangle> triangles) {
+	ZN_PROFILE_SCOPE();
+
+	nodes.clear();
+	sorted_triangles.resize(triangles.size());
+	for (unsigned int i = 0; i < triangles.size(); ++i) {
+		sorted_triangles[i] = &triangles[i];
+	}
+
+	if (triangles.size() == 0) {
+		return;
+	}
+
+	nodes.reserve(2 * triangles.size() / LEAF_TRIANGLE_COUNT + 1);
+	build_node(0, triangles.size());
+}
+
+const Triangle *TriangleBvh::get_closest_triangle(const Vector3f pos, float &inout_min_distance_squared) const {
+	if (nodes.size() == 0) {
+		return nullptr;
+	}
+
+	const Triangle *closest_triangle = nullptr;
+
+	// The tree is balanced (median splits), its depth is logarithmic in triangle count
+	FixedArray<uint32_t, 64> stack;
+	unsigned int stack_size = 0;
+	stack[stack_size++] = 0;
+
+	while (stack_size > 0) {
+		const Node &node = nodes[stack[--stack_size]];
+
+		if (get_distance_to_aabb_squared(node.aabb_min, node.aabb_max, pos) >= inout_min_distance_squared) {
+			continue;
+		}
+
+		if (node.count > 0) {
+			for (unsigned int i = node.a; i < node.a + node.count; ++i) {
+				const Triangle &t = *sorted_triangles[i];
+				const float sqd = get_distance_to_triangle_squared_precalc(t, pos);
+				if (sqd < inout_min_distance_squared) {
+					inout_min_distance_squared = sqd;
+					closest_triangle = &t;
+				}
+			}
+
+		} else {
+			// Visit the closest child first so the bound shrinks early and prunes the other
+			const Node &node_a = nodes[node.a];
+			const Node &node_b = nodes[node.b];
+			const float da = get_distance_to_aabb_squared(node_a.aabb_min, node_a.aabb_max, pos);
+			const float db = get_distance_to_aabb_squared(node_b.aabb_min, node_b.aabb_max, pos);
+			ZN_ASSERT(stack_size + 2 <= stack.size());
+			if (da < db) {
+				stack[stack_size++] = node.b;
+				stack[stack_size++] = node.a;
+			} else {
+				stack[stack_size++] = node.a;
+				stack[stack_size++] = node.b;
+			}
+		}
+	}
+
+	return closest_triangle;
+}
+
 void precalc_triangles(Span<Triangle> triangles) {
 	ZN_PROFILE_SCOPE();
 	for (size_t i = 0; i < triangles.size(); ++i) {
@@ -439,6 +579,26 @@ float get_mesh_signed_distance_at(const Vector3f pos, const ChunkGrid &chunk_gri
 	return -d;
 }
 
+float get_mesh_signed_distance_at(const Vector3f pos, const TriangleBvh &bvh) {
+	float min_distance_squared = 9999999.f;
+	const Triangle *closest_tri = bvh.get_closest_triangle(pos, min_distance_squared);
+
+	if (closest_tri == nullptr) {
+		// Empty mesh
+		return Math::sqrt(min_distance_squared);
+	}
+
+	const float d = Math::sqrt(min_distance_squared);
+
+	const Vector3f plane_normal = closest_tri->v13.cross(closest_tri->v1 - closest_tri->v2).normalized();
+	const float plane_d = plane_normal.dot(closest_tri->v1);
+
+	if (plane_normal.dot(pos) > plane_d) {
+		return d;
+	}
+	return -d;
+}
+
 struct GridToSpaceConverter {
 	const Vector3i res;
 	const Vector3f min_pos;
@@ -637,7 +797,8 @@ void generate_mesh_sdf_approx_interp(Span<float> sdf_grid, const Vector3i res, S
 }
 
 void generate_mesh_sdf_naive(Span<float> sdf_grid, const Vector3i res, const Box3i sub_box,
-		Span<const Triangle> triangles, const Vector3f min_pos, const Vector3f max_pos) {
+		Span<const Triangle> triangles, const Vector3f min_pos, const Vector3f max_pos,
+		const std::atomic_bool *validity_flag) {
 	ZN_PROFILE_SCOPE();
 	ZN_ASSERT(Box3i(Vector3i(), res).contains(sub_box));
 	ZN_ASSERT(int64_t(sdf_grid.size()) == Vector3iUtil::get_volume(res));
@@ -651,6 +812,10 @@ void generate_mesh_sdf_naive(Span<float> sdf_grid, const Vector3i res, const Box
 	const Vector3i sub_box_end = sub_box.pos + sub_box.size;
 
 	for (grid_pos.z = sub_box.pos.z; grid_pos.z < sub_box_end.z; ++grid_pos.z) {
+		if (validity_flag != nullptr && !validity_flag->load(std::memory_order_relaxed)) {
+			// The bake result is already dead, stop burning the worker on it
+			return;
+		}
 		for (grid_pos.x = sub_box.pos.x; grid_pos.x < sub_box_end.x; ++grid_pos.x) {
 			grid_pos.y = sub_box.pos.y;
 			size_t grid_index = Vector3iUtil::get_zxy_index(grid_pos, res);
@@ -671,7 +836,8 @@ void generate_mesh_sdf_naive(Span<float> sdf_grid, const Vector3i res, const Box
 }
 
 void generate_mesh_sdf_partitioned(Span<float> sdf_grid, const Vector3i res, const Box3i sub_box,
-		const Vector3f min_pos, const Vector3f max_pos, const ChunkGrid &chunk_grid) {
+		const Vector3f min_pos, const Vector3f max_pos, const ChunkGrid &chunk_grid,
+		const std::atomic_bool *validity_flag) {
 	ZN_PROFILE_SCOPE();
 	ZN_ASSERT(Box3i(Vector3i(), res).contains(sub_box));
 	ZN_ASSERT(int64_t(sdf_grid.size()) == Vector3iUtil::get_volume(res));
@@ -686,6 +852,10 @@ void generate_mesh_sdf_partitioned(Span<float> sdf_grid, const Vector3i res, con
 	const Vector3i sub_box_end = sub_box.pos + sub_box.size;
 
 	for (grid_pos.z = sub_box.pos.z; grid_pos.z < sub_box_end.z; ++grid_pos.z) {
+		if (validity_flag != nullptr && !validity_flag->load(std::memory_order_relaxed)) {
+			// The bake result is already dead, stop burning the worker on it
+			return;
+		}
 		for (grid_pos.x = sub_box.pos.x; grid_pos.x < sub_box_end.x; ++grid_pos.x) {
 			grid_pos.y = sub_box.pos.y;
 			size_t grid_index = Vector3iUtil::get_zxy_index(grid_pos, res);
@@ -702,6 +872,125 @@ void generate_mesh_sdf_partitioned(Span<float> sdf_grid, const Vector3i res, con
 	}
 }
 
+void generate_mesh_sdf_bvh(Span<float> sdf_grid, const Vector3i res, const Box3i sub_box, const TriangleBvh &bvh,
+		const Vector3f min_pos, const Vector3f max_pos, const std::atomic_bool *validity_flag) {
+	ZN_PROFILE_SCOPE();
+	ZN_ASSERT(Box3i(Vector3i(), res).contains(sub_box));
+	ZN_ASSERT(int64_t(sdf_grid.size()) == Vector3iUtil::get_volume(res));
+
+	const Vector3f mesh_size = max_pos - min_pos;
+	const Vector3f cell_size = mesh_size / Vector3f(res.x, res.y, res.z);
+	const GridToSpaceConverter grid_to_space(res, min_pos, mesh_size, cell_size * 0.5f);
+
+	Vector3i grid_pos;
+	const Vector3i sub_box_end = sub_box.pos + sub_box.size;
+
+	for (grid_pos.z = sub_box.pos.z; grid_pos.z < sub_box_end.z; ++grid_pos.z) {
+		if (validity_flag != nullptr && !validity_flag->load(std::memory_order_relaxed)) {
+			// The bake result is already dead, stop burning the worker on it
+			return;
+		}
+		for (grid_pos.x = sub_box.pos.x; grid_pos.x < sub_box_end.x; ++grid_pos.x) {
+			grid_pos.y = sub_box.pos.y;
+			size_t grid_index = Vector3iUtil::get_zxy_index(grid_pos, res);
+
+			for (; grid_pos.y < sub_box_end.y; ++grid_pos.y) {
+				const float sd = get_mesh_signed_distance_at(grid_to_space(grid_pos), bvh);
+
+				ZN_ASSERT(grid_index < sdf_grid.size());
+				sdf_grid[grid_index] = sd;
+
+				++grid_index;
+			}
+		}
+	}
+}
+
+void generate_mesh_sdf_narrow_band(Span<float> sdf_grid, const Vector3i res, const TriangleBvh &bvh,
+		Span<const Triangle> triangles, const Vector3f min_pos, const Vector3f max_pos, int band_cells) {
+	ZN_PROFILE_SCOPE();
+	ZN_ASSERT(int64_t(sdf_grid.size()) == Vector3iUtil::get_volume(res));
+	ZN_ASSERT(band_cells >= 1);
+
+	const Vector3f mesh_size = max_pos - min_pos;
+	const Vector3f cell_size = mesh_size / Vector3f(res.x, res.y, res.z);
+	const GridToSpaceConverter grid_to_space(res, min_pos, mesh_size, cell_size * 0.5f);
+
+	// Cells close to triangles get exact distances
+	std::vector<uint8_t> flag_grid;
+	flag_grid.resize(sdf_grid.size(), FLAG_NOT_VISITED);
+	mark_triangle_hull(to_span(flag_grid), res, triangles, min_pos, max_pos, FLAG_VISITED, band_cells);
+
+	std::vector<Vector3i> current_layer;
+	{
+		ZN_PROFILE_SCOPE_NAMED("Evaluate band");
+		Vector3i grid_pos;
+		for (grid_pos.z = 0; grid_pos.z < res.z; ++grid_pos.z) {
+			for (grid_pos.x = 0; grid_pos.x < res.x; ++grid_pos.x) {
+				grid_pos.y = 0;
+				size_t grid_index = Vector3iUtil::get_zxy_index(grid_pos, res);
+
+				for (; grid_pos.y < res.y; ++grid_pos.y, ++grid_index) {
+					if (flag_grid[grid_index] == FLAG_VISITED) {
+						sdf_grid[grid_index] = get_mesh_signed_distance_at(grid_to_space(grid_pos), bvh);
+						current_layer.push_back(grid_pos);
+					}
+				}
+			}
+		}
+	}
+
+	if (current_layer.size() == 0) {
+		// No triangles, everything is far outside
+		for (size_t i = 0; i < sdf_grid.size(); ++i) {
+			sdf_grid[i] = 9999999.f;
+		}
+		return;
+	}
+
+	// Extend values outward from the band, layer by layer, keeping the sign of the cell they grew
+	// from. Distances beyond the band are approximate, which is fine for stamping since only the
+	// surroundings of the surface matter there.
+	{
+		ZN_PROFILE_SCOPE_NAMED("Extend band");
+
+		FixedArray<Vector3i, 6> dirs;
+		dirs[0] = Vector3i(-1, 0, 0);
+		dirs[1] = Vector3i(1, 0, 0);
+		dirs[2] = Vector3i(0, -1, 0);
+		dirs[3] = Vector3i(0, 1, 0);
+		dirs[4] = Vector3i(0, 0, -1);
+		dirs[5] = Vector3i(0, 0, 1);
+
+		const float step = get_max_sdf_variation(min_pos, max_pos, res);
+
+		std::vector<Vector3i> next_layer;
+		while (current_layer.size() > 0) {
+			for (unsigned int i = 0; i < current_layer.size(); ++i) {
+				const Vector3i pos = current_layer[i];
+				const float v = sdf_grid[Vector3iUtil::get_zxy_index(pos, res)];
+
+				for (unsigned int dir = 0; dir < dirs.size(); ++dir) {
+					const Vector3i npos = pos + dirs[dir];
+					if (npos.x < 0 || npos.y < 0 || npos.z < 0 || npos.x >= res.x || npos.y >= res.y ||
+							npos.z >= res.z) {
+						continue;
+					}
+					const size_t nloc = Vector3iUtil::get_zxy_index(npos, res);
+					if (flag_grid[nloc] == FLAG_VISITED) {
+						continue;
+					}
+					flag_grid[nloc] = FLAG_VISITED;
+					sdf_grid[nloc] = v >= 0.f ? v + step : v - step;
+					next_layer.push_back(npos);
+				}
+			}
+			current_layer.clear();
+			std::swap(current_layer, next_layer);
+		}
+	}
+}
+
 void generate_mesh_sdf_partitioned(Span<float> sdf_grid, const Vector3i res, Span<const Triangle> triangles,
 		const Vector3f min_pos, const Vector3f max_pos, int subdiv) {
 	// TODO Make this thread-local?
@@ -857,16 +1146,23 @@ void GenMeshSDFSubBoxTask::run(ThreadedTaskContext ctx) {
 	Span<float> sdf_grid;
 	ZN_ASSERT(buffer.get_channel_data(channel, sdf_grid));
 
-	if (shared_data->use_chunk_grid) {
-		generate_mesh_sdf_partitioned(
-				sdf_grid, buffer.get_size(), box, shared_data->min_pos, shared_data->max_pos, shared_data->chunk_grid);
+	const std::atomic_bool *validity_flag = shared_data->validity.get();
+
+	if (shared_data->use_bvh) {
+		generate_mesh_sdf_bvh(sdf_grid, buffer.get_size(), box, shared_data->bvh, shared_data->min_pos,
+				shared_data->max_pos, validity_flag);
+	} else if (shared_data->use_chunk_grid) {
+		generate_mesh_sdf_partitioned(sdf_grid, buffer.get_size(), box, shared_data->min_pos, shared_data->max_pos,
+				shared_data->chunk_grid, validity_flag);
 	} else {
 		generate_mesh_sdf_naive(sdf_grid, buffer.get_size(), box, to_span(shared_data->triangles), shared_data->min_pos,
-				shared_data->max_pos);
+				shared_data->max_pos, validity_flag);
 	}
 
+	// The counter must reach zero even for aborted slices, `on_complete` owns the ending
 	if (shared_data->pending_jobs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
-		if (shared_data->boundary_sign_fix) {
+		const bool still_valid = validity_flag == nullptr || validity_flag->load(std::memory_order_relaxed);
+		if (still_valid && shared_data->boundary_sign_fix) {
 			fix_sdf_sign_from_boundary(sdf_grid, buffer.get_size(), shared_data->min_pos, shared_data->max_pos);
 		}
 		// That was the last job
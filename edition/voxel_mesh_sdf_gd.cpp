@@ -127,6 +127,17 @@ void VoxelMeshSDF::bake() {
 		case BAKE_MODE_APPROX_INTERP:
 			mesh_sdf::generate_mesh_sdf_approx_interp(sdf_grid, res, to_span(triangles), box_min_pos, box_max_pos);
 			break;
+		case BAKE_MODE_ACCURATE_BVH: {
+			mesh_sdf::TriangleBvh bvh;
+			bvh.build(to_span(triangles));
+			mesh_sdf::generate_mesh_sdf_bvh(sdf_grid, res, Box3i(Vector3i(), res), bvh, box_min_pos, box_max_pos);
+		} break;
+		case BAKE_MODE_APPROX_NARROW_BAND: {
+			mesh_sdf::TriangleBvh bvh;
+			bvh.build(to_span(triangles));
+			mesh_sdf::generate_mesh_sdf_narrow_band(
+					sdf_grid, res, bvh, to_span(triangles), box_min_pos, box_max_pos, NARROW_BAND_CELLS);
+		} break;
 		default:
 			ZN_CRASH();
 	}
@@ -140,10 +151,23 @@ void VoxelMeshSDF::bake() {
 	_max_pos = box_max_pos;
 }
 
+VoxelMeshSDF::~VoxelMeshSDF() {
+	if (_bake_validity != nullptr) {
+		// In-flight bake slices abort early instead of finishing a result nobody will read
+		*_bake_validity = false;
+	}
+}
+
 void VoxelMeshSDF::bake_async(SceneTree *scene_tree) {
 	ZN_ASSERT_RETURN(scene_tree != nullptr);
 	VoxelServerUpdater::ensure_existence(scene_tree);
 
+	// Re-baking makes the previous bake's result moot, cancel what remains of it
+	if (_bake_validity != nullptr) {
+		*_bake_validity = false;
+	}
+	_bake_validity = make_shared_instance<std::atomic_bool>(true);
+
 	//ZN_ASSERT_RETURN_MSG(!_is_baking, "Already baking");
 
 	struct L {
@@ -162,6 +186,10 @@ void VoxelMeshSDF::bake_async(SceneTree *scene_tree) {
 
 		void on_complete() override {
 			ZN_ASSERT(obj_to_notify.is_valid());
+			if (shared_data->validity != nullptr && !*shared_data->validity) {
+				// Cancelled bake, the buffer is incomplete and a newer bake owns the object
+				return;
+			}
 			L::notify_on_complete(**obj_to_notify, *shared_data);
 		}
 	};
@@ -175,6 +203,7 @@ void VoxelMeshSDF::bake_async(SceneTree *scene_tree) {
 		bool boundary_sign_fix;
 		Array surface;
 		Ref<VoxelMeshSDF> obj_to_notify;
+		std::shared_ptr<std::atomic_bool> validity;
 
 		void run(ThreadedTaskContext ctx) override {
 			ZN_PROFILE_SCOPE();
@@ -182,6 +211,7 @@ void VoxelMeshSDF::bake_async(SceneTree *scene_tree) {
 
 			std::shared_ptr<mesh_sdf::GenMeshSDFSubBoxTask::SharedData> shared_data =
 					make_shared_instance<mesh_sdf::GenMeshSDFSubBoxTask::SharedData>();
+			shared_data->validity = validity;
 			Vector3f min_pos;
 			Vector3f max_pos;
 
@@ -211,8 +241,9 @@ void VoxelMeshSDF::bake_async(SceneTree *scene_tree) {
 
 			switch (bake_mode) {
 				case BAKE_MODE_ACCURATE_NAIVE:
-				case BAKE_MODE_ACCURATE_PARTITIONED: {
-					// These two approaches are better parallelized
+				case BAKE_MODE_ACCURATE_PARTITIONED:
+				case BAKE_MODE_ACCURATE_BVH: {
+					// These approaches are better parallelized
 
 					const bool partitioned = bake_mode == BAKE_MODE_ACCURATE_PARTITIONED;
 					if (partitioned) {
@@ -221,6 +252,11 @@ void VoxelMeshSDF::bake_async(SceneTree *scene_tree) {
 					}
 					shared_data->use_chunk_grid = partitioned;
 
+					if (bake_mode == BAKE_MODE_ACCURATE_BVH) {
+						shared_data->bvh.build(to_span(shared_data->triangles));
+						shared_data->use_bvh = true;
+					}
+
 					shared_data->boundary_sign_fix = boundary_sign_fix;
 
 					// Spawn a parallel task for every Z slice of the grid.
@@ -249,6 +285,21 @@ void VoxelMeshSDF::bake_async(SceneTree *scene_tree) {
 					L::notify_on_complete(**obj_to_notify, *shared_data);
 				} break;
 
+				case BAKE_MODE_APPROX_NARROW_BAND: {
+					// The band extension is a global floodfill, so this one runs as a single task,
+					// but it is also by far the fastest mode
+					VoxelBufferInternal &buffer = shared_data->buffer;
+					Span<float> sdf_grid;
+					ZN_ASSERT(buffer.get_channel_data(channel, sdf_grid));
+					shared_data->bvh.build(to_span(shared_data->triangles));
+					mesh_sdf::generate_mesh_sdf_narrow_band(sdf_grid, res, shared_data->bvh,
+							to_span(shared_data->triangles), box_min_pos, box_max_pos, NARROW_BAND_CELLS);
+					if (boundary_sign_fix) {
+						mesh_sdf::fix_sdf_sign_from_boundary(sdf_grid, res, box_min_pos, box_max_pos);
+					}
+					L::notify_on_complete(**obj_to_notify, *shared_data);
+				} break;
+
 				default:
 					ZN_PRINT_ERROR(format("Invalid bake mode {}", bake_mode));
 					report_error();
@@ -283,6 +334,7 @@ void VoxelMeshSDF::bake_async(SceneTree *scene_tree) {
 	task->partition_subdiv = _partition_subdiv;
 	task->surface = surface;
 	task->obj_to_notify.reference_ptr(this);
+	task->validity = _bake_validity;
 	task->boundary_sign_fix = _boundary_sign_fix;
 	VoxelServer::get_singleton().push_async_task(task);
 }
@@ -436,7 +488,7 @@ void VoxelMeshSDF::_bind_methods() {
 			"set_margin_ratio", "get_margin_ratio");
 
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "bake_mode", PROPERTY_HINT_ENUM,
-						 "AccurateNaive,AccuratePartitioned,ApproxInterp"),
+						 "AccurateNaive,AccuratePartitioned,ApproxInterp,AccurateBVH,ApproxNarrowBand"),
 			"set_bake_mode", "get_bake_mode");
 
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "partition_subdiv", PROPERTY_HINT_RANGE,
@@ -455,6 +507,8 @@ void VoxelMeshSDF::_bind_methods() {
 	BIND_ENUM_CONSTANT(BAKE_MODE_ACCURATE_NAIVE);
 	BIND_ENUM_CONSTANT(BAKE_MODE_ACCURATE_PARTITIONED);
 	BIND_ENUM_CONSTANT(BAKE_MODE_APPROX_INTERP);
+	BIND_ENUM_CONSTANT(BAKE_MODE_ACCURATE_BVH);
+	BIND_ENUM_CONSTANT(BAKE_MODE_APPROX_NARROW_BAND);
 	BIND_ENUM_CONSTANT(BAKE_MODE_COUNT);
 }
 
@@ -2,6 +2,8 @@
 #define VOXEL_MESH_SDF_GD_H
 
 #include "../storage/voxel_buffer_gd.h"
+#include <atomic>
+#include <memory>
 #include "../util/math/vector3f.h"
 
 #include <core/io/resource.h>
@@ -20,9 +22,18 @@ public:
 		BAKE_MODE_ACCURATE_NAIVE,
 		BAKE_MODE_ACCURATE_PARTITIONED,
 		BAKE_MODE_APPROX_INTERP,
+		// Accurate, with distance queries going through a triangle BVH. Fastest accurate mode on
+		// high-poly meshes.
+		BAKE_MODE_ACCURATE_BVH,
+		// Exact distances only within a few cells of the surface, extended with consistent signs
+		// beyond. Fastest mode, good enough for stamping.
+		BAKE_MODE_APPROX_NARROW_BAND,
 		BAKE_MODE_COUNT
 	};
 
+	// How many cells around triangles get exact distances in narrow-band mode
+	static const int NARROW_BAND_CELLS = 4;
+
 	static const int MIN_CELL_COUNT = 2;
 	static const int MAX_CELL_COUNT = 256;
 
@@ -61,6 +72,8 @@ public:
 	// It is currently needed to ensure `VoxelServerUpdater` gets created so it can tick the task system...
 	void bake_async(SceneTree *scene_tree);
 
+	~VoxelMeshSDF();
+
 	Ref<gd::VoxelBuffer> get_voxel_buffer() const;
 	AABB get_aabb() const;
 
@@ -74,6 +87,10 @@ private:
 
 	static void _bind_methods();
 
+	// Cooperative cancellation of in-flight bakes: re-baking or destroying the resource flips
+	// the previous flag false, and bake slices abort early instead of finishing a dead result
+	std::shared_ptr<std::atomic_bool> _bake_validity;
+
 	// Data
 	Ref<gd::VoxelBuffer> _voxel_buffer;
 	Vector3f _min_pos;
@@ -235,6 +235,14 @@ void VoxelTool::sdf_stamp_erase(Ref<gd::VoxelBuffer> stamp, Vector3i pos) {
 	_post_edit(box);
 }
 
+void VoxelTool::do_spheres(PackedVector3Array centers, PackedFloat32Array radii) {
+	ZN_PROFILE_SCOPE();
+	ERR_FAIL_COND_MSG(centers.size() != radii.size(), "There must be as many centers as radii");
+	for (int i = 0; i < centers.size(); ++i) {
+		do_sphere(centers[i], radii[i]);
+	}
+}
+
 void VoxelTool::do_box(Vector3i begin, Vector3i end) {
 	ZN_PROFILE_SCOPE();
 	Vector3iUtil::sort_min_max(begin, end);
@@ -290,6 +298,38 @@ uint64_t VoxelTool::_b_get_voxel(Vector3i pos) {
 	return get_voxel(pos);
 }
 
+void VoxelTool::get_voxel_f_series(Span<const Vector3i> positions, Span<float> out_values) const {
+	ZN_ASSERT_RETURN(positions.size() == out_values.size());
+	_get_voxel_f_series(positions, out_values);
+}
+
+uint32_t VoxelTool::get_block_edit_version(Vector3i block_position) const {
+	return 0;
+}
+
+void VoxelTool::_get_voxel_f_series(Span<const Vector3i> positions, Span<float> out_values) const {
+	// Generic fallback; terrain tools override this with block-grouped lookups
+	for (unsigned int i = 0; i < positions.size(); ++i) {
+		out_values[i] = _get_voxel_f(positions[i]);
+	}
+}
+
+PackedFloat32Array VoxelTool::_b_get_voxel_f_series(PackedVector3Array positions) {
+	PackedFloat32Array values;
+	if (positions.size() == 0) {
+		return values;
+	}
+	static thread_local std::vector<Vector3i> tls_positions;
+	tls_positions.resize(positions.size());
+	const Vector3 *src = positions.ptr();
+	for (int i = 0; i < positions.size(); ++i) {
+		tls_positions[i] = math::floor_to_int(src[i]);
+	}
+	values.resize(positions.size());
+	get_voxel_f_series(to_span_const(tls_positions), Span<float>(values.ptrw(), values.size()));
+	return values;
+}
+
 float VoxelTool::_b_get_voxel_f(Vector3i pos) {
 	return get_voxel_f(pos);
 }
@@ -378,10 +418,14 @@ void VoxelTool::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_voxel", "pos"), &VoxelTool::_b_get_voxel);
 	ClassDB::bind_method(D_METHOD("get_voxel_f", "pos"), &VoxelTool::_b_get_voxel_f);
+	ClassDB::bind_method(D_METHOD("get_voxel_f_series", "positions"), &VoxelTool::_b_get_voxel_f_series);
+	ClassDB::bind_method(
+			D_METHOD("get_block_edit_version", "block_position"), &VoxelTool::get_block_edit_version);
 	ClassDB::bind_method(D_METHOD("set_voxel", "pos", "v"), &VoxelTool::_b_set_voxel);
 	ClassDB::bind_method(D_METHOD("set_voxel_f", "pos", "v"), &VoxelTool::_b_set_voxel_f);
 	ClassDB::bind_method(D_METHOD("do_point", "pos"), &VoxelTool::_b_do_point);
 	ClassDB::bind_method(D_METHOD("do_sphere", "center", "radius"), &VoxelTool::_b_do_sphere);
+	ClassDB::bind_method(D_METHOD("do_spheres", "centers", "radii"), &VoxelTool::do_spheres);
 	ClassDB::bind_method(D_METHOD("do_box", "begin", "end"), &VoxelTool::_b_do_box);
 
 	ClassDB::bind_method(D_METHOD("set_voxel_metadata", "pos", "meta"), &VoxelTool::_b_set_voxel_metadata);
@@ -4,6 +4,7 @@
 #include "../storage/funcs.h"
 #include "../util/math/box3i.h"
 #include "../util/math/sdf.h"
+#include "../util/span.h"
 #include "funcs.h"
 #include "voxel_raycast_result.h"
 
@@ -45,6 +46,16 @@ public:
 	uint64_t get_voxel(Vector3i pos) const;
 	float get_voxel_f(Vector3i pos) const;
 
+	// Batched sampling: fills `out_values` with the value at each position, in one call.
+	// Implementations group lookups by block and take each lock once, so per-entity query
+	// clusters (vehicle suspension, foot IK) don't pay map lookup and locking per sample.
+	void get_voxel_f_series(Span<const Vector3i> positions, Span<float> out_values) const;
+
+	// Edit version of the data block at the given BLOCK position, for network delta replication
+	// (see VoxelBlockSerializer.serialize_delta). 0 when the block isn't loaded or the tool
+	// doesn't support it.
+	virtual uint32_t get_block_edit_version(Vector3i block_position) const;
+
 	float get_sdf_scale() const;
 	void set_sdf_scale(float s);
 
@@ -67,6 +78,9 @@ public:
 	virtual void do_line(Vector3i begin, Vector3i end);
 	virtual void do_circle(Vector3i pos, int radius, Vector3i direction);
 	virtual void do_sphere(Vector3 center, float radius);
+	// Applies a whole list of spheres in one call, using the same mode and settings as `do_sphere`.
+	// Scripted mass edits then cross the script boundary once instead of once per shape.
+	void do_spheres(PackedVector3Array centers, PackedFloat32Array radii);
 	virtual void do_box(Vector3i begin, Vector3i end);
 
 	void sdf_stamp_erase(Ref<gd::VoxelBuffer> stamp, Vector3i pos);
@@ -90,6 +104,7 @@ protected:
 	// They don't represent an edit, they only abstract the lower-level API
 	virtual uint64_t _get_voxel(Vector3i pos) const;
 	virtual float _get_voxel_f(Vector3i pos) const;
+	virtual void _get_voxel_f_series(Span<const Vector3i> positions, Span<float> out_values) const;
 	virtual void _set_voxel(Vector3i pos, uint64_t v);
 	virtual void _set_voxel_f(Vector3i pos, float v);
 	virtual void _post_edit(const Box3i &box);
@@ -100,6 +115,7 @@ private:
 
 	uint64_t _b_get_voxel(Vector3i pos);
 	float _b_get_voxel_f(Vector3i pos);
+	PackedFloat32Array _b_get_voxel_f_series(PackedVector3Array positions);
 	void _b_set_voxel(Vector3i pos, uint64_t v);
 	void _b_set_voxel_f(Vector3i pos, float v);
 	Ref<VoxelRaycastResult> _b_raycast(Vector3 pos, Vector3 dir, float max_distance, uint32_t collision_mask);
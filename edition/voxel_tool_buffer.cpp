@@ -38,6 +38,38 @@ void VoxelToolBuffer::do_sphere(Vector3 center, float radius) {
 	_post_edit(box);
 }
 
+namespace {
+// Copies raw values from a packed array laid out in ZXY order over the target box
+struct SetRawValuesOp {
+	const int64_t *values;
+	Vector3i box_pos;
+	Vector3i box_size;
+
+	template <typename T>
+	inline T operator()(Vector3i pos, T) const {
+		const size_t i = Vector3iUtil::get_zxy_index(pos - box_pos, box_size);
+		return T(values[i]);
+	}
+};
+} // namespace
+
+void VoxelToolBuffer::set_raw_values_box(Vector3i box_min, Vector3i box_size, PackedInt64Array values) {
+	ZN_PROFILE_SCOPE();
+	ERR_FAIL_COND(_buffer.is_null());
+
+	const Box3i box(box_min, box_size);
+	ERR_FAIL_COND_MSG(!is_area_editable(box), "Box is not fully inside the buffer");
+	ERR_FAIL_COND_MSG(values.size() != Vector3iUtil::get_volume(box_size),
+			"The amount of values must match the volume of the box");
+	if (values.size() == 0) {
+		return;
+	}
+
+	_buffer->get_buffer().write_box(box, _channel, SetRawValuesOp{ values.ptr(), box_min, box_size }, Vector3i());
+
+	_post_edit(box);
+}
+
 uint64_t VoxelToolBuffer::_get_voxel(Vector3i pos) const {
 	ERR_FAIL_COND_V(_buffer.is_null(), 0);
 	return _buffer->get_buffer().get_voxel(pos, _channel);
@@ -128,4 +160,9 @@ void VoxelToolBuffer::paste(
 			p_voxels->get_buffer(), Box3i(Vector3i(), p_voxels->get_buffer().get_size()), p_pos);
 }
 
+void VoxelToolBuffer::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_raw_values_box", "box_min", "box_size", "values"),
+			&VoxelToolBuffer::set_raw_values_box);
+}
+
 } // namespace zylann::voxel
@@ -20,7 +20,15 @@ public:
 
 	void do_sphere(Vector3 center, float radius) override;
 
+	// Writes a packed span of raw values over a box of the current channel, in one native call.
+	// Values are laid out in ZXY order (z-major, y-minor), like VoxelBuffer memory, and their size
+	// must match the box volume. Meant for scripted mass edits, which would otherwise pay a script
+	// call per voxel.
+	void set_raw_values_box(Vector3i box_min, Vector3i box_size, PackedInt64Array values);
+
 protected:
+	static void _bind_methods();
+
 	uint64_t _get_voxel(Vector3i pos) const override;
 	float _get_voxel_f(Vector3i pos) const override;
 	void _set_voxel(Vector3i pos, uint64_t v) override;
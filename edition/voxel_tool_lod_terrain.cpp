@@ -9,6 +9,7 @@
 #include "../util/tasks/async_dependency_tracker.h"
 #include "../util/voxel_raycast.h"
 #include "funcs.h"
+#include "sdf_row_kernels.h"
 #include "voxel_mesh_sdf_gd.h"
 
 #include <scene/3d/collision_shape_3d.h>
@@ -100,19 +101,88 @@ Ref<VoxelRaycastResult> VoxelToolLodTerrain::raycast(
 	struct RaycastPredicate {
 		VoxelLodTerrain *terrain;
 
+		// The DDA tests voxels one by one, and most rays cross many voxels of the same block, so
+		// paying a map lookup and a lock per voxel adds up fast with hundreds of rays per frame.
+		// We cache information about the last visited block: blocks that are uniform in the SDF
+		// channel answer every voxel they contain without touching the map again, and non-uniform
+		// blocks are sampled directly. Only blocks that aren't loaded at LOD0 use the generic
+		// fallback, which can look at lower LODs or the generator.
+		enum BlockState { //
+			BLOCK_AIR,
+			BLOCK_MATTER,
+			BLOCK_MIXED,
+			BLOCK_FALLBACK
+		};
+		std::shared_ptr<VoxelDataLodMap> data;
+		Box3i bounds_in_voxels;
+		unsigned int block_size_po2;
+		bool has_cached_block = false;
+		Vector3i cached_block_pos;
+		BlockState cached_block_state = BLOCK_FALLBACK;
+		std::shared_ptr<VoxelBufferInternal> cached_voxels;
+
 		bool operator()(Vector3i pos) {
-			// This is not particularly optimized, but runs fast enough for player raycasts
-			VoxelSingleValue defval;
-			defval.f = 1.f;
-			const VoxelSingleValue v = terrain->get_voxel(pos, VoxelBufferInternal::CHANNEL_SDF, defval);
-			return v.f < 0;
+			if (!bounds_in_voxels.contains(pos)) {
+				// Outside bounds is air, like the default value of the generic fallback
+				return false;
+			}
+
+			const Vector3i bpos = pos >> block_size_po2;
+			if (!has_cached_block || bpos != cached_block_pos) {
+				VoxelDataLodMap::Lod &data_lod0 = data->lods[0];
+				std::shared_ptr<VoxelBufferInternal> voxels;
+				{
+					RWLockRead rlock(data_lod0.map_lock);
+					const VoxelDataBlock *block = data_lod0.map.get_block(bpos);
+					if (block != nullptr) {
+						voxels = block->get_voxels_shared();
+					}
+				}
+				has_cached_block = true;
+				cached_block_pos = bpos;
+				cached_voxels = nullptr;
+				if (voxels == nullptr) {
+					cached_block_state = BLOCK_FALLBACK;
+				} else {
+					RWLockRead vlock(voxels->get_lock());
+					if (voxels->get_channel_compression(VoxelBufferInternal::CHANNEL_SDF) ==
+							VoxelBufferInternal::COMPRESSION_UNIFORM) {
+						const float sdf = voxels->get_voxel_f(0, 0, 0, VoxelBufferInternal::CHANNEL_SDF);
+						cached_block_state = sdf < 0.f ? BLOCK_MATTER : BLOCK_AIR;
+					} else {
+						cached_block_state = BLOCK_MIXED;
+						cached_voxels = voxels;
+					}
+				}
+			}
+
+			switch (cached_block_state) {
+				case BLOCK_AIR:
+					return false;
+				case BLOCK_MATTER:
+					return true;
+				case BLOCK_MIXED: {
+					const Vector3i rpos = data->lods[0].map.to_local(pos);
+					RWLockRead vlock(cached_voxels->get_lock());
+					return cached_voxels->get_voxel_f(rpos.x, rpos.y, rpos.z, VoxelBufferInternal::CHANNEL_SDF) < 0.f;
+				}
+				default: {
+					// Not loaded at LOD0, sample the slow way (lower LODs, or the generator in full
+					// load mode)
+					VoxelSingleValue defval;
+					defval.f = 1.f;
+					const VoxelSingleValue v = terrain->get_voxel(pos, VoxelBufferInternal::CHANNEL_SDF, defval);
+					return v.f < 0;
+				}
+			}
 		}
 	};
 
 	Ref<VoxelRaycastResult> res;
 
 	// We use grid-raycast as a middle-phase to roughly detect where the hit will be
-	RaycastPredicate predicate = { _terrain };
+	RaycastPredicate predicate = { _terrain, _terrain->get_storage(), _terrain->get_voxel_bounds(),
+		_terrain->get_data_block_size_pow2() };
 	Vector3i hit_pos;
 	Vector3i prev_pos;
 	float hit_distance;
@@ -177,34 +247,92 @@ struct DoSphere {
 	Box3i box;
 	TextureParams texture_params;
 
+	// Whether the operation can change a block that uniformly holds `raw_value` over `touched_box`.
+	// Digging can't change blocks that are entirely air, adding can't change blocks that are
+	// entirely matter, and those make up most of a large brush's bounding box.
+	bool uniform_block_can_change(SdfRowBlendOp blend_op, uint64_t raw_value, Box3i touched_box) const {
+		if (blend_op == SDF_ROW_BLEND_SET) {
+			return true;
+		}
+		// TODO Support other depths, format should be accessible from the volume
+		const float uniform_sdf = s16_to_snorm(int16_t(raw_value));
+
+		// Lower bound of the sphere's SDF over the touched box, reached at the point of the box
+		// closest to the center
+		const Vector3 box_min(touched_box.pos);
+		const Vector3 box_max(touched_box.pos + touched_box.size);
+		float min_distance_sq = 0.f;
+		for (unsigned int axis = 0; axis < 3; ++axis) {
+			const float below = box_min[axis] - center[axis];
+			const float above = center[axis] - box_max[axis];
+			const float outside = math::max(math::max(below, above), 0.f);
+			min_distance_sq += outside * outside;
+		}
+		// Stored values are clamped to the snorm range like the write kernels do
+		const float field_min = math::clamp(sdf_scale * (Math::sqrt(min_distance_sq) - radius), -1.f, 1.f);
+
+		if (blend_op == SDF_ROW_BLEND_UNION) {
+			// min(a, b) == a for the whole block iff a <= min(b)
+			return uniform_sdf > field_min;
+		}
+		// Subtract: max(a, -b) == a for the whole block iff a >= max(-b) == -min(b)
+		return uniform_sdf < -field_min;
+	}
+
+	// Row-vectorized stamping when the channel fits the kernel, per-voxel fallback otherwise
+	void stamp_sphere(SdfRowBlendOp blend_op) {
+		blocks.write_box_blocks_sparse(
+				box, VoxelBufferInternal::CHANNEL_SDF,
+				[this, blend_op](VoxelBufferInternal &voxels, Box3i local_box, Vector3i voxel_offset) {
+					if (try_stamp_sphere_sdf_s16(voxels, local_box, voxel_offset, center, radius, sdf_scale,
+								blend_op)) {
+						return;
+					}
+					// TODO Support other depths, format should be accessible from the volume
+					switch (blend_op) {
+						case SDF_ROW_BLEND_UNION: {
+							SdfOperation16bit<SdfUnion, SdfSphere> op;
+							op.shape.center = center;
+							op.shape.radius = radius;
+							op.shape.scale = sdf_scale;
+							voxels.write_box(local_box, VoxelBufferInternal::CHANNEL_SDF, op, voxel_offset);
+						} break;
+						case SDF_ROW_BLEND_SUBTRACT: {
+							SdfOperation16bit<SdfSubtract, SdfSphere> op;
+							op.shape.center = center;
+							op.shape.radius = radius;
+							op.shape.scale = sdf_scale;
+							voxels.write_box(local_box, VoxelBufferInternal::CHANNEL_SDF, op, voxel_offset);
+						} break;
+						default: {
+							SdfOperation16bit<SdfSet, SdfSphere> op;
+							op.shape.center = center;
+							op.shape.radius = radius;
+							op.shape.scale = sdf_scale;
+							voxels.write_box(local_box, VoxelBufferInternal::CHANNEL_SDF, op, voxel_offset);
+						} break;
+					}
+				},
+				[this, blend_op](uint64_t raw_value, Box3i touched_box) {
+					return uniform_block_can_change(blend_op, raw_value, touched_box);
+				});
+	}
+
 	void operator()() {
 		ZN_PROFILE_SCOPE();
 
 		switch (mode) {
-			case VoxelTool::MODE_ADD: {
-				// TODO Support other depths, format should be accessible from the volume
-				SdfOperation16bit<SdfUnion, SdfSphere> op;
-				op.shape.center = center;
-				op.shape.radius = radius;
-				op.shape.scale = sdf_scale;
-				blocks.write_box(box, VoxelBufferInternal::CHANNEL_SDF, op);
-			} break;
+			case VoxelTool::MODE_ADD:
+				stamp_sphere(SDF_ROW_BLEND_UNION);
+				break;
 
-			case VoxelTool::MODE_REMOVE: {
-				SdfOperation16bit<SdfSubtract, SdfSphere> op;
-				op.shape.center = center;
-				op.shape.radius = radius;
-				op.shape.scale = sdf_scale;
-				blocks.write_box(box, VoxelBufferInternal::CHANNEL_SDF, op);
-			} break;
+			case VoxelTool::MODE_REMOVE:
+				stamp_sphere(SDF_ROW_BLEND_SUBTRACT);
+				break;
 
-			case VoxelTool::MODE_SET: {
-				SdfOperation16bit<SdfSet, SdfSphere> op;
-				op.shape.center = center;
-				op.shape.radius = radius;
-				op.shape.scale = sdf_scale;
-				blocks.write_box(box, VoxelBufferInternal::CHANNEL_SDF, op);
-			} break;
+			case VoxelTool::MODE_SET:
+				stamp_sphere(SDF_ROW_BLEND_SET);
+				break;
 
 			case VoxelTool::MODE_TEXTURE_PAINT: {
 				blocks.write_box_2(box, VoxelBufferInternal::CHANNEL_INDICES, VoxelBufferInternal::CHANNEL_WEIGHTS,
@@ -249,9 +377,17 @@ void VoxelToolLodTerrain::do_sphere(Vector3 center, float radius) {
 	op.sdf_scale = get_sdf_scale();
 	op.texture_params = _texture_params;
 	{
-		RWLockRead rlock(data_lod.map_lock);
-		op.blocks.reference_area(data_lod.map, box);
+		// Register the edited area so unloading defers around it, then the map lock is only
+		// needed while referencing blocks: concurrent edits elsewhere and structural map changes
+		// proceed in parallel with the actual write
+		const Box3i blocks_box = box.downscaled(data_lod.map.get_block_size());
+		data_lod.add_edited_box(blocks_box);
+		{
+			RWLockRead rlock(data_lod.map_lock);
+			op.blocks.reference_area(data_lod.map, box);
+		}
 		op();
+		data_lod.remove_edited_box(blocks_box);
 	}
 
 	_post_edit(box);
@@ -269,14 +405,17 @@ public:
 		CRASH_COND(_data == nullptr);
 		VoxelDataLodMap::Lod &data_lod = _data->lods[0];
 		{
-			// TODO Prefer a spatial lock?
-			// We want blocks inside the edited area to not be accessed by other threads,
-			// but this locks the entire map, not just our area. If we used a spatial lock we would only need to lock
-			// the map for the duration of `reference_area`.
-			RWLockRead rlock(data_lod.map_lock);
-			// TODO May want to fail if not all blocks were found
-			_op.blocks.reference_area(data_lod.map, _op.box);
+			// Spatial lock: the edited area is registered so unloading defers around it, and the
+			// map lock is only held while referencing blocks
+			const Box3i blocks_box = _op.box.downscaled(data_lod.map.get_block_size());
+			data_lod.add_edited_box(blocks_box);
+			{
+				RWLockRead rlock(data_lod.map_lock);
+				// TODO May want to fail if not all blocks were found
+				_op.blocks.reference_area(data_lod.map, _op.box);
+			}
 			_op();
+			data_lod.remove_edited_box(blocks_box);
 		}
 		_tracker->post_complete();
 	}
@@ -361,6 +500,83 @@ float VoxelToolLodTerrain::_get_voxel_f(Vector3i pos) const {
 	return _terrain->get_voxel(pos, _channel, defval).f;
 }
 
+uint32_t VoxelToolLodTerrain::get_block_edit_version(Vector3i block_position) const {
+	ERR_FAIL_COND_V(_terrain == nullptr, 0);
+	const VoxelDataLodMap::Lod &data_lod0 = _terrain->get_storage()->lods[0];
+	RWLockRead rlock(data_lod0.map_lock);
+	const VoxelDataBlock *block = data_lod0.map.get_block(block_position);
+	return block != nullptr ? block->get_edit_version() : 0;
+}
+
+// Batched variant: entity sample clusters land in the same data block most of the time, so the
+// block resolution (map lock, lookup, LOD fallback) is memoized on the LOD-0 block position and
+// only redone when a query crosses into another block. Semantics mirror `VoxelLodTerrain::get_voxel`.
+void VoxelToolLodTerrain::_get_voxel_f_series(Span<const Vector3i> positions, Span<float> out_values) const {
+	ERR_FAIL_COND(_terrain == nullptr);
+
+	std::shared_ptr<VoxelDataLodMap> data = _terrain->get_storage();
+	const Box3i bounds = _terrain->get_voxel_bounds();
+	const unsigned int block_size_pow2 = _terrain->get_data_block_size_pow2();
+	const bool full_load_mode = _terrain->is_full_load_mode_enabled();
+	Ref<VoxelGenerator> generator = _terrain->get_generator();
+
+	std::shared_ptr<VoxelBufferInternal> cached_voxels;
+	unsigned int cached_lod_index = 0;
+	bool cached_resolved = false;
+	Vector3i cached_bpos0(0x7fffffff, 0x7fffffff, 0x7fffffff);
+
+	for (unsigned int i = 0; i < positions.size(); ++i) {
+		const Vector3i pos = positions[i];
+		if (!bounds.contains(pos)) {
+			out_values[i] = 1.f;
+			continue;
+		}
+
+		const Vector3i bpos0 = pos >> block_size_pow2;
+		if (bpos0 != cached_bpos0 || !cached_resolved) {
+			cached_bpos0 = bpos0;
+			cached_resolved = true;
+			cached_voxels = nullptr;
+
+			if (full_load_mode) {
+				// Like `VoxelLodTerrain::get_voxel`: only LOD 0 counts, the generator fills gaps
+				const VoxelDataLodMap::Lod &data_lod0 = data->lods[0];
+				RWLockRead rlock(data_lod0.map_lock);
+				const VoxelDataBlock *block = data_lod0.map.get_block(bpos0);
+				if (block != nullptr) {
+					cached_voxels = block->get_voxels_shared();
+					cached_lod_index = 0;
+				}
+			} else {
+				Vector3i block_pos = bpos0;
+				for (unsigned int lod_index = 0; lod_index < data->lod_count; ++lod_index) {
+					const VoxelDataLodMap::Lod &data_lod = data->lods[lod_index];
+					RWLockRead rlock(data_lod.map_lock);
+					const VoxelDataBlock *block = data_lod.map.get_block(block_pos);
+					if (block != nullptr) {
+						cached_voxels = block->get_voxels_shared();
+						cached_lod_index = lod_index;
+						break;
+					}
+					// Fallback on lower LOD
+					block_pos = block_pos >> 1;
+				}
+			}
+		}
+
+		if (cached_voxels != nullptr) {
+			const VoxelBufferInternal &voxels = *cached_voxels;
+			const Vector3i lpos = data->lods[cached_lod_index].map.to_local(pos >> cached_lod_index);
+			RWLockRead rlock(voxels.get_lock());
+			out_values[i] = voxels.get_voxel_f(lpos.x, lpos.y, lpos.z, _channel);
+		} else if (full_load_mode && generator.is_valid()) {
+			out_values[i] = generator->generate_single(pos, _channel).f;
+		} else {
+			out_values[i] = 1.f;
+		}
+	}
+}
+
 void VoxelToolLodTerrain::_set_voxel(Vector3i pos, uint64_t v) {
 	ERR_FAIL_COND(_terrain == nullptr);
 	_terrain->try_set_voxel_without_update(pos, _channel, v);
@@ -391,13 +607,61 @@ void VoxelToolLodTerrain::set_raycast_binary_search_iterations(int iterations) {
 // This is one way of doing it, I don't know if it's the best way (there is rarely a best way)
 // so there are probably other approaches that could be explored in the future, if they have better performance
 Array separate_floating_chunks(VoxelTool &voxel_tool, Box3i world_box, Node *parent_node, Transform3D transform,
-		Ref<VoxelMesher> mesher, Array materials) {
+		Ref<VoxelMesher> mesher, Array materials, const VoxelDataLodMap *data) {
 	ZN_PROFILE_SCOPE();
 
 	// Checks
 	ERR_FAIL_COND_V(mesher.is_null(), Array());
 	ERR_FAIL_COND_V(parent_node == nullptr, Array());
 
+	// Block-level pre-pass: edits invalidate per-block content summaries (air/matter/mixed), so
+	// the flood-fill can be clipped to the blocks that actually hold matter instead of scanning
+	// the whole requested box. Players usually pass generous boxes around a dig, and most of the
+	// volume is plain air after it; islands can only exist where matter is. The clipped box is
+	// grown one voxel into the surrounding air blocks, so an island ending right at matter bounds
+	// still gets an air border and isn't mistaken for terrain extending beyond the box.
+	if (data != nullptr) {
+		ZN_PROFILE_SCOPE_NAMED("Block summary clip");
+		const VoxelDataLodMap::Lod &data_lod = data->lods[0];
+		const unsigned int block_size = data_lod.map.get_block_size();
+		const Box3i blocks_box = world_box.downscaled(block_size);
+
+		Box3i matter_bounds;
+		bool has_matter = false;
+
+		{
+			RWLockRead rlock(data_lod.map_lock);
+			blocks_box.for_each_cell([&data_lod, &matter_bounds, &has_matter](Vector3i bpos) {
+				const VoxelDataBlock *block = data_lod.map.get_block(bpos);
+				// Unloaded blocks can't be classified, treat them as potential matter
+				const uint8_t uniform_class =
+						block != nullptr ? block->get_or_compute_uniform_class() : VoxelDataBlock::UNIFORM_CLASS_MIXED;
+				if (uniform_class == VoxelDataBlock::UNIFORM_CLASS_AIR) {
+					return;
+				}
+				const Box3i block_box(bpos, Vector3i(1, 1, 1));
+				if (has_matter) {
+					matter_bounds.merge_with(block_box);
+				} else {
+					matter_bounds = block_box;
+					has_matter = true;
+				}
+			});
+		}
+
+		if (!has_matter) {
+			// Nothing but air in the whole box, no island can exist
+			return Array();
+		}
+
+		const Box3i matter_voxel_bounds =
+				Box3i(matter_bounds.pos * block_size, matter_bounds.size * block_size).padded(1);
+		world_box = world_box.clipped(matter_voxel_bounds);
+		if (Vector3iUtil::get_volume(world_box.size) == 0) {
+			return Array();
+		}
+	}
+
 	// Copy source data
 
 	// TODO Do not assume channel, at the moment it's hardcoded for smooth terrain
@@ -425,13 +689,56 @@ Array separate_floating_chunks(VoxelTool &voxel_tool, Box3i world_box, Node *par
 		// TODO Allow to run the algorithm at a different LOD, to trade precision for speed
 		ZN_PROFILE_SCOPE_NAMED("CCL scan");
 		IslandFinder island_finder;
-		island_finder.scan_3d(
-				Box3i(Vector3i(), world_box.size),
-				[&source_copy_buffer](Vector3i pos) {
-					// TODO Can be optimized further with direct access
-					return source_copy_buffer.get_voxel_f(pos.x, pos.y, pos.z, main_channel) < 0.f;
-				},
-				to_span(ccl_output), &label_count);
+		const Box3i scan_box(Vector3i(), world_box.size);
+		const Vector3i scan_size = world_box.size;
+
+		// Scan raw channel data directly; calling `get_voxel_f` per voxel was a large constant
+		// factor of the freeze this function used to cause. Raw negative means negative SDF for
+		// every depth, so no unscaling is needed to classify.
+		source_copy_buffer.decompress_channel(main_channel);
+		Span<uint8_t> sdf_raw;
+		CRASH_COND(!source_copy_buffer.get_channel_raw(main_channel, sdf_raw));
+
+		switch (source_copy_buffer.get_channel_depth(main_channel)) {
+			case VoxelBufferInternal::DEPTH_8_BIT: {
+				Span<const int8_t> sdf = sdf_raw.reinterpret_cast_to<const int8_t>();
+				island_finder.scan_3d(
+						scan_box,
+						[sdf, scan_size](Vector3i pos) { //
+							return sdf[Vector3iUtil::get_zxy_index(pos, scan_size)] < 0;
+						},
+						to_span(ccl_output), &label_count);
+			} break;
+
+			case VoxelBufferInternal::DEPTH_16_BIT: {
+				Span<const int16_t> sdf = sdf_raw.reinterpret_cast_to<const int16_t>();
+				island_finder.scan_3d(
+						scan_box,
+						[sdf, scan_size](Vector3i pos) { //
+							return sdf[Vector3iUtil::get_zxy_index(pos, scan_size)] < 0;
+						},
+						to_span(ccl_output), &label_count);
+			} break;
+
+			case VoxelBufferInternal::DEPTH_32_BIT: {
+				Span<const float> sdf = sdf_raw.reinterpret_cast_to<const float>();
+				island_finder.scan_3d(
+						scan_box,
+						[sdf, scan_size](Vector3i pos) { //
+							return sdf[Vector3iUtil::get_zxy_index(pos, scan_size)] < 0.f;
+						},
+						to_span(ccl_output), &label_count);
+			} break;
+
+			default:
+				island_finder.scan_3d(
+						scan_box,
+						[&source_copy_buffer](Vector3i pos) {
+							return source_copy_buffer.get_voxel_f(pos.x, pos.y, pos.z, main_channel) < 0.f;
+						},
+						to_span(ccl_output), &label_count);
+				break;
+		}
 	}
 
 	struct Bounds {
@@ -719,8 +1026,8 @@ Array VoxelToolLodTerrain::separate_floating_chunks(AABB world_box, Node *parent
 	Array materials;
 	materials.append(_terrain->get_material());
 	const Box3i int_world_box(math::floor_to_int(world_box.position), math::ceil_to_int(world_box.size));
-	return zylann::voxel::separate_floating_chunks(
-			*this, int_world_box, parent_node, _terrain->get_global_transform(), mesher, materials);
+	return zylann::voxel::separate_floating_chunks(*this, int_world_box, parent_node,
+			_terrain->get_global_transform(), mesher, materials, _terrain->get_storage().get());
 }
 
 // Combines a precalculated SDF with the terrain at a specific position, rotation and scale.
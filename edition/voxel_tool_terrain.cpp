@@ -192,6 +192,49 @@ float VoxelToolTerrain::_get_voxel_f(Vector3i pos) const {
 	return _terrain->get_storage().get_voxel_f(pos, _channel);
 }
 
+uint32_t VoxelToolTerrain::get_block_edit_version(Vector3i block_position) const {
+	ERR_FAIL_COND_V(_terrain == nullptr, 0);
+	const VoxelDataBlock *block = _terrain->get_storage().get_block(block_position);
+	return block != nullptr ? block->get_edit_version() : 0;
+}
+
+// Grouped by block so each buffer lock is taken once per run of consecutive same-block queries,
+// which is the common shape of per-entity sample clusters
+void VoxelToolTerrain::_get_voxel_f_series(Span<const Vector3i> positions, Span<float> out_values) const {
+	ERR_FAIL_COND(_terrain == nullptr);
+	const VoxelDataMap &map = _terrain->get_storage();
+
+	const VoxelDataBlock *cached_block = nullptr;
+	Vector3i cached_bpos(0x7fffffff, 0x7fffffff, 0x7fffffff);
+
+	for (unsigned int i = 0; i < positions.size();) {
+		const Vector3i bpos = map.voxel_to_block(positions[i]);
+		if (bpos != cached_bpos) {
+			cached_block = map.get_block(bpos);
+			cached_bpos = bpos;
+		}
+
+		// Extend the run to every following query landing in the same block
+		unsigned int run_end = i + 1;
+		while (run_end < positions.size() && map.voxel_to_block(positions[run_end]) == bpos) {
+			++run_end;
+		}
+
+		if (cached_block == nullptr) {
+			for (; i < run_end; ++i) {
+				out_values[i] = map.get_default_voxel(_channel);
+			}
+		} else {
+			const VoxelBufferInternal &voxels = cached_block->get_voxels_const();
+			RWLockRead rlock(voxels.get_lock());
+			for (; i < run_end; ++i) {
+				const Vector3i lpos = map.to_local(positions[i]);
+				out_values[i] = voxels.get_voxel_f(lpos.x, lpos.y, lpos.z, _channel);
+			}
+		}
+	}
+}
+
 void VoxelToolTerrain::_set_voxel(Vector3i pos, uint64_t v) {
 	ERR_FAIL_COND(_terrain == nullptr);
 	_terrain->get_storage().set_voxel(v, pos, _channel);
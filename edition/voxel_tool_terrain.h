@@ -43,6 +43,8 @@ public:
 protected:
 	uint64_t _get_voxel(Vector3i pos) const override;
 	float _get_voxel_f(Vector3i pos) const override;
+	void _get_voxel_f_series(Span<const Vector3i> positions, Span<float> out_values) const override;
+	uint32_t get_block_edit_version(Vector3i block_position) const override;
 	void _set_voxel(Vector3i pos, uint64_t v) override;
 	void _set_voxel_f(Vector3i pos, float v) override;
 	void _post_edit(const Box3i &box) override;
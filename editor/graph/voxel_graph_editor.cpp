@@ -1,6 +1,9 @@
 #include "voxel_graph_editor.h"
 #include "../../generators/graph/voxel_generator_graph.h"
 #include "../../generators/graph/voxel_graph_node_db.h"
+#include "../../server/voxel_server.h"
+#include "../../util/memory.h"
+#include "../../util/tasks/threaded_task.h"
 #include "../../terrain/voxel_node.h"
 #include "../../util/godot/funcs.h"
 #include "../../util/log.h"
@@ -111,6 +114,10 @@ VoxelGraphEditor::VoxelGraphEditor() {
 	}
 	for (int i = 0; i < VoxelGraphNodeDB::get_singleton().get_type_count(); ++i) {
 		const VoxelGraphNodeDB::NodeType &node_type = VoxelGraphNodeDB::get_singleton().get_type(i);
+		if (node_type.internal) {
+			// Only produced by compilation passes
+			continue;
+		}
 		PopupMenu *menu = category_menus[node_type.category];
 		menu->add_item(node_type.name, i);
 	}
@@ -698,20 +705,11 @@ void VoxelGraphEditor::update_range_analysis_gizmo() {
 }
 
 void VoxelGraphEditor::update_slice_previews() {
-	// TODO Use a thread?
 	ZN_PRINT_VERBOSE("Updating slice previews");
 	ERR_FAIL_COND(!_graph->is_good());
 
-	struct PreviewInfo {
-		VoxelGraphEditorNodePreview *control;
-		uint32_t address;
-		float min_value;
-		float value_scale;
-	};
-
-	std::vector<PreviewInfo> previews;
-
 	// Gather preview nodes
+	_slice_preview_infos.clear();
 	for (int i = 0; i < _graph_edit->get_child_count(); ++i) {
 		const VoxelGraphEditorNode *node = Object::cast_to<VoxelGraphEditorNode>(_graph_edit->get_child(i));
 		if (node == nullptr || node->get_preview() == nullptr) {
@@ -725,7 +723,7 @@ void VoxelGraphEditor::update_slice_previews() {
 			// Not connected?
 			continue;
 		}
-		PreviewInfo info;
+		SlicePreviewInfo info;
 		info.control = node->get_preview();
 		if (!_graph->try_get_output_port_address(src, info.address)) {
 			// Not part of the compiled result
@@ -734,76 +732,162 @@ void VoxelGraphEditor::update_slice_previews() {
 		info.min_value = _graph->get_node_param(dst.node_id, 0);
 		const float max_value = _graph->get_node_param(dst.node_id, 1);
 		info.value_scale = 1.f / (max_value - info.min_value);
-		previews.push_back(info);
+		_slice_preview_infos.push_back(info);
+	}
+	if (_slice_preview_infos.size() == 0) {
+		return;
 	}
 
-	// Generate data
-	{
-		const int preview_size_x = VoxelGraphEditorNodePreview::RESOLUTION;
-		const int preview_size_y = VoxelGraphEditorNodePreview::RESOLUTION;
-		const int buffer_size = preview_size_x * preview_size_y;
-		std::vector<float> x_vec;
-		std::vector<float> y_vec;
-		std::vector<float> z_vec;
-		x_vec.resize(buffer_size);
-		y_vec.resize(buffer_size);
-		z_vec.resize(buffer_size);
-
-		const Vector3f min_pos(-preview_size_x / 2, -preview_size_y / 2, 0);
-		const Vector3f max_pos = min_pos + Vector3f(preview_size_x, preview_size_x, 0);
-
-		int i = 0;
-		for (int iy = 0; iy < preview_size_x; ++iy) {
-			const float y = Math::lerp(min_pos.y, max_pos.y, static_cast<float>(iy) / preview_size_y);
-			for (int ix = 0; ix < preview_size_y; ++ix) {
-				const float x = Math::lerp(min_pos.x, max_pos.x, static_cast<float>(ix) / preview_size_x);
-				x_vec[i] = x;
-				y_vec[i] = y;
-				z_vec[i] = min_pos.z;
-				++i;
+	// Previews regenerate as background tile tasks instead of one synchronous pass: designers
+	// tweak parameters continuously and heavy graphs used to freeze the editor for seconds each
+	// time. Bumping the generation cancels tiles still queued for the previous parameters.
+	if (_preview_generation == nullptr) {
+		_preview_generation = make_shared_instance<std::atomic_uint32_t>(0u);
+	}
+	const uint32_t generation = _preview_generation->fetch_add(1, std::memory_order_relaxed) + 1;
+
+	class PreviewTileTask : public zylann::IThreadedTask {
+	public:
+		ObjectID editor_object_id;
+		Ref<VoxelGeneratorGraph> graph;
+		std::shared_ptr<std::atomic_uint32_t> generation_ref;
+		uint32_t generation;
+		Vector2i tile_origin;
+		Vector2i tile_size;
+		int preview_axes;
+		std::vector<uint32_t> addresses;
+		std::vector<std::vector<float>> values_per_preview;
+		// Distance of the tile to the preview center, for center-first scheduling
+		int priority;
+
+		void run(zylann::ThreadedTaskContext ctx) override {
+			if (is_cancelled()) {
+				return;
+			}
+			const int buffer_size = tile_size.x * tile_size.y;
+			std::vector<float> x_vec(buffer_size);
+			std::vector<float> y_vec(buffer_size);
+			std::vector<float> z_vec(buffer_size);
+
+			const int res = VoxelGraphEditorNodePreview::RESOLUTION;
+			int i = 0;
+			for (int iy = 0; iy < tile_size.y; ++iy) {
+				const float y = float(tile_origin.y + iy) - res / 2;
+				for (int ix = 0; ix < tile_size.x; ++ix) {
+					x_vec[i] = float(tile_origin.x + ix) - res / 2;
+					y_vec[i] = y;
+					z_vec[i] = 0.f;
+					++i;
+				}
+			}
+
+			Span<float> x_coords = to_span(x_vec);
+			Span<float> y_coords;
+			Span<float> z_coords;
+			if (preview_axes == PREVIEW_XY) {
+				y_coords = to_span(y_vec);
+				z_coords = to_span(z_vec);
+			} else {
+				y_coords = to_span(z_vec);
+				z_coords = to_span(y_vec);
+			}
+
+			graph->generate_set(x_coords, y_coords, z_coords);
+
+			const VoxelGraphRuntime::State &state = VoxelGeneratorGraph::get_last_state_from_current_thread();
+			values_per_preview.resize(addresses.size());
+			for (unsigned int preview_index = 0; preview_index < addresses.size(); ++preview_index) {
+				std::vector<float> &values = values_per_preview[preview_index];
+				values.clear();
+				// A recompile may have changed buffer layout while this tile was in flight;
+				// the stale result gets dropped at apply time through the generation anyway
+				if (addresses[preview_index] >= state.get_buffer_count()) {
+					continue;
+				}
+				const VoxelGraphRuntime::Buffer &buffer = state.get_buffer(addresses[preview_index]);
+				if (buffer.data == nullptr || int(buffer.size) < buffer_size) {
+					continue;
+				}
+				values.resize(buffer_size);
+				memcpy(values.data(), buffer.data, buffer_size * sizeof(float));
 			}
 		}
 
-		Span<float> x_coords = to_span(x_vec);
-		Span<float> y_coords;
-		Span<float> z_coords;
-		if (_preview_axes == PREVIEW_XY) {
-			y_coords = to_span(y_vec);
-			z_coords = to_span(z_vec);
-		} else {
-			y_coords = to_span(z_vec);
-			z_coords = to_span(y_vec);
+		int get_priority() override {
+			return priority;
 		}
 
-		_graph->generate_set(x_coords, y_coords, z_coords);
-	}
+		bool is_cancelled() override {
+			// Obsolete as soon as parameters changed again
+			return generation_ref->load(std::memory_order_relaxed) != generation;
+		}
 
-	const VoxelGraphRuntime::State &last_state = VoxelGeneratorGraph::get_last_state_from_current_thread();
+		void apply_result() override {
+			if (is_cancelled()) {
+				return;
+			}
+			Object *obj = ObjectDB::get_instance(editor_object_id);
+			if (obj == nullptr) {
+				return;
+			}
+			VoxelGraphEditor *editor = Object::cast_to<VoxelGraphEditor>(obj);
+			ERR_FAIL_COND(editor == nullptr);
+			editor->apply_preview_tile(generation, tile_origin, tile_size, values_per_preview);
+		}
+	};
 
-	// Update previews
-	for (size_t preview_index = 0; preview_index < previews.size(); ++preview_index) {
-		PreviewInfo &info = previews[preview_index];
+	const int res = VoxelGraphEditorNodePreview::RESOLUTION;
+	const int TILE_SIZE = 32;
+	std::vector<uint32_t> addresses;
+	for (unsigned int i = 0; i < _slice_preview_infos.size(); ++i) {
+		addresses.push_back(_slice_preview_infos[i].address);
+	}
 
-		const VoxelGraphRuntime::Buffer &buffer = last_state.get_buffer(info.address);
+	for (int ty = 0; ty < res; ty += TILE_SIZE) {
+		for (int tx = 0; tx < res; tx += TILE_SIZE) {
+			PreviewTileTask *task = memnew(PreviewTileTask);
+			task->editor_object_id = get_instance_id();
+			task->graph = _graph;
+			task->generation_ref = _preview_generation;
+			task->generation = generation;
+			task->tile_origin = Vector2i(tx, ty);
+			task->tile_size = Vector2i(math::min(TILE_SIZE, res - tx), math::min(TILE_SIZE, res - ty));
+			task->preview_axes = _preview_axes;
+			task->addresses = addresses;
+			// Center tiles first
+			const Vector2i tile_center = task->tile_origin + task->tile_size / 2;
+			task->priority = (tile_center - Vector2i(res / 2, res / 2)).length_squared();
+			VoxelServer::get_singleton().push_async_task(task);
+		}
+	}
+}
 
-		Image &im = **info.control->get_image();
-		ERR_FAIL_COND(im.get_width() * im.get_height() != static_cast<int>(buffer.size));
+void VoxelGraphEditor::apply_preview_tile(uint32_t generation, Vector2i tile_origin, Vector2i tile_size,
+		const std::vector<std::vector<float>> &values_per_preview) {
+	if (_preview_generation == nullptr ||
+			_preview_generation->load(std::memory_order_relaxed) != generation) {
+		// Parameters changed since this tile was computed
+		return;
+	}
+	ERR_FAIL_COND(values_per_preview.size() != _slice_preview_infos.size());
 
-		// TODO Support debugging inputs
-		ERR_CONTINUE_MSG(buffer.data == nullptr,
-				buffer.is_binding ? "Plugging a debug view on an input is not supported yet."
-								  : "Didn't expect buffer to be null");
+	for (unsigned int preview_index = 0; preview_index < _slice_preview_infos.size(); ++preview_index) {
+		const SlicePreviewInfo &info = _slice_preview_infos[preview_index];
+		const std::vector<float> &values = values_per_preview[preview_index];
+		if (values.size() == 0) {
+			continue;
+		}
 
+		Image &im = **info.control->get_image();
 		unsigned int i = 0;
-		for (int y = 0; y < im.get_height(); ++y) {
-			for (int x = 0; x < im.get_width(); ++x) {
-				const float v = buffer.data[i];
+		for (int y = 0; y < tile_size.y; ++y) {
+			for (int x = 0; x < tile_size.x; ++x) {
+				const float v = values[i];
 				const float g = math::clamp((v - info.min_value) * info.value_scale, 0.f, 1.f);
-				im.set_pixel(x, im.get_height() - y - 1, Color(g, g, g));
+				im.set_pixel(tile_origin.x + x, im.get_height() - (tile_origin.y + y) - 1, Color(g, g, g));
 				++i;
 			}
 		}
-
 		info.control->update_texture();
 	}
 }
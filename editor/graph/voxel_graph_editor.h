@@ -3,6 +3,9 @@
 
 #include "../voxel_debug.h"
 #include <scene/gui/control.h>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 class GraphEdit;
 class PopupMenu;
@@ -52,6 +55,9 @@ private:
 	void schedule_preview_update();
 	void update_previews();
 	void update_slice_previews();
+	// Called by background tile tasks, see `update_slice_previews`
+	void apply_preview_tile(uint32_t generation, Vector2i tile_origin, Vector2i tile_size,
+			const std::vector<std::vector<float>> &values_per_preview);
 	void update_range_analysis_previews();
 	void update_range_analysis_gizmo();
 	void clear_range_analysis_tooltips();
@@ -101,6 +107,18 @@ private:
 	};
 
 	PreviewAxes _preview_axes = PREVIEW_XY;
+
+	// Incremental preview baking: the graph editor previews regenerate as background tile tasks,
+	// center tiles first; bumping the generation cancels everything still queued for the
+	// previous parameters. See `update_slice_previews`.
+	struct SlicePreviewInfo {
+		VoxelGraphEditorNodePreview *control;
+		uint32_t address;
+		float min_value;
+		float value_scale;
+	};
+	std::vector<SlicePreviewInfo> _slice_preview_infos;
+	std::shared_ptr<std::atomic_uint32_t> _preview_generation;
 };
 
 } // namespace zylann::voxel
@@ -0,0 +1,200 @@
+#include "voxel_performance_inspector.h"
+#include "../../terrain/voxel_node.h"
+#include "../../util/godot/funcs.h"
+#include "../../util/math/funcs.h"
+
+#include <core/os/time.h>
+#include <editor/editor_scale.h>
+#include <scene/gui/label.h>
+#include <scene/gui/separator.h>
+
+#include <algorithm>
+
+namespace zylann::voxel {
+
+VoxelPerformanceGraph::VoxelPerformanceGraph() {
+	fill(_samples, 0.f);
+	set_custom_minimum_size(Vector2(0, 36 * EDSCALE));
+	set_clip_contents(true);
+}
+
+void VoxelPerformanceGraph::push_sample(float value) {
+	_samples[_next_sample_index] = value;
+	_next_sample_index = (_next_sample_index + 1) % SAMPLE_COUNT;
+	update();
+}
+
+void VoxelPerformanceGraph::_notification(int p_what) {
+	if (p_what == NOTIFICATION_DRAW) {
+		draw_graph();
+	}
+}
+
+void VoxelPerformanceGraph::draw_graph() {
+	const Vector2 control_size = get_size();
+
+	const Color bg_color(0.1, 0.1, 0.1);
+	const Color line_color(0.4, 0.7, 1.0);
+	draw_rect(Rect2(Vector2(), control_size), bg_color);
+
+	float max_value = 1.f;
+	for (unsigned int i = 0; i < SAMPLE_COUNT; ++i) {
+		max_value = math::max(max_value, _samples[i]);
+	}
+
+	const float x_step = control_size.x / float(SAMPLE_COUNT - 1);
+	Vector2 prev_point;
+	for (unsigned int i = 0; i < SAMPLE_COUNT; ++i) {
+		// Oldest sample first
+		const float value = _samples[(_next_sample_index + i) % SAMPLE_COUNT];
+		const Vector2 point(i * x_step, control_size.y * (1.f - value / max_value));
+		if (i > 0) {
+			draw_line(prev_point, point, line_color);
+		}
+		prev_point = point;
+	}
+}
+
+VoxelPerformanceInspector::VoxelPerformanceInspector() {
+	create_graph(GRAPH_GENERAL_TASKS, TTR("General tasks"));
+	create_graph(GRAPH_STREAMING_TASKS, TTR("Streaming tasks"));
+	create_graph(GRAPH_MAIN_THREAD_TASKS, TTR("Main thread tasks"));
+	create_graph(GRAPH_DROPPED_TASKS, TTR("Dropped tasks (per frame)"));
+
+	add_child(memnew(HSeparator));
+
+	{
+		Label *title = memnew(Label);
+		title->set_text(TTR("Selected terrain"));
+		add_child(title);
+		_volume_stats_label = memnew(Label);
+		_volume_stats_label->set_text("---");
+		add_child(_volume_stats_label);
+	}
+
+	add_child(memnew(HSeparator));
+
+	{
+		Label *title = memnew(Label);
+		title->set_text(TTR("Slowest blocks"));
+		title->set_tooltip(TTR("Blocks whose pipeline tasks took the longest recently, with their "
+							   "positions in blocks of their LOD"));
+		title->set_mouse_filter(Control::MOUSE_FILTER_PASS);
+		add_child(title);
+		_slow_blocks_label = memnew(Label);
+		_slow_blocks_label->set_text("---");
+		add_child(_slow_blocks_label);
+	}
+}
+
+void VoxelPerformanceInspector::create_graph(GraphID id, String p_name) {
+	Graph &graph = _graphs[id];
+	CRASH_COND(graph.view != nullptr);
+
+	HBoxContainer *header = memnew(HBoxContainer);
+	Label *name_label = memnew(Label);
+	name_label->set_text(p_name);
+	name_label->set_h_size_flags(Control::SIZE_EXPAND_FILL);
+	header->add_child(name_label);
+	graph.value_label = memnew(Label);
+	graph.value_label->set_text("---");
+	header->add_child(graph.value_label);
+	add_child(header);
+
+	graph.view = memnew(VoxelPerformanceGraph);
+	add_child(graph.view);
+}
+
+void VoxelPerformanceInspector::set_terrain_node(VoxelNode *node) {
+	_terrain_node_id = node != nullptr ? node->get_instance_id() : ObjectID();
+}
+
+void VoxelPerformanceInspector::process() {
+	if (!is_visible_in_tree()) {
+		return;
+	}
+
+	const VoxelServer::Stats stats = VoxelServer::get_singleton().get_stats();
+	update_graphs(stats);
+
+	// Labels and the slow-block list churn text allocations, a couple of refreshes per second
+	// reads just as well
+	const uint64_t now = Time::get_singleton()->get_ticks_msec();
+	if (now - _last_text_update_msec >= 500) {
+		_last_text_update_msec = now;
+		update_texts();
+	}
+}
+
+void VoxelPerformanceInspector::update_graphs(const VoxelServer::Stats &stats) {
+	const uint64_t dropped_total = stats.general.dropped_tasks + stats.streaming.dropped_tasks;
+	const uint64_t dropped_delta = dropped_total - _last_dropped_total;
+	_last_dropped_total = dropped_total;
+
+	_graphs[GRAPH_GENERAL_TASKS].view->push_sample(stats.general.tasks);
+	_graphs[GRAPH_STREAMING_TASKS].view->push_sample(stats.streaming.tasks);
+	_graphs[GRAPH_MAIN_THREAD_TASKS].view->push_sample(stats.main_thread_tasks);
+	_graphs[GRAPH_DROPPED_TASKS].view->push_sample(dropped_delta);
+
+	_graphs[GRAPH_GENERAL_TASKS].value_label->set_text(String::num_int64(stats.general.tasks));
+	_graphs[GRAPH_STREAMING_TASKS].value_label->set_text(String::num_int64(stats.streaming.tasks));
+	_graphs[GRAPH_MAIN_THREAD_TASKS].value_label->set_text(String::num_int64(stats.main_thread_tasks));
+	_graphs[GRAPH_DROPPED_TASKS].value_label->set_text(String::num_int64(dropped_delta));
+}
+
+void VoxelPerformanceInspector::update_texts() {
+	// Per-volume statistics of the edited terrain. Both terrain types bind `get_statistics`,
+	// going through the scripting call keeps this panel working for either without duplicating
+	// their stat structs here.
+	String volume_text = "---";
+	if (_terrain_node_id.is_valid()) {
+		Object *obj = ObjectDB::get_instance(_terrain_node_id);
+		VoxelNode *node = Object::cast_to<VoxelNode>(obj);
+		if (node != nullptr) {
+			const Dictionary d = node->call("get_statistics");
+			String text;
+			const Array keys = d.keys();
+			for (int i = 0; i < keys.size(); ++i) {
+				const String key = keys[i];
+				String value_text;
+				// Time breakdown entries come from ProfilingClock in microseconds
+				if (key.begins_with("time_")) {
+					value_text = String::num_int64(int64_t(d[keys[i]])) + " us";
+				} else {
+					value_text = String(d[keys[i]]);
+				}
+				if (text.length() > 0) {
+					text += "\n";
+				}
+				text += key + ": " + value_text;
+			}
+			if (text.length() > 0) {
+				volume_text = text;
+			}
+		}
+	}
+	_volume_stats_label->set_text(volume_text);
+
+	// Top-N slowest blocks since the previous refresh
+	VoxelServer::get_singleton().consume_slow_block_records(_slow_block_records);
+	std::sort(_slow_block_records.begin(), _slow_block_records.end(),
+			[](const VoxelServer::SlowBlockRecord &a, const VoxelServer::SlowBlockRecord &b) {
+				return a.time_usec > b.time_usec;
+			});
+	const char *task_type_names[TaskLatencyStats::TASK_TYPE_COUNT] = { "generate", "mesh", "load", "save" };
+	String slow_text;
+	for (unsigned int i = 0; i < _slow_block_records.size(); ++i) {
+		const VoxelServer::SlowBlockRecord &record = _slow_block_records[i];
+		if (slow_text.length() > 0) {
+			slow_text += "\n";
+		}
+		const char *type_name =
+				record.task_type < TaskLatencyStats::TASK_TYPE_COUNT ? task_type_names[record.task_type] : "?";
+		slow_text += String("{0} ({1}, {2}, {3}) lod{4}: {5} ms")
+							 .format(varray(type_name, record.position.x, record.position.y, record.position.z,
+									 record.lod, float(record.time_usec) / 1000.f));
+	}
+	_slow_blocks_label->set_text(slow_text.length() > 0 ? slow_text : "---");
+}
+
+} // namespace zylann::voxel
@@ -0,0 +1,78 @@
+#ifndef VOXEL_PERFORMANCE_INSPECTOR_H
+#define VOXEL_PERFORMANCE_INSPECTOR_H
+
+#include "../../server/voxel_server.h"
+#include "../../util/fixed_array.h"
+
+#include <scene/gui/box_container.h>
+
+class Label;
+
+namespace zylann::voxel {
+
+class VoxelNode;
+
+// Scrolling line graph of a single counter, redrawn from a fixed ring of samples.
+// Height scales to the largest sample in view, so spikes stay visible without configuration.
+class VoxelPerformanceGraph : public Control {
+	GDCLASS(VoxelPerformanceGraph, Control)
+public:
+	static const unsigned int SAMPLE_COUNT = 128;
+
+	VoxelPerformanceGraph();
+
+	void push_sample(float value);
+
+private:
+	void _notification(int p_what);
+	void draw_graph();
+
+	FixedArray<float, SAMPLE_COUNT> _samples;
+	unsigned int _next_sample_index = 0;
+};
+
+// Dockable performance inspector: live graphs of the server's task counters, the edited
+// terrain's process-time breakdown, and the slowest recently-processed blocks with their
+// positions — so heavy map areas show up in-editor instead of in shipped-game reports.
+class VoxelPerformanceInspector : public VBoxContainer {
+	GDCLASS(VoxelPerformanceInspector, VBoxContainer)
+public:
+	VoxelPerformanceInspector();
+
+	// The node whose per-volume statistics get displayed. Can be null.
+	void set_terrain_node(VoxelNode *node);
+
+	// Call every frame while the dock may be visible; cheap when it isn't
+	void process();
+
+private:
+	enum GraphID {
+		GRAPH_GENERAL_TASKS = 0,
+		GRAPH_STREAMING_TASKS,
+		GRAPH_MAIN_THREAD_TASKS,
+		GRAPH_DROPPED_TASKS,
+		GRAPH_COUNT
+	};
+
+	void create_graph(GraphID id, String p_name);
+	void update_graphs(const VoxelServer::Stats &stats);
+	void update_texts();
+
+	struct Graph {
+		VoxelPerformanceGraph *view = nullptr;
+		Label *value_label = nullptr;
+	};
+
+	FixedArray<Graph, GRAPH_COUNT> _graphs;
+	Label *_volume_stats_label = nullptr;
+	Label *_slow_blocks_label = nullptr;
+
+	ObjectID _terrain_node_id;
+	uint64_t _last_text_update_msec = 0;
+	uint64_t _last_dropped_total = 0;
+	std::vector<VoxelServer::SlowBlockRecord> _slow_block_records;
+};
+
+} // namespace zylann::voxel
+
+#endif // VOXEL_PERFORMANCE_INSPECTOR_H
@@ -4,6 +4,7 @@
 #include "../../terrain/variable_lod/voxel_lod_terrain.h"
 #include "../about_window.h"
 #include "../graph/voxel_graph_node_inspector_wrapper.h"
+#include "voxel_performance_inspector.h"
 #include "voxel_terrain_editor_task_indicator.h"
 
 #include <editor/editor_scale.h>
@@ -25,6 +26,10 @@ VoxelTerrainEditorPlugin::VoxelTerrainEditorPlugin() {
 	_task_indicator->hide();
 	add_control_to_container(EditorPlugin::CONTAINER_SPATIAL_EDITOR_BOTTOM, _task_indicator);
 
+	_performance_inspector = memnew(VoxelPerformanceInspector);
+	_performance_inspector->set_name(TTR("Voxel Performance"));
+	add_control_to_dock(EditorPlugin::DOCK_SLOT_RIGHT_BL, _performance_inspector);
+
 	Node *base_control = get_editor_interface()->get_base_control();
 
 	_about_window = memnew(VoxelAboutWindow);
@@ -66,10 +71,12 @@ void VoxelTerrainEditorPlugin::_notification(int p_what) {
 
 		case NOTIFICATION_EXIT_TREE:
 			VoxelServer::get_singleton().remove_viewer(_editor_viewer_id);
+			remove_control_from_docks(_performance_inspector);
 			break;
 
 		case NOTIFICATION_PROCESS:
 			_task_indicator->update_stats();
+			_performance_inspector->process();
 			break;
 	}
 }
@@ -129,6 +136,7 @@ void VoxelTerrainEditorPlugin::set_node(VoxelNode *node) {
 	}
 
 	_node = node;
+	_performance_inspector->set_terrain_node(node);
 
 	if (_node != nullptr) {
 		_node->connect(
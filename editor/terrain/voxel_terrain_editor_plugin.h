@@ -9,6 +9,7 @@ namespace zylann::voxel {
 
 class VoxelAboutWindow;
 class VoxelNode;
+class VoxelPerformanceInspector;
 class VoxelTerrainEditorTaskIndicator;
 
 class VoxelTerrainEditorPlugin : public EditorPlugin {
@@ -52,6 +53,7 @@ private:
 	MenuButton *_menu_button = nullptr;
 	VoxelAboutWindow *_about_window = nullptr;
 	VoxelTerrainEditorTaskIndicator *_task_indicator = nullptr;
+	VoxelPerformanceInspector *_performance_inspector = nullptr;
 };
 
 } // namespace zylann::voxel
@@ -63,6 +63,8 @@ bool VoxelVoxMeshImporter::get_option_visibility(
 
 struct ForEachModelInstanceArgs {
 	const Model *model;
+	// Index to pass to `Data::load_model_voxels`
+	unsigned int model_index;
 	// Pivot position, which turns out to be at the center in MagicaVoxel
 	Vector3i position;
 	Basis basis;
@@ -95,6 +97,7 @@ Error for_each_model_instance_in_scene_graph(const Data &data, int node_id, Tran
 			const ShapeNode *vox_shape_node = reinterpret_cast<const ShapeNode *>(vox_node);
 			ForEachModelInstanceArgs args;
 			args.model = &data.get_model(vox_shape_node->model_id);
+			args.model_index = vox_shape_node->model_id;
 			args.position = math::round_to_int(transform.origin);
 			args.basis = transform.basis;
 			f(args);
@@ -117,6 +120,7 @@ void for_each_model_instance(const Data &vox_data, F f) {
 		// No scene graph
 		ForEachModelInstanceArgs args;
 		args.model = &vox_data.get_model(0);
+		args.model_index = 0;
 		// Put at center to match what MagicaVoxel would do
 		args.position = args.model->size / 2;
 		args.basis = Basis();
@@ -137,10 +141,15 @@ struct ModelInstance {
 
 void extract_model_instances(const Data &vox_data, std::vector<ModelInstance> &out_instances) {
 	// Gather all models and bake their rotations
-	for_each_model_instance(vox_data, [&out_instances](ForEachModelInstanceArgs args) {
+	for_each_model_instance(vox_data, [&vox_data, &out_instances](ForEachModelInstanceArgs args) {
 		ERR_FAIL_COND(args.model == nullptr);
 		const Model &model = *args.model;
 
+		// Voxels are materialized one model at a time, so only the model being converted
+		// occupies memory
+		std::vector<uint8_t> model_voxels;
+		ERR_FAIL_COND(vox_data.load_model_voxels(args.model_index, model_voxels) != OK);
+
 		Span<const uint8_t> src_color_indices;
 		Vector3i dst_size = model.size;
 
@@ -149,15 +158,15 @@ void extract_model_instances(const Data &vox_data, std::vector<ModelInstance> &o
 
 		if (args.basis == Basis()) {
 			// No transformation
-			src_color_indices = to_span_const(model.color_indexes);
+			src_color_indices = to_span_const(model_voxels);
 		} else {
 			IntBasis basis;
 			basis.x = to_vec3i(args.basis.get_column(Vector3::AXIS_X));
 			basis.y = to_vec3i(args.basis.get_column(Vector3::AXIS_Y));
 			basis.z = to_vec3i(args.basis.get_column(Vector3::AXIS_Z));
-			temp_voxels.resize(model.color_indexes.size());
+			temp_voxels.resize(model_voxels.size());
 			dst_size =
-					transform_3d_array_zxy(to_span_const(model.color_indexes), to_span(temp_voxels), model.size, basis);
+					transform_3d_array_zxy(to_span_const(model_voxels), to_span(temp_voxels), model.size, basis);
 			src_color_indices = to_span_const(temp_voxels);
 		}
 
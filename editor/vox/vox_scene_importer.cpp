@@ -5,9 +5,15 @@
 #include "../../streams/vox_data.h"
 #include "../../util/godot/funcs.h"
 #include "../../util/profiling.h"
+#include "../../util/macros.h"
+#include "../../util/math/funcs.h"
+#include "../../util/thread/thread.h"
 #include "vox_import_funcs.h"
 
+#include <atomic>
 #include <core/io/file_access.h>
+#include <core/os/os.h>
+#include <editor/editor_node.h>
 #include <scene/3d/mesh_instance_3d.h>
 #include <scene/3d/node_3d.h>
 #include <scene/resources/mesh.h>
@@ -260,13 +266,6 @@ Error VoxelVoxSceneImporter::import(const String &p_source_file, const String &p
 		palette->set_color8(i, color);
 	}
 
-	Ref<VoxelMesherCubes> mesher;
-	mesher.instantiate();
-	mesher->set_color_mode(VoxelMesherCubes::COLOR_MESHER_PALETTE);
-	mesher->set_palette(palette);
-	mesher->set_greedy_meshing_enabled(true);
-	mesher->set_store_colors_in_texture(p_store_colors_in_textures);
-
 	FixedArray<Ref<StandardMaterial3D>, 2> materials;
 	for (unsigned int i = 0; i < materials.size(); ++i) {
 		Ref<StandardMaterial3D> &mat = materials[i];
@@ -279,23 +278,134 @@ Error VoxelVoxSceneImporter::import(const String &p_source_file, const String &p
 	}
 	materials[1]->set_transparency(StandardMaterial3D::TRANSPARENCY_ALPHA);
 
-	// Build meshes from voxel models
-	for (unsigned int model_index = 0; model_index < data.get_model_count(); ++model_index) {
-		const magica::Model &model = data.get_model(model_index);
+	// Build meshes from voxel models.
+	// Each model is independent and the work is throughput-bound (decode + greedy meshing), so
+	// models are fanned out over temporary threads. Each worker owns a mesher instance, since
+	// meshing keeps per-instance state; only RenderingServer-facing work (textures, materials)
+	// stays on this thread below. The editor thread meanwhile drives a cancellable progress bar.
+	struct ModelResult {
+		Ref<Mesh> mesh;
+		Ref<Image> atlas;
+		std::vector<unsigned int> surface_index_to_material;
+		Vector3 pivot;
+	};
+	std::vector<ModelResult> model_results;
+	model_results.resize(data.get_model_count());
+
+	struct ConversionContext {
+		const magica::Data &data;
+		Span<ModelResult> results;
+		Ref<VoxelColorPalette> palette;
+		float scale;
+		bool store_colors_in_textures;
+		std::atomic_uint32_t next_model_index = { 0 };
+		std::atomic_uint32_t done_count = { 0 };
+		std::atomic_bool cancelled = { false };
+	};
+
+	struct ConversionJob {
+		ConversionContext *context;
+
+		static void run(void *p_userdata) {
+			ConversionJob &job = *static_cast<ConversionJob *>(p_userdata);
+			ConversionContext &ctx = *job.context;
+
+			Ref<VoxelMesherCubes> mesher;
+			mesher.instantiate();
+			mesher->set_color_mode(VoxelMesherCubes::COLOR_MESHER_PALETTE);
+			mesher->set_palette(ctx.palette);
+			mesher->set_greedy_meshing_enabled(true);
+			mesher->set_store_colors_in_texture(ctx.store_colors_in_textures);
+
+			std::vector<uint8_t> model_voxels;
+
+			while (!ctx.cancelled.load(std::memory_order_relaxed)) {
+				const uint32_t model_index = ctx.next_model_index.fetch_add(1, std::memory_order_relaxed);
+				if (model_index >= ctx.results.size()) {
+					break;
+				}
+				const magica::Model &model = ctx.data.get_model(model_index);
+				ModelResult &result = ctx.results[model_index];
 
-		VoxelBufferInternal voxels;
-		voxels.create(model.size + Vector3iUtil::create(VoxelMesherCubes::PADDING * 2));
-		voxels.decompress_channel(VoxelBufferInternal::CHANNEL_COLOR);
+				if (ctx.data.load_model_voxels(model_index, model_voxels) != OK) {
+					ctx.done_count.fetch_add(1, std::memory_order_relaxed);
+					continue;
+				}
 
-		Span<uint8_t> dst_color_indices;
-		ERR_FAIL_COND_V(!voxels.get_channel_raw(VoxelBufferInternal::CHANNEL_COLOR, dst_color_indices), ERR_BUG);
-		Span<const uint8_t> src_color_indices = to_span_const(model.color_indexes);
-		copy_3d_region_zxy(dst_color_indices, voxels.get_size(), Vector3iUtil::create(VoxelMesherCubes::PADDING),
-				src_color_indices, model.size, Vector3i(), model.size);
+				VoxelBufferInternal voxels;
+				voxels.create(model.size + Vector3iUtil::create(VoxelMesherCubes::PADDING * 2));
+				voxels.decompress_channel(VoxelBufferInternal::CHANNEL_COLOR);
 
-		std::vector<unsigned int> surface_index_to_material;
-		Ref<Image> atlas;
-		Ref<Mesh> mesh = magica::build_mesh(voxels, **mesher, surface_index_to_material, atlas, p_scale, Vector3());
+				Span<uint8_t> dst_color_indices;
+				if (voxels.get_channel_raw(VoxelBufferInternal::CHANNEL_COLOR, dst_color_indices)) {
+					copy_3d_region_zxy(dst_color_indices, voxels.get_size(),
+							Vector3iUtil::create(VoxelMesherCubes::PADDING), to_span_const(model_voxels), model.size,
+							Vector3i(), model.size);
+
+					result.mesh = magica::build_mesh(
+							voxels, **mesher, result.surface_index_to_material, result.atlas, ctx.scale, Vector3());
+					result.pivot = (voxels.get_size() / 2 - Vector3iUtil::create(1));
+				}
+
+				ctx.done_count.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+	};
+
+	ConversionContext conversion_context{ data, to_span(model_results), palette, p_scale,
+		p_store_colors_in_textures };
+	{
+		const unsigned int thread_count = math::clamp(
+				uint32_t(Thread::get_hardware_concurrency()), 1u, uint32_t(math::max(size_t(1), model_results.size())));
+
+		// This thread drives the progress dialog while helpers work; with a single hardware
+		// thread it does the conversion itself instead
+		std::vector<zylann::Thread> threads(thread_count - 1);
+		std::vector<ConversionJob> thread_jobs(thread_count, ConversionJob{ &conversion_context });
+		for (unsigned int i = 0; i < threads.size(); ++i) {
+			threads[i].start(&ConversionJob::run, &thread_jobs[i + 1]);
+		}
+
+		if (threads.size() == 0) {
+			// No helper threads, just do the work here
+			ConversionJob::run(&thread_jobs[0]);
+		} else {
+			// Drive a cancellable progress bar while workers chew through the models
+			EditorProgress progress("voxel_vox_scene_import", ZN_TTR("Importing MagicaVoxel scene"),
+					int(model_results.size()), true);
+			uint32_t last_done = 0xffffffff;
+			while (true) {
+				const uint32_t done = conversion_context.done_count.load(std::memory_order_relaxed);
+				if (done >= model_results.size()) {
+					break;
+				}
+				if (done != last_done) {
+					last_done = done;
+					if (progress.step(
+								String("{0}/{1}").format(varray(done, int(model_results.size()))), done, false)) {
+						conversion_context.cancelled.store(true, std::memory_order_relaxed);
+						break;
+					}
+				}
+				OS::get_singleton()->delay_usec(10000);
+			}
+		}
+
+		for (unsigned int i = 0; i < threads.size(); ++i) {
+			threads[i].wait_to_finish();
+		}
+	}
+
+	if (conversion_context.cancelled.load(std::memory_order_relaxed)) {
+		return ERR_SKIP;
+	}
+
+	// Materials and textures touch the RenderingServer, that part stays here
+	for (unsigned int model_index = 0; model_index < model_results.size(); ++model_index) {
+		ModelResult &model_result = model_results[model_index];
+		Ref<Mesh> mesh = model_result.mesh;
+		std::vector<unsigned int> &surface_index_to_material = model_result.surface_index_to_material;
+		Ref<Image> atlas = model_result.atlas;
 
 		if (mesh.is_null()) {
 			continue;
@@ -350,7 +460,7 @@ Error VoxelVoxSceneImporter::import(const String &p_source_file, const String &p
 		// In MagicaVoxel scene graph, pivots are at the center of models, not at the lower corner.
 		// TODO I don't know if this is correct, but I could not find a reference saying how that pivot should be
 		// calculated
-		mesh_info.pivot = (voxels.get_size() / 2 - Vector3iUtil::create(1));
+		mesh_info.pivot = model_result.pivot;
 		meshes[model_index] = mesh_info;
 	}
 
@@ -106,47 +106,120 @@ void free_debug_resources() {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-class DebugRendererItem {
-public:
-	DebugRendererItem() {
-		_mesh_instance.create();
-		// TODO When shadow casting is on, directional shadows completely break.
-		// The reason is still unknown.
-		// It should be off anyways, but it's rather concerning.
-		_mesh_instance.set_cast_shadows_setting(RenderingServer::SHADOW_CASTING_SETTING_OFF);
+DebugBatchedLinesRenderer::DebugBatchedLinesRenderer() {
+	_mesh_instance.create();
+	// TODO When shadow casting is on, directional shadows completely break.
+	// The reason is still unknown.
+	// It should be off anyways, but it's rather concerning.
+	_mesh_instance.set_cast_shadows_setting(RenderingServer::SHADOW_CASTING_SETTING_OFF);
+	_mesh.instantiate();
+	_mesh_instance.set_mesh(_mesh);
+	_material.instantiate();
+	_material->set_shading_mode(StandardMaterial3D::SHADING_MODE_UNSHADED);
+	_material->set_flag(StandardMaterial3D::FLAG_ALBEDO_FROM_VERTEX_COLOR, true);
+	_mesh_instance.set_material_override(_material);
+}
+
+DebugBatchedLinesRenderer::~DebugBatchedLinesRenderer() {
+	// Same ownership quirk as DebugMultiMeshRenderer: release the instance before the material
+	_mesh_instance.destroy();
+}
+
+void DebugBatchedLinesRenderer::set_world(World3D *world) {
+	_mesh_instance.set_world(world);
+	_world = world;
+}
+
+void DebugBatchedLinesRenderer::begin() {
+	ERR_FAIL_COND(_inside_block);
+	ERR_FAIL_COND(_world == nullptr);
+	_positions.clear();
+	_colors.clear();
+	_inside_block = true;
+}
+
+void DebugBatchedLinesRenderer::draw_box(const Transform3D &t, Color color) {
+	// Same corners as `get_debug_wirecube`, pre-transformed so every box lands in one buffer
+	const Vector3 corners_raw[8] = {
+		Vector3(0, 0, 0), //
+		Vector3(1, 0, 0), //
+		Vector3(1, 0, 1), //
+		Vector3(0, 0, 1), //
+		Vector3(0, 1, 0), //
+		Vector3(1, 1, 0), //
+		Vector3(1, 1, 1), //
+		Vector3(0, 1, 1) //
+	};
+	for (unsigned int i = 0; i < 8; ++i) {
+		_positions.push_back(t.xform(corners_raw[i]));
+		_colors.push_back(color);
 	}
+}
 
-	void set_mesh(Ref<Mesh> mesh) {
-		if (_mesh != mesh) {
-			_mesh = mesh;
-			_mesh_instance.set_mesh(mesh);
-		}
+void DebugBatchedLinesRenderer::end() {
+	ERR_FAIL_COND(!_inside_block);
+	_inside_block = false;
+
+	// Bounds gizmos rarely move; skip the upload when this frame drew the same boxes
+	if (_positions.size() == _uploaded_positions.size() &&
+			(_positions.size() == 0 ||
+					(memcmp(_positions.data(), _uploaded_positions.data(), _positions.size() * sizeof(Vector3)) == 0 &&
+							memcmp(_colors.data(), _uploaded_colors.data(), _colors.size() * sizeof(Color)) == 0))) {
+		return;
 	}
 
-	void set_transform(Transform3D t) {
-		if (_transform != t) {
-			_transform = t;
-			_mesh_instance.set_transform(t);
+	_mesh->clear_surfaces();
+
+	if (_positions.size() > 0) {
+		const unsigned int box_count = _positions.size() / 8;
+
+		// Indices follow the same 24-entry pattern per box, only grow the list when needed
+		const unsigned int required_index_count = box_count * 24;
+		if (static_cast<unsigned int>(_indices.size()) < required_index_count) {
+			const int edges_raw[24] = {
+				0, 1, 1, 2, 2, 3, 3, 0, //
+				4, 5, 5, 6, 6, 7, 7, 4, //
+				0, 4, 1, 5, 2, 6, 3, 7 //
+			};
+			unsigned int first_box = _indices.size() / 24;
+			_indices.resize(required_index_count);
+			int *iw = _indices.ptrw();
+			for (unsigned int b = first_box; b < box_count; ++b) {
+				for (unsigned int i = 0; i < 24; ++i) {
+					iw[b * 24 + i] = b * 8 + edges_raw[i];
+				}
+			}
 		}
-	}
 
-	void set_visible(bool visible) {
-		if (_visible != visible) {
-			_visible = visible;
-			_mesh_instance.set_visible(visible);
+		PackedVector3Array positions;
+		raw_copy_to(positions, _positions.data(), _positions.size());
+		PackedColorArray colors;
+		raw_copy_to(colors, _colors.data(), _colors.size());
+		PackedInt32Array indices = _indices;
+		if (static_cast<unsigned int>(indices.size()) > required_index_count) {
+			indices.resize(required_index_count);
 		}
-	}
 
-	void set_world(World3D *world) {
-		_mesh_instance.set_world(world);
+		Array arrays;
+		arrays.resize(Mesh::ARRAY_MAX);
+		arrays[Mesh::ARRAY_VERTEX] = positions;
+		arrays[Mesh::ARRAY_COLOR] = colors;
+		arrays[Mesh::ARRAY_INDEX] = indices;
+		_mesh->add_surface_from_arrays(Mesh::PRIMITIVE_LINES, arrays);
 	}
 
-private:
-	Transform3D _transform;
-	bool _visible = true;
-	Ref<Mesh> _mesh;
-	zylann::DirectMeshInstance _mesh_instance;
-};
+	// The stale buffers get cleared on the next `begin()`
+	std::swap(_uploaded_positions, _positions);
+	std::swap(_uploaded_colors, _colors);
+}
+
+void DebugBatchedLinesRenderer::clear() {
+	_positions.clear();
+	_colors.clear();
+	_uploaded_positions.clear();
+	_uploaded_colors.clear();
+	_mesh->clear_surfaces();
+}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -155,45 +228,26 @@ DebugRenderer::~DebugRenderer() {
 }
 
 void DebugRenderer::clear() {
-	for (auto it = _items.begin(); it != _items.end(); ++it) {
-		memdelete(*it);
-	}
-	_items.clear();
+	_lines_renderer.clear();
 	_mm_renderer.clear();
 }
 
 void DebugRenderer::set_world(World3D *world) {
 	_world = world;
-	for (auto it = _items.begin(); it != _items.end(); ++it) {
-		(*it)->set_world(world);
-	}
+	_lines_renderer.set_world(world);
 	_mm_renderer.set_world(world);
 }
 
 void DebugRenderer::begin() {
 	CRASH_COND(_inside_block);
 	CRASH_COND(_world == nullptr);
-	_current = 0;
 	_inside_block = true;
+	_lines_renderer.begin();
 	_mm_renderer.begin();
 }
 
 void DebugRenderer::draw_box(const Transform3D &t, DebugColors::ColorID color) {
-	// Pick an existing item, or create one
-	DebugRendererItem *item;
-	if (_current >= _items.size()) {
-		item = memnew(DebugRendererItem);
-		item->set_world(_world);
-		_items.push_back(item);
-	} else {
-		item = _items[_current];
-	}
-
-	item->set_mesh(get_debug_wirecube(color));
-	item->set_transform(t);
-	item->set_visible(true);
-
-	++_current;
+	_lines_renderer.draw_box(t, get_color(color));
 }
 
 void DebugRenderer::draw_box_mm(const Transform3D &t, Color8 color) {
@@ -202,12 +256,8 @@ void DebugRenderer::draw_box_mm(const Transform3D &t, Color8 color) {
 
 void DebugRenderer::end() {
 	CRASH_COND(!_inside_block);
-	// Hide exceeding items
-	for (unsigned int i = _current; i < _items.size(); ++i) {
-		DebugRendererItem *item = _items[i];
-		item->set_visible(false);
-	}
 	_inside_block = false;
+	_lines_renderer.end();
 	_mm_renderer.end();
 }
 
@@ -1,6 +1,7 @@
 #ifndef VOXEL_DEBUG_H
 #define VOXEL_DEBUG_H
 
+#include "../util/godot/direct_mesh_instance.h"
 #include "../util/godot/direct_multimesh_instance.h"
 #include <core/object/ref_counted.h>
 #include <vector>
@@ -46,7 +47,38 @@ private:
 	Ref<StandardMaterial3D> _material;
 };
 
-class DebugRendererItem;
+// Batches every wireframe box drawn between begin() and end() into a single line mesh on one
+// instance. Godot pays a fixed cost per rendered instance, so drawing thousands of boxes as
+// individual mesh instances tanks the editor; a single dynamic surface scales to
+// production-size worlds. The surface is only re-uploaded when the set of boxes changed since
+// the last frame, which is the common case for bounds that stay put.
+class DebugBatchedLinesRenderer {
+public:
+	DebugBatchedLinesRenderer();
+	~DebugBatchedLinesRenderer();
+
+	void set_world(World3D *world);
+	void begin();
+	void draw_box(const Transform3D &t, Color color);
+	void end();
+	void clear();
+
+private:
+	// Boxes submitted since `begin()`
+	std::vector<Vector3> _positions;
+	std::vector<Color> _colors;
+	// What the surface currently contains, to detect when a rebuild can be skipped
+	std::vector<Vector3> _uploaded_positions;
+	std::vector<Color> _uploaded_colors;
+	// Grown on demand; indices only depend on the number of boxes
+	PackedInt32Array _indices;
+	Ref<ArrayMesh> _mesh;
+	DirectMeshInstance _mesh_instance;
+	Ref<StandardMaterial3D> _material;
+	// TODO World3D is a reference, do not store it by pointer
+	World3D *_world = nullptr;
+	bool _inside_block = false;
+};
 
 class DebugRenderer {
 public:
@@ -70,11 +102,10 @@ public:
 	void clear();
 
 private:
-	std::vector<DebugRendererItem *> _items;
-	unsigned int _current = 0;
 	bool _inside_block = false;
 	// TODO World3D is a reference, do not store it by pointer
 	World3D *_world = nullptr;
+	DebugBatchedLinesRenderer _lines_renderer;
 	DebugMultiMeshRenderer _mm_renderer;
 };
 
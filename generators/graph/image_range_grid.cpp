@@ -1,7 +1,12 @@
 #include "image_range_grid.h"
+#include "../../util/log.h"
 #include "range_utility.h"
 
+#include <core/io/dir_access.h>
+#include <core/io/file_access.h>
 #include <core/io/image.h>
+#include <core/templates/hashfuncs.h>
+#include <cstring>
 
 namespace zylann {
 
@@ -172,4 +177,131 @@ Interval ImageRangeGrid::get_range(Interval xr, Interval yr) const {
 	return r;
 }
 
+namespace {
+const char *RANGE_GRID_CACHE_MAGIC = "ZNRG";
+const uint8_t RANGE_GRID_CACHE_VERSION = 1;
+const char *RANGE_GRID_CACHE_DIRECTORY = "user://cache/voxel_graph";
+} // namespace
+
+bool ImageRangeGrid::save_to_file(const String &fpath) const {
+	Ref<FileAccess> f = FileAccess::open(fpath, FileAccess::WRITE);
+	ERR_FAIL_COND_V(f.is_null(), false);
+
+	f->store_buffer(reinterpret_cast<const uint8_t *>(RANGE_GRID_CACHE_MAGIC), 4);
+	f->store_8(RANGE_GRID_CACHE_VERSION);
+
+	f->store_32(_pixels_x);
+	f->store_32(_pixels_y);
+	f->store_8(_lod_base);
+	f->store_8(_lod_count);
+	// Intervals are stored as 32-bit floats regardless of `real_t`, caches are throwaway data
+	f->store_float(_total_range.min);
+	f->store_float(_total_range.max);
+
+	for (int lod_index = 0; lod_index < _lod_count; ++lod_index) {
+		const Lod &lod = _lods[lod_index];
+		f->store_32(lod.size_x);
+		f->store_32(lod.size_y);
+		for (int i = 0; i < lod.size_x * lod.size_y; ++i) {
+			f->store_float(lod.data[i].min);
+			f->store_float(lod.data[i].max);
+		}
+	}
+
+	return true;
+}
+
+bool ImageRangeGrid::load_from_file(const String &fpath) {
+	Ref<FileAccess> f = FileAccess::open(fpath, FileAccess::READ);
+	if (f.is_null()) {
+		// Cache miss
+		return false;
+	}
+
+	FixedArray<char, 5> magic;
+	fill(magic, '\0');
+	if (f->get_buffer(reinterpret_cast<uint8_t *>(magic.data()), 4) != 4 ||
+			strcmp(magic.data(), RANGE_GRID_CACHE_MAGIC) != 0) {
+		return false;
+	}
+	if (f->get_8() != RANGE_GRID_CACHE_VERSION) {
+		return false;
+	}
+
+	clear();
+
+	_pixels_x = f->get_32();
+	_pixels_y = f->get_32();
+	_lod_base = f->get_8();
+	const int lod_count = f->get_8();
+	const float total_min = f->get_float();
+	const float total_max = f->get_float();
+
+	// Max image size supported by Godot is 16384. `_lod_base` is used as a shift amount, it must
+	// not come out of range from a corrupted file.
+	const int max_pixels_across = 16384;
+	if (_pixels_x < 1 || _pixels_y < 1 || _pixels_x > max_pixels_across || _pixels_y > max_pixels_across ||
+			_lod_base < 0 || _lod_base >= MAX_LODS || lod_count < 1 || lod_count > MAX_LODS ||
+			total_min > total_max) {
+		clear();
+		return false;
+	}
+	_total_range = Interval(total_min, total_max);
+
+	for (int lod_index = 0; lod_index < lod_count; ++lod_index) {
+		Lod &lod = _lods[lod_index];
+		lod.size_x = f->get_32();
+		lod.size_y = f->get_32();
+		// Sizes are bounded by the source image, a corrupted file must not cause a huge allocation
+		if (lod.size_x < 1 || lod.size_y < 1 || lod.size_x > _pixels_x + 1 || lod.size_y > _pixels_y + 1) {
+			lod.size_x = 0;
+			lod.size_y = 0;
+			clear();
+			return false;
+		}
+		lod.data = memnew_arr(Interval, lod.size_x * lod.size_y);
+		_lod_count = lod_index + 1;
+		for (int i = 0; i < lod.size_x * lod.size_y; ++i) {
+			const float rmin = f->get_float();
+			const float rmax = f->get_float();
+			if (rmin > rmax || f->eof_reached()) {
+				clear();
+				return false;
+			}
+			lod.data[i] = Interval(rmin, rmax);
+		}
+	}
+
+	return true;
+}
+
+ImageRangeGrid *get_or_generate_image_range_grid(const Image &im) {
+	// Key on the image content, so the cache survives renames and is invalidated by any pixel
+	// change. The cost of hashing is negligible compared to interval analysis.
+	uint64_t content_hash = hash_djb2_one_32(im.get_width());
+	content_hash = hash_djb2_one_32(im.get_height(), content_hash);
+	content_hash = hash_djb2_one_32(im.get_format(), content_hash);
+	const Vector<uint8_t> data = im.get_data();
+	content_hash = (uint64_t(content_hash) << 32) | hash_djb2_buffer(data.ptr(), data.size());
+
+	const String cache_path =
+			String(RANGE_GRID_CACHE_DIRECTORY).plus_file(String("image_range_{0}.bin").format(varray(content_hash)));
+
+	ImageRangeGrid *im_range = memnew(ImageRangeGrid);
+	if (im_range->load_from_file(cache_path)) {
+		return im_range;
+	}
+
+	im_range->generate(im);
+
+	const Error dir_err = DirAccess::make_dir_recursive_absolute(RANGE_GRID_CACHE_DIRECTORY);
+	if (dir_err == OK) {
+		im_range->save_to_file(cache_path);
+	} else {
+		ZN_PRINT_VERBOSE("Could not create the voxel graph cache directory");
+	}
+
+	return im_range;
+}
+
 } // namespace zylann
@@ -4,6 +4,8 @@
 #include "../../util/fixed_array.h"
 #include "../../util/math/interval.h"
 
+#include <core/string/ustring.h>
+
 class Image;
 
 namespace zylann {
@@ -15,6 +17,12 @@ public:
 
 	void clear();
 	void generate(const Image &im);
+
+	// Serialization of the precomputed ranges, so the analysis of large images can be cached on
+	// disk across loads. `load_from_file` returns false on missing or invalid files, in which case
+	// the grid must be generated from the image.
+	bool save_to_file(const String &fpath) const;
+	bool load_from_file(const String &fpath);
 	inline math::Interval get_range() const {
 		return _total_range;
 	}
@@ -41,6 +49,11 @@ private:
 	FixedArray<Lod, MAX_LODS> _lods;
 };
 
+// Returns a grid either deserialized from the on-disk cache (keyed by a hash of the image content)
+// or generated from the image and then saved to the cache, so warm startups skip scanning large
+// images entirely. The caller owns the returned grid.
+ImageRangeGrid *get_or_generate_image_range_grid(const Image &im);
+
 } // namespace zylann
 
 #endif // IMAGE_RANGE_GRID_H
@@ -8,7 +8,9 @@
 #include "../../util/profiling.h"
 #include "../../util/profiling_clock.h"
 #include "../../util/string_funcs.h"
+#include "voxel_graph_compute_backend.h"
 #include "voxel_graph_node_db.h"
+#include "voxel_graph_shader_generator.h"
 
 #include <core/config/engine.h>
 #include <core/core_string_names.h>
@@ -59,6 +61,8 @@ ProgramGraph::Node *create_node_internal(
 
 uint32_t VoxelGeneratorGraph::create_node(NodeTypeID type_id, Vector2 position, uint32_t id) {
 	ERR_FAIL_COND_V(!VoxelGraphNodeDB::get_singleton().is_valid_type_id(type_id), ProgramGraph::NULL_ID);
+	// Some node types only exist as products of compilation passes
+	ERR_FAIL_COND_V(VoxelGraphNodeDB::get_singleton().get_type(type_id).internal, ProgramGraph::NULL_ID);
 	const ProgramGraph::Node *node = create_node_internal(_graph, type_id, position, id);
 	ERR_FAIL_COND_V(node == nullptr, ProgramGraph::NULL_ID);
 	return node->id;
@@ -347,6 +351,18 @@ bool VoxelGeneratorGraph::is_using_subdivision() const {
 	return _use_subdivision;
 }
 
+void VoxelGeneratorGraph::set_use_lod_refinement(bool enabled) {
+	_use_lod_refinement = enabled;
+}
+
+bool VoxelGeneratorGraph::is_using_lod_refinement() const {
+	return _use_lod_refinement;
+}
+
+bool VoxelGeneratorGraph::supports_lod_refinement() const {
+	return _use_lod_refinement;
+}
+
 void VoxelGeneratorGraph::set_subdivision_size(int size) {
 	_subdivision_size = size;
 }
@@ -371,6 +387,40 @@ bool VoxelGeneratorGraph::is_using_xz_caching() const {
 	return _use_xz_caching;
 }
 
+void VoxelGeneratorGraph::set_use_gpu_generation(bool enabled) {
+	if (enabled == _use_gpu_generation) {
+		return;
+	}
+	_use_gpu_generation = enabled;
+	if (!enabled) {
+		RWLockWrite wlock(_runtime_lock);
+		_compute_backend = nullptr;
+	}
+	// When turning it on, the backend gets built on the next compilation
+}
+
+bool VoxelGeneratorGraph::is_using_gpu_generation() const {
+	return _use_gpu_generation;
+}
+
+bool VoxelGeneratorGraph::supports_gpu_generation() const {
+	RWLockRead rlock(_runtime_lock);
+	return _compute_backend != nullptr;
+}
+
+bool VoxelGeneratorGraph::generate_block_gpu(VoxelGenerator::VoxelQueryData &input) {
+	std::shared_ptr<VoxelGraphComputeBackend> backend;
+	{
+		RWLockRead rlock(_runtime_lock);
+		backend = _compute_backend;
+	}
+	if (backend == nullptr) {
+		return false;
+	}
+	VoxelGraphComputeBackend::BlockQuery query{ &input.voxel_buffer, input.origin_in_voxels, input.lod };
+	return backend->generate_blocks(Span<VoxelGraphComputeBackend::BlockQuery>(&query, 1));
+}
+
 // TODO Optimization: generating indices and weights on every voxel of a block might be avoidable
 // Instead, we could only generate them near zero-crossings, because this is where materials will be seen.
 // The problem is that it's harder to manage at the moment, to support edited blocks and LOD...
@@ -624,6 +674,53 @@ static void fill_zx_integer_slice(const VoxelGraphRuntime::Buffer &src_buffer, V
 	}
 }
 
+// Seeds a section of a child block by trilinearly upsampling the SDF of its parent block.
+// Values are stored with the same scale convention at every LOD, so they copy over directly.
+static void upsample_sdf_section(const VoxelBufferInternal &coarse, uint8_t octant, VoxelBufferInternal &out_buffer,
+		VoxelBufferInternal::ChannelId channel, Vector3i rmin, Vector3i rmax) {
+	ZN_PROFILE_SCOPE();
+	const Vector3i bs = out_buffer.get_size();
+	// Which corner of the parent the child covers, in parent voxels
+	const Vector3i coarse_origin = Vector3i(octant & 1, (octant >> 1) & 1, (octant >> 2) & 1) * (bs >> 1);
+	const Vector3i coarse_max = coarse.get_size() - Vector3i(1, 1, 1);
+
+	for (int z = rmin.z; z < rmax.z; ++z) {
+		for (int x = rmin.x; x < rmax.x; ++x) {
+			for (int y = rmin.y; y < rmax.y; ++y) {
+				// Center of the child voxel in parent voxel space
+				const float cx = coarse_origin.x + (x + 0.5f) * 0.5f - 0.5f;
+				const float cy = coarse_origin.y + (y + 0.5f) * 0.5f - 0.5f;
+				const float cz = coarse_origin.z + (z + 0.5f) * 0.5f - 0.5f;
+
+				const int x0 = math::clamp(int(Math::floor(cx)), 0, coarse_max.x);
+				const int y0 = math::clamp(int(Math::floor(cy)), 0, coarse_max.y);
+				const int z0 = math::clamp(int(Math::floor(cz)), 0, coarse_max.z);
+				const int x1 = math::min(x0 + 1, coarse_max.x);
+				const int y1 = math::min(y0 + 1, coarse_max.y);
+				const int z1 = math::min(z0 + 1, coarse_max.z);
+				const float tx = math::clamp(cx - x0, 0.f, 1.f);
+				const float ty = math::clamp(cy - y0, 0.f, 1.f);
+				const float tz = math::clamp(cz - z0, 0.f, 1.f);
+
+				const float v000 = coarse.get_voxel_f(x0, y0, z0, channel);
+				const float v100 = coarse.get_voxel_f(x1, y0, z0, channel);
+				const float v010 = coarse.get_voxel_f(x0, y1, z0, channel);
+				const float v110 = coarse.get_voxel_f(x1, y1, z0, channel);
+				const float v001 = coarse.get_voxel_f(x0, y0, z1, channel);
+				const float v101 = coarse.get_voxel_f(x1, y0, z1, channel);
+				const float v011 = coarse.get_voxel_f(x0, y1, z1, channel);
+				const float v111 = coarse.get_voxel_f(x1, y1, z1, channel);
+
+				const float v = Math::lerp( //
+						Math::lerp(Math::lerp(v000, v100, tx), Math::lerp(v010, v110, tx), ty),
+						Math::lerp(Math::lerp(v001, v101, tx), Math::lerp(v011, v111, tx), ty), tz);
+
+				out_buffer.set_voxel_f(v, x, y, z, channel);
+			}
+		}
+	}
+}
+
 VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::VoxelQueryData &input) {
 	std::shared_ptr<Runtime> runtime_ptr;
 	{
@@ -657,6 +754,15 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 	// Clip threshold must be higher for higher lod indexes because distances for one sampled voxel are also larger
 	const float clip_threshold = sdf_scale * _sdf_clip_threshold * stride;
 
+	// Parent data can seed sections the surface provably doesn't pass through, see
+	// `set_use_lod_refinement`. The band is in voxels at this LOD: coarse data is accurate to
+	// about one child voxel, so anything further than that from the surface is good enough.
+	const bool refine_from_coarse = _use_lod_refinement && input.coarse_voxels != nullptr &&
+			input.coarse_voxels->get_size() == bs &&
+			input.coarse_voxels->get_channel_depth(sdf_channel) == sdf_channel_depth &&
+			!input.coarse_voxels->is_uniform(sdf_channel);
+	const float refinement_band = sdf_scale * 1.f * stride;
+
 	// Block size must be a multiple of section size, as all sections must have the same size
 	const bool can_use_subdivision =
 			(bs.x % _subdivision_size == 0) && (bs.y % _subdivision_size == 0) && (bs.z % _subdivision_size == 0);
@@ -672,7 +778,9 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 	// Slice is on the Y axis
 	const unsigned int slice_buffer_size = section_size.x * section_size.z;
 	VoxelGraphRuntime &runtime = runtime_ptr->runtime;
-	runtime.prepare_state(cache.state, slice_buffer_size, false);
+	VoxelGraphRuntime::State &state = cache.get_state(
+			uint64_t(reinterpret_cast<uintptr_t>(runtime_ptr.get())), slice_buffer_size);
+	runtime.prepare_state(state, slice_buffer_size, false);
 
 	cache.x_cache.resize(slice_buffer_size);
 	cache.y_cache.resize(slice_buffer_size);
@@ -689,12 +797,40 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 	const int sdf_output_buffer_index = runtime_ptr->sdf_output_buffer_index;
 	const int type_output_buffer_index = runtime_ptr->type_output_buffer_index;
 
+	// Outputs feeding channels the caller didn't request are skipped entirely; the existing
+	// execution-map optimization then prunes their whole subtrees. Collision-only refreshes need
+	// SDF but never texture weights, for example.
+	const bool sdf_requested = (input.requested_channels & (1 << sdf_channel)) != 0;
+	const bool type_requested = (input.requested_channels & (1 << type_channel)) != 0;
+	const bool weights_requested = (input.requested_channels &
+											((1 << VoxelBufferInternal::CHANNEL_INDICES) |
+													(1 << VoxelBufferInternal::CHANNEL_WEIGHTS))) != 0;
+
 	FixedArray<unsigned int, VoxelGraphRuntime::MAX_OUTPUTS> required_outputs;
 	unsigned int required_outputs_count = 0;
 
 	bool all_sdf_is_air = (sdf_output_buffer_index != -1) && (type_output_buffer_index == -1);
 	bool all_sdf_is_matter = all_sdf_is_air;
 
+	// Coarse verdict cache setup, see `RangeVerdictCache`. Groups cover 4x4x4 sections in world
+	// space; verdicts only shortcut cases whose downstream reads don't depend on the skipped
+	// per-section analysis (air always skips weights, matter additionally requires no texture
+	// outputs, and a type output disables both since its range would be stale).
+	const bool section_cubic_po2 = section_size.x == section_size.y && section_size.x == section_size.z &&
+			math::is_power_of_two(section_size.x);
+	bool use_verdict_cache = section_cubic_po2 && sdf_output_buffer_index != -1 && sdf_requested;
+	unsigned int group_po2 = 0;
+	if (use_verdict_cache) {
+		group_po2 = math::get_shift_from_power_of_two_32(uint32_t(section_size.x)) + input.lod + 2;
+		// Coordinate shifts must stay in 32-bit range at the deepest LODs
+		use_verdict_cache = group_po2 < 31;
+	}
+	const bool air_verdict_usable = type_output_buffer_index == -1 || !type_requested;
+	const bool matter_verdict_usable = air_verdict_usable &&
+			(!weights_requested ||
+					(runtime_ptr->weight_outputs_count == 0 && runtime_ptr->single_texture_output_index == -1));
+	const void *verdict_runtime_token = runtime_ptr.get();
+
 	// For each subdivision of the block
 	for (int sz = 0; sz < bs.z; sz += section_size.z) {
 		for (int sy = 0; sy < bs.y; sy += section_size.y) {
@@ -706,12 +842,66 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 				const Vector3i gmin = origin + (rmin << input.lod);
 				const Vector3i gmax = origin + (rmax << input.lod);
 
+				if (use_verdict_cache) {
+					const RangeVerdictCache::Key key{ gmin >> group_po2, uint8_t(group_po2) };
+					uint8_t verdict = RangeVerdictCache::VERDICT_MIXED;
+					bool verdict_known = false;
+					{
+						MutexLock vlock(_range_verdict_cache.mutex);
+						if (_range_verdict_cache.runtime_token != verdict_runtime_token) {
+							_range_verdict_cache.verdicts.clear();
+							_range_verdict_cache.runtime_token = verdict_runtime_token;
+						}
+						auto it = _range_verdict_cache.verdicts.find(key);
+						if (it != _range_verdict_cache.verdicts.end()) {
+							verdict = it->second;
+							verdict_known = true;
+						}
+					}
+					if (!verdict_known) {
+						// One conservative analysis of the whole group box; bounds valid for the
+						// group hold for every section inside it
+						const Vector3i group_gmin = key.group_pos << group_po2;
+						const Vector3i group_gmax = group_gmin + Vector3iUtil::create(1 << group_po2);
+						runtime.analyze_range(state, group_gmin, group_gmax);
+						const math::Interval group_sdf_range =
+								state.get_range(sdf_output_buffer_index) * sdf_scale;
+						if (group_sdf_range.min > clip_threshold && group_sdf_range.max > clip_threshold) {
+							verdict = RangeVerdictCache::VERDICT_AIR;
+						} else if (group_sdf_range.min < -clip_threshold && group_sdf_range.max < -clip_threshold) {
+							verdict = RangeVerdictCache::VERDICT_MATTER;
+						}
+						MutexLock vlock(_range_verdict_cache.mutex);
+						if (_range_verdict_cache.verdicts.size() >= RangeVerdictCache::MAX_ENTRIES) {
+							_range_verdict_cache.verdicts.clear();
+						}
+						_range_verdict_cache.verdicts.insert({ key, verdict });
+					}
+					if (verdict == RangeVerdictCache::VERDICT_AIR && air_verdict_usable) {
+						out_buffer.fill_area_f(air_sdf, rmin, rmax, sdf_channel);
+						all_sdf_is_matter = false;
+						continue;
+					}
+					if (verdict == RangeVerdictCache::VERDICT_MATTER && matter_verdict_usable) {
+						out_buffer.fill_area_f(matter_sdf, rmin, rmax, sdf_channel);
+						all_sdf_is_air = false;
+						continue;
+					}
+				}
+
 				// Do a quick analysis of the area. We'll only compute voxels if necessary.
-				runtime.analyze_range(cache.state, gmin, gmax);
+				runtime.analyze_range(state, gmin, gmax);
 
 				bool sdf_is_air = true;
-				if (sdf_output_buffer_index != -1) {
-					const math::Interval sdf_range = cache.state.get_range(sdf_output_buffer_index) * sdf_scale;
+				bool sdf_refinable = false;
+				if (!sdf_requested) {
+					// Without SDF knowledge, other outputs can't assume the section is air
+					sdf_is_air = false;
+					all_sdf_is_air = false;
+					all_sdf_is_matter = false;
+				}
+				if (sdf_output_buffer_index != -1 && sdf_requested) {
+					const math::Interval sdf_range = state.get_range(sdf_output_buffer_index) * sdf_scale;
 					bool sdf_is_matter = false;
 
 					if (sdf_range.min > clip_threshold && sdf_range.max > clip_threshold) {
@@ -728,6 +918,14 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 						sdf_is_air = sdf_range.min > 0.f;
 						sdf_is_matter = !sdf_is_air;
 
+					} else if (refine_from_coarse &&
+							(sdf_range.min > refinement_band || sdf_range.max < -refinement_band)) {
+						// The surface can't pass through this section, only far-field values vary;
+						// upsampled parent data will be accurate enough (see below)
+						sdf_refinable = true;
+						sdf_is_air = sdf_range.min > 0.f;
+						sdf_is_matter = !sdf_is_air;
+
 					} else {
 						// SDF is not uniform, we'll need to compute it per voxel
 						required_outputs[required_outputs_count] = runtime_ptr->sdf_output_index;
@@ -739,8 +937,8 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 					all_sdf_is_matter = all_sdf_is_matter && sdf_is_matter;
 				}
 
-				if (type_output_buffer_index != -1) {
-					const math::Interval type_range = cache.state.get_range(type_output_buffer_index);
+				if (type_output_buffer_index != -1 && type_requested) {
+					const math::Interval type_range = state.get_range(type_output_buffer_index);
 					if (type_range.is_single_value()) {
 						out_buffer.fill_area(int(type_range.min), rmin, rmax, type_channel);
 					} else {
@@ -750,7 +948,7 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 					}
 				}
 
-				if (runtime_ptr->weight_outputs_count > 0 && !sdf_is_air) {
+				if (runtime_ptr->weight_outputs_count > 0 && weights_requested && !sdf_is_air) {
 					// We can skip this when SDF is air because there won't be any matter to give a texture to
 					// TODO Range analysis on that?
 					for (unsigned int i = 0; i < runtime_ptr->weight_outputs_count; ++i) {
@@ -759,8 +957,8 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 					}
 				}
 
-				if (runtime_ptr->single_texture_output_index != -1 && !sdf_is_air) {
-					const math::Interval index_range = cache.state.get_range(runtime_ptr->single_texture_output_index);
+				if (runtime_ptr->single_texture_output_index != -1 && weights_requested && !sdf_is_air) {
+					const math::Interval index_range = state.get_range(runtime_ptr->single_texture_output_index);
 					if (index_range.is_single_value()) {
 						out_buffer.fill_area(int(index_range.min), rmin, rmax, type_channel);
 					} else {
@@ -769,6 +967,20 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 					}
 				}
 
+				if (sdf_refinable) {
+					if (required_outputs_count == 0) {
+						// Nothing else needs per-voxel work, the section can be seeded from the
+						// parent block instead of evaluating the graph
+						upsample_sdf_section(
+								*input.coarse_voxels, input.coarse_octant, out_buffer, sdf_channel, rmin, rmax);
+						continue;
+					}
+					// Other outputs need a per-voxel pass anyway, and that pass writes the SDF
+					// slice, so the SDF has to be evaluated too rather than leaving stale data
+					required_outputs[required_outputs_count] = runtime_ptr->sdf_output_index;
+					++required_outputs_count;
+				}
+
 				if (required_outputs_count == 0) {
 					// We found all we need with range analysis, no need to calculate per voxel.
 					continue;
@@ -777,10 +989,28 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 				// At least one channel needs per-voxel computation.
 
 				if (_use_optimized_execution_map) {
-					runtime.generate_optimized_execution_map(cache.state, cache.optimized_execution_map,
+					runtime.generate_optimized_execution_map(state, cache.optimized_execution_map,
 							to_span_const(required_outputs, required_outputs_count), false);
 				}
 
+				// Y-independent operations produce identical outputs for every block of a vertical
+				// column. The pooled state remembers which column (and required-output set, which
+				// decides the execution map) its XZ outputs were computed for; a match lets even
+				// the first slice of this block skip the whole XZ prefix.
+				uint64_t xz_signature = 0;
+				if (_use_xz_caching) {
+					uint64_t h = 0xcbf29ce484222325ull;
+					const int64_t sig_values[5] = { gmin.x, gmin.z, stride, section_size.x, section_size.z };
+					for (unsigned int i = 0; i < 5; ++i) {
+						h = (h ^ uint64_t(sig_values[i])) * 0x100000001b3ull;
+					}
+					for (unsigned int i = 0; i < required_outputs_count; ++i) {
+						h = (h ^ required_outputs[i]) * 0x100000001b3ull;
+					}
+					xz_signature = h | 1; // 0 is reserved for "invalid"
+				}
+				const bool xz_cache_warm = _use_xz_caching && state.cached_xz_signature == xz_signature;
+
 				{
 					unsigned int i = 0;
 					for (int rz = rmin.z, gz = gmin.z; rz < rmax.z; ++rz, gz += stride) {
@@ -798,32 +1028,36 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 					y_cache.fill(gy);
 
 					// Full query (unless using execution map)
-					runtime.generate_set(cache.state, x_cache, y_cache, z_cache, _use_xz_caching && ry != rmin.y,
+					runtime.generate_set(state, x_cache, y_cache, z_cache,
+							_use_xz_caching && (ry != rmin.y || xz_cache_warm),
 							_use_optimized_execution_map ? &cache.optimized_execution_map : nullptr);
 
 					if (sdf_output_buffer_index != -1) {
-						const VoxelGraphRuntime::Buffer &sdf_buffer = cache.state.get_buffer(sdf_output_buffer_index);
+						const VoxelGraphRuntime::Buffer &sdf_buffer = state.get_buffer(sdf_output_buffer_index);
 						fill_zx_sdf_slice(
 								sdf_buffer, out_buffer, sdf_channel, sdf_channel_depth, sdf_scale, rmin, rmax, ry);
 					}
 
 					if (type_output_buffer_index != -1) {
-						const VoxelGraphRuntime::Buffer &type_buffer = cache.state.get_buffer(type_output_buffer_index);
+						const VoxelGraphRuntime::Buffer &type_buffer = state.get_buffer(type_output_buffer_index);
 						fill_zx_integer_slice(
 								type_buffer, out_buffer, type_channel, type_channel_depth, rmin, rmax, ry);
 					}
 
 					if (runtime_ptr->single_texture_output_index != -1) {
 						gather_indices_and_weights_from_single_texture(runtime_ptr->single_texture_output_buffer_index,
-								cache.state, rmin, rmax, ry, out_buffer);
+								state, rmin, rmax, ry, out_buffer);
 					}
 
 					if (runtime_ptr->weight_outputs_count > 0) {
 						gather_indices_and_weights(
 								to_span_const(runtime_ptr->weight_outputs, runtime_ptr->weight_outputs_count),
-								cache.state, rmin, rmax, ry, out_buffer, spare_texture_indices);
+								state, rmin, rmax, ry, out_buffer, spare_texture_indices);
 					}
 				}
+
+				// The XZ prefix outputs in the buffers now correspond to this column
+				state.cached_xz_signature = xz_signature;
 			}
 		}
 	}
@@ -1018,9 +1252,29 @@ VoxelGraphRuntime::CompilationResult VoxelGeneratorGraph::compile(bool debug) {
 		r->spare_texture_indices = spare_indices;
 	}
 
+	// Try building the compute backend when requested. Failing is not fatal: not all graphs can be
+	// converted to shader, and devices without compute support exist, so generation falls back on
+	// the CPU path in those cases.
+	std::shared_ptr<VoxelGraphComputeBackend> compute_backend;
+	// The shader only covers the SDF output; graphs with type, texture or weight outputs would lose
+	// those channels if generated on GPU, so they stay on the CPU path.
+	const bool gpu_can_cover_outputs = r->type_output_buffer_index == -1 &&
+			r->single_texture_output_buffer_index == -1 && r->weight_outputs_count == 0;
+	if (_use_gpu_generation && gpu_can_cover_outputs) {
+		std::string shader_code;
+		const VoxelGraphRuntime::CompilationResult shader_result = zylann::voxel::generate_shader(_graph, shader_code);
+		if (shader_result.success) {
+			compute_backend.reset(VoxelGraphComputeBackend::create(String(shader_code.c_str())));
+		} else {
+			ZN_PRINT_VERBOSE(
+					format("Voxel graph not convertible to shader, staying on CPU: {}", String(shader_result.message)));
+		}
+	}
+
 	// Store valid result
 	RWLockWrite wlock(_runtime_lock);
 	_runtime = r;
+	_compute_backend = compute_backend;
 
 	const int64_t time_spent = Time::get_singleton()->get_ticks_usec() - time_before;
 	ZN_PRINT_VERBOSE(format("Voxel graph compiled in {} us", time_spent));
@@ -1039,12 +1293,16 @@ void VoxelGeneratorGraph::generate_set(Span<float> in_x, Span<float> in_y, Span<
 	ERR_FAIL_COND(_runtime == nullptr);
 	Cache &cache = _cache;
 	VoxelGraphRuntime &runtime = _runtime->runtime;
-	runtime.prepare_state(cache.state, in_x.size(), false);
-	runtime.generate_set(cache.state, in_x, in_y, in_z, false, nullptr);
+	VoxelGraphRuntime::State &state = cache.get_state(
+			uint64_t(reinterpret_cast<uintptr_t>(_runtime.get())), in_x.size());
+	runtime.prepare_state(state, in_x.size(), false);
+	runtime.generate_set(state, in_x, in_y, in_z, false, nullptr);
+	// Arbitrary positions were just written into the buffers, any cached column is gone
+	state.cached_xz_signature = 0;
 }
 
 const VoxelGraphRuntime::State &VoxelGeneratorGraph::get_last_state_from_current_thread() {
-	return _cache.state;
+	return _cache.get_last_used_state();
 }
 
 Span<const uint32_t> VoxelGeneratorGraph::get_last_execution_map_debug_from_current_thread() {
@@ -1182,8 +1440,9 @@ void VoxelGeneratorGraph::bake_sphere_bumpmap(Ref<Image> im, float ref_radius, f
 
 	Cache &cache = _cache;
 
-	ProcessChunk pc(
-			cache.state, runtime_ptr->sdf_output_buffer_index, runtime_ptr->runtime, ref_radius, sdf_min, sdf_max);
+	// Editor bakes get their own slot; chunk sizes are prepared inside the processor
+	ProcessChunk pc(cache.get_state(uint64_t(reinterpret_cast<uintptr_t>(runtime_ptr.get())), 0),
+			runtime_ptr->sdf_output_buffer_index, runtime_ptr->runtime, ref_radius, sdf_min, sdf_max);
 	pc.im = im;
 	for_chunks_2d(im->get_width(), im->get_height(), 32, pc);
 }
@@ -1338,7 +1597,8 @@ void VoxelGeneratorGraph::bake_sphere_normalmap(Ref<Image> im, float ref_radius,
 		}
 	}
 
-	ProcessChunk pc(cache.state, runtime_ptr->sdf_output_buffer_index, im, runtime_ptr->runtime, strength, ref_radius);
+	ProcessChunk pc(cache.get_state(uint64_t(reinterpret_cast<uintptr_t>(runtime_ptr.get())), 0),
+			runtime_ptr->sdf_output_buffer_index, im, runtime_ptr->runtime, strength, ref_radius);
 	for_chunks_2d(im->get_width(), im->get_height(), 32, pc);
 }
 
@@ -1372,15 +1632,140 @@ VoxelSingleValue VoxelGeneratorGraph::generate_single(Vector3i position, unsigne
 	}
 	Cache &cache = _cache;
 	const VoxelGraphRuntime &runtime = runtime_ptr->runtime;
-	runtime.prepare_state(cache.state, 1, false);
-	runtime.generate_single(cache.state, to_vec3f(position), nullptr);
-	const VoxelGraphRuntime::Buffer &buffer = cache.state.get_buffer(runtime_ptr->sdf_output_buffer_index);
+	VoxelGraphRuntime::State &state = cache.get_state(
+			uint64_t(reinterpret_cast<uintptr_t>(runtime_ptr.get())), 1);
+	runtime.prepare_state(state, 1, false);
+	runtime.generate_single(state, to_vec3f(position), nullptr);
+	state.cached_xz_signature = 0;
+	const VoxelGraphRuntime::Buffer &buffer = state.get_buffer(runtime_ptr->sdf_output_buffer_index);
 	ERR_FAIL_COND_V(buffer.size == 0, v);
 	ERR_FAIL_COND_V(buffer.data == nullptr, v);
 	v.f = buffer.data[0];
 	return v;
 }
 
+float VoxelGeneratorGraph::get_surface_height(int x, int z, float min_y, float max_y) {
+	ZN_PROFILE_SCOPE();
+	ERR_FAIL_COND_V(!(min_y < max_y), std::numeric_limits<float>::quiet_NaN());
+
+	std::shared_ptr<const Runtime> runtime_ptr;
+	{
+		RWLockRead rlock(_runtime_lock);
+		runtime_ptr = _runtime;
+	}
+	ERR_FAIL_COND_V(runtime_ptr == nullptr, std::numeric_limits<float>::quiet_NaN());
+	if (runtime_ptr->sdf_output_buffer_index == -1) {
+		return std::numeric_limits<float>::quiet_NaN();
+	}
+
+	const HeightCache::Key cache_key{ x, z };
+	{
+		MutexLock lock(_height_cache.mutex);
+		if (_height_cache.runtime_token != runtime_ptr.get()) {
+			// The graph was recompiled, cached heights belong to the old output
+			_height_cache.map.clear();
+			_height_cache.lru.clear();
+			_height_cache.runtime_token = runtime_ptr.get();
+		}
+		auto it = _height_cache.map.find(cache_key);
+		if (it != _height_cache.map.end()) {
+			// Refresh LRU position
+			_height_cache.lru.erase(it->second.lru_it);
+			_height_cache.lru.push_front(cache_key);
+			it->second.lru_it = _height_cache.lru.begin();
+			return it->second.height;
+		}
+	}
+
+	Cache &cache = _cache;
+	const VoxelGraphRuntime &runtime = runtime_ptr->runtime;
+	VoxelGraphRuntime::State &state = cache.get_state(
+			uint64_t(reinterpret_cast<uintptr_t>(runtime_ptr.get())), 1);
+	runtime.prepare_state(state, 1, false);
+
+	// Bracket the topmost crossing. Candidate spans are explored top-first; range analysis is
+	// conservative, so a span that "may contain" the surface can turn out empty, in which case
+	// exploration falls back to the spans below it.
+	struct YSpan {
+		int y_min;
+		int y_max;
+	};
+	static thread_local std::vector<YSpan> tls_span_stack;
+	tls_span_stack.clear();
+	tls_span_stack.push_back(YSpan{ int(Math::floor(min_y)), int(Math::ceil(max_y)) });
+
+	const int EXACT_SCAN_SPAN = 8;
+	float height = std::numeric_limits<float>::quiet_NaN();
+
+	while (tls_span_stack.size() > 0) {
+		const YSpan span = tls_span_stack.back();
+		tls_span_stack.pop_back();
+
+		if (span.y_max - span.y_min > EXACT_SCAN_SPAN) {
+			// The whole-span check prunes empty regions; only the relevant subgraph of the SDF
+			// output runs during range analysis
+			runtime.analyze_range(state, Vector3i(x, span.y_min, z), Vector3i(x, span.y_max, z));
+			const math::Interval sdf_range = state.get_range(runtime_ptr->sdf_output_buffer_index);
+			if (sdf_range.min > 0.f) {
+				// All air
+				continue;
+			}
+			const int mid = (span.y_min + span.y_max) / 2;
+			// Lower half pushed first so the upper half is explored first (topmost surface)
+			tls_span_stack.push_back(YSpan{ span.y_min, mid });
+			tls_span_stack.push_back(YSpan{ mid, span.y_max });
+			continue;
+		}
+
+		// Exact top-down scan of a small bracket
+		float above_sdf = std::numeric_limits<float>::quiet_NaN();
+		bool found = false;
+		for (int y = span.y_max; y >= span.y_min; --y) {
+			runtime.generate_single(state, Vector3f(x, y, z), nullptr);
+			state.cached_xz_signature = 0;
+			const VoxelGraphRuntime::Buffer &buffer = state.get_buffer(runtime_ptr->sdf_output_buffer_index);
+			ERR_FAIL_COND_V(buffer.size == 0 || buffer.data == nullptr, height);
+			const float sdf = buffer.data[0];
+
+			if (sdf < 0.f) {
+				if (Math::is_nan(above_sdf) || above_sdf <= 0.f) {
+					// Solid at the top of the bracket
+					height = float(y);
+				} else {
+					// Crossing between y (solid) and y+1 (air), interpolate
+					height = float(y) + sdf / (sdf - above_sdf);
+				}
+				found = true;
+				break;
+			}
+			above_sdf = sdf;
+		}
+		if (found) {
+			break;
+		}
+	}
+
+	if (!Math::is_nan(height)) {
+		MutexLock lock(_height_cache.mutex);
+		if (_height_cache.runtime_token == runtime_ptr.get()) {
+			_height_cache.lru.push_front(cache_key);
+			HeightCache::Entry &entry = _height_cache.map[cache_key];
+			entry.height = height;
+			entry.lru_it = _height_cache.lru.begin();
+			while (_height_cache.map.size() > HeightCache::CAPACITY && _height_cache.lru.size() > 0) {
+				_height_cache.map.erase(_height_cache.lru.back());
+				_height_cache.lru.pop_back();
+			}
+		}
+	}
+
+	return height;
+}
+
+float VoxelGeneratorGraph::_b_get_surface_height(int x, int z, float min_y, float max_y) {
+	return get_surface_height(x, z, min_y, max_y);
+}
+
 // Note, this wrapper may not be used for main generation tasks.
 // It is mostly used as a debug tool.
 math::Interval VoxelGeneratorGraph::debug_analyze_range(
@@ -1394,14 +1779,16 @@ math::Interval VoxelGeneratorGraph::debug_analyze_range(
 	Cache &cache = _cache;
 	const VoxelGraphRuntime &runtime = runtime_ptr->runtime;
 	// Note, buffer size is irrelevant here, because range analysis doesn't use buffers
-	runtime.prepare_state(cache.state, 1, false);
-	runtime.analyze_range(cache.state, min_pos, max_pos);
+	VoxelGraphRuntime::State &state = cache.get_state(
+			uint64_t(reinterpret_cast<uintptr_t>(runtime_ptr.get())), 1);
+	runtime.prepare_state(state, 1, false);
+	runtime.analyze_range(state, min_pos, max_pos);
 	if (optimize_execution_map) {
-		runtime.generate_optimized_execution_map(cache.state, cache.optimized_execution_map, true);
+		runtime.generate_optimized_execution_map(state, cache.optimized_execution_map, true);
 	}
 	// TODO Change return value to allow checking other outputs
 	if (runtime_ptr->sdf_output_buffer_index != -1) {
-		return cache.state.get_range(runtime_ptr->sdf_output_buffer_index);
+		return state.get_range(runtime_ptr->sdf_output_buffer_index);
 	}
 	return math::Interval();
 }
@@ -1652,7 +2039,9 @@ float VoxelGeneratorGraph::debug_measure_microseconds_per_voxel(
 	Cache &cache = _cache;
 
 	if (singular) {
-		runtime.prepare_state(cache.state, 1, false);
+		VoxelGraphRuntime::State &state = cache.get_state(
+				uint64_t(reinterpret_cast<uintptr_t>(runtime_ptr.get())), 1);
+		runtime.prepare_state(state, 1, false);
 
 		for (uint32_t i = 0; i < cube_count; ++i) {
 			profiling_clock.restart();
@@ -1660,7 +2049,7 @@ float VoxelGeneratorGraph::debug_measure_microseconds_per_voxel(
 			for (uint32_t z = 0; z < cube_size; ++z) {
 				for (uint32_t y = 0; y < cube_size; ++y) {
 					for (uint32_t x = 0; x < cube_size; ++x) {
-						runtime.generate_single(cache.state, Vector3f(x, y, z), nullptr);
+						runtime.generate_single(state, Vector3f(x, y, z), nullptr);
 					}
 				}
 			}
@@ -1681,13 +2070,17 @@ float VoxelGeneratorGraph::debug_measure_microseconds_per_voxel(
 		Span<float> sz(src_z, 0, src_z.size());
 
 		const bool per_node_profiling = node_profiling_info != nullptr;
-		runtime.prepare_state(cache.state, sx.size(), per_node_profiling);
+		VoxelGraphRuntime::State &state = cache.get_state(
+				uint64_t(reinterpret_cast<uintptr_t>(runtime_ptr.get())), sx.size());
+		runtime.prepare_state(state, sx.size(), per_node_profiling);
+		// Benchmark writes arbitrary positions, any cached column in this slot is gone
+		state.cached_xz_signature = 0;
 
 		for (uint32_t i = 0; i < cube_count; ++i) {
 			profiling_clock.restart();
 
 			for (uint32_t y = 0; y < cube_size; ++y) {
-				runtime.generate_set(cache.state, sx, sy, sz, false, nullptr);
+				runtime.generate_set(state, sx, sy, sz, false, nullptr);
 			}
 
 			total_elapsed_us += profiling_clock.restart();
@@ -1699,7 +2092,7 @@ float VoxelGeneratorGraph::debug_measure_microseconds_per_voxel(
 			for (unsigned int i = 0; i < node_profiling_info->size(); ++i) {
 				NodeProfilingInfo &info = (*node_profiling_info)[i];
 				info.node_id = execution_map.debug_nodes[i];
-				info.microseconds = cache.state.get_execution_time(i);
+				info.microseconds = state.get_execution_time(i);
 			}
 		}
 	}
@@ -1907,6 +2300,9 @@ void VoxelGeneratorGraph::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("set_use_subdivision", "use"), &VoxelGeneratorGraph::set_use_subdivision);
 	ClassDB::bind_method(D_METHOD("is_using_subdivision"), &VoxelGeneratorGraph::is_using_subdivision);
+	ClassDB::bind_method(
+			D_METHOD("set_use_lod_refinement", "enabled"), &VoxelGeneratorGraph::set_use_lod_refinement);
+	ClassDB::bind_method(D_METHOD("is_using_lod_refinement"), &VoxelGeneratorGraph::is_using_lod_refinement);
 
 	ClassDB::bind_method(D_METHOD("set_subdivision_size", "size"), &VoxelGeneratorGraph::set_subdivision_size);
 	ClassDB::bind_method(D_METHOD("get_subdivision_size"), &VoxelGeneratorGraph::get_subdivision_size);
@@ -1915,6 +2311,8 @@ void VoxelGeneratorGraph::_bind_methods() {
 			D_METHOD("set_debug_clipped_blocks", "enabled"), &VoxelGeneratorGraph::set_debug_clipped_blocks);
 	ClassDB::bind_method(D_METHOD("is_debug_clipped_blocks"), &VoxelGeneratorGraph::is_debug_clipped_blocks);
 
+	ClassDB::bind_method(D_METHOD("set_use_gpu_generation", "enabled"), &VoxelGeneratorGraph::set_use_gpu_generation);
+	ClassDB::bind_method(D_METHOD("is_using_gpu_generation"), &VoxelGeneratorGraph::is_using_gpu_generation);
 	ClassDB::bind_method(D_METHOD("set_use_xz_caching", "enabled"), &VoxelGeneratorGraph::set_use_xz_caching);
 	ClassDB::bind_method(D_METHOD("is_using_xz_caching"), &VoxelGeneratorGraph::is_using_xz_caching);
 
@@ -1932,6 +2330,8 @@ void VoxelGeneratorGraph::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("bake_sphere_normalmap", "im", "ref_radius", "strength"),
 			&VoxelGeneratorGraph::bake_sphere_normalmap);
 	ClassDB::bind_method(D_METHOD("generate_shader"), &VoxelGeneratorGraph::generate_shader);
+	ClassDB::bind_method(D_METHOD("get_surface_height", "x", "z", "min_y", "max_y"),
+			&VoxelGeneratorGraph::_b_get_surface_height);
 
 	ClassDB::bind_method(D_METHOD("debug_load_waves_preset"), &VoxelGeneratorGraph::debug_load_waves_preset);
 	ClassDB::bind_method(D_METHOD("debug_measure_microseconds_per_voxel", "use_singular_queries"),
@@ -1953,8 +2353,12 @@ void VoxelGeneratorGraph::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_optimized_execution_map"), "set_use_optimized_execution_map",
 			"is_using_optimized_execution_map");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_subdivision"), "set_use_subdivision", "is_using_subdivision");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_lod_refinement"), "set_use_lod_refinement",
+			"is_using_lod_refinement");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "subdivision_size"), "set_subdivision_size", "get_subdivision_size");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_xz_caching"), "set_use_xz_caching", "is_using_xz_caching");
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "use_gpu_generation"), "set_use_gpu_generation", "is_using_gpu_generation");
 	ADD_PROPERTY(
 			PropertyInfo(Variant::BOOL, "debug_block_clipping"), "set_debug_clipped_blocks", "is_debug_clipped_blocks");
 
@@ -2011,6 +2415,8 @@ void VoxelGeneratorGraph::_bind_methods() {
 	BIND_ENUM_CONSTANT(NODE_EXPRESSION);
 	BIND_ENUM_CONSTANT(NODE_POWI);
 	BIND_ENUM_CONSTANT(NODE_POW);
+	BIND_ENUM_CONSTANT(NODE_FUSED_EXPRESSION);
+	BIND_ENUM_CONSTANT(NODE_SDF_SMOOTH_UNION_N);
 	BIND_ENUM_CONSTANT(NODE_TYPE_COUNT);
 }
 
@@ -1,17 +1,24 @@
 #ifndef VOXEL_GENERATOR_GRAPH_H
 #define VOXEL_GENERATOR_GRAPH_H
 
+#include "../../util/fixed_array.h"
 #include "../../util/thread/rw_lock.h"
+#include "../../util/thread/mutex.h"
 #include "../voxel_generator.h"
 #include "program_graph.h"
 #include "voxel_graph_runtime.h"
 
+#include <limits>
+#include <list>
 #include <memory>
+#include <unordered_map>
 
 class Image;
 
 namespace zylann::voxel {
 
+class VoxelGraphComputeBackend;
+
 class VoxelGeneratorGraph : public VoxelGenerator {
 	GDCLASS(VoxelGeneratorGraph, VoxelGenerator)
 public:
@@ -74,6 +81,10 @@ public:
 		NODE_EXPRESSION,
 		NODE_POWI, // pow(x, constant positive integer)
 		NODE_POW, // pow(x, y)
+		// Internal node executing a whole expression as one operation, see `FusedExpression`
+		NODE_FUSED_EXPRESSION,
+		// N-ary variant folding up to 8 shapes in one buffer pass, see `SdfSmoothUnionN`
+		NODE_SDF_SMOOTH_UNION_N,
 
 		NODE_TYPE_COUNT
 	};
@@ -147,6 +158,14 @@ public:
 	void set_use_subdivision(bool use);
 	bool is_using_subdivision() const;
 
+	// When enabled and the querier provides parent LOD data, sections of a block where range
+	// analysis proves the surface can't pass are seeded by upsampling that data instead of
+	// evaluating the graph per voxel. Only for graphs that are LOD-consistent (same output
+	// regardless of sampling step). See `VoxelGenerator::VoxelQueryData::coarse_voxels`.
+	void set_use_lod_refinement(bool enabled);
+	bool is_using_lod_refinement() const;
+	bool supports_lod_refinement() const override;
+
 	void set_subdivision_size(int size);
 	int get_subdivision_size() const;
 
@@ -156,17 +175,32 @@ public:
 	void set_use_xz_caching(bool enabled);
 	bool is_using_xz_caching() const;
 
+	// When enabled, compiling the graph also builds a compute-shader backend (if the graph supports
+	// conversion to shader), which generation tasks can use to generate SDF blocks on the GPU.
+	void set_use_gpu_generation(bool enabled);
+	bool is_using_gpu_generation() const;
+
 	// VoxelGenerator implementation
 
 	int get_used_channels_mask() const override;
 
 	Result generate_block(VoxelGenerator::VoxelQueryData &input) override;
 	//float generate_single(const Vector3i &position);
+	bool supports_gpu_generation() const override;
+	bool generate_block_gpu(VoxelGenerator::VoxelQueryData &input) override;
 	bool supports_single_generation() const override {
 		return true;
 	}
 	VoxelSingleValue generate_single(Vector3i position, unsigned int channel) override;
 
+	// Surface height at a column, for gameplay queries (spawn placement, AI navigation).
+	// Brackets the topmost SDF zero-crossing in [min_y, max_y] with range analysis over
+	// shrinking vertical spans (so the full subgraph only evaluates for a handful of samples),
+	// then refines with single queries and linear interpolation. Returns NAN when the column has
+	// no surface in the range. Results go through a small thread-safe LRU keyed per column,
+	// invalidated when the graph recompiles. Callable from any thread.
+	float get_surface_height(int x, int z, float min_y, float max_y);
+
 	Ref<Resource> duplicate(bool p_subresources) const override;
 
 	// Utility
@@ -226,6 +260,7 @@ private:
 	void _b_set_node_param_null(int node_id, int param_index);
 	void _b_set_node_name(int node_id, String name);
 	float _b_generate_single(Vector3 pos);
+	float _b_get_surface_height(int x, int z, float min_y, float max_y);
 	Vector2 _b_debug_analyze_range(Vector3 min_pos, Vector3 max_pos) const;
 	Dictionary _b_compile();
 	float _b_debug_measure_microseconds_per_voxel(bool singular);
@@ -252,6 +287,7 @@ private:
 	// generation within areas of the block instead of doing it whole.
 	// Blocks size must be a multiple of the subdivision size.
 	bool _use_subdivision = true;
+	bool _use_lod_refinement = false;
 	int _subdivision_size = 16;
 	// When enabled, the generator will attempt to optimize out nodes that don't need to run in specific areas,
 	// if their output range is considered to not affect the final result.
@@ -260,6 +296,9 @@ private:
 	// This prevents recalculating values that would otherwise be the same on each slice.
 	// It helps a lot when part of the graph is generating a heightmap for example.
 	bool _use_xz_caching = true;
+	// When enabled, a compute backend is built on compilation so generation tasks can offload SDF
+	// block generation to the GPU. Only graphs convertible to shader get a backend.
+	bool _use_gpu_generation = false;
 	// If true, inverts clipped blocks so they create visual artifacts making the clipped area visible.
 	bool _debug_clipped_blocks = false;
 
@@ -287,17 +326,129 @@ private:
 	};
 
 	std::shared_ptr<Runtime> _runtime = nullptr;
+	// Also guarded by `_runtime_lock`, assigned together with `_runtime` on compilation
+	std::shared_ptr<VoxelGraphComputeBackend> _compute_backend;
 	RWLock _runtime_lock;
 
 	struct Cache {
 		std::vector<float> x_cache;
 		std::vector<float> y_cache;
 		std::vector<float> z_cache;
-		VoxelGraphRuntime::State state;
+
+		// Runtime states are kept per (compiled program, buffer size): several differently
+		// configured terrains share the worker threads, and bouncing one state between programs
+		// and resolutions reallocated its per-node buffers on every switch. A few slots per
+		// thread cover typical scenes; least-recently-used slots get repurposed.
+		struct StateSlot {
+			// Address of the compiled `Runtime`; recompiles allocate a new one, stale slots age out
+			uint64_t program_key = 0;
+			unsigned int buffer_size = 0;
+			uint64_t last_use = 0;
+			VoxelGraphRuntime::State state;
+		};
+		static const unsigned int STATE_SLOT_COUNT = 6;
+		FixedArray<StateSlot, STATE_SLOT_COUNT> state_slots;
+		uint64_t state_use_counter = 0;
+
+		VoxelGraphRuntime::State &get_state(uint64_t program_key, unsigned int buffer_size) {
+			unsigned int lru_index = 0;
+			uint64_t lru_use = std::numeric_limits<uint64_t>::max();
+			for (unsigned int i = 0; i < state_slots.size(); ++i) {
+				StateSlot &slot = state_slots[i];
+				if (slot.program_key == program_key && slot.buffer_size == buffer_size) {
+					slot.last_use = ++state_use_counter;
+					return slot.state;
+				}
+				if (slot.last_use < lru_use) {
+					lru_use = slot.last_use;
+					lru_index = i;
+				}
+			}
+			StateSlot &slot = state_slots[lru_index];
+			slot.program_key = program_key;
+			slot.buffer_size = buffer_size;
+			slot.last_use = ++state_use_counter;
+			// `prepare_state` re-fits whatever the slot held before; its XZ cache belonged to
+			// another program, it must not be trusted
+			slot.state.cached_xz_signature = 0;
+			return slot.state;
+		}
+
+		// For introspection: the state most recently handed out on this thread
+		VoxelGraphRuntime::State &get_last_used_state() {
+			unsigned int best_index = 0;
+			uint64_t best_use = 0;
+			for (unsigned int i = 0; i < state_slots.size(); ++i) {
+				if (state_slots[i].last_use >= best_use) {
+					best_use = state_slots[i].last_use;
+					best_index = i;
+				}
+			}
+			return state_slots[best_index].state;
+		}
+
 		VoxelGraphRuntime::ExecutionMap optimized_execution_map;
 	};
 
 	static thread_local Cache _cache;
+
+	// Column height LRU, see `get_surface_height`
+	// Coarse cache of range-analysis verdicts over groups of 4x4x4 sections in world space.
+	// Adjacent blocks at the same LOD usually reach identical conclusions; a decisively-air or
+	// decisively-matter group verdict (computed once with one conservative analysis of the whole
+	// group box) lets contained sections skip their per-section interval walk entirely.
+	// Cleared when the compiled runtime changes. Thread-safe.
+	struct RangeVerdictCache {
+		enum Verdict : uint8_t {
+			VERDICT_AIR = 0,
+			VERDICT_MATTER,
+			VERDICT_MIXED,
+		};
+		struct Key {
+			Vector3i group_pos;
+			uint8_t group_po2;
+			inline bool operator==(const Key &other) const {
+				return group_pos == other.group_pos && group_po2 == other.group_po2;
+			}
+		};
+		struct KeyHasher {
+			inline size_t operator()(const Key &k) const {
+				return Vector3iHasher::hash(k.group_pos) ^ (size_t(k.group_po2) << 24);
+			}
+		};
+		static const unsigned int MAX_ENTRIES = 65536;
+		Mutex mutex;
+		std::unordered_map<Key, uint8_t, KeyHasher> verdicts;
+		// Entries belong to one compiled runtime; a recompile clears them
+		const void *runtime_token = nullptr;
+	};
+
+	struct HeightCache {
+		struct Key {
+			int32_t x;
+			int32_t z;
+			inline bool operator==(const Key &other) const {
+				return x == other.x && z == other.z;
+			}
+		};
+		struct KeyHasher {
+			inline size_t operator()(const Key &k) const {
+				return hash_djb2_one_32(uint32_t(k.x), hash_djb2_one_32(uint32_t(k.z)));
+			}
+		};
+		struct Entry {
+			float height;
+			std::list<Key>::iterator lru_it;
+		};
+		static const unsigned int CAPACITY = 1024;
+		Mutex mutex;
+		std::unordered_map<Key, Entry, KeyHasher> map;
+		std::list<Key> lru;
+		// Entries belong to one compiled runtime; a recompile clears them
+		const void *runtime_token = nullptr;
+	};
+	HeightCache _height_cache;
+	mutable RangeVerdictCache _range_verdict_cache;
 };
 
 ProgramGraph::Node *create_node_internal(
@@ -172,6 +172,154 @@ static uint32_t expand_node(ProgramGraph &graph, const ExpressionParser::Node &e
 	}
 }
 
+// See `FusedExpression` in voxel_graph_compiler.h. Emits postfix bytecode for an AST when every
+// operation in it has an opcode and the program fits the fixed limits.
+struct FusedExpressionBuilder {
+	std::vector<uint16_t> ops;
+	std::vector<float> constants;
+	// Index is the input port slot the variable will be connected to
+	std::vector<std::string_view> variables;
+	unsigned int stack_size = 0;
+	unsigned int max_stack_size = 0;
+	// Operations actually doing math; fusing a single one would not gain anything over the
+	// native node the regular expansion produces
+	unsigned int math_op_count = 0;
+};
+
+static bool get_fused_opcode_from_function(
+		unsigned int function_id, FusedExpression::OpCode &out_opcode, unsigned int &out_argument_count) {
+	switch (function_id) {
+		case VoxelGeneratorGraph::NODE_SIN:
+			out_opcode = FusedExpression::OP_SIN;
+			out_argument_count = 1;
+			return true;
+		case VoxelGeneratorGraph::NODE_FLOOR:
+			out_opcode = FusedExpression::OP_FLOOR;
+			out_argument_count = 1;
+			return true;
+		case VoxelGeneratorGraph::NODE_ABS:
+			out_opcode = FusedExpression::OP_ABS;
+			out_argument_count = 1;
+			return true;
+		case VoxelGeneratorGraph::NODE_SQRT:
+			out_opcode = FusedExpression::OP_SQRT;
+			out_argument_count = 1;
+			return true;
+		case VoxelGeneratorGraph::NODE_FRACT:
+			out_opcode = FusedExpression::OP_FRACT;
+			out_argument_count = 1;
+			return true;
+		case VoxelGeneratorGraph::NODE_MIN:
+			out_opcode = FusedExpression::OP_MIN;
+			out_argument_count = 2;
+			return true;
+		case VoxelGeneratorGraph::NODE_MAX:
+			out_opcode = FusedExpression::OP_MAX;
+			out_argument_count = 2;
+			return true;
+		default:
+			return false;
+	}
+}
+
+static bool fused_emit(FusedExpressionBuilder &b, uint16_t op, int stack_delta) {
+	if (b.ops.size() >= FusedExpression::MAX_OPS) {
+		return false;
+	}
+	b.ops.push_back(op);
+	b.stack_size += stack_delta;
+	b.max_stack_size = math::max(b.max_stack_size, b.stack_size);
+	return b.max_stack_size <= FusedExpression::MAX_STACK;
+}
+
+static bool build_fused_expression(const ExpressionParser::Node &ep_node, FusedExpressionBuilder &b) {
+	switch (ep_node.type) {
+		case ExpressionParser::Node::NUMBER: {
+			const ExpressionParser::NumberNode &nn = reinterpret_cast<const ExpressionParser::NumberNode &>(ep_node);
+			unsigned int ci = 0;
+			for (; ci < b.constants.size(); ++ci) {
+				if (b.constants[ci] == nn.value) {
+					break;
+				}
+			}
+			if (ci == b.constants.size()) {
+				if (b.constants.size() >= FusedExpression::MAX_CONSTANTS) {
+					return false;
+				}
+				b.constants.push_back(nn.value);
+			}
+			return fused_emit(b, FusedExpression::make_op(FusedExpression::OP_PUSH_CONST, ci), 1);
+		}
+
+		case ExpressionParser::Node::VARIABLE: {
+			const ExpressionParser::VariableNode &vn =
+					reinterpret_cast<const ExpressionParser::VariableNode &>(ep_node);
+			unsigned int vi = 0;
+			for (; vi < b.variables.size(); ++vi) {
+				if (b.variables[vi] == vn.name) {
+					break;
+				}
+			}
+			if (vi == b.variables.size()) {
+				if (b.variables.size() >= FusedExpression::MAX_VARIABLES) {
+					return false;
+				}
+				b.variables.push_back(vn.name);
+			}
+			return fused_emit(b, FusedExpression::make_op(FusedExpression::OP_PUSH_VAR, vi), 1);
+		}
+
+		case ExpressionParser::Node::OPERATOR: {
+			const ExpressionParser::OperatorNode &on =
+					reinterpret_cast<const ExpressionParser::OperatorNode &>(ep_node);
+			FusedExpression::OpCode opcode;
+			switch (on.op) {
+				case ExpressionParser::OperatorNode::ADD:
+					opcode = FusedExpression::OP_ADD;
+					break;
+				case ExpressionParser::OperatorNode::SUBTRACT:
+					opcode = FusedExpression::OP_SUBTRACT;
+					break;
+				case ExpressionParser::OperatorNode::MULTIPLY:
+					opcode = FusedExpression::OP_MULTIPLY;
+					break;
+				case ExpressionParser::OperatorNode::DIVIDE:
+					opcode = FusedExpression::OP_DIVIDE;
+					break;
+				default:
+					// Notably POWER, which has an optimized node for constant integer exponents
+					return false;
+			}
+			if (!build_fused_expression(*on.n0, b) || !build_fused_expression(*on.n1, b)) {
+				return false;
+			}
+			++b.math_op_count;
+			return fused_emit(b, FusedExpression::make_op(opcode), -1);
+		}
+
+		case ExpressionParser::Node::FUNCTION: {
+			const ExpressionParser::FunctionNode &fn =
+					reinterpret_cast<const ExpressionParser::FunctionNode &>(ep_node);
+			FusedExpression::OpCode opcode;
+			unsigned int argument_count;
+			if (!get_fused_opcode_from_function(fn.function_id, opcode, argument_count)) {
+				return false;
+			}
+			for (unsigned int i = 0; i < argument_count; ++i) {
+				const ExpressionParser::Node *arg = fn.args[i].get();
+				if (arg == nullptr || !build_fused_expression(*arg, b)) {
+					return false;
+				}
+			}
+			++b.math_op_count;
+			return fused_emit(b, FusedExpression::make_op(opcode), 1 - int(argument_count));
+		}
+
+		default:
+			return false;
+	}
+}
+
 static VoxelGraphRuntime::CompilationResult expand_expression_node(ProgramGraph &graph, uint32_t original_node_id,
 		ProgramGraph::PortLocation &expanded_output_port, std::vector<uint32_t> &expanded_nodes,
 		const VoxelGraphNodeDB &type_db) {
@@ -208,18 +356,54 @@ static VoxelGraphRuntime::CompilationResult expand_expression_node(ProgramGraph
 
 	std::vector<ToConnect> to_connect;
 
-	// Create nodes from the expression's AST and connect them together
-	const uint32_t expanded_root_node_id = expand_node(
-			graph, *parse_result.root, VoxelGraphNodeDB::get_singleton(), to_connect, expanded_nodes, functions);
-	if (expanded_root_node_id == ProgramGraph::NULL_ID) {
-		VoxelGraphRuntime::CompilationResult result;
-		result.success = false;
-		result.node_id = original_node_id;
-		result.message = "Internal error";
-		return result;
+	// Prefer the fused single-operation form: it evaluates the whole expression in one buffer
+	// pass instead of one pass per AST operator. Expressions it can't represent fall back to
+	// regular node expansion below.
+	bool fused = false;
+	{
+		FusedExpressionBuilder builder;
+		if (build_fused_expression(*parse_result.root, builder) && builder.math_op_count >= 2) {
+			ProgramGraph::Node &pg_node = create_node(
+					graph, VoxelGraphNodeDB::get_singleton(), VoxelGeneratorGraph::NODE_FUSED_EXPRESSION);
+			expanded_nodes.push_back(pg_node.id);
+
+			PackedInt32Array bytecode;
+			bytecode.resize(builder.ops.size());
+			for (unsigned int i = 0; i < builder.ops.size(); ++i) {
+				bytecode.write[i] = builder.ops[i];
+			}
+			PackedFloat32Array constants;
+			constants.resize(builder.constants.size());
+			for (unsigned int i = 0; i < builder.constants.size(); ++i) {
+				constants.write[i] = builder.constants[i];
+			}
+			CRASH_COND(pg_node.params.size() != 2);
+			pg_node.params[0] = bytecode;
+			pg_node.params[1] = constants;
+
+			for (unsigned int i = 0; i < builder.variables.size(); ++i) {
+				to_connect.push_back({ builder.variables[i], { pg_node.id, i } });
+			}
+
+			expanded_output_port = { pg_node.id, 0 };
+			fused = true;
+		}
 	}
 
-	expanded_output_port = { expanded_root_node_id, 0 };
+	if (!fused) {
+		// Create nodes from the expression's AST and connect them together
+		const uint32_t expanded_root_node_id = expand_node(
+				graph, *parse_result.root, VoxelGraphNodeDB::get_singleton(), to_connect, expanded_nodes, functions);
+		if (expanded_root_node_id == ProgramGraph::NULL_ID) {
+			VoxelGraphRuntime::CompilationResult result;
+			result.success = false;
+			result.node_id = original_node_id;
+			result.message = "Internal error";
+			return result;
+		}
+
+		expanded_output_port = { expanded_root_node_id, 0 };
+	}
 
 	// Add connections from outside the expression to entry nodes of the expression
 	for (const ToConnect tc : to_connect) {
@@ -290,6 +474,244 @@ VoxelGraphRuntime::CompilationResult expand_expression_nodes(
 	return result;
 }
 
+// Chain fusion: contiguous trees of simple arithmetic nodes (the shape stamping and blending
+// setups produce long runs of them) are collapsed into single `NODE_FUSED_EXPRESSION` operations.
+// The interpreter then makes one buffer pass over the whole tree instead of one per node, which
+// is where the inter-node dispatch overhead went. Runs only on non-debug compiles, where
+// per-node inspection (previews, profiling) is not needed.
+
+static bool get_fused_opcode_from_node_type(
+		uint32_t type_id, FusedExpression::OpCode &out_opcode, unsigned int &out_argument_count) {
+	switch (type_id) {
+		case VoxelGeneratorGraph::NODE_ADD:
+			out_opcode = FusedExpression::OP_ADD;
+			out_argument_count = 2;
+			return true;
+		case VoxelGeneratorGraph::NODE_SUBTRACT:
+			out_opcode = FusedExpression::OP_SUBTRACT;
+			out_argument_count = 2;
+			return true;
+		case VoxelGeneratorGraph::NODE_MULTIPLY:
+			out_opcode = FusedExpression::OP_MULTIPLY;
+			out_argument_count = 2;
+			return true;
+		case VoxelGeneratorGraph::NODE_DIVIDE:
+			out_opcode = FusedExpression::OP_DIVIDE;
+			out_argument_count = 2;
+			return true;
+		case VoxelGeneratorGraph::NODE_MIN:
+			out_opcode = FusedExpression::OP_MIN;
+			out_argument_count = 2;
+			return true;
+		case VoxelGeneratorGraph::NODE_MAX:
+			out_opcode = FusedExpression::OP_MAX;
+			out_argument_count = 2;
+			return true;
+		case VoxelGeneratorGraph::NODE_SIN:
+			out_opcode = FusedExpression::OP_SIN;
+			out_argument_count = 1;
+			return true;
+		case VoxelGeneratorGraph::NODE_FLOOR:
+			out_opcode = FusedExpression::OP_FLOOR;
+			out_argument_count = 1;
+			return true;
+		case VoxelGeneratorGraph::NODE_ABS:
+			out_opcode = FusedExpression::OP_ABS;
+			out_argument_count = 1;
+			return true;
+		case VoxelGeneratorGraph::NODE_SQRT:
+			out_opcode = FusedExpression::OP_SQRT;
+			out_argument_count = 1;
+			return true;
+		case VoxelGeneratorGraph::NODE_FRACT:
+			out_opcode = FusedExpression::OP_FRACT;
+			out_argument_count = 1;
+			return true;
+		default:
+			return false;
+	}
+}
+
+static bool is_fusable_chain_node(const ProgramGraph::Node &node) {
+	FusedExpression::OpCode opcode;
+	unsigned int argument_count;
+	return get_fused_opcode_from_node_type(node.type_id, opcode, argument_count);
+}
+
+namespace {
+struct ChainFusionBuilder {
+	std::vector<uint16_t> ops;
+	std::vector<float> constants;
+	// External sources, to be connected to the fused node's input ports in order
+	std::vector<ProgramGraph::PortLocation> variables;
+	// Nodes absorbed into the program, removed from the graph on success
+	std::vector<uint32_t> consumed_node_ids;
+	unsigned int stack_size = 0;
+	unsigned int max_stack_size = 0;
+	unsigned int math_op_count = 0;
+
+	bool emit(uint16_t op, int stack_delta) {
+		if (ops.size() >= FusedExpression::MAX_OPS) {
+			return false;
+		}
+		ops.push_back(op);
+		stack_size += stack_delta;
+		max_stack_size = math::max(max_stack_size, stack_size);
+		return max_stack_size <= FusedExpression::MAX_STACK;
+	}
+
+	bool emit_constant(float value) {
+		unsigned int ci = 0;
+		for (; ci < constants.size(); ++ci) {
+			if (constants[ci] == value) {
+				break;
+			}
+		}
+		if (ci == constants.size()) {
+			if (constants.size() >= FusedExpression::MAX_CONSTANTS) {
+				return false;
+			}
+			constants.push_back(value);
+		}
+		return emit(FusedExpression::make_op(FusedExpression::OP_PUSH_CONST, ci), 1);
+	}
+
+	bool emit_variable(ProgramGraph::PortLocation src) {
+		unsigned int vi = 0;
+		for (; vi < variables.size(); ++vi) {
+			if (variables[vi].node_id == src.node_id && variables[vi].port_index == src.port_index) {
+				break;
+			}
+		}
+		if (vi == variables.size()) {
+			if (variables.size() >= FusedExpression::MAX_VARIABLES) {
+				return false;
+			}
+			variables.push_back(src);
+		}
+		return emit(FusedExpression::make_op(FusedExpression::OP_PUSH_VAR, vi), 1);
+	}
+};
+} // namespace
+
+// Postfix-emits `node` and every single-consumer fusable producer above it
+static bool build_fused_chain(const ProgramGraph &graph, const ProgramGraph::Node &node, ChainFusionBuilder &b) {
+	FusedExpression::OpCode opcode;
+	unsigned int argument_count;
+	if (!get_fused_opcode_from_node_type(node.type_id, opcode, argument_count)) {
+		return false;
+	}
+	CRASH_COND(node.inputs.size() < argument_count);
+
+	for (unsigned int i = 0; i < argument_count; ++i) {
+		const ProgramGraph::Port &port = node.inputs[i];
+
+		if (port.connections.size() == 0) {
+			// Unconnected input, the compiler would have fed it the default value
+			if (!b.emit_constant(node.default_inputs[i].operator float())) {
+				return false;
+			}
+			continue;
+		}
+
+		const ProgramGraph::PortLocation src = port.connections[0];
+		const ProgramGraph::Node &src_node = graph.get_node(src.node_id);
+		const bool single_consumer =
+				src.port_index == 0 && src_node.outputs[0].connections.size() == 1;
+
+		if (single_consumer && is_fusable_chain_node(src_node)) {
+			if (!build_fused_chain(graph, src_node, b)) {
+				return false;
+			}
+			b.consumed_node_ids.push_back(src_node.id);
+			continue;
+		}
+		if (single_consumer && src_node.type_id == VoxelGeneratorGraph::NODE_CONSTANT) {
+			if (!b.emit_constant(src_node.params[0].operator float())) {
+				return false;
+			}
+			b.consumed_node_ids.push_back(src_node.id);
+			continue;
+		}
+		if (!b.emit_variable(src)) {
+			return false;
+		}
+	}
+
+	++b.math_op_count;
+	return b.emit(FusedExpression::make_op(opcode), 1 - int(argument_count));
+}
+
+void fuse_operation_chains(ProgramGraph &graph, const VoxelGraphNodeDB &type_db) {
+	ZN_PROFILE_SCOPE();
+
+	// Roots: fusable nodes whose output does not feed exactly one other fusable node.
+	// Gathered first since fusion removes nodes.
+	std::vector<uint32_t> root_ids;
+	graph.for_each_node_const([&root_ids, &graph](const ProgramGraph::Node &node) {
+		if (!is_fusable_chain_node(node)) {
+			return;
+		}
+		if (node.outputs[0].connections.size() == 0) {
+			// Dead code, the compiler prunes it anyway
+			return;
+		}
+		if (node.outputs[0].connections.size() == 1) {
+			const ProgramGraph::Node &consumer = graph.get_node(node.outputs[0].connections[0].node_id);
+			if (is_fusable_chain_node(consumer)) {
+				return;
+			}
+		}
+		root_ids.push_back(node.id);
+	});
+
+	for (const uint32_t root_id : root_ids) {
+		const ProgramGraph::Node *root = graph.try_get_node(root_id);
+		if (root == nullptr) {
+			// Absorbed by a previous fusion
+			continue;
+		}
+
+		ChainFusionBuilder builder;
+		if (!build_fused_chain(graph, *root, builder) || builder.math_op_count < 2) {
+			// Too short or doesn't fit the fixed limits; the regular per-node path stays
+			continue;
+		}
+		builder.consumed_node_ids.push_back(root_id);
+
+		ProgramGraph::Node &fused_node = create_node(graph, type_db, VoxelGeneratorGraph::NODE_FUSED_EXPRESSION);
+
+		PackedInt32Array bytecode;
+		bytecode.resize(builder.ops.size());
+		for (unsigned int i = 0; i < builder.ops.size(); ++i) {
+			bytecode.write[i] = builder.ops[i];
+		}
+		PackedFloat32Array constants;
+		constants.resize(builder.constants.size());
+		for (unsigned int i = 0; i < builder.constants.size(); ++i) {
+			constants.write[i] = builder.constants[i];
+		}
+		CRASH_COND(fused_node.params.size() != 2);
+		fused_node.params[0] = bytecode;
+		fused_node.params[1] = constants;
+
+		// Copied before removals, which also drop connections
+		const std::vector<ProgramGraph::PortLocation> root_consumers = root->outputs[0].connections;
+		const std::vector<ProgramGraph::PortLocation> variables = builder.variables;
+
+		for (const uint32_t consumed_id : builder.consumed_node_ids) {
+			graph.remove_node(consumed_id);
+		}
+
+		for (unsigned int i = 0; i < variables.size(); ++i) {
+			graph.connect(variables[i], { fused_node.id, i });
+		}
+		for (const ProgramGraph::PortLocation dst : root_consumers) {
+			graph.connect({ fused_node.id, 0 }, dst);
+		}
+	}
+}
+
 VoxelGraphRuntime::CompilationResult VoxelGraphRuntime::compile(const ProgramGraph &p_graph, bool debug) {
 	ZN_PROFILE_SCOPE();
 
@@ -308,6 +730,13 @@ VoxelGraphRuntime::CompilationResult VoxelGraphRuntime::compile(const ProgramGra
 	ERR_FAIL_COND_V(expanded_graph.get_nodes_count() < p_graph.get_nodes_count(),
 			CompilationResult::make_error("Internal error"));
 
+	if (!debug) {
+		// Editor compiles keep one operation per node so previews and per-node profiling still
+		// map back to the graph; game compiles fuse arithmetic chains into single operations,
+		// which can only shrink the node count from here on
+		fuse_operation_chains(expanded_graph, type_db);
+	}
+
 	const VoxelGraphRuntime::CompilationResult result = _compile(expanded_graph, debug, type_db);
 	if (!result.success) {
 		clear();
@@ -23,6 +23,52 @@ struct GraphRemappingInfo {
 VoxelGraphRuntime::CompilationResult expand_expression_nodes(
 		ProgramGraph &graph, const VoxelGraphNodeDB &type_db, GraphRemappingInfo *remap_info);
 
+// Stack-machine bytecode for Expression nodes whose operations can all be fused into a single
+// program operation. Designers lean heavily on expression nodes; expanding them into one graph
+// node per AST operator makes every `+` a full read-modify-write pass over the buffers. The fused
+// form reads each variable once per element and keeps all intermediates on a small stack, so a
+// whole expression costs a single pass. Expressions that exceed these limits, or use operations
+// without an opcode below, fall back to regular node expansion.
+namespace FusedExpression {
+
+static const unsigned int MAX_OPS = 48;
+static const unsigned int MAX_CONSTANTS = 16;
+// Bound by the input ports declared on NODE_FUSED_EXPRESSION
+static const unsigned int MAX_VARIABLES = 4;
+static const unsigned int MAX_STACK = 8;
+
+enum OpCode : uint8_t { //
+	OP_PUSH_CONST, // operand: index in `constants`
+	OP_PUSH_VAR, // operand: input port index
+	OP_ADD,
+	OP_SUBTRACT,
+	OP_MULTIPLY,
+	OP_DIVIDE, // 0 when the divisor is 0, like NODE_DIVIDE
+	OP_MIN,
+	OP_MAX,
+	OP_SIN,
+	OP_FLOOR,
+	OP_ABS,
+	OP_SQRT,
+	OP_FRACT
+};
+
+// Low byte: OpCode. High byte: operand, for push instructions.
+inline uint16_t make_op(OpCode code, uint8_t operand = 0) {
+	return uint16_t(code) | (uint16_t(operand) << 8);
+}
+
+// Compiled program, stored as operation parameters
+struct Params {
+	uint16_t op_count;
+	uint16_t constant_count;
+	FixedArray<uint16_t, MAX_OPS> ops;
+	FixedArray<float, MAX_CONSTANTS> constants;
+};
+
+} // namespace FusedExpression
+
+
 // Functions usable by node implementations during the compilation stage
 class CompileContext {
 public:
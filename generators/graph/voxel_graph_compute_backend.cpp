@@ -0,0 +1,331 @@
+#include "voxel_graph_compute_backend.h"
+#include "../../storage/voxel_buffer_internal.h"
+#include "../../util/log.h"
+#include "../../util/profiling.h"
+#include "../../util/string_funcs.h"
+
+#include <servers/rendering/rendering_device.h>
+#include <servers/rendering_server.h>
+
+namespace zylann::voxel {
+
+namespace {
+
+// Must match `PushConstants` and the layout declared in the shader (std430)
+struct PushConstants {
+	float origin_x;
+	float origin_y;
+	float origin_z;
+	float step;
+	int32_t size_x;
+	int32_t size_y;
+	int32_t size_z;
+	int32_t output_offset;
+	int32_t block_index;
+	int32_t padding0;
+	int32_t padding1;
+	int32_t padding2;
+};
+static_assert(sizeof(PushConstants) == 48, "Push constants must match the shader layout");
+
+const char *g_shader_template_prefix = //
+		"#version 450\n"
+		"\n"
+		"layout(local_size_x = 4, local_size_y = 4, local_size_z = 4) in;\n"
+		"\n"
+		"layout(set = 0, binding = 0, std430) restrict writeonly buffer OutputBuffer {\n"
+		"	float values[];\n"
+		"} u_output;\n"
+		"\n"
+		// Per-block SDF bounds, reduced with atomics over order-preserving float bits so the CPU
+		// can classify whole blocks (all-air / all-matter) without scanning their values
+		"layout(set = 0, binding = 1, std430) restrict buffer StatsBuffer {\n"
+		"	uint values[];\n"
+		"} u_stats;\n"
+		"\n"
+		"layout(push_constant, std430) uniform Params {\n"
+		"	vec3 origin;\n"
+		"	float step;\n"
+		"	ivec3 size;\n"
+		"	int output_offset;\n"
+		"	int block_index;\n"
+		"	int padding0;\n"
+		"	int padding1;\n"
+		"	int padding2;\n"
+		"} u_params;\n"
+		"\n"
+		"uint ordered_float_bits(float f) {\n"
+		"	uint u = floatBitsToUint(f);\n"
+		"	return (u & 0x80000000u) != 0u ? ~u : (u | 0x80000000u);\n"
+		"}\n"
+		"\n";
+
+const char *g_shader_template_suffix = //
+		"\n"
+		"void main() {\n"
+		"	const ivec3 pos = ivec3(gl_GlobalInvocationID.xyz);\n"
+		"	if (pos.x >= u_params.size.x || pos.y >= u_params.size.y || pos.z >= u_params.size.z) {\n"
+		"		return;\n"
+		"	}\n"
+		"	// Matches the ZXY order of VoxelBuffer\n"
+		"	const int index = u_params.output_offset + pos.y + pos.x * u_params.size.y\n"
+		"			+ pos.z * u_params.size.x * u_params.size.y;\n"
+		"	const float sdf = get_sdf(u_params.origin + vec3(pos) * u_params.step);\n"
+		"	u_output.values[index] = sdf;\n"
+		"	const uint ordered = ordered_float_bits(sdf);\n"
+		"	atomicMin(u_stats.values[u_params.block_index * 2], ordered);\n"
+		"	atomicMax(u_stats.values[u_params.block_index * 2 + 1], ordered);\n"
+		"}\n";
+
+inline float decode_ordered_float_bits(uint32_t u) {
+	const uint32_t bits = (u & 0x80000000u) != 0 ? (u & 0x7fffffffu) : ~u;
+	float f;
+	memcpy(&f, &bits, sizeof(f));
+	return f;
+}
+
+} // namespace
+
+VoxelGraphComputeBackend *VoxelGraphComputeBackend::create(const String &sdf_function_code) {
+	ZN_PROFILE_SCOPE();
+
+	RenderingServer *rendering_server = RenderingServer::get_singleton();
+	ERR_FAIL_COND_V(rendering_server == nullptr, nullptr);
+	RenderingDevice *rd = rendering_server->create_local_rendering_device();
+	if (rd == nullptr) {
+		// Headless or driver without compute support
+		ZN_PRINT_VERBOSE("Could not create a local RenderingDevice, GPU generation unavailable");
+		return nullptr;
+	}
+
+	String source;
+	source += g_shader_template_prefix;
+	source += sdf_function_code;
+	source += g_shader_template_suffix;
+
+	String compile_error;
+	const Vector<uint8_t> spirv = rd->shader_compile_spirv_from_source(
+			RenderingDevice::SHADER_STAGE_COMPUTE, source, RenderingDevice::SHADER_LANGUAGE_GLSL, &compile_error);
+	if (spirv.size() == 0) {
+		ERR_PRINT(String("Voxel graph compute shader failed to compile: {0}").format(varray(compile_error)));
+		memdelete(rd);
+		return nullptr;
+	}
+
+	RenderingDevice::ShaderStageSPIRVData stage_data;
+	stage_data.shader_stage = RenderingDevice::SHADER_STAGE_COMPUTE;
+	stage_data.spir_v = spirv;
+	Vector<RenderingDevice::ShaderStageSPIRVData> stages;
+	stages.push_back(stage_data);
+
+	const RID shader = rd->shader_create_from_spirv(stages);
+	if (!shader.is_valid()) {
+		ERR_PRINT("Voxel graph compute shader could not be created");
+		memdelete(rd);
+		return nullptr;
+	}
+
+	const RID pipeline = rd->compute_pipeline_create(shader);
+	if (!pipeline.is_valid()) {
+		ERR_PRINT("Voxel graph compute pipeline could not be created");
+		rd->free(shader);
+		memdelete(rd);
+		return nullptr;
+	}
+
+	VoxelGraphComputeBackend *backend = memnew(VoxelGraphComputeBackend);
+	backend->_rendering_device = rd;
+	backend->_shader = shader;
+	backend->_pipeline = pipeline;
+	return backend;
+}
+
+VoxelGraphComputeBackend::~VoxelGraphComputeBackend() {
+	if (_rendering_device != nullptr) {
+		if (_uniform_set.is_valid()) {
+			_rendering_device->free(_uniform_set);
+		}
+		if (_storage_buffer.is_valid()) {
+			_rendering_device->free(_storage_buffer);
+		}
+		if (_stats_buffer.is_valid()) {
+			_rendering_device->free(_stats_buffer);
+		}
+		if (_pipeline.is_valid()) {
+			_rendering_device->free(_pipeline);
+		}
+		if (_shader.is_valid()) {
+			_rendering_device->free(_shader);
+		}
+		memdelete(_rendering_device);
+	}
+}
+
+bool VoxelGraphComputeBackend::generate_blocks(Span<BlockQuery> queries) {
+	ZN_PROFILE_SCOPE();
+	ERR_FAIL_COND_V(queries.size() == 0, false);
+
+	MutexLock lock(_mutex);
+	RenderingDevice *rd = _rendering_device;
+	ERR_FAIL_COND_V(rd == nullptr, false);
+
+	// All blocks of a batch write to distinct ranges of one storage buffer,
+	// read back with a single transfer once the batch completes
+	uint32_t total_values = 0;
+	for (unsigned int i = 0; i < queries.size(); ++i) {
+		const BlockQuery &query = queries[i];
+		ERR_FAIL_COND_V(query.voxels == nullptr, false);
+		total_values += Vector3iUtil::get_volume(query.voxels->get_size());
+	}
+	const uint32_t required_bytes = total_values * sizeof(float);
+	ERR_FAIL_COND_V(required_bytes == 0, false);
+
+	if (_storage_buffer_capacity < required_bytes) {
+		if (_uniform_set.is_valid()) {
+			rd->free(_uniform_set);
+			_uniform_set = RID();
+		}
+		if (_storage_buffer.is_valid()) {
+			rd->free(_storage_buffer);
+		}
+		_storage_buffer = rd->storage_buffer_create(required_bytes);
+		ERR_FAIL_COND_V(!_storage_buffer.is_valid(), false);
+		_storage_buffer_capacity = required_bytes;
+	}
+
+	// Per-block min/max pairs, reset each batch so the reduction starts neutral
+	const uint32_t stats_bytes = queries.size() * 2 * sizeof(uint32_t);
+	if (_stats_buffer_capacity < stats_bytes) {
+		if (_uniform_set.is_valid()) {
+			rd->free(_uniform_set);
+			_uniform_set = RID();
+		}
+		if (_stats_buffer.is_valid()) {
+			rd->free(_stats_buffer);
+		}
+		_stats_buffer = rd->storage_buffer_create(stats_bytes);
+		ERR_FAIL_COND_V(!_stats_buffer.is_valid(), false);
+		_stats_buffer_capacity = stats_bytes;
+	}
+	{
+		static thread_local std::vector<uint32_t> tls_stats_init;
+		tls_stats_init.resize(queries.size() * 2);
+		for (unsigned int i = 0; i < queries.size(); ++i) {
+			tls_stats_init[i * 2] = 0xffffffffu; // min identity
+			tls_stats_init[i * 2 + 1] = 0u; // max identity
+		}
+		rd->buffer_update(_stats_buffer, 0, stats_bytes, tls_stats_init.data());
+	}
+
+	if (!_uniform_set.is_valid()) {
+		RenderingDevice::Uniform uniform;
+		uniform.uniform_type = RenderingDevice::UNIFORM_TYPE_STORAGE_BUFFER;
+		uniform.binding = 0;
+		uniform.append_id(_storage_buffer);
+		RenderingDevice::Uniform stats_uniform;
+		stats_uniform.uniform_type = RenderingDevice::UNIFORM_TYPE_STORAGE_BUFFER;
+		stats_uniform.binding = 1;
+		stats_uniform.append_id(_stats_buffer);
+		Vector<RenderingDevice::Uniform> uniforms;
+		uniforms.push_back(uniform);
+		uniforms.push_back(stats_uniform);
+		_uniform_set = rd->uniform_set_create(uniforms, _shader, 0);
+		ERR_FAIL_COND_V(!_uniform_set.is_valid(), false);
+	}
+
+	{
+		ZN_PROFILE_SCOPE_NAMED("Dispatch");
+		const RenderingDevice::ComputeListID compute_list = rd->compute_list_begin();
+		rd->compute_list_bind_compute_pipeline(compute_list, _pipeline);
+		rd->compute_list_bind_uniform_set(compute_list, _uniform_set, 0);
+
+		uint32_t output_offset = 0;
+		for (unsigned int i = 0; i < queries.size(); ++i) {
+			const BlockQuery &query = queries[i];
+			const Vector3i block_size = query.voxels->get_size();
+
+			PushConstants push_constants;
+			push_constants.origin_x = query.origin_in_voxels.x;
+			push_constants.origin_y = query.origin_in_voxels.y;
+			push_constants.origin_z = query.origin_in_voxels.z;
+			push_constants.step = float(1 << query.lod);
+			push_constants.size_x = block_size.x;
+			push_constants.size_y = block_size.y;
+			push_constants.size_z = block_size.z;
+			push_constants.output_offset = output_offset;
+			push_constants.block_index = i;
+			push_constants.padding0 = 0;
+			push_constants.padding1 = 0;
+			push_constants.padding2 = 0;
+
+			rd->compute_list_set_push_constant(compute_list, &push_constants, sizeof(push_constants));
+			rd->compute_list_dispatch(
+					compute_list, (block_size.x + 3) / 4, (block_size.y + 3) / 4, (block_size.z + 3) / 4);
+
+			output_offset += Vector3iUtil::get_volume(block_size);
+		}
+		rd->compute_list_end();
+
+		rd->submit();
+		// The wait happens on the calling task thread, other threads keep generating on the CPU
+		rd->sync();
+	}
+
+	// Stats come back first: blocks whose clamped SDF bounds collapse to one stored value (all
+	// air beyond +1, all matter beyond -1 after scaling) fill uniformly, skipping the dense
+	// allocation and the per-voxel conversion entirely. Distant view-only rings are dominated by
+	// such blocks, which is where most of this pipeline's cost used to go. The classification is
+	// lossless: it only applies when clamping would have produced that exact uniform value anyway.
+	const Vector<uint8_t> stats_bytes_data = rd->buffer_get_data(_stats_buffer);
+	ERR_FAIL_COND_V(stats_bytes_data.size() < int64_t(stats_bytes), false);
+	const uint32_t *stats_values = reinterpret_cast<const uint32_t *>(stats_bytes_data.ptr());
+
+	const Vector<uint8_t> output_bytes = rd->buffer_get_data(_storage_buffer);
+	ERR_FAIL_COND_V(output_bytes.size() < int64_t(required_bytes), false);
+	const float *output_values = reinterpret_cast<const float *>(output_bytes.ptr());
+
+	{
+		ZN_PROFILE_SCOPE_NAMED("Readback");
+		unsigned int value_index = 0;
+		for (unsigned int i = 0; i < queries.size(); ++i) {
+			const BlockQuery &query = queries[i];
+			VoxelBufferInternal &voxels = *query.voxels;
+			const Vector3i block_size = voxels.get_size();
+			const unsigned int volume = Vector3iUtil::get_volume(block_size);
+			const float sdf_scale =
+					VoxelBufferInternal::get_sdf_quantization_scale( //
+							voxels.get_channel_depth(VoxelBufferInternal::CHANNEL_SDF));
+
+			const float sdf_min = sdf_scale * decode_ordered_float_bits(stats_values[i * 2]);
+			const float sdf_max = sdf_scale * decode_ordered_float_bits(stats_values[i * 2 + 1]);
+
+			if (sdf_min >= 1.f) {
+				// Every value clamps to +1, exactly what the per-voxel path would store
+				voxels.fill_f(1.f, VoxelBufferInternal::CHANNEL_SDF);
+				value_index += volume;
+				continue;
+			}
+			if (sdf_max <= -1.f) {
+				voxels.fill_f(-1.f, VoxelBufferInternal::CHANNEL_SDF);
+				value_index += volume;
+				continue;
+			}
+
+			// Same ZXY order as the shader writes, so values are consumed sequentially
+			for (int z = 0; z < block_size.z; ++z) {
+				for (int x = 0; x < block_size.x; ++x) {
+					for (int y = 0; y < block_size.y; ++y) {
+						voxels.set_voxel_f(
+								sdf_scale * output_values[value_index], x, y, z, VoxelBufferInternal::CHANNEL_SDF);
+						++value_index;
+					}
+				}
+			}
+			voxels.compress_uniform_channels();
+		}
+	}
+
+	return true;
+}
+
+} // namespace zylann::voxel
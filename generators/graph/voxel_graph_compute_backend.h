@@ -0,0 +1,60 @@
+#ifndef VOXEL_GRAPH_COMPUTE_BACKEND_H
+#define VOXEL_GRAPH_COMPUTE_BACKEND_H
+
+#include "../../util/math/vector3i.h"
+#include "../../util/span.h"
+#include "../../util/thread/mutex.h"
+
+#include <core/string/ustring.h>
+#include <core/templates/rid.h>
+#include <cstdint>
+
+class RenderingDevice;
+
+namespace zylann::voxel {
+
+class VoxelBufferInternal;
+
+// Executes the SDF part of a compiled voxel graph on the GPU as a compute shader.
+// Instances own a local RenderingDevice, so dispatches are independent from the main rendering
+// queue. A device can only process one submission at a time, so batches serialize on an internal
+// mutex; while one task thread waits on the GPU, the others keep generating on the CPU.
+class VoxelGraphComputeBackend {
+public:
+	struct BlockQuery {
+		// SDF channel is written on success
+		VoxelBufferInternal *voxels;
+		Vector3i origin_in_voxels;
+		uint8_t lod;
+	};
+
+	// Builds a backend from the GLSL generated by `generate_shader`, which must define
+	// `float get_sdf(vec3 pos)`. Returns null if no device is available or the shader fails to
+	// compile, in which case generation stays on the CPU.
+	static VoxelGraphComputeBackend *create(const String &sdf_function_code);
+
+	~VoxelGraphComputeBackend();
+
+	// Generates a batch of blocks in a single submission and reads all results back at once.
+	// Returns false if the dispatch could not run, so callers can fall back on the CPU path.
+	bool generate_blocks(Span<BlockQuery> queries);
+
+private:
+	VoxelGraphComputeBackend() {}
+
+	RenderingDevice *_rendering_device = nullptr;
+	RID _shader;
+	RID _pipeline;
+	// Grown as needed and re-used across batches
+	RID _storage_buffer;
+	uint32_t _storage_buffer_capacity = 0;
+	// Per-block SDF min/max reduced on the GPU, so whole blocks classify without scanning
+	RID _stats_buffer;
+	uint32_t _stats_buffer_capacity = 0;
+	RID _uniform_set;
+	Mutex _mutex;
+};
+
+} // namespace zylann::voxel
+
+#endif // VOXEL_GRAPH_COMPUTE_BACKEND_H
@@ -1139,8 +1139,7 @@ VoxelGraphNodeDB::VoxelGraphNodeDB() {
 									   .format(varray(Image::get_class_static())));
 				return;
 			}
-			ImageRangeGrid *im_range = memnew(ImageRangeGrid);
-			im_range->generate(**image);
+			ImageRangeGrid *im_range = get_or_generate_image_range_grid(**image);
 			Params p;
 			p.image = *image;
 			p.image_range_grid = im_range;
@@ -1605,8 +1604,7 @@ VoxelGraphNodeDB::VoxelGraphNodeDB() {
 									   .format(varray(Image::get_class_static())));
 				return;
 			}
-			ImageRangeGrid *im_range = memnew(ImageRangeGrid);
-			im_range->generate(**image);
+			ImageRangeGrid *im_range = get_or_generate_image_range_grid(**image);
 			const float factor = ctx.get_param(2);
 			const Interval range = im_range->get_range() * factor;
 			Params p;
@@ -1738,9 +1736,8 @@ VoxelGraphNodeDB::VoxelGraphNodeDB() {
 			const VoxelGraphRuntime::Buffer &y = ctx.get_input(1);
 			VoxelGraphRuntime::Buffer &out = ctx.get_output(0);
 			const Params p = ctx.get_params<Params>();
-			for (uint32_t i = 0; i < out.size; ++i) {
-				out.data[i] = p.noise->get_noise_2d(x.data[i], y.data[i]);
-			}
+			p.noise->get_noise_2d_series(Span<const float>(x.data, x.size), Span<const float>(y.data, y.size),
+					Span<float>(out.data, out.size));
 		};
 
 		t.range_analysis_func = [](RangeAnalysisContext &ctx) {
@@ -1806,9 +1803,8 @@ VoxelGraphNodeDB::VoxelGraphNodeDB() {
 			const VoxelGraphRuntime::Buffer &z = ctx.get_input(2);
 			VoxelGraphRuntime::Buffer &out = ctx.get_output(0);
 			const Params p = ctx.get_params<Params>();
-			for (uint32_t i = 0; i < out.size; ++i) {
-				out.data[i] = p.noise->get_noise_3d(x.data[i], y.data[i], z.data[i]);
-			}
+			p.noise->get_noise_3d_series(Span<const float>(x.data, x.size), Span<const float>(y.data, y.size),
+					Span<const float>(z.data, z.size), Span<float>(out.data, out.size));
 		};
 
 		t.range_analysis_func = [](RangeAnalysisContext &ctx) {
@@ -2158,6 +2154,341 @@ VoxelGraphNodeDB::VoxelGraphNodeDB() {
 			ctx.add_format("{} = pow({}, {});\n", ctx.get_output_name(0), ctx.get_input_name(0), ctx.get_input_name(1));
 		};
 	}
+	{
+		NodeType &t = types[VoxelGeneratorGraph::NODE_FUSED_EXPRESSION];
+		t.name = "_FusedExpression";
+		t.category = CATEGORY_MATH;
+		// Only produced by expression expansion, see `FusedExpression` in voxel_graph_compiler.h
+		t.internal = true;
+		t.inputs.push_back(Port("a"));
+		t.inputs.push_back(Port("b"));
+		t.inputs.push_back(Port("c"));
+		t.inputs.push_back(Port("d"));
+		t.outputs.push_back(Port("out"));
+		t.params.push_back(Param("bytecode", Variant::PACKED_INT32_ARRAY));
+		t.params.push_back(Param("constants", Variant::PACKED_FLOAT32_ARRAY));
+
+		t.compile_func = [](CompileContext &ctx) {
+			const PackedInt32Array bytecode = ctx.get_param(0);
+			const PackedFloat32Array constants = ctx.get_param(1);
+			if (bytecode.size() == 0 || bytecode.size() > int(FusedExpression::MAX_OPS) ||
+					constants.size() > int(FusedExpression::MAX_CONSTANTS)) {
+				ctx.make_error(ZN_TTR("Invalid fused expression program"));
+				return;
+			}
+			FusedExpression::Params p;
+			p.op_count = bytecode.size();
+			p.constant_count = constants.size();
+			for (int i = 0; i < bytecode.size(); ++i) {
+				p.ops[i] = uint16_t(bytecode[i]);
+			}
+			for (int i = 0; i < constants.size(); ++i) {
+				p.constants[i] = constants[i];
+			}
+			ctx.set_params(p);
+		};
+
+		t.process_buffer_func = [](ProcessBufferContext &ctx) {
+			const FusedExpression::Params &p = ctx.get_params<FusedExpression::Params>();
+			FixedArray<const VoxelGraphRuntime::Buffer *, FusedExpression::MAX_VARIABLES> vars;
+			for (unsigned int i = 0; i < vars.size(); ++i) {
+				vars[i] = &ctx.get_input(i);
+			}
+			VoxelGraphRuntime::Buffer &out = ctx.get_output(0);
+
+			// One pass over the buffers: variables are read once per element and every
+			// intermediate stays on a tiny stack, instead of one full buffer pass per operator
+			for (unsigned int i = 0; i < out.size; ++i) {
+				FixedArray<float, FusedExpression::MAX_STACK> stack;
+				unsigned int sp = 0;
+				for (unsigned int j = 0; j < p.op_count; ++j) {
+					const uint16_t op = p.ops[j];
+					const unsigned int operand = op >> 8;
+					switch (FusedExpression::OpCode(op & 0xff)) {
+						case FusedExpression::OP_PUSH_CONST:
+							stack[sp++] = p.constants[operand];
+							break;
+						case FusedExpression::OP_PUSH_VAR: {
+							const VoxelGraphRuntime::Buffer &vb = *vars[operand];
+							stack[sp++] = vb.is_constant ? vb.constant_value : vb.data[i];
+						} break;
+						case FusedExpression::OP_ADD:
+							--sp;
+							stack[sp - 1] += stack[sp];
+							break;
+						case FusedExpression::OP_SUBTRACT:
+							--sp;
+							stack[sp - 1] -= stack[sp];
+							break;
+						case FusedExpression::OP_MULTIPLY:
+							--sp;
+							stack[sp - 1] *= stack[sp];
+							break;
+						case FusedExpression::OP_DIVIDE:
+							--sp;
+							stack[sp - 1] = stack[sp] == 0.f ? 0.f : stack[sp - 1] / stack[sp];
+							break;
+						case FusedExpression::OP_MIN:
+							--sp;
+							stack[sp - 1] = math::min(stack[sp - 1], stack[sp]);
+							break;
+						case FusedExpression::OP_MAX:
+							--sp;
+							stack[sp - 1] = math::max(stack[sp - 1], stack[sp]);
+							break;
+						case FusedExpression::OP_SIN:
+							stack[sp - 1] = Math::sin(stack[sp - 1]);
+							break;
+						case FusedExpression::OP_FLOOR:
+							stack[sp - 1] = Math::floor(stack[sp - 1]);
+							break;
+						case FusedExpression::OP_ABS:
+							stack[sp - 1] = Math::abs(stack[sp - 1]);
+							break;
+						case FusedExpression::OP_SQRT:
+							stack[sp - 1] = Math::sqrt(stack[sp - 1]);
+							break;
+						case FusedExpression::OP_FRACT:
+							stack[sp - 1] = stack[sp - 1] - Math::floor(stack[sp - 1]);
+							break;
+					}
+				}
+				out.data[i] = stack[0];
+			}
+		};
+
+		t.range_analysis_func = [](RangeAnalysisContext &ctx) {
+			const FusedExpression::Params &p = ctx.get_params<FusedExpression::Params>();
+			// Same program, interpreted over intervals, so range-based execution skipping keeps
+			// working as if the expression had been expanded into individual nodes
+			FixedArray<Interval, FusedExpression::MAX_STACK> stack;
+			unsigned int sp = 0;
+			for (unsigned int j = 0; j < p.op_count; ++j) {
+				const uint16_t op = p.ops[j];
+				const unsigned int operand = op >> 8;
+				switch (FusedExpression::OpCode(op & 0xff)) {
+					case FusedExpression::OP_PUSH_CONST:
+						stack[sp++] = Interval::from_single_value(p.constants[operand]);
+						break;
+					case FusedExpression::OP_PUSH_VAR:
+						stack[sp++] = ctx.get_input(operand);
+						break;
+					case FusedExpression::OP_ADD:
+						--sp;
+						stack[sp - 1] = stack[sp - 1] + stack[sp];
+						break;
+					case FusedExpression::OP_SUBTRACT:
+						--sp;
+						stack[sp - 1] = stack[sp - 1] - stack[sp];
+						break;
+					case FusedExpression::OP_MULTIPLY:
+						--sp;
+						stack[sp - 1] = stack[sp - 1] * stack[sp];
+						break;
+					case FusedExpression::OP_DIVIDE:
+						--sp;
+						stack[sp - 1] = stack[sp - 1] / stack[sp];
+						break;
+					case FusedExpression::OP_MIN:
+						--sp;
+						stack[sp - 1] = min_interval(stack[sp - 1], stack[sp]);
+						break;
+					case FusedExpression::OP_MAX:
+						--sp;
+						stack[sp - 1] = max_interval(stack[sp - 1], stack[sp]);
+						break;
+					case FusedExpression::OP_SIN:
+						stack[sp - 1] = sin(stack[sp - 1]);
+						break;
+					case FusedExpression::OP_FLOOR:
+						stack[sp - 1] = floor(stack[sp - 1]);
+						break;
+					case FusedExpression::OP_ABS:
+						stack[sp - 1] = abs(stack[sp - 1]);
+						break;
+					case FusedExpression::OP_SQRT:
+						stack[sp - 1] = sqrt(stack[sp - 1]);
+						break;
+					case FusedExpression::OP_FRACT:
+						stack[sp - 1] = stack[sp - 1] - floor(stack[sp - 1]);
+						break;
+				}
+			}
+			ctx.set_output(0, stack[0]);
+		};
+
+		t.shader_gen_func = [](ShaderGenContext &ctx) {
+			const PackedInt32Array bytecode = ctx.get_param(0);
+			const PackedFloat32Array constants = ctx.get_param(1);
+			// Replay the program over expression strings; precedence is handled with parentheses
+			FixedArray<std::string, FusedExpression::MAX_STACK> stack;
+			unsigned int sp = 0;
+			for (int j = 0; j < bytecode.size(); ++j) {
+				const uint16_t op = uint16_t(bytecode[j]);
+				const unsigned int operand = op >> 8;
+				switch (FusedExpression::OpCode(op & 0xff)) {
+					case FusedExpression::OP_PUSH_CONST:
+						stack[sp++] = format("{}", constants[operand]);
+						break;
+					case FusedExpression::OP_PUSH_VAR:
+						stack[sp++] = ctx.get_input_name(operand);
+						break;
+					case FusedExpression::OP_ADD:
+						--sp;
+						stack[sp - 1] = format("({} + {})", stack[sp - 1], stack[sp]);
+						break;
+					case FusedExpression::OP_SUBTRACT:
+						--sp;
+						stack[sp - 1] = format("({} - {})", stack[sp - 1], stack[sp]);
+						break;
+					case FusedExpression::OP_MULTIPLY:
+						--sp;
+						stack[sp - 1] = format("({} * {})", stack[sp - 1], stack[sp]);
+						break;
+					case FusedExpression::OP_DIVIDE:
+						--sp;
+						stack[sp - 1] = format("({} / {})", stack[sp - 1], stack[sp]);
+						break;
+					case FusedExpression::OP_MIN:
+						--sp;
+						stack[sp - 1] = format("min({}, {})", stack[sp - 1], stack[sp]);
+						break;
+					case FusedExpression::OP_MAX:
+						--sp;
+						stack[sp - 1] = format("max({}, {})", stack[sp - 1], stack[sp]);
+						break;
+					case FusedExpression::OP_SIN:
+						stack[sp - 1] = format("sin({})", stack[sp - 1]);
+						break;
+					case FusedExpression::OP_FLOOR:
+						stack[sp - 1] = format("floor({})", stack[sp - 1]);
+						break;
+					case FusedExpression::OP_ABS:
+						stack[sp - 1] = format("abs({})", stack[sp - 1]);
+						break;
+					case FusedExpression::OP_SQRT:
+						stack[sp - 1] = format("sqrt({})", stack[sp - 1]);
+						break;
+					case FusedExpression::OP_FRACT:
+						stack[sp - 1] = format("fract({})", stack[sp - 1]);
+						break;
+				}
+			}
+			ctx.add_format("{} = {};\n", ctx.get_output_name(0), stack[0]);
+		};
+	}
+	{
+		struct Params {
+			float smoothness;
+		};
+		// Unconnected inputs default to a value so far outside that smooth union returns the
+		// other operand exactly, making them free to leave dangling
+		const float neutral = 1000000.f;
+
+		NodeType &t = types[VoxelGeneratorGraph::NODE_SDF_SMOOTH_UNION_N];
+		t.name = "SdfSmoothUnionN";
+		t.category = CATEGORY_SDF;
+		t.inputs.push_back(Port("a", neutral));
+		t.inputs.push_back(Port("b", neutral));
+		t.inputs.push_back(Port("c", neutral));
+		t.inputs.push_back(Port("d", neutral));
+		t.inputs.push_back(Port("e", neutral));
+		t.inputs.push_back(Port("f", neutral));
+		t.inputs.push_back(Port("g", neutral));
+		t.inputs.push_back(Port("h", neutral));
+		t.outputs.push_back(Port("sdf"));
+		t.params.push_back(Param("smoothness", Variant::FLOAT, 0.f));
+		t.compile_func = [](CompileContext &ctx) {
+			Params p;
+			p.smoothness = ctx.get_param(0).operator float();
+			ctx.set_params(p);
+		};
+		t.process_buffer_func = [](ProcessBufferContext &ctx) {
+			ZN_PROFILE_SCOPE_NAMED("NODE_SDF_SMOOTH_UNION_N");
+			const Params params = ctx.get_params<Params>();
+			const float neutral_threshold = 500000.f;
+
+			// Combining N shapes through chained binary nodes costs a full buffer sweep per
+			// node; here all connected inputs fold in a single pass, each element read once
+			FixedArray<const VoxelGraphRuntime::Buffer *, 8> inputs;
+			unsigned int input_count = 0;
+			for (unsigned int i = 0; i < 8; ++i) {
+				bool ignored;
+				const VoxelGraphRuntime::Buffer &b = ctx.try_get_input(i, ignored);
+				if (ignored) {
+					continue;
+				}
+				if (b.is_constant && b.constant_value >= neutral_threshold) {
+					// Unconnected port
+					continue;
+				}
+				inputs[input_count++] = &b;
+			}
+
+			VoxelGraphRuntime::Buffer &out = ctx.get_output(0);
+
+			if (input_count == 0) {
+				for (uint32_t i = 0; i < out.size; ++i) {
+					out.data[i] = neutral_threshold;
+				}
+				return;
+			}
+			if (input_count == 1) {
+				const VoxelGraphRuntime::Buffer &a = *inputs[0];
+				for (uint32_t i = 0; i < out.size; ++i) {
+					out.data[i] = a.data[i];
+				}
+				return;
+			}
+
+			if (params.smoothness > 0.0001f) {
+				for (uint32_t i = 0; i < out.size; ++i) {
+					float acc = inputs[0]->data[i];
+					for (unsigned int j = 1; j < input_count; ++j) {
+						acc = math::sdf_smooth_union(acc, inputs[j]->data[i], params.smoothness);
+					}
+					out.data[i] = acc;
+				}
+			} else {
+				// Fallback on hard-union, smooth union does not support zero smoothness
+				for (uint32_t i = 0; i < out.size; ++i) {
+					float acc = inputs[0]->data[i];
+					for (unsigned int j = 1; j < input_count; ++j) {
+						acc = math::sdf_union(acc, inputs[j]->data[i]);
+					}
+					out.data[i] = acc;
+				}
+			}
+		};
+		t.range_analysis_func = [](RangeAnalysisContext &ctx) {
+			const Params params = ctx.get_params<Params>();
+			// No per-input ignoring: with N operands the "only one side matters" analysis of the
+			// binary node does not transpose cheaply, and folding intervals is already tight
+			Interval acc = ctx.get_input(0);
+			for (unsigned int i = 1; i < 8; ++i) {
+				const Interval b = ctx.get_input(i);
+				if (params.smoothness > 0.0001f) {
+					acc = math::sdf_smooth_union(acc, b, params.smoothness);
+				} else {
+					acc = math::sdf_union(acc, b);
+				}
+			}
+			ctx.set_output(0, acc);
+		};
+		t.shader_gen_func = [](ShaderGenContext &ctx) {
+			ctx.require_lib_code("sdf_smooth_union",
+					"float vg_sdf_smooth_union(float a, float b, float s) {\n"
+					"	float h = clamp(0.5 + 0.5 * (b - a) / s, 0.0, 1.0);\n"
+					"	return mix(b, a, h) - s * h * (1.0 - h);\n"
+					"}\n");
+			const float smoothness = ctx.get_param(0);
+			ctx.add_format("{} = {};\n", ctx.get_output_name(0), ctx.get_input_name(0));
+			for (unsigned int i = 1; i < 8; ++i) {
+				ctx.add_format("{} = vg_sdf_smooth_union({}, {}, {});\n", ctx.get_output_name(0),
+						ctx.get_output_name(0), ctx.get_input_name(i), smoothness);
+			}
+		};
+	}
 
 	CRASH_COND(_expression_functions.size() > 0);
 
@@ -2185,6 +2516,9 @@ VoxelGraphNodeDB::VoxelGraphNodeDB() {
 
 				case Variant::OBJECT:
 				case Variant::STRING:
+				// Used by internal nodes to carry compiled programs
+				case Variant::PACKED_INT32_ARRAY:
+				case Variant::PACKED_FLOAT32_ARRAY:
 					break;
 
 				default:
@@ -53,6 +53,9 @@ public:
 		bool debug_only = false;
 		// Pseudo nodes are replaced during compilation with one or multiple real nodes, they have no logic on their own
 		bool is_pseudo_node = false;
+		// Internal nodes are only created by compilation passes; they can't be created by the user
+		// and never appear in saved graphs
+		bool internal = false;
 		Category category;
 		std::vector<Port> inputs;
 		std::vector<Port> outputs;
@@ -1,4 +1,5 @@
 #include "voxel_graph_runtime.h"
+#include "../../util/lightweight_profiler.h"
 #include "../../util/container_funcs.h"
 #include "../../util/log.h"
 #include "../../util/macros.h"
@@ -369,6 +370,7 @@ static inline Span<const uint8_t> read_params(Span<const uint16_t> operations, u
 
 void VoxelGraphRuntime::generate_set(State &state, Span<float> in_x, Span<float> in_y, Span<float> in_z, bool skip_xz,
 		const ExecutionMap *execution_map) const {
+	ZN_LIGHT_PROFILE_SCOPE("graph_generate_set");
 	// I don't like putting private helper functions in headers.
 	struct L {
 		static inline void bind_buffer(Span<Buffer> buffers, int a, Span<float> d) {
@@ -89,6 +89,10 @@ public:
 			return buffers[address];
 		}
 
+		inline unsigned int get_buffer_count() const {
+			return buffers.size();
+		}
+
 		inline const math::Interval get_range(uint16_t address) const {
 			// TODO Just for convenience because STL bound checks aren't working in Godot 3
 			CRASH_COND(address >= buffers.size());
@@ -107,8 +111,15 @@ public:
 			buffers.clear();
 			ranges.clear();
 			debug_profiler_times.clear();
+			cached_xz_signature = 0;
 		}
 
+		// Scratch for callers: identifies which XZ-invariant slice the Y-independent operation
+		// outputs currently held in the buffers were computed for. Lets vertically-stacked blocks
+		// of the same column skip the whole XZ prefix, not just slices within one block.
+		// 0 means unknown/invalid.
+		uint64_t cached_xz_signature = 0;
+
 		inline void add_execution_time(uint32_t execution_map_index, uint32_t time) {
 #if DEBUG_ENABLED
 			CRASH_COND(execution_map_index >= debug_profiler_times.size());
@@ -36,6 +36,7 @@ int VoxelGeneratorHeightmap::get_used_channels_mask() const {
 void VoxelGeneratorHeightmap::set_height_start(float start) {
 	RWLockWrite wlock(_parameters_lock);
 	_parameters.range.start = start;
+	invalidate_column_cache();
 }
 
 float VoxelGeneratorHeightmap::get_height_start() const {
@@ -46,6 +47,7 @@ float VoxelGeneratorHeightmap::get_height_start() const {
 void VoxelGeneratorHeightmap::set_height_range(float range) {
 	RWLockWrite wlock(_parameters_lock);
 	_parameters.range.height = range;
+	invalidate_column_cache();
 }
 
 float VoxelGeneratorHeightmap::get_height_range() const {
@@ -5,6 +5,8 @@
 #include "../voxel_generator.h"
 #include <core/io/image.h>
 
+#include <atomic>
+
 namespace zylann::voxel {
 
 // Common base class for basic heightmap generators
@@ -29,6 +31,12 @@ public:
 	float get_iso_scale() const;
 
 protected:
+	// Must be called by any setter that changes produced heights; invalidates per-thread column
+	// caches
+	void invalidate_column_cache() {
+		_column_cache_version.fetch_add(1, std::memory_order_acq_rel);
+	}
+
 	void _b_set_channel(gd::VoxelBuffer::ChannelId p_channel);
 	gd::VoxelBuffer::ChannelId _b_get_channel() const;
 
@@ -44,6 +52,30 @@ protected:
 		const Vector3i bs = out_buffer.get_size();
 		const bool use_sdf = channel == VoxelBufferInternal::CHANNEL_SDF;
 
+		// Heights only depend on (x, z): blocks of the same vertical stack share them. The last
+		// computed column slab is kept per thread, keyed by generator, column origin, lod and a
+		// version bumped by any setter affecting heights; stacks streaming through the same
+		// worker back to back then sample their source once per column instead of once per block.
+		struct ColumnSlab {
+			// ObjectID: never reused, unlike addresses
+			uint64_t generator_id = 0;
+			uint64_t version = 0;
+			int origin_x = 0;
+			int origin_z = 0;
+			int lod = -1;
+			int size_x = 0;
+			int size_z = 0;
+			std::vector<float> heights;
+		};
+		static thread_local ColumnSlab tls_column_slab;
+		ColumnSlab &slab = tls_column_slab;
+
+		const uint64_t cache_version = _column_cache_version.load(std::memory_order_acquire);
+		const uint64_t generator_id = uint64_t(get_instance_id());
+		const bool slab_warm = slab.generator_id == generator_id && slab.version == cache_version &&
+				slab.origin_x == origin.x && slab.origin_z == origin.z && slab.lod == lod && slab.size_x == bs.x &&
+				slab.size_z == bs.z;
+
 		if (origin.y > get_height_start() + get_height_range()) {
 			// The bottom of the block is above the highest ground can go (default is air)
 			Result result;
@@ -60,14 +92,30 @@ protected:
 
 		const int stride = 1 << lod;
 
-		if (use_sdf) {
+		if (!slab_warm) {
+			slab.heights.resize(bs.x * bs.z);
 			int gz = origin.z;
-
+			unsigned int i = 0;
 			for (int z = 0; z < bs.z; ++z, gz += stride) {
 				int gx = origin.x;
+				for (int x = 0; x < bs.x; ++x, gx += stride, ++i) {
+					slab.heights[i] = params.range.xform(height_func(gx, gz));
+				}
+			}
+			slab.generator_id = generator_id;
+			slab.version = cache_version;
+			slab.origin_x = origin.x;
+			slab.origin_z = origin.z;
+			slab.lod = lod;
+			slab.size_x = bs.x;
+			slab.size_z = bs.z;
+		}
 
-				for (int x = 0; x < bs.x; ++x, gx += stride) {
-					float h = params.range.xform(height_func(gx, gz));
+		if (use_sdf) {
+			unsigned int i = 0;
+			for (int z = 0; z < bs.z; ++z) {
+				for (int x = 0; x < bs.x; ++x, ++i) {
+					const float h = slab.heights[i];
 					int gy = origin.y;
 					for (int y = 0; y < bs.y; ++y, gy += stride) {
 						float sdf = params.iso_scale * (gy - h);
@@ -80,14 +128,11 @@ protected:
 		} else {
 			// Blocky
 
-			int gz = origin.z;
-
-			for (int z = 0; z < bs.z; ++z, gz += stride) {
-				int gx = origin.x;
-
-				for (int x = 0; x < bs.x; ++x, gx += stride) {
+			unsigned int i = 0;
+			for (int z = 0; z < bs.z; ++z) {
+				for (int x = 0; x < bs.x; ++x, ++i) {
 					// Output is blocky, so we can go for just one sample
-					float h = params.range.xform(height_func(gx, gz));
+					float h = slab.heights[i];
 					h -= origin.y;
 					int ih = int(h) >> lod;
 					if (ih > 0) {
@@ -125,6 +170,8 @@ private:
 	};
 
 	RWLock _parameters_lock;
+	// See `invalidate_column_cache`
+	std::atomic_uint64_t _column_cache_version = { 0 };
 	Parameters _parameters;
 };
 
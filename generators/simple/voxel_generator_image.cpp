@@ -39,6 +39,7 @@ void VoxelGeneratorImage::set_image(Ref<Image> im) {
 	}
 	RWLockWrite wlock(_parameters_lock);
 	_parameters.image = copy;
+	invalidate_column_cache();
 }
 
 Ref<Image> VoxelGeneratorImage::get_image() const {
@@ -48,6 +49,7 @@ Ref<Image> VoxelGeneratorImage::get_image() const {
 void VoxelGeneratorImage::set_blur_enabled(bool enable) {
 	RWLockWrite wlock(_parameters_lock);
 	_parameters.blur_enabled = enable;
+	invalidate_column_cache();
 }
 
 bool VoxelGeneratorImage::is_blur_enabled() const {
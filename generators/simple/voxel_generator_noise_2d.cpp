@@ -28,6 +28,7 @@ void VoxelGeneratorNoise2D::set_noise(Ref<Noise> noise) {
 	}
 	RWLockWrite wlock(_parameters_lock);
 	_parameters.noise = copy;
+	invalidate_column_cache();
 }
 
 Ref<Noise> VoxelGeneratorNoise2D::get_noise() const {
@@ -53,6 +54,7 @@ void VoxelGeneratorNoise2D::set_curve(Ref<Curve> curve) {
 	} else {
 		_parameters.curve.unref();
 	}
+	invalidate_column_cache();
 }
 
 Ref<Curve> VoxelGeneratorNoise2D::get_curve() const {
@@ -94,6 +96,7 @@ void VoxelGeneratorNoise2D::_on_noise_changed() {
 	ERR_FAIL_COND(_noise.is_null());
 	RWLockWrite wlock(_parameters_lock);
 	_parameters.noise = _noise->duplicate();
+	invalidate_column_cache();
 }
 
 void VoxelGeneratorNoise2D::_on_curve_changed() {
@@ -101,6 +104,7 @@ void VoxelGeneratorNoise2D::_on_curve_changed() {
 	RWLockWrite wlock(_parameters_lock);
 	_parameters.curve = _curve->duplicate();
 	_parameters.curve->bake();
+	invalidate_column_cache();
 }
 
 void VoxelGeneratorNoise2D::_bind_methods() {
@@ -10,6 +10,12 @@ VoxelGenerator::Result VoxelGenerator::generate_block(VoxelQueryData &input) {
 	return Result();
 }
 
+void VoxelGenerator::generate_block_batch(Span<VoxelQueryData> p_queries) {
+	for (unsigned int i = 0; i < p_queries.size(); ++i) {
+		generate_block(p_queries[i]);
+	}
+}
+
 int VoxelGenerator::get_used_channels_mask() const {
 	return 0;
 }
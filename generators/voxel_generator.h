@@ -1,6 +1,8 @@
 #ifndef VOXEL_GENERATOR_H
 #define VOXEL_GENERATOR_H
 
+#include "../util/span.h"
+
 #include <core/io/resource.h>
 #include <core/math/vector3i.h>
 #include <core/variant/typed_array.h>
@@ -39,11 +41,50 @@ public:
 		VoxelBufferInternal &voxel_buffer;
 		Vector3i origin_in_voxels;
 		uint8_t lod;
+		// Optional coarse version of the same area (the parent LOD block covering it), letting
+		// LOD-consistent generators seed far-from-surface voxels from it instead of recomputing
+		// them. See `supports_lod_refinement`.
+		const VoxelBufferInternal *coarse_voxels = nullptr;
+		// Which octant of `coarse_voxels` this block covers (bit 0 = X, bit 1 = Y, bit 2 = Z)
+		uint8_t coarse_octant = 0;
+		// Bitmask of VoxelBufferInternal channels the caller actually needs. Generators may use
+		// it to skip work feeding other channels (a collision-only refresh has no use for texture
+		// weights); channels outside the mask are left untouched. Defaults to everything, which
+		// callers storing the result (streaming generation) must keep.
+		uint32_t requested_channels = 0xffffffff;
 	};
 
 	virtual Result generate_block(VoxelQueryData &input);
 	// TODO Single sample
 
+	// Tells if this generator can reuse coarser data from a parent LOD block when generating
+	// (see `VoxelQueryData::coarse_voxels`). Schedulers only pay for the parent snapshot when true.
+	virtual bool supports_lod_refinement() const {
+		return false;
+	}
+
+	// Tells if this generator prefers receiving several blocks per call. Generators implemented in
+	// scripts pay a fixed cost to cross into user code, so the server hands them whole batches.
+	virtual bool supports_batched_generation() const {
+		return false;
+	}
+
+	// Generates several blocks in one call. All queries have the same LOD. The default just runs
+	// `generate_block` on each query.
+	virtual void generate_block_batch(Span<VoxelQueryData> p_queries);
+
+	// Tells if this generator can currently execute on the GPU via `generate_block_gpu`.
+	// Generation tasks use this to offload work when the CPU queue gets deep.
+	virtual bool supports_gpu_generation() const {
+		return false;
+	}
+
+	// Runs generation of one block on the GPU. Returns false if it could not run (no device, shader
+	// not compiled...), in which case the caller should use `generate_block` instead.
+	virtual bool generate_block_gpu(VoxelQueryData &input) {
+		return false;
+	}
+
 	virtual bool supports_single_generation() const {
 		return false;
 	}
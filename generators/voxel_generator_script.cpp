@@ -1,6 +1,7 @@
 #include "voxel_generator_script.h"
 #include "../constants/voxel_string_names.h"
 #include "../storage/voxel_buffer_gd.h"
+#include "../util/errors.h"
 #include "../util/godot/funcs.h"
 
 namespace zylann::voxel {
@@ -32,6 +33,56 @@ VoxelGenerator::Result VoxelGeneratorScript::generate_block(VoxelGenerator::Voxe
 	return result;
 }
 
+bool VoxelGeneratorScript::supports_batched_generation() const {
+	// `has_method` rather than a cached flag, so attaching or editing the script while running
+	// behaves as expected. This is only called once per batch.
+	ScriptInstance *script = const_cast<VoxelGeneratorScript *>(this)->get_script_instance();
+	return script != nullptr && script->has_method(VoxelStringNames::get_singleton()._generate_blocks);
+}
+
+void VoxelGeneratorScript::generate_block_batch(Span<VoxelGenerator::VoxelQueryData> p_queries) {
+	if (p_queries.size() == 0) {
+		return;
+	}
+	const int lod = p_queries[0].lod;
+
+	// Create temporary wrappers so Godot can pass them to scripts.
+	// Origins are passed as Vector3i like in `_generate_block`, so far origins stay exact.
+	Array buffer_wrappers;
+	buffer_wrappers.resize(p_queries.size());
+	Array origins;
+	origins.resize(p_queries.size());
+
+	for (unsigned int i = 0; i < p_queries.size(); ++i) {
+		VoxelGenerator::VoxelQueryData &q = p_queries[i];
+#ifdef DEBUG_ENABLED
+		ZN_ASSERT(q.lod == lod);
+#endif
+		Ref<gd::VoxelBuffer> buffer_wrapper;
+		buffer_wrapper.instantiate();
+		buffer_wrapper->get_buffer().copy_format(q.voxel_buffer);
+		buffer_wrapper->get_buffer().create(q.voxel_buffer.get_size());
+		buffer_wrappers[i] = buffer_wrapper;
+		origins[i] = q.origin_in_voxels;
+	}
+
+	if (!GDVIRTUAL_CALL(_generate_blocks, buffer_wrappers, origins, lod)) {
+		// `supports_batched_generation` said otherwise, fall back to per-block calls
+		WARN_PRINT_ONCE("VoxelGeneratorScript::_generate_blocks failed to be called!");
+		for (unsigned int i = 0; i < p_queries.size(); ++i) {
+			generate_block(p_queries[i]);
+		}
+		return;
+	}
+
+	// The wrappers are discarded
+	for (unsigned int i = 0; i < p_queries.size(); ++i) {
+		Ref<gd::VoxelBuffer> buffer_wrapper = buffer_wrappers[i];
+		ERR_CONTINUE(buffer_wrapper.is_null());
+		buffer_wrapper->get_buffer().move_to(p_queries[i].voxel_buffer);
+	}
+}
+
 int VoxelGeneratorScript::get_used_channels_mask() const {
 	int mask = 0;
 	if (!GDVIRTUAL_CALL(_get_used_channels_mask, mask)) {
@@ -43,6 +94,9 @@ int VoxelGeneratorScript::get_used_channels_mask() const {
 void VoxelGeneratorScript::_bind_methods() {
 	// TODO Test if GDVIRTUAL can print errors properly when GDScript fails inside a different thread.
 	GDVIRTUAL_BIND(_generate_block, "out_buffer", "origin_in_voxels", "lod");
+	// Batched variant: `out_buffers` is an Array of VoxelBuffer to fill, `origins_in_voxels` the
+	// matching origins, all at the same `lod`. Implementing it makes the engine prefer it.
+	GDVIRTUAL_BIND(_generate_blocks, "out_buffers", "origins_in_voxels", "lod");
 	GDVIRTUAL_BIND(_get_used_channels_mask);
 
 	// BIND_VMETHOD(MethodInfo("_generate_block",
@@ -15,10 +15,18 @@ public:
 	VoxelGeneratorScript();
 
 	Result generate_block(VoxelGenerator::VoxelQueryData &input) override;
+
+	// When the script implements `_generate_blocks`, the server crosses the script boundary once
+	// per batch instead of once per block, which matters a lot for script generators since every
+	// call serializes on the script lock.
+	bool supports_batched_generation() const override;
+	void generate_block_batch(Span<VoxelGenerator::VoxelQueryData> p_queries) override;
+
 	int get_used_channels_mask() const override;
 
 protected:
 	GDVIRTUAL3(_generate_block, Ref<gd::VoxelBuffer>, Vector3i, int)
+	GDVIRTUAL3(_generate_blocks, Array, Array, int)
 	GDVIRTUAL0RC(int, _get_used_channels_mask) // I think `C` means `const`?
 
 private:
@@ -2,6 +2,7 @@
 #include "../../util/log.h"
 #include "../../util/string_funcs.h"
 
+#include <core/io/file_access.h>
 #include <core/math/geometry_2d.h>
 #include <core/os/time.h>
 
@@ -163,6 +164,208 @@ static void rasterize_triangle_barycentric(Vector2f a, Vector2f b, Vector2f c, F
 	}
 }
 
+namespace {
+
+const char *BAKED_CACHE_MAGIC = "ZNBL";
+const uint8_t BAKED_CACHE_VERSION = 1;
+
+template <typename T>
+void store_vector_raw(FileAccess &f, const std::vector<T> &v) {
+	f.store_32(v.size());
+	if (v.size() > 0) {
+		f.store_buffer(reinterpret_cast<const uint8_t *>(v.data()), v.size() * sizeof(T));
+	}
+}
+
+template <typename T>
+bool load_vector_raw(FileAccess &f, std::vector<T> &v) {
+	const uint32_t count = f.get_32();
+	v.resize(count);
+	if (count > 0) {
+		const size_t len = count * sizeof(T);
+		if (f.get_buffer(reinterpret_cast<uint8_t *>(v.data()), len) != len) {
+			return false;
+		}
+	}
+	return true;
+}
+
+inline uint64_t fnv1a_64(uint64_t h, const void *data, size_t len) {
+	const uint8_t *bytes = static_cast<const uint8_t *>(data);
+	for (size_t i = 0; i < len; ++i) {
+		h = (h ^ bytes[i]) * 0x100000001b3ull;
+	}
+	return h;
+}
+
+} // namespace
+
+// Cheap fingerprint of the configuration the bake depends on. It guards against loading a cache
+// baked from a different library; it is not a deep content hash, so regenerating the cache
+// whenever the library resource changes (export time) remains the authoritative rule.
+uint64_t VoxelBlockyLibrary::compute_bake_fingerprint() const {
+	uint64_t h = 0xcbf29ce484222325ull;
+	const uint32_t count = _voxel_types.size();
+	h = fnv1a_64(h, &count, sizeof(count));
+	h = fnv1a_64(h, &_atlas_size, sizeof(_atlas_size));
+	const uint8_t tangents = _bake_tangents ? 1 : 0;
+	h = fnv1a_64(h, &tangents, sizeof(tangents));
+	for (size_t i = 0; i < _voxel_types.size(); ++i) {
+		const Ref<VoxelBlockyModel> &model = _voxel_types[i];
+		const uint8_t valid = model.is_valid() ? 1 : 0;
+		h = fnv1a_64(h, &valid, sizeof(valid));
+		if (model.is_null()) {
+			continue;
+		}
+		const uint32_t name_hash = String(model->get_voxel_name()).hash();
+		h = fnv1a_64(h, &name_hash, sizeof(name_hash));
+		const uint32_t material_id = model->get_material_id();
+		h = fnv1a_64(h, &material_id, sizeof(material_id));
+		const Color color = model->get_color();
+		h = fnv1a_64(h, &color, sizeof(color));
+		const int transparency_index = model->get_transparency_index();
+		h = fnv1a_64(h, &transparency_index, sizeof(transparency_index));
+		const int geometry_type = model->get_geometry_type();
+		h = fnv1a_64(h, &geometry_type, sizeof(geometry_type));
+	}
+	return h;
+}
+
+Error VoxelBlockyLibrary::save_baked_cache(String fpath) {
+	// Make sure the data we save is current
+	bake();
+
+	Error err;
+	Ref<FileAccess> f = FileAccess::open(fpath, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V(f.is_null(), err != OK ? err : ERR_CANT_CREATE);
+
+	RWLockRead lock(_baked_data_rw_lock);
+
+	f->store_buffer(reinterpret_cast<const uint8_t *>(BAKED_CACHE_MAGIC), 4);
+	f->store_8(BAKED_CACHE_VERSION);
+	f->store_64(compute_bake_fingerprint());
+
+	f->store_32(_baked_data.side_pattern_count);
+	{
+		// Culling matrix, packed by bit
+		const uint64_t bit_count =
+				uint64_t(_baked_data.side_pattern_count) * uint64_t(_baked_data.side_pattern_count);
+		for (uint64_t i = 0; i < bit_count; i += 8) {
+			uint8_t byte = 0;
+			for (uint64_t j = 0; j < 8 && i + j < bit_count; ++j) {
+				if (_baked_data.side_pattern_culling.get(i + j)) {
+					byte |= 1 << j;
+				}
+			}
+			f->store_8(byte);
+		}
+	}
+
+	f->store_32(_baked_data.models.size());
+	for (size_t i = 0; i < _baked_data.models.size(); ++i) {
+		const VoxelBlockyModel::BakedData &baked_model = _baked_data.models[i];
+		f->store_32(baked_model.material_id);
+		f->store_float(baked_model.color.r);
+		f->store_float(baked_model.color.g);
+		f->store_float(baked_model.color.b);
+		f->store_float(baked_model.color.a);
+		f->store_8(baked_model.transparency_index);
+		f->store_8((baked_model.contributes_to_ao ? 1 : 0) | (baked_model.empty ? 2 : 0));
+
+		const VoxelBlockyModel::BakedData::Model &geometry = baked_model.model;
+		store_vector_raw(**f, geometry.positions);
+		store_vector_raw(**f, geometry.normals);
+		store_vector_raw(**f, geometry.uvs);
+		store_vector_raw(**f, geometry.indices);
+		store_vector_raw(**f, geometry.tangents);
+		for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
+			f->store_32(geometry.side_pattern_indices[side]);
+			store_vector_raw(**f, geometry.side_positions[side]);
+			store_vector_raw(**f, geometry.side_uvs[side]);
+			store_vector_raw(**f, geometry.side_indices[side]);
+			store_vector_raw(**f, geometry.side_tangents[side]);
+		}
+	}
+
+	store_vector_raw(**f, _baked_data.face_infos);
+
+	return OK;
+}
+
+Error VoxelBlockyLibrary::load_baked_cache(String fpath) {
+	Error err;
+	Ref<FileAccess> f = FileAccess::open(fpath, FileAccess::READ, &err);
+	if (f.is_null()) {
+		return err != OK ? err : ERR_CANT_OPEN;
+	}
+
+	char magic[5] = { 0 };
+	ERR_FAIL_COND_V(f->get_buffer(reinterpret_cast<uint8_t *>(magic), 4) != 4, ERR_FILE_CORRUPT);
+	ERR_FAIL_COND_V(strcmp(magic, BAKED_CACHE_MAGIC) != 0, ERR_FILE_UNRECOGNIZED);
+	ERR_FAIL_COND_V(f->get_8() != BAKED_CACHE_VERSION, ERR_FILE_UNRECOGNIZED);
+	if (f->get_64() != compute_bake_fingerprint()) {
+		// Baked from a different configuration; the caller falls back on a regular bake
+		return ERR_FILE_UNRECOGNIZED;
+	}
+
+	RWLockWrite lock(_baked_data_rw_lock);
+
+	const uint64_t time_before = Time::get_singleton()->get_ticks_usec();
+
+	_baked_data.side_pattern_count = f->get_32();
+	{
+		const uint64_t bit_count =
+				uint64_t(_baked_data.side_pattern_count) * uint64_t(_baked_data.side_pattern_count);
+		_baked_data.side_pattern_culling.resize(bit_count);
+		_baked_data.side_pattern_culling.fill(false);
+		for (uint64_t i = 0; i < bit_count; i += 8) {
+			const uint8_t byte = f->get_8();
+			for (uint64_t j = 0; j < 8 && i + j < bit_count; ++j) {
+				if ((byte & (1 << j)) != 0) {
+					_baked_data.side_pattern_culling.set(i + j);
+				}
+			}
+		}
+	}
+
+	const uint32_t model_count = f->get_32();
+	ERR_FAIL_COND_V(model_count != _voxel_types.size(), ERR_FILE_CORRUPT);
+	_baked_data.models.resize(model_count);
+	for (uint32_t i = 0; i < model_count; ++i) {
+		VoxelBlockyModel::BakedData &baked_model = _baked_data.models[i];
+		baked_model.material_id = f->get_32();
+		baked_model.color.r = f->get_float();
+		baked_model.color.g = f->get_float();
+		baked_model.color.b = f->get_float();
+		baked_model.color.a = f->get_float();
+		baked_model.transparency_index = f->get_8();
+		const uint8_t flags = f->get_8();
+		baked_model.contributes_to_ao = (flags & 1) != 0;
+		baked_model.empty = (flags & 2) != 0;
+
+		VoxelBlockyModel::BakedData::Model &geometry = baked_model.model;
+		ERR_FAIL_COND_V(!load_vector_raw(**f, geometry.positions), ERR_FILE_CORRUPT);
+		ERR_FAIL_COND_V(!load_vector_raw(**f, geometry.normals), ERR_FILE_CORRUPT);
+		ERR_FAIL_COND_V(!load_vector_raw(**f, geometry.uvs), ERR_FILE_CORRUPT);
+		ERR_FAIL_COND_V(!load_vector_raw(**f, geometry.indices), ERR_FILE_CORRUPT);
+		ERR_FAIL_COND_V(!load_vector_raw(**f, geometry.tangents), ERR_FILE_CORRUPT);
+		for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
+			geometry.side_pattern_indices[side] = f->get_32();
+			ERR_FAIL_COND_V(!load_vector_raw(**f, geometry.side_positions[side]), ERR_FILE_CORRUPT);
+			ERR_FAIL_COND_V(!load_vector_raw(**f, geometry.side_uvs[side]), ERR_FILE_CORRUPT);
+			ERR_FAIL_COND_V(!load_vector_raw(**f, geometry.side_indices[side]), ERR_FILE_CORRUPT);
+			ERR_FAIL_COND_V(!load_vector_raw(**f, geometry.side_tangents[side]), ERR_FILE_CORRUPT);
+		}
+	}
+
+	ERR_FAIL_COND_V(!load_vector_raw(**f, _baked_data.face_infos), ERR_FILE_CORRUPT);
+	ERR_FAIL_COND_V(_baked_data.face_infos.size() != model_count * Cube::SIDE_COUNT, ERR_FILE_CORRUPT);
+
+	ZN_PRINT_VERBOSE(format("Loaded baked voxel library cache in {} us",
+			Time::get_singleton()->get_ticks_usec() - time_before));
+	return OK;
+}
+
 void VoxelBlockyLibrary::bake() {
 	RWLockWrite lock(_baked_data_rw_lock);
 
@@ -182,6 +385,26 @@ void VoxelBlockyLibrary::bake() {
 
 	generate_side_culling_matrix();
 
+	// Flatten per-face decision data (see `BakedData::face_infos`). Must come after the culling
+	// matrix, which assigns side pattern indices.
+	_baked_data.face_infos.resize(_baked_data.models.size() * Cube::SIDE_COUNT);
+	for (size_t model_id = 0; model_id < _baked_data.models.size(); ++model_id) {
+		const VoxelBlockyModel::BakedData &model = _baked_data.models[model_id];
+		for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
+			// Packing leaves 20 bits for pattern indices, far beyond practical library sizes
+			ERR_CONTINUE(model.model.side_pattern_indices[side] > BakedData::FACE_INFO_PATTERN_MASK);
+			uint32_t info = model.model.side_pattern_indices[side] & BakedData::FACE_INFO_PATTERN_MASK;
+			info |= uint32_t(model.transparency_index) << BakedData::FACE_INFO_TRANSPARENCY_SHIFT;
+			if (model.empty) {
+				info |= BakedData::FACE_INFO_EMPTY_BIT;
+			}
+			if (model.contributes_to_ao) {
+				info |= BakedData::FACE_INFO_AO_BIT;
+			}
+			_baked_data.face_infos[model_id * Cube::SIDE_COUNT + side] = info;
+		}
+	}
+
 	uint64_t time_spent = Time::get_singleton()->get_ticks_usec() - time_before;
 	ZN_PRINT_VERBOSE(format("Took {} us to bake VoxelLibrary", time_spent));
 }
@@ -424,6 +647,8 @@ void VoxelBlockyLibrary::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_voxel_by_name", "name"), &VoxelBlockyLibrary::_b_get_voxel_by_name);
 
 	ClassDB::bind_method(D_METHOD("bake"), &VoxelBlockyLibrary::bake);
+	ClassDB::bind_method(D_METHOD("save_baked_cache", "path"), &VoxelBlockyLibrary::save_baked_cache);
+	ClassDB::bind_method(D_METHOD("load_baked_cache", "path"), &VoxelBlockyLibrary::load_baked_cache);
 
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "atlas_size"), "set_atlas_size", "get_atlas_size");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "voxel_count", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_EDITOR),
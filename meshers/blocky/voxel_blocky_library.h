@@ -35,6 +35,25 @@ public:
 #endif
 			return side_pattern_culling.get(pattern_a + pattern_b * side_pattern_count);
 		}
+
+		// Flat per-(model, side) records powering per-face mesh decisions. Reading the neighbor's
+		// record is one contiguous array access instead of chasing into its whole baked model;
+		// together with the culling bitset, a face decision is two array reads.
+		// Packing: bits 0..19 = side pattern index, 20..27 = transparency index, 28 = empty,
+		// 29 = contributes to AO.
+		static const uint32_t FACE_INFO_PATTERN_MASK = 0xfffff;
+		static const uint32_t FACE_INFO_TRANSPARENCY_SHIFT = 20;
+		static const uint32_t FACE_INFO_TRANSPARENCY_MASK = 0xff;
+		static const uint32_t FACE_INFO_EMPTY_BIT = 1 << 28;
+		static const uint32_t FACE_INFO_AO_BIT = 1 << 29;
+		std::vector<uint32_t> face_infos;
+
+		inline uint32_t get_face_info(uint32_t model_id, unsigned int side) const {
+#ifdef DEBUG_ENABLED
+			CRASH_COND(model_id * Cube::SIDE_COUNT + side >= face_infos.size());
+#endif
+			return face_infos[model_id * Cube::SIDE_COUNT + side];
+		}
 	};
 
 	VoxelBlockyLibrary();
@@ -62,6 +81,15 @@ public:
 
 	void bake();
 
+	// Ahead-of-time bake cache: with thousands of models, `bake()` takes seconds at startup and
+	// its output is identical every run. `save_baked_cache` writes the baked data to a versioned
+	// binary validated by a fingerprint of the library configuration; `load_baked_cache` loads
+	// it with one read and zero per-model processing. On any mismatch (version, fingerprint,
+	// corruption) it returns an error and the caller bakes normally. The file is a local cache
+	// (native endianness), meant to be produced at export time per platform.
+	Error save_baked_cache(String fpath);
+	Error load_baked_cache(String fpath);
+
 	//-------------------------
 	// Internal use
 
@@ -84,6 +112,7 @@ private:
 	void set_voxel(unsigned int id, Ref<VoxelBlockyModel> voxel);
 
 	void generate_side_culling_matrix();
+	uint64_t compute_bake_fingerprint() const;
 
 	bool _set(const StringName &p_name, const Variant &p_value);
 	bool _get(const StringName &p_name, Variant &r_ret) const;
@@ -1,4 +1,5 @@
 #include "voxel_mesher_blocky.h"
+#include "../../util/lightweight_profiler.h"
 #include "../../constants/cube_tables.h"
 #include "../../storage/voxel_buffer_internal.h"
 #include "../../util/godot/funcs.h"
@@ -22,12 +23,17 @@ const int g_opposite_side[6] = {
 inline bool is_face_visible(const VoxelBlockyLibrary::BakedData &lib, const VoxelBlockyModel::BakedData &vt,
 		uint32_t other_voxel_id, int side) {
 	if (other_voxel_id < lib.models.size()) {
-		const VoxelBlockyModel::BakedData &other_vt = lib.models[other_voxel_id];
-		if (other_vt.empty || (other_vt.transparency_index > vt.transparency_index)) {
+		// One flat record carries everything needed about the neighbor's facing side, instead of
+		// chasing into its whole baked model
+		const uint32_t other_info = lib.get_face_info(other_voxel_id, g_opposite_side[side]);
+		const uint32_t other_transparency = (other_info >> VoxelBlockyLibrary::BakedData::FACE_INFO_TRANSPARENCY_SHIFT) &
+				VoxelBlockyLibrary::BakedData::FACE_INFO_TRANSPARENCY_MASK;
+		if ((other_info & VoxelBlockyLibrary::BakedData::FACE_INFO_EMPTY_BIT) != 0 ||
+				other_transparency > vt.transparency_index) {
 			return true;
 		} else {
 			const unsigned int ai = vt.model.side_pattern_indices[side];
-			const unsigned int bi = other_vt.model.side_pattern_indices[g_opposite_side[side]];
+			const unsigned int bi = other_info & VoxelBlockyLibrary::BakedData::FACE_INFO_PATTERN_MASK;
 			// Patterns are not the same, and B does not occlude A
 			return (ai != bi) && !lib.get_side_pattern_occlusion(bi, ai);
 		}
@@ -37,19 +43,211 @@ inline bool is_face_visible(const VoxelBlockyLibrary::BakedData &lib, const Voxe
 
 inline bool contributes_to_ao(const VoxelBlockyLibrary::BakedData &lib, uint32_t voxel_id) {
 	if (voxel_id < lib.models.size()) {
-		const VoxelBlockyModel::BakedData &t = lib.models[voxel_id];
-		return t.contributes_to_ao;
+		return (lib.get_face_info(voxel_id, 0) & VoxelBlockyLibrary::BakedData::FACE_INFO_AO_BIT) != 0;
+	}
+	return true;
+}
+
+// A model qualifies for greedy merging when it is a plain unit cube: no geometry besides its 6
+// sides, 4 vertices per side, full-tile UVs (so merged quads can tile with repeating samplers) and
+// no tangents (they would need re-deriving on merged quads)
+bool is_greedy_mergeable_model(const VoxelBlockyModel::BakedData &voxel) {
+	if (voxel.empty || voxel.model.positions.size() > 0) {
+		return false;
+	}
+	for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
+		if (voxel.model.side_positions[side].size() != 4 || voxel.model.side_indices[side].size() != 6 ||
+				voxel.model.side_tangents[side].size() != 0) {
+			return false;
+		}
+		const std::vector<Vector2f> &uvs = voxel.model.side_uvs[side];
+		Vector2f uv_min = uvs[0];
+		Vector2f uv_max = uvs[0];
+		for (unsigned int i = 1; i < uvs.size(); ++i) {
+			uv_min.x = math::min(uv_min.x, uvs[i].x);
+			uv_min.y = math::min(uv_min.y, uvs[i].y);
+			uv_max.x = math::max(uv_max.x, uvs[i].x);
+			uv_max.y = math::max(uv_max.y, uvs[i].y);
+		}
+		const float e = 0.001f;
+		if (uv_min.x > e || uv_min.y > e || uv_max.x < 1.f - e || uv_max.y < 1.f - e) {
+			return false;
+		}
 	}
 	return true;
 }
 
 } // namespace
 
+// Merges visible coplanar faces of mergeable cube models into larger quads, one plane at a time,
+// like the cubes mesher does for colors. Faces are only merged between voxels of the same type, so
+// material and texture stay correct; UVs span the merged size and tile with the block grid.
+// Only valid when baked occlusion is off, since merged faces must share the same lighting.
 template <typename Type_T>
+void generate_blocky_mesh_greedy(
+		FixedArray<VoxelMesherBlocky::Arrays, VoxelMesherBlocky::MAX_MATERIALS> &out_arrays_per_material,
+		FixedArray<int, VoxelMesherBlocky::MAX_MATERIALS> &index_offsets, const Span<Type_T> type_buffer,
+		const Vector3i block_size, const VoxelBlockyLibrary::BakedData &library,
+		const std::vector<uint8_t> &mergeable_models) {
+	//
+	const int row_size = block_size.y;
+	const int deck_size = block_size.x * row_size;
+
+	const Vector3i min = Vector3iUtil::create(VoxelMesherBlocky::PADDING);
+	const Vector3i max = block_size - Vector3iUtil::create(VoxelMesherBlocky::PADDING);
+
+	FixedArray<int, Vector3iUtil::AXIS_COUNT> stride_lut;
+	stride_lut[Vector3i::AXIS_X] = row_size;
+	stride_lut[Vector3i::AXIS_Y] = 1;
+	stride_lut[Vector3i::AXIS_Z] = deck_size;
+
+	static thread_local std::vector<Type_T> tls_mask;
+
+	for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
+		// One cache line holds everything this loop reads about the side
+		const Cube::PackedSideInfo &side_info = Cube::g_packed_side_info[side];
+
+		const unsigned int axis = side_info.axis;
+		const int axis_sign = side_info.axis_sign;
+
+		const unsigned int ua = axis == Vector3i::AXIS_X ? Vector3i::AXIS_Y : Vector3i::AXIS_X;
+		const unsigned int va = axis == Vector3i::AXIS_Z ? Vector3i::AXIS_Y : Vector3i::AXIS_Z;
+
+		const unsigned int mask_size_u = max[ua] - min[ua];
+		const unsigned int mask_size_v = max[va] - min[va];
+		tls_mask.resize(mask_size_u * mask_size_v);
+
+		// The neighbor a face is checked against is along the side's normal
+		const int neighbor_offset = axis_sign * stride_lut[axis];
+
+		for (int d = min[axis]; d < max[axis]; ++d) {
+			// Gather visible mergeable faces of this plane
+			for (unsigned int v = 0; v < mask_size_v; ++v) {
+				for (unsigned int u = 0; u < mask_size_u; ++u) {
+					Vector3i pos;
+					pos[axis] = d;
+					pos[ua] = min[ua] + u;
+					pos[va] = min[va] + v;
+					const int voxel_index = pos.y + pos.x * row_size + pos.z * deck_size;
+					const unsigned int voxel_id = type_buffer[voxel_index];
+
+					Type_T mask_value = 0;
+					if (voxel_id != 0 && voxel_id < mergeable_models.size() && mergeable_models[voxel_id] != 0) {
+						const VoxelBlockyModel::BakedData &voxel = library.models[voxel_id];
+						const uint32_t neighbor_voxel_id = type_buffer[voxel_index + neighbor_offset];
+						if (is_face_visible(library, voxel, neighbor_voxel_id, side)) {
+							mask_value = voxel_id;
+						}
+					}
+					tls_mask[u + v * mask_size_u] = mask_value;
+				}
+			}
+
+			// Greedy quads
+			for (unsigned int fv = 0; fv < mask_size_v; ++fv) {
+				for (unsigned int fu = 0; fu < mask_size_u; ++fu) {
+					const Type_T m = tls_mask[fu + fv * mask_size_u];
+					if (m == 0) {
+						continue;
+					}
+
+					unsigned int ru = fu + 1;
+					while (ru < mask_size_u && tls_mask[ru + fv * mask_size_u] == m) {
+						++ru;
+					}
+
+					unsigned int rv = fv + 1;
+					while (rv < mask_size_v) {
+						bool row_equal = true;
+						for (unsigned int u = fu; u < ru; ++u) {
+							if (tls_mask[u + rv * mask_size_u] != m) {
+								row_equal = false;
+								break;
+							}
+						}
+						if (!row_equal) {
+							break;
+						}
+						++rv;
+					}
+
+					// Commit the merged quad
+
+					const VoxelBlockyModel::BakedData &voxel = library.models[m];
+					VoxelMesherBlocky::Arrays &arrays = out_arrays_per_material[voxel.material_id];
+					int &index_offset = index_offsets[voxel.material_id];
+
+					const float quad_size_u = ru - fu;
+					const float quad_size_v = rv - fv;
+
+					// Unpadded coordinates; the face plane is at the far end of the cell when the
+					// side points positively
+					Vector3f p00;
+					p00[axis] = (d - VoxelMesherBlocky::PADDING) + (axis_sign > 0 ? 1 : 0);
+					p00[ua] = fu;
+					p00[va] = fv;
+
+					Vector3f du;
+					du[ua] = quad_size_u;
+					Vector3f dv;
+					dv[va] = quad_size_v;
+
+					const Vector3f p10 = p00 + du;
+					const Vector3f p01 = p00 + dv;
+					const Vector3f p11 = p00 + du + dv;
+
+					const Vector3f normal = Vector3f(side_info.normal_x, side_info.normal_y, side_info.normal_z);
+
+					arrays.positions.push_back(p00);
+					arrays.positions.push_back(p10);
+					arrays.positions.push_back(p01);
+					arrays.positions.push_back(p11);
+
+					arrays.uvs.push_back(Vector2f(0.f, 0.f));
+					arrays.uvs.push_back(Vector2f(quad_size_u, 0.f));
+					arrays.uvs.push_back(Vector2f(0.f, quad_size_v));
+					arrays.uvs.push_back(Vector2f(quad_size_u, quad_size_v));
+
+					for (unsigned int i = 0; i < 4; ++i) {
+						arrays.normals.push_back(normal);
+						arrays.colors.push_back(voxel.color);
+					}
+
+					// Winding such that triangles face the side's normal
+					const Vector3f tri_normal = (p10 - p00).cross(p01 - p00);
+					if (tri_normal.dot(normal) > 0.f) {
+						const int quad_indices[6] = { 0, 1, 2, 1, 3, 2 };
+						for (unsigned int i = 0; i < 6; ++i) {
+							arrays.indices.push_back(index_offset + quad_indices[i]);
+						}
+					} else {
+						const int quad_indices[6] = { 0, 2, 1, 1, 2, 3 };
+						for (unsigned int i = 0; i < 6; ++i) {
+							arrays.indices.push_back(index_offset + quad_indices[i]);
+						}
+					}
+					index_offset += 4;
+
+					// Consume merged cells
+					for (unsigned int v = fv; v < rv; ++v) {
+						for (unsigned int u = fu; u < ru; ++u) {
+							tls_mask[u + v * mask_size_u] = 0;
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+// `TypeBuffer_T` only needs `operator[]` returning voxel type IDs: a `Span` over dense data, or
+// a view resolving paletted indices on the fly (see `PalettedTypeBuffer`)
+template <typename TypeBuffer_T>
 void generate_blocky_mesh(
 		FixedArray<VoxelMesherBlocky::Arrays, VoxelMesherBlocky::MAX_MATERIALS> &out_arrays_per_material,
-		const Span<Type_T> type_buffer, const Vector3i block_size, const VoxelBlockyLibrary::BakedData &library,
-		bool bake_occlusion, float baked_occlusion_darkness) {
+		FixedArray<int, VoxelMesherBlocky::MAX_MATERIALS> &index_offsets, const TypeBuffer_T type_buffer,
+		const Vector3i block_size, const VoxelBlockyLibrary::BakedData &library, bool bake_occlusion,
+		float baked_occlusion_darkness, const std::vector<uint8_t> *mergeable_models) {
 	ERR_FAIL_COND(block_size.x < static_cast<int>(2 * VoxelMesherBlocky::PADDING) ||
 			block_size.y < static_cast<int>(2 * VoxelMesherBlocky::PADDING) ||
 			block_size.z < static_cast<int>(2 * VoxelMesherBlocky::PADDING));
@@ -64,7 +262,6 @@ void generate_blocky_mesh(
 	const Vector3i min = Vector3iUtil::create(VoxelMesherBlocky::PADDING);
 	const Vector3i max = block_size - Vector3iUtil::create(VoxelMesherBlocky::PADDING);
 
-	int index_offsets[VoxelMesherBlocky::MAX_MATERIALS] = { 0 };
 
 	FixedArray<int, Cube::SIDE_COUNT> side_neighbor_lut;
 	side_neighbor_lut[Cube::SIDE_LEFT] = row_size;
@@ -132,6 +329,11 @@ void generate_blocky_mesh(
 				const int voxel_id = type_buffer[voxel_index];
 
 				if (voxel_id != 0 && library.has_model(voxel_id)) {
+					if (mergeable_models != nullptr && (unsigned int)voxel_id < mergeable_models->size() &&
+							(*mergeable_models)[voxel_id] != 0) {
+						// Already emitted by the greedy pass
+						continue;
+					}
 					const VoxelBlockyModel::BakedData &voxel = library.models[voxel_id];
 
 					VoxelMesherBlocky::Arrays &arrays = out_arrays_per_material[voxel.material_id];
@@ -170,15 +372,16 @@ void generate_blocky_mesh(
 							//	}
 
 							for (unsigned int j = 0; j < 4; ++j) {
-								const unsigned int edge = Cube::g_side_edges[side][j];
+								const unsigned int edge = side_info.edges[j];
 								const int edge_neighbor_id = type_buffer[voxel_index + edge_neighbor_lut[edge]];
 								if (contributes_to_ao(library, edge_neighbor_id)) {
-									++shaded_corner[Cube::g_edge_corners[edge][0]];
-									++shaded_corner[Cube::g_edge_corners[edge][1]];
+									// Edge->corner mapping pre-resolved in the packed LUT
+									++shaded_corner[side_info.edge_corners[2 * j]];
+									++shaded_corner[side_info.edge_corners[2 * j + 1]];
 								}
 							}
 							for (unsigned int j = 0; j < 4; ++j) {
-								const unsigned int corner = Cube::g_side_corners[side][j];
+								const unsigned int corner = side_info.corners[j];
 								if (shaded_corner[corner] == 2) {
 									shaded_corner[corner] = 3;
 								} else {
@@ -226,7 +429,7 @@ void generate_blocky_mesh(
 							arrays.normals.resize(arrays.normals.size() + vertex_count);
 							Vector3f *w = arrays.normals.data() + append_index;
 							for (unsigned int i = 0; i < vertex_count; ++i) {
-								w[i] = to_vec3f(Cube::g_side_normals[side]);
+								w[i] = Vector3f(side_info.normal_x, side_info.normal_y, side_info.normal_z);
 							}
 						}
 
@@ -246,7 +449,7 @@ void generate_blocky_mesh(
 									// worth it
 									float shade = 0;
 									for (unsigned int j = 0; j < 4; ++j) {
-										unsigned int corner = Cube::g_side_corners[side][j];
+										unsigned int corner = side_info.corners[j];
 										if (shaded_corner[corner]) {
 											float s = baked_occlusion_darkness *
 													static_cast<float>(shaded_corner[corner]);
@@ -366,12 +569,23 @@ void VoxelMesherBlocky::set_occlusion_enabled(bool enable) {
 	_parameters.bake_occlusion = enable;
 }
 
+void VoxelMesherBlocky::set_greedy_merging_enabled(bool enable) {
+	RWLockWrite wlock(_parameters_lock);
+	_parameters.greedy_merging = enable;
+}
+
+bool VoxelMesherBlocky::get_greedy_merging_enabled() const {
+	RWLockRead rlock(_parameters_lock);
+	return _parameters.greedy_merging;
+}
+
 bool VoxelMesherBlocky::get_occlusion_enabled() const {
 	RWLockRead rlock(_parameters_lock);
 	return _parameters.bake_occlusion;
 }
 
 void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::Input &input) {
+	ZN_LIGHT_PROFILE_SCOPE("blocky_build_mesh");
 	const int channel = VoxelBufferInternal::CHANNEL_TYPE;
 	Parameters params;
 	{
@@ -423,14 +637,21 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 		// error), decompress into a backing array to still allow the use of the same algorithm.
 		return;
 
-	} else if (voxels.get_channel_compression(channel) != VoxelBufferInternal::COMPRESSION_NONE) {
+	}
+
+	// Paletted channels are meshed through their indices directly, no expansion needed
+	Span<const uint8_t> palette_indices;
+	Span<const uint64_t> palette;
+	const bool paletted = voxels.get_channel_paletted_view(channel, palette_indices, palette);
+
+	if (!paletted && voxels.get_channel_compression(channel) != VoxelBufferInternal::COMPRESSION_NONE) {
 		// No other form of compression is allowed
 		ERR_PRINT("VoxelMesherBlocky received unsupported voxel compression");
 		return;
 	}
 
 	Span<uint8_t> raw_channel;
-	if (!voxels.get_channel_raw(channel, raw_channel)) {
+	if (!paletted && !voxels.get_channel_raw(channel, raw_channel)) {
 		/*       _
 		//      | \
 		//     /\ \\
@@ -454,20 +675,62 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 		RWLockRead lock(params.library->get_baked_data_rw_lock());
 		const VoxelBlockyLibrary::BakedData &library_baked_data = params.library->get_baked_data();
 
-		switch (channel_depth) {
+		// Greedy merging only applies to plain cube models, and only without baked occlusion since
+		// merged faces must share the same lighting
+		static thread_local std::vector<uint8_t> tls_mergeable_models;
+		const std::vector<uint8_t> *mergeable_models = nullptr;
+		if (params.greedy_merging && !params.bake_occlusion && !paletted) {
+			tls_mergeable_models.resize(library_baked_data.models.size());
+			for (unsigned int id = 0; id < library_baked_data.models.size(); ++id) {
+				tls_mergeable_models[id] = id != 0 && is_greedy_mergeable_model(library_baked_data.models[id]);
+			}
+			mergeable_models = &tls_mergeable_models;
+		}
+
+		FixedArray<int, MAX_MATERIALS> index_offsets;
+		fill(index_offsets, 0);
+
+		if (paletted) {
+			// Resolves type IDs through the palette per lookup. With at most 256 entries the
+			// table stays in cache, and the per-voxel stream is half the size of 16-bit data.
+			// Greedy merging is skipped on this path, it requires a typed mask buffer.
+			struct PalettedTypeBuffer {
+				Span<const uint8_t> indices;
+				Span<const uint64_t> palette;
+				inline uint64_t operator[](size_t i) const {
+					return palette[indices[i]];
+				}
+			};
+			generate_blocky_mesh(cache.arrays_per_material, index_offsets,
+					PalettedTypeBuffer{ palette_indices, palette }, block_size, library_baked_data,
+					params.bake_occlusion, baked_occlusion_darkness, nullptr);
+
+		} else {
+			switch (channel_depth) {
 			case VoxelBufferInternal::DEPTH_8_BIT:
-				generate_blocky_mesh(cache.arrays_per_material, raw_channel, block_size, library_baked_data,
-						params.bake_occlusion, baked_occlusion_darkness);
+				if (mergeable_models != nullptr) {
+					generate_blocky_mesh_greedy(cache.arrays_per_material, index_offsets, raw_channel, block_size,
+							library_baked_data, *mergeable_models);
+				}
+				generate_blocky_mesh(cache.arrays_per_material, index_offsets, raw_channel, block_size,
+						library_baked_data, params.bake_occlusion, baked_occlusion_darkness, mergeable_models);
 				break;
 
 			case VoxelBufferInternal::DEPTH_16_BIT:
-				generate_blocky_mesh(cache.arrays_per_material, raw_channel.reinterpret_cast_to<uint16_t>(), block_size,
-						library_baked_data, params.bake_occlusion, baked_occlusion_darkness);
+				if (mergeable_models != nullptr) {
+					generate_blocky_mesh_greedy(cache.arrays_per_material, index_offsets,
+							raw_channel.reinterpret_cast_to<uint16_t>(), block_size, library_baked_data,
+							*mergeable_models);
+				}
+				generate_blocky_mesh(cache.arrays_per_material, index_offsets,
+						raw_channel.reinterpret_cast_to<uint16_t>(), block_size, library_baked_data,
+						params.bake_occlusion, baked_occlusion_darkness, mergeable_models);
 				break;
 
 			default:
 				ERR_PRINT("Unsupported voxel depth");
 				return;
+			}
 		}
 	}
 
@@ -586,6 +849,10 @@ void VoxelMesherBlocky::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_occlusion_enabled", "enable"), &VoxelMesherBlocky::set_occlusion_enabled);
 	ClassDB::bind_method(D_METHOD("get_occlusion_enabled"), &VoxelMesherBlocky::get_occlusion_enabled);
 
+	ClassDB::bind_method(
+			D_METHOD("set_greedy_merging_enabled", "enable"), &VoxelMesherBlocky::set_greedy_merging_enabled);
+	ClassDB::bind_method(D_METHOD("get_greedy_merging_enabled"), &VoxelMesherBlocky::get_greedy_merging_enabled);
+
 	ClassDB::bind_method(D_METHOD("set_occlusion_darkness", "value"), &VoxelMesherBlocky::set_occlusion_darkness);
 	ClassDB::bind_method(D_METHOD("get_occlusion_darkness"), &VoxelMesherBlocky::get_occlusion_darkness);
 
@@ -594,6 +861,8 @@ void VoxelMesherBlocky::_bind_methods() {
 						 PROPERTY_USAGE_DEFAULT | PROPERTY_USAGE_EDITOR_INSTANTIATE_OBJECT),
 			"set_library", "get_library");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "occlusion_enabled"), "set_occlusion_enabled", "get_occlusion_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "greedy_merging_enabled"), "set_greedy_merging_enabled",
+			"get_greedy_merging_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "occlusion_darkness", PROPERTY_HINT_RANGE, "0,1,0.01"),
 			"set_occlusion_darkness", "get_occlusion_darkness");
 }
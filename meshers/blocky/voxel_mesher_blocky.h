@@ -32,6 +32,14 @@ public:
 	void set_occlusion_enabled(bool enable);
 	bool get_occlusion_enabled() const;
 
+	// When enabled, visible faces of plain full-cube models (4-vertex sides with full-tile UVs)
+	// are merged into larger quads per plane, like the cubes mesher does for colors. Irregular
+	// models keep going through the regular path. Only active while baked occlusion is disabled,
+	// since merged faces must share the same lighting. Textures on merged faces tile with the
+	// block grid, so materials should use repeating samplers.
+	void set_greedy_merging_enabled(bool enable);
+	bool get_greedy_merging_enabled() const;
+
 	void build(VoxelMesher::Output &output, const VoxelMesher::Input &input) override;
 
 	Ref<Resource> duplicate(bool p_subresources = false) const override;
@@ -41,6 +49,11 @@ public:
 		return false;
 	}
 
+	// The TYPE channel is read through its palette directly, no expansion needed
+	bool supports_paletted_channels() const override {
+		return true;
+	}
+
 	// Using std::vector because they make this mesher twice as fast than Godot Vectors.
 	// See why: https://github.com/godotengine/godot/issues/24731
 	struct Arrays {
@@ -72,6 +85,7 @@ private:
 	struct Parameters {
 		float baked_occlusion_darkness = 0.8;
 		bool bake_occlusion = true;
+		bool greedy_merging = false;
 		Ref<VoxelBlockyLibrary> library;
 	};
 
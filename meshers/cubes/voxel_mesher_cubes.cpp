@@ -1,7 +1,10 @@
 #include "voxel_mesher_cubes.h"
+#include "../../util/lightweight_profiler.h"
 #include "../../storage/voxel_buffer_internal.h"
 #include "../../util/godot/funcs.h"
+#include "../../util/memory.h"
 #include "../../util/profiling.h"
+#include "../../util/thread/thread.h"
 #include <core/math/geometry_2d.h>
 
 namespace zylann::voxel {
@@ -76,6 +79,7 @@ void build_voxel_mesh_as_simple_cubes(
 	const Vector3i max_pos = block_size - Vector3iUtil::create(VoxelMesherCubes::PADDING);
 	const unsigned int row_size = block_size.y;
 	const unsigned int deck_size = block_size.x * row_size;
+	const size_t volume = Vector3iUtil::get_volume(block_size);
 
 	// Note: voxel buffers are indexed in ZXY order
 	FixedArray<uint32_t, Vector3iUtil::AXIS_COUNT> neighbor_offset_d_lut;
@@ -83,122 +87,258 @@ void build_voxel_mesh_as_simple_cubes(
 	neighbor_offset_d_lut[Vector3i::AXIS_Y] = 1;
 	neighbor_offset_d_lut[Vector3i::AXIS_Z] = block_size.x * block_size.y;
 
-	FixedArray<uint32_t, VoxelMesherCubes::MATERIAL_COUNT> index_offsets;
-	fill(index_offsets, uint32_t(0));
-
-	// For each axis
-	for (unsigned int za = 0; za < Vector3iUtil::AXIS_COUNT; ++za) {
-		const unsigned int xa = g_face_axes_lut[za][0];
-		const unsigned int ya = g_face_axes_lut[za][1];
-
-		// For each deck
-		for (unsigned int d = min_pos[za] - VoxelMesherCubes::PADDING; d < (unsigned int)max_pos[za]; ++d) {
-			// For each cell of the deck, gather face info
-			for (unsigned int fy = min_pos[ya]; fy < (unsigned int)max_pos[ya]; ++fy) {
-				for (unsigned int fx = min_pos[xa]; fx < (unsigned int)max_pos[xa]; ++fx) {
+	// First pass: one alpha classification per voxel, instead of re-evaluating the color function
+	// for both sides of every pair on every axis (6x per voxel). The face-detection passes below
+	// then run on plain bytes, which the compiler can vectorize.
+	static thread_local std::vector<uint8_t> tls_alpha_indices;
+	tls_alpha_indices.resize(volume);
+	{
+		ZN_PROFILE_SCOPE_NAMED("Alpha classification");
+		uint8_t *alpha_indices = tls_alpha_indices.data();
+		for (size_t i = 0; i < volume; ++i) {
+			alpha_indices[i] = get_alpha_index(color_func(voxel_buffer[i]));
+		}
+	}
+	const Span<const uint8_t> alpha_indices = to_span_const(tls_alpha_indices);
+
+	// Face detection and quad emission for one axis; axes are fully independent of each other
+	struct AxisJob {
+		Span<const Voxel_T> voxel_buffer;
+		Span<const uint8_t> alpha_indices;
+		Vector3i block_size;
+		Vector3i min_pos;
+		Vector3i max_pos;
+		unsigned int row_size;
+		unsigned int deck_size;
+		unsigned int za;
+		uint32_t neighbor_offset_d;
+		const Color_F *color_func;
+		FixedArray<VoxelMesherCubes::Arrays, VoxelMesherCubes::MATERIAL_COUNT> arrays;
+
+		void run_axis() {
+			ZN_PROFILE_SCOPE();
+
+			const unsigned int xa = g_face_axes_lut[za][0];
+			const unsigned int ya = g_face_axes_lut[za][1];
+
+			const unsigned int mask_size_x = max_pos[xa] - min_pos[xa];
+			const unsigned int mask_size_y = max_pos[ya] - min_pos[ya];
+
+			// One worker thread per axis, each needs its own mask
+			static thread_local std::vector<uint8_t> tls_mask;
+			tls_mask.resize(mask_size_x * mask_size_y);
+
+			FixedArray<uint32_t, VoxelMesherCubes::MATERIAL_COUNT> index_offsets;
+			fill(index_offsets, uint32_t(0));
+
+			// For each deck
+			for (unsigned int d = min_pos[za] - VoxelMesherCubes::PADDING; d < (unsigned int)max_pos[za]; ++d) {
+				// Branch-free mask pass: 0 = no face, 1 = back face, 2 = front face.
+				// Pure byte compares over the classification array, no calls, no branches.
+				{
+					unsigned int mi = 0;
 					FixedArray<unsigned int, Vector3iUtil::AXIS_COUNT> pos;
-					pos[xa] = fx;
-					pos[ya] = fy;
 					pos[za] = d;
-
-					const unsigned int voxel_index = pos[Vector3i::AXIS_Y] + pos[Vector3i::AXIS_X] * row_size +
-							pos[Vector3i::AXIS_Z] * deck_size;
-
-					const Voxel_T raw_color0 = voxel_buffer[voxel_index];
-					const Voxel_T raw_color1 = voxel_buffer[voxel_index + neighbor_offset_d_lut[za]];
-
-					const Color8 color0 = color_func(raw_color0);
-					const Color8 color1 = color_func(raw_color1);
-
-					// TODO Change this
-					const uint8_t ai0 = get_alpha_index(color0);
-					const uint8_t ai1 = get_alpha_index(color1);
-
-					Color8 color;
-					FaceSide side;
-					if (ai0 == ai1) {
-						continue;
-					} else if (ai0 > ai1) {
-						color = color0;
-						side = FACE_SIDE_BACK;
-					} else {
-						color = color1;
-						side = FACE_SIDE_FRONT;
+					for (unsigned int fy = min_pos[ya]; fy < (unsigned int)max_pos[ya]; ++fy) {
+						pos[ya] = fy;
+						for (unsigned int fx = min_pos[xa]; fx < (unsigned int)max_pos[xa]; ++fx, ++mi) {
+							pos[xa] = fx;
+							const unsigned int voxel_index = pos[Vector3i::AXIS_Y] +
+									pos[Vector3i::AXIS_X] * row_size + pos[Vector3i::AXIS_Z] * deck_size;
+							const uint8_t ai0 = alpha_indices[voxel_index];
+							const uint8_t ai1 = alpha_indices[voxel_index + neighbor_offset_d];
+							tls_mask[mi] = (ai0 != ai1) * (1 + (ai0 < ai1));
+						}
 					}
+				}
 
-					// Commit face to the mesh
-
-					const uint8_t material_index = color.a < 255;
-					VoxelMesherCubes::Arrays &arrays = out_arrays_per_material[material_index];
-
-					const int vx0 = fx - VoxelMesherCubes::PADDING;
-					const int vy0 = fy - VoxelMesherCubes::PADDING;
-					const int vx1 = vx0 + 1;
-					const int vy1 = vy0 + 1;
-
-					Vector3f v0;
-					v0[xa] = vx0;
-					v0[ya] = vy0;
-					v0[za] = d;
-
-					Vector3f v1;
-					v1[xa] = vx1;
-					v1[ya] = vy0;
-					v1[za] = d;
-
-					Vector3f v2;
-					v2[xa] = vx0;
-					v2[ya] = vy1;
-					v2[za] = d;
-
-					Vector3f v3;
-					v3[xa] = vx1;
-					v3[ya] = vy1;
-					v3[za] = d;
+				// Compaction pass: only masked cells emit quads
+				unsigned int mi = 0;
+				for (unsigned int fy = min_pos[ya]; fy < (unsigned int)max_pos[ya]; ++fy) {
+					for (unsigned int fx = min_pos[xa]; fx < (unsigned int)max_pos[xa]; ++fx, ++mi) {
+						const uint8_t m = tls_mask[mi];
+						if (m == 0) {
+							continue;
+						}
+						const FaceSide side = m == 1 ? FACE_SIDE_BACK : FACE_SIDE_FRONT;
+
+						FixedArray<unsigned int, Vector3iUtil::AXIS_COUNT> pos;
+						pos[xa] = fx;
+						pos[ya] = fy;
+						pos[za] = d;
+						const unsigned int voxel_index = pos[Vector3i::AXIS_Y] +
+								pos[Vector3i::AXIS_X] * row_size + pos[Vector3i::AXIS_Z] * deck_size;
+
+						// The visible side is the more opaque one
+						const Voxel_T raw_color = voxel_buffer[side == FACE_SIDE_BACK
+								? voxel_index
+								: voxel_index + neighbor_offset_d];
+						const Color8 color = (*color_func)(raw_color);
+
+						// Commit face to the mesh
+
+						const uint8_t material_index = color.a < 255;
+						VoxelMesherCubes::Arrays &arrays_m = arrays[material_index];
+
+						const int vx0 = fx - VoxelMesherCubes::PADDING;
+						const int vy0 = fy - VoxelMesherCubes::PADDING;
+						const int vx1 = vx0 + 1;
+						const int vy1 = vy0 + 1;
+
+						Vector3f v0;
+						v0[xa] = vx0;
+						v0[ya] = vy0;
+						v0[za] = d;
+
+						Vector3f v1;
+						v1[xa] = vx1;
+						v1[ya] = vy0;
+						v1[za] = d;
+
+						Vector3f v2;
+						v2[xa] = vx0;
+						v2[ya] = vy1;
+						v2[za] = d;
+
+						Vector3f v3;
+						v3[xa] = vx1;
+						v3[ya] = vy1;
+						v3[za] = d;
+
+						Vector3f n;
+						n[za] = side == FACE_SIDE_FRONT ? -1 : 1;
+
+						// 2-----3
+						// |     |
+						// |     |
+						// 0-----1
+
+						arrays_m.positions.push_back(v0);
+						arrays_m.positions.push_back(v1);
+						arrays_m.positions.push_back(v2);
+						arrays_m.positions.push_back(v3);
+
+						// TODO Any way to not need Color anywhere? It's wasteful
+						const Color colorf = color;
+						arrays_m.colors.push_back(colorf);
+						arrays_m.colors.push_back(colorf);
+						arrays_m.colors.push_back(colorf);
+						arrays_m.colors.push_back(colorf);
+
+						arrays_m.normals.push_back(n);
+						arrays_m.normals.push_back(n);
+						arrays_m.normals.push_back(n);
+						arrays_m.normals.push_back(n);
+
+						const unsigned int index_offset = index_offsets[material_index];
+						CRASH_COND(za >= 3 || side >= 2);
+						const uint8_t *lut = g_indices_lut[za][side];
+						for (unsigned int i = 0; i < 6; ++i) {
+							arrays_m.indices.push_back(index_offset + lut[i]);
+						}
+						index_offsets[material_index] += 4;
+					}
+				}
+			}
+		}
 
-					Vector3f n;
-					n[za] = side == FACE_SIDE_FRONT ? -1 : 1;
+		static void run(void *p_userdata) {
+			static_cast<AxisJob *>(p_userdata)->run_axis();
+		}
+	};
 
-					// 2-----3
-					// |     |
-					// |     |
-					// 0-----1
+	FixedArray<AxisJob, Vector3iUtil::AXIS_COUNT> jobs;
+	for (unsigned int za = 0; za < Vector3iUtil::AXIS_COUNT; ++za) {
+		AxisJob &job = jobs[za];
+		job.voxel_buffer = voxel_buffer;
+		job.alpha_indices = alpha_indices;
+		job.block_size = block_size;
+		job.min_pos = min_pos;
+		job.max_pos = max_pos;
+		job.row_size = row_size;
+		job.deck_size = deck_size;
+		job.za = za;
+		job.neighbor_offset_d = neighbor_offset_d_lut[za];
+		job.color_func = &color_func;
+	}
 
-					arrays.positions.push_back(v0);
-					arrays.positions.push_back(v1);
-					arrays.positions.push_back(v2);
-					arrays.positions.push_back(v3);
+	// Big colored blocks are worth fanning the axes out over temporary threads, in the same spirit
+	// as the Transvoxel slabs; small ones aren't, thread startup isn't free
+	if (volume >= 32 * 32 * 32) {
+		FixedArray<Thread, 2> threads;
+		threads[0].start(&AxisJob::run, &jobs[1]);
+		threads[1].start(&AxisJob::run, &jobs[2]);
+		jobs[0].run_axis();
+		threads[0].wait_to_finish();
+		threads[1].wait_to_finish();
+	} else {
+		for (unsigned int za = 0; za < Vector3iUtil::AXIS_COUNT; ++za) {
+			jobs[za].run_axis();
+		}
+	}
 
-					// TODO Any way to not need Color anywhere? It's wasteful
-					const Color colorf = color;
-					arrays.colors.push_back(colorf);
-					arrays.colors.push_back(colorf);
-					arrays.colors.push_back(colorf);
-					arrays.colors.push_back(colorf);
+	// Merge per-axis outputs, rebasing indices
+	for (unsigned int za = 0; za < Vector3iUtil::AXIS_COUNT; ++za) {
+		const AxisJob &job = jobs[za];
+		for (unsigned int mi = 0; mi < VoxelMesherCubes::MATERIAL_COUNT; ++mi) {
+			const VoxelMesherCubes::Arrays &src = job.arrays[mi];
+			VoxelMesherCubes::Arrays &dst = out_arrays_per_material[mi];
+			const uint32_t index_base = dst.positions.size();
+			dst.positions.insert(dst.positions.end(), src.positions.begin(), src.positions.end());
+			dst.normals.insert(dst.normals.end(), src.normals.begin(), src.normals.end());
+			dst.colors.insert(dst.colors.end(), src.colors.begin(), src.colors.end());
+			for (size_t ii = 0; ii < src.indices.size(); ++ii) {
+				dst.indices.push_back(index_base + src.indices[ii]);
+			}
+		}
+	}
+}
 
-					arrays.normals.push_back(n);
-					arrays.normals.push_back(n);
-					arrays.normals.push_back(n);
-					arrays.normals.push_back(n);
+// Stitches the cached geometry of one deck back into the output arrays, rebasing indices.
+void stitch_cached_deck(const VoxelMesherCubes::DeckCacheEntry &deck_cache,
+		FixedArray<VoxelMesherCubes::Arrays, VoxelMesherCubes::MATERIAL_COUNT> &out_arrays_per_material,
+		FixedArray<uint32_t, VoxelMesherCubes::MATERIAL_COUNT> &index_offsets) {
+	for (unsigned int mi = 0; mi < VoxelMesherCubes::MATERIAL_COUNT; ++mi) {
+		const VoxelMesherCubes::Arrays &src = deck_cache.arrays_per_material[mi];
+		VoxelMesherCubes::Arrays &dst = out_arrays_per_material[mi];
+		dst.positions.insert(dst.positions.end(), src.positions.begin(), src.positions.end());
+		dst.normals.insert(dst.normals.end(), src.normals.begin(), src.normals.end());
+		dst.colors.insert(dst.colors.end(), src.colors.begin(), src.colors.end());
+		const uint32_t index_base = index_offsets[mi];
+		for (size_t ii = 0; ii < src.indices.size(); ++ii) {
+			dst.indices.push_back(index_base + src.indices[ii]);
+		}
+		index_offsets[mi] += src.positions.size();
+	}
+}
 
-					const unsigned int index_offset = index_offsets[material_index];
-					CRASH_COND(za >= 3 || side >= 2);
-					const uint8_t *lut = g_indices_lut[za][side];
-					for (unsigned int i = 0; i < 6; ++i) {
-						arrays.indices.push_back(index_offset + lut[i]);
-					}
-					index_offsets[material_index] += 4;
-				}
+// Hash of the two voxel slabs a deck of faces depends on. Used to detect unchanged decks.
+template <typename Voxel_T>
+uint64_t hash_deck_slabs(const Span<Voxel_T> voxel_buffer, const Vector3i block_size, unsigned int za,
+		unsigned int deck, unsigned int row_size, unsigned int deck_size) {
+	uint64_t h = uint64_t(14695981039346656037ULL);
+	FixedArray<unsigned int, Vector3iUtil::AXIS_COUNT> pos;
+	for (unsigned int i = 0; i < 2; ++i) {
+		pos[za] = deck + i;
+		const unsigned int xa = g_face_axes_lut[za][0];
+		const unsigned int ya = g_face_axes_lut[za][1];
+		for (pos[xa] = 0; pos[xa] < (unsigned int)block_size[xa]; ++pos[xa]) {
+			for (pos[ya] = 0; pos[ya] < (unsigned int)block_size[ya]; ++pos[ya]) {
+				const unsigned int voxel_index = pos[Vector3i::AXIS_Y] + pos[Vector3i::AXIS_X] * row_size +
+						pos[Vector3i::AXIS_Z] * deck_size;
+				h = (h ^ uint64_t(voxel_buffer[voxel_index])) * uint64_t(1099511628211ULL);
 			}
 		}
 	}
+	return h;
 }
 
 template <typename Voxel_T, typename Color_F>
 void build_voxel_mesh_as_greedy_cubes(
 		FixedArray<VoxelMesherCubes::Arrays, VoxelMesherCubes::MATERIAL_COUNT> &out_arrays_per_material,
 		const Span<Voxel_T> voxel_buffer, const Vector3i block_size, std::vector<uint8_t> &mask_memory_pool,
-		Color_F color_func) {
+		Color_F color_func, VoxelMesherCubes::BlockMeshCache *inc_cache = nullptr,
+		const Box3i *dirty_box = nullptr) {
 	//
 	ERR_FAIL_COND(block_size.x < static_cast<int>(2 * VoxelMesherCubes::PADDING) ||
 			block_size.y < static_cast<int>(2 * VoxelMesherCubes::PADDING) ||
@@ -243,8 +383,48 @@ void build_voxel_mesh_as_greedy_cubes(
 		mask_memory_pool.resize(mask_area * sizeof(MaskValue));
 		Span<MaskValue> mask(reinterpret_cast<MaskValue *>(mask_memory_pool.data()), 0, mask_area);
 
+		const unsigned int deck_count = max_pos[za];
+		if (inc_cache != nullptr && inc_cache->decks[za].size() != deck_count) {
+			// First build with this block size, nothing reusable
+			inc_cache->decks[za].clear();
+			inc_cache->decks[za].resize(deck_count);
+		}
+
 		// For each deck
 		for (unsigned int d = min_pos[za] - VoxelMesherCubes::PADDING; d < (unsigned int)max_pos[za]; ++d) {
+			VoxelMesherCubes::DeckCacheEntry *deck_cache = nullptr;
+			uint64_t deck_hash = 0;
+			FixedArray<size_t, VoxelMesherCubes::MATERIAL_COUNT> deck_first_vertex;
+			FixedArray<size_t, VoxelMesherCubes::MATERIAL_COUNT> deck_first_index;
+			FixedArray<uint32_t, VoxelMesherCubes::MATERIAL_COUNT> deck_index_base;
+
+			if (inc_cache != nullptr) {
+				deck_cache = &inc_cache->decks[za][d];
+
+				// A deck only depends on the two voxel slabs on either side of it. If the caller told
+				// us which region changed, decks fully outside of it can be reused without even
+				// hashing their slabs.
+				if (dirty_box != nullptr && deck_cache->valid &&
+						(int(d) + 1 < dirty_box->pos[za] || int(d) >= dirty_box->pos[za] + dirty_box->size[za])) {
+					stitch_cached_deck(*deck_cache, out_arrays_per_material, index_offsets);
+					continue;
+				}
+
+				deck_hash = hash_deck_slabs(voxel_buffer, block_size, za, d, row_size, deck_size);
+
+				if (deck_cache->valid && deck_cache->hash == deck_hash) {
+					// The voxels this deck depends on did not change, stitch the previous geometry back in
+					stitch_cached_deck(*deck_cache, out_arrays_per_material, index_offsets);
+					continue;
+				}
+
+				for (unsigned int mi = 0; mi < VoxelMesherCubes::MATERIAL_COUNT; ++mi) {
+					deck_first_vertex[mi] = out_arrays_per_material[mi].positions.size();
+					deck_first_index[mi] = out_arrays_per_material[mi].indices.size();
+					deck_index_base[mi] = index_offsets[mi];
+				}
+			}
+
 			// For each cell of the deck, gather face info
 			for (unsigned int fy = min_pos[ya]; fy < (unsigned int)max_pos[ya]; ++fy) {
 				for (unsigned int fx = min_pos[xa]; fx < (unsigned int)max_pos[xa]; ++fx) {
@@ -379,6 +559,24 @@ void build_voxel_mesh_as_greedy_cubes(
 					}
 				}
 			}
+
+			if (deck_cache != nullptr) {
+				// Snapshot what this deck produced, with indices rebased to the start of the deck
+				deck_cache->hash = deck_hash;
+				deck_cache->valid = true;
+				for (unsigned int mi = 0; mi < VoxelMesherCubes::MATERIAL_COUNT; ++mi) {
+					const VoxelMesherCubes::Arrays &src = out_arrays_per_material[mi];
+					VoxelMesherCubes::Arrays &dst = deck_cache->arrays_per_material[mi];
+					dst.clear();
+					dst.positions.insert(dst.positions.end(), src.positions.begin() + deck_first_vertex[mi],
+							src.positions.end());
+					dst.normals.insert(dst.normals.end(), src.normals.begin() + deck_first_vertex[mi], src.normals.end());
+					dst.colors.insert(dst.colors.end(), src.colors.begin() + deck_first_vertex[mi], src.colors.end());
+					for (size_t ii = deck_first_index[mi]; ii < src.indices.size(); ++ii) {
+						dst.indices.push_back(src.indices[ii] - deck_index_base[mi]);
+					}
+				}
+			}
 		}
 	}
 }
@@ -709,6 +907,7 @@ VoxelMesherCubes::~VoxelMesherCubes() {}
 
 void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Input &input) {
 	ZN_PROFILE_SCOPE();
+	ZN_LIGHT_PROFILE_SCOPE("cubes_build_mesh");
 	const int channel = VoxelBufferInternal::CHANNEL_COLOR;
 	Cache &cache = _cache;
 
@@ -754,6 +953,41 @@ void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Inp
 	}
 	// Note, we don't lock the palette because its data has fixed-size
 
+	// Get or create the incremental cache of the block being meshed. Shared pointer so clearing the
+	// map (on parameter changes) can't free an entry a running build still uses.
+	std::shared_ptr<BlockMeshCache> inc_cache_ref;
+	BlockMeshCache *inc_cache = nullptr;
+	if (params.greedy_meshing && params.incremental_meshing) {
+		MutexLock lock(_incremental_cache_mutex);
+		std::shared_ptr<BlockMeshCache> &slot = _incremental_cache[input.origin_in_voxels];
+		// Another volume using this mesher can mesh a block at the same origin, its geometry must
+		// not be reused. Replacing the instance keeps the old one valid for builds still using it.
+		if (slot == nullptr || slot->volume_id != input.volume_id) {
+			slot = make_shared_instance<BlockMeshCache>();
+			slot->volume_id = input.volume_id;
+		}
+		inc_cache_ref = slot;
+		inc_cache = inc_cache_ref.get();
+	}
+	const Box3i *dirty_box = (inc_cache != nullptr && input.has_dirty_box) ? &input.dirty_box : nullptr;
+
+	// Several updates of the same block can be in flight at once when edits pile up; serialize
+	// their access to the shared per-block cache.
+	struct ConditionalLock {
+		Mutex *mutex;
+		ConditionalLock(Mutex *p_mutex) : mutex(p_mutex) {
+			if (mutex != nullptr) {
+				mutex->lock();
+			}
+		}
+		~ConditionalLock() {
+			if (mutex != nullptr) {
+				mutex->unlock();
+			}
+		}
+	};
+	ConditionalLock inc_cache_lock(inc_cache != nullptr ? &inc_cache->mutex : nullptr);
+
 	Ref<Image> atlas_image;
 
 	switch (params.color_mode) {
@@ -762,7 +996,7 @@ void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Inp
 				case VoxelBufferInternal::DEPTH_8_BIT:
 					if (params.greedy_meshing) {
 						build_voxel_mesh_as_greedy_cubes(cache.arrays_per_material, raw_channel, block_size,
-								cache.mask_memory_pool, Color8::from_u8);
+								cache.mask_memory_pool, Color8::from_u8, inc_cache, dirty_box);
 					} else {
 						build_voxel_mesh_as_simple_cubes(
 								cache.arrays_per_material, raw_channel, block_size, Color8::from_u8);
@@ -773,7 +1007,7 @@ void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Inp
 					if (params.greedy_meshing) {
 						build_voxel_mesh_as_greedy_cubes(cache.arrays_per_material,
 								raw_channel.reinterpret_cast_to<uint16_t>(), block_size, cache.mask_memory_pool,
-								Color8::from_u16);
+								Color8::from_u16, inc_cache, dirty_box);
 					} else {
 						build_voxel_mesh_as_simple_cubes(cache.arrays_per_material,
 								raw_channel.reinterpret_cast_to<uint16_t>(), block_size, Color8::from_u16);
@@ -810,7 +1044,7 @@ void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Inp
 									make_greedy_atlas(cache.greedy_atlas_data, to_span(cache.arrays_per_material));
 						} else {
 							build_voxel_mesh_as_greedy_cubes(cache.arrays_per_material, raw_channel, block_size,
-									cache.mask_memory_pool, get_color_from_palette);
+									cache.mask_memory_pool, get_color_from_palette, inc_cache, dirty_box);
 						}
 					} else {
 						build_voxel_mesh_as_simple_cubes(
@@ -822,7 +1056,7 @@ void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Inp
 					if (params.greedy_meshing) {
 						build_voxel_mesh_as_greedy_cubes(cache.arrays_per_material,
 								raw_channel.reinterpret_cast_to<uint16_t>(), block_size, cache.mask_memory_pool,
-								get_color_from_palette);
+								get_color_from_palette, inc_cache, dirty_box);
 					} else {
 						build_voxel_mesh_as_simple_cubes(cache.arrays_per_material,
 								raw_channel.reinterpret_cast_to<uint16_t>(), block_size, get_color_from_palette);
@@ -851,7 +1085,7 @@ void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Inp
 				case VoxelBufferInternal::DEPTH_8_BIT:
 					if (params.greedy_meshing) {
 						build_voxel_mesh_as_greedy_cubes(cache.arrays_per_material, raw_channel, block_size,
-								cache.mask_memory_pool, get_index_from_palette);
+								cache.mask_memory_pool, get_index_from_palette, inc_cache, dirty_box);
 					} else {
 						build_voxel_mesh_as_simple_cubes(
 								cache.arrays_per_material, raw_channel, block_size, get_index_from_palette);
@@ -862,7 +1096,7 @@ void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Inp
 					if (params.greedy_meshing) {
 						build_voxel_mesh_as_greedy_cubes(cache.arrays_per_material,
 								raw_channel.reinterpret_cast_to<uint16_t>(), block_size, cache.mask_memory_pool,
-								get_index_from_palette);
+								get_index_from_palette, inc_cache, dirty_box);
 					} else {
 						build_voxel_mesh_as_simple_cubes(cache.arrays_per_material,
 								raw_channel.reinterpret_cast_to<uint16_t>(), block_size, get_index_from_palette);
@@ -945,8 +1179,31 @@ void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Inp
 }
 
 void VoxelMesherCubes::set_greedy_meshing_enabled(bool enable) {
-	RWLockWrite wlock(_parameters_lock);
-	_parameters.greedy_meshing = enable;
+	{
+		RWLockWrite wlock(_parameters_lock);
+		_parameters.greedy_meshing = enable;
+	}
+	// Cached deck geometry was produced with the previous settings
+	clear_incremental_cache();
+}
+
+void VoxelMesherCubes::set_incremental_meshing_enabled(bool enable) {
+	{
+		RWLockWrite wlock(_parameters_lock);
+		_parameters.incremental_meshing = enable;
+	}
+	clear_incremental_cache();
+}
+
+bool VoxelMesherCubes::is_incremental_meshing_enabled() const {
+	RWLockRead rlock(_parameters_lock);
+	return _parameters.incremental_meshing;
+}
+
+void VoxelMesherCubes::clear_incremental_cache() {
+	MutexLock lock(_incremental_cache_mutex);
+	// Builds currently using an entry keep it alive through their own shared pointer
+	_incremental_cache.clear();
 }
 
 bool VoxelMesherCubes::is_greedy_meshing_enabled() const {
@@ -955,8 +1212,11 @@ bool VoxelMesherCubes::is_greedy_meshing_enabled() const {
 }
 
 void VoxelMesherCubes::set_palette(Ref<VoxelColorPalette> palette) {
-	RWLockWrite wlock(_parameters_lock);
-	_parameters.palette = palette;
+	{
+		RWLockWrite wlock(_parameters_lock);
+		_parameters.palette = palette;
+	}
+	clear_incremental_cache();
 }
 
 Ref<VoxelColorPalette> VoxelMesherCubes::get_palette() const {
@@ -966,8 +1226,11 @@ Ref<VoxelColorPalette> VoxelMesherCubes::get_palette() const {
 
 void VoxelMesherCubes::set_color_mode(ColorMode mode) {
 	ERR_FAIL_INDEX(mode, COLOR_MODE_COUNT);
-	RWLockWrite wlock(_parameters_lock);
-	_parameters.color_mode = mode;
+	{
+		RWLockWrite wlock(_parameters_lock);
+		_parameters.color_mode = mode;
+	}
+	clear_incremental_cache();
 }
 
 VoxelMesherCubes::ColorMode VoxelMesherCubes::get_color_mode() const {
@@ -976,8 +1239,11 @@ VoxelMesherCubes::ColorMode VoxelMesherCubes::get_color_mode() const {
 }
 
 void VoxelMesherCubes::set_store_colors_in_texture(bool enable) {
-	RWLockWrite wlock(_parameters_lock);
-	_parameters.store_colors_in_texture = enable;
+	{
+		RWLockWrite wlock(_parameters_lock);
+		_parameters.store_colors_in_texture = enable;
+	}
+	clear_incremental_cache();
 }
 
 bool VoxelMesherCubes::get_store_colors_in_texture() const {
@@ -1009,6 +1275,10 @@ void VoxelMesherCubes::_bind_methods() {
 	ClassDB::bind_method(
 			D_METHOD("set_greedy_meshing_enabled", "enable"), &VoxelMesherCubes::set_greedy_meshing_enabled);
 	ClassDB::bind_method(D_METHOD("is_greedy_meshing_enabled"), &VoxelMesherCubes::is_greedy_meshing_enabled);
+	ClassDB::bind_method(D_METHOD("set_incremental_meshing_enabled", "enable"),
+			&VoxelMesherCubes::set_incremental_meshing_enabled);
+	ClassDB::bind_method(
+			D_METHOD("is_incremental_meshing_enabled"), &VoxelMesherCubes::is_incremental_meshing_enabled);
 
 	ClassDB::bind_method(D_METHOD("set_palette", "palette"), &VoxelMesherCubes::set_palette);
 	ClassDB::bind_method(D_METHOD("get_palette"), &VoxelMesherCubes::get_palette);
@@ -1018,6 +1288,8 @@ void VoxelMesherCubes::_bind_methods() {
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "greedy_meshing_enabled"), "set_greedy_meshing_enabled",
 			"is_greedy_meshing_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "incremental_meshing_enabled"), "set_incremental_meshing_enabled",
+			"is_incremental_meshing_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "color_mode", PROPERTY_HINT_ENUM, "Raw,MesherPalette,ShaderPalette"),
 			"set_color_mode", "get_color_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "palette", PROPERTY_HINT_RESOURCE_TYPE,
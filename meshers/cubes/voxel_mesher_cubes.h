@@ -3,10 +3,13 @@
 
 #include "../../util/math/vector2f.h"
 #include "../../util/math/vector3f.h"
+#include "../../util/thread/mutex.h"
 #include "../../util/thread/rw_lock.h"
 #include "../voxel_mesher.h"
 #include "voxel_color_palette.h"
 
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace zylann::voxel {
@@ -45,6 +48,13 @@ public:
 	void set_greedy_meshing_enabled(bool enable);
 	bool is_greedy_meshing_enabled() const;
 
+	// When enabled along with greedy meshing, geometry of unchanged decks (slices along each axis) is
+	// reused from the previous build of the same block instead of being re-gathered and re-merged.
+	// Worth it when blocks are remeshed often with localized edits, at the cost of retaining geometry
+	// in memory per block. Off by default.
+	void set_incremental_meshing_enabled(bool enable);
+	bool is_incremental_meshing_enabled() const;
+
 	void set_color_mode(ColorMode mode);
 	ColorMode get_color_mode() const;
 
@@ -81,6 +91,24 @@ public:
 		}
 	};
 
+	// Incremental meshing: cached output of one deck (slice of faces perpendicular to one axis).
+	// Indices are stored relative to the first vertex of the deck, and rebased when stitched back.
+	struct DeckCacheEntry {
+		uint64_t hash = 0;
+		bool valid = false;
+		FixedArray<Arrays, MATERIAL_COUNT> arrays_per_material;
+	};
+
+	struct BlockMeshCache {
+		// [axis][deck]
+		FixedArray<std::vector<DeckCacheEntry>, 3> decks;
+		// Volume the cached geometry was built from, so blocks of other volumes at the same
+		// position don't reuse it
+		uint32_t volume_id = 0;
+		// Serializes concurrent builds of the same block
+		Mutex mutex;
+	};
+
 	struct GreedyAtlasData {
 		struct ImageInfo {
 			unsigned int first_color_index;
@@ -107,8 +135,11 @@ private:
 		Ref<VoxelColorPalette> palette;
 		bool greedy_meshing = true;
 		bool store_colors_in_texture = false;
+		bool incremental_meshing = false;
 	};
 
+	void clear_incremental_cache();
+
 	struct Cache {
 		FixedArray<Arrays, MATERIAL_COUNT> arrays_per_material;
 		std::vector<uint8_t> mask_memory_pool;
@@ -121,6 +152,12 @@ private:
 
 	// Work cache
 	static thread_local Cache _cache;
+
+	// Incremental meshing cache, keyed by block position. Concurrent builds of different blocks only hold
+	// the mutex to look up their entry; the same block is never meshed twice at a time by the server.
+	// Entries are shared pointers so clearing the cache cannot pull memory from under a running build.
+	std::unordered_map<Vector3i, std::shared_ptr<BlockMeshCache>> _incremental_cache;
+	Mutex _incremental_cache_mutex;
 };
 
 } // namespace zylann::voxel
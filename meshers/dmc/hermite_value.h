@@ -1,6 +1,7 @@
 #ifndef HERMITE_VALUE_H
 #define HERMITE_VALUE_H
 
+#include "../../storage/funcs.h"
 #include "../../storage/voxel_buffer_internal.h"
 #include "../../util/math/funcs.h"
 #include "../../util/math/vector3f.h"
@@ -74,6 +75,58 @@ inline HermiteValue get_interpolated_hermite_value(const VoxelBufferInternal &vo
 	return v;
 }
 
+// Gathers Hermite samples straight from a dense 16-bit ZXY SDF channel, the layout every
+// terrain block uses in practice. `get_hermite_value` pays a full per-voxel dispatch (depth
+// switch, format checks) for each of its 7 reads; the simplification pass performs hundreds of
+// those per octree cell, which made it dominate DMC's runtime. Buffers in another shape fall
+// back to the generic reads transparently.
+struct HermiteSampler {
+	const VoxelBufferInternal &voxels;
+	Span<const int16_t> raw;
+	Vector3i size;
+	bool fast = false;
+
+	HermiteSampler(const VoxelBufferInternal &p_voxels) : voxels(p_voxels) {
+		size = voxels.get_size();
+		const unsigned int channel = VoxelBufferInternal::CHANNEL_SDF;
+		Span<const uint8_t> bytes;
+		if (voxels.get_channel_depth(channel) == VoxelBufferInternal::DEPTH_16_BIT &&
+				voxels.get_channel_compression(channel) == VoxelBufferInternal::COMPRESSION_NONE &&
+				voxels.get_channel_layout(channel) == VoxelBufferInternal::CHANNEL_LAYOUT_ZXY &&
+				voxels.get_channel_raw_read_only(channel, bytes)) {
+			raw = bytes.reinterpret_cast_to<const int16_t>();
+			fast = true;
+		}
+	}
+
+	// Matches the clamping of `get_isolevel_clamped`, including its unsigned wrap at -1
+	inline float get_sdf_clamped(unsigned int x, unsigned int y, unsigned int z) const {
+		x = x >= (unsigned int)size.x ? size.x - 1 : x;
+		y = y >= (unsigned int)size.y ? size.y - 1 : y;
+		z = z >= (unsigned int)size.z ? size.z - 1 : z;
+		return s16_to_snorm(raw[y + size.y * (x + size.x * z)]);
+	}
+
+	inline float get_sdf(unsigned int x, unsigned int y, unsigned int z) const {
+		if (!fast) {
+			return voxels.get_voxel_f(x, y, z, VoxelBufferInternal::CHANNEL_SDF);
+		}
+		return get_sdf_clamped(x, y, z);
+	}
+
+	inline HermiteValue get_hermite(unsigned int x, unsigned int y, unsigned int z) const {
+		if (!fast) {
+			return get_hermite_value(voxels, x, y, z);
+		}
+		HermiteValue v;
+		v.sdf = get_sdf_clamped(x, y, z);
+		v.gradient.x = get_sdf_clamped(x + 1, y, z) - get_sdf_clamped(x - 1, y, z);
+		v.gradient.y = get_sdf_clamped(x, y + 1, z) - get_sdf_clamped(x, y - 1, z);
+		v.gradient.z = get_sdf_clamped(x, y, z + 1) - get_sdf_clamped(x, y, z - 1);
+		return v;
+	}
+};
+
 } // namespace zylann::voxel::dmc
 
 #endif // HERMITE_VALUE_H
@@ -5,8 +5,12 @@
 #include "mesh_builder.h"
 #include "octree_tables.h"
 
+#include "../../util/thread/thread.h"
+
 #include <core/os/time.h>
 
+#include <atomic>
+
 // Dual marching cubes
 // Algorithm taken from https://www.volume-gfx.com/volume-rendering/dual-marching-cubes/
 // Partially based on Ogre's implementation, adapted for requirements of this module with a few extras
@@ -23,18 +27,48 @@ const float SQRT3 = 1.7320508075688772;
 struct VoxelAccess {
 	const VoxelBufferInternal &buffer;
 	const Vector3i offset;
+	// Direct gather over the common dense 16-bit SDF layout; other shapes fall back to the
+	// generic per-voxel reads transparently. See `HermiteSampler`.
+	const HermiteSampler sampler;
 
-	VoxelAccess(const VoxelBufferInternal &p_buffer, Vector3i p_offset) : buffer(p_buffer), offset(p_offset) {}
+	VoxelAccess(const VoxelBufferInternal &p_buffer, Vector3i p_offset) :
+			buffer(p_buffer), offset(p_offset), sampler(p_buffer) {}
 
 	inline HermiteValue get_hermite_value(int x, int y, int z) const {
-		return dmc::get_hermite_value(buffer, x + offset.x, y + offset.y, z + offset.z);
+		return sampler.get_hermite(x + offset.x, y + offset.y, z + offset.z);
 	}
 
 	inline HermiteValue get_interpolated_hermite_value(Vector3f pos) const {
 		pos.x += offset.x;
 		pos.y += offset.y;
 		pos.z += offset.z;
-		return dmc::get_interpolated_hermite_value(buffer, pos);
+		if (!sampler.fast) {
+			return dmc::get_interpolated_hermite_value(buffer, pos);
+		}
+
+		const int x0 = static_cast<int>(pos.x);
+		const int y0 = static_cast<int>(pos.y);
+		const int z0 = static_cast<int>(pos.z);
+		const int x1 = static_cast<int>(Math::ceil(pos.x));
+		const int y1 = static_cast<int>(Math::ceil(pos.y));
+		const int z1 = static_cast<int>(Math::ceil(pos.z));
+
+		const HermiteValue v0 = sampler.get_hermite(x0, y0, z0);
+		const HermiteValue v1 = sampler.get_hermite(x1, y0, z0);
+		const HermiteValue v2 = sampler.get_hermite(x1, y0, z1);
+		const HermiteValue v3 = sampler.get_hermite(x0, y0, z1);
+		const HermiteValue v4 = sampler.get_hermite(x0, y1, z0);
+		const HermiteValue v5 = sampler.get_hermite(x1, y1, z0);
+		const HermiteValue v6 = sampler.get_hermite(x1, y1, z1);
+		const HermiteValue v7 = sampler.get_hermite(x0, y1, z1);
+
+		const Vector3f rpos = pos - Vector3f(x0, y0, z0);
+
+		HermiteValue v;
+		v.sdf = math::interpolate_trilinear(v0.sdf, v1.sdf, v2.sdf, v3.sdf, v4.sdf, v5.sdf, v6.sdf, v7.sdf, rpos);
+		v.gradient = math::interpolate_trilinear(v0.gradient, v1.gradient, v2.gradient, v3.gradient, v4.gradient,
+				v5.gradient, v6.gradient, v7.gradient, rpos);
+		return v;
 	}
 };
 
@@ -46,7 +80,6 @@ bool can_split(Vector3i node_origin, int node_size, const VoxelAccess &voxels, f
 
 	Vector3i origin = node_origin + voxels.offset;
 	int step = node_size;
-	int channel = VoxelBufferInternal::CHANNEL_SDF;
 
 	// Don't split if nothing is inside, i.e isolevel distance is greater than the size of the cube we are in
 	Vector3i center_pos = node_origin + Vector3iUtil::create(node_size / 2);
@@ -57,15 +90,15 @@ bool can_split(Vector3i node_origin, int node_size, const VoxelAccess &voxels, f
 
 	// Fighting with Clang-format here /**/
 
-	float v0 = voxels.buffer.get_voxel_f(origin.x, /*  */ origin.y, /*  */ origin.z, /*  */ channel); // 0
-	float v1 = voxels.buffer.get_voxel_f(origin.x + step, origin.y, /*  */ origin.z, /*  */ channel); // 1
-	float v2 = voxels.buffer.get_voxel_f(origin.x + step, origin.y, /*  */ origin.z + step, channel); // 2
-	float v3 = voxels.buffer.get_voxel_f(origin.x, /*  */ origin.y, /*  */ origin.z + step, channel); // 3
+	float v0 = voxels.sampler.get_sdf(origin.x, /*  */ origin.y, /*  */ origin.z /*       */); // 0
+	float v1 = voxels.sampler.get_sdf(origin.x + step, origin.y, /*  */ origin.z /*       */); // 1
+	float v2 = voxels.sampler.get_sdf(origin.x + step, origin.y, /*  */ origin.z + step /**/); // 2
+	float v3 = voxels.sampler.get_sdf(origin.x, /*  */ origin.y, /*  */ origin.z + step /**/); // 3
 
-	float v4 = voxels.buffer.get_voxel_f(origin.x, /*  */ origin.y + step, origin.z, /*  */ channel); // 4
-	float v5 = voxels.buffer.get_voxel_f(origin.x + step, origin.y + step, origin.z, /*  */ channel); // 5
-	float v6 = voxels.buffer.get_voxel_f(origin.x + step, origin.y + step, origin.z + step, channel); // 6
-	float v7 = voxels.buffer.get_voxel_f(origin.x, /*  */ origin.y + step, origin.z + step, channel); // 7
+	float v4 = voxels.sampler.get_sdf(origin.x, /*  */ origin.y + step, origin.z /*       */); // 4
+	float v5 = voxels.sampler.get_sdf(origin.x + step, origin.y + step, origin.z /*       */); // 5
+	float v6 = voxels.sampler.get_sdf(origin.x + step, origin.y + step, origin.z + step /**/); // 6
+	float v7 = voxels.sampler.get_sdf(origin.x, /*  */ origin.y + step, origin.z + step /**/); // 7
 
 	int hstep = step / 2;
 
@@ -123,7 +156,7 @@ bool can_split(Vector3i node_origin, int node_size, const VoxelAccess &voxels, f
 	for (int i = 0; i < 19; ++i) {
 		Vector3i pos = positions[i];
 
-		HermiteValue value = get_hermite_value(voxels.buffer, pos.x, pos.y, pos.z);
+		HermiteValue value = voxels.sampler.get_hermite(pos.x, pos.y, pos.z);
 
 		float interpolated_value = math::interpolate_trilinear(v0, v1, v2, v3, v4, v5, v6, v7, positions_ratio[i]);
 
@@ -146,8 +179,9 @@ inline Vector3f get_center(const OctreeNode *node) {
 
 class OctreeBuilderTopDown {
 public:
-	OctreeBuilderTopDown(const VoxelAccess &voxels, float geometry_error, OctreeNodePool &pool) :
-			_voxels(voxels), _geometry_error(geometry_error), _pool(pool) {}
+	OctreeBuilderTopDown(const VoxelAccess &voxels, float geometry_error, OctreeNodePool &pool,
+			const std::atomic_bool *validity_flag = nullptr) :
+			_voxels(voxels), _geometry_error(geometry_error), _pool(pool), _validity_flag(validity_flag) {}
 
 	OctreeNode *build(Vector3i origin, int size) {
 		OctreeNode *root = _pool.create();
@@ -157,8 +191,14 @@ public:
 		return root;
 	}
 
-private:
+	// Also used by the parallel per-octant path, which pre-splits the root on the main thread
+	// and refines each child with its own builder
 	void build(OctreeNode *node) {
+		if (_validity_flag != nullptr && !_validity_flag->load(std::memory_order_relaxed)) {
+			// Result is already dead, leave the subtree unsplit; the caller discards the mesh
+			node->center_value = _voxels.get_interpolated_hermite_value(get_center(node));
+			return;
+		}
 		if (can_split(node->origin, node->size, _voxels, _geometry_error)) {
 			split(node);
 			for (int i = 0; i < 8; ++i) {
@@ -187,15 +227,22 @@ private:
 	const VoxelAccess &_voxels;
 	const float _geometry_error;
 	OctreeNodePool &_pool;
+	const std::atomic_bool *_validity_flag = nullptr;
 };
 
 // Builds the octree bottom-up, to ensure that no detail can be missed by a top-down approach.
 class OctreeBuilderBottomUp {
 public:
-	OctreeBuilderBottomUp(const VoxelAccess &voxels, float geometry_error, OctreeNodePool &pool) :
-			_voxels(voxels), _geometry_error(geometry_error), _pool(pool) {}
+	OctreeBuilderBottomUp(const VoxelAccess &voxels, float geometry_error, OctreeNodePool &pool,
+			const std::atomic_bool *validity_flag = nullptr) :
+			_voxels(voxels), _geometry_error(geometry_error), _pool(pool), _validity_flag(validity_flag) {}
 
 	OctreeNode *build(Vector3i node_origin, int node_size) const {
+		if (_validity_flag != nullptr && !_validity_flag->load(std::memory_order_relaxed)) {
+			// Result is already dead; an absent subtree reads as "no detail", which the caller
+			// discards anyway
+			return nullptr;
+		}
 		OctreeNode *children[8] = { nullptr };
 		bool any_node = false;
 
@@ -261,6 +308,7 @@ private:
 	const VoxelAccess &_voxels;
 	const float _geometry_error;
 	OctreeNodePool &_pool;
+	const std::atomic_bool *_validity_flag = nullptr;
 };
 
 template <typename Action_T>
@@ -1394,6 +1442,14 @@ VoxelMesherDMC::SeamMode VoxelMesherDMC::get_seam_mode() const {
 	return _parameters.seam_mode;
 }
 
+void VoxelMesherDMC::set_octree_parallelism(int thread_count) {
+	_octree_parallelism = math::clamp(thread_count, 1, 8);
+}
+
+int VoxelMesherDMC::get_octree_parallelism() const {
+	return _octree_parallelism;
+}
+
 void VoxelMesherDMC::build(VoxelMesher::Output &output, const VoxelMesher::Input &input) {
 	using namespace zylann::voxel;
 
@@ -1461,12 +1517,144 @@ void VoxelMesherDMC::build(VoxelMesher::Output &output, const VoxelMesher::Input
 	//
 	// TODO This option might disappear once I find a good enough solution
 	dmc::OctreeNode *root = nullptr;
-	if (params.simplify_mode == SIMPLIFY_OCTREE_BOTTOM_UP) {
-		dmc::OctreeBuilderBottomUp octree_builder(voxels_access, params.geometric_error, cache.octree_node_pool);
+	// Forked per root octant: the eight subtrees are independent, each job builds its own with a
+	// task-local node pool (seeded from the shared one), and the root combines them afterwards.
+	// The simplification threshold pass dominates DMC's runtime, and it parallelizes cleanly here.
+	const bool parallel_octree = _octree_parallelism > 1 && chunk_size >= 16 &&
+			(params.simplify_mode == SIMPLIFY_OCTREE_BOTTOM_UP || params.simplify_mode == SIMPLIFY_OCTREE_TOP_DOWN);
+
+	if (parallel_octree) {
+		struct OctantJob {
+			const dmc::VoxelAccess *voxels = nullptr;
+			float geometric_error;
+			Vector3i origin;
+			int size;
+			bool top_down;
+			dmc::OctreeNode *input_node = nullptr; // Top-down only: pre-created child to refine
+			const std::atomic_bool *validity_flag = nullptr;
+			dmc::OctreeNodePool pool;
+			dmc::OctreeNode *result = nullptr;
+
+			static void run(void *p_userdata) {
+				OctantJob &job = *static_cast<OctantJob *>(p_userdata);
+				if (job.top_down) {
+					dmc::OctreeBuilderTopDown builder(*job.voxels, job.geometric_error, job.pool, job.validity_flag);
+					builder.build(job.input_node);
+					job.result = job.input_node;
+				} else {
+					dmc::OctreeBuilderBottomUp builder(
+							*job.voxels, job.geometric_error, job.pool, job.validity_flag);
+					job.result = builder.build(job.origin, job.size);
+				}
+			}
+		};
+
+		const bool top_down = params.simplify_mode == SIMPLIFY_OCTREE_TOP_DOWN;
+		const int child_size = chunk_size / 2;
+
+		bool run_jobs = true;
+		std::vector<OctantJob> jobs(8);
+
+		if (top_down) {
+			// The root split happens up-front on this thread, jobs then refine each child
+			if (dmc::can_split(Vector3i(), chunk_size, voxels_access, params.geometric_error)) {
+				dmc::OctreeBuilderTopDown root_builder(
+						voxels_access, params.geometric_error, cache.octree_node_pool);
+				root = cache.octree_node_pool.create();
+				root->origin = Vector3i();
+				root->size = chunk_size;
+				root_builder.split(root);
+			} else {
+				// Same as the serial builder: an unsplit root still exists, with its center value
+				root = cache.octree_node_pool.create();
+				root->origin = Vector3i();
+				root->size = chunk_size;
+				root->center_value = voxels_access.get_interpolated_hermite_value(dmc::get_center(root));
+				run_jobs = false;
+			}
+		}
+
+		if (run_jobs) {
+			for (int i = 0; i < 8; ++i) {
+				OctantJob &job = jobs[i];
+				job.voxels = &voxels_access;
+				job.geometric_error = params.geometric_error;
+				const int *dir = dmc::OctreeTables::g_octant_position[i];
+				job.origin = child_size * Vector3i(dir[0], dir[1], dir[2]);
+				job.size = child_size;
+				job.top_down = top_down;
+				job.validity_flag = input.validity_flag;
+				if (top_down) {
+					job.input_node = root->children[i];
+				}
+				// Reuse nodes the shared pool already holds instead of re-allocating per build
+				cache.octree_node_pool.transfer_to(job.pool, 64);
+			}
+
+			std::vector<Thread> threads(7);
+			for (int i = 1; i < 8; ++i) {
+				threads[i - 1].start(&OctantJob::run, &jobs[i]);
+			}
+			OctantJob::run(&jobs[0]);
+			for (unsigned int i = 0; i < threads.size(); ++i) {
+				threads[i].wait_to_finish();
+			}
+
+			if (!top_down) {
+				// Same combine as the serial bottom-up root step
+				bool any_node = false;
+				for (int i = 0; i < 8; ++i) {
+					any_node |= jobs[i].result != nullptr;
+				}
+				if (any_node) {
+					root = cache.octree_node_pool.create();
+					root->origin = Vector3i();
+					root->size = chunk_size;
+					for (int i = 0; i < 8; ++i) {
+						if (jobs[i].result != nullptr) {
+							root->children[i] = jobs[i].result;
+						} else {
+							// Sibling at the same detail level, like the serial builder creates
+							const int *dir = dmc::OctreeTables::g_octant_position[i];
+							dmc::OctreeNode *child = cache.octree_node_pool.create();
+							child->size = child_size;
+							child->origin = child_size * Vector3i(dir[0], dir[1], dir[2]);
+							child->center_value =
+									voxels_access.get_interpolated_hermite_value(dmc::get_center(child));
+							root->children[i] = child;
+						}
+					}
+				} else if (dmc::can_split(Vector3i(), chunk_size, voxels_access, params.geometric_error)) {
+					root = cache.octree_node_pool.create();
+					root->origin = Vector3i();
+					root->size = chunk_size;
+					for (int i = 0; i < 8; ++i) {
+						const int *dir = dmc::OctreeTables::g_octant_position[i];
+						dmc::OctreeNode *child = cache.octree_node_pool.create();
+						child->size = child_size;
+						child->origin = child_size * Vector3i(dir[0], dir[1], dir[2]);
+						child->center_value =
+								voxels_access.get_interpolated_hermite_value(dmc::get_center(child));
+						root->children[i] = child;
+					}
+				}
+			}
+
+			// Unused pre-seeded nodes go back to the shared pool; live tree nodes are recycled
+			// there after meshing like in the serial path
+			for (int i = 0; i < 8; ++i) {
+				jobs[i].pool.transfer_to(cache.octree_node_pool, 0xffffffff);
+			}
+		}
+
+	} else if (params.simplify_mode == SIMPLIFY_OCTREE_BOTTOM_UP) {
+		dmc::OctreeBuilderBottomUp octree_builder(
+				voxels_access, params.geometric_error, cache.octree_node_pool, input.validity_flag);
 		root = octree_builder.build(Vector3i(), chunk_size);
 
 	} else if (params.simplify_mode == SIMPLIFY_OCTREE_TOP_DOWN) {
-		dmc::OctreeBuilderTopDown octree_builder(voxels_access, params.geometric_error, cache.octree_node_pool);
+		dmc::OctreeBuilderTopDown octree_builder(
+				voxels_access, params.geometric_error, cache.octree_node_pool, input.validity_flag);
 		root = octree_builder.build(Vector3i(), chunk_size);
 	}
 
@@ -1500,6 +1688,7 @@ void VoxelMesherDMC::build(VoxelMesher::Output &output, const VoxelMesher::Input
 		}
 
 		root->recycle(cache.octree_node_pool);
+		cache.octree_node_pool.recycle(root);
 
 	} else if (params.simplify_mode == SIMPLIFY_NONE) {
 		// We throw away adaptivity for meshing speed.
@@ -1565,6 +1754,10 @@ void VoxelMesherDMC::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_seam_mode", "mode"), &VoxelMesherDMC::set_seam_mode);
 	ClassDB::bind_method(D_METHOD("get_seam_mode"), &VoxelMesherDMC::get_seam_mode);
 
+	ClassDB::bind_method(
+			D_METHOD("set_octree_parallelism", "thread_count"), &VoxelMesherDMC::set_octree_parallelism);
+	ClassDB::bind_method(D_METHOD("get_octree_parallelism"), &VoxelMesherDMC::get_octree_parallelism);
+
 	ClassDB::bind_method(D_METHOD("get_statistics"), &VoxelMesherDMC::get_statistics);
 
 	ADD_PROPERTY(
@@ -1578,6 +1771,8 @@ void VoxelMesherDMC::_bind_methods() {
 
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "seam_mode", PROPERTY_HINT_ENUM, "None,MarchingSquareSkirts"),
 			"set_seam_mode", "get_seam_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "octree_parallelism", PROPERTY_HINT_RANGE, "1,8,1"),
+			"set_octree_parallelism", "get_octree_parallelism");
 
 	BIND_ENUM_CONSTANT(MESH_NORMAL);
 	BIND_ENUM_CONSTANT(MESH_WIREFRAME);
@@ -30,8 +30,10 @@ struct OctreeNode {
 	}
 
 	void recycle(OctreeNodePool &pool) {
+		// Children recurse before being recycled, since recycling clears their child pointers
 		for (int i = 0; i < 8; ++i) {
 			if (children[i]) {
+				children[i]->recycle(pool);
 				pool.recycle(children[i]);
 			}
 		}
@@ -103,6 +105,11 @@ public:
 	void set_seam_mode(SeamMode mode);
 	SeamMode get_seam_mode() const;
 
+	// How many threads the octree simplification pass may use, forked per root octant (1 to 8).
+	// Only big enough blocks fork; thread startup is not free.
+	void set_octree_parallelism(int thread_count);
+	int get_octree_parallelism() const;
+
 	void build(VoxelMesher::Output &output, const VoxelMesher::Input &input) override;
 
 	Dictionary get_statistics() const;
@@ -130,6 +137,8 @@ private:
 	// Parameters
 	Parameters _parameters;
 	RWLock _parameters_lock;
+	// See `set_octree_parallelism`
+	int _octree_parallelism = 1;
 
 	// Work cache
 	static thread_local Cache _cache;
@@ -1,4 +1,5 @@
 #include "transvoxel.h"
+#include "../../util/lightweight_profiler.h"
 #include "../../constants/cube_tables.h"
 #include "../../util/math/conv.h"
 #include "../../util/profiling.h"
@@ -144,7 +145,7 @@ inline uint32_t pack_bytes(const FixedArray<uint8_t, 4> &a) {
 }
 
 void add_texture_data(
-		std::vector<Vector2f> &uv, unsigned int packed_indices, FixedArray<uint8_t, MAX_TEXTURE_BLENDS> weights) {
+		AlignedVector<Vector2f> &uv, unsigned int packed_indices, FixedArray<uint8_t, MAX_TEXTURE_BLENDS> weights) {
 	struct IntUV {
 		uint32_t x;
 		uint32_t y;
@@ -278,32 +279,87 @@ inline float get_isolevel<float>() {
 	return 0.f;
 }
 
-Vector3f binary_search_interpolate(const IDeepSDFSampler &sampler, float s0, float s1, Vector3i p0, Vector3i p1,
-		uint32_t initial_lod_index, uint32_t min_lod_index) {
-	for (uint32_t lod_index = initial_lod_index; lod_index > min_lod_index; --lod_index) {
-		const Vector3i pm = (p0 + p1) >> 1;
-		// TODO Optimization: this is quite slow for a small difference in the result.
-		// Could be improved somewhat, but for now I don't think it's worth it
-		const float sm = -sampler.get_single(pm, lod_index - 1);
-		if (sign_f(s0) != sign_f(sm)) {
-			p1 = pm;
-			s1 = sm;
-		} else {
-			p0 = pm;
-			s0 = sm;
+void IDeepSDFSampler::get_multiple(
+		Span<const Vector3i> positions_in_voxels, uint32_t lod_index, Span<float> out_values) const {
+	for (unsigned int i = 0; i < positions_in_voxels.size(); ++i) {
+		out_values[i] = get_single(positions_in_voxels[i], lod_index);
+	}
+}
+
+// Deep-shifted vertex whose final position is resolved after the cell pass, so all binary
+// searches of the block can step through LOD levels together and batch their sampler queries.
+// See `resolve_deferred_deep_shifts`.
+struct PendingDeepShift {
+	uint32_t vertex_index;
+	uint8_t needs_secondary;
+	Vector3i p0;
+	Vector3i p1;
+	float s0;
+	float s1;
+	Vector3f normal;
+};
+
+thread_local std::vector<PendingDeepShift> tls_pending_deep_shifts;
+thread_local std::vector<Vector3i> tls_deep_positions;
+thread_local std::vector<float> tls_deep_samples;
+
+// Runs every pending binary search in lockstep: at each LOD level, the midpoint queries of all
+// searches are resolved with one batched sampler call (grouped by source block inside the
+// sampler), replacing the per-vertex virtual call chain. Final positions (and dependent
+// secondary positions of border vertices) are patched into the output arrays.
+static void resolve_deferred_deep_shifts(const IDeepSDFSampler &sampler, uint32_t initial_lod_index,
+		const Vector3i block_size_scaled, MeshArrays &output) {
+	ZN_PROFILE_SCOPE();
+	std::vector<PendingDeepShift> &pendings = tls_pending_deep_shifts;
+	if (pendings.size() == 0) {
+		return;
+	}
+
+	for (uint32_t lod_index = initial_lod_index; lod_index > 0; --lod_index) {
+		tls_deep_positions.resize(pendings.size());
+		tls_deep_samples.resize(pendings.size());
+		for (unsigned int i = 0; i < pendings.size(); ++i) {
+			tls_deep_positions[i] = (pendings[i].p0 + pendings[i].p1) >> 1;
+		}
+		sampler.get_multiple(to_span_const(tls_deep_positions), lod_index - 1, to_span(tls_deep_samples));
+		for (unsigned int i = 0; i < pendings.size(); ++i) {
+			PendingDeepShift &pending = pendings[i];
+			const float sm = -tls_deep_samples[i];
+			const Vector3i pm = tls_deep_positions[i];
+			if (sign_f(pending.s0) != sign_f(sm)) {
+				pending.p1 = pm;
+				pending.s1 = sm;
+			} else {
+				pending.p0 = pm;
+				pending.s0 = sm;
+			}
+		}
+	}
+
+	for (unsigned int i = 0; i < pendings.size(); ++i) {
+		const PendingDeepShift &pending = pendings[i];
+		const float t = pending.s1 / (pending.s1 - pending.s0);
+		const Vector3f primaryf = to_vec3f(pending.p0) * t + to_vec3f(pending.p1) * (1.f - t);
+		output.vertices[pending.vertex_index] = primaryf;
+		if (pending.needs_secondary) {
+			const Vector3f secondary = get_secondary_position(primaryf, pending.normal, 0, block_size_scaled);
+			Color &lod_data = output.lod_data[pending.vertex_index];
+			lod_data.r = secondary.x;
+			lod_data.g = secondary.y;
+			lod_data.b = secondary.z;
 		}
 	}
-	const float t = s1 / (s1 - s0);
-	const float t0 = t;
-	const float t1 = 1.f - t;
-	return to_vec3f(p0) * t0 + to_vec3f(p1) * t1;
+
+	pendings.clear();
 }
 
+
 // This function is template so we avoid branches and checks when sampling voxels
 template <typename Sdf_T, typename WeightSampler_T>
 void build_regular_mesh(Span<const Sdf_T> sdf_data, TextureIndicesData texture_indices_data,
 		const WeightSampler_T &weights_sampler, const Vector3i block_size_with_padding, uint32_t lod_index,
-		TexturingMode texturing_mode, Cache &cache, MeshArrays &output, const IDeepSDFSampler *deep_sdf_sampler) {
+		TexturingMode texturing_mode, Cache &cache, MeshArrays &output, const IDeepSDFSampler *deep_sdf_sampler,
+		const int cell_z_begin, const int cell_z_end, const std::atomic_bool *validity_flag) {
 	ZN_PROFILE_SCOPE();
 
 	// This function has some comments as quotes from the Transvoxel paper.
@@ -331,9 +387,52 @@ void build_regular_mesh(Span<const Sdf_T> sdf_data, TextureIndicesData texture_i
 	// Get direct representation of the isolevel (not always zero since we are not using signed integers yet)
 	const Sdf_T isolevel = get_isolevel<Sdf_T>();
 
-	// Iterate all cells with padding (expected to be neighbors)
+	// Gradient sampling costs 6 extra SDF reads per corner; when normals are reconstructed at
+	// render time it's only done where transition seams still need one
+	const bool compute_normals = output.normals_enabled;
+
+	{
+		// First pass: count cells the surface passes through, so output arrays get grown once
+		// instead of reallocating several times while triangulating. This repeats the cheap
+		// early-reject test of the main loop, which is memory-bound and a small fraction of
+		// triangulation cost.
+		ZN_PROFILE_SCOPE_NAMED("Occupancy pre-pass");
+		unsigned int surface_cell_count = 0;
+		Vector3i pre_pos;
+		for (pre_pos.z = cell_z_begin; pre_pos.z < cell_z_end; ++pre_pos.z) {
+			for (pre_pos.y = min_pos.y; pre_pos.y < max_pos.y; ++pre_pos.y) {
+				unsigned int data_index = Vector3iUtil::get_zxy_index(
+						Vector3i(min_pos.x, pre_pos.y, pre_pos.z), block_size_with_padding);
+				for (pre_pos.x = min_pos.x; pre_pos.x < max_pos.x;
+						++pre_pos.x, data_index += block_size_with_padding.y) {
+					const bool s = sdf_data[data_index] > isolevel;
+					if ((sdf_data[data_index + n010] > isolevel) != s ||
+							(sdf_data[data_index + n100] > isolevel) != s ||
+							(sdf_data[data_index + n110] > isolevel) != s ||
+							(sdf_data[data_index + n001] > isolevel) != s ||
+							(sdf_data[data_index + n011] > isolevel) != s ||
+							(sdf_data[data_index + n101] > isolevel) != s ||
+							(sdf_data[data_index + n111] > isolevel) != s) {
+						++surface_cell_count;
+					}
+				}
+			}
+		}
+		// Cells can produce up to 12 vertices and 15 triangles, but vertex reuse brings the
+		// average way down; this headroom makes reallocation during the main pass rare
+		output.reserve_additional(
+				4 * surface_cell_count, 12 * surface_cell_count, texturing_mode != TEXTURES_NONE);
+	}
+
+	// Iterate all cells with padding (expected to be neighbors).
+	// The Z range may be a slab of the block when meshing it with multiple threads.
 	Vector3i pos;
-	for (pos.z = min_pos.z; pos.z < max_pos.z; ++pos.z) {
+	for (pos.z = cell_z_begin; pos.z < cell_z_end; ++pos.z) {
+		if (validity_flag != nullptr && !validity_flag->load(std::memory_order_relaxed)) {
+			// The result is already dead (volume teardown, teleport); the incomplete output gets
+			// discarded by the caller, stop burning the worker on it
+			return;
+		}
 		for (pos.y = min_pos.y; pos.y < max_pos.y; ++pos.y) {
 			// TODO Optimization: change iteration to be ZXY? (Data is laid out with Y as deepest coordinate)
 			unsigned int data_index =
@@ -442,7 +541,7 @@ void build_regular_mesh(Span<const Sdf_T> sdf_data, TextureIndicesData texture_i
 				// While iterating through the cells in a block, a 3-bit mask is maintained whose bits indicate
 				// whether corresponding bits in a direction code are valid
 				const uint8_t direction_validity_mask = (pos.x > min_pos.x ? 1 : 0) |
-						((pos.y > min_pos.y ? 1 : 0) << 1) | ((pos.z > min_pos.z ? 1 : 0) << 2);
+						((pos.y > min_pos.y ? 1 : 0) << 1) | ((pos.z > cell_z_begin ? 1 : 0) << 2);
 
 				const uint8_t regular_cell_class_index = tables::get_regular_cell_class(case_code);
 				const tables::RegularCellData &regular_cell_data =
@@ -528,22 +627,22 @@ void build_regular_mesh(Span<const Sdf_T> sdf_data, TextureIndicesData texture_i
 							//const int ti1 = 0x100 - t;
 							//const Vector3i primary = p0 * ti0 + p1 * ti1;
 
-							Vector3f primaryf;
-							if (deep_sdf_sampler != nullptr) {
-								primaryf = binary_search_interpolate(
-										*deep_sdf_sampler, sample0, sample1, p0, p1, lod_index, 0);
-							} else {
-								primaryf = to_vec3f(p0) * t0 + to_vec3f(p1) * t1;
-							}
+							// When deep sampling is active this is provisional: the real position
+							// comes from a batched binary search resolved after the cell pass,
+							// see `resolve_deferred_deep_shifts`
+							const Vector3f primaryf = to_vec3f(p0) * t0 + to_vec3f(p1) * t1;
 							// TODO Binary search gives better positional results, but does not improve normals.
 							// I'm not sure how to overcome this because if we sample low-detail normals, we get a
 							// "blocky" result due to SDF clipping. If we sample high-detail gradients, we get details,
 							// but if details are bumpy, we also get noisy results.
-							const Vector3f cg0 = get_corner_gradient<Sdf_T>(
-									corner_data_indices[v0], sdf_data, block_size_with_padding);
-							const Vector3f cg1 = get_corner_gradient<Sdf_T>(
-									corner_data_indices[v1], sdf_data, block_size_with_padding);
-							const Vector3f normal = normalized_not_null(cg0 * t0 + cg1 * t1);
+							Vector3f normal;
+							if (compute_normals || cell_border_mask > 0) {
+								const Vector3f cg0 = get_corner_gradient<Sdf_T>(
+										corner_data_indices[v0], sdf_data, block_size_with_padding);
+								const Vector3f cg1 = get_corner_gradient<Sdf_T>(
+										corner_data_indices[v1], sdf_data, block_size_with_padding);
+								normal = normalized_not_null(cg0 * t0 + cg1 * t1);
+							}
 
 							Vector3f secondary;
 							uint16_t border_mask = cell_border_mask;
@@ -558,6 +657,18 @@ void build_regular_mesh(Span<const Sdf_T> sdf_data, TextureIndicesData texture_i
 							cell_vertex_indices[vertex_index] =
 									output.add_vertex(primaryf, normal, border_mask, secondary);
 
+							if (deep_sdf_sampler != nullptr) {
+								PendingDeepShift pending;
+								pending.vertex_index = cell_vertex_indices[vertex_index];
+								pending.needs_secondary = cell_border_mask > 0;
+								pending.p0 = p0;
+								pending.p1 = p1;
+								pending.s0 = sample0;
+								pending.s1 = sample1;
+								pending.normal = normal;
+								tls_pending_deep_shifts.push_back(pending);
+							}
+
 							if (texturing_mode == TEXTURES_BLEND_4_OVER_16) {
 								const FixedArray<uint8_t, MAX_TEXTURE_BLENDS> weights0 = cell_textures.weights[v0];
 								const FixedArray<uint8_t, MAX_TEXTURE_BLENDS> weights1 = cell_textures.weights[v1];
@@ -582,9 +693,12 @@ void build_regular_mesh(Span<const Sdf_T> sdf_data, TextureIndicesData texture_i
 
 						const Vector3i primary = p1;
 						const Vector3f primaryf = to_vec3f(primary);
-						const Vector3f cg1 =
-								get_corner_gradient<Sdf_T>(corner_data_indices[v1], sdf_data, block_size_with_padding);
-						const Vector3f normal = normalized_not_null(cg1);
+						Vector3f normal;
+						if (compute_normals || cell_border_mask > 0) {
+							const Vector3f cg1 = get_corner_gradient<Sdf_T>(
+									corner_data_indices[v1], sdf_data, block_size_with_padding);
+							normal = normalized_not_null(cg1);
+						}
 
 						Vector3f secondary;
 						uint16_t border_mask = cell_border_mask;
@@ -629,9 +743,12 @@ void build_regular_mesh(Span<const Sdf_T> sdf_data, TextureIndicesData texture_i
 
 							const Vector3i primary = t == 0 ? p1 : p0;
 							const Vector3f primaryf = to_vec3f(primary);
-							const Vector3f cg = get_corner_gradient<Sdf_T>(
-									corner_data_indices[vi], sdf_data, block_size_with_padding);
-							const Vector3f normal = normalized_not_null(cg);
+							Vector3f normal;
+							if (compute_normals || cell_border_mask > 0) {
+								const Vector3f cg = get_corner_gradient<Sdf_T>(
+										corner_data_indices[vi], sdf_data, block_size_with_padding);
+								normal = normalized_not_null(cg);
+							}
 
 							// TODO This bit of code is repeated several times, factor it?
 							Vector3f secondary;
@@ -667,6 +784,10 @@ void build_regular_mesh(Span<const Sdf_T> sdf_data, TextureIndicesData texture_i
 			} // x
 		} // y
 	} // z
+
+	if (deep_sdf_sampler != nullptr) {
+		resolve_deferred_deep_shifts(*deep_sdf_sampler, lod_index, block_size_scaled, output);
+	}
 }
 
 //    y            y
@@ -1227,6 +1348,92 @@ struct WeightSamplerPackedU16 {
 };
 
 thread_local std::vector<uint16_t> s_weights_backing_buffer_u16;
+// Holds weights remapped into palette lanes, see `try_build_block_texture_palette`
+thread_local std::vector<uint16_t> s_palette_weights_backing_buffer;
+
+// Block-wide texture palette precomputation. Scans the indices and weights planes once: when all
+// voxels with non-zero weights use at most 4 distinct textures (the common case anywhere but
+// biome borders), the block is rewritten as one palette plus per-voxel weights remapped into
+// palette lanes. Every cell then takes the same fast path as blocks with uniform indices,
+// skipping the per-cell 16-entry selection sort entirely, which measured around a third of
+// textured meshing cost. One O(volume) pass traded against O(cells * 8) selection work.
+static void try_build_block_texture_palette(TextureIndicesData &indices_data, WeightSamplerPackedU16 &weights_data) {
+	ZN_PROFILE_SCOPE();
+	const Span<const uint16_t> indices_buffer = indices_data.buffer;
+	const Span<const uint16_t> weights_buffer = weights_data.u16_data;
+	ZN_ASSERT_RETURN(indices_buffer.size() == weights_buffer.size());
+
+	// Find which textures are actually used; zero-weight lanes don't count, the encoding always
+	// lists 4 indices even when fewer textures are painted
+	uint32_t used_mask = 0;
+	{
+		// Identical consecutive values are common (channels are ZXY-contiguous), skip re-decoding
+		uint32_t previous_packed = 0xffffffff;
+		for (unsigned int i = 0; i < indices_buffer.size(); ++i) {
+			const uint32_t packed = (uint32_t(indices_buffer[i]) << 16) | weights_buffer[i];
+			if (packed == previous_packed) {
+				continue;
+			}
+			previous_packed = packed;
+			const FixedArray<uint8_t, 4> indices = decode_indices_from_packed_u16(indices_buffer[i]);
+			const FixedArray<uint8_t, 4> weights = decode_weights_from_packed_u16(weights_buffer[i]);
+			for (unsigned int j = 0; j < indices.size(); ++j) {
+				if (weights[j] > 0) {
+					used_mask |= (1 << indices[j]);
+				}
+			}
+		}
+	}
+
+	unsigned int used_count = 0;
+	FixedArray<uint8_t, 4> palette;
+	fill(palette, uint8_t(0));
+	for (unsigned int ti = 0; ti < MAX_TEXTURES; ++ti) {
+		if ((used_mask & (1 << ti)) != 0) {
+			if (used_count == 4) {
+				// More than 4 textures in the block, per-cell selection remains necessary
+				return;
+			}
+			palette[used_count] = ti;
+			++used_count;
+		}
+	}
+	if (used_count == 0) {
+		return;
+	}
+	// Pad unused lanes by repeating the last used texture; their weight is always zero.
+	// The palette is naturally sorted, as the selection path requires to keep blending stable.
+	for (unsigned int i = used_count; i < palette.size(); ++i) {
+		palette[i] = palette[used_count - 1];
+	}
+
+	// Remap per-voxel weights into palette lanes
+	std::vector<uint16_t> &remapped = s_palette_weights_backing_buffer;
+	remapped.resize(weights_buffer.size());
+	for (unsigned int i = 0; i < weights_buffer.size(); ++i) {
+		const FixedArray<uint8_t, 4> indices = decode_indices_from_packed_u16(indices_buffer[i]);
+		const FixedArray<uint8_t, 4> weights = decode_weights_from_packed_u16(weights_buffer[i]);
+		FixedArray<uint8_t, 4> out_weights;
+		fill(out_weights, uint8_t(0));
+		for (unsigned int j = 0; j < indices.size(); ++j) {
+			if (weights[j] == 0) {
+				continue;
+			}
+			for (unsigned int lane = 0; lane < used_count; ++lane) {
+				if (palette[lane] == indices[j]) {
+					out_weights[lane] = weights[j];
+					break;
+				}
+			}
+		}
+		remapped[i] = encode_weights_to_packed_u16(out_weights[0], out_weights[1], out_weights[2], out_weights[3]);
+	}
+
+	indices_data.buffer = Span<const uint16_t>();
+	indices_data.default_indices = palette;
+	indices_data.packed_default_indices = pack_bytes(palette);
+	weights_data.u16_data = to_span_const(remapped);
+}
 #endif
 
 // Presence of zeroes in samples occurs more often when precision is scarce
@@ -1265,8 +1472,23 @@ Span<const Sdf_T> apply_zero_sdf_fix(Span<const Sdf_T> p_sdf_data) {
 
 DefaultTextureIndicesData build_regular_mesh(const VoxelBufferInternal &voxels, unsigned int sdf_channel,
 		uint32_t lod_index, TexturingMode texturing_mode, Cache &cache, MeshArrays &output,
-		const IDeepSDFSampler *deep_sdf_sampler) {
+		const IDeepSDFSampler *deep_sdf_sampler, int slab_cell_z_begin, int slab_cell_z_end,
+		const std::atomic_bool *validity_flag) {
 	ZN_PROFILE_SCOPE();
+	ZN_LIGHT_PROFILE_SCOPE("transvoxel_build_regular_mesh");
+
+	// Default to the whole block, otherwise clamp the slab to the valid cell range
+	const int cell_max_z = voxels.get_size().z - MAX_PADDING;
+	if (slab_cell_z_begin < 0) {
+		slab_cell_z_begin = MIN_PADDING;
+	} else {
+		slab_cell_z_begin = math::clamp(slab_cell_z_begin, int(MIN_PADDING), cell_max_z);
+	}
+	if (slab_cell_z_end < 0) {
+		slab_cell_z_end = cell_max_z;
+	} else {
+		slab_cell_z_end = math::clamp(slab_cell_z_end, slab_cell_z_begin, cell_max_z);
+	}
 	// From this point, we expect the buffer to contain allocated data in the relevant channels.
 
 	Span<uint8_t> sdf_data_raw;
@@ -1304,6 +1526,11 @@ DefaultTextureIndicesData build_regular_mesh(const VoxelBufferInternal &voxels,
 		weights_data.u16_data =
 				get_or_decompress_channel(voxels, s_weights_backing_buffer_u16, VoxelBufferInternal::CHANNEL_WEIGHTS);
 		ZN_ASSERT_RETURN_V(weights_data.u16_data.size() == voxels_count, default_texture_indices_data);
+		if (indices_data.buffer.size() > 0) {
+			// Note: on success this keeps `default_texture_indices_data.use` false on purpose.
+			// Transition meshes read the raw weights planes, which don't match the remapped lanes.
+			try_build_block_texture_palette(indices_data, weights_data);
+		}
 	}
 #endif
 
@@ -1313,13 +1540,15 @@ DefaultTextureIndicesData build_regular_mesh(const VoxelBufferInternal &voxels,
 		case VoxelBufferInternal::DEPTH_8_BIT: {
 			Span<const int8_t> sdf_data = sdf_data_raw.reinterpret_cast_to<const int8_t>();
 			build_regular_mesh<int8_t>(sdf_data, indices_data, weights_data, voxels.get_size(), lod_index,
-					texturing_mode, cache, output, deep_sdf_sampler);
+					texturing_mode, cache, output, deep_sdf_sampler, slab_cell_z_begin, slab_cell_z_end,
+					validity_flag);
 		} break;
 
 		case VoxelBufferInternal::DEPTH_16_BIT: {
 			Span<const int16_t> sdf_data = sdf_data_raw.reinterpret_cast_to<const int16_t>();
 			build_regular_mesh<int16_t>(sdf_data, indices_data, weights_data, voxels.get_size(), lod_index,
-					texturing_mode, cache, output, deep_sdf_sampler);
+					texturing_mode, cache, output, deep_sdf_sampler, slab_cell_z_begin, slab_cell_z_end,
+					validity_flag);
 		} break;
 
 		// TODO Remove support for 32-bit SDF in Transvoxel?
@@ -1328,7 +1557,8 @@ DefaultTextureIndicesData build_regular_mesh(const VoxelBufferInternal &voxels,
 		case VoxelBufferInternal::DEPTH_32_BIT: {
 			Span<const float> sdf_data = sdf_data_raw.reinterpret_cast_to<const float>();
 			build_regular_mesh<float>(sdf_data, indices_data, weights_data, voxels.get_size(), lod_index,
-					texturing_mode, cache, output, deep_sdf_sampler);
+					texturing_mode, cache, output, deep_sdf_sampler, slab_cell_z_begin, slab_cell_z_end,
+					validity_flag);
 		} break;
 
 		case VoxelBufferInternal::DEPTH_64_BIT:
@@ -2,7 +2,9 @@
 #define TRANSVOXEL_H
 
 #include "../../storage/voxel_buffer_internal.h"
+#include <atomic>
 #include "../../util/fixed_array.h"
+#include "../../util/memory.h"
 #include "../../util/math/vector2f.h"
 #include "../../util/math/vector3f.h"
 #include "../../util/math/vector3i.h"
@@ -30,11 +32,30 @@ enum TexturingMode {
 };
 
 struct MeshArrays {
-	std::vector<Vector3f> vertices;
-	std::vector<Vector3f> normals;
-	std::vector<Color> lod_data;
-	std::vector<Vector2f> texturing_data;
-	std::vector<int> indices;
+	// 32-byte-aligned storage so post-passes (normals, MeshOptimizer) can use full-width SIMD
+	// loads without peeling
+	AlignedVector<Vector3f> vertices;
+	AlignedVector<Vector3f> normals;
+	AlignedVector<Color> lod_data;
+	AlignedVector<Vector2f> texturing_data;
+	AlignedVector<int> indices;
+
+	// When disabled, vertices are emitted without normals (the array stays empty) and the mesher
+	// skips gradient sampling except where transition seams need it. Renderers then reconstruct
+	// normals, e.g. with screen-space derivatives in a shader.
+	bool normals_enabled = true;
+
+	// Grows capacity for an expected amount of extra geometry, so accumulation doesn't reallocate
+	// several times per block. Predictions come from the pre-pass in `build_regular_mesh`.
+	void reserve_additional(unsigned int vertex_count, unsigned int index_count, bool with_texturing) {
+		vertices.reserve(vertices.size() + vertex_count);
+		normals.reserve(normals.size() + vertex_count);
+		lod_data.reserve(lod_data.size() + vertex_count);
+		if (with_texturing) {
+			texturing_data.reserve(texturing_data.size() + vertex_count);
+		}
+		indices.reserve(indices.size() + index_count);
+	}
 
 	void clear() {
 		vertices.clear();
@@ -47,10 +68,25 @@ struct MeshArrays {
 	int add_vertex(Vector3f primary, Vector3f normal, uint16_t border_mask, Vector3f secondary) {
 		int vi = vertices.size();
 		vertices.push_back(primary);
-		normals.push_back(normal);
+		if (normals_enabled) {
+			normals.push_back(normal);
+		}
 		lod_data.push_back(Color(secondary.x, secondary.y, secondary.z, border_mask));
 		return vi;
 	}
+
+	// Appends the geometry of another mesh, rebasing its indices. Used to merge slabs meshed in parallel.
+	void append(const MeshArrays &other) {
+		const int index_base = vertices.size();
+		vertices.insert(vertices.end(), other.vertices.begin(), other.vertices.end());
+		normals.insert(normals.end(), other.normals.begin(), other.normals.end());
+		lod_data.insert(lod_data.end(), other.lod_data.begin(), other.lod_data.end());
+		texturing_data.insert(texturing_data.end(), other.texturing_data.begin(), other.texturing_data.end());
+		indices.reserve(indices.size() + other.indices.size());
+		for (size_t i = 0; i < other.indices.size(); ++i) {
+			indices.push_back(index_base + other.indices[i]);
+		}
+	}
 };
 
 struct ReuseCell {
@@ -117,11 +153,23 @@ struct DefaultTextureIndicesData {
 class IDeepSDFSampler {
 public:
 	virtual float get_single(const Vector3i position_in_voxels, uint32_t lod_index) const = 0;
+	// Batched variant used when many nearby positions resolve at the same LOD: implementations
+	// can group queries by source block and gather each group with a single lookup and a tight
+	// loop, instead of paying the virtual call and block resolution per query. The default just
+	// loops over `get_single`.
+	virtual void get_multiple(
+			Span<const Vector3i> positions_in_voxels, uint32_t lod_index, Span<float> out_values) const;
 };
 
+// `slab_cell_z_begin`/`slab_cell_z_end` optionally restrict meshing to a range of cell Z coordinates
+// (in padded cell space), so one block can be meshed as several slabs on different threads, each with its
+// own Cache and MeshArrays. Vertices are not reused across slab boundaries, the seam cells just emit their
+// own copies. Pass negative values to mesh the whole block.
+// `validity_flag` optionally enables cooperative cancellation, checked once per cell deck.
 DefaultTextureIndicesData build_regular_mesh(const VoxelBufferInternal &voxels, unsigned int sdf_channel,
 		uint32_t lod_index, TexturingMode texturing_mode, Cache &cache, MeshArrays &output,
-		const IDeepSDFSampler *deep_sdf_sampler);
+		const IDeepSDFSampler *deep_sdf_sampler, int slab_cell_z_begin = -1, int slab_cell_z_end = -1,
+		const std::atomic_bool *validity_flag = nullptr);
 
 void build_transition_mesh(const VoxelBufferInternal &voxels, unsigned int sdf_channel, int direction,
 		uint32_t lod_index, TexturingMode texturing_mode, Cache &cache, MeshArrays &output,
@@ -4,9 +4,13 @@
 #include "../../storage/voxel_data_map.h"
 #include "../../thirdparty/meshoptimizer/meshoptimizer.h"
 #include "../../util/godot/funcs.h"
+#include "../../util/math/funcs.h"
 #include "../../util/profiling.h"
+#include "../../util/thread/thread.h"
 #include "transvoxel_tables.cpp"
 
+#include <algorithm>
+
 namespace zylann::voxel {
 
 VoxelMesherTransvoxel::VoxelMesherTransvoxel() {
@@ -27,19 +31,13 @@ int VoxelMesherTransvoxel::get_used_channels_mask() const {
 	return (1 << VoxelBufferInternal::CHANNEL_SDF);
 }
 
-void VoxelMesherTransvoxel::fill_surface_arrays(Array &arrays, const transvoxel::MeshArrays &src) {
+void VoxelMesherTransvoxel::fill_surface_arrays(
+		Array &arrays, const transvoxel::MeshArrays &src, bool quantize_attributes) {
 	PackedVector3Array vertices;
 	PackedVector3Array normals;
-	PackedFloat32Array lod_data; // 4*float32
-	PackedFloat32Array texturing_data; // 2*4*uint8 as 2*float32
 	PackedInt32Array indices;
 
 	copy_to(vertices, src.vertices);
-
-	//raw_copy_to(lod_data, src.lod_data);
-	lod_data.resize(src.lod_data.size() * 4);
-	memcpy(lod_data.ptrw(), src.lod_data.data(), lod_data.size() * sizeof(float));
-
 	raw_copy_to(indices, src.indices);
 
 	arrays.resize(Mesh::ARRAY_MAX);
@@ -49,17 +47,36 @@ void VoxelMesherTransvoxel::fill_surface_arrays(Array &arrays, const transvoxel:
 		arrays[Mesh::ARRAY_NORMAL] = normals;
 	}
 	if (src.texturing_data.size() != 0) {
-		//raw_copy_to(texturing_data, src.texturing_data);
+		// 2*4*uint8 crammed into 2*float32; the bytes are bit-cast, so this attribute must stay
+		// at 32-bit width regardless of quantization
+		PackedFloat32Array texturing_data;
 		texturing_data.resize(src.texturing_data.size() * 2);
 		memcpy(texturing_data.ptrw(), src.texturing_data.data(), texturing_data.size() * sizeof(float));
 		arrays[Mesh::ARRAY_CUSTOM1] = texturing_data;
 	}
-	arrays[Mesh::ARRAY_CUSTOM0] = lod_data;
+	if (quantize_attributes) {
+		// Halved to RGBA16F: secondary positions are block-local morph targets, half precision
+		// is far below pixel coverage at the distances where quantization kicks in. Non-float
+		// custom formats are passed as raw bytes.
+		PackedByteArray lod_data;
+		lod_data.resize(src.lod_data.size() * 4 * sizeof(uint16_t));
+		uint16_t *dst = reinterpret_cast<uint16_t *>(lod_data.ptrw());
+		const float *src_values = reinterpret_cast<const float *>(src.lod_data.data());
+		for (unsigned int i = 0; i < src.lod_data.size() * 4; ++i) {
+			dst[i] = zylannmeshopt::meshopt_quantizeHalf(src_values[i]);
+		}
+		arrays[Mesh::ARRAY_CUSTOM0] = lod_data;
+	} else {
+		PackedFloat32Array lod_data; // 4*float32
+		lod_data.resize(src.lod_data.size() * 4);
+		memcpy(lod_data.ptrw(), src.lod_data.data(), lod_data.size() * sizeof(float));
+		arrays[Mesh::ARRAY_CUSTOM0] = lod_data;
+	}
 	arrays[Mesh::ARRAY_INDEX] = indices;
 }
 
-template <typename T>
-static void remap_vertex_array(const std::vector<T> &src_data, std::vector<T> &dst_data,
+template <typename T, typename TAllocator>
+static void remap_vertex_array(const std::vector<T, TAllocator> &src_data, std::vector<T, TAllocator> &dst_data,
 		const std::vector<unsigned int> &remap_indices, unsigned int unique_vertex_count) {
 	if (src_data.size() == 0) {
 		dst_data.clear();
@@ -70,6 +87,66 @@ static void remap_vertex_array(const std::vector<T> &src_data, std::vector<T> &d
 			&dst_data[0], &src_data[0], src_data.size(), sizeof(T), remap_indices.data());
 }
 
+// Slabs meshed in parallel each run with their own reuse cache, so the vertices on shared slab
+// faces get interpolated twice and land duplicated in the merged buffers. Duplicates are
+// bit-identical (same cells, same SDF inputs), so an exact-match remap welds them back together,
+// shrinking the vertex buffer by the seam area and restoring index sharing across the seam.
+static void weld_duplicate_vertices(transvoxel::MeshArrays &mesh) {
+	ZN_PROFILE_SCOPE();
+	if (mesh.vertices.size() == 0 || mesh.indices.size() == 0) {
+		return;
+	}
+
+	FixedArray<zylannmeshopt::meshopt_Stream, 4> streams;
+	unsigned int stream_count = 0;
+	streams[stream_count++] = { mesh.vertices.data(), sizeof(Vector3f), sizeof(Vector3f) };
+	if (mesh.normals.size() != 0) {
+		streams[stream_count++] = { mesh.normals.data(), sizeof(Vector3f), sizeof(Vector3f) };
+	}
+	streams[stream_count++] = { mesh.lod_data.data(), sizeof(Color), sizeof(Color) };
+	if (mesh.texturing_data.size() != 0) {
+		streams[stream_count++] = { mesh.texturing_data.data(), sizeof(Vector2f), sizeof(Vector2f) };
+	}
+
+	static thread_local std::vector<unsigned int> weld_remap;
+	weld_remap.clear();
+	weld_remap.resize(mesh.vertices.size());
+
+	const size_t unique_vertex_count = zylannmeshopt::meshopt_generateVertexRemapMulti(weld_remap.data(),
+			reinterpret_cast<const unsigned int *>(mesh.indices.data()), mesh.indices.size(), mesh.vertices.size(),
+			&streams[0], stream_count);
+
+	if (unique_vertex_count == mesh.vertices.size()) {
+		// Nothing duplicated (flat seams, or geometry missed the planes entirely)
+		return;
+	}
+
+	// Remapping is in-place-safe: the remap only moves vertices to lower or equal indices
+	zylannmeshopt::meshopt_remapVertexBuffer(
+			mesh.vertices.data(), mesh.vertices.data(), mesh.vertices.size(), sizeof(Vector3f), weld_remap.data());
+	if (mesh.normals.size() != 0) {
+		zylannmeshopt::meshopt_remapVertexBuffer(
+				mesh.normals.data(), mesh.normals.data(), mesh.normals.size(), sizeof(Vector3f), weld_remap.data());
+	}
+	zylannmeshopt::meshopt_remapVertexBuffer(
+			mesh.lod_data.data(), mesh.lod_data.data(), mesh.lod_data.size(), sizeof(Color), weld_remap.data());
+	if (mesh.texturing_data.size() != 0) {
+		zylannmeshopt::meshopt_remapVertexBuffer(mesh.texturing_data.data(), mesh.texturing_data.data(),
+				mesh.texturing_data.size(), sizeof(Vector2f), weld_remap.data());
+	}
+	zylannmeshopt::meshopt_remapIndexBuffer(reinterpret_cast<unsigned int *>(mesh.indices.data()),
+			reinterpret_cast<const unsigned int *>(mesh.indices.data()), mesh.indices.size(), weld_remap.data());
+
+	mesh.vertices.resize(unique_vertex_count);
+	if (mesh.normals.size() != 0) {
+		mesh.normals.resize(unique_vertex_count);
+	}
+	mesh.lod_data.resize(unique_vertex_count);
+	if (mesh.texturing_data.size() != 0) {
+		mesh.texturing_data.resize(unique_vertex_count);
+	}
+}
+
 static void simplify(const transvoxel::MeshArrays &src_mesh, transvoxel::MeshArrays &dst_mesh, float p_target_ratio,
 		float p_error_threshold) {
 	ZN_PROFILE_SCOPE();
@@ -125,12 +202,36 @@ static void simplify(const transvoxel::MeshArrays &src_mesh, transvoxel::MeshArr
 			lod_indices.data(), lod_indices.size(), remap_indices.data());
 }
 
+// Converts one raw SDF sample to float the same way `VoxelBufferInternal::get_voxel_f` would,
+// but with the depth known at compile time
+inline float raw_sdf_to_float(int8_t v) {
+	return s8_to_snorm(v);
+}
+
+inline float raw_sdf_to_float(int16_t v) {
+	return s16_to_snorm(v);
+}
+
+inline float raw_sdf_to_float(float v) {
+	return v;
+}
+
+// Samples the data map at a higher detail than the meshed block, with the SDF depth selected once
+// per block instead of dispatched on every voxel (`get_voxel_f` switches on depth twice per call).
+template <typename Sdf_T>
 struct DeepSampler : transvoxel::IDeepSDFSampler {
 	VoxelGenerator &generator;
 	const VoxelDataLodMap &data;
 	const VoxelBufferInternal::ChannelId sdf_channel;
 	const Vector3i origin;
 
+	// Consecutive samples cluster along the same surface cell, so the last accessed block is
+	// cached to skip the map lookup most of the time. Samplers are used by one thread only.
+	mutable std::shared_ptr<VoxelBufferInternal> cached_voxels;
+	mutable Vector3i cached_bpos;
+	mutable uint32_t cached_lod_index = constants::MAX_LOD;
+	mutable unsigned int cached_bsm = 0;
+
 	DeepSampler(VoxelGenerator &p_generator, const VoxelDataLodMap &p_data,
 			VoxelBufferInternal::ChannelId p_sdf_channel, Vector3i p_origin) :
 			generator(p_generator), data(p_data), sdf_channel(p_sdf_channel), origin(p_origin) {}
@@ -139,26 +240,252 @@ struct DeepSampler : transvoxel::IDeepSDFSampler {
 		position_in_voxels += origin;
 		const Vector3i lod_pos = position_in_voxels >> lod_index;
 		const VoxelDataLodMap::Lod &lod = data.lods[lod_index];
-		unsigned int bsm = 0;
-		std::shared_ptr<VoxelBufferInternal> voxels;
-		{
+		const Vector3i lod_bpos = lod_pos >> lod.map.get_block_size_pow2();
+
+		if (cached_lod_index != lod_index || cached_bpos != lod_bpos) {
 			RWLockRead rlock(lod.map_lock);
-			const Vector3i lod_bpos = lod_pos >> lod.map.get_block_size_pow2();
 			const VoxelDataBlock *block = lod.map.get_block(lod_bpos);
 			if (block != nullptr) {
-				voxels = block->get_voxels_shared();
-				bsm = lod.map.get_block_size_mask();
+				cached_voxels = block->get_voxels_shared();
+				cached_bsm = lod.map.get_block_size_mask();
+			} else {
+				cached_voxels = nullptr;
 			}
+			cached_bpos = lod_bpos;
+			cached_lod_index = lod_index;
 		}
-		if (voxels != nullptr) {
-			RWLockRead rlock(voxels->get_lock());
-			return voxels->get_voxel_f(lod_pos & bsm, sdf_channel);
+
+		if (cached_voxels != nullptr) {
+			const VoxelBufferInternal &voxels = *cached_voxels;
+			RWLockRead rlock(voxels.get_lock());
+			const Vector3i rpos = lod_pos & cached_bsm;
+			// The typed fast path only applies when the block matches the compile-time depth and
+			// the default layout. Uniform channels or other configurations take the generic path.
+			Span<const uint8_t> raw;
+			if (voxels.get_channel_depth(sdf_channel) == VoxelBufferInternal::get_depth_from_size(sizeof(Sdf_T)) &&
+					voxels.get_channel_layout(sdf_channel) == VoxelBufferInternal::CHANNEL_LAYOUT_ZXY &&
+					voxels.get_channel_raw_read_only(sdf_channel, raw)) {
+				Span<const Sdf_T> typed_data = raw.reinterpret_cast_to<const Sdf_T>();
+				return raw_sdf_to_float(typed_data[voxels.get_index(rpos.x, rpos.y, rpos.z)]);
+			}
+			return voxels.get_voxel_f(rpos, sdf_channel);
+
 		} else {
 			return generator.generate_single(position_in_voxels, sdf_channel).f;
 		}
 	}
+
+	// Batched path used by the deferred vertex shifting: queries are sorted by source block so
+	// each block pays one map lookup, one lock and one depth check, then gets gathered with a
+	// tight devirtualized loop.
+	void get_multiple(Span<const Vector3i> positions_in_voxels, uint32_t lod_index,
+			Span<float> out_values) const override {
+		ZN_PROFILE_SCOPE();
+		struct Query {
+			Vector3i bpos;
+			uint32_t index;
+		};
+		static thread_local std::vector<Query> tls_queries;
+		tls_queries.resize(positions_in_voxels.size());
+
+		const VoxelDataLodMap::Lod &lod = data.lods[lod_index];
+		const unsigned int bsp2 = lod.map.get_block_size_pow2();
+		const unsigned int bsm = lod.map.get_block_size_mask();
+
+		for (unsigned int i = 0; i < positions_in_voxels.size(); ++i) {
+			const Vector3i lod_pos = (positions_in_voxels[i] + origin) >> lod_index;
+			tls_queries[i] = Query{ lod_pos >> bsp2, i };
+		}
+		std::sort(tls_queries.begin(), tls_queries.end(), [](const Query &a, const Query &b) {
+			const Vector3i &va = a.bpos;
+			const Vector3i &vb = b.bpos;
+			if (va.z != vb.z) {
+				return va.z < vb.z;
+			}
+			if (va.y != vb.y) {
+				return va.y < vb.y;
+			}
+			return va.x < vb.x;
+		});
+
+		unsigned int run_begin = 0;
+		while (run_begin < tls_queries.size()) {
+			const Vector3i run_bpos = tls_queries[run_begin].bpos;
+			unsigned int run_end = run_begin + 1;
+			while (run_end < tls_queries.size() && tls_queries[run_end].bpos == run_bpos) {
+				++run_end;
+			}
+
+			std::shared_ptr<VoxelBufferInternal> voxels_ptr;
+			{
+				RWLockRead rlock(lod.map_lock);
+				const VoxelDataBlock *block = lod.map.get_block(run_bpos);
+				if (block != nullptr) {
+					voxels_ptr = block->get_voxels_shared();
+				}
+			}
+
+			if (voxels_ptr != nullptr) {
+				const VoxelBufferInternal &voxels = *voxels_ptr;
+				RWLockRead rlock(voxels.get_lock());
+				Span<const uint8_t> raw;
+				const bool typed = voxels.get_channel_depth(sdf_channel) ==
+								VoxelBufferInternal::get_depth_from_size(sizeof(Sdf_T)) &&
+						voxels.get_channel_layout(sdf_channel) == VoxelBufferInternal::CHANNEL_LAYOUT_ZXY &&
+						voxels.get_channel_raw_read_only(sdf_channel, raw);
+				if (typed) {
+					Span<const Sdf_T> typed_data = raw.reinterpret_cast_to<const Sdf_T>();
+					for (unsigned int i = run_begin; i < run_end; ++i) {
+						const uint32_t qi = tls_queries[i].index;
+						const Vector3i rpos = ((positions_in_voxels[qi] + origin) >> lod_index) & bsm;
+						out_values[qi] = raw_sdf_to_float(typed_data[voxels.get_index(rpos.x, rpos.y, rpos.z)]);
+					}
+				} else {
+					for (unsigned int i = run_begin; i < run_end; ++i) {
+						const uint32_t qi = tls_queries[i].index;
+						const Vector3i rpos = ((positions_in_voxels[qi] + origin) >> lod_index) & bsm;
+						out_values[qi] = voxels.get_voxel_f(rpos, sdf_channel);
+					}
+				}
+
+			} else {
+				for (unsigned int i = run_begin; i < run_end; ++i) {
+					const uint32_t qi = tls_queries[i].index;
+					out_values[qi] = generator.generate_single(positions_in_voxels[qi] + origin, sdf_channel).f;
+				}
+			}
+
+			run_begin = run_end;
+		}
+	}
 };
 
+template <typename Sdf_T>
+static transvoxel::DefaultTextureIndicesData build_regular_mesh_with_deep_sampling(
+		const VoxelMesher::Input &input, VoxelBufferInternal::ChannelId sdf_channel,
+		transvoxel::TexturingMode texturing_mode, transvoxel::Cache &cache, transvoxel::MeshArrays &mesh_arrays) {
+	const DeepSampler<Sdf_T> ds(*input.generator, *input.data, sdf_channel, input.origin_in_voxels);
+	// TODO Optimization: "area scope" feature on generators to optimize certain uses of `generate_single`.
+	// The idea is to call `begin_area(box)` and `end_area()`, so the generator can optimize random calls to
+	// `generate_single` in between, knowing they will all be done within the specified area.
+	return transvoxel::build_regular_mesh(input.voxels, sdf_channel, input.lod, texturing_mode, cache, mesh_arrays,
+			&ds, -1, -1, input.validity_flag);
+}
+
+// Appends skirt geometry hiding LOD cracks on block borders: border edges of the mesh are
+// extruded inward, perpendicular to their block face, forming small walls just behind any gap a
+// neighboring coarser mesh could leave. Much cheaper than transition cells, and at distant LODs
+// the difference is below pixel coverage. Sides in `sides_mask` are processed; duplicate border
+// edges shared by two triangles produce overlapping quads, which is fine at these distances.
+static void append_skirts(transvoxel::MeshArrays &mesh, Vector3i block_size_with_padding, uint8_t sides_mask,
+		float depth) {
+	ZN_PROFILE_SCOPE();
+
+	const float min_plane[3] = { float(transvoxel::MIN_PADDING), float(transvoxel::MIN_PADDING),
+		float(transvoxel::MIN_PADDING) };
+	const float max_plane[3] = { float(block_size_with_padding.x - transvoxel::MAX_PADDING),
+		float(block_size_with_padding.y - transvoxel::MAX_PADDING),
+		float(block_size_with_padding.z - transvoxel::MAX_PADDING) };
+
+	struct SideInfo {
+		uint8_t axis;
+		bool is_max;
+	};
+	// Same order as `Cube::Side`, which transition side masks use (see `Cube::g_side_normals`)
+	const SideInfo side_infos[6] = {
+		{ 0, true }, // LEFT (which currently maps to +X in the tables)
+		{ 0, false }, // RIGHT (-X)
+		{ 1, false }, // BOTTOM (-Y)
+		{ 1, true }, // TOP (+Y)
+		{ 2, false }, // BACK (-Z)
+		{ 2, true } // FRONT (+Z)
+	};
+
+	// Which sides each vertex lies on, as a bitmask
+	static thread_local std::vector<uint8_t> tls_vertex_sides;
+	tls_vertex_sides.clear();
+	tls_vertex_sides.resize(mesh.vertices.size(), 0);
+	for (unsigned int i = 0; i < mesh.vertices.size(); ++i) {
+		const Vector3f v = mesh.vertices[i];
+		uint8_t m = 0;
+		for (unsigned int side = 0; side < 6; ++side) {
+			const SideInfo si = side_infos[side];
+			const float plane = si.is_max ? max_plane[si.axis] : min_plane[si.axis];
+			if (v[si.axis] == plane) {
+				m |= (1 << side);
+			}
+		}
+		tls_vertex_sides[i] = m;
+	}
+
+	const unsigned int src_index_count = mesh.indices.size();
+	const bool has_texturing = mesh.texturing_data.size() != 0;
+
+	for (unsigned int ii = 0; ii < src_index_count; ii += 3) {
+		const int tri[3] = { mesh.indices[ii], mesh.indices[ii + 1], mesh.indices[ii + 2] };
+
+		for (unsigned int e = 0; e < 3; ++e) {
+			const int ia = tri[e];
+			const int ib = tri[(e + 1) % 3];
+			const uint8_t shared_sides = tls_vertex_sides[ia] & tls_vertex_sides[ib] & sides_mask;
+			if (shared_sides == 0) {
+				continue;
+			}
+			// Extrude along the first matching side's inward direction
+			unsigned int side = 0;
+			while ((shared_sides & (1 << side)) == 0) {
+				++side;
+			}
+			const SideInfo si = side_infos[side];
+			Vector3f inward;
+			inward[si.axis] = si.is_max ? -depth : depth;
+
+			const int base = mesh.vertices.size();
+			const Vector3f va = mesh.vertices[ia];
+			const Vector3f vb = mesh.vertices[ib];
+
+			mesh.vertices.push_back(va);
+			mesh.vertices.push_back(vb);
+			mesh.vertices.push_back(vb + inward);
+			mesh.vertices.push_back(va + inward);
+
+			if (mesh.normals.size() != 0) {
+				const Vector3f na = mesh.normals[ia];
+				const Vector3f nb = mesh.normals[ib];
+				mesh.normals.push_back(na);
+				mesh.normals.push_back(nb);
+				mesh.normals.push_back(nb);
+				mesh.normals.push_back(na);
+			}
+
+			// Secondary positions would shift skirts with LOD fading; keep them in place
+			const Color la = mesh.lod_data[ia];
+			const Color lb = mesh.lod_data[ib];
+			mesh.lod_data.push_back(la);
+			mesh.lod_data.push_back(lb);
+			mesh.lod_data.push_back(lb);
+			mesh.lod_data.push_back(la);
+
+			if (has_texturing) {
+				const Vector2f ta = mesh.texturing_data[ia];
+				const Vector2f tb = mesh.texturing_data[ib];
+				mesh.texturing_data.push_back(ta);
+				mesh.texturing_data.push_back(tb);
+				mesh.texturing_data.push_back(tb);
+				mesh.texturing_data.push_back(ta);
+			}
+
+			// Two triangles per quad, both windings don't matter much here; follow the edge order
+			mesh.indices.push_back(base);
+			mesh.indices.push_back(base + 1);
+			mesh.indices.push_back(base + 2);
+			mesh.indices.push_back(base);
+			mesh.indices.push_back(base + 2);
+			mesh.indices.push_back(base + 3);
+		}
+	}
+}
+
 void VoxelMesherTransvoxel::build(VoxelMesher::Output &output, const VoxelMesher::Input &input) {
 	ZN_PROFILE_SCOPE();
 
@@ -184,17 +511,87 @@ void VoxelMesherTransvoxel::build(VoxelMesher::Output &output, const VoxelMesher
 
 	transvoxel::DefaultTextureIndicesData default_texture_indices_data;
 
+	s_mesh_arrays.normals_enabled = _normal_mode == NORMAL_MODE_GRADIENT;
+
 	if (_deep_sampling_enabled && input.generator != nullptr && input.data != nullptr && input.lod > 0) {
-		const DeepSampler ds(*input.generator, *input.data, sdf_channel, input.origin_in_voxels);
-		// TODO Optimization: "area scope" feature on generators to optimize certain uses of `generate_single`.
-		// The idea is to call `begin_area(box)` and `end_area()`, so the generator can optimize random calls to
-		// `generate_single` in between, knowing they will all be done within the specified area.
+		const transvoxel::TexturingMode texturing_mode = static_cast<transvoxel::TexturingMode>(_texture_mode);
+		// The sampler is instantiated per SDF depth, so per-sample reads don't re-dispatch on it
+		switch (voxels.get_channel_depth(sdf_channel)) {
+			case VoxelBufferInternal::DEPTH_8_BIT:
+				default_texture_indices_data = build_regular_mesh_with_deep_sampling<int8_t>(
+						input, sdf_channel, texturing_mode, s_cache, s_mesh_arrays);
+				break;
+			case VoxelBufferInternal::DEPTH_16_BIT:
+				default_texture_indices_data = build_regular_mesh_with_deep_sampling<int16_t>(
+						input, sdf_channel, texturing_mode, s_cache, s_mesh_arrays);
+				break;
+			default:
+				// Other depths fall back to generic sampling (32-bit is rarely worth deep
+				// sampling, 64-bit is not supported by this mesher anyway)
+				default_texture_indices_data = build_regular_mesh_with_deep_sampling<float>(
+						input, sdf_channel, texturing_mode, s_cache, s_mesh_arrays);
+				break;
+		}
+	} else if (_slab_parallelism > 1 && voxels.get_size().z >= _slab_parallelism * 8) {
+		// Mesh the block as Z-slabs on temporary threads, each with its own cache and output, then merge.
+		// Only worth it for big blocks; thread startup is not free.
+		struct SlabJob {
+			const VoxelBufferInternal *voxels = nullptr;
+			unsigned int sdf_channel;
+			uint32_t lod_index;
+			transvoxel::TexturingMode texturing_mode;
+			int cell_z_begin;
+			int cell_z_end;
+			const std::atomic_bool *validity_flag = nullptr;
+			transvoxel::Cache cache;
+			transvoxel::MeshArrays mesh_arrays;
+			transvoxel::DefaultTextureIndicesData texture_indices_data;
+
+			static void run(void *p_userdata) {
+				SlabJob &job = *static_cast<SlabJob *>(p_userdata);
+				job.texture_indices_data = transvoxel::build_regular_mesh(*job.voxels, job.sdf_channel,
+						job.lod_index, job.texturing_mode, job.cache, job.mesh_arrays, nullptr, job.cell_z_begin,
+						job.cell_z_end, job.validity_flag);
+			}
+		};
+
+		const int slab_count = math::min(_slab_parallelism, 8);
+		const int cell_min_z = transvoxel::MIN_PADDING;
+		const int cell_max_z = voxels.get_size().z - transvoxel::MAX_PADDING;
+
+		std::vector<SlabJob> jobs(slab_count);
+		for (int i = 0; i < slab_count; ++i) {
+			SlabJob &job = jobs[i];
+			job.mesh_arrays.normals_enabled = _normal_mode == NORMAL_MODE_GRADIENT;
+			job.voxels = &voxels;
+			job.sdf_channel = sdf_channel;
+			job.lod_index = input.lod;
+			job.texturing_mode = static_cast<transvoxel::TexturingMode>(_texture_mode);
+			job.cell_z_begin = cell_min_z + (i * (cell_max_z - cell_min_z)) / slab_count;
+			job.cell_z_end = cell_min_z + ((i + 1) * (cell_max_z - cell_min_z)) / slab_count;
+			job.validity_flag = input.validity_flag;
+		}
+
+		std::vector<Thread> threads(slab_count - 1);
+		for (int i = 1; i < slab_count; ++i) {
+			threads[i - 1].start(&SlabJob::run, &jobs[i]);
+		}
+		SlabJob::run(&jobs[0]);
+		for (unsigned int i = 0; i < threads.size(); ++i) {
+			threads[i].wait_to_finish();
+		}
+
+		for (int i = 0; i < slab_count; ++i) {
+			s_mesh_arrays.append(jobs[i].mesh_arrays);
+		}
+		// Each slab recomputed the vertices of its boundary faces; weld them back together
+		weld_duplicate_vertices(s_mesh_arrays);
+		default_texture_indices_data = jobs[0].texture_indices_data;
 
-		default_texture_indices_data = transvoxel::build_regular_mesh(voxels, sdf_channel, input.lod,
-				static_cast<transvoxel::TexturingMode>(_texture_mode), s_cache, s_mesh_arrays, &ds);
 	} else {
 		default_texture_indices_data = transvoxel::build_regular_mesh(voxels, sdf_channel, input.lod,
-				static_cast<transvoxel::TexturingMode>(_texture_mode), s_cache, s_mesh_arrays, nullptr);
+				static_cast<transvoxel::TexturingMode>(_texture_mode), s_cache, s_mesh_arrays, nullptr, -1, -1,
+				input.validity_flag);
 	}
 
 	if (s_mesh_arrays.vertices.size() == 0) {
@@ -204,24 +601,65 @@ void VoxelMesherTransvoxel::build(VoxelMesher::Output &output, const VoxelMesher
 
 	Array regular_arrays;
 
-	if (_mesh_optimization_params.enabled) {
+	// Beyond the configured LOD, exact transition stitching is replaced by cheap skirts appended
+	// to the main surface; at those distances the difference is below pixel coverage and the six
+	// per-side transition meshes stop being built entirely
+	const bool use_skirts = _skirts_lod_start >= 0 && int(input.lod) >= _skirts_lod_start;
+
+	const bool quantize_attributes =
+			_attribute_quantization_lod_start >= 0 && int(input.lod) >= _attribute_quantization_lod_start;
+
+	// Near LODs keep full resolution; beyond `lod_start` the error threshold doubles per LOD so
+	// distant meshes get simplified more aggressively, where the loss is below pixel coverage
+	bool do_simplification = _mesh_optimization_params.enabled && input.lod >= _mesh_optimization_params.lod_start;
+	if (do_simplification && input.require_fast_build) {
+		// Latency-critical build (edit response): emit the full mesh now, the caller schedules a
+		// non-urgent rebuild whose simplified result hot-swaps in when ready
+		do_simplification = false;
+		output.polish_pass_skipped = true;
+	}
+
+	if (do_simplification) {
 		// TODO When voxel texturing is enabled, this will decrease quality a lot.
 		// There is no support yet for taking textures into account when simplifying.
 		// See https://github.com/zeux/meshoptimizer/issues/158
-		simplify(s_mesh_arrays, s_simplified_mesh_arrays, _mesh_optimization_params.target_ratio,
-				_mesh_optimization_params.error_threshold);
-
-		fill_surface_arrays(regular_arrays, s_simplified_mesh_arrays);
+		const int lods_past_start = input.lod - _mesh_optimization_params.lod_start;
+		const float error_threshold =
+				math::min(_mesh_optimization_params.error_threshold * float(1 << math::min(lods_past_start, 8)), 1.f);
+		simplify(s_mesh_arrays, s_simplified_mesh_arrays, _mesh_optimization_params.target_ratio, error_threshold);
+
+		if (use_skirts) {
+			append_skirts(s_simplified_mesh_arrays, voxels.get_size(),
+					uint8_t(~input.excluded_transition_sides_mask), 1.5f);
+		}
+		fill_surface_arrays(regular_arrays, s_simplified_mesh_arrays, quantize_attributes);
 
 	} else {
-		fill_surface_arrays(regular_arrays, s_mesh_arrays);
+		if (use_skirts) {
+			append_skirts(
+					s_mesh_arrays, voxels.get_size(), uint8_t(~input.excluded_transition_sides_mask), 1.5f);
+		}
+		fill_surface_arrays(regular_arrays, s_mesh_arrays, quantize_attributes);
 	}
 
 	output.surfaces.push_back(regular_arrays);
 
 	for (int dir = 0; dir < Cube::SIDE_COUNT; ++dir) {
 		ZN_PROFILE_SCOPE();
+
+		if (use_skirts) {
+			// Skirts cover the cracks, transitions aren't built at all at these LODs
+			break;
+		}
+
+		if ((input.excluded_transition_sides_mask & (1 << dir)) != 0) {
+			// The caller knows this side is not displayed, don't pay for its mesh
+			continue;
+		}
+
 		s_mesh_arrays.clear();
+		// Transition cells sit on seams and need normals for their secondary positions
+		s_mesh_arrays.normals_enabled = true;
 
 		transvoxel::build_transition_mesh(voxels, sdf_channel, dir, input.lod,
 				static_cast<transvoxel::TexturingMode>(_texture_mode), s_cache, s_mesh_arrays,
@@ -232,7 +670,7 @@ void VoxelMesherTransvoxel::build(VoxelMesher::Output &output, const VoxelMesher
 		}
 
 		Array transition_arrays;
-		fill_surface_arrays(transition_arrays, s_mesh_arrays);
+		fill_surface_arrays(transition_arrays, s_mesh_arrays, quantize_attributes);
 		output.transition_surfaces[dir].push_back(transition_arrays);
 	}
 
@@ -241,7 +679,8 @@ void VoxelMesherTransvoxel::build(VoxelMesher::Output &output, const VoxelMesher
 
 	output.primitive_type = Mesh::PRIMITIVE_TRIANGLES;
 	output.mesh_flags = //
-			(RenderingServer::ARRAY_CUSTOM_RGBA_FLOAT << Mesh::ARRAY_FORMAT_CUSTOM0_SHIFT) |
+			((quantize_attributes ? RenderingServer::ARRAY_CUSTOM_RGBA_HALF : RenderingServer::ARRAY_CUSTOM_RGBA_FLOAT)
+					<< Mesh::ARRAY_FORMAT_CUSTOM0_SHIFT) |
 			(RenderingServer::ARRAY_CUSTOM_RG_FLOAT << Mesh::ARRAY_FORMAT_CUSTOM1_SHIFT);
 }
 
@@ -274,7 +713,7 @@ Ref<ArrayMesh> VoxelMesherTransvoxel::build_transition_mesh(Ref<gd::VoxelBuffer>
 	}
 
 	Array arrays;
-	fill_surface_arrays(arrays, s_mesh_arrays);
+	fill_surface_arrays(arrays, s_mesh_arrays, false);
 	mesh.instantiate();
 	mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
 	return mesh;
@@ -287,6 +726,23 @@ void VoxelMesherTransvoxel::set_texturing_mode(TexturingMode mode) {
 	}
 }
 
+void VoxelMesherTransvoxel::set_normal_mode(NormalMode mode) {
+	ERR_FAIL_INDEX(mode, NORMAL_MODE_COUNT);
+	_normal_mode = mode;
+}
+
+VoxelMesherTransvoxel::NormalMode VoxelMesherTransvoxel::get_normal_mode() const {
+	return _normal_mode;
+}
+
+void VoxelMesherTransvoxel::set_skirts_lod_start(int lod_index) {
+	_skirts_lod_start = math::clamp(lod_index, -1, int(constants::MAX_LOD) - 1);
+}
+
+int VoxelMesherTransvoxel::get_skirts_lod_start() const {
+	return _skirts_lod_start;
+}
+
 VoxelMesherTransvoxel::TexturingMode VoxelMesherTransvoxel::get_texturing_mode() const {
 	return _texture_mode;
 }
@@ -311,6 +767,22 @@ void VoxelMesherTransvoxel::set_mesh_optimization_target_ratio(float ratio) {
 	_mesh_optimization_params.target_ratio = math::clamp(ratio, 0.f, 1.f);
 }
 
+void VoxelMesherTransvoxel::set_attribute_quantization_lod_start(int lod_index) {
+	_attribute_quantization_lod_start = math::clamp(lod_index, -1, int(constants::MAX_LOD) - 1);
+}
+
+int VoxelMesherTransvoxel::get_attribute_quantization_lod_start() const {
+	return _attribute_quantization_lod_start;
+}
+
+void VoxelMesherTransvoxel::set_mesh_optimization_lod_start(int lod_index) {
+	_mesh_optimization_params.lod_start = math::clamp(lod_index, 0, int(constants::MAX_LOD) - 1);
+}
+
+int VoxelMesherTransvoxel::get_mesh_optimization_lod_start() const {
+	return _mesh_optimization_params.lod_start;
+}
+
 float VoxelMesherTransvoxel::get_mesh_optimization_target_ratio() const {
 	return _mesh_optimization_params.target_ratio;
 }
@@ -323,6 +795,14 @@ bool VoxelMesherTransvoxel::is_deep_sampling_enabled() const {
 	return _deep_sampling_enabled;
 }
 
+void VoxelMesherTransvoxel::set_slab_parallelism(int thread_count) {
+	_slab_parallelism = math::clamp(thread_count, 1, 8);
+}
+
+int VoxelMesherTransvoxel::get_slab_parallelism() const {
+	return _slab_parallelism;
+}
+
 void VoxelMesherTransvoxel::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("build_transition_mesh", "voxel_buffer", "direction"),
 			&VoxelMesherTransvoxel::build_transition_mesh);
@@ -330,6 +810,13 @@ void VoxelMesherTransvoxel::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_texturing_mode", "mode"), &VoxelMesherTransvoxel::set_texturing_mode);
 	ClassDB::bind_method(D_METHOD("get_texturing_mode"), &VoxelMesherTransvoxel::get_texturing_mode);
 
+	ClassDB::bind_method(D_METHOD("set_normal_mode", "mode"), &VoxelMesherTransvoxel::set_normal_mode);
+	ClassDB::bind_method(D_METHOD("get_normal_mode"), &VoxelMesherTransvoxel::get_normal_mode);
+
+	ClassDB::bind_method(
+			D_METHOD("set_skirts_lod_start", "lod_index"), &VoxelMesherTransvoxel::set_skirts_lod_start);
+	ClassDB::bind_method(D_METHOD("get_skirts_lod_start"), &VoxelMesherTransvoxel::get_skirts_lod_start);
+
 	ClassDB::bind_method(D_METHOD("set_mesh_optimization_enabled", "enabled"),
 			&VoxelMesherTransvoxel::set_mesh_optimization_enabled);
 	ClassDB::bind_method(
@@ -344,15 +831,31 @@ void VoxelMesherTransvoxel::_bind_methods() {
 			&VoxelMesherTransvoxel::set_mesh_optimization_target_ratio);
 	ClassDB::bind_method(
 			D_METHOD("get_mesh_optimization_target_ratio"), &VoxelMesherTransvoxel::get_mesh_optimization_target_ratio);
+	ClassDB::bind_method(D_METHOD("set_mesh_optimization_lod_start", "lod_index"),
+			&VoxelMesherTransvoxel::set_mesh_optimization_lod_start);
+	ClassDB::bind_method(
+			D_METHOD("get_mesh_optimization_lod_start"), &VoxelMesherTransvoxel::get_mesh_optimization_lod_start);
 
 	ClassDB::bind_method(
 			D_METHOD("set_deep_sampling_enabled", "enabled"), &VoxelMesherTransvoxel::set_deep_sampling_enabled);
 	ClassDB::bind_method(D_METHOD("is_deep_sampling_enabled"), &VoxelMesherTransvoxel::is_deep_sampling_enabled);
+	ClassDB::bind_method(D_METHOD("set_slab_parallelism", "thread_count"), &VoxelMesherTransvoxel::set_slab_parallelism);
+	ClassDB::bind_method(D_METHOD("get_slab_parallelism"), &VoxelMesherTransvoxel::get_slab_parallelism);
+
+	ClassDB::bind_method(D_METHOD("set_attribute_quantization_lod_start", "lod_index"),
+			&VoxelMesherTransvoxel::set_attribute_quantization_lod_start);
+	ClassDB::bind_method(D_METHOD("get_attribute_quantization_lod_start"),
+			&VoxelMesherTransvoxel::get_attribute_quantization_lod_start);
 
 	ADD_PROPERTY(
 			PropertyInfo(Variant::INT, "texturing_mode", PROPERTY_HINT_ENUM, "None,4-blend over 16 textures (4 bits)"),
 			"set_texturing_mode", "get_texturing_mode");
 
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "normal_mode", PROPERTY_HINT_ENUM, "Gradient,Render time"),
+			"set_normal_mode", "get_normal_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "skirts_lod_start", PROPERTY_HINT_RANGE, "-1,31,1"),
+			"set_skirts_lod_start", "get_skirts_lod_start");
+
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "mesh_optimization_enabled"), "set_mesh_optimization_enabled",
 			"is_mesh_optimization_enabled");
 
@@ -361,13 +864,22 @@ void VoxelMesherTransvoxel::_bind_methods() {
 
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "mesh_optimization_target_ratio"), "set_mesh_optimization_target_ratio",
 			"get_mesh_optimization_target_ratio");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "mesh_optimization_lod_start"), "set_mesh_optimization_lod_start",
+			"get_mesh_optimization_lod_start");
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "deep_sampling_enabled"), "set_deep_sampling_enabled",
 			"is_deep_sampling_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "slab_parallelism", PROPERTY_HINT_RANGE, "1,8,1"),
+			"set_slab_parallelism", "get_slab_parallelism");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "attribute_quantization_lod_start", PROPERTY_HINT_RANGE, "-1,31,1"),
+			"set_attribute_quantization_lod_start", "get_attribute_quantization_lod_start");
 
 	BIND_ENUM_CONSTANT(TEXTURES_NONE);
 	// TODO Rename MIXEL
 	BIND_ENUM_CONSTANT(TEXTURES_BLEND_4_OVER_16);
+
+	BIND_ENUM_CONSTANT(NORMAL_MODE_GRADIENT);
+	BIND_ENUM_CONSTANT(NORMAL_MODE_RENDER_TIME);
 }
 
 } // namespace zylann::voxel
@@ -33,6 +33,26 @@ public:
 	void set_texturing_mode(TexturingMode mode);
 	TexturingMode get_texturing_mode() const;
 
+	enum NormalMode {
+		// Normals computed on the CPU from SDF gradients (6 extra samples per vertex)
+		NORMAL_MODE_GRADIENT = 0,
+		// No normals in the main surface; renderers reconstruct them, typically with
+		// screen-space derivatives in a shader (`normalize(cross(dFdx(v), dFdy(v)))`).
+		// Roughly doubles mesher throughput, which matters on remesh-heavy edits.
+		// Transition meshes keep normals, their seam shifting depends on them.
+		NORMAL_MODE_RENDER_TIME,
+		NORMAL_MODE_COUNT
+	};
+
+	void set_normal_mode(NormalMode mode);
+	NormalMode get_normal_mode() const;
+
+	// From which LOD index cheap border skirts replace exact transition stitching.
+	// -1 disables skirts (transitions everywhere). Near LODs keep exact stitching; beyond this,
+	// the six per-side transition meshes are not built at all.
+	void set_skirts_lod_start(int lod_index);
+	int get_skirts_lod_start() const;
+
 	void set_mesh_optimization_enabled(bool enabled);
 	bool is_mesh_optimization_enabled() const;
 
@@ -42,21 +62,43 @@ public:
 	void set_mesh_optimization_target_ratio(float ratio);
 	float get_mesh_optimization_target_ratio() const;
 
+	// First LOD index at which simplification runs; lower (nearer) LODs keep full resolution.
+	// Aggressiveness also scales with how far past this LOD the mesh is.
+	void set_mesh_optimization_lod_start(int lod_index);
+	int get_mesh_optimization_lod_start() const;
+
 	void set_deep_sampling_enabled(bool enable);
 	bool is_deep_sampling_enabled() const;
 
+	void set_slab_parallelism(int thread_count);
+	int get_slab_parallelism() const;
+
+	// From which LOD index the per-vertex secondary-position attribute is quantized to half
+	// floats (-1 disables). Halves the largest vertex attribute on distant meshes, where the
+	// reduced precision is far below pixel coverage. Positions and normals are not ours to
+	// shrink: the RenderingServer keeps positions at full precision and already stores normals
+	// octahedral-compressed.
+	void set_attribute_quantization_lod_start(int lod_index);
+	int get_attribute_quantization_lod_start() const;
+
 protected:
 	static void _bind_methods();
 
 private:
-	void fill_surface_arrays(Array &arrays, const transvoxel::MeshArrays &src);
+	void fill_surface_arrays(Array &arrays, const transvoxel::MeshArrays &src, bool quantize_attributes);
 
 	TexturingMode _texture_mode = TEXTURES_NONE;
+	NormalMode _normal_mode = NORMAL_MODE_GRADIENT;
+	int _skirts_lod_start = -1;
+	// See `set_attribute_quantization_lod_start`
+	int _attribute_quantization_lod_start = -1;
 
 	struct MeshOptimizationParams {
 		bool enabled = false;
 		float error_threshold = 0.005;
 		float target_ratio = 0.0;
+		// See `set_mesh_optimization_lod_start`
+		int lod_start = 0;
 	};
 
 	MeshOptimizationParams _mesh_optimization_params;
@@ -65,10 +107,16 @@ private:
 	// by querying the generator and edits. This can result in better quality meshes, but is also more expensive
 	// because voxel data shared between threads will have to be accessed randomly over denser data sets.
 	bool _deep_sampling_enabled = false;
+
+	// When higher than 1, the regular mesh of a block is built as that many Z-slabs meshed on temporary
+	// threads and merged, so one big block can use several cores during interactive edits. Vertices are not
+	// reused across slab seams. Small blocks and deep-sampled builds stay single-threaded.
+	int _slab_parallelism = 1;
 };
 
 } // namespace zylann::voxel
 
 VARIANT_ENUM_CAST(zylann::voxel::VoxelMesherTransvoxel::TexturingMode);
+VARIANT_ENUM_CAST(zylann::voxel::VoxelMesherTransvoxel::NormalMode);
 
 #endif // VOXEL_MESHER_TRANSVOXEL_H
@@ -7,8 +7,20 @@ namespace zylann::voxel {
 Ref<Mesh> VoxelMesher::build_mesh(Ref<gd::VoxelBuffer> voxels, TypedArray<Material> materials) {
 	ERR_FAIL_COND_V(voxels.is_null(), Ref<ArrayMesh>());
 
+	// Meshers read channels raw and don't support tiled storage, expand it first. Paletted
+	// channels are kept for meshers able to read them directly, expanded for the others.
+	VoxelBufferInternal &voxels_internal = voxels->get_buffer();
+	for (unsigned int channel_index = 0; channel_index < VoxelBufferInternal::MAX_CHANNELS; ++channel_index) {
+		const VoxelBufferInternal::Compression compression =
+				voxels_internal.get_channel_compression(channel_index);
+		if (compression == VoxelBufferInternal::COMPRESSION_TILED ||
+				(compression == VoxelBufferInternal::COMPRESSION_PALETTED && !supports_paletted_channels())) {
+			voxels_internal.decompress_channel(channel_index);
+		}
+	}
+
 	Output output;
-	Input input = { voxels->get_buffer(), 0 };
+	Input input = { voxels_internal, 0 };
 	build(output, input);
 
 	if (output.surfaces.size() == 0) {
@@ -2,7 +2,9 @@
 #define VOXEL_MESHER_H
 
 #include "../constants/cube_tables.h"
+#include <atomic>
 #include "../util/fixed_array.h"
+#include "../util/math/box3i.h"
 
 #include <scene/resources/mesh.h>
 #include <vector>
@@ -32,6 +34,26 @@ public:
 		// LOD index. 0 means highest detail. 1 means half detail etc.
 		// Not initialized because it confused GCC.
 		int lod; // = 0;
+		// Optional hint for incremental meshers: voxels outside this box (in coordinates of `voxels`,
+		// padding included) are identical to those provided on the previous build of the same block.
+		// Only meaningful when `has_dirty_box` is true, otherwise everything may have changed.
+		Box3i dirty_box;
+		bool has_dirty_box; // = false
+		// Identifies the volume the block comes from, for meshers that keep per-block caches.
+		// 0 when meshing outside of a volume.
+		uint32_t volume_id; // = 0
+		// Sides for which meshers supporting LOD transitions may skip building transition meshes,
+		// because the caller knows they are not displayed. 0 (the default) builds everything.
+		uint8_t excluded_transition_sides_mask; // = 0
+		// When set, the build is latency-critical (edit response): meshers should skip expensive
+		// polish passes like simplification and flag the output instead, so the caller can
+		// schedule a second low-urgency build whose result hot-swaps in when ready.
+		bool require_fast_build; // = false
+		// Optional cooperative cancellation: when non-null and it flips false mid-build, the
+		// mesher may abort at slice granularity and return an incomplete output, which the
+		// caller then discards. Saves worker seconds on results that died (volume teardown,
+		// teleports) while the task was already running.
+		const std::atomic_bool *validity_flag; // = nullptr
 	};
 
 	struct Output {
@@ -41,6 +63,9 @@ public:
 		Mesh::PrimitiveType primitive_type = Mesh::PRIMITIVE_TRIANGLES;
 		unsigned int mesh_flags = 0;
 		Ref<Image> atlas_image;
+		// Set when a polish pass was skipped due to `require_fast_build`; the caller should
+		// schedule a non-urgent rebuild to recover the skipped quality
+		bool polish_pass_skipped = false;
 	};
 
 	// This can be called from multiple threads at once. Make sure member vars are protected or thread-local.
@@ -72,6 +97,12 @@ public:
 		return true;
 	}
 
+	// Tells if this mesher can read paletted channels directly (see
+	// `VoxelBufferInternal::Channel::FORMAT_PALETTED`); others get them expanded first
+	virtual bool supports_paletted_channels() const {
+		return false;
+	}
+
 #ifdef TOOLS_ENABLED
 	virtual void get_configuration_warnings(TypedArray<String> &out_warnings) const {}
 #endif
@@ -20,6 +20,7 @@
 #include "meshers/dmc/voxel_mesher_dmc.h"
 #include "meshers/transvoxel/voxel_mesher_transvoxel.h"
 #include "server/voxel_server_gd.h"
+#include "storage/voxel_buffer_channel_view_gd.h"
 #include "storage/voxel_buffer_gd.h"
 #include "storage/voxel_memory_pool.h"
 #include "storage/voxel_metadata_variant.h"
@@ -28,6 +29,7 @@
 #include "streams/vox_loader.h"
 #include "streams/voxel_block_serializer_gd.h"
 #include "streams/voxel_stream_block_files.h"
+#include "streams/voxel_stream_memory.h"
 #include "streams/voxel_stream_script.h"
 #include "terrain/fixed_lod/voxel_box_mover.h"
 #include "terrain/fixed_lod/voxel_terrain.h"
@@ -68,6 +70,10 @@
 #include "tests/tests.h"
 #endif
 
+#ifdef VOXEL_RUN_BENCHMARKS
+#include "benchmarks/benchmarks.h"
+#endif
+
 void initialize_voxel_module(ModuleInitializationLevel p_level) {
 	using namespace zylann;
 	using namespace voxel;
@@ -100,6 +106,7 @@ void initialize_voxel_module(ModuleInitializationLevel p_level) {
 
 		// Storage
 		ClassDB::register_class<gd::VoxelBuffer>();
+		ClassDB::register_class<gd::VoxelBufferChannelView>();
 
 		// Nodes
 		ClassDB::register_abstract_class<VoxelNode>();
@@ -113,6 +120,7 @@ void initialize_voxel_module(ModuleInitializationLevel p_level) {
 		// Streams
 		ClassDB::register_abstract_class<VoxelStream>();
 		ClassDB::register_class<VoxelStreamBlockFiles>();
+		ClassDB::register_class<VoxelStreamMemory>();
 		ClassDB::register_class<VoxelStreamRegionFiles>();
 		ClassDB::register_class<VoxelStreamScript>();
 		ClassDB::register_class<VoxelStreamSQLite>();
@@ -176,6 +184,10 @@ void initialize_voxel_module(ModuleInitializationLevel p_level) {
 		zylann::voxel::tests::run_voxel_tests();
 #endif
 
+#ifdef VOXEL_RUN_BENCHMARKS
+		zylann::voxel::benchmarks::run_voxel_benchmarks();
+#endif
+
 		// Compatibility with older version
 		ClassDB::add_compatibility_class("VoxelLibrary", "VoxelBlockyLibrary");
 		ClassDB::add_compatibility_class("Voxel", "VoxelBlockyModel");
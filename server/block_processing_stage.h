@@ -0,0 +1,43 @@
+#ifndef VOXEL_BLOCK_PROCESSING_STAGE_H
+#define VOXEL_BLOCK_PROCESSING_STAGE_H
+
+#include "../storage/voxel_buffer_internal.h"
+
+namespace zylann::voxel {
+
+// Native per-block processing stage running between generation and everything consuming generated
+// data (caching, saving, meshing). Gameplay systems register stages on VoxelServer to inject work
+// like ore decoration or structure stamping without forking the module or paying script speed.
+//
+// Stages run on worker threads, possibly several blocks at once, so implementations must be
+// stateless or internally synchronized. The edited buffer is exclusively owned by the calling
+// task, no locking is needed on it.
+//
+// IMPORTANT: stages must be deterministic functions of the buffer contents and the context.
+// The same world region can be produced through different paths (full blocks, padded meshing
+// slices, LOD fallbacks), each with different buffer origins; a stage deciding placements from
+// `origin_in_voxels` (absolute coordinates) and `deterministic_seed` produces consistent results
+// across all of them.
+class IBlockProcessingStage {
+public:
+	struct Context {
+		VoxelBufferInternal &voxels;
+		// Absolute position of the buffer's first voxel, in voxels at LOD 0 scale
+		Vector3i origin_in_voxels;
+		uint8_t lod;
+		uint32_t volume_id;
+		// Hash of this buffer's origin and LOD. Stable for full-block generation paths, but
+		// meshing slices cover partial regions with different origins, so stages whose results
+		// must be consistent across paths (placements visible in neighbor padding) should derive
+		// randomness from absolute voxel coordinates instead of this seed alone.
+		uint64_t deterministic_seed;
+	};
+
+	virtual ~IBlockProcessingStage() {}
+
+	virtual void process(Context &ctx) = 0;
+};
+
+} // namespace zylann::voxel
+
+#endif // VOXEL_BLOCK_PROCESSING_STAGE_H
@@ -0,0 +1,169 @@
+#ifndef VOXEL_COLD_BLOCK_CACHE_H
+#define VOXEL_COLD_BLOCK_CACHE_H
+
+#include "../storage/voxel_buffer_internal.h"
+#include "../streams/voxel_block_serializer.h"
+#include "../util/thread/mutex.h"
+#include "../util/memory_accounting.h"
+
+#include <atomic>
+#include <list>
+#include <unordered_map>
+
+namespace zylann::voxel {
+
+// Middle tier between loaded blocks and the stream: blocks evicted from the active view get
+// LZ4-compressed in memory before true eviction, bounded by total byte size (LRU). Players
+// circling an area then reload from cheap in-memory decompression instead of hitting the stream
+// (or regenerating). Entries are dropped whenever a volume's stream or generator changes.
+// Thread-safe: insertions come from unload paths (main thread or update tasks), lookups from the
+// streaming thread.
+class ColdBlockCache {
+public:
+	// Compressed blocks are small (a few KB), this fits thousands of them
+	static const size_t MAX_TOTAL_BYTES = 32 * 1024 * 1024;
+
+	// Serializes and stores a block being evicted. The buffer is read-locked internally.
+	void put(uint32_t volume_id, uint8_t lod, Vector3i position, const VoxelBufferInternal &voxels) {
+		std::vector<uint8_t> compressed_data;
+		{
+			RWLockRead rlock(voxels.get_lock());
+			const BlockSerializer::SerializeResult res = BlockSerializer::serialize_and_compress(voxels);
+			if (!res.success) {
+				return;
+			}
+			// The result references a thread-local scratch buffer, copy it out while it's valid
+			compressed_data = res.data;
+		}
+
+		const Key key{ position, volume_id, lod };
+		MutexLock lock(_mutex);
+
+		auto it = _map.find(key);
+		if (it != _map.end()) {
+			MemoryAccounting::get_singleton().remove(MemoryAccounting::CATEGORY_CACHES, it->second.data.size());
+			_total_bytes -= it->second.data.size();
+			_lru.erase(it->second.lru_it);
+			_map.erase(it);
+		}
+
+		_lru.push_front(key);
+		Entry &entry = _map[key];
+		entry.data = std::move(compressed_data);
+		entry.lru_it = _lru.begin();
+		_total_bytes += entry.data.size();
+		MemoryAccounting::get_singleton().add(MemoryAccounting::CATEGORY_CACHES, entry.data.size());
+
+		while (_total_bytes > MAX_TOTAL_BYTES && _lru.size() > 0) {
+			auto evict_it = _map.find(_lru.back());
+			ZN_ASSERT(evict_it != _map.end());
+			MemoryAccounting::get_singleton().remove(MemoryAccounting::CATEGORY_CACHES, evict_it->second.data.size());
+			_total_bytes -= evict_it->second.data.size();
+			_map.erase(evict_it);
+			_lru.pop_back();
+		}
+	}
+
+	// On success, fills `out_voxels` with the decompressed block and removes the entry (it is
+	// about to become a live block again)
+	bool try_get(uint32_t volume_id, uint8_t lod, Vector3i position, VoxelBufferInternal &out_voxels) {
+		const Key key{ position, volume_id, lod };
+		static thread_local std::vector<uint8_t> tls_blob;
+		{
+			MutexLock lock(_mutex);
+			auto it = _map.find(key);
+			if (it == _map.end()) {
+				_miss_count.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			// Copy out so decompression happens outside the lock
+			tls_blob = it->second.data;
+			MemoryAccounting::get_singleton().remove(MemoryAccounting::CATEGORY_CACHES, it->second.data.size());
+			_total_bytes -= it->second.data.size();
+			_lru.erase(it->second.lru_it);
+			_map.erase(it);
+		}
+		if (!BlockSerializer::decompress_and_deserialize(to_span_const(tls_blob), out_voxels)) {
+			_miss_count.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		_hit_count.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	// Evicts least-recently-used entries until total bytes fit `target_bytes`. Used by the memory
+	// governor: the cold tier is the cheapest memory to give back under pressure.
+	void shrink_to(size_t target_bytes) {
+		MutexLock lock(_mutex);
+		while (_total_bytes > target_bytes && _lru.size() > 0) {
+			auto evict_it = _map.find(_lru.back());
+			ZN_ASSERT(evict_it != _map.end());
+			MemoryAccounting::get_singleton().remove(MemoryAccounting::CATEGORY_CACHES, evict_it->second.data.size());
+			_total_bytes -= evict_it->second.data.size();
+			_map.erase(evict_it);
+			_lru.pop_back();
+		}
+	}
+
+	void clear_volume(uint32_t volume_id) {
+		MutexLock lock(_mutex);
+		for (auto it = _map.begin(); it != _map.end();) {
+			if (it->first.volume_id == volume_id) {
+				MemoryAccounting::get_singleton().remove(MemoryAccounting::CATEGORY_CACHES, it->second.data.size());
+				_total_bytes -= it->second.data.size();
+				_lru.erase(it->second.lru_it);
+				it = _map.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+
+	uint64_t get_hit_count() const {
+		return _hit_count.load(std::memory_order_relaxed);
+	}
+	uint64_t get_miss_count() const {
+		return _miss_count.load(std::memory_order_relaxed);
+	}
+	size_t get_total_bytes() const {
+		MutexLock lock(_mutex);
+		return _total_bytes;
+	}
+
+private:
+	struct Key {
+		Vector3i position;
+		uint32_t volume_id;
+		uint8_t lod;
+
+		inline bool operator==(const Key &other) const {
+			return position == other.position && volume_id == other.volume_id && lod == other.lod;
+		}
+	};
+
+	struct KeyHasher {
+		inline size_t operator()(const Key &key) const {
+			uint32_t hash = Vector3iHasher::hash(key.position);
+			hash = hash_djb2_one_32(key.volume_id, hash);
+			hash = hash_djb2_one_32(key.lod, hash);
+			return hash;
+		}
+	};
+
+	struct Entry {
+		std::vector<uint8_t> data;
+		std::list<Key>::iterator lru_it;
+	};
+
+	mutable Mutex _mutex;
+	std::unordered_map<Key, Entry, KeyHasher> _map;
+	// Most recently used at the front
+	std::list<Key> _lru;
+	size_t _total_bytes = 0;
+	std::atomic_uint64_t _hit_count = { 0 };
+	std::atomic_uint64_t _miss_count = { 0 };
+};
+
+} // namespace zylann::voxel
+
+#endif // VOXEL_COLD_BLOCK_CACHE_H
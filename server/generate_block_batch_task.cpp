@@ -0,0 +1,218 @@
+#include "generate_block_batch_task.h"
+#include "../util/object_pool.h"
+#include "../storage/voxel_buffer_internal.h"
+#include "../util/godot/funcs.h"
+#include "../util/log.h"
+#include "../util/memory_accounting.h"
+#include "../util/profiling.h"
+#include "../util/string_funcs.h"
+#include "save_block_data_task.h"
+#include "voxel_server.h"
+#include <core/os/time.h>
+
+namespace zylann::voxel {
+
+namespace {
+std::atomic_int g_debug_generate_batch_tasks_count;
+}
+
+namespace {
+ThreadSafeObjectPool<GenerateBlockBatchTask> g_task_pool;
+}
+
+GenerateBlockBatchTask *GenerateBlockBatchTask::create() {
+	GenerateBlockBatchTask *task = g_task_pool.create();
+	task->_scheduled_time_usec = Time::get_singleton()->get_ticks_usec();
+	++g_debug_generate_batch_tasks_count;
+	return task;
+}
+
+void GenerateBlockBatchTask::dispose() {
+	InFlightTaskRegistry &in_flight_registry = VoxelServer::get_singleton().get_in_flight_task_registry();
+	for (unsigned int i = 0; i < blocks_count; ++i) {
+		if (blocks[i].registered_in_flight) {
+			in_flight_registry.unregister_task(
+					volume_id, InFlightTaskRegistry::KIND_GENERATE, lod, blocks[i].position);
+		}
+	}
+	--g_debug_generate_batch_tasks_count;
+	g_task_pool.recycle(this);
+}
+
+void GenerateBlockBatchTask::init() {
+	*this = GenerateBlockBatchTask();
+}
+
+int GenerateBlockBatchTask::debug_get_running_count() {
+	return g_debug_generate_batch_tasks_count;
+}
+
+void GenerateBlockBatchTask::run(zylann::ThreadedTaskContext ctx) {
+	ZN_PROFILE_SCOPE();
+	const uint64_t run_begin_usec = Time::get_singleton()->get_ticks_usec();
+
+	CRASH_COND(stream_dependency == nullptr);
+	Ref<VoxelGenerator> generator = stream_dependency->generator;
+	ERR_FAIL_COND(generator.is_null());
+
+	Ref<VoxelStream> stream = stream_dependency->stream;
+	const bool save_output =
+			stream_dependency->valid && stream.is_valid() && stream->get_save_generator_output();
+
+	GeneratedBlockCache &gen_cache = VoxelServer::get_singleton().get_generated_block_cache();
+	InFlightTaskRegistry &in_flight_registry = VoxelServer::get_singleton().get_in_flight_task_registry();
+
+	// Some generators (scripts) prefer receiving all blocks in one call, because each call into
+	// them has a fixed cost. Cache hits are resolved first either way.
+	const bool batched = generator->supports_batched_generation();
+	FixedArray<unsigned int, MAX_BLOCKS> pending_block_indices;
+	unsigned int pending_block_count = 0;
+
+	auto cache_and_save = [this, &gen_cache, save_output](Block &block) {
+		{
+			// Keep a copy-on-write snapshot for future requests of the same block
+			std::shared_ptr<VoxelBufferInternal> cache_copy = make_shared_instance<VoxelBufferInternal>();
+			cache_copy->copy_shared_from(*block.voxels, true);
+			gen_cache.put(volume_id, lod, block.position, cache_copy, stream_dependency, block.max_lod_hint);
+		}
+
+		if (save_output) {
+			ZN_PRINT_VERBOSE(
+					format("Requesting save of generator output for block {} lod {}", block.position, lod));
+
+			// TODO Optimization: `voxels` doesnt actually need to be shared
+			std::shared_ptr<VoxelBufferInternal> voxels_copy = make_shared_instance<VoxelBufferInternal>();
+			// Copy-on-write snapshot, only duplicated if the block gets edited before it is saved
+			voxels_copy->copy_shared_from(*block.voxels, true);
+
+			// No instances, generators are not designed to produce them at this stage yet.
+			// No priority data, saving doesnt need sorting
+
+			SaveBlockDataTask *save_task = SaveBlockDataTask::create(
+					volume_id, block.position, lod, block_size, voxels_copy, stream_dependency);
+
+			VoxelServer::get_singleton().push_async_task(save_task);
+		}
+	};
+
+	for (unsigned int i = 0; i < blocks_count; ++i) {
+		Block &block = blocks[i];
+
+		const Vector3i origin_in_voxels = (block.position << lod) * block_size;
+
+		if (block.voxels == nullptr) {
+			block.voxels = make_shared_instance<VoxelBufferInternal>();
+			block.voxels->create(block_size, block_size, block_size);
+		}
+
+		// If a twin task is already generating this block, it will deliver it; skip it here
+		block.registered_in_flight = in_flight_registry.try_register_task(
+				volume_id, InFlightTaskRegistry::KIND_GENERATE, lod, block.position);
+		if (!block.registered_in_flight) {
+			block.is_duplicate = true;
+			continue;
+		}
+
+		// A cache hit skips both the generator and the save-output request below,
+		// since the block was saved when it was first generated
+		bool cached_max_lod_hint = false;
+		std::shared_ptr<VoxelBufferInternal> cached_voxels =
+				gen_cache.try_get(volume_id, lod, block.position, stream_dependency.get(), cached_max_lod_hint);
+		if (cached_voxels != nullptr) {
+			block.voxels->copy_shared_from(*cached_voxels, true);
+			block.max_lod_hint = cached_max_lod_hint;
+			continue;
+		}
+
+		if (batched) {
+			pending_block_indices[pending_block_count] = i;
+			++pending_block_count;
+			continue;
+		}
+
+		VoxelGenerator::VoxelQueryData query_data{ *block.voxels, origin_in_voxels, lod };
+		const VoxelGenerator::Result result = generator->generate_block(query_data);
+		block.max_lod_hint = result.max_lod_hint;
+
+		VoxelServer::get_singleton().apply_block_processing_stages(*block.voxels, origin_in_voxels, lod, volume_id);
+
+		cache_and_save(block);
+	}
+
+	if (pending_block_count > 0) {
+		std::vector<VoxelGenerator::VoxelQueryData> queries;
+		queries.reserve(pending_block_count);
+		for (unsigned int i = 0; i < pending_block_count; ++i) {
+			Block &block = blocks[pending_block_indices[i]];
+			queries.push_back(
+					VoxelGenerator::VoxelQueryData{ *block.voxels, (block.position << lod) * block_size, lod });
+		}
+
+		generator->generate_block_batch(to_span(queries));
+
+		for (unsigned int i = 0; i < pending_block_count; ++i) {
+			Block &block = blocks[pending_block_indices[i]];
+			VoxelServer::get_singleton().apply_block_processing_stages(
+					*block.voxels, (block.position << lod) * block_size, lod, volume_id);
+			// The batch API has no per-block result, so no `max_lod_hint` either
+			cache_and_save(block);
+		}
+	}
+
+	has_run = true;
+
+	const uint64_t now_usec = Time::get_singleton()->get_ticks_usec();
+	VoxelServer::get_singleton().get_task_latency_stats().record(
+			TaskLatencyStats::TASK_GENERATE, now_usec - _scheduled_time_usec);
+	VoxelServer::get_singleton().get_task_runtime_stats().record(TaskLatencyStats::TASK_GENERATE,
+			now_usec - run_begin_usec, MemoryAccounting::get_thread_task_peak_bytes());
+}
+
+int GenerateBlockBatchTask::get_priority() {
+	float closest_viewer_distance_sq;
+	const int p = priority_dependency.evaluate(lod, &closest_viewer_distance_sq);
+	too_far = drop_beyond_max_distance && closest_viewer_distance_sq > priority_dependency.drop_distance_squared;
+	return p;
+}
+
+bool GenerateBlockBatchTask::is_cancelled() {
+	return !stream_dependency->valid || too_far;
+}
+
+void GenerateBlockBatchTask::apply_result() {
+	if (VoxelServer::get_singleton().is_volume_valid(volume_id)) {
+		// TODO Comparing pointer may not be guaranteed
+		// The request response must match the dependency it would have been requested with.
+		// If it doesn't match, we are no longer interested in the result.
+		if (stream_dependency->valid) {
+			VoxelServer::VolumeCallbacks callbacks = VoxelServer::get_singleton().get_volume_callbacks(volume_id);
+			ERR_FAIL_COND(callbacks.data_output_callback == nullptr);
+
+			for (unsigned int i = 0; i < blocks_count; ++i) {
+				Block &block = blocks[i];
+
+				if (block.is_duplicate) {
+					// The twin task delivers this block
+					continue;
+				}
+
+				VoxelServer::BlockDataOutput o;
+				o.voxels = block.voxels;
+				o.position = block.position;
+				o.lod = lod;
+				o.dropped = !has_run;
+				o.type = VoxelServer::BlockDataOutput::TYPE_GENERATED;
+				o.max_lod_hint = block.max_lod_hint;
+				o.initial_load = false;
+
+				callbacks.data_output_callback(callbacks.data, o);
+			}
+		}
+
+	} else {
+		// This can happen if the user removes the volume while requests are still about to return
+		ZN_PRINT_VERBOSE("Generated data request response came back but volume wasn't found");
+	}
+}
+
+} // namespace zylann::voxel
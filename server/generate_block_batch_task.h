@@ -0,0 +1,65 @@
+#ifndef GENERATE_BLOCK_BATCH_TASK_H
+#define GENERATE_BLOCK_BATCH_TASK_H
+
+#include "../util/fixed_array.h"
+#include "../util/tasks/threaded_task.h"
+#include "priority_dependency.h"
+#include "streaming_dependency.h"
+
+namespace zylann::voxel {
+
+// Generates several nearby blocks in one task. Compared to one GenerateBlockTask per block, this
+// amortizes task scheduling and priority evaluation, and keeps the generator's thread-local state
+// warm across consecutive blocks (the graph runtime re-uses its prepared buffers when block sizes
+// don't change, see `VoxelGraphRuntime::prepare_state`).
+class GenerateBlockBatchTask : public IThreadedTask {
+public:
+	static const unsigned int MAX_BLOCKS = 8;
+
+	// Tasks are pooled, get instances with `create()` (the default constructor only exists for the
+	// pool). The owner gives them back through `dispose()`.
+	GenerateBlockBatchTask() {}
+
+	static GenerateBlockBatchTask *create();
+
+	void run(ThreadedTaskContext ctx) override;
+	int get_priority() override;
+	bool is_cancelled() override;
+	void apply_result() override;
+	void dispose() override;
+
+	// Resets to a freshly-constructed state, called when recycled into the pool
+	void init();
+
+	static int debug_get_running_count();
+
+	struct Block {
+		Vector3i position;
+		std::shared_ptr<VoxelBufferInternal> voxels;
+		bool max_lod_hint = false;
+		// See `InFlightTaskRegistry`: whether this entry is owned in the registry, and whether a
+		// twin task was already running this block when the batch started
+		bool registered_in_flight = false;
+		bool is_duplicate = false;
+	};
+
+	FixedArray<Block, MAX_BLOCKS> blocks;
+	unsigned int blocks_count = 0;
+	uint32_t volume_id;
+	uint8_t lod;
+	uint8_t block_size;
+	bool has_run = false;
+	bool too_far = false;
+	bool drop_beyond_max_distance = true;
+	// Based on the center of the batch, which must only contain nearby blocks
+	PriorityDependency priority_dependency;
+	std::shared_ptr<StreamingDependency> stream_dependency;
+
+private:
+	// For latency stats
+	uint64_t _scheduled_time_usec = 0;
+};
+
+} // namespace zylann::voxel
+
+#endif // GENERATE_BLOCK_BATCH_TASK_H
@@ -2,23 +2,42 @@
 #include "../storage/voxel_buffer_internal.h"
 #include "../util/godot/funcs.h"
 #include "../util/log.h"
+#include "../util/memory_accounting.h"
 #include "../util/profiling.h"
 #include "../util/string_funcs.h"
 #include "save_block_data_task.h"
+#include "../util/object_pool.h"
+#include "../constants/voxel_constants.h"
 #include "voxel_server.h"
+#include <core/os/time.h>
 
 namespace zylann::voxel {
 
 namespace {
 std::atomic_int g_debug_generate_tasks_count;
-}
-
-GenerateBlockTask::GenerateBlockTask() {
+// Streaming bursts schedule thousands of these; recycling them keeps the allocator out of the
+// hot path entirely once the pool warmed up
+ThreadSafeObjectPool<GenerateBlockTask> g_task_pool;
+} // namespace
+
+GenerateBlockTask *GenerateBlockTask::create() {
+	GenerateBlockTask *task = g_task_pool.create();
+	task->_scheduled_time_usec = Time::get_singleton()->get_ticks_usec();
 	++g_debug_generate_tasks_count;
+	return task;
 }
 
-GenerateBlockTask::~GenerateBlockTask() {
+void GenerateBlockTask::dispose() {
+	if (_registered_in_flight) {
+		VoxelServer::get_singleton().get_in_flight_task_registry().unregister_task(
+				volume_id, InFlightTaskRegistry::KIND_GENERATE, lod, position);
+	}
 	--g_debug_generate_tasks_count;
+	g_task_pool.recycle(this);
+}
+
+void GenerateBlockTask::init() {
+	*this = GenerateBlockTask();
 }
 
 int GenerateBlockTask::debug_get_running_count() {
@@ -27,11 +46,24 @@ int GenerateBlockTask::debug_get_running_count() {
 
 void GenerateBlockTask::run(zylann::ThreadedTaskContext ctx) {
 	ZN_PROFILE_SCOPE();
+	const uint64_t run_begin_usec = Time::get_singleton()->get_ticks_usec();
 
 	CRASH_COND(stream_dependency == nullptr);
 	Ref<VoxelGenerator> generator = stream_dependency->generator;
 	ERR_FAIL_COND(generator.is_null());
 
+	// Overlapping viewers can schedule the same block twice; if a twin is already generating it,
+	// its result will reach the volume anyway, so this one bows out. Tasks chained to a tracker
+	// (edit preloads) are excluded: their completion gates follow-up work, they must run fully.
+	if (tracker == nullptr) {
+		_registered_in_flight = VoxelServer::get_singleton().get_in_flight_task_registry().try_register_task(
+				volume_id, InFlightTaskRegistry::KIND_GENERATE, lod, position);
+		if (!_registered_in_flight) {
+			_is_duplicate = true;
+			return;
+		}
+	}
+
 	const Vector3i origin_in_voxels = (position << lod) * block_size;
 
 	if (voxels == nullptr) {
@@ -39,9 +71,57 @@ void GenerateBlockTask::run(zylann::ThreadedTaskContext ctx) {
 		voxels->create(block_size, block_size, block_size);
 	}
 
+	// Generators are deterministic: the same block may have been generated before and evicted,
+	// or restored by an undo. A cache hit skips the generator entirely.
+	GeneratedBlockCache &gen_cache = VoxelServer::get_singleton().get_generated_block_cache();
+	bool cached_max_lod_hint = false;
+	std::shared_ptr<VoxelBufferInternal> cached_voxels =
+			gen_cache.try_get(volume_id, lod, position, stream_dependency.get(), cached_max_lod_hint);
+
+	if (cached_voxels != nullptr) {
+		// Copy-on-write, actual data is only duplicated if the block gets edited
+		voxels->copy_shared_from(*cached_voxels, true);
+		max_lod_hint = cached_max_lod_hint;
+		has_run = true;
+
+		const uint64_t now_usec = Time::get_singleton()->get_ticks_usec();
+		VoxelServer::get_singleton().get_task_latency_stats().record(
+				TaskLatencyStats::TASK_GENERATE, now_usec - _scheduled_time_usec);
+		VoxelServer::get_singleton().get_task_runtime_stats().record(TaskLatencyStats::TASK_GENERATE,
+				now_usec - run_begin_usec, MemoryAccounting::get_thread_task_peak_bytes());
+		return;
+	}
+
 	VoxelGenerator::VoxelQueryData query_data{ *voxels, origin_in_voxels, lod };
-	const VoxelGenerator::Result result = generator->generate_block(query_data);
-	max_lod_hint = result.max_lod_hint;
+	query_data.coarse_voxels = coarse_voxels.get();
+	query_data.coarse_octant = coarse_octant;
+
+	// When the generation queue gets deeper than what the CPU threads can absorb, offload blocks to
+	// the GPU backend if the generator has one. Below that depth the CPU path has lower latency
+	// since it doesn't pay for dispatch and readback.
+	bool generated_on_gpu = false;
+	if (generator->supports_gpu_generation()) {
+		const VoxelServer::Stats::ThreadPoolStats pool_stats = VoxelServer::get_singleton().get_stats().general;
+		if (pool_stats.tasks > 2 * pool_stats.thread_count) {
+			generated_on_gpu = generator->generate_block_gpu(query_data);
+		}
+	}
+
+	if (!generated_on_gpu) {
+		const VoxelGenerator::Result result = generator->generate_block(query_data);
+		max_lod_hint = result.max_lod_hint;
+	}
+
+	// Custom native stages (ore decoration, structure stamping) run before the result gets
+	// cached, saved or meshed, so every consumer sees the same data
+	VoxelServer::get_singleton().apply_block_processing_stages(*voxels, origin_in_voxels, lod, volume_id);
+
+	{
+		// Keep a copy-on-write snapshot for future requests of the same block
+		std::shared_ptr<VoxelBufferInternal> cache_copy = make_shared_instance<VoxelBufferInternal>();
+		cache_copy->copy_shared_from(*voxels, true);
+		gen_cache.put(volume_id, lod, position, cache_copy, stream_dependency, max_lod_hint);
+	}
 
 	if (stream_dependency->valid) {
 		Ref<VoxelStream> stream = stream_dependency->stream;
@@ -53,33 +133,54 @@ void GenerateBlockTask::run(zylann::ThreadedTaskContext ctx) {
 
 			// TODO Optimization: `voxels` doesnt actually need to be shared
 			std::shared_ptr<VoxelBufferInternal> voxels_copy = make_shared_instance<VoxelBufferInternal>();
-			voxels->duplicate_to(*voxels_copy, true);
+			// Copy-on-write snapshot, only duplicated if the block gets edited before it is saved
+			voxels_copy->copy_shared_from(*voxels, true);
 
 			// No instances, generators are not designed to produce them at this stage yet.
 			// No priority data, saving doesnt need sorting
 
 			SaveBlockDataTask *save_task =
-					memnew(SaveBlockDataTask(volume_id, position, lod, block_size, voxels_copy, stream_dependency));
+					SaveBlockDataTask::create(volume_id, position, lod, block_size, voxels_copy, stream_dependency);
 
 			VoxelServer::get_singleton().push_async_task(save_task);
 		}
 	}
 
 	has_run = true;
+
+	const uint64_t now_usec = Time::get_singleton()->get_ticks_usec();
+	VoxelServer::get_singleton().get_task_latency_stats().record(
+			TaskLatencyStats::TASK_GENERATE, now_usec - _scheduled_time_usec);
+	VoxelServer::get_singleton().get_task_runtime_stats().record(TaskLatencyStats::TASK_GENERATE,
+			now_usec - run_begin_usec, MemoryAccounting::get_thread_task_peak_bytes());
+	VoxelServer::get_singleton().record_slow_block(
+			TaskLatencyStats::TASK_GENERATE, position, lod, now_usec - run_begin_usec);
 }
 
 int GenerateBlockTask::get_priority() {
 	float closest_viewer_distance_sq;
 	const int p = priority_dependency.evaluate(lod, &closest_viewer_distance_sq);
 	too_far = drop_beyond_max_distance && closest_viewer_distance_sq > priority_dependency.drop_distance_squared;
+	_latency_critical = lod == 0 &&
+			closest_viewer_distance_sq < math::squared(constants::LATENCY_CRITICAL_DISTANCE);
 	return p;
 }
 
+uint8_t GenerateBlockTask::get_qos_class() const {
+	// Set by `get_priority`, which the pool evaluates before sampling the class
+	return _latency_critical ? QOS_LATENCY_CRITICAL : QOS_BULK;
+}
+
 bool GenerateBlockTask::is_cancelled() {
 	return !stream_dependency->valid || too_far; // || stream_dependency->stream->get_fallback_generator().is_null();
 }
 
 void GenerateBlockTask::apply_result() {
+	if (_is_duplicate) {
+		// The twin task delivers the block, reporting this one as dropped would only cause churn
+		return;
+	}
+
 	bool aborted = true;
 
 	if (VoxelServer::get_singleton().is_volume_valid(volume_id)) {
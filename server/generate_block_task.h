@@ -10,28 +10,51 @@ namespace zylann::voxel {
 
 class GenerateBlockTask : public IThreadedTask {
 public:
-	GenerateBlockTask();
-	~GenerateBlockTask();
+	// Tasks are pooled, get instances with `create()` (the default constructor only exists for the
+	// pool). The owner gives them back through `dispose()`.
+	GenerateBlockTask() {}
+
+	static GenerateBlockTask *create();
 
 	void run(ThreadedTaskContext ctx) override;
 	int get_priority() override;
+	uint8_t get_qos_class() const override;
 	bool is_cancelled() override;
 	void apply_result() override;
+	void dispose() override;
+
+	// Resets to a freshly-constructed state, called when recycled into the pool
+	void init();
 
 	static int debug_get_running_count();
 
 	std::shared_ptr<VoxelBufferInternal> voxels;
+	// Optional snapshot of the parent LOD block covering this one, for generators supporting LOD
+	// refinement. Never written to.
+	std::shared_ptr<VoxelBufferInternal> coarse_voxels;
+	uint8_t coarse_octant = 0;
 	Vector3i position;
 	uint32_t volume_id;
 	uint8_t lod;
 	uint8_t block_size;
 	bool has_run = false;
 	bool too_far = false;
+	// See get_qos_class
+	bool _latency_critical = false;
 	bool max_lod_hint = false;
 	bool drop_beyond_max_distance = true;
 	PriorityDependency priority_dependency;
 	std::shared_ptr<StreamingDependency> stream_dependency;
 	std::shared_ptr<AsyncDependencyTracker> tracker;
+
+private:
+	// See `InFlightTaskRegistry`: whether this task owns the registry entry for its block, and
+	// whether a twin was already running it when this one started
+	bool _registered_in_flight = false;
+	bool _is_duplicate = false;
+
+	// For latency stats
+	uint64_t _scheduled_time_usec = 0;
 };
 
 } // namespace zylann::voxel
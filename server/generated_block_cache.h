@@ -0,0 +1,124 @@
+#ifndef VOXEL_GENERATED_BLOCK_CACHE_H
+#define VOXEL_GENERATED_BLOCK_CACHE_H
+
+#include "../storage/voxel_buffer_internal.h"
+#include "../util/thread/mutex.h"
+#include "streaming_dependency.h"
+
+#include <atomic>
+#include <list>
+#include <unordered_map>
+
+namespace zylann::voxel {
+
+// Bounded LRU cache of generator output. Generators are deterministic, so when a player undoes
+// edits or revisits an unmodified area that was evicted, regenerating the same block is pure
+// waste; generation tasks consult this cache first. Entries are keyed by volume, LOD and block
+// position, and carry the streaming dependency they were generated with: changing the generator
+// (or stream) replaces the dependency, which invalidates them without scanning.
+// Cached buffers are copy-on-write snapshots and are never mutated.
+class GeneratedBlockCache {
+public:
+	// Bounds memory by entry count; blocks have a fixed size per volume, so with typical 16^3
+	// 16-bit blocks this is in the order of 10 MB
+	static const unsigned int MAX_ENTRIES = 1024;
+
+	std::shared_ptr<VoxelBufferInternal> try_get(uint32_t volume_id, uint8_t lod, Vector3i position,
+			const StreamingDependency *dependency, bool &out_max_lod_hint) {
+		const Key key{ position, volume_id, lod };
+		MutexLock lock(_mutex);
+		auto it = _map.find(key);
+		if (it == _map.end() || it->second.dependency.get() != dependency || !it->second.dependency->valid) {
+			_miss_count.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+		// Freshen
+		_lru.splice(_lru.begin(), _lru, it->second.lru_it);
+		_hit_count.fetch_add(1, std::memory_order_relaxed);
+		out_max_lod_hint = it->second.max_lod_hint;
+		return it->second.voxels;
+	}
+
+	void put(uint32_t volume_id, uint8_t lod, Vector3i position, std::shared_ptr<VoxelBufferInternal> voxels,
+			std::shared_ptr<StreamingDependency> dependency, bool max_lod_hint) {
+		const Key key{ position, volume_id, lod };
+		MutexLock lock(_mutex);
+
+		auto it = _map.find(key);
+		if (it != _map.end()) {
+			_lru.erase(it->second.lru_it);
+			_map.erase(it);
+		}
+
+		_lru.push_front(key);
+		Entry &entry = _map[key];
+		entry.voxels = voxels;
+		entry.dependency = dependency;
+		entry.max_lod_hint = max_lod_hint;
+		entry.lru_it = _lru.begin();
+
+		while (_map.size() > MAX_ENTRIES) {
+			_map.erase(_lru.back());
+			_lru.pop_back();
+		}
+	}
+
+	// Frees entries of a removed volume. Volume IDs can be re-used, stale entries must not match.
+	void clear_volume(uint32_t volume_id) {
+		MutexLock lock(_mutex);
+		for (auto it = _map.begin(); it != _map.end();) {
+			if (it->first.volume_id == volume_id) {
+				_lru.erase(it->second.lru_it);
+				it = _map.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+
+	uint64_t get_hit_count() const {
+		return _hit_count;
+	}
+	uint64_t get_miss_count() const {
+		return _miss_count;
+	}
+
+private:
+	struct Key {
+		Vector3i position;
+		uint32_t volume_id;
+		uint8_t lod;
+
+		inline bool operator==(const Key &other) const {
+			return position == other.position && volume_id == other.volume_id && lod == other.lod;
+		}
+	};
+
+	struct KeyHasher {
+		inline size_t operator()(const Key &key) const {
+			uint32_t hash = Vector3iHasher::hash(key.position);
+			hash = hash_djb2_one_32(key.volume_id, hash);
+			hash = hash_djb2_one_32(key.lod, hash);
+			return hash;
+		}
+	};
+
+	struct Entry {
+		std::shared_ptr<VoxelBufferInternal> voxels;
+		std::shared_ptr<StreamingDependency> dependency;
+		std::list<Key>::iterator lru_it;
+		bool max_lod_hint = false;
+	};
+
+	Mutex _mutex;
+	std::unordered_map<Key, Entry, KeyHasher> _map;
+	// Most recently used at the front
+	std::list<Key> _lru;
+
+	std::atomic_uint64_t _hit_count = { 0 };
+	std::atomic_uint64_t _miss_count = { 0 };
+};
+
+} // namespace zylann::voxel
+
+#endif // VOXEL_GENERATED_BLOCK_CACHE_H
@@ -0,0 +1,77 @@
+#ifndef VOXEL_IN_FLIGHT_TASK_REGISTRY_H
+#define VOXEL_IN_FLIGHT_TASK_REGISTRY_H
+
+#include "../util/math/vector3i.h"
+#include "../util/thread/mutex.h"
+
+#include <atomic>
+#include <unordered_set>
+
+namespace zylann::voxel {
+
+// Tracks which block tasks are currently executing, keyed by (volume, kind, lod, position).
+// Overlapping viewer volumes can end up scheduling the same block more than once; a duplicate
+// starting while the original is still in flight detects it here and skips the heavy work. The
+// single result fans out through the volume's callbacks, which already serve every viewer.
+class InFlightTaskRegistry {
+public:
+	enum TaskKind { //
+		KIND_LOAD = 0,
+		KIND_GENERATE,
+		KIND_MESH
+	};
+
+	// Returns false when an identical task is already running, in which case the caller should
+	// skip its work and let the original deliver. On success the caller owns the entry and must
+	// call `unregister_task` with the same key when done.
+	bool try_register_task(uint32_t volume_id, TaskKind kind, uint8_t lod, Vector3i position) {
+		const Key key{ position, volume_id, uint8_t(kind), lod };
+		MutexLock lock(_mutex);
+		if (!_in_flight.insert(key).second) {
+			_deduplicated_count.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		return true;
+	}
+
+	void unregister_task(uint32_t volume_id, TaskKind kind, uint8_t lod, Vector3i position) {
+		const Key key{ position, volume_id, uint8_t(kind), lod };
+		MutexLock lock(_mutex);
+		_in_flight.erase(key);
+	}
+
+	// How many tasks detected a running twin and skipped their work, since startup
+	uint64_t get_deduplicated_count() const {
+		return _deduplicated_count.load(std::memory_order_relaxed);
+	}
+
+private:
+	struct Key {
+		Vector3i position;
+		uint32_t volume_id;
+		uint8_t kind;
+		uint8_t lod;
+
+		inline bool operator==(const Key &other) const {
+			return position == other.position && volume_id == other.volume_id && kind == other.kind &&
+					lod == other.lod;
+		}
+	};
+
+	struct KeyHasher {
+		inline size_t operator()(const Key &key) const {
+			uint32_t hash = Vector3iHasher::hash(key.position);
+			hash = hash_djb2_one_32(key.volume_id, hash);
+			hash = hash_djb2_one_32((uint32_t(key.kind) << 8) | key.lod, hash);
+			return hash;
+		}
+	};
+
+	Mutex _mutex;
+	std::unordered_set<Key, KeyHasher> _in_flight;
+	std::atomic_uint64_t _deduplicated_count = { 0 };
+};
+
+} // namespace zylann::voxel
+
+#endif // VOXEL_IN_FLIGHT_TASK_REGISTRY_H
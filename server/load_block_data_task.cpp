@@ -1,10 +1,14 @@
 #include "load_block_data_task.h"
+#include "../util/object_pool.h"
 #include "../storage/voxel_buffer_internal.h"
+#include "../streams/voxel_block_serializer.h"
 #include "../util/godot/funcs.h"
 #include "../util/log.h"
+#include "../util/memory_accounting.h"
 #include "../util/profiling.h"
 #include "generate_block_task.h"
 #include "voxel_server.h"
+#include <core/os/time.h>
 
 namespace zylann::voxel {
 
@@ -12,23 +16,40 @@ namespace {
 std::atomic_int g_debug_load_block_tasks_count;
 }
 
-LoadBlockDataTask::LoadBlockDataTask(uint32_t p_volume_id, Vector3i p_block_pos, uint8_t p_lod, uint8_t p_block_size,
-		bool p_request_instances, std::shared_ptr<StreamingDependency> p_stream_dependency,
-		PriorityDependency p_priority_dependency) :
-		_priority_dependency(p_priority_dependency),
-		_position(p_block_pos),
-		_volume_id(p_volume_id),
-		_lod(p_lod),
-		_block_size(p_block_size),
-		_request_instances(p_request_instances),
-		//_request_voxels(true),
-		_stream_dependency(p_stream_dependency) {
-	//
+namespace {
+ThreadSafeObjectPool<LoadBlockDataTask> g_task_pool;
+}
+
+LoadBlockDataTask *LoadBlockDataTask::create(uint32_t p_volume_id, Vector3i p_block_pos, uint8_t p_lod,
+		uint8_t p_block_size, bool p_request_instances, std::shared_ptr<StreamingDependency> p_stream_dependency,
+		PriorityDependency p_priority_dependency, std::shared_ptr<VoxelBufferInternal> p_coarse_voxels,
+		uint8_t p_coarse_octant) {
+	LoadBlockDataTask *task = g_task_pool.create();
+	task->_priority_dependency = p_priority_dependency;
+	task->_coarse_voxels = std::move(p_coarse_voxels);
+	task->_coarse_octant = p_coarse_octant;
+	task->_position = p_block_pos;
+	task->_volume_id = p_volume_id;
+	task->_lod = p_lod;
+	task->_block_size = p_block_size;
+	task->_request_instances = p_request_instances;
+	task->_stream_dependency = std::move(p_stream_dependency);
+	task->_scheduled_time_usec = Time::get_singleton()->get_ticks_usec();
 	++g_debug_load_block_tasks_count;
+	return task;
 }
 
-LoadBlockDataTask::~LoadBlockDataTask() {
+void LoadBlockDataTask::dispose() {
+	if (_registered_in_flight) {
+		VoxelServer::get_singleton().get_in_flight_task_registry().unregister_task(
+				_volume_id, InFlightTaskRegistry::KIND_LOAD, _lod, _position);
+	}
 	--g_debug_load_block_tasks_count;
+	g_task_pool.recycle(this);
+}
+
+void LoadBlockDataTask::init() {
+	*this = LoadBlockDataTask();
 }
 
 int LoadBlockDataTask::debug_get_running_count() {
@@ -37,17 +58,36 @@ int LoadBlockDataTask::debug_get_running_count() {
 
 void LoadBlockDataTask::run(zylann::ThreadedTaskContext ctx) {
 	ZN_PROFILE_SCOPE();
+	const uint64_t run_begin_usec = Time::get_singleton()->get_ticks_usec();
 
 	CRASH_COND(_stream_dependency == nullptr);
 	Ref<VoxelStream> stream = _stream_dependency->stream;
 	CRASH_COND(stream.is_null());
 
+	// Overlapping viewers can schedule the same block twice; if a twin is already loading it,
+	// its result will reach the volume anyway, so this one bows out
+	_registered_in_flight = VoxelServer::get_singleton().get_in_flight_task_registry().try_register_task(
+			_volume_id, InFlightTaskRegistry::KIND_LOAD, _lod, _position);
+	if (!_registered_in_flight) {
+		_is_duplicate = true;
+		return;
+	}
+
 	const Vector3i origin_in_voxels = (_position << _lod) * _block_size;
 
 	ERR_FAIL_COND(_voxels != nullptr);
 	_voxels = make_shared_instance<VoxelBufferInternal>();
+	if (_lod >= _stream_dependency->sdf_low_precision_lod_start) {
+		// Distant LODs don't need 16-bit SDF precision; see StreamingDependency
+		_voxels->set_channel_depth(VoxelBufferInternal::CHANNEL_SDF, VoxelBufferInternal::DEPTH_8_BIT);
+	}
 	_voxels->create(_block_size, _block_size, _block_size);
 
+	// Recently-evicted blocks are kept compressed in memory; circling players then reload from a
+	// cheap decompression instead of the stream
+	const bool cold_cache_hit =
+			VoxelServer::get_singleton().get_cold_block_cache().try_get(_volume_id, _lod, _position, *_voxels);
+
 	// TODO We should consider batching this again, but it needs to be done carefully.
 	// Each task is one block, and priority depends on distance to closest viewer.
 	// If we batch blocks, we have to do it by distance too.
@@ -55,7 +95,50 @@ void LoadBlockDataTask::run(zylann::ThreadedTaskContext ctx) {
 	// TODO Assign max_lod_hint when available
 
 	VoxelStream::VoxelQueryData voxel_query_data{ *_voxels, origin_in_voxels, _lod, VoxelStream::RESULT_ERROR };
-	stream->load_voxel_block(voxel_query_data);
+	voxel_query_data.delta_boxes = &_delta_boxes;
+	if (cold_cache_hit) {
+		voxel_query_data.result = VoxelStream::RESULT_BLOCK_FOUND;
+	} else {
+		// Timed so production can tell storage latency apart from scheduling problems
+		const uint64_t io_time_before = Time::get_singleton()->get_ticks_usec();
+		stream->load_voxel_block(voxel_query_data);
+		stream->record_load_io(_position, _lod, Time::get_singleton()->get_ticks_usec() - io_time_before);
+	}
+
+	if (voxel_query_data.result == VoxelStream::RESULT_BLOCK_FOUND_PARTIAL) {
+		// The stored data was a delta against generator output: stash the stored regions,
+		// regenerate the block, and put the regions back on top
+		Ref<VoxelGenerator> generator = _stream_dependency->generator;
+		if (generator.is_null()) {
+			ERR_PRINT("Found a delta-saved block but there is no generator to rebuild it");
+			voxel_query_data.result = VoxelStream::RESULT_ERROR;
+
+		} else {
+			static thread_local std::vector<VoxelBufferInternal> tls_stashed_regions;
+			tls_stashed_regions.resize(_delta_boxes.size());
+			for (unsigned int i = 0; i < _delta_boxes.size(); ++i) {
+				const Box3i box = _delta_boxes[i];
+				VoxelBufferInternal &stash = tls_stashed_regions[i];
+				stash.copy_format(*_voxels);
+				stash.create(box.size);
+				for (unsigned int ci = 0; ci < VoxelBufferInternal::MAX_CHANNELS; ++ci) {
+					stash.copy_from(*_voxels, box.pos, box.pos + box.size, Vector3i(), ci);
+				}
+			}
+
+			VoxelGenerator::VoxelQueryData gen_query{ *_voxels, origin_in_voxels, _lod };
+			generator->generate_block(gen_query);
+
+			for (unsigned int i = 0; i < _delta_boxes.size(); ++i) {
+				const Box3i box = _delta_boxes[i];
+				VoxelBufferInternal &stash = tls_stashed_regions[i];
+				for (unsigned int ci = 0; ci < VoxelBufferInternal::MAX_CHANNELS; ++ci) {
+					_voxels->copy_from(stash, Vector3i(), box.size, box.pos, ci);
+				}
+			}
+			tls_stashed_regions.clear();
+		}
+	}
 
 	if (voxel_query_data.result == VoxelStream::RESULT_ERROR) {
 		ERR_PRINT("Error loading voxel block");
@@ -64,8 +147,10 @@ void LoadBlockDataTask::run(zylann::ThreadedTaskContext ctx) {
 		Ref<VoxelGenerator> generator = _stream_dependency->generator;
 
 		if (generator.is_valid()) {
-			GenerateBlockTask *task = memnew(GenerateBlockTask);
+			GenerateBlockTask *task = GenerateBlockTask::create();
 			task->voxels = _voxels;
+			task->coarse_voxels = _coarse_voxels;
+			task->coarse_octant = _coarse_octant;
 			task->volume_id = _volume_id;
 			task->position = _position;
 			task->lod = _lod;
@@ -102,7 +187,30 @@ void LoadBlockDataTask::run(zylann::ThreadedTaskContext ctx) {
 		// which means it can be generated by the instancer after the meshing process
 	}
 
+	// During teleports, thousands of results can pile up in the delivery queue while the main
+	// thread catches up, each holding a full decompressed buffer. Past a backlog threshold the
+	// payload is handed over in compressed form instead (roughly 5x smaller for typical terrain)
+	// and decompressed under the apply path, bounding the spike to queue depth times compressed
+	// size. The recompression cost lands on worker threads, and only during bursts.
+	const unsigned int BACKLOG_COMPRESSION_THRESHOLD = 128;
+	if (!_fallback_on_generator && _voxels != nullptr &&
+			VoxelServer::get_singleton().get_streaming_results_backlog() > BACKLOG_COMPRESSION_THRESHOLD) {
+		BlockSerializer::SerializeResult res = BlockSerializer::serialize_and_compress(*_voxels);
+		if (res.success) {
+			_compressed_voxels = res.data;
+			_voxels = nullptr;
+		}
+	}
+
 	_has_run = true;
+
+	const uint64_t now_usec = Time::get_singleton()->get_ticks_usec();
+	VoxelServer::get_singleton().get_task_latency_stats().record(
+			TaskLatencyStats::TASK_LOAD, now_usec - _scheduled_time_usec);
+	VoxelServer::get_singleton().get_task_runtime_stats().record(TaskLatencyStats::TASK_LOAD,
+			now_usec - run_begin_usec, MemoryAccounting::get_thread_task_peak_bytes());
+	VoxelServer::get_singleton().record_slow_block(
+			TaskLatencyStats::TASK_LOAD, _position, _lod, now_usec - run_begin_usec);
 }
 
 int LoadBlockDataTask::get_priority() {
@@ -117,14 +225,34 @@ bool LoadBlockDataTask::is_cancelled() {
 }
 
 void LoadBlockDataTask::apply_result() {
+	if (_counted_for_admission) {
+		// Frees the volume's admission slot and admits deferred loads; runs for every outcome
+		// (success, drop, duplicate), the slot was taken when the task was created
+		VoxelServer::get_singleton().on_streamed_load_finished(_volume_id);
+	}
+	if (_is_duplicate) {
+		// The twin task delivers the block, reporting this one as dropped would only cause churn
+		return;
+	}
 	if (VoxelServer::get_singleton().is_volume_valid(_volume_id)) {
 		// TODO Comparing pointer may not be guaranteed
 		// The request response must match the dependency it would have been requested with.
 		// If it doesn't match, we are no longer interested in the result.
 		if (_stream_dependency->valid && !_fallback_on_generator) {
+			if (_voxels == nullptr && _compressed_voxels.size() > 0) {
+				// Payload waited in compressed form, see end of `run()`
+				_voxels = make_shared_instance<VoxelBufferInternal>();
+				if (!BlockSerializer::decompress_and_deserialize(to_span_const(_compressed_voxels), *_voxels)) {
+					ERR_PRINT("Failed to decompress deferred block payload");
+					_voxels = nullptr;
+				}
+				_compressed_voxels.clear();
+			}
+
 			VoxelServer::BlockDataOutput o;
 			o.voxels = _voxels;
 			o.instances = std::move(_instances);
+			o.delta_boxes = std::move(_delta_boxes);
 			o.position = _position;
 			o.lod = _lod;
 			o.dropped = !_has_run;
@@ -10,34 +10,66 @@ namespace zylann::voxel {
 
 class LoadBlockDataTask : public IThreadedTask {
 public:
-	LoadBlockDataTask(uint32_t p_volume_id, Vector3i p_block_pos, uint8_t p_lod, uint8_t p_block_size,
-			bool p_request_instances, std::shared_ptr<StreamingDependency> p_stream_dependency,
-			PriorityDependency p_priority_dependency);
+	// Tasks are pooled, get instances with `create()` (the default constructor only exists for the
+	// pool). The owner gives them back through `dispose()`.
+	LoadBlockDataTask() {}
 
-	~LoadBlockDataTask();
+	// `p_coarse_voxels` optionally carries a snapshot of the parent LOD block covering this one,
+	// forwarded to the generation fallback for generators supporting LOD refinement
+	static LoadBlockDataTask *create(uint32_t p_volume_id, Vector3i p_block_pos, uint8_t p_lod, uint8_t p_block_size,
+			bool p_request_instances, std::shared_ptr<StreamingDependency> p_stream_dependency,
+			PriorityDependency p_priority_dependency,
+			std::shared_ptr<VoxelBufferInternal> p_coarse_voxels = nullptr, uint8_t p_coarse_octant = 0);
 
 	void run(ThreadedTaskContext ctx) override;
 	int get_priority() override;
+	uint32_t get_fair_group() const override {
+		return _volume_id;
+	}
 	bool is_cancelled() override;
 	void apply_result() override;
 
+	void set_counted_for_admission(bool counted) {
+		_counted_for_admission = counted;
+	}
+	void dispose() override;
+
+	// Resets to a freshly-constructed state, called when recycled into the pool
+	void init();
+
 	static int debug_get_running_count();
 
 private:
 	PriorityDependency _priority_dependency;
 	std::shared_ptr<VoxelBufferInternal> _voxels;
+	// When the main thread falls behind during load bursts, the payload waits in this compressed
+	// form instead of a full buffer, and is decompressed at apply time. See end of `run()`.
+	std::vector<uint8_t> _compressed_voxels;
+	std::shared_ptr<VoxelBufferInternal> _coarse_voxels;
+	// Filled when the stored block was a delta against generator output
+	std::vector<Box3i> _delta_boxes;
+	uint8_t _coarse_octant = 0;
 	UniquePtr<InstanceBlockData> _instances;
 	Vector3i _position; // In data blocks of the specified lod
 	uint32_t _volume_id;
 	uint8_t _lod;
 	uint8_t _block_size;
 	bool _has_run = false;
+	// Whether this task holds an admission slot of its volume, see
+	// `VoxelServer::request_block_load`
+	bool _counted_for_admission = false;
+	// Whether this task owns the in-flight registry entry for its block. Duplicates don't.
+	bool _registered_in_flight = false;
+	// Set when a twin task was already running this block when this one started
+	bool _is_duplicate = false;
 	bool _too_far = false;
 	bool _request_instances = false;
 	//bool _request_voxels = false;
 	bool _max_lod_hint = false;
 	bool _fallback_on_generator = false;
 	std::shared_ptr<StreamingDependency> _stream_dependency;
+	// For latency stats
+	uint64_t _scheduled_time_usec = 0;
 };
 
 } // namespace zylann::voxel
@@ -1,7 +1,15 @@
 #include "mesh_block_task.h"
+#include "../util/lightweight_profiler.h"
+#include "../constants/voxel_constants.h"
+#include "../util/godot/funcs.h"
+#include "../util/math/conv.h"
 #include "../util/log.h"
+#include "../util/memory_accounting.h"
 #include "../util/profiling.h"
+#include "../util/object_pool.h"
+#include "../thirdparty/meshoptimizer/meshoptimizer.h"
 #include "voxel_server.h"
+#include <core/os/time.h>
 
 namespace zylann::voxel {
 
@@ -10,8 +18,9 @@ namespace zylann::voxel {
 // which includes enough neighbors for the mesher to avoid doing bound checks.
 static void copy_block_and_neighbors(Span<std::shared_ptr<VoxelBufferInternal>> blocks, VoxelBufferInternal &dst,
 		int min_padding, int max_padding, int channels_mask, Ref<VoxelGenerator> generator, int data_block_size,
-		uint8_t lod_index, Vector3i mesh_block_pos) {
+		uint8_t lod_index, Vector3i mesh_block_pos, uint32_t volume_id) {
 	ZN_PROFILE_SCOPE();
+	ZN_LIGHT_PROFILE_SCOPE("mesh_gather_voxels");
 
 	// Extract wanted channels in a list
 	unsigned int channels_count = 0;
@@ -132,7 +141,15 @@ static void copy_block_and_neighbors(Span<std::shared_ptr<VoxelBufferInternal>>
 			//generated_voxels.set_voxel_f(2.0f, box.size.x / 2, box.size.y / 2, box.size.z / 2,
 			//VoxelBufferInternal::CHANNEL_SDF);
 			VoxelGenerator::VoxelQueryData q{ generated_voxels, (box.pos << lod_index) + origin_in_voxels, lod_index };
+			// This data only feeds the mesher and is thrown away afterwards, so the generator can
+			// skip outputs for channels the mesher doesn't read
+			q.requested_channels = channels_mask;
 			generator->generate_block(q);
+			// Stages must also run on throwaway meshing slices, or decorated content would be
+			// missing from neighbor padding; they are required to be deterministic in absolute
+			// coordinates, so partial boxes come out consistent with full blocks
+			VoxelServer::get_singleton().apply_block_processing_stages(
+					generated_voxels, q.origin_in_voxels, lod_index, volume_id);
 
 			for (unsigned int ci = 0; ci < channels_count; ++ci) {
 				dst.copy_from(generated_voxels, Vector3i(), generated_voxels.get_size(),
@@ -142,53 +159,325 @@ static void copy_block_and_neighbors(Span<std::shared_ptr<VoxelBufferInternal>>
 	}
 }
 
+static inline uint64_t hash_fnv1a(const uint8_t *data, size_t len, uint64_t h) {
+	for (size_t i = 0; i < len; ++i) {
+		h = (h ^ data[i]) * 0x100000001b3ull;
+	}
+	return h;
+}
+
+// Hashes the contents of the produced surfaces, so identical meshes (flat oceans, plains) can be
+// shared instead of uploaded once per block. See `MeshDedupCache`.
+static uint64_t hash_surfaces(const VoxelMesher::Output &output) {
+	uint64_t h = 0xcbf29ce484222325ull;
+	h = hash_fnv1a(reinterpret_cast<const uint8_t *>(&output.primitive_type), sizeof(output.primitive_type), h);
+	h = hash_fnv1a(reinterpret_cast<const uint8_t *>(&output.mesh_flags), sizeof(output.mesh_flags), h);
+
+	for (unsigned int surface_index = 0; surface_index < output.surfaces.size(); ++surface_index) {
+		const Array &surface = output.surfaces[surface_index];
+		for (int i = 0; i < surface.size(); ++i) {
+			const Variant &v = surface[i];
+			// Delimit elements by type so layouts can't alias
+			const uint8_t type = v.get_type();
+			h = hash_fnv1a(&type, 1, h);
+			switch (v.get_type()) {
+				case Variant::PACKED_VECTOR3_ARRAY: {
+					const PackedVector3Array a = v;
+					h = hash_fnv1a(reinterpret_cast<const uint8_t *>(a.ptr()), a.size() * sizeof(Vector3), h);
+				} break;
+				case Variant::PACKED_VECTOR2_ARRAY: {
+					const PackedVector2Array a = v;
+					h = hash_fnv1a(reinterpret_cast<const uint8_t *>(a.ptr()), a.size() * sizeof(Vector2), h);
+				} break;
+				case Variant::PACKED_FLOAT32_ARRAY: {
+					const PackedFloat32Array a = v;
+					h = hash_fnv1a(reinterpret_cast<const uint8_t *>(a.ptr()), a.size() * sizeof(float), h);
+				} break;
+				case Variant::PACKED_INT32_ARRAY: {
+					const PackedInt32Array a = v;
+					h = hash_fnv1a(reinterpret_cast<const uint8_t *>(a.ptr()), a.size() * sizeof(int32_t), h);
+				} break;
+				case Variant::PACKED_COLOR_ARRAY: {
+					const PackedColorArray a = v;
+					h = hash_fnv1a(reinterpret_cast<const uint8_t *>(a.ptr()), a.size() * sizeof(Color), h);
+				} break;
+				case Variant::PACKED_BYTE_ARRAY: {
+					const PackedByteArray a = v;
+					h = hash_fnv1a(a.ptr(), a.size(), h);
+				} break;
+				default:
+					// NIL and anything unexpected only contribute their type
+					break;
+			}
+		}
+	}
+	return h;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 namespace {
 std::atomic_int g_debug_mesh_tasks_count;
+// Remeshing bursts schedule these by the hundreds, recycling avoids the allocator entirely
+ThreadSafeObjectPool<MeshBlockTask> g_task_pool;
 } //namespace
 
-MeshBlockTask::MeshBlockTask() {
+MeshBlockTask *MeshBlockTask::create() {
+	MeshBlockTask *task = g_task_pool.create();
+	task->_scheduled_time_usec = Time::get_singleton()->get_ticks_usec();
 	++g_debug_mesh_tasks_count;
+	return task;
 }
 
-MeshBlockTask::~MeshBlockTask() {
+void MeshBlockTask::dispose() {
+	if (_registered_in_flight) {
+		VoxelServer::get_singleton().get_in_flight_task_registry().unregister_task(
+				volume_id, InFlightTaskRegistry::KIND_MESH, lod, position);
+	}
 	--g_debug_mesh_tasks_count;
+	g_task_pool.recycle(this);
+}
+
+void MeshBlockTask::init() {
+	*this = MeshBlockTask();
 }
 
 int MeshBlockTask::debug_get_running_count() {
 	return g_debug_mesh_tasks_count;
 }
 
+namespace {
+
+// Decimates a collision triangle soup in place using meshoptimizer, for blocks far enough that
+// full-resolution physics doesn't matter. Duplicated corners are welded first so the simplifier
+// can work across triangles. Gives up when little would be gained.
+void simplify_collision_faces(PackedVector3Array &faces) {
+	ZN_PROFILE_SCOPE();
+	const unsigned int src_vertex_count = faces.size();
+	if (src_vertex_count < 3 * 16) {
+		// Not worth it
+		return;
+	}
+
+	static thread_local std::vector<Vector3f> tls_positions;
+	tls_positions.resize(src_vertex_count);
+	{
+		const Vector3 *src = faces.ptr();
+		for (unsigned int i = 0; i < src_vertex_count; ++i) {
+			tls_positions[i] = to_vec3f(src[i]);
+		}
+	}
+
+	static thread_local std::vector<unsigned int> tls_remap;
+	tls_remap.resize(src_vertex_count);
+	const size_t unique_vertex_count = zylannmeshopt::meshopt_generateVertexRemap(tls_remap.data(), nullptr,
+			src_vertex_count, tls_positions.data(), src_vertex_count, sizeof(Vector3f));
+
+	static thread_local std::vector<unsigned int> tls_indices;
+	tls_indices.resize(src_vertex_count);
+	for (unsigned int i = 0; i < src_vertex_count; ++i) {
+		tls_indices[i] = tls_remap[i];
+	}
+
+	static thread_local std::vector<Vector3f> tls_unique_positions;
+	tls_unique_positions.resize(unique_vertex_count);
+	zylannmeshopt::meshopt_remapVertexBuffer(tls_unique_positions.data(), tls_positions.data(), src_vertex_count,
+			sizeof(Vector3f), tls_remap.data());
+
+	// A quarter of the triangles retains the shape of terrain well enough for far physics
+	const unsigned int target_index_count =
+			math::max(3u * 16u, (src_vertex_count / 4u) - (src_vertex_count / 4u) % 3u);
+	const float target_error = 0.05f;
+
+	static thread_local std::vector<unsigned int> tls_simplified_indices;
+	tls_simplified_indices.resize(src_vertex_count);
+	float result_error = 0.f;
+	const unsigned int simplified_index_count = zylannmeshopt::meshopt_simplify(tls_simplified_indices.data(),
+			tls_indices.data(), src_vertex_count, &tls_unique_positions[0].x, unique_vertex_count, sizeof(Vector3f),
+			target_index_count, target_error, &result_error);
+
+	if (simplified_index_count == 0 || simplified_index_count >= src_vertex_count) {
+		return;
+	}
+
+	faces.resize(simplified_index_count);
+	Vector3 *dst = faces.ptrw();
+	for (unsigned int i = 0; i < simplified_index_count; ++i) {
+		dst[i] = to_vec3(tls_unique_positions[tls_simplified_indices[i]]);
+	}
+}
+
+} // namespace
+
 void MeshBlockTask::run(zylann::ThreadedTaskContext ctx) {
 	ZN_PROFILE_SCOPE();
+	const uint64_t run_begin_usec = Time::get_singleton()->get_ticks_usec();
 	CRASH_COND(meshing_dependency == nullptr);
 
+	// If a twin task is already meshing this block, skip the build. Reported as dropped, so in the
+	// unlikely case the twin's output doesn't cover this request, the volume will just reschedule.
+	_registered_in_flight = VoxelServer::get_singleton().get_in_flight_task_registry().try_register_task(
+			volume_id, InFlightTaskRegistry::KIND_MESH, lod, position);
+	if (!_registered_in_flight) {
+		return;
+	}
+
 	Ref<VoxelMesher> mesher = meshing_dependency->mesher;
 	CRASH_COND(mesher.is_null());
 	const unsigned int min_padding = mesher->get_minimum_padding();
 	const unsigned int max_padding = mesher->get_maximum_padding();
 
+	// Pre-gather classification: when every channel the mesher reads is uniform with the same
+	// value across the whole neighborhood, the padded buffer would be uniform too, and uniform
+	// content has no boundary to mesh, whatever the mesher. Sky-heavy LOD rings schedule vast
+	// numbers of such blocks; both the gather and the meshing are skipped and an empty result is
+	// delivered through the normal path. Missing neighbors disqualify the check: they'd be filled
+	// by the generator or defaults, which may differ.
+	{
+		bool provably_empty = true;
+		const unsigned int channels_mask = mesher->get_used_channels_mask();
+		for (unsigned int channel = 0; channel < VoxelBufferInternal::MAX_CHANNELS && provably_empty; ++channel) {
+			if ((channels_mask & (1 << channel)) == 0) {
+				continue;
+			}
+			bool first = true;
+			uint64_t reference_value = 0;
+			for (unsigned int i = 0; i < blocks_count; ++i) {
+				const std::shared_ptr<VoxelBufferInternal> &block = blocks[i];
+				if (block == nullptr) {
+					provably_empty = false;
+					break;
+				}
+				RWLockRead rlock(block->get_lock());
+				if (block->get_channel_compression(channel) != VoxelBufferInternal::COMPRESSION_UNIFORM) {
+					provably_empty = false;
+					break;
+				}
+				const uint64_t value = block->get_voxel(Vector3i(), channel);
+				if (first) {
+					reference_value = value;
+					first = false;
+				} else if (value != reference_value) {
+					provably_empty = false;
+					break;
+				}
+			}
+		}
+		if (provably_empty) {
+			// `_surfaces_output` stays empty; hashing, packing and collision cooking below all
+			// no-op on it, and the volume handles an empty mesh like any other
+			_has_run = true;
+			const uint64_t now_usec = Time::get_singleton()->get_ticks_usec();
+			VoxelServer::get_singleton().get_task_latency_stats().record(
+					TaskLatencyStats::TASK_MESH, now_usec - _scheduled_time_usec);
+			VoxelServer::get_singleton().get_task_runtime_stats().record(TaskLatencyStats::TASK_MESH,
+					now_usec - run_begin_usec, MemoryAccounting::get_thread_task_peak_bytes());
+			return;
+		}
+	}
+
 	// TODO Cache?
 	VoxelBufferInternal voxels;
 	copy_block_and_neighbors(to_span(blocks, blocks_count), voxels, min_padding, max_padding,
-			mesher->get_used_channels_mask(), meshing_dependency->generator, data_block_size, lod, position);
+			mesher->get_used_channels_mask(), meshing_dependency->generator, data_block_size, lod, position, volume_id);
 
 	const Vector3i origin_in_voxels = position * (int(data_block_size) << lod);
 
-	const VoxelMesher::Input input = { voxels, meshing_dependency->generator.ptr(), data.get(), origin_in_voxels, lod };
+	// If the volume told us which region changed since the previous request for this block,
+	// hand it to the mesher in the coordinate space of the padded buffer, so incremental meshers
+	// can reuse previous geometry outside of it.
+	Box3i dirty_box_in_buffer;
+	if (has_dirty_box) {
+		const int mesh_block_size = voxels.get_size().x - (min_padding + max_padding);
+		dirty_box_in_buffer =
+				Box3i(dirty_box.pos - position * mesh_block_size + Vector3iUtil::create(min_padding), dirty_box.size)
+						.clipped(Box3i(Vector3i(), voxels.get_size()));
+	}
+
+	// Edit-driven remeshes are latency-critical; expensive polish passes get skipped and
+	// recovered by a non-urgent rebuild scheduled by the volume
+	const VoxelMesher::Input input = { voxels, meshing_dependency->generator.ptr(), data.get(), origin_in_voxels, lod,
+		dirty_box_in_buffer, has_dirty_box, volume_id, uint8_t(~transition_sides_mask), has_dirty_box,
+		&meshing_dependency->valid };
 	mesher->build(_surfaces_output, input);
 
+	_content_hash = hash_surfaces(_surfaces_output);
+
+	{
+		// Pack surfaces into the RenderingServer's native layout here on the worker;
+		// `mesh_create_surface_data_from_arrays` is pure CPU work and safe off the main thread.
+		// The main thread then only calls `ArrayMesh::add_surface`, skipping Variant unpacking
+		// and vertex packing entirely.
+		ZN_PROFILE_SCOPE_NAMED("Pack surfaces");
+		for (unsigned int i = 0; i < _surfaces_output.surfaces.size(); ++i) {
+			const Array &surface = _surfaces_output.surfaces[i];
+			if (surface.is_empty() || !is_surface_triangulated(surface)) {
+				continue;
+			}
+			VoxelServer::BlockMeshOutput::PackedSurface packed;
+			packed.src_index = i;
+			const Error err = RenderingServer::get_singleton()->mesh_create_surface_data_from_arrays(&packed.data,
+					RenderingServer::PrimitiveType(_surfaces_output.primitive_type), surface, Array(), Dictionary(),
+					_surfaces_output.mesh_flags);
+			if (err != OK) {
+				// Consumers fall back to the Variant path when packing is absent
+				_packed_surfaces.clear();
+				break;
+			}
+			_packed_surfaces.push_back(std::move(packed));
+		}
+	}
+
+	if (collision_hint) {
+		// Cook the collision triangle soup here too, so the main thread only has to create the
+		// shape and assign it to the body
+		ZN_PROFILE_SCOPE_NAMED("Cook collision faces");
+		std::vector<Array> collidable_surfaces;
+		for (unsigned int i = 0; i < _surfaces_output.surfaces.size(); ++i) {
+			const Array &surface = _surfaces_output.surfaces[i];
+			if (surface.is_empty() || !is_surface_triangulated(surface)) {
+				continue;
+			}
+			collidable_surfaces.push_back(surface);
+		}
+		_collision_shape_faces = build_collision_shape_faces(to_span_const(collidable_surfaces));
+
+		if (collision_simplify_distance > 0.f && _collision_shape_faces.size() > 0) {
+			float closest_viewer_distance_sq = 0.f;
+			priority_dependency.evaluate(lod, &closest_viewer_distance_sq);
+			if (closest_viewer_distance_sq > math::squared(collision_simplify_distance)) {
+				// Far blocks only need approximate physics (projectiles, distant actors); a
+				// decimated soup cooks and queries much faster
+				simplify_collision_faces(_collision_shape_faces);
+			}
+		}
+	}
+
 	_has_run = true;
+
+	const uint64_t now_usec = Time::get_singleton()->get_ticks_usec();
+	VoxelServer::get_singleton().get_task_latency_stats().record(
+			TaskLatencyStats::TASK_MESH, now_usec - _scheduled_time_usec);
+	VoxelServer::get_singleton().get_task_runtime_stats().record(TaskLatencyStats::TASK_MESH,
+			now_usec - run_begin_usec, MemoryAccounting::get_thread_task_peak_bytes());
+	VoxelServer::get_singleton().record_slow_block(
+			TaskLatencyStats::TASK_MESH, position, lod, now_usec - run_begin_usec);
 }
 
 int MeshBlockTask::get_priority() {
 	float closest_viewer_distance_sq;
 	const int p = priority_dependency.evaluate(lod, &closest_viewer_distance_sq);
 	_too_far = closest_viewer_distance_sq > priority_dependency.drop_distance_squared;
+	_latency_critical = lod == 0 &&
+			closest_viewer_distance_sq < math::squared(constants::LATENCY_CRITICAL_DISTANCE);
 	return p;
 }
 
+uint8_t MeshBlockTask::get_qos_class() const {
+	// Set by `get_priority`, which the pool evaluates before sampling the class
+	return _latency_critical ? QOS_LATENCY_CRITICAL : QOS_BULK;
+}
+
 bool MeshBlockTask::is_cancelled() {
 	return !meshing_dependency->valid || _too_far;
 }
@@ -211,6 +500,11 @@ void MeshBlockTask::apply_result() {
 			o.position = position;
 			o.lod = lod;
 			o.surfaces = std::move(_surfaces_output);
+			o.collision_shape_faces = _collision_shape_faces;
+			o.has_collision_shape_faces = collision_hint && _has_run;
+			o.content_hash = _has_run ? _content_hash : 0;
+			o.packed_surfaces = std::move(_packed_surfaces);
+			o.built_transition_sides_mask = transition_sides_mask;
 
 			VoxelServer::VolumeCallbacks callbacks = VoxelServer::get_singleton().get_volume_callbacks(volume_id);
 			ERR_FAIL_COND(callbacks.mesh_output_callback == nullptr);
@@ -6,19 +6,28 @@
 #include "../util/tasks/threaded_task.h"
 #include "meshing_dependency.h"
 #include "priority_dependency.h"
+#include "voxel_server.h"
 
 namespace zylann::voxel {
 
 // Asynchronous task generating a mesh from voxel blocks and their neighbors, in a particular volume
 class MeshBlockTask : public IThreadedTask {
 public:
-	MeshBlockTask();
-	~MeshBlockTask();
+	// Tasks are pooled, get instances with `create()` (the default constructor only exists for the
+	// pool). The owner gives them back through `dispose()`.
+	MeshBlockTask() {}
+
+	static MeshBlockTask *create();
 
 	void run(ThreadedTaskContext ctx) override;
 	int get_priority() override;
+	uint8_t get_qos_class() const override;
 	bool is_cancelled() override;
 	void apply_result() override;
+	void dispose() override;
+
+	// Resets to a freshly-constructed state, called when recycled into the pool
+	void init();
 
 	static int debug_get_running_count();
 
@@ -27,6 +36,17 @@ public:
 	// TODO Need to provide format
 	//FixedArray<uint8_t, VoxelBufferInternal::MAX_CHANNELS> channel_depths;
 	Vector3i position; // In mesh blocks of the specified lod
+	// When `has_dirty_box` is set, voxels outside this box (in voxels at the task's lod) did not
+	// change since the previous mesh request for this block.
+	Box3i dirty_box;
+	bool has_dirty_box = false;
+	// When set, the collision triangle soup is cooked here too, see `BlockMeshOutput`
+	bool collision_hint = false;
+	// When non-zero, collision triangles get decimated when the closest viewer is farther than
+	// this distance; distant blocks don't need full-resolution physics
+	float collision_simplify_distance = 0.f;
+	// Transition sides to build, see `BlockMeshInput`
+	uint8_t transition_sides_mask = 0xff;
 	uint32_t volume_id;
 	uint8_t lod;
 	uint8_t blocks_count;
@@ -36,9 +56,21 @@ public:
 	std::shared_ptr<VoxelDataLodMap> data;
 
 private:
+	// Whether this task owns the in-flight registry entry for its block. Duplicates don't.
+	bool _registered_in_flight = false;
+
+	// For latency stats
+	uint64_t _scheduled_time_usec = 0;
 	bool _has_run = false;
 	bool _too_far = false;
+	// Whether the block is close enough that players feel its update latency; see get_qos_class
+	bool _latency_critical = false;
 	VoxelMesher::Output _surfaces_output;
+	// See `BlockMeshOutput::packed_surfaces`
+	std::vector<VoxelServer::BlockMeshOutput::PackedSurface> _packed_surfaces;
+	// Content hash of the surfaces, for mesh deduplication
+	uint64_t _content_hash = 0;
+	PackedVector3Array _collision_shape_faces;
 };
 
 } // namespace zylann::voxel
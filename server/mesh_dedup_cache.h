@@ -0,0 +1,102 @@
+#ifndef VOXEL_MESH_DEDUP_CACHE_H
+#define VOXEL_MESH_DEDUP_CACHE_H
+
+#include <core/object/object.h>
+#include <scene/resources/mesh.h>
+
+#include <atomic>
+#include <unordered_map>
+
+namespace zylann::voxel {
+
+// Shares identical meshes across blocks of the same volume. Flat oceans and plains produce
+// thousands of blocks with exactly the same geometry; uploading one mesh and pointing every
+// block's instance at it saves GPU memory and upload bandwidth. Keys are content hashes computed
+// by the meshing task; entries hold weak references (ObjectID), so meshes die naturally when the
+// last block using them unloads and stale entries get pruned lazily.
+// Only used from the main thread, where meshes are built and applied.
+class MeshDedupCache {
+public:
+	// Above this, stale entries get swept before inserting more
+	static const unsigned int PRUNE_THRESHOLD = 4096;
+
+	Ref<ArrayMesh> try_get(uint32_t volume_id, uint64_t content_hash) {
+		const Key key{ content_hash, volume_id };
+		auto it = _map.find(key);
+		if (it == _map.end()) {
+			_miss_count.fetch_add(1, std::memory_order_relaxed);
+			return Ref<ArrayMesh>();
+		}
+		Object *obj = ObjectDB::get_instance(it->second);
+		if (obj == nullptr) {
+			// The last block using that mesh unloaded
+			_map.erase(it);
+			_miss_count.fetch_add(1, std::memory_order_relaxed);
+			return Ref<ArrayMesh>();
+		}
+		_hit_count.fetch_add(1, std::memory_order_relaxed);
+		return Ref<ArrayMesh>(Object::cast_to<ArrayMesh>(obj));
+	}
+
+	void put(uint32_t volume_id, uint64_t content_hash, const Ref<ArrayMesh> &mesh) {
+		ERR_FAIL_COND(mesh.is_null());
+		if (_map.size() >= PRUNE_THRESHOLD) {
+			prune_dead_entries();
+		}
+		const Key key{ content_hash, volume_id };
+		_map[key] = mesh->get_instance_id();
+	}
+
+	// Materials are baked into shared meshes, so a volume changing materials (or going away)
+	// must drop its entries
+	void clear_volume(uint32_t volume_id) {
+		for (auto it = _map.begin(); it != _map.end();) {
+			if (it->first.volume_id == volume_id) {
+				it = _map.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+
+	uint64_t get_hit_count() const {
+		return _hit_count.load(std::memory_order_relaxed);
+	}
+	uint64_t get_miss_count() const {
+		return _miss_count.load(std::memory_order_relaxed);
+	}
+
+private:
+	void prune_dead_entries() {
+		for (auto it = _map.begin(); it != _map.end();) {
+			if (ObjectDB::get_instance(it->second) == nullptr) {
+				it = _map.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+
+	struct Key {
+		uint64_t content_hash;
+		uint32_t volume_id;
+
+		inline bool operator==(const Key &other) const {
+			return content_hash == other.content_hash && volume_id == other.volume_id;
+		}
+	};
+
+	struct KeyHasher {
+		inline size_t operator()(const Key &key) const {
+			return size_t(key.content_hash ^ (uint64_t(key.volume_id) * 0x9e3779b97f4a7c15ull));
+		}
+	};
+
+	std::unordered_map<Key, ObjectID, KeyHasher> _map;
+	std::atomic_uint64_t _hit_count = { 0 };
+	std::atomic_uint64_t _miss_count = { 0 };
+};
+
+} // namespace zylann::voxel
+
+#endif // VOXEL_MESH_DEDUP_CACHE_H
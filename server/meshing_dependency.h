@@ -4,6 +4,8 @@
 #include "../generators/voxel_generator.h"
 #include "../meshers/voxel_mesher.h"
 
+#include <atomic>
+
 namespace zylann::voxel {
 
 // Shared dependency needed by some asynchronous tasks.
@@ -13,7 +15,8 @@ namespace zylann::voxel {
 struct MeshingDependency {
 	Ref<VoxelMesher> mesher;
 	Ref<VoxelGenerator> generator;
-	bool valid = true;
+	// Atomic so meshers can poll it cooperatively mid-build, see `VoxelMesher::Input::validity_flag`
+	std::atomic_bool valid = { true };
 };
 
 } // namespace zylann::voxel
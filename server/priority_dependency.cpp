@@ -10,6 +10,7 @@ int PriorityDependency::evaluate(uint8_t lod_index, float *out_closest_distance_
 	const Vector3 block_position = world_position;
 
 	float closest_distance_sq = 99999.f;
+	size_t closest_viewer_index = 0;
 	if (viewer_positions.size() == 0) {
 		// Assume origin
 		closest_distance_sq = block_position.length_squared();
@@ -18,6 +19,7 @@ int PriorityDependency::evaluate(uint8_t lod_index, float *out_closest_distance_
 			float d = viewer_positions[i].distance_squared_to(block_position);
 			if (d < closest_distance_sq) {
 				closest_distance_sq = d;
+				closest_viewer_index = i;
 			}
 		}
 	}
@@ -29,7 +31,21 @@ int PriorityDependency::evaluate(uint8_t lod_index, float *out_closest_distance_
 	// TODO Any way to optimize out the sqrt?
 	// I added it because the LOD modifier was not working with squared distances,
 	// which led blocks to subdivide too much compared to their neighbors, making cracks more likely to happen
-	int priority = static_cast<int>(Math::sqrt(closest_distance_sq));
+	float distance = Math::sqrt(closest_distance_sq);
+
+	// View-cone weighting: blocks behind the closest viewer rank as if up to twice as far, so
+	// on-screen terrain completes first at equal distance. The factor is bounded so blocks behind
+	// still complete, just later; the periodic priority resort keeps it fresh as the view turns.
+	if (closest_viewer_index < shared->viewer_directions.size() && distance > 0.001f) {
+		const Vector3 view_direction = shared->viewer_directions[closest_viewer_index];
+		if (view_direction != Vector3()) {
+			const float dot =
+					view_direction.dot((block_position - viewer_positions[closest_viewer_index]) / distance);
+			distance *= 1.5f - 0.5f * dot;
+		}
+	}
+
+	int priority = static_cast<int>(distance);
 
 	// TODO Prioritizing LOD makes generation slower... but not prioritizing makes cracks more likely to appear...
 	// This could be fixed by allowing the volume to preemptively request blocks of the next LOD?
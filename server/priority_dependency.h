@@ -17,6 +17,10 @@ struct PriorityDependency {
 		// No resizing should happen concurrently. If it happens, a new instance will be made for future tasks,
 		// while old tasks will keep referencing the previous version.
 		std::vector<Vector3> viewers;
+		// Unit view direction per viewer, index-matched with `viewers`. Zero when unknown
+		// (headless viewers), in which case no view-cone weighting applies. Same relaxed
+		// synchronization as positions: stale values only skew priorities temporarily.
+		std::vector<Vector3> viewer_directions;
 		float highest_view_distance = 999999;
 	};
 
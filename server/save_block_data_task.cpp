@@ -1,10 +1,13 @@
 #include "save_block_data_task.h"
+#include "../util/object_pool.h"
 #include "../storage/voxel_buffer_internal.h"
 #include "../util/log.h"
+#include "../util/memory_accounting.h"
 #include "../util/profiling.h"
 #include "../util/string_funcs.h"
 #include "generate_block_task.h"
 #include "voxel_server.h"
+#include <core/os/time.h>
 
 namespace zylann::voxel {
 
@@ -12,36 +15,59 @@ namespace {
 std::atomic_int g_debug_save_block_tasks_count;
 }
 
-SaveBlockDataTask::SaveBlockDataTask(uint32_t p_volume_id, Vector3i p_block_pos, uint8_t p_lod, uint8_t p_block_size,
-		std::shared_ptr<VoxelBufferInternal> p_voxels, std::shared_ptr<StreamingDependency> p_stream_dependency) :
-		_voxels(p_voxels),
-		_position(p_block_pos),
-		_volume_id(p_volume_id),
-		_lod(p_lod),
-		_block_size(p_block_size),
-		_save_instances(false),
-		_save_voxels(true),
-		_stream_dependency(p_stream_dependency) {
-	//
-	++g_debug_save_block_tasks_count;
+namespace {
+ThreadSafeObjectPool<SaveBlockDataTask> g_task_pool;
 }
 
-SaveBlockDataTask::SaveBlockDataTask(uint32_t p_volume_id, Vector3i p_block_pos, uint8_t p_lod, uint8_t p_block_size,
-		UniquePtr<InstanceBlockData> p_instances, std::shared_ptr<StreamingDependency> p_stream_dependency) :
-		_instances(std::move(p_instances)),
-		_position(p_block_pos),
-		_volume_id(p_volume_id),
-		_lod(p_lod),
-		_block_size(p_block_size),
-		_save_instances(true),
-		_save_voxels(false),
-		_stream_dependency(p_stream_dependency) {
-	//
+// Common part of the `create` functions
+static SaveBlockDataTask *create_task() {
+	SaveBlockDataTask *task = g_task_pool.create();
 	++g_debug_save_block_tasks_count;
+	return task;
+}
+
+SaveBlockDataTask *SaveBlockDataTask::create(uint32_t p_volume_id, Vector3i p_block_pos, uint8_t p_lod,
+		uint8_t p_block_size, std::shared_ptr<VoxelBufferInternal> p_voxels,
+		std::shared_ptr<StreamingDependency> p_stream_dependency, Span<const Box3i> p_delta_boxes) {
+	SaveBlockDataTask *task = create_task();
+	task->_volume_id = p_volume_id;
+	task->_position = p_block_pos;
+	task->_lod = p_lod;
+	task->_block_size = p_block_size;
+	task->_stream_dependency = std::move(p_stream_dependency);
+	task->_scheduled_time_usec = Time::get_singleton()->get_ticks_usec();
+	task->_voxels = std::move(p_voxels);
+	task->_save_voxels = true;
+	ERR_FAIL_COND_V(p_delta_boxes.size() > task->_delta_boxes.size(), task);
+	for (unsigned int i = 0; i < p_delta_boxes.size(); ++i) {
+		task->_delta_boxes[i] = p_delta_boxes[i];
+	}
+	task->_delta_box_count = p_delta_boxes.size();
+	return task;
 }
 
-SaveBlockDataTask::~SaveBlockDataTask() {
+SaveBlockDataTask *SaveBlockDataTask::create(uint32_t p_volume_id, Vector3i p_block_pos, uint8_t p_lod,
+		uint8_t p_block_size, UniquePtr<InstanceBlockData> p_instances,
+		std::shared_ptr<StreamingDependency> p_stream_dependency) {
+	SaveBlockDataTask *task = create_task();
+	task->_volume_id = p_volume_id;
+	task->_position = p_block_pos;
+	task->_lod = p_lod;
+	task->_block_size = p_block_size;
+	task->_stream_dependency = std::move(p_stream_dependency);
+	task->_scheduled_time_usec = Time::get_singleton()->get_ticks_usec();
+	task->_instances = std::move(p_instances);
+	task->_save_instances = true;
+	return task;
+}
+
+void SaveBlockDataTask::dispose() {
 	--g_debug_save_block_tasks_count;
+	g_task_pool.recycle(this);
+}
+
+void SaveBlockDataTask::init() {
+	*this = SaveBlockDataTask();
 }
 
 int SaveBlockDataTask::debug_get_running_count() {
@@ -50,6 +76,7 @@ int SaveBlockDataTask::debug_get_running_count() {
 
 void SaveBlockDataTask::run(zylann::ThreadedTaskContext ctx) {
 	ZN_PROFILE_SCOPE();
+	const uint64_t run_begin_usec = Time::get_singleton()->get_ticks_usec();
 
 	CRASH_COND(_stream_dependency == nullptr);
 	Ref<VoxelStream> stream = _stream_dependency->stream;
@@ -60,14 +87,23 @@ void SaveBlockDataTask::run(zylann::ThreadedTaskContext ctx) {
 		VoxelBufferInternal voxels_copy;
 		{
 			RWLockRead lock(_voxels->get_lock());
-			// TODO Optimization: is that copy necessary? It's possible it was already done while issuing the
-			// request
-			_voxels->duplicate_to(voxels_copy, true);
+			// Copy-on-write snapshot: serialization only reads it, so channel payloads stay shared
+			// unless the source block gets edited before we're done
+			voxels_copy.copy_shared_from(*_voxels, true);
 		}
 		_voxels = nullptr;
 		const Vector3i origin_in_voxels = (_position << _lod) * _block_size;
 		VoxelStream::VoxelQueryData q{ voxels_copy, origin_in_voxels, _lod };
-		stream->save_voxel_block(q);
+		// Timed so production can tell storage latency apart from scheduling problems
+		const uint64_t io_time_before = Time::get_singleton()->get_ticks_usec();
+		if (_delta_box_count > 0 && stream->supports_delta_saves() && stream->is_delta_saves_enabled() &&
+				_stream_dependency->generator.is_valid()) {
+			// Only the journaled regions diverge from generator output, store them as a delta
+			stream->save_voxel_block_delta(q, Span<const Box3i>(_delta_boxes.data(), _delta_box_count));
+		} else {
+			stream->save_voxel_block(q);
+		}
+		stream->record_save_io(_position, _lod, Time::get_singleton()->get_ticks_usec() - io_time_before);
 	}
 
 	if (_save_instances && stream->supports_instance_blocks()) {
@@ -83,6 +119,14 @@ void SaveBlockDataTask::run(zylann::ThreadedTaskContext ctx) {
 	}
 
 	_has_run = true;
+
+	const uint64_t now_usec = Time::get_singleton()->get_ticks_usec();
+	VoxelServer::get_singleton().get_task_latency_stats().record(
+			TaskLatencyStats::TASK_SAVE, now_usec - _scheduled_time_usec);
+	VoxelServer::get_singleton().get_task_runtime_stats().record(TaskLatencyStats::TASK_SAVE,
+			now_usec - run_begin_usec, MemoryAccounting::get_thread_task_peak_bytes());
+	VoxelServer::get_singleton().record_slow_block(
+			TaskLatencyStats::TASK_SAVE, _position, _lod, now_usec - run_begin_usec);
 }
 
 int SaveBlockDataTask::get_priority() {
@@ -9,25 +9,39 @@ namespace zylann::voxel {
 
 class SaveBlockDataTask : public IThreadedTask {
 public:
-	// For saving voxels only
-	SaveBlockDataTask(uint32_t p_volume_id, Vector3i p_block_pos, uint8_t p_lod, uint8_t p_block_size,
-			std::shared_ptr<VoxelBufferInternal> p_voxels, std::shared_ptr<StreamingDependency> p_stream_dependency);
+	// Tasks are pooled, get instances with one of the `create` functions (the default constructor
+	// only exists for the pool). The owner gives them back through `dispose()`.
+	SaveBlockDataTask() {}
+
+	// For saving voxels only. `p_delta_boxes` optionally lists the regions diverging from
+	// generator output, letting supporting streams store a compact delta instead of the block.
+	static SaveBlockDataTask *create(uint32_t p_volume_id, Vector3i p_block_pos, uint8_t p_lod, uint8_t p_block_size,
+			std::shared_ptr<VoxelBufferInternal> p_voxels, std::shared_ptr<StreamingDependency> p_stream_dependency,
+			Span<const Box3i> p_delta_boxes = Span<const Box3i>());
 
 	// For saving instances only
-	SaveBlockDataTask(uint32_t p_volume_id, Vector3i p_block_pos, uint8_t p_lod, uint8_t p_block_size,
+	static SaveBlockDataTask *create(uint32_t p_volume_id, Vector3i p_block_pos, uint8_t p_lod, uint8_t p_block_size,
 			UniquePtr<InstanceBlockData> p_instances, std::shared_ptr<StreamingDependency> p_stream_dependency);
 
-	~SaveBlockDataTask();
-
 	void run(ThreadedTaskContext ctx) override;
 	int get_priority() override;
+	uint32_t get_fair_group() const override {
+		return _volume_id;
+	}
 	bool is_cancelled() override;
 	void apply_result() override;
+	void dispose() override;
+
+	// Resets to a freshly-constructed state, called when recycled into the pool
+	void init();
 
 	static int debug_get_running_count();
 
 private:
 	std::shared_ptr<VoxelBufferInternal> _voxels;
+	// See `create`
+	FixedArray<Box3i, 4> _delta_boxes;
+	uint8_t _delta_box_count = 0;
 	UniquePtr<InstanceBlockData> _instances;
 	Vector3i _position; // In data blocks of the specified lod
 	uint32_t _volume_id;
@@ -37,6 +51,8 @@ private:
 	bool _save_instances = false;
 	bool _save_voxels = false;
 	std::shared_ptr<StreamingDependency> _stream_dependency;
+	// For latency stats
+	uint64_t _scheduled_time_usec = 0;
 };
 
 } // namespace zylann::voxel
@@ -13,6 +13,10 @@ namespace zylann::voxel {
 struct StreamingDependency {
 	Ref<VoxelStream> stream;
 	Ref<VoxelGenerator> generator;
+	// First LOD index at which freshly created data buffers use 8-bit SDF instead of 16-bit,
+	// halving memory of the LOD pyramid; 255 disables the policy. Immutable once shared with
+	// tasks, like the rest of this struct.
+	uint8_t sdf_low_precision_lod_start = 255;
 	bool valid = true;
 };
 
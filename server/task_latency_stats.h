@@ -0,0 +1,98 @@
+#ifndef VOXEL_TASK_LATENCY_STATS_H
+#define VOXEL_TASK_LATENCY_STATS_H
+
+#include "../util/fixed_array.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace zylann::voxel {
+
+// Log-scale latency histograms for streaming tasks, recorded from scheduling to end of execution.
+// Recording is one relaxed atomic increment, cheap enough to stay enabled in production.
+// Percentiles are computed over the samples accumulated since the previous query, so the window
+// rolls at whatever rate a dashboard polls the stats.
+class TaskLatencyStats {
+public:
+	enum TaskType { //
+		TASK_GENERATE = 0,
+		TASK_MESH,
+		TASK_LOAD,
+		TASK_SAVE,
+		TASK_TYPE_COUNT
+	};
+
+	// Power-of-two microsecond bins: bin N counts latencies up to 2^(N+1) microseconds,
+	// the last bin catches everything above ~8 seconds
+	static const unsigned int BIN_COUNT = 24;
+
+	inline void record(TaskType type, uint64_t latency_usec) {
+		unsigned int bin = 0;
+		uint64_t v = latency_usec;
+		while (v > 1 && bin + 1 < BIN_COUNT) {
+			v >>= 1;
+			++bin;
+		}
+		_histograms[type].bins[bin].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	struct Report {
+		uint64_t sample_count = 0;
+		// Upper-bound estimates, constrained by bin resolution
+		uint64_t p50_usec = 0;
+		uint64_t p95_usec = 0;
+		uint64_t p99_usec = 0;
+	};
+
+	// Computes percentile estimates from the samples accumulated since the previous call for this
+	// type, then resets them
+	Report consume_report(TaskType type) {
+		Histogram &histogram = _histograms[type];
+
+		FixedArray<uint32_t, BIN_COUNT> counts;
+		Report report;
+		for (unsigned int i = 0; i < BIN_COUNT; ++i) {
+			counts[i] = histogram.bins[i].exchange(0, std::memory_order_relaxed);
+			report.sample_count += counts[i];
+		}
+		if (report.sample_count == 0) {
+			return report;
+		}
+
+		report.p50_usec = get_percentile_usec(counts, report.sample_count, 50);
+		report.p95_usec = get_percentile_usec(counts, report.sample_count, 95);
+		report.p99_usec = get_percentile_usec(counts, report.sample_count, 99);
+		return report;
+	}
+
+private:
+	static uint64_t get_percentile_usec(
+			const FixedArray<uint32_t, BIN_COUNT> &counts, uint64_t total, unsigned int percent) {
+		// Index of the first sample at or above the percentile, in sorted order
+		const uint64_t target_rank = (total * percent + 99) / 100;
+		uint64_t cumulative = 0;
+		for (unsigned int i = 0; i < BIN_COUNT; ++i) {
+			cumulative += counts[i];
+			if (cumulative >= target_rank) {
+				return uint64_t(1) << (i + 1);
+			}
+		}
+		return uint64_t(1) << BIN_COUNT;
+	}
+
+	struct Histogram {
+		FixedArray<std::atomic_uint32_t, BIN_COUNT> bins;
+
+		Histogram() {
+			for (unsigned int i = 0; i < BIN_COUNT; ++i) {
+				bins[i].store(0, std::memory_order_relaxed);
+			}
+		}
+	};
+
+	FixedArray<Histogram, TASK_TYPE_COUNT> _histograms;
+};
+
+} // namespace zylann::voxel
+
+#endif // VOXEL_TASK_LATENCY_STATS_H
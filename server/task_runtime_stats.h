@@ -0,0 +1,75 @@
+#ifndef VOXEL_TASK_RUNTIME_STATS_H
+#define VOXEL_TASK_RUNTIME_STATS_H
+
+#include "task_latency_stats.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace zylann::voxel {
+
+// Per-task-type execution cost aggregation, complementing `TaskLatencyStats` (which measures
+// scheduling-to-completion). Tasks report their run duration and the peak categorized allocation
+// the worker observed while they ran (see `MemoryAccounting`), so when a worker blows past memory
+// limits the stats tell whether meshing, generation or serialization did it. Recording is a few
+// relaxed atomic updates, cheap enough to stay enabled in production. Like the latency stats,
+// reports cover the window since the previous query.
+class TaskRuntimeStats {
+public:
+	inline void record(TaskLatencyStats::TaskType type, uint64_t run_usec, uint64_t peak_alloc_bytes) {
+		Entry &entry = _entries[type];
+		entry.count.fetch_add(1, std::memory_order_relaxed);
+		entry.run_usec_total.fetch_add(run_usec, std::memory_order_relaxed);
+		entry.peak_alloc_total.fetch_add(peak_alloc_bytes, std::memory_order_relaxed);
+		update_max(entry.run_usec_max, run_usec);
+		update_max(entry.peak_alloc_max, peak_alloc_bytes);
+	}
+
+	struct Report {
+		uint64_t sample_count = 0;
+		uint64_t mean_run_usec = 0;
+		uint64_t max_run_usec = 0;
+		uint64_t mean_peak_alloc_bytes = 0;
+		uint64_t max_peak_alloc_bytes = 0;
+	};
+
+	// Computes aggregates from the samples accumulated since the previous call for this type,
+	// then resets them
+	Report consume_report(TaskLatencyStats::TaskType type) {
+		Entry &entry = _entries[type];
+		Report report;
+		report.sample_count = entry.count.exchange(0, std::memory_order_relaxed);
+		const uint64_t run_total = entry.run_usec_total.exchange(0, std::memory_order_relaxed);
+		const uint64_t alloc_total = entry.peak_alloc_total.exchange(0, std::memory_order_relaxed);
+		report.max_run_usec = entry.run_usec_max.exchange(0, std::memory_order_relaxed);
+		report.max_peak_alloc_bytes = entry.peak_alloc_max.exchange(0, std::memory_order_relaxed);
+		if (report.sample_count > 0) {
+			report.mean_run_usec = run_total / report.sample_count;
+			report.mean_peak_alloc_bytes = alloc_total / report.sample_count;
+		}
+		return report;
+	}
+
+private:
+	static inline void update_max(std::atomic_uint64_t &dst, uint64_t value) {
+		// Racy max update, losing one once in a while only makes the maximum slightly
+		// conservative
+		uint64_t current = dst.load(std::memory_order_relaxed);
+		while (value > current && !dst.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+		}
+	}
+
+	struct Entry {
+		std::atomic_uint64_t count = { 0 };
+		std::atomic_uint64_t run_usec_total = { 0 };
+		std::atomic_uint64_t run_usec_max = { 0 };
+		std::atomic_uint64_t peak_alloc_total = { 0 };
+		std::atomic_uint64_t peak_alloc_max = { 0 };
+	};
+
+	Entry _entries[TaskLatencyStats::TASK_TYPE_COUNT];
+};
+
+} // namespace zylann::voxel
+
+#endif // VOXEL_TASK_RUNTIME_STATS_H
@@ -0,0 +1,270 @@
+#include "viewer_trace.h"
+#include "../util/log.h"
+#include "../util/string_funcs.h"
+#include "voxel_server.h"
+
+#include <core/io/file_access.h>
+#include <core/os/time.h>
+
+namespace zylann::voxel {
+
+namespace {
+const char *TRACE_MAGIC = "ZNVR";
+const uint8_t TRACE_VERSION = 1;
+} // namespace
+
+void ViewerTrace::start_recording() {
+	_events.clear();
+	_recording = true;
+	_recording_start_msec = Time::get_singleton()->get_ticks_msec();
+}
+
+bool ViewerTrace::stop_recording(const String &fpath) {
+	_recording = false;
+
+	Error err;
+	Ref<FileAccess> f = FileAccess::open(fpath, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V(f.is_null(), false);
+
+	f->store_buffer(reinterpret_cast<const uint8_t *>(TRACE_MAGIC), 4);
+	f->store_8(TRACE_VERSION);
+	f->store_32(_events.size());
+
+	for (unsigned int i = 0; i < _events.size(); ++i) {
+		const Event &event = _events[i];
+		f->store_32(event.time_msec);
+		f->store_8(event.type);
+		f->store_32(event.viewer_id);
+		switch (event.type) {
+			case EVENT_POSITION:
+			case EVENT_DIRECTION:
+				f->store_float(event.vector.x);
+				f->store_float(event.vector.y);
+				f->store_float(event.vector.z);
+				break;
+			case EVENT_VIEW_DISTANCE:
+			case EVENT_COLLISION_DISTANCE:
+			case EVENT_FLAGS:
+				f->store_32(event.value);
+				break;
+			default:
+				break;
+		}
+	}
+
+	ZN_PRINT_VERBOSE(format("Saved viewer trace with {} events", _events.size()));
+	_events.clear();
+	return true;
+}
+
+void ViewerTrace::push_event(const Event &event) {
+	_events.push_back(event);
+}
+
+void ViewerTrace::record_add_viewer(uint32_t viewer_id) {
+	Event e{};
+	e.time_msec = uint32_t(Time::get_singleton()->get_ticks_msec() - _recording_start_msec);
+	e.type = EVENT_ADD_VIEWER;
+	e.viewer_id = viewer_id;
+	push_event(e);
+}
+
+void ViewerTrace::record_remove_viewer(uint32_t viewer_id) {
+	Event e{};
+	e.time_msec = uint32_t(Time::get_singleton()->get_ticks_msec() - _recording_start_msec);
+	e.type = EVENT_REMOVE_VIEWER;
+	e.viewer_id = viewer_id;
+	push_event(e);
+}
+
+void ViewerTrace::record_position(uint32_t viewer_id, Vector3 position) {
+	Event e{};
+	e.time_msec = uint32_t(Time::get_singleton()->get_ticks_msec() - _recording_start_msec);
+	e.type = EVENT_POSITION;
+	e.viewer_id = viewer_id;
+	e.vector = position;
+	push_event(e);
+}
+
+void ViewerTrace::record_direction(uint32_t viewer_id, Vector3 direction) {
+	Event e{};
+	e.time_msec = uint32_t(Time::get_singleton()->get_ticks_msec() - _recording_start_msec);
+	e.type = EVENT_DIRECTION;
+	e.viewer_id = viewer_id;
+	e.vector = direction;
+	push_event(e);
+}
+
+void ViewerTrace::record_view_distance(uint32_t viewer_id, uint32_t distance) {
+	Event e{};
+	e.time_msec = uint32_t(Time::get_singleton()->get_ticks_msec() - _recording_start_msec);
+	e.type = EVENT_VIEW_DISTANCE;
+	e.viewer_id = viewer_id;
+	e.value = distance;
+	push_event(e);
+}
+
+void ViewerTrace::record_collision_distance(uint32_t viewer_id, uint32_t distance) {
+	Event e{};
+	e.time_msec = uint32_t(Time::get_singleton()->get_ticks_msec() - _recording_start_msec);
+	e.type = EVENT_COLLISION_DISTANCE;
+	e.viewer_id = viewer_id;
+	e.value = distance;
+	push_event(e);
+}
+
+void ViewerTrace::record_flags(uint32_t viewer_id, bool require_visuals, bool require_collisions) {
+	Event e{};
+	e.time_msec = uint32_t(Time::get_singleton()->get_ticks_msec() - _recording_start_msec);
+	e.type = EVENT_FLAGS;
+	e.viewer_id = viewer_id;
+	e.value = (require_visuals ? 1 : 0) | (require_collisions ? 2 : 0);
+	push_event(e);
+}
+
+bool ViewerTrace::start_replay(const String &fpath) {
+	Error err;
+	Ref<FileAccess> f = FileAccess::open(fpath, FileAccess::READ, &err);
+	ERR_FAIL_COND_V_MSG(f.is_null(), false, String("Could not open viewer trace {0}").format(varray(fpath)));
+
+	char magic[5] = { 0 };
+	ERR_FAIL_COND_V(f->get_buffer(reinterpret_cast<uint8_t *>(magic), 4) != 4, false);
+	ERR_FAIL_COND_V(strcmp(magic, TRACE_MAGIC) != 0, false);
+	ERR_FAIL_COND_V(f->get_8() != TRACE_VERSION, false);
+
+	const uint32_t event_count = f->get_32();
+	_events.clear();
+	_events.reserve(event_count);
+
+	for (uint32_t i = 0; i < event_count; ++i) {
+		Event e{};
+		e.time_msec = f->get_32();
+		e.type = f->get_8();
+		e.viewer_id = f->get_32();
+		switch (e.type) {
+			case EVENT_POSITION:
+			case EVENT_DIRECTION:
+				e.vector.x = f->get_float();
+				e.vector.y = f->get_float();
+				e.vector.z = f->get_float();
+				break;
+			case EVENT_VIEW_DISTANCE:
+			case EVENT_COLLISION_DISTANCE:
+			case EVENT_FLAGS:
+				e.value = f->get_32();
+				break;
+			case EVENT_ADD_VIEWER:
+			case EVENT_REMOVE_VIEWER:
+				break;
+			default:
+				ERR_FAIL_V_MSG(false, "Corrupted viewer trace");
+		}
+		ERR_FAIL_COND_V(f->eof_reached() && i + 1 != event_count, false);
+		_events.push_back(e);
+	}
+
+	_replaying = true;
+	_replay_cursor = 0;
+	_replay_start_msec = 0;
+	_replay_viewer_ids.clear();
+	println(format("Replaying viewer trace with {} events", _events.size()));
+	return true;
+}
+
+bool ViewerTrace::process_replay(VoxelServer &server, uint64_t now_msec) {
+	if (!_replaying) {
+		return false;
+	}
+	if (_replay_start_msec == 0) {
+		_replay_start_msec = now_msec;
+		// Also consumes the rolling latency windows, so the final report covers the replay span
+		const VoxelServer::Stats initial_stats = server.get_stats();
+		_initial_executed_general = initial_stats.general.executed_tasks;
+		_initial_executed_streaming = initial_stats.streaming.executed_tasks;
+	}
+
+	const uint64_t elapsed = now_msec - _replay_start_msec;
+
+	while (_replay_cursor < _events.size() && _events[_replay_cursor].time_msec <= elapsed) {
+		const Event &event = _events[_replay_cursor];
+		++_replay_cursor;
+
+		switch (event.type) {
+			case EVENT_ADD_VIEWER:
+				_replay_viewer_ids[event.viewer_id] = server.add_viewer();
+				break;
+
+			default: {
+				auto it = _replay_viewer_ids.find(event.viewer_id);
+				if (it == _replay_viewer_ids.end()) {
+					// Trace can start mid-session; viewers unseen by an ADD get created lazily
+					it = _replay_viewer_ids.insert({ event.viewer_id, server.add_viewer() }).first;
+				}
+				const uint32_t live_id = it->second;
+				switch (event.type) {
+					case EVENT_REMOVE_VIEWER:
+						server.remove_viewer(live_id);
+						_replay_viewer_ids.erase(event.viewer_id);
+						break;
+					case EVENT_POSITION:
+						server.set_viewer_position(live_id, event.vector);
+						break;
+					case EVENT_DIRECTION:
+						server.set_viewer_direction(live_id, event.vector);
+						break;
+					case EVENT_VIEW_DISTANCE:
+						server.set_viewer_distance(live_id, event.value);
+						break;
+					case EVENT_COLLISION_DISTANCE:
+						server.set_viewer_collision_distance(live_id, event.value);
+						break;
+					case EVENT_FLAGS:
+						server.set_viewer_requires_visuals(live_id, (event.value & 1) != 0);
+						server.set_viewer_requires_collisions(live_id, (event.value & 2) != 0);
+						break;
+					default:
+						break;
+				}
+			} break;
+		}
+	}
+
+	if (_replay_cursor >= _events.size()) {
+		print_replay_report(server, now_msec);
+		// Remove viewers the trace left behind so the world stops streaming
+		for (auto it = _replay_viewer_ids.begin(); it != _replay_viewer_ids.end(); ++it) {
+			server.remove_viewer(it->second);
+		}
+		_replay_viewer_ids.clear();
+		_replaying = false;
+		_events.clear();
+		return false;
+	}
+	return true;
+}
+
+void ViewerTrace::print_replay_report(VoxelServer &server, uint64_t now_msec) {
+	const VoxelServer::Stats stats = server.get_stats();
+	const uint64_t elapsed_msec = now_msec - _replay_start_msec;
+	const double elapsed_seconds = math::max(double(elapsed_msec) / 1000.0, 0.001);
+
+	const uint64_t general_tasks = stats.general.executed_tasks - _initial_executed_general;
+	const uint64_t streaming_tasks = stats.streaming.executed_tasks - _initial_executed_streaming;
+
+	println("---- Voxel replay report ----");
+	println(format("Duration: {} ms", elapsed_msec));
+	println(format("General tasks executed: {} ({} per second)", general_tasks,
+			uint64_t(general_tasks / elapsed_seconds)));
+	println(format("Streaming tasks executed: {} ({} per second)", streaming_tasks,
+			uint64_t(streaming_tasks / elapsed_seconds)));
+
+	const char *latency_names[TaskLatencyStats::TASK_TYPE_COUNT] = { "generate", "mesh", "load", "save" };
+	for (unsigned int i = 0; i < TaskLatencyStats::TASK_TYPE_COUNT; ++i) {
+		const TaskLatencyStats::Report &report = stats.task_latencies[i];
+		println(format("{} latency: samples={} p50={}us p95={}us p99={}us", latency_names[i], report.sample_count,
+				report.p50_usec, report.p95_usec, report.p99_usec));
+	}
+	println("-----------------------------");
+}
+
+} // namespace zylann::voxel
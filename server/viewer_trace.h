@@ -0,0 +1,91 @@
+#ifndef VOXEL_VIEWER_TRACE_H
+#define VOXEL_VIEWER_TRACE_H
+
+#include <core/math/vector3.h>
+#include <core/string/ustring.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace zylann::voxel {
+
+class VoxelServer;
+
+// Record/replay of viewer event streams, for reproducing streaming workloads deterministically.
+// Recording captures every viewer mutation (add, remove, position, direction, distances, flags)
+// with millisecond timestamps into a compact binary file. Replaying feeds the same sequence back
+// into the live VoxelServer at the recorded pace, driving the real task pipeline; when the trace
+// ends, a summary with task throughput and latency percentiles is printed. Block requests are
+// not recorded: the pipeline derives them from viewer state, so replaying viewers reproduces
+// them. Works headless with `--voxel-replay=path/to/trace` on the command line.
+// All methods run on the main thread.
+class ViewerTrace {
+public:
+	enum EventType : uint8_t {
+		EVENT_ADD_VIEWER = 0,
+		EVENT_REMOVE_VIEWER,
+		EVENT_POSITION,
+		EVENT_DIRECTION,
+		EVENT_VIEW_DISTANCE,
+		EVENT_COLLISION_DISTANCE,
+		EVENT_FLAGS
+	};
+
+	// Recording
+
+	void start_recording();
+	bool is_recording() const {
+		return _recording;
+	}
+	// Writes the recorded stream and stops recording. Returns false on I/O failure.
+	bool stop_recording(const String &fpath);
+
+	void record_add_viewer(uint32_t viewer_id);
+	void record_remove_viewer(uint32_t viewer_id);
+	void record_position(uint32_t viewer_id, Vector3 position);
+	void record_direction(uint32_t viewer_id, Vector3 direction);
+	void record_view_distance(uint32_t viewer_id, uint32_t distance);
+	void record_collision_distance(uint32_t viewer_id, uint32_t distance);
+	void record_flags(uint32_t viewer_id, bool require_visuals, bool require_collisions);
+
+	// Replaying
+
+	// Loads a trace and arms the replay; events start applying on the next `process_replay`.
+	bool start_replay(const String &fpath);
+	bool is_replaying() const {
+		return _replaying;
+	}
+	// Applies all events due at this time. Returns false when the trace ended (after printing
+	// the summary report).
+	bool process_replay(VoxelServer &server, uint64_t now_msec);
+
+private:
+	struct Event {
+		uint32_t time_msec;
+		uint8_t type;
+		uint32_t viewer_id;
+		Vector3 vector;
+		uint32_t value;
+	};
+
+	void push_event(const Event &event);
+	void print_replay_report(VoxelServer &server, uint64_t now_msec);
+
+	bool _recording = false;
+	uint64_t _recording_start_msec = 0;
+	std::vector<Event> _events;
+
+	bool _replaying = false;
+	uint64_t _replay_start_msec = 0;
+	size_t _replay_cursor = 0;
+	// Recorded viewer ids mapped to the live ids created during replay
+	std::unordered_map<uint32_t, uint32_t> _replay_viewer_ids;
+	// Pool executed-task counters at replay start, for throughput deltas
+	uint64_t _initial_executed_general = 0;
+	uint64_t _initial_executed_streaming = 0;
+};
+
+} // namespace zylann::voxel
+
+#endif // VOXEL_VIEWER_TRACE_H
@@ -3,8 +3,11 @@
 #include "../storage/voxel_memory_pool.h"
 #include "../util/log.h"
 #include "../util/macros.h"
+#include "../util/memory_accounting.h"
+#include "../util/math/conv.h"
 #include "../util/profiling.h"
 #include "../util/string_funcs.h"
+#include "generate_block_batch_task.h"
 #include "generate_block_task.h"
 #include "load_all_blocks_data_task.h"
 #include "load_block_data_task.h"
@@ -12,6 +15,10 @@
 #include "save_block_data_task.h"
 
 #include <core/config/project_settings.h>
+#include <core/os/os.h>
+#include <core/os/time.h>
+
+#include <algorithm>
 
 namespace zylann::voxel {
 
@@ -55,10 +62,48 @@ VoxelServer::VoxelServer() {
 	ProjectSettings::get_singleton()->set_custom_property_info("voxel/threads/count/ratio_over_max",
 			PropertyInfo(Variant::FLOAT, "voxel/threads/count/ratio_over_max", PROPERTY_HINT_RANGE, "0,1,0.1"));
 
+	GLOBAL_DEF_RST("voxel/threads/pin_to_cores", false);
+	ProjectSettings::get_singleton()->set_custom_property_info("voxel/threads/pin_to_cores",
+			PropertyInfo(Variant::BOOL, "voxel/threads/pin_to_cores"));
+
+	// Adapts pool batching and priority polling online from measured task costs,
+	// see `ThreadedTaskRunner::auto_tune`
+	GLOBAL_DEF_RST("voxel/threads/auto_tuning", true);
+	ProjectSettings::get_singleton()->set_custom_property_info("voxel/threads/auto_tuning",
+			PropertyInfo(Variant::BOOL, "voxel/threads/auto_tuning"));
+
 	GLOBAL_DEF_RST("voxel/threads/main/time_budget_ms", 8);
 	ProjectSettings::get_singleton()->set_custom_property_info("voxel/threads/main/time_budget_ms",
 			PropertyInfo(Variant::INT, "voxel/threads/main/time_budget_ms", PROPERTY_HINT_RANGE, "0,1000"));
 
+	// Hugepage-backed slabs for voxel buffer memory; cuts dTLB misses on dense-world servers,
+	// but slab memory is never returned to the OS. See `VoxelMemoryPool::set_slab_backing_enabled`
+	GLOBAL_DEF_RST("voxel/memory/use_huge_pages", false);
+	ProjectSettings::get_singleton()->set_custom_property_info("voxel/memory/use_huge_pages",
+			PropertyInfo(Variant::BOOL, "voxel/memory/use_huge_pages"));
+	if (ProjectSettings::get_singleton()->get("voxel/memory/use_huge_pages")) {
+		VoxelMemoryPool::get_singleton().set_slab_backing_enabled(true);
+	}
+
+	// Total memory budget for voxel data (buffers, pooled free blocks and compressed caches).
+	// 0 disables the governor. Mainly for memory-constrained platforms (consoles, mobile).
+	GLOBAL_DEF_RST("voxel/memory/budget_mb", 0);
+	ProjectSettings::get_singleton()->set_custom_property_info("voxel/memory/budget_mb",
+			PropertyInfo(Variant::INT, "voxel/memory/budget_mb", PROPERTY_HINT_RANGE, "0,16384"));
+
+	_memory_budget_bytes = size_t(math::max(0, int(ProjectSettings::get_singleton()->get("voxel/memory/budget_mb")))) *
+			1024 * 1024;
+
+	// Caps how many streamed load tasks can be in flight per volume; excess requests wait as
+	// tiny descriptors and get admitted as slots free. Bounds memory and tail latency when
+	// storage is slow. 0 disables the cap.
+	GLOBAL_DEF_RST("voxel/streaming/max_inflight_loads_per_volume", 256);
+	ProjectSettings::get_singleton()->set_custom_property_info("voxel/streaming/max_inflight_loads_per_volume",
+			PropertyInfo(Variant::INT, "voxel/streaming/max_inflight_loads_per_volume", PROPERTY_HINT_RANGE,
+					"0,65536"));
+	_max_inflight_loads_per_volume = math::max(
+			0, int(ProjectSettings::get_singleton()->get("voxel/streaming/max_inflight_loads_per_volume")));
+
 	_main_thread_time_budget_usec =
 			1000 * int(ProjectSettings::get_singleton()->get("voxel/threads/main/time_budget_ms"));
 
@@ -91,15 +136,51 @@ VoxelServer::VoxelServer() {
 	// Batching is only to give a chance for file I/O tasks to be grouped and reduce open/close calls.
 	// But in the end it might be better to move this idea to the tasks themselves?
 	_streaming_thread_pool.set_batch_count(16);
+	// Several volumes can share this pool's single FIFO; fair grouping keeps one volume's bulk
+	// load from starving another's saves
+	_streaming_thread_pool.set_fair_grouping_enabled(true);
+
+	// Pinning workers to cores keeps their queues and thread-local buffers on the local memory
+	// node, which matters on multi-socket hosts. Off by default, as games sharing the machine with
+	// other heavy threads usually prefer the scheduler to balance.
+	const bool pin_threads = ProjectSettings::get_singleton()->get("voxel/threads/pin_to_cores");
 
 	_general_thread_pool.set_name("Voxel general");
+	// Generation/meshing bursts enqueue lots of short tasks, a shared queue lock doesn't scale there.
+	// Must be set before threads are created.
+	_general_thread_pool.set_work_stealing_enabled(true);
+	// A reserved worker subset keeps nearby updates responsive under generation bursts,
+	// see IThreadedTask::get_qos_class
+	_general_thread_pool.set_qos_reservation_enabled(true);
+	_general_thread_pool.set_thread_pinning_enabled(pin_threads);
+	// With a dedicated refresh thread, workers never run priority evaluations while holding a
+	// queue lock; teleports leaving tens of thousands of queued tasks no longer stall the pool
+	// on the periodic resort
+	_general_thread_pool.set_priority_refresh_thread_enabled(true);
 	_general_thread_pool.set_thread_count(thread_count);
 	_general_thread_pool.set_priority_update_period(200);
 	_general_thread_pool.set_batch_count(1);
+	// These are starting points when auto-tuning is on; the workload mix (cheap blocky vs
+	// expensive graph generation) decides the rest at runtime. The streaming pool keeps manual
+	// batching, its value exists to group file I/O, not to balance CPU cost.
+	_general_thread_pool.set_auto_tuning_enabled(ProjectSettings::get_singleton()->get("voxel/threads/auto_tuning"));
+
+	// Headless workload replay, see ViewerTrace
+	{
+		const List<String> args = OS::get_singleton()->get_cmdline_args();
+		for (const List<String>::Element *e = args.front(); e != nullptr; e = e->next()) {
+			const String &arg = e->get();
+			if (arg.begins_with("--voxel-replay=")) {
+				_pending_replay_path = arg.substr(String("--voxel-replay=").length());
+			}
+		}
+	}
 
 	// Init world
 	_world.shared_priority_dependency = make_shared_instance<PriorityDependency::ViewersData>();
 
+	_telemetry.configure_from_project_settings();
+
 	ZN_PRINT_VERBOSE(format("Size of LoadBlockDataTask: {}", sizeof(LoadBlockDataTask)));
 	ZN_PRINT_VERBOSE(format("Size of SaveBlockDataTask: {}", sizeof(SaveBlockDataTask)));
 	ZN_PRINT_VERBOSE(format("Size of MeshBlockTask: {}", sizeof(MeshBlockTask)));
@@ -126,7 +207,7 @@ void VoxelServer::wait_and_clear_all_tasks(bool warn) {
 			WARN_PRINT("Streaming tasks remain on module cleanup, "
 					   "this could become a problem if they reference scripts");
 		}
-		memdelete(task);
+		task->dispose();
 	});
 
 	_general_thread_pool.dequeue_completed_tasks([warn](zylann::IThreadedTask *task) {
@@ -134,7 +215,7 @@ void VoxelServer::wait_and_clear_all_tasks(bool warn) {
 			WARN_PRINT("General tasks remain on module cleanup, "
 					   "this could become a problem if they reference scripts");
 		}
-		memdelete(task);
+		task->dispose();
 	});
 }
 
@@ -163,6 +244,9 @@ void VoxelServer::set_volume_data_block_size(uint32_t volume_id, uint32_t block_
 }
 
 void VoxelServer::set_volume_stream(uint32_t volume_id, Ref<VoxelStream> stream) {
+	// Cached evicted blocks no longer match the new source of data
+	_cold_block_cache.clear_volume(volume_id);
+
 	Volume &volume = _world.volumes.get(volume_id);
 	volume.stream = stream;
 
@@ -177,6 +261,8 @@ void VoxelServer::set_volume_stream(uint32_t volume_id, Ref<VoxelStream> stream)
 }
 
 void VoxelServer::set_volume_generator(uint32_t volume_id, Ref<VoxelGenerator> generator) {
+	_cold_block_cache.clear_volume(volume_id);
+
 	Volume &volume = _world.volumes.get(volume_id);
 	volume.generator = generator;
 
@@ -216,6 +302,25 @@ void VoxelServer::set_volume_octree_lod_distance(uint32_t volume_id, float lod_d
 	volume.octree_lod_distance = lod_distance;
 }
 
+void VoxelServer::set_volume_debug_block_counts(uint32_t volume_id, uint32_t data_blocks, uint32_t mesh_blocks) {
+	Volume &volume = _world.volumes.get(volume_id);
+	volume.debug_data_block_count = data_blocks;
+	volume.debug_mesh_block_count = mesh_blocks;
+}
+
+Array VoxelServer::debug_get_per_volume_info() const {
+	Array volumes_info;
+	_world.volumes.for_each_with_id([&volumes_info](const Volume &volume, uint32_t id) {
+		Dictionary d;
+		d["id"] = id;
+		d["type"] = volume.type == VOLUME_SPARSE_OCTREE ? "sparse_octree" : "sparse_grid";
+		d["data_blocks"] = volume.debug_data_block_count;
+		d["mesh_blocks"] = volume.debug_mesh_block_count;
+		volumes_info.append(d);
+	});
+	return volumes_info;
+}
+
 void VoxelServer::invalidate_volume_mesh_requests(uint32_t volume_id) {
 	Volume &volume = _world.volumes.get(volume_id);
 	volume.meshing_dependency->valid = false;
@@ -270,12 +375,17 @@ void VoxelServer::request_block_mesh(uint32_t volume_id, const BlockMeshInput &i
 	ERR_FAIL_COND(volume.meshing_dependency->mesher.is_null());
 	ERR_FAIL_COND(volume.data_block_size > 255);
 
-	MeshBlockTask *task = memnew(MeshBlockTask);
+	MeshBlockTask *task = MeshBlockTask::create();
 	task->volume_id = volume_id;
 	task->blocks = input.data_blocks;
 	task->blocks_count = input.data_blocks_count;
 	task->position = input.render_block_position;
 	task->lod = input.lod;
+	task->dirty_box = input.dirty_box;
+	task->has_dirty_box = input.has_dirty_box;
+	task->collision_hint = input.collision_hint;
+	task->collision_simplify_distance = input.collision_simplify_distance;
+	task->transition_sides_mask = input.transition_sides_mask;
 	task->meshing_dependency = volume.meshing_dependency;
 	task->data_block_size = volume.data_block_size;
 
@@ -286,17 +396,72 @@ void VoxelServer::request_block_mesh(uint32_t volume_id, const BlockMeshInput &i
 	_general_thread_pool.enqueue(task);
 }
 
-void VoxelServer::request_block_load(uint32_t volume_id, Vector3i block_pos, int lod, bool request_instances) {
+void VoxelServer::request_block_loads(
+		uint32_t volume_id, Span<const Vector3i> block_positions, int lod, bool request_instances) {
+	if (block_positions.size() == 0) {
+		return;
+	}
 	const Volume &volume = _world.volumes.get(volume_id);
 	ERR_FAIL_COND(volume.stream_dependency == nullptr);
+
+	if (volume.stream_dependency->stream.is_valid()) {
+		// Streams load per block
+		for (unsigned int i = 0; i < block_positions.size(); ++i) {
+			request_block_load(volume_id, block_positions[i], lod, request_instances);
+		}
+		return;
+	}
+
+	ERR_FAIL_COND(volume.stream_dependency->generator.is_null());
+	ERR_FAIL_COND(volume.data_block_size > 255);
+
+	// Generator only: group nearby blocks so one task generates several of them. Callers send
+	// positions roughly in scan order, so consecutive entries are close to each other.
+	for (unsigned int begin = 0; begin < block_positions.size(); begin += GenerateBlockBatchTask::MAX_BLOCKS) {
+		const unsigned int count =
+				math::min(unsigned(GenerateBlockBatchTask::MAX_BLOCKS), unsigned(block_positions.size() - begin));
+
+		GenerateBlockBatchTask *task = GenerateBlockBatchTask::create();
+		task->volume_id = volume_id;
+		task->lod = lod;
+		task->block_size = volume.data_block_size;
+		task->stream_dependency = volume.stream_dependency;
+
+		Vector3i position_sum;
+		for (unsigned int i = 0; i < count; ++i) {
+			const Vector3i block_pos = block_positions[begin + i];
+			task->blocks[i].position = block_pos;
+			position_sum += block_pos;
+		}
+		task->blocks_count = count;
+
+		const Vector3i center_block_pos = position_sum / int(count);
+		init_priority_dependency(task->priority_dependency, center_block_pos, lod, volume, volume.data_block_size);
+
+		_general_thread_pool.enqueue(task);
+	}
+}
+
+void VoxelServer::request_block_load(uint32_t volume_id, Vector3i block_pos, int lod, bool request_instances) {
+	Volume &volume = _world.volumes.get(volume_id);
+	ERR_FAIL_COND(volume.stream_dependency == nullptr);
 	ERR_FAIL_COND(volume.data_block_size > 255);
 
 	if (volume.stream_dependency->stream.is_valid()) {
+		if (_max_inflight_loads_per_volume > 0 && volume.inflight_load_count >= _max_inflight_loads_per_volume) {
+			// Over the in-flight cap: bounded queue with late admission beats piling up full
+			// tasks. The descriptor is re-checked against viewer state when its turn comes.
+			volume.deferred_loads.push_back(Volume::DeferredLoad{ block_pos, uint8_t(lod), request_instances });
+			return;
+		}
+
 		PriorityDependency priority_dependency;
 		init_priority_dependency(priority_dependency, block_pos, lod, volume, volume.data_block_size);
 
-		LoadBlockDataTask *task = memnew(LoadBlockDataTask(volume_id, block_pos, lod, volume.data_block_size,
-				request_instances, volume.stream_dependency, priority_dependency));
+		LoadBlockDataTask *task = LoadBlockDataTask::create(volume_id, block_pos, lod, volume.data_block_size,
+				request_instances, volume.stream_dependency, priority_dependency);
+		task->set_counted_for_admission(true);
+		++volume.inflight_load_count;
 
 		_streaming_thread_pool.enqueue(task);
 
@@ -304,7 +469,7 @@ void VoxelServer::request_block_load(uint32_t volume_id, Vector3i block_pos, int
 		// Directly generate the block without checking the stream
 		ERR_FAIL_COND(volume.stream_dependency->generator.is_null());
 
-		GenerateBlockTask *task = memnew(GenerateBlockTask);
+		GenerateBlockTask *task = GenerateBlockTask::create();
 		task->volume_id = volume_id;
 		task->position = block_pos;
 		task->lod = lod;
@@ -317,13 +482,60 @@ void VoxelServer::request_block_load(uint32_t volume_id, Vector3i block_pos, int
 	}
 }
 
+void VoxelServer::on_streamed_load_finished(uint32_t volume_id) {
+	Volume *volume = _world.volumes.try_get(volume_id);
+	if (volume == nullptr) {
+		// The volume was removed while its loads were in flight
+		return;
+	}
+	if (volume->inflight_load_count > 0) {
+		--volume->inflight_load_count;
+	}
+
+	// Admit deferred requests into the freed slots, oldest first. Entries whose block left every
+	// viewer's range while waiting are shed with a regular dropped response, so volumes unmark
+	// them and can re-request if they come back in range.
+	while (volume->deferred_loads.size() > 0 &&
+			(_max_inflight_loads_per_volume == 0 ||
+					volume->inflight_load_count < _max_inflight_loads_per_volume)) {
+		const Volume::DeferredLoad deferred = volume->deferred_loads.front();
+		volume->deferred_loads.pop_front();
+
+		PriorityDependency priority_dependency;
+		init_priority_dependency(
+				priority_dependency, deferred.position, deferred.lod, *volume, volume->data_block_size);
+
+		LoadBlockDataTask *task = LoadBlockDataTask::create(volume_id, deferred.position, deferred.lod,
+				volume->data_block_size, deferred.request_instances, volume->stream_dependency, priority_dependency);
+
+		// Evaluates viewer distance, which also updates the cancellation state
+		task->get_priority();
+		if (task->is_cancelled()) {
+			// Left every viewer's range while deferred; deliver the standard dropped response
+			++_shed_load_request_count;
+			task->apply_result();
+			task->dispose();
+			// `volume` may have been invalidated by the callback re-entering the server
+			volume = _world.volumes.try_get(volume_id);
+			if (volume == nullptr) {
+				return;
+			}
+			continue;
+		}
+
+		task->set_counted_for_admission(true);
+		++volume->inflight_load_count;
+		_streaming_thread_pool.enqueue(task);
+	}
+}
+
 void VoxelServer::request_block_generate(
 		uint32_t volume_id, Vector3i block_pos, int lod, std::shared_ptr<zylann::AsyncDependencyTracker> tracker) {
 	//
 	const Volume &volume = _world.volumes.get(volume_id);
 	ERR_FAIL_COND(volume.stream_dependency->generator.is_null());
 
-	GenerateBlockTask *task = memnew(GenerateBlockTask);
+	GenerateBlockTask *task = GenerateBlockTask::create();
 	task->volume_id = volume_id;
 	task->position = block_pos;
 	task->lod = lod;
@@ -357,8 +569,8 @@ void VoxelServer::request_voxel_block_save(
 	ERR_FAIL_COND(volume.stream.is_null());
 	CRASH_COND(volume.stream_dependency == nullptr);
 
-	SaveBlockDataTask *task = memnew(
-			SaveBlockDataTask(volume_id, block_pos, lod, volume.data_block_size, voxels, volume.stream_dependency));
+	SaveBlockDataTask *task = SaveBlockDataTask::create(
+			volume_id, block_pos, lod, volume.data_block_size, voxels, volume.stream_dependency);
 
 	// No priority data, saving doesnt need sorting
 
@@ -371,8 +583,8 @@ void VoxelServer::request_instance_block_save(
 	ERR_FAIL_COND(volume.stream.is_null());
 	CRASH_COND(volume.stream_dependency == nullptr);
 
-	SaveBlockDataTask *task = memnew(SaveBlockDataTask(
-			volume_id, block_pos, lod, volume.data_block_size, std::move(instances), volume.stream_dependency));
+	SaveBlockDataTask *task = SaveBlockDataTask::create(
+			volume_id, block_pos, lod, volume.data_block_size, std::move(instances), volume.stream_dependency);
 
 	// No priority data, saving doesnt need sorting
 
@@ -380,6 +592,9 @@ void VoxelServer::request_instance_block_save(
 }
 
 void VoxelServer::remove_volume(uint32_t volume_id) {
+	_generated_block_cache.clear_volume(volume_id);
+	_mesh_dedup_cache.clear_volume(volume_id);
+	_cold_block_cache.clear_volume(volume_id);
 	{
 		Volume &volume = _world.volumes.get(volume_id);
 		if (volume.stream_dependency != nullptr) {
@@ -405,21 +620,55 @@ bool VoxelServer::is_volume_valid(uint32_t volume_id) const {
 }
 
 uint32_t VoxelServer::add_viewer() {
-	return _world.viewers.create(Viewer());
+	++_viewers_state_version;
+	const uint32_t viewer_id = _world.viewers.create(Viewer());
+	if (_viewer_trace.is_recording()) {
+		_viewer_trace.record_add_viewer(viewer_id);
+	}
+	return viewer_id;
 }
 
 void VoxelServer::remove_viewer(uint32_t viewer_id) {
+	if (_viewer_trace.is_recording()) {
+		_viewer_trace.record_remove_viewer(viewer_id);
+	}
+
+	++_viewers_state_version;
 	_world.viewers.destroy(viewer_id);
 }
 
 void VoxelServer::set_viewer_position(uint32_t viewer_id, Vector3 position) {
+	if (_viewer_trace.is_recording()) {
+		_viewer_trace.record_position(viewer_id, position);
+	}
 	Viewer &viewer = _world.viewers.get(viewer_id);
 	viewer.world_position = position;
+	// Terrains only care about movement at block granularity, so the version only changes when the
+	// viewer crosses a block boundary. Priorities keep using the exact position.
+	const Vector3i quantized_position = math::floor_to_int(position) >> constants::DEFAULT_BLOCK_SIZE_PO2;
+	if (quantized_position != viewer.quantized_position) {
+		viewer.quantized_position = quantized_position;
+		++_viewers_state_version;
+	}
+}
+
+void VoxelServer::set_viewer_direction(uint32_t viewer_id, Vector3 direction) {
+	if (_viewer_trace.is_recording()) {
+		_viewer_trace.record_direction(viewer_id, direction);
+	}
+	Viewer &viewer = _world.viewers.get(viewer_id);
+	viewer.view_direction = direction;
 }
 
 void VoxelServer::set_viewer_distance(uint32_t viewer_id, unsigned int distance) {
+	if (_viewer_trace.is_recording()) {
+		_viewer_trace.record_view_distance(viewer_id, distance);
+	}
 	Viewer &viewer = _world.viewers.get(viewer_id);
-	viewer.view_distance = distance;
+	if (distance != viewer.view_distance) {
+		viewer.view_distance = distance;
+		++_viewers_state_version;
+	}
 }
 
 unsigned int VoxelServer::get_viewer_distance(uint32_t viewer_id) const {
@@ -429,7 +678,13 @@ unsigned int VoxelServer::get_viewer_distance(uint32_t viewer_id) const {
 
 void VoxelServer::set_viewer_requires_visuals(uint32_t viewer_id, bool enabled) {
 	Viewer &viewer = _world.viewers.get(viewer_id);
-	viewer.require_visuals = enabled;
+	if (_viewer_trace.is_recording()) {
+		_viewer_trace.record_flags(viewer_id, enabled, viewer.require_collisions);
+	}
+	if (enabled != viewer.require_visuals) {
+		viewer.require_visuals = enabled;
+		++_viewers_state_version;
+	}
 }
 
 bool VoxelServer::is_viewer_requiring_visuals(uint32_t viewer_id) const {
@@ -439,7 +694,13 @@ bool VoxelServer::is_viewer_requiring_visuals(uint32_t viewer_id) const {
 
 void VoxelServer::set_viewer_requires_collisions(uint32_t viewer_id, bool enabled) {
 	Viewer &viewer = _world.viewers.get(viewer_id);
-	viewer.require_collisions = enabled;
+	if (_viewer_trace.is_recording()) {
+		_viewer_trace.record_flags(viewer_id, viewer.require_visuals, enabled);
+	}
+	if (enabled != viewer.require_collisions) {
+		viewer.require_collisions = enabled;
+		++_viewers_state_version;
+	}
 }
 
 bool VoxelServer::is_viewer_requiring_collisions(uint32_t viewer_id) const {
@@ -447,9 +708,28 @@ bool VoxelServer::is_viewer_requiring_collisions(uint32_t viewer_id) const {
 	return viewer.require_collisions;
 }
 
+void VoxelServer::set_viewer_collision_distance(uint32_t viewer_id, unsigned int distance) {
+	if (_viewer_trace.is_recording()) {
+		_viewer_trace.record_collision_distance(viewer_id, distance);
+	}
+	Viewer &viewer = _world.viewers.get(viewer_id);
+	if (distance != viewer.collision_distance) {
+		viewer.collision_distance = distance;
+		++_viewers_state_version;
+	}
+}
+
+unsigned int VoxelServer::get_viewer_collision_distance(uint32_t viewer_id) const {
+	const Viewer &viewer = _world.viewers.get(viewer_id);
+	return viewer.collision_distance;
+}
+
 void VoxelServer::set_viewer_requires_data_block_notifications(uint32_t viewer_id, bool enabled) {
 	Viewer &viewer = _world.viewers.get(viewer_id);
-	viewer.requires_data_block_notifications = enabled;
+	if (enabled != viewer.requires_data_block_notifications) {
+		viewer.requires_data_block_notifications = enabled;
+		++_viewers_state_version;
+	}
 }
 
 bool VoxelServer::is_viewer_requiring_data_block_notifications(uint32_t viewer_id) const {
@@ -471,8 +751,30 @@ bool VoxelServer::viewer_exists(uint32_t viewer_id) const {
 	return _world.viewers.is_valid(viewer_id);
 }
 
-void VoxelServer::push_main_thread_time_spread_task(zylann::ITimeSpreadTask *task) {
-	_time_spread_task_runner.push(task);
+void VoxelServer::push_main_thread_time_spread_task(
+		zylann::ITimeSpreadTask *task, TimeSpreadTaskRunner::Priority priority) {
+	_time_spread_task_runner.push(task, priority);
+}
+
+TimeSpreadTaskRunner::Priority VoxelServer::get_main_thread_time_spread_priority(Vector3 world_position) const {
+	const PriorityDependency::ViewersData &viewers_data = *_world.shared_priority_dependency;
+	if (viewers_data.viewers.size() == 0) {
+		return TimeSpreadTaskRunner::PRIORITY_NORMAL;
+	}
+	float closest_distance_sq = Math_INF;
+	for (unsigned int i = 0; i < viewers_data.viewers.size(); ++i) {
+		closest_distance_sq = math::min(closest_distance_sq, //
+				float(world_position.distance_squared_to(viewers_data.viewers[i])));
+	}
+	// Same space as `PriorityDependency`: thresholds relative to the largest view distance
+	const float view_distance = viewers_data.highest_view_distance;
+	if (closest_distance_sq < math::squared(view_distance * 0.25f)) {
+		return TimeSpreadTaskRunner::PRIORITY_HIGH;
+	}
+	if (closest_distance_sq < math::squared(view_distance * 0.5f)) {
+		return TimeSpreadTaskRunner::PRIORITY_NORMAL;
+	}
+	return TimeSpreadTaskRunner::PRIORITY_LOW;
 }
 
 void VoxelServer::push_main_thread_progressive_task(zylann::IProgressiveTask *task) {
@@ -499,8 +801,80 @@ void VoxelServer::push_async_io_tasks(Span<zylann::IThreadedTask *> tasks) {
 	_streaming_thread_pool.enqueue(tasks);
 }
 
+void VoxelServer::add_block_processing_stage(std::shared_ptr<IBlockProcessingStage> stage) {
+	ERR_FAIL_COND(stage == nullptr);
+	MutexLock lock(_block_processing_stages_mutex);
+	_block_processing_stages.push_back(stage);
+}
+
+void VoxelServer::clear_block_processing_stages() {
+	MutexLock lock(_block_processing_stages_mutex);
+	_block_processing_stages.clear();
+}
+
+void VoxelServer::apply_block_processing_stages(
+		VoxelBufferInternal &voxels, Vector3i origin_in_voxels, uint8_t lod, uint32_t volume_id) {
+	// Copy the list so stages can run without holding the lock; registration is rare
+	static thread_local std::vector<std::shared_ptr<IBlockProcessingStage>> tls_stages;
+	{
+		MutexLock lock(_block_processing_stages_mutex);
+		if (_block_processing_stages.size() == 0) {
+			return;
+		}
+		tls_stages = _block_processing_stages;
+	}
+	ZN_PROFILE_SCOPE();
+
+	// Stable per-block randomness: FNV-1a over absolute position and LOD
+	uint64_t seed = 0xcbf29ce484222325ull;
+	const int64_t coords[4] = { origin_in_voxels.x, origin_in_voxels.y, origin_in_voxels.z, lod };
+	for (unsigned int i = 0; i < 4; ++i) {
+		const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&coords[i]);
+		for (unsigned int j = 0; j < sizeof(int64_t); ++j) {
+			seed = (seed ^ bytes[j]) * 0x100000001b3ull;
+		}
+	}
+
+	IBlockProcessingStage::Context ctx{ voxels, origin_in_voxels, lod, volume_id, seed };
+	for (unsigned int i = 0; i < tls_stages.size(); ++i) {
+		tls_stages[i]->process(ctx);
+	}
+	tls_stages.clear();
+}
+
+void VoxelServer::push_synchronous_update_join(ObjectID object_id, void (*callback)(Object &object)) {
+	_synchronous_update_joins.push_back(SynchronousUpdateJoin{ object_id, callback });
+}
+
 void VoxelServer::process() {
 	ZN_PROFILE_SCOPE();
+
+	// Armed on first process so terrain volumes exist by the time events apply
+	if (!_pending_replay_path.is_empty()) {
+		_viewer_trace.start_replay(_pending_replay_path);
+		_pending_replay_path = String();
+	}
+	if (_viewer_trace.is_replaying()) {
+		_viewer_trace.process_replay(*this, Time::get_singleton()->get_ticks_msec());
+	}
+
+	// Join volume updates submitted during scene processing. Their tasks have been running
+	// concurrently on the pool since each volume's `_process`; waiting here pays only for the
+	// slowest one. Must run before task outputs are applied below, so results reach their nodes
+	// within the same frame.
+	if (_synchronous_update_joins.size() > 0) {
+		ZN_PROFILE_SCOPE_NAMED("Join synchronous volume updates");
+		for (unsigned int i = 0; i < _synchronous_update_joins.size(); ++i) {
+			const SynchronousUpdateJoin &join = _synchronous_update_joins[i];
+			Object *obj = ObjectDB::get_instance(join.object_id);
+			if (obj == nullptr) {
+				// The volume's node was freed during the frame
+				continue;
+			}
+			join.callback(*obj);
+		}
+		_synchronous_update_joins.clear();
+	}
 	ZN_PROFILE_PLOT("Static memory usage", int64_t(OS::get_singleton()->get_static_memory_usage()));
 	ZN_PROFILE_PLOT("TimeSpread tasks", int64_t(_time_spread_task_runner.get_pending_count()));
 	ZN_PROFILE_PLOT("Progressive tasks", int64_t(_progressive_task_runner.get_pending_count()));
@@ -508,21 +882,62 @@ void VoxelServer::process() {
 	// Receive data updates
 	_streaming_thread_pool.dequeue_completed_tasks([](zylann::IThreadedTask *task) {
 		task->apply_result();
-		memdelete(task);
+		task->dispose();
 	});
 
 	// Receive generation and meshing results
 	_general_thread_pool.dequeue_completed_tasks([](zylann::IThreadedTask *task) {
 		task->apply_result();
-		memdelete(task);
+		task->dispose();
 	});
 
 	// Run this after dequeueing threaded tasks, because they can add some to this runner,
 	// which could in turn complete right away (we avoid 1-frame delays this way).
-	_time_spread_task_runner.process(_main_thread_time_budget_usec);
+	{
+		// Overshoot (one heavy task can exceed the budget despite prediction) is carried over as
+		// debt and paid back by shrinking following budgets, by at most half so queues keep
+		// progressing. This way a spike costs quieter frames instead of stacking on a busy one.
+		const uint64_t base_budget_usec = _main_thread_time_budget_usec;
+		const uint64_t repaid_usec = math::min(_main_thread_budget_debt_usec, base_budget_usec / 2);
+		const uint64_t budget_usec = base_budget_usec - repaid_usec;
+		const uint64_t spent_usec = _time_spread_task_runner.process(budget_usec);
+		_main_thread_budget_debt_usec -= repaid_usec;
+		if (spent_usec > budget_usec) {
+			_main_thread_budget_debt_usec += spent_usec - budget_usec;
+		}
+		// Under sustained overload, debt beyond a few frames' worth carries no useful signal and
+		// would keep budgets halved long after the burst ends
+		_main_thread_budget_debt_usec = math::min(_main_thread_budget_debt_usec, 4 * base_budget_usec);
+	}
 
 	_progressive_task_runner.process();
 
+	_telemetry.process(*this);
+
+	// Adapt pool batching to the current workload, no-op when auto-tuning is off
+	_general_thread_pool.auto_tune();
+
+	// Memory governor: when over budget, give back the cheapest memory first (compressed cold
+	// blocks, then pooled free blocks), and leave the pressure flag up if that wasn't enough so
+	// volumes degrade their resident data instead of letting the process OOM
+	if (_memory_budget_bytes > 0) {
+		size_t total_memory =
+				VoxelMemoryPool::get_singleton().debug_get_total_memory() + _cold_block_cache.get_total_bytes();
+		if (total_memory > _memory_budget_bytes) {
+			const size_t overage = total_memory - _memory_budget_bytes;
+			const size_t cold_bytes = _cold_block_cache.get_total_bytes();
+			_cold_block_cache.shrink_to(cold_bytes - math::min(cold_bytes, overage));
+			// Under pressure, keeping free blocks pooled for later re-use is a luxury; this trades
+			// some allocation churn for actually returning memory to the OS
+			VoxelMemoryPool::get_singleton().clear_unused_blocks();
+			total_memory =
+					VoxelMemoryPool::get_singleton().debug_get_total_memory() + _cold_block_cache.get_total_bytes();
+		}
+		_memory_over_budget = total_memory > _memory_budget_bytes;
+	} else {
+		_memory_over_budget = false;
+	}
+
 	// Update viewer dependencies
 	{
 		const size_t viewer_count = _world.viewers.count();
@@ -530,11 +945,13 @@ void VoxelServer::process() {
 			// TODO We can avoid the invalidation by using an atomic size or memory barrier?
 			_world.shared_priority_dependency = make_shared_instance<PriorityDependency::ViewersData>();
 			_world.shared_priority_dependency->viewers.resize(viewer_count);
+			_world.shared_priority_dependency->viewer_directions.resize(viewer_count);
 		}
 		size_t i = 0;
 		unsigned int max_distance = 0;
 		_world.viewers.for_each([&i, &max_distance, this](Viewer &viewer) {
 			_world.shared_priority_dependency->viewers[i] = viewer.world_position;
+			_world.shared_priority_dependency->viewer_directions[i] = viewer.view_direction;
 			if (viewer.view_distance > max_distance) {
 				max_distance = viewer.view_distance;
 			}
@@ -563,6 +980,9 @@ static VoxelServer::Stats::ThreadPoolStats debug_get_pool_stats(const zylann::Th
 	d.tasks = pool.get_debug_remaining_tasks();
 	d.active_threads = debug_get_active_thread_count(pool);
 	d.thread_count = pool.get_thread_count();
+	d.executed_tasks = pool.get_executed_task_count();
+	d.dropped_tasks = pool.get_dropped_task_count();
+	d.starved_tasks = pool.get_starved_task_count();
 	return d;
 }
 
@@ -576,28 +996,212 @@ Dictionary VoxelServer::Stats::to_dict() {
 	tasks["generation"] = generation_tasks;
 	tasks["meshing"] = meshing_tasks;
 	tasks["main_thread"] = main_thread_tasks;
+	tasks["deduplicated"] = ZN_SIZE_T_TO_VARIANT(deduplicated_tasks);
 
 	// This part is additional for scripts because VoxelMemoryPool is not exposed
 	Dictionary mem;
 	mem["voxel_total"] = ZN_SIZE_T_TO_VARIANT(VoxelMemoryPool::get_singleton().debug_get_total_memory());
 	mem["voxel_used"] = ZN_SIZE_T_TO_VARIANT(VoxelMemoryPool::get_singleton().debug_get_used_memory());
 	mem["block_count"] = VoxelMemoryPool::get_singleton().debug_get_used_blocks();
+	mem["budget"] = ZN_SIZE_T_TO_VARIANT(memory_budget_bytes);
+	mem["over_budget"] = memory_over_budget;
+
+	// Per-subsystem attribution for OOM triage, see MemoryAccounting
+	Dictionary categories;
+	for (unsigned int i = 0; i < MemoryAccounting::CATEGORY_COUNT; ++i) {
+		const MemoryAccounting::Category category = MemoryAccounting::Category(i);
+		const MemoryAccounting::Report report = MemoryAccounting::get_singleton().get_report(category);
+		Dictionary cd;
+		cd["current"] = ZN_SIZE_T_TO_VARIANT(report.current);
+		cd["peak"] = ZN_SIZE_T_TO_VARIANT(report.peak);
+		categories[MemoryAccounting::get_category_name(category)] = cd;
+	}
+	mem["categories"] = categories;
+
+	const char *latency_names[TaskLatencyStats::TASK_TYPE_COUNT] = { "generate", "mesh", "load", "save" };
+	Dictionary latencies;
+	for (unsigned int i = 0; i < TaskLatencyStats::TASK_TYPE_COUNT; ++i) {
+		const TaskLatencyStats::Report &report = task_latencies[i];
+		Dictionary ld;
+		ld["samples"] = report.sample_count;
+		ld["p50_usec"] = report.p50_usec;
+		ld["p95_usec"] = report.p95_usec;
+		ld["p99_usec"] = report.p99_usec;
+		latencies[latency_names[i]] = ld;
+	}
+
+	Dictionary runtimes;
+	for (unsigned int i = 0; i < TaskLatencyStats::TASK_TYPE_COUNT; ++i) {
+		const TaskRuntimeStats::Report &report = task_runtimes[i];
+		Dictionary rd;
+		rd["samples"] = report.sample_count;
+		rd["mean_run_usec"] = report.mean_run_usec;
+		rd["max_run_usec"] = report.max_run_usec;
+		rd["mean_peak_alloc_bytes"] = report.mean_peak_alloc_bytes;
+		rd["max_peak_alloc_bytes"] = report.max_peak_alloc_bytes;
+		runtimes[latency_names[i]] = rd;
+	}
+
+	Dictionary caches;
+	caches["generated_block_hits"] = generated_block_cache_hits;
+	caches["generated_block_misses"] = generated_block_cache_misses;
+	caches["mesh_dedup_hits"] = ZN_SIZE_T_TO_VARIANT(mesh_dedup_hits);
+	caches["mesh_dedup_misses"] = ZN_SIZE_T_TO_VARIANT(mesh_dedup_misses);
+	caches["cold_block_hits"] = ZN_SIZE_T_TO_VARIANT(cold_block_cache_hits);
+	caches["cold_block_misses"] = ZN_SIZE_T_TO_VARIANT(cold_block_cache_misses);
+	caches["cold_block_bytes"] = ZN_SIZE_T_TO_VARIANT(cold_block_cache_bytes);
+
+	Dictionary streaming_io;
+	streaming_io["shed_load_requests"] = int64_t(shed_load_requests);
+	streaming_io["deferred_load_backlog"] = int64_t(deferred_load_backlog);
+	streaming_io["load_count"] = ZN_SIZE_T_TO_VARIANT(stream_load_count);
+	streaming_io["load_time_total_usec"] = ZN_SIZE_T_TO_VARIANT(stream_load_time_total_usec);
+	streaming_io["load_time_max_usec"] = ZN_SIZE_T_TO_VARIANT(stream_load_time_max_usec);
+	streaming_io["save_count"] = ZN_SIZE_T_TO_VARIANT(stream_save_count);
+	streaming_io["save_time_total_usec"] = ZN_SIZE_T_TO_VARIANT(stream_save_time_total_usec);
+	streaming_io["save_time_max_usec"] = ZN_SIZE_T_TO_VARIANT(stream_save_time_max_usec);
+	streaming_io["slow_op_count"] = ZN_SIZE_T_TO_VARIANT(stream_slow_op_count);
+
+	const char *lane_names[TimeSpreadTaskRunner::PRIORITY_COUNT] = { "high", "normal", "low" };
+	Dictionary main_thread_lanes_dict;
+	for (unsigned int i = 0; i < TimeSpreadTaskRunner::PRIORITY_COUNT; ++i) {
+		const MainThreadLaneStats &lane = main_thread_lanes[i];
+		Dictionary lane_dict;
+		lane_dict["pending"] = lane.pending;
+		lane_dict["time_spent_usec"] = ZN_SIZE_T_TO_VARIANT(lane.time_spent_usec);
+		lane_dict["mean_task_time_usec"] = lane.mean_task_time_usec;
+		main_thread_lanes_dict[lane_names[i]] = lane_dict;
+	}
 
 	Dictionary d;
 	d["thread_pools"] = pools;
 	d["tasks"] = tasks;
 	d["memory_pools"] = mem;
+	// Percentiles cover the window since stats were last queried
+	d["task_latencies"] = latencies;
+	d["task_runtimes"] = runtimes;
+	d["caches"] = caches;
+	d["main_thread_lanes"] = main_thread_lanes_dict;
+	d["streaming_io"] = streaming_io;
 	return d;
 }
 
+void VoxelServer::record_slow_block(TaskLatencyStats::TaskType type, Vector3i position, uint8_t lod,
+		uint32_t time_usec) {
+	// The floor stays 0 until the list fills up, so this lock-free check only rejects entries
+	// once the list can actually turn them away
+	if (time_usec <= _slow_block_floor_usec.load(std::memory_order_relaxed)) {
+		return;
+	}
+	MutexLock lock(_slow_block_records_mutex);
+	unsigned int target_index = _slow_block_record_count;
+	if (_slow_block_record_count == SLOW_BLOCK_RECORD_COUNT) {
+		// Replace the current minimum
+		target_index = 0;
+		for (unsigned int i = 1; i < SLOW_BLOCK_RECORD_COUNT; ++i) {
+			if (_slow_block_records[i].time_usec < _slow_block_records[target_index].time_usec) {
+				target_index = i;
+			}
+		}
+		if (time_usec <= _slow_block_records[target_index].time_usec) {
+			return;
+		}
+	} else {
+		++_slow_block_record_count;
+	}
+	SlowBlockRecord &record = _slow_block_records[target_index];
+	record.position = position;
+	record.time_usec = time_usec;
+	record.lod = lod;
+	record.task_type = type;
+	if (_slow_block_record_count == SLOW_BLOCK_RECORD_COUNT) {
+		uint32_t floor_usec = _slow_block_records[0].time_usec;
+		for (unsigned int i = 1; i < SLOW_BLOCK_RECORD_COUNT; ++i) {
+			floor_usec = math::min(floor_usec, _slow_block_records[i].time_usec);
+		}
+		_slow_block_floor_usec.store(floor_usec, std::memory_order_relaxed);
+	}
+}
+
+void VoxelServer::consume_slow_block_records(std::vector<SlowBlockRecord> &out_records) {
+	MutexLock lock(_slow_block_records_mutex);
+	out_records.clear();
+	for (unsigned int i = 0; i < _slow_block_record_count; ++i) {
+		out_records.push_back(_slow_block_records[i]);
+	}
+	_slow_block_record_count = 0;
+	_slow_block_floor_usec.store(0, std::memory_order_relaxed);
+}
+
+unsigned int VoxelServer::cancel_stale_tasks() {
+	return _general_thread_pool.cancel_stale_tasks();
+}
+
 VoxelServer::Stats VoxelServer::get_stats() const {
 	Stats s;
 	s.streaming = debug_get_pool_stats(_streaming_thread_pool);
 	s.general = debug_get_pool_stats(_general_thread_pool);
-	s.generation_tasks = GenerateBlockTask::debug_get_running_count();
+	s.generation_tasks =
+			GenerateBlockTask::debug_get_running_count() + GenerateBlockBatchTask::debug_get_running_count();
 	s.meshing_tasks = GenerateBlockTask::debug_get_running_count();
 	s.streaming_tasks = LoadBlockDataTask::debug_get_running_count() + SaveBlockDataTask::debug_get_running_count();
 	s.main_thread_tasks = _time_spread_task_runner.get_pending_count() + _progressive_task_runner.get_pending_count();
+	for (unsigned int i = 0; i < TaskLatencyStats::TASK_TYPE_COUNT; ++i) {
+		s.task_latencies[i] = _task_latency_stats.consume_report(TaskLatencyStats::TaskType(i));
+	}
+	for (unsigned int i = 0; i < TaskLatencyStats::TASK_TYPE_COUNT; ++i) {
+		s.task_runtimes[i] = _task_runtime_stats.consume_report(TaskLatencyStats::TaskType(i));
+	}
+	s.generated_block_cache_hits = _generated_block_cache.get_hit_count();
+	s.generated_block_cache_misses = _generated_block_cache.get_miss_count();
+	s.deduplicated_tasks = _in_flight_task_registry.get_deduplicated_count();
+	s.shed_load_requests = _shed_load_request_count;
+	s.deferred_load_backlog = 0;
+	_world.volumes.for_each([&s](const Volume &volume) { //
+		s.deferred_load_backlog += volume.deferred_loads.size();
+	});
+	s.mesh_dedup_hits = _mesh_dedup_cache.get_hit_count();
+	s.mesh_dedup_misses = _mesh_dedup_cache.get_miss_count();
+	s.cold_block_cache_hits = _cold_block_cache.get_hit_count();
+	s.cold_block_cache_misses = _cold_block_cache.get_miss_count();
+	s.cold_block_cache_bytes = _cold_block_cache.get_total_bytes();
+	s.memory_budget_bytes = _memory_budget_bytes;
+	s.memory_over_budget = _memory_over_budget;
+	s.stream_load_count = 0;
+	s.stream_load_time_total_usec = 0;
+	s.stream_load_time_max_usec = 0;
+	s.stream_save_count = 0;
+	s.stream_save_time_total_usec = 0;
+	s.stream_save_time_max_usec = 0;
+	s.stream_slow_op_count = 0;
+	{
+		// Aggregate per-stream I/O stats; a stream shared by several volumes only counts once
+		std::vector<const VoxelStream *> seen_streams;
+		_world.volumes.for_each_with_id([&s, &seen_streams](const Volume &volume, uint32_t id) {
+			const VoxelStream *stream = volume.stream.ptr();
+			if (stream == nullptr ||
+					std::find(seen_streams.begin(), seen_streams.end(), stream) != seen_streams.end()) {
+				return;
+			}
+			seen_streams.push_back(stream);
+			const VoxelStream::IoStats &io = stream->get_io_stats();
+			s.stream_load_count += io.load_count.load(std::memory_order_relaxed);
+			s.stream_load_time_total_usec += io.load_time_total_usec.load(std::memory_order_relaxed);
+			s.stream_load_time_max_usec =
+					math::max(s.stream_load_time_max_usec, io.load_time_max_usec.load(std::memory_order_relaxed));
+			s.stream_save_count += io.save_count.load(std::memory_order_relaxed);
+			s.stream_save_time_total_usec += io.save_time_total_usec.load(std::memory_order_relaxed);
+			s.stream_save_time_max_usec =
+					math::max(s.stream_save_time_max_usec, io.save_time_max_usec.load(std::memory_order_relaxed));
+			s.stream_slow_op_count += io.slow_op_count.load(std::memory_order_relaxed);
+		});
+	}
+	for (unsigned int i = 0; i < TimeSpreadTaskRunner::PRIORITY_COUNT; ++i) {
+		const TimeSpreadTaskRunner::Priority priority = TimeSpreadTaskRunner::Priority(i);
+		s.main_thread_lanes[i].pending = _time_spread_task_runner.get_pending_count(priority);
+		s.main_thread_lanes[i].time_spent_usec = _time_spread_task_runner.get_lane_time_spent_usec(priority);
+		s.main_thread_lanes[i].mean_task_time_usec = _time_spread_task_runner.get_lane_mean_task_time_usec(priority);
+	}
 	return s;
 }
 
@@ -10,10 +10,22 @@
 #include "../util/tasks/progressive_task_runner.h"
 #include "../util/tasks/threaded_task_runner.h"
 #include "../util/tasks/time_spread_task_runner.h"
+#include "block_processing_stage.h"
+#include "cold_block_cache.h"
+#include "viewer_trace.h"
+#include "generated_block_cache.h"
+#include "in_flight_task_registry.h"
+#include "mesh_dedup_cache.h"
 #include "meshing_dependency.h"
 #include "priority_dependency.h"
 #include "streaming_dependency.h"
+#include "task_latency_stats.h"
+#include "task_runtime_stats.h"
+#include "voxel_telemetry.h"
 
+#include <servers/rendering_server.h>
+
+#include <deque>
 #include <memory>
 
 namespace zylann {
@@ -34,8 +46,25 @@ public:
 
 		Type type;
 		VoxelMesher::Output surfaces;
+		// Main surfaces pre-packed into the RenderingServer's native buffer layout on the worker,
+		// so applying only issues the upload instead of unpacking Variants and packing vertices on
+		// the main thread. Parallel to non-empty triangulated entries of `surfaces.surfaces`;
+		// `src_index` maps back to the original surface (for per-surface materials).
+		struct PackedSurface {
+			RenderingServer::SurfaceData data;
+			uint16_t src_index = 0;
+		};
+		std::vector<PackedSurface> packed_surfaces;
 		Vector3i position;
 		uint8_t lod;
+		// Triangle soup for the collision shape, cooked on the worker when the request had
+		// `collision_hint` set. The main thread only has to create the shape from it.
+		PackedVector3Array collision_shape_faces;
+		bool has_collision_shape_faces = false;
+		// Hash of the produced surfaces, for mesh deduplication (0 when not computed)
+		uint64_t content_hash = 0;
+		// Which transition sides were built, per the request's `transition_sides_mask`
+		uint8_t built_transition_sides_mask = 0xff;
 	};
 
 	struct BlockDataOutput {
@@ -54,6 +83,9 @@ public:
 		bool max_lod_hint;
 		// Blocks with this flag set should not be ignored
 		bool initial_load;
+		// When the block was reconstructed from a delta save, regions diverging from generator
+		// output (lets the volume keep journaling edits for future delta saves)
+		std::vector<Box3i> delta_boxes;
 	};
 
 	struct BlockMeshInput {
@@ -62,6 +94,20 @@ public:
 		unsigned int data_blocks_count = 0;
 		Vector3i render_block_position;
 		uint8_t lod = 0;
+		// Optional region (in voxels at the request's LOD) outside which data did not change since
+		// the previous mesh request for this block. Lets incremental meshers skip unchanged cells.
+		Box3i dirty_box;
+		bool has_dirty_box = false;
+		// When set, the task also cooks the collision triangle soup from the produced surfaces,
+		// so the main thread doesn't have to
+		bool collision_hint = false;
+		// When non-zero, collision triangles of blocks farther than this distance from the
+		// closest viewer get decimated on the worker before cooking, see `MeshBlockTask`
+		float collision_simplify_distance = 0.f;
+		// Transition sides to build for meshers supporting LOD transitions. Volumes knowing which
+		// sides are displayed can request only those; missing sides trigger a remesh if they get
+		// enabled later.
+		uint8_t transition_sides_mask = 0xff;
 	};
 
 	struct VolumeCallbacks {
@@ -85,7 +131,15 @@ public:
 		// 	FLAGS_COUNT = 3
 		// };
 		Vector3 world_position;
+		// Unit view direction, used to weight task priorities toward on-screen terrain.
+		// Zero when the viewer doesn't provide one.
+		Vector3 view_direction;
+		// Position quantized to block granularity, so stationary viewers can be detected cheaply.
+		// See `get_viewers_state_version`.
+		Vector3i quantized_position;
 		unsigned int view_distance = 128;
+		// Distance beyond which this viewer doesn't need collisions (0 = same as view distance)
+		unsigned int collision_distance = 0;
 		bool require_collisions = true;
 		bool require_visuals = true;
 		bool requires_data_block_notifications = false;
@@ -113,10 +167,21 @@ public:
 	void set_volume_mesher(uint32_t volume_id, Ref<VoxelMesher> mesher);
 	VolumeCallbacks get_volume_callbacks(uint32_t volume_id) const;
 	void set_volume_octree_lod_distance(uint32_t volume_id, float lod_distance);
+	// Diagnostics gauges shown in telemetry, reported by terrain nodes every process
+	void set_volume_debug_block_counts(uint32_t volume_id, uint32_t data_blocks, uint32_t mesh_blocks);
 	void invalidate_volume_mesh_requests(uint32_t volume_id);
 	void request_block_mesh(uint32_t volume_id, const BlockMeshInput &input);
+	// Variant of `request_block_load` taking several block positions at once. When the volume has
+	// no stream (generator only), nearby positions are grouped into batch generation tasks, which
+	// amortizes per-task and per-block setup costs. Positions should come roughly in scan order.
+	void request_block_loads(
+			uint32_t volume_id, Span<const Vector3i> block_positions, int lod, bool request_instances);
 	// TODO Add parameter to skip stream loading
 	void request_block_load(uint32_t volume_id, Vector3i block_pos, int lod, bool request_instances);
+
+	// Called by finished streamed load tasks (main thread), frees an admission slot and admits
+	// deferred requests
+	void on_streamed_load_finished(uint32_t volume_id);
 	void request_block_generate(
 			uint32_t volume_id, Vector3i block_pos, int lod, std::shared_ptr<AsyncDependencyTracker> tracker);
 	void request_all_stream_blocks(uint32_t volume_id);
@@ -134,26 +199,43 @@ public:
 	uint32_t add_viewer();
 	void remove_viewer(uint32_t viewer_id);
 	void set_viewer_position(uint32_t viewer_id, Vector3 position);
+	// Doesn't bump the viewers state version: direction changes every frame and doesn't affect
+	// which blocks are viewed, only the order tasks complete in
+	void set_viewer_direction(uint32_t viewer_id, Vector3 direction);
 	void set_viewer_distance(uint32_t viewer_id, unsigned int distance);
 	unsigned int get_viewer_distance(uint32_t viewer_id) const;
 	void set_viewer_requires_visuals(uint32_t viewer_id, bool enabled);
 	bool is_viewer_requiring_visuals(uint32_t viewer_id) const;
 	void set_viewer_requires_collisions(uint32_t viewer_id, bool enabled);
 	bool is_viewer_requiring_collisions(uint32_t viewer_id) const;
+	void set_viewer_collision_distance(uint32_t viewer_id, unsigned int distance);
+	unsigned int get_viewer_collision_distance(uint32_t viewer_id) const;
 	void set_viewer_requires_data_block_notifications(uint32_t viewer_id, bool enabled);
 	bool is_viewer_requiring_data_block_notifications(uint32_t viewer_id) const;
 	void set_viewer_network_peer_id(uint32_t viewer_id, int peer_id);
 	int get_viewer_network_peer_id(uint32_t viewer_id) const;
 	bool viewer_exists(uint32_t viewer_id) const;
 
+	// Increments whenever something observable about viewers changes: pairing, flags, view
+	// distance, or position at block granularity. Terrains compare it to what they last processed
+	// and skip their whole view-box diffing when nothing moved, which is the common steady state.
+	uint64_t get_viewers_state_version() const {
+		return _viewers_state_version;
+	}
+
 	template <typename F>
 	inline void for_each_viewer(F f) const {
 		_world.viewers.for_each_with_id(f);
 	}
 
-	void push_main_thread_time_spread_task(ITimeSpreadTask *task);
+	void push_main_thread_time_spread_task(
+			ITimeSpreadTask *task, TimeSpreadTaskRunner::Priority priority = TimeSpreadTaskRunner::PRIORITY_NORMAL);
 	int get_main_thread_time_budget_usec() const;
 
+	// Picks which main-thread lane a task about the given position should go to, based on distance
+	// to the closest viewer. Near bursts of work, this is what makes distant blocks degrade first.
+	TimeSpreadTaskRunner::Priority get_main_thread_time_spread_priority(Vector3 world_position) const;
+
 	void push_main_thread_progressive_task(IProgressiveTask *task);
 
 	// Thread-safe.
@@ -189,12 +271,20 @@ public:
 			unsigned int thread_count;
 			unsigned int active_threads;
 			unsigned int tasks;
+			// Lifetime totals, so dropped-vs-executed ratios can be checked after bulk cancellations
+			uint64_t executed_tasks;
+			uint64_t dropped_tasks;
+			// Tasks that waited more than a second before pickup, a starvation indicator
+			uint64_t starved_tasks;
 
 			Dictionary to_dict() {
 				Dictionary d;
 				d["tasks"] = tasks;
 				d["active_threads"] = active_threads;
 				d["thread_count"] = thread_count;
+				d["executed_tasks"] = executed_tasks;
+				d["dropped_tasks"] = dropped_tasks;
+				d["starved_tasks"] = int64_t(starved_tasks);
 				return d;
 			}
 		};
@@ -205,12 +295,155 @@ public:
 		int streaming_tasks;
 		int meshing_tasks;
 		int main_thread_tasks;
+		// Lifetime count of tasks that skipped their work because a twin was already running
+		uint64_t deduplicated_tasks;
+		// Admission control of streamed loads: lifetime shed count and current deferred backlog
+		uint64_t shed_load_requests;
+		uint64_t deferred_load_backlog;
+		// Latency percentiles per task type, over the window since stats were last queried
+		FixedArray<TaskLatencyStats::Report, TaskLatencyStats::TASK_TYPE_COUNT> task_latencies;
+		// Run duration and peak-allocation aggregates per task type, same window
+		FixedArray<TaskRuntimeStats::Report, TaskLatencyStats::TASK_TYPE_COUNT> task_runtimes;
+		// Lifetime totals of the generated-block cache
+		uint64_t generated_block_cache_hits;
+		uint64_t generated_block_cache_misses;
+		// Lifetime totals of the mesh deduplication cache
+		uint64_t mesh_dedup_hits;
+		uint64_t mesh_dedup_misses;
+		// Lifetime totals of the compressed cold block tier
+		uint64_t cold_block_cache_hits;
+		uint64_t cold_block_cache_misses;
+		uint64_t cold_block_cache_bytes;
+		// Memory governor state (see `is_memory_over_budget`)
+		uint64_t memory_budget_bytes;
+		bool memory_over_budget;
+		// Aggregated stream I/O timing across volumes (see VoxelStream::IoStats)
+		uint64_t stream_load_count;
+		uint64_t stream_load_time_total_usec;
+		uint64_t stream_load_time_max_usec;
+		uint64_t stream_save_count;
+		uint64_t stream_save_time_total_usec;
+		uint64_t stream_save_time_max_usec;
+		uint64_t stream_slow_op_count;
+		// Per-lane accounting of the main-thread time-spread runner
+		struct MainThreadLaneStats {
+			unsigned int pending;
+			uint64_t time_spent_usec;
+			unsigned int mean_task_time_usec;
+		};
+		FixedArray<MainThreadLaneStats, TimeSpreadTaskRunner::PRIORITY_COUNT> main_thread_lanes;
 
 		Dictionary to_dict();
 	};
 
 	Stats get_stats() const;
 
+	// One dictionary per volume with its reported block counts, for telemetry
+	Array debug_get_per_volume_info() const;
+
+	unsigned int get_viewer_count() const {
+		return _world.viewers.count();
+	}
+
+	// Whether telemetry streaming is on; volumes only report their gauges when it is
+	bool is_telemetry_enabled() const {
+		return _telemetry.is_enabled();
+	}
+
+	// Registers a volume whose update task was pushed to the pool this frame and must be joined
+	// before the frame ends (same-frame updates without threaded-update latency). `process()`
+	// runs after scene nodes, waits for every registered volume and invokes the callback, so
+	// several volumes' update tasks overlap on the pool and the frame pays the slowest one
+	// instead of their sum.
+	void push_synchronous_update_join(ObjectID object_id, void (*callback)(Object &object));
+
+	// Memory governor: total bytes held by voxel buffers and caches must stay under this budget
+	// (`voxel/memory/budget_mb`, 0 means unlimited). When the server can't get back under it by
+	// trimming its own caches, volumes run bounded in-place compression sweeps each frame until
+	// pressure subsides. See `process()`.
+	bool is_memory_over_budget() const {
+		return _memory_over_budget;
+	}
+
+	// Record/replay of viewer workloads for diagnosing streaming regressions, see ViewerTrace.
+	// Percentiles in the final report cover the stats window since the last query.
+	void debug_start_viewer_recording() {
+		_viewer_trace.start_recording();
+	}
+	bool debug_stop_viewer_recording(const String &fpath) {
+		return _viewer_trace.stop_recording(fpath);
+	}
+	bool debug_start_viewer_replay(const String &fpath) {
+		return _viewer_trace.start_replay(fpath);
+	}
+
+	// Backlog of finished streaming tasks not yet applied by the main thread. Load tasks use it
+	// to decide whether to hand over compressed payloads during bursts, see LoadBlockDataTask.
+	unsigned int get_streaming_results_backlog() const {
+		return _streaming_thread_pool.get_completed_pending_count();
+	}
+
+	// Tasks report their scheduling-to-completion latency here
+	TaskLatencyStats &get_task_latency_stats() {
+		return _task_latency_stats;
+	}
+
+	// Tasks report their run duration and per-task allocation watermark here
+	TaskRuntimeStats &get_task_runtime_stats() {
+		return _task_runtime_stats;
+	}
+
+	// Slowest blocks seen since the last consume, so editor tooling can point at the map areas
+	// that hammer the pipeline. Positions use the coordinate space of the recording task type.
+	struct SlowBlockRecord {
+		Vector3i position;
+		uint32_t time_usec = 0;
+		uint8_t lod = 0;
+		uint8_t task_type = 0; // TaskLatencyStats::TaskType
+	};
+	static const unsigned int SLOW_BLOCK_RECORD_COUNT = 8;
+
+	void record_slow_block(TaskLatencyStats::TaskType type, Vector3i position, uint8_t lod, uint32_t time_usec);
+	// Copies the current records into `out_records` (unsorted) and resets the window
+	void consume_slow_block_records(std::vector<SlowBlockRecord> &out_records);
+
+	// Tasks register here while running, so duplicates scheduled by overlapping viewers skip work
+	InFlightTaskRegistry &get_in_flight_task_registry() {
+		return _in_flight_task_registry;
+	}
+
+	// Shares identical meshes across blocks of a volume, see `MeshDedupCache`. Main thread only.
+	MeshDedupCache &get_mesh_dedup_cache() {
+		return _mesh_dedup_cache;
+	}
+
+	// Compressed middle tier for evicted blocks, see `ColdBlockCache`
+	ColdBlockCache &get_cold_block_cache() {
+		return _cold_block_cache;
+	}
+
+	// Ordered native stages run on freshly generated blocks, see IBlockProcessingStage.
+	// Register during game initialization, before volumes start streaming; stages registered
+	// while generation tasks run only apply to blocks generated afterwards, which would make
+	// results non-deterministic across the world.
+	void add_block_processing_stage(std::shared_ptr<IBlockProcessingStage> stage);
+	void clear_block_processing_stages();
+	// Runs every registered stage in order on a freshly generated block. Called by generation
+	// paths on worker threads; `voxels` must be exclusively owned by the caller.
+	void apply_block_processing_stages(
+			VoxelBufferInternal &voxels, Vector3i origin_in_voxels, uint8_t lod, uint32_t volume_id);
+
+	// Consulted by generation tasks before running the generator
+	GeneratedBlockCache &get_generated_block_cache() {
+		return _generated_block_cache;
+	}
+
+	// Drops all queued general tasks (meshing, generation) that report cancellation, typically
+	// because their area moved too far away from viewers. Useful right after large viewer jumps
+	// like teleports, so thousands of stale tasks stop being re-scored until they reach the front
+	// of the queue. Returns how many tasks were dropped.
+	unsigned int cancel_stale_tasks();
+
 private:
 	// Since we are going to send data to tasks running in multiple threads, a few strategies are in place:
 	//
@@ -227,6 +460,9 @@ private:
 	struct Volume {
 		VolumeType type;
 		VolumeCallbacks callbacks;
+		// Gauges reported by the volume's node for diagnostics/telemetry, not used by the server
+		uint32_t debug_data_block_count = 0;
+		uint32_t debug_mesh_block_count = 0;
 		Transform3D transform;
 		Ref<VoxelStream> stream;
 		Ref<VoxelGenerator> generator;
@@ -236,6 +472,18 @@ private:
 		float octree_lod_distance = 0;
 		std::shared_ptr<StreamingDependency> stream_dependency;
 		std::shared_ptr<MeshingDependency> meshing_dependency;
+
+		// Admission control for streamed loads (see `request_block_load`): when storage is slow,
+		// requests beyond the in-flight cap wait here as tiny descriptors instead of piling up as
+		// full tasks with payload buffers. Admitted oldest-first as loads finish; entries whose
+		// block left every viewer's range by then are shed with a regular dropped response.
+		struct DeferredLoad {
+			Vector3i position;
+			uint8_t lod;
+			bool request_instances;
+		};
+		unsigned int inflight_load_count = 0;
+		std::deque<DeferredLoad> deferred_loads;
 	};
 
 	struct World {
@@ -256,9 +504,45 @@ private:
 	ThreadedTaskRunner _streaming_thread_pool;
 	// Pool for every other task
 	ThreadedTaskRunner _general_thread_pool;
+	// Mutable so querying stats (const) can consume the rolling window
+	mutable TaskLatencyStats _task_latency_stats;
+	mutable TaskRuntimeStats _task_runtime_stats;
+	// See `request_block_load`; 0 disables admission control
+	unsigned int _max_inflight_loads_per_volume = 0;
+	uint64_t _shed_load_request_count = 0;
+	// See `record_slow_block`. The atomic floor keeps the lock out of the common path: tasks
+	// only take it when their duration would actually enter the list.
+	FixedArray<SlowBlockRecord, SLOW_BLOCK_RECORD_COUNT> _slow_block_records;
+	unsigned int _slow_block_record_count = 0;
+	std::atomic_uint32_t _slow_block_floor_usec = { 0 };
+	Mutex _slow_block_records_mutex;
+	GeneratedBlockCache _generated_block_cache;
+	InFlightTaskRegistry _in_flight_task_registry;
+	MeshDedupCache _mesh_dedup_cache;
+	// See `add_block_processing_stage`. Guarded by its mutex; workers copy the list per call.
+	std::vector<std::shared_ptr<IBlockProcessingStage>> _block_processing_stages;
+	Mutex _block_processing_stages_mutex;
+	ColdBlockCache _cold_block_cache;
+	VoxelTelemetry _telemetry;
+	ViewerTrace _viewer_trace;
+	// Path passed with --voxel-replay, armed on the first process() so volumes exist by then
+	String _pending_replay_path;
 	// For tasks that can only run on the main thread and be spread out over frames
 	TimeSpreadTaskRunner _time_spread_task_runner;
 	int _main_thread_time_budget_usec = 8000;
+	uint64_t _viewers_state_version = 1;
+	// Time overspent past recent budgets, still to be paid back. See `process()`
+	uint64_t _main_thread_budget_debt_usec = 0;
+	// Same-frame volume update joins, see `push_synchronous_update_join`
+	struct SynchronousUpdateJoin {
+		ObjectID object_id;
+		void (*callback)(Object &object);
+	};
+	std::vector<SynchronousUpdateJoin> _synchronous_update_joins;
+
+	// Memory governor, see `is_memory_over_budget()`
+	size_t _memory_budget_bytes = 0;
+	bool _memory_over_budget = false;
 	ProgressiveTaskRunner _progressive_task_runner;
 
 	FileLocker _file_locker;
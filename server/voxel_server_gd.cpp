@@ -1,5 +1,6 @@
 #include "voxel_server_gd.h"
 #include "../util/macros.h"
+#include "../util/lightweight_profiler.h"
 #include "../util/profiling.h"
 #include "../util/tasks/godot/threaded_task_gd.h"
 #include "voxel_server.h"
@@ -35,6 +36,65 @@ Dictionary VoxelServer::get_stats() const {
 	return zylann::voxel::VoxelServer::get_singleton().get_stats().to_dict();
 }
 
+void VoxelServer::debug_start_viewer_recording() {
+	zylann::voxel::VoxelServer::get_singleton().debug_start_viewer_recording();
+}
+
+bool VoxelServer::debug_stop_viewer_recording(String fpath) {
+	return zylann::voxel::VoxelServer::get_singleton().debug_stop_viewer_recording(fpath);
+}
+
+bool VoxelServer::debug_start_viewer_replay(String fpath) {
+	return zylann::voxel::VoxelServer::get_singleton().debug_start_viewer_replay(fpath);
+}
+
+void VoxelServer::debug_set_light_profiling_enabled(bool enabled) {
+	LightweightProfiler::get_singleton().set_enabled(enabled);
+}
+
+Dictionary VoxelServer::debug_get_light_profile() const {
+	const LightweightProfiler &profiler = LightweightProfiler::get_singleton();
+
+	Dictionary d;
+
+	std::vector<LightweightProfiler::ZoneReport> zone_reports;
+	profiler.get_zone_reports(zone_reports);
+	Array zones;
+	for (unsigned int i = 0; i < zone_reports.size(); ++i) {
+		const LightweightProfiler::ZoneReport &report = zone_reports[i];
+		Dictionary zd;
+		zd["name"] = report.name;
+		zd["calls"] = int64_t(report.call_count);
+		zd["total_usec"] = int64_t(report.total_usec);
+		zd["max_usec"] = int64_t(report.max_usec);
+		zones.push_back(zd);
+	}
+	d["zones"] = zones;
+
+	std::vector<LightweightProfiler::EventReport> event_reports;
+	profiler.get_recent_events(event_reports);
+	Array events;
+	for (unsigned int i = 0; i < event_reports.size(); ++i) {
+		const LightweightProfiler::EventReport &report = event_reports[i];
+		Dictionary ed;
+		ed["zone"] = report.zone_name;
+		ed["age_usec"] = int64_t(report.age_usec);
+		ed["duration_usec"] = int64_t(report.duration_usec);
+		events.push_back(ed);
+	}
+	d["recent_events"] = events;
+
+	return d;
+}
+
+void VoxelServer::debug_reset_light_profile() {
+	LightweightProfiler::get_singleton().reset();
+}
+
+int VoxelServer::cancel_stale_tasks() {
+	return zylann::voxel::VoxelServer::get_singleton().cancel_stale_tasks();
+}
+
 void VoxelServer::schedule_task(Ref<ZN_ThreadedTask> task) {
 	ERR_FAIL_COND(task.is_null());
 	ERR_FAIL_COND_MSG(task->is_scheduled(), "Cannot schedule again a task that is already scheduled");
@@ -49,6 +109,16 @@ void VoxelServer::_on_rendering_server_frame_post_draw() {
 
 void VoxelServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_stats"), &VoxelServer::get_stats);
+	ClassDB::bind_method(
+			D_METHOD("debug_start_viewer_recording"), &VoxelServer::debug_start_viewer_recording);
+	ClassDB::bind_method(
+			D_METHOD("debug_stop_viewer_recording", "path"), &VoxelServer::debug_stop_viewer_recording);
+	ClassDB::bind_method(D_METHOD("debug_start_viewer_replay", "path"), &VoxelServer::debug_start_viewer_replay);
+	ClassDB::bind_method(D_METHOD("cancel_stale_tasks"), &VoxelServer::cancel_stale_tasks);
+	ClassDB::bind_method(D_METHOD("debug_set_light_profiling_enabled", "enabled"),
+			&VoxelServer::debug_set_light_profiling_enabled);
+	ClassDB::bind_method(D_METHOD("debug_get_light_profile"), &VoxelServer::debug_get_light_profile);
+	ClassDB::bind_method(D_METHOD("debug_reset_light_profile"), &VoxelServer::debug_reset_light_profile);
 }
 
 } // namespace zylann::voxel::gd
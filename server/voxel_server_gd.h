@@ -16,7 +16,21 @@ class VoxelServer : public Object {
 	GDCLASS(VoxelServer, Object)
 public:
 	Dictionary get_stats() const;
+
+	// Record/replay of viewer workloads, see ViewerTrace
+	void debug_start_viewer_recording();
+	bool debug_stop_viewer_recording(String fpath);
+	bool debug_start_viewer_replay(String fpath);
+
+	// Runtime-toggleable lightweight profiling zones, see `LightweightProfiler`. Enabling costs
+	// nearly nothing; the report can be pulled during a live incident without redeploying.
+	void debug_set_light_profiling_enabled(bool enabled);
+	Dictionary debug_get_light_profile() const;
+	void debug_reset_light_profile();
 	void schedule_task(Ref<ZN_ThreadedTask> task);
+	// Drops queued tasks that are no longer relevant (e.g. after teleporting viewers far away).
+	// Returns how many were dropped.
+	int cancel_stale_tasks();
 
 	VoxelServer();
 
@@ -12,6 +12,10 @@ bool g_updater_created = false;
 VoxelServerUpdater::VoxelServerUpdater() {
 	ZN_PRINT_VERBOSE("Creating VoxelServerUpdater");
 	set_process(true);
+	// Must tick after terrain nodes: volumes running non-threaded updates submit their task
+	// during their own `_process` and rely on `VoxelServer::process` joining them in the same
+	// frame (see `push_synchronous_update_join`)
+	set_process_priority(100);
 	g_updater_created = true;
 }
 
@@ -0,0 +1,147 @@
+#include "voxel_telemetry.h"
+#include "../util/log.h"
+#include "../util/math/funcs.h"
+#include "../util/profiling.h"
+#include "../util/string_funcs.h"
+#include "voxel_server.h"
+
+#include <core/config/project_settings.h>
+#include <core/os/time.h>
+
+namespace zylann::voxel {
+
+// Minimal JSON writer for telemetry payloads. The stats dictionaries only contain numbers,
+// strings, nested dictionaries and arrays, so this avoids depending on the engine's JSON class
+// for such a small need.
+static void append_json(String &out, const Variant &value) {
+	switch (value.get_type()) {
+		case Variant::NIL:
+			out += "null";
+			break;
+
+		case Variant::BOOL:
+			out += bool(value) ? "true" : "false";
+			break;
+
+		case Variant::INT:
+			out += String::num_int64(value);
+			break;
+
+		case Variant::FLOAT:
+			out += String::num(double(value));
+			break;
+
+		case Variant::DICTIONARY: {
+			const Dictionary d = value;
+			out += "{";
+			const Array keys = d.keys();
+			for (int i = 0; i < keys.size(); ++i) {
+				if (i > 0) {
+					out += ",";
+				}
+				out += "\"";
+				out += String(keys[i]).json_escape();
+				out += "\":";
+				append_json(out, d[keys[i]]);
+			}
+			out += "}";
+		} break;
+
+		case Variant::ARRAY: {
+			const Array a = value;
+			out += "[";
+			for (int i = 0; i < a.size(); ++i) {
+				if (i > 0) {
+					out += ",";
+				}
+				append_json(out, a[i]);
+			}
+			out += "]";
+		} break;
+
+		default:
+			out += "\"";
+			out += String(value).json_escape();
+			out += "\"";
+			break;
+	}
+}
+
+void VoxelTelemetry::configure_from_project_settings() {
+	ProjectSettings &ps = *ProjectSettings::get_singleton();
+
+	// "RST" means changing the property requires an editor restart (or game restart)
+	GLOBAL_DEF_RST("voxel/telemetry/enabled", false);
+	ps.set_custom_property_info(
+			"voxel/telemetry/enabled", PropertyInfo(Variant::BOOL, "voxel/telemetry/enabled"));
+
+	GLOBAL_DEF_RST("voxel/telemetry/host", "127.0.0.1");
+	ps.set_custom_property_info("voxel/telemetry/host", PropertyInfo(Variant::STRING, "voxel/telemetry/host"));
+
+	GLOBAL_DEF_RST("voxel/telemetry/port", 9464);
+	ps.set_custom_property_info("voxel/telemetry/port",
+			PropertyInfo(Variant::INT, "voxel/telemetry/port", PROPERTY_HINT_RANGE, "1,65535"));
+
+	GLOBAL_DEF_RST("voxel/telemetry/interval_seconds", 1.f);
+	ps.set_custom_property_info("voxel/telemetry/interval_seconds",
+			PropertyInfo(Variant::FLOAT, "voxel/telemetry/interval_seconds", PROPERTY_HINT_RANGE, "0.1,60,0.1"));
+
+	_enabled = ps.get("voxel/telemetry/enabled");
+	if (!_enabled) {
+		return;
+	}
+
+	const String host = ps.get("voxel/telemetry/host");
+	const int port = ps.get("voxel/telemetry/port");
+	const float interval_seconds = math::max(float(ps.get("voxel/telemetry/interval_seconds")), 0.1f);
+	_interval_usec = uint64_t(interval_seconds * 1000000.f);
+
+	const IPAddress address(host);
+	if (!address.is_valid()) {
+		ERR_PRINT(String("Invalid voxel telemetry host {0}").format(varray(host)));
+		_enabled = false;
+		return;
+	}
+
+	_peer.instantiate();
+	// UDP is connectionless, this only sets the destination
+	const Error err = _peer->connect_to_host(address, port);
+	if (err != OK) {
+		ERR_PRINT(String("Could not setup voxel telemetry socket to {0}:{1}").format(varray(host, port)));
+		_peer.unref();
+		_enabled = false;
+		return;
+	}
+
+	ZN_PRINT_VERBOSE(format("Voxel telemetry streaming to {}:{}", String(host).utf8().get_data(), port));
+}
+
+void VoxelTelemetry::process(VoxelServer &server) {
+	if (!_enabled) {
+		return;
+	}
+	const uint64_t now = Time::get_singleton()->get_ticks_usec();
+	if (now - _last_send_time_usec < _interval_usec) {
+		return;
+	}
+	_last_send_time_usec = now;
+
+	ZN_PROFILE_SCOPE();
+
+	Dictionary d;
+	d["time_usec"] = now;
+	// Note, latency percentiles cover the window since stats were last queried, so with telemetry
+	// enabled the interval below is also the percentile window
+	d["stats"] = server.get_stats().to_dict();
+	d["volumes"] = server.debug_get_per_volume_info();
+	d["viewer_count"] = int(server.get_viewer_count());
+
+	String json;
+	append_json(json, d);
+
+	const CharString utf8 = json.utf8();
+	// Best effort: losing a datagram only loses one sample
+	_peer->put_packet(reinterpret_cast<const uint8_t *>(utf8.get_data()), utf8.length());
+}
+
+} // namespace zylann::voxel
@@ -0,0 +1,37 @@
+#ifndef VOXEL_TELEMETRY_H
+#define VOXEL_TELEMETRY_H
+
+#include <core/io/packet_peer_udp.h>
+
+namespace zylann::voxel {
+
+class VoxelServer;
+
+// Opt-in telemetry for headless servers, where the editor's debug drawing is unavailable.
+// Streams VoxelServer stats (thread pools, task latencies, caches, memory pool, per-volume block
+// counts) as one JSON datagram per interval over UDP, so external stacks can graph streaming
+// health in production. Configured through `voxel/telemetry/*` project settings; disabled by
+// default and costs nothing when off.
+class VoxelTelemetry {
+public:
+	// Reads project settings and opens the socket when enabled
+	void configure_from_project_settings();
+
+	// Called from `VoxelServer::process()`. Sends a datagram when the interval elapsed.
+	void process(VoxelServer &server);
+
+	// Volumes use this to skip gathering their gauges when nobody listens
+	bool is_enabled() const {
+		return _enabled;
+	}
+
+private:
+	Ref<PacketPeerUDP> _peer;
+	bool _enabled = false;
+	uint64_t _interval_usec = 1000000;
+	uint64_t _last_send_time_usec = 0;
+};
+
+} // namespace zylann::voxel
+
+#endif // VOXEL_TELEMETRY_H
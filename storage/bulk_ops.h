@@ -0,0 +1,284 @@
+#ifndef VOXEL_STORAGE_BULK_OPS_H
+#define VOXEL_STORAGE_BULK_OPS_H
+
+#include "../util/span.h"
+
+#include <cstdint>
+#include <cstring>
+
+// Vectorized bulk operations on channel data.
+// These kernels operate on flat spans so they can be used on whole channels as well as on contiguous rows
+// of a 3D region (see `write_box_template` and the fill/copy functions of `VoxelBufferInternal`).
+// Dispatch is done at compile-time per platform; every kernel has a scalar fallback so behavior is identical
+// everywhere, SIMD only makes it faster.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VOXEL_BULK_OPS_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define VOXEL_BULK_OPS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace zylann::voxel::bulk_ops {
+
+template <typename T>
+inline void fill_span(Span<T> dst, T value) {
+	if (sizeof(T) == 1) {
+		memset(dst.data(), uint8_t(value), dst.size());
+		return;
+	}
+	size_t i = 0;
+#if defined(VOXEL_BULK_OPS_SSE2)
+	if (sizeof(T) == 2) {
+		const __m128i v = _mm_set1_epi16(int16_t(value));
+		const size_t n8 = dst.size() & ~size_t(7);
+		for (; i < n8; i += 8) {
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(dst.data() + i), v);
+		}
+	} else if (sizeof(T) == 4) {
+		const __m128i v = _mm_set1_epi32(int32_t(value));
+		const size_t n4 = dst.size() & ~size_t(3);
+		for (; i < n4; i += 4) {
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(dst.data() + i), v);
+		}
+	}
+#elif defined(VOXEL_BULK_OPS_NEON)
+	if (sizeof(T) == 2) {
+		const uint16x8_t v = vdupq_n_u16(uint16_t(value));
+		const size_t n8 = dst.size() & ~size_t(7);
+		for (; i < n8; i += 8) {
+			vst1q_u16(reinterpret_cast<uint16_t *>(dst.data()) + i, v);
+		}
+	} else if (sizeof(T) == 4) {
+		const uint32x4_t v = vdupq_n_u32(uint32_t(value));
+		const size_t n4 = dst.size() & ~size_t(3);
+		for (; i < n4; i += 4) {
+			vst1q_u32(reinterpret_cast<uint32_t *>(dst.data()) + i, v);
+		}
+	}
+#endif
+	for (; i < dst.size(); ++i) {
+		dst[i] = value;
+	}
+}
+
+template <typename T>
+inline void copy_span(Span<T> dst, Span<const T> src) {
+	ZN_ASSERT(dst.size() >= src.size());
+	memcpy(dst.data(), src.data(), src.size() * sizeof(T));
+}
+
+// Min/max reduction over signed 16-bit values (the default SDF channel encoding).
+inline void min_max_span_s16(Span<const int16_t> src, int16_t &out_min, int16_t &out_max) {
+	ZN_ASSERT_RETURN(src.size() > 0);
+	int16_t min_value = src[0];
+	int16_t max_value = src[0];
+	size_t i = 0;
+#if defined(VOXEL_BULK_OPS_SSE2)
+	if (src.size() >= 8) {
+		__m128i vmin = _mm_set1_epi16(min_value);
+		__m128i vmax = vmin;
+		const size_t n8 = src.size() & ~size_t(7);
+		for (; i < n8; i += 8) {
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src.data() + i));
+			vmin = _mm_min_epi16(vmin, v);
+			vmax = _mm_max_epi16(vmax, v);
+		}
+		int16_t lanes[8];
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), vmin);
+		for (unsigned int j = 0; j < 8; ++j) {
+			min_value = lanes[j] < min_value ? lanes[j] : min_value;
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), vmax);
+		for (unsigned int j = 0; j < 8; ++j) {
+			max_value = lanes[j] > max_value ? lanes[j] : max_value;
+		}
+	}
+#elif defined(VOXEL_BULK_OPS_NEON)
+	if (src.size() >= 8) {
+		int16x8_t vmin = vdupq_n_s16(min_value);
+		int16x8_t vmax = vmin;
+		const size_t n8 = src.size() & ~size_t(7);
+		for (; i < n8; i += 8) {
+			const int16x8_t v = vld1q_s16(src.data() + i);
+			vmin = vminq_s16(vmin, v);
+			vmax = vmaxq_s16(vmax, v);
+		}
+		int16_t lanes[8];
+		vst1q_s16(lanes, vmin);
+		for (unsigned int j = 0; j < 8; ++j) {
+			min_value = lanes[j] < min_value ? lanes[j] : min_value;
+		}
+		vst1q_s16(lanes, vmax);
+		for (unsigned int j = 0; j < 8; ++j) {
+			max_value = lanes[j] > max_value ? lanes[j] : max_value;
+		}
+	}
+#endif
+	for (; i < src.size(); ++i) {
+		const int16_t v = src[i];
+		min_value = v < min_value ? v : min_value;
+		max_value = v > max_value ? v : max_value;
+	}
+	out_min = min_value;
+	out_max = max_value;
+}
+
+// dst = min(dst, src), the quantized equivalent of `sdf_union` over a row of voxels.
+inline void sdf_union_span_s16(Span<int16_t> dst, Span<const int16_t> src) {
+	ZN_ASSERT_RETURN(dst.size() == src.size());
+	size_t i = 0;
+#if defined(VOXEL_BULK_OPS_SSE2)
+	const size_t n8 = dst.size() & ~size_t(7);
+	for (; i < n8; i += 8) {
+		const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst.data() + i));
+		const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src.data() + i));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst.data() + i), _mm_min_epi16(a, b));
+	}
+#elif defined(VOXEL_BULK_OPS_NEON)
+	const size_t n8 = dst.size() & ~size_t(7);
+	for (; i < n8; i += 8) {
+		const int16x8_t a = vld1q_s16(dst.data() + i);
+		const int16x8_t b = vld1q_s16(src.data() + i);
+		vst1q_s16(dst.data() + i, vminq_s16(a, b));
+	}
+#endif
+	for (; i < dst.size(); ++i) {
+		dst[i] = src[i] < dst[i] ? src[i] : dst[i];
+	}
+}
+
+// dst = max(dst, -src), the quantized equivalent of `sdf_subtract` over a row of voxels.
+// Uses saturation so -(-32768) does not wrap around.
+inline void sdf_subtract_span_s16(Span<int16_t> dst, Span<const int16_t> src) {
+	ZN_ASSERT_RETURN(dst.size() == src.size());
+	size_t i = 0;
+#if defined(VOXEL_BULK_OPS_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	const size_t n8 = dst.size() & ~size_t(7);
+	for (; i < n8; i += 8) {
+		const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst.data() + i));
+		const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src.data() + i));
+		const __m128i nb = _mm_subs_epi16(zero, b);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst.data() + i), _mm_max_epi16(a, nb));
+	}
+#elif defined(VOXEL_BULK_OPS_NEON)
+	const size_t n8 = dst.size() & ~size_t(7);
+	for (; i < n8; i += 8) {
+		const int16x8_t a = vld1q_s16(dst.data() + i);
+		const int16x8_t b = vld1q_s16(src.data() + i);
+		vst1q_s16(dst.data() + i, vmaxq_s16(a, vqnegq_s16(b)));
+	}
+#endif
+	for (; i < dst.size(); ++i) {
+		const int32_t nb = -int32_t(src[i]);
+		const int16_t nbs = nb > 32767 ? int16_t(32767) : int16_t(nb);
+		dst[i] = nbs > dst[i] ? nbs : dst[i];
+	}
+}
+
+// Float variants, for when the SDF channel uses 32-bit depth.
+
+inline void min_max_span_f32(Span<const float> src, float &out_min, float &out_max) {
+	ZN_ASSERT_RETURN(src.size() > 0);
+	float min_value = src[0];
+	float max_value = src[0];
+	size_t i = 0;
+#if defined(VOXEL_BULK_OPS_SSE2)
+	if (src.size() >= 4) {
+		__m128 vmin = _mm_set1_ps(min_value);
+		__m128 vmax = vmin;
+		const size_t n4 = src.size() & ~size_t(3);
+		for (; i < n4; i += 4) {
+			const __m128 v = _mm_loadu_ps(src.data() + i);
+			vmin = _mm_min_ps(vmin, v);
+			vmax = _mm_max_ps(vmax, v);
+		}
+		float lanes[4];
+		_mm_storeu_ps(lanes, vmin);
+		for (unsigned int j = 0; j < 4; ++j) {
+			min_value = lanes[j] < min_value ? lanes[j] : min_value;
+		}
+		_mm_storeu_ps(lanes, vmax);
+		for (unsigned int j = 0; j < 4; ++j) {
+			max_value = lanes[j] > max_value ? lanes[j] : max_value;
+		}
+	}
+#elif defined(VOXEL_BULK_OPS_NEON)
+	if (src.size() >= 4) {
+		float32x4_t vmin = vdupq_n_f32(min_value);
+		float32x4_t vmax = vmin;
+		const size_t n4 = src.size() & ~size_t(3);
+		for (; i < n4; i += 4) {
+			const float32x4_t v = vld1q_f32(src.data() + i);
+			vmin = vminq_f32(vmin, v);
+			vmax = vmaxq_f32(vmax, v);
+		}
+		float lanes[4];
+		vst1q_f32(lanes, vmin);
+		for (unsigned int j = 0; j < 4; ++j) {
+			min_value = lanes[j] < min_value ? lanes[j] : min_value;
+		}
+		vst1q_f32(lanes, vmax);
+		for (unsigned int j = 0; j < 4; ++j) {
+			max_value = lanes[j] > max_value ? lanes[j] : max_value;
+		}
+	}
+#endif
+	for (; i < src.size(); ++i) {
+		const float v = src[i];
+		min_value = v < min_value ? v : min_value;
+		max_value = v > max_value ? v : max_value;
+	}
+	out_min = min_value;
+	out_max = max_value;
+}
+
+inline void sdf_union_span_f32(Span<float> dst, Span<const float> src) {
+	ZN_ASSERT_RETURN(dst.size() == src.size());
+	size_t i = 0;
+#if defined(VOXEL_BULK_OPS_SSE2)
+	const size_t n4 = dst.size() & ~size_t(3);
+	for (; i < n4; i += 4) {
+		const __m128 a = _mm_loadu_ps(dst.data() + i);
+		const __m128 b = _mm_loadu_ps(src.data() + i);
+		_mm_storeu_ps(dst.data() + i, _mm_min_ps(a, b));
+	}
+#elif defined(VOXEL_BULK_OPS_NEON)
+	const size_t n4 = dst.size() & ~size_t(3);
+	for (; i < n4; i += 4) {
+		vst1q_f32(dst.data() + i, vminq_f32(vld1q_f32(dst.data() + i), vld1q_f32(src.data() + i)));
+	}
+#endif
+	for (; i < dst.size(); ++i) {
+		dst[i] = src[i] < dst[i] ? src[i] : dst[i];
+	}
+}
+
+inline void sdf_subtract_span_f32(Span<float> dst, Span<const float> src) {
+	ZN_ASSERT_RETURN(dst.size() == src.size());
+	size_t i = 0;
+#if defined(VOXEL_BULK_OPS_SSE2)
+	const __m128 zero = _mm_setzero_ps();
+	const size_t n4 = dst.size() & ~size_t(3);
+	for (; i < n4; i += 4) {
+		const __m128 a = _mm_loadu_ps(dst.data() + i);
+		const __m128 b = _mm_loadu_ps(src.data() + i);
+		_mm_storeu_ps(dst.data() + i, _mm_max_ps(a, _mm_sub_ps(zero, b)));
+	}
+#elif defined(VOXEL_BULK_OPS_NEON)
+	const size_t n4 = dst.size() & ~size_t(3);
+	for (; i < n4; i += 4) {
+		vst1q_f32(dst.data() + i, vmaxq_f32(vld1q_f32(dst.data() + i), vnegq_f32(vld1q_f32(src.data() + i))));
+	}
+#endif
+	for (; i < dst.size(); ++i) {
+		const float nb = -src[i];
+		dst[i] = nb > dst[i] ? nb : dst[i];
+	}
+}
+
+} // namespace zylann::voxel::bulk_ops
+
+#endif // VOXEL_STORAGE_BULK_OPS_H
@@ -0,0 +1,159 @@
+#include "voxel_buffer_channel_view_gd.h"
+#include "../util/log.h"
+
+namespace zylann::voxel::gd {
+
+VoxelBufferChannelView::VoxelBufferChannelView() {}
+
+VoxelBufferChannelView::~VoxelBufferChannelView() {
+	release();
+}
+
+bool VoxelBufferChannelView::open(std::shared_ptr<VoxelBufferInternal> buffer, unsigned int channel, Mode mode) {
+	ERR_FAIL_COND_V(_open, false);
+	ERR_FAIL_COND_V(buffer == nullptr, false);
+	ERR_FAIL_COND_V(channel >= VoxelBufferInternal::MAX_CHANNELS, false);
+
+	if (mode == MODE_WRITE) {
+		buffer->get_lock().write_lock();
+		// Detaching shared payloads and densifying are mutations, only legal under the write lock
+		buffer->decompress_channel(channel);
+
+		Span<uint8_t> data;
+		if (!buffer->get_channel_raw(channel, data) ||
+				buffer->get_channel_layout(channel) != VoxelBufferInternal::CHANNEL_LAYOUT_ZXY) {
+			buffer->get_lock().write_unlock();
+			ERR_FAIL_V_MSG(false, "Channel data can't be viewed in place");
+		}
+		_write_data = data;
+		_data = Span<const uint8_t>(data.data(), data.size());
+
+	} else {
+		if (buffer->get_channel_compression(channel) != VoxelBufferInternal::COMPRESSION_NONE) {
+			// Compact storages can't be indexed in place. Densify before taking the read lock;
+			// the brief unlocked window is fine since script-held buffers aren't contended.
+			buffer->get_lock().write_lock();
+			buffer->decompress_channel(channel);
+			buffer->get_lock().write_unlock();
+		}
+		buffer->get_lock().read_lock();
+
+		// Read-only access on purpose: `get_channel_raw` can detach a copy-on-write payload or
+		// densify, which must never happen under a read lock while other readers (mesh and save
+		// tasks) hold the same payload. A shared payload is perfectly fine to read in place.
+		Span<const uint8_t> data;
+		if (!buffer->get_channel_raw_read_only(channel, data) ||
+				buffer->get_channel_layout(channel) != VoxelBufferInternal::CHANNEL_LAYOUT_ZXY) {
+			buffer->get_lock().read_unlock();
+			ERR_FAIL_V_MSG(false, "Channel data can't be viewed in place");
+		}
+		_data = data;
+	}
+
+	_buffer = buffer;
+	_size = buffer->get_size();
+	_depth = buffer->get_channel_depth(channel);
+	_mode = mode;
+	_open = true;
+	return true;
+}
+
+void VoxelBufferChannelView::release() {
+	if (!_open) {
+		return;
+	}
+	if (_mode == MODE_WRITE) {
+		_buffer->get_lock().write_unlock();
+	} else {
+		_buffer->get_lock().read_unlock();
+	}
+	_buffer = nullptr;
+	_data = Span<const uint8_t>();
+	_write_data = Span<uint8_t>();
+	_open = false;
+}
+
+Vector3i VoxelBufferChannelView::get_size() const {
+	ERR_FAIL_COND_V(!_open, Vector3i());
+	return _size;
+}
+
+int VoxelBufferChannelView::get_length() const {
+	ERR_FAIL_COND_V(!_open, 0);
+	return Vector3iUtil::get_volume(_size);
+}
+
+int VoxelBufferChannelView::get_index(Vector3i position) const {
+	ERR_FAIL_COND_V(!_open, 0);
+	ERR_FAIL_COND_V(position.x < 0 || position.y < 0 || position.z < 0 || position.x >= _size.x ||
+					position.y >= _size.y || position.z >= _size.z,
+			0);
+	return Vector3iUtil::get_zxy_index(position, _size);
+}
+
+uint64_t VoxelBufferChannelView::get_voxel_at_index(int i) const {
+	ERR_FAIL_COND_V(!_open, 0);
+	ERR_FAIL_INDEX_V(i, int(Vector3iUtil::get_volume(_size)), 0);
+	switch (_depth) {
+		case VoxelBufferInternal::DEPTH_8_BIT:
+			return _data[i];
+		case VoxelBufferInternal::DEPTH_16_BIT:
+			return _data.reinterpret_cast_to<const uint16_t>()[i];
+		case VoxelBufferInternal::DEPTH_32_BIT:
+			return _data.reinterpret_cast_to<const uint32_t>()[i];
+		case VoxelBufferInternal::DEPTH_64_BIT:
+			return _data.reinterpret_cast_to<const uint64_t>()[i];
+		default:
+			CRASH_NOW();
+			return 0;
+	}
+}
+
+void VoxelBufferChannelView::set_voxel_at_index(int i, uint64_t value) {
+	ERR_FAIL_COND(!_open);
+	ERR_FAIL_COND_MSG(_mode != MODE_WRITE, "The view was opened for reading");
+	ERR_FAIL_INDEX(i, int(Vector3iUtil::get_volume(_size)));
+	switch (_depth) {
+		case VoxelBufferInternal::DEPTH_8_BIT:
+			_write_data[i] = value;
+			break;
+		case VoxelBufferInternal::DEPTH_16_BIT:
+			_write_data.reinterpret_cast_to<uint16_t>()[i] = value;
+			break;
+		case VoxelBufferInternal::DEPTH_32_BIT:
+			_write_data.reinterpret_cast_to<uint32_t>()[i] = value;
+			break;
+		case VoxelBufferInternal::DEPTH_64_BIT:
+			_write_data.reinterpret_cast_to<uint64_t>()[i] = value;
+			break;
+		default:
+			CRASH_NOW();
+			break;
+	}
+}
+
+uint64_t VoxelBufferChannelView::get_voxel(Vector3i position) const {
+	return get_voxel_at_index(get_index(position));
+}
+
+void VoxelBufferChannelView::set_voxel(uint64_t value, Vector3i position) {
+	set_voxel_at_index(get_index(position), value);
+}
+
+void VoxelBufferChannelView::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("is_open"), &VoxelBufferChannelView::is_open);
+	ClassDB::bind_method(D_METHOD("release"), &VoxelBufferChannelView::release);
+	ClassDB::bind_method(D_METHOD("get_size"), &VoxelBufferChannelView::get_size);
+	ClassDB::bind_method(D_METHOD("get_length"), &VoxelBufferChannelView::get_length);
+	ClassDB::bind_method(D_METHOD("get_index", "position"), &VoxelBufferChannelView::get_index);
+	ClassDB::bind_method(D_METHOD("get_voxel_at_index", "index"), &VoxelBufferChannelView::get_voxel_at_index);
+	ClassDB::bind_method(
+			D_METHOD("set_voxel_at_index", "index", "value"), &VoxelBufferChannelView::set_voxel_at_index);
+	ClassDB::bind_method(D_METHOD("get_voxel", "position"), &VoxelBufferChannelView::get_voxel);
+	ClassDB::bind_method(D_METHOD("set_voxel", "value", "position"), &VoxelBufferChannelView::set_voxel);
+
+	BIND_ENUM_CONSTANT(MODE_READ);
+	BIND_ENUM_CONSTANT(MODE_WRITE);
+}
+
+} // namespace zylann::voxel::gd
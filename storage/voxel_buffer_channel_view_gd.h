@@ -0,0 +1,73 @@
+#ifndef VOXEL_BUFFER_CHANNEL_VIEW_GD_H
+#define VOXEL_BUFFER_CHANNEL_VIEW_GD_H
+
+#include "voxel_buffer_internal.h"
+#include <core/object/ref_counted.h>
+#include <memory>
+
+namespace zylann::voxel::gd {
+
+// Script-facing zero-copy access to one channel of a VoxelBuffer.
+// Packed arrays can't alias external memory in Godot, so bulk script access used to require
+// copying whole channels; this view instead borrows the channel's memory, holding the buffer's
+// read or write lock for as long as it is open. Analysis tools (pathfinding bakers, scanners)
+// can then iterate voxels in place through indexed accessors.
+//
+// The view keeps the underlying lock held until `release()` is called or the view is destroyed.
+// Keep its lifetime short: holding a write view blocks meshing and streaming of that buffer.
+class VoxelBufferChannelView : public RefCounted {
+	GDCLASS(VoxelBufferChannelView, RefCounted)
+
+public:
+	enum Mode { //
+		MODE_READ,
+		MODE_WRITE
+	};
+
+	VoxelBufferChannelView();
+	~VoxelBufferChannelView();
+
+	// Internal. Borrows the channel, taking the corresponding lock. The channel gets densified
+	// first, since compact storages can't be indexed directly. Only ZXY-layout channels are
+	// supported. Returns false on failure, in which case no lock is held.
+	bool open(std::shared_ptr<VoxelBufferInternal> buffer, unsigned int channel, Mode mode);
+
+	bool is_open() const {
+		return _open;
+	}
+
+	// Releases the borrowed memory and the lock. The view becomes unusable.
+	void release();
+
+	Vector3i get_size() const;
+	// Number of voxels in the channel
+	int get_length() const;
+	// Index of a position in the flat channel data (ZXY order)
+	int get_index(Vector3i position) const;
+
+	uint64_t get_voxel_at_index(int i) const;
+	void set_voxel_at_index(int i, uint64_t value);
+
+	uint64_t get_voxel(Vector3i position) const;
+	void set_voxel(uint64_t value, Vector3i position);
+
+private:
+	static void _bind_methods();
+
+	std::shared_ptr<VoxelBufferInternal> _buffer;
+	// Read view of the channel payload; reads never mutate the channel, so a COW-shared payload
+	// can be viewed as-is
+	Span<const uint8_t> _data;
+	// Only valid in MODE_WRITE, where the channel was detached and densified under the write lock
+	Span<uint8_t> _write_data;
+	Vector3i _size;
+	VoxelBufferInternal::Depth _depth = VoxelBufferInternal::DEPTH_8_BIT;
+	Mode _mode = MODE_READ;
+	bool _open = false;
+};
+
+} // namespace zylann::voxel::gd
+
+VARIANT_ENUM_CAST(zylann::voxel::gd::VoxelBufferChannelView::Mode)
+
+#endif // VOXEL_BUFFER_CHANNEL_VIEW_GD_H
@@ -1,4 +1,5 @@
 #include "voxel_buffer_gd.h"
+#include "voxel_buffer_channel_view_gd.h"
 #include "../edition/voxel_tool_buffer.h"
 #include "../util/math/color.h"
 #include "../util/memory.h"
@@ -103,6 +104,13 @@ void VoxelBuffer::set_channel_depth(unsigned int channel_index, Depth new_depth)
 	_buffer->set_channel_depth(channel_index, VoxelBufferInternal::Depth(new_depth));
 }
 
+void VoxelBuffer::convert_channel_depth(unsigned int channel_index, Depth new_depth, bool normalized) {
+	ERR_FAIL_INDEX(channel_index, MAX_CHANNELS);
+	ERR_FAIL_INDEX(new_depth, DEPTH_COUNT);
+	_buffer->convert_channel_depth(
+			channel_index, VoxelBufferInternal::Depth(new_depth), normalized);
+}
+
 VoxelBuffer::Depth VoxelBuffer::get_channel_depth(unsigned int channel_index) const {
 	return VoxelBuffer::Depth(_buffer->get_channel_depth(channel_index));
 }
@@ -260,6 +268,19 @@ Array VoxelBuffer::debug_print_sdf_y_slices(float scale) const {
 	return images;
 }
 
+Ref<VoxelBufferChannelView> VoxelBuffer::get_channel_view(unsigned int channel_index, int mode) {
+	ERR_FAIL_COND_V(channel_index >= MAX_CHANNELS, Ref<VoxelBufferChannelView>());
+	ERR_FAIL_COND_V(
+			mode != VoxelBufferChannelView::MODE_READ && mode != VoxelBufferChannelView::MODE_WRITE,
+			Ref<VoxelBufferChannelView>());
+	Ref<VoxelBufferChannelView> view;
+	view.instantiate();
+	if (!view->open(_buffer, channel_index, VoxelBufferChannelView::Mode(mode))) {
+		return Ref<VoxelBufferChannelView>();
+	}
+	return view;
+}
+
 void VoxelBuffer::_b_deprecated_optimize() {
 	ERR_PRINT_ONCE("VoxelBuffer.optimize() is deprecated. Use compress_uniform_channels() instead.");
 	compress_uniform_channels();
@@ -281,9 +302,12 @@ void VoxelBuffer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_voxel", "x", "y", "z", "channel"), &VoxelBuffer::get_voxel, DEFVAL(0));
 	ClassDB::bind_method(D_METHOD("get_voxel_f", "x", "y", "z", "channel"), &VoxelBuffer::get_voxel_f, DEFVAL(0));
 	ClassDB::bind_method(D_METHOD("get_voxel_tool"), &VoxelBuffer::get_voxel_tool);
+	ClassDB::bind_method(D_METHOD("get_channel_view", "channel", "mode"), &VoxelBuffer::get_channel_view);
 
 	ClassDB::bind_method(D_METHOD("get_channel_depth", "channel"), &VoxelBuffer::get_channel_depth);
 	ClassDB::bind_method(D_METHOD("set_channel_depth", "channel", "depth"), &VoxelBuffer::set_channel_depth);
+	ClassDB::bind_method(D_METHOD("convert_channel_depth", "channel", "depth", "normalized"),
+			&VoxelBuffer::convert_channel_depth);
 
 	ClassDB::bind_method(D_METHOD("fill", "value", "channel"), &VoxelBuffer::fill, DEFVAL(0));
 	ClassDB::bind_method(D_METHOD("fill_f", "value", "channel"), &VoxelBuffer::fill_f, DEFVAL(0));
@@ -331,6 +355,8 @@ void VoxelBuffer::_bind_methods() {
 
 	BIND_ENUM_CONSTANT(COMPRESSION_NONE);
 	BIND_ENUM_CONSTANT(COMPRESSION_UNIFORM);
+	BIND_ENUM_CONSTANT(COMPRESSION_TILED);
+	BIND_ENUM_CONSTANT(COMPRESSION_PALETTED);
 	BIND_ENUM_CONSTANT(COMPRESSION_COUNT);
 
 	BIND_CONSTANT(MAX_SIZE);
@@ -13,6 +13,8 @@ class VoxelTool;
 
 namespace gd {
 
+class VoxelBufferChannelView;
+
 // Scripts-facing wrapper around VoxelBufferInternal.
 // It is separate because being a Godot object requires to carry more baggage, and because this data type can
 // be instanced many times while being rarely accessed directly from scripts, it is a bit better to take this part out
@@ -38,6 +40,8 @@ public:
 	enum Compression {
 		COMPRESSION_NONE = VoxelBufferInternal::COMPRESSION_NONE,
 		COMPRESSION_UNIFORM = VoxelBufferInternal::COMPRESSION_UNIFORM,
+		COMPRESSION_TILED = VoxelBufferInternal::COMPRESSION_TILED,
+		COMPRESSION_PALETTED = VoxelBufferInternal::COMPRESSION_PALETTED,
 		//COMPRESSION_RLE,
 		COMPRESSION_COUNT = VoxelBufferInternal::COMPRESSION_COUNT
 	};
@@ -139,7 +143,13 @@ public:
 
 	Ref<VoxelTool> get_voxel_tool();
 
+	// Borrows one channel's memory for in-place iteration, see `VoxelBufferChannelView`.
+	// Returns null on failure. The channel stays locked until the view is released.
+	Ref<VoxelBufferChannelView> get_channel_view(unsigned int channel_index, int mode);
+
 	void set_channel_depth(unsigned int channel_index, Depth new_depth);
+	// Offline format pre-conversion, see `VoxelBufferInternal::convert_channel_depth`
+	void convert_channel_depth(unsigned int channel_index, Depth new_depth, bool normalized);
 	Depth get_channel_depth(unsigned int channel_index) const;
 
 	// When using lower than 32-bit resolution for terrain signed distance fields,
@@ -7,9 +7,11 @@
 #include "../util/container_funcs.h"
 #include "../util/profiling.h"
 #include "../util/string_funcs.h"
+#include "bulk_ops.h"
 #include "voxel_buffer_internal.h"
 
 #include <core/io/marshalls.h>
+#include <unordered_map>
 #include <core/math/math_funcs.h>
 
 namespace zylann::voxel {
@@ -22,6 +24,12 @@ inline uint8_t *allocate_channel_data(size_t size) {
 #endif
 }
 
+inline std::atomic_uint32_t *allocate_channel_refcount() {
+	std::atomic_uint32_t *refcount = ZN_NEW(std::atomic_uint32_t);
+	refcount->store(1, std::memory_order_relaxed);
+	return refcount;
+}
+
 inline void free_channel_data(uint8_t *data, uint32_t size) {
 #ifdef VOXEL_BUFFER_USE_MEMORY_POOL
 	VoxelMemoryPool::get_singleton().recycle(data, size);
@@ -205,7 +213,11 @@ uint64_t VoxelBufferInternal::get_voxel(int x, int y, int z, unsigned int channe
 	const Channel &channel = _channels[channel_index];
 
 	if (channel.data != nullptr) {
-		const uint32_t i = get_index(x, y, z);
+		if (channel.format != Channel::FORMAT_DENSE) {
+			return get_voxel_compact(channel, x, y, z);
+		}
+
+		const uint32_t i = get_index_in_layout(x, y, z, channel.layout);
 
 		switch (channel.depth) {
 			case DEPTH_8_BIT:
@@ -236,6 +248,11 @@ void VoxelBufferInternal::set_voxel(uint64_t value, int x, int y, int z, unsigne
 
 	Channel &channel = _channels[channel_index];
 
+	// Writes operate on dense data, compact storage converts back transparently
+	if (channel.format != Channel::FORMAT_DENSE) {
+		densify_channel(channel);
+	}
+
 	bool do_set = true;
 
 	if (channel.data == nullptr) {
@@ -248,7 +265,8 @@ void VoxelBufferInternal::set_voxel(uint64_t value, int x, int y, int z, unsigne
 	}
 
 	if (do_set) {
-		const uint32_t i = get_index(x, y, z);
+		ensure_channel_unique(channel, true);
+		const uint32_t i = get_index_in_layout(x, y, z, channel.layout);
 
 		switch (channel.depth) {
 			case DEPTH_8_BIT:
@@ -292,6 +310,11 @@ void VoxelBufferInternal::fill(uint64_t defval, unsigned int channel_index) {
 
 	Channel &channel = _channels[channel_index];
 
+	if (channel.format != Channel::FORMAT_DENSE) {
+		// Everything gets overwritten, no point decoding first
+		delete_channel(channel);
+	}
+
 	if (channel.data == nullptr) {
 		// Channel is already optimized and uniform
 		if (channel.defval == defval) {
@@ -309,27 +332,25 @@ void VoxelBufferInternal::fill(uint64_t defval, unsigned int channel_index) {
 	ZN_ASSERT(channel.size_in_bytes == get_size_in_bytes_for_volume(_size, channel.depth));
 #endif
 
+	// The payload may be shared copy-on-write (snapshots, zero-copy pastes); writing in place
+	// would rewrite every other owner. The whole payload gets overwritten, so nothing to preserve.
+	ensure_channel_unique(channel, false);
+
 	switch (channel.depth) {
 		case DEPTH_8_BIT:
 			memset(channel.data, defval, channel.size_in_bytes);
 			break;
 
 		case DEPTH_16_BIT:
-			for (size_t i = 0; i < volume; ++i) {
-				reinterpret_cast<uint16_t *>(channel.data)[i] = defval;
-			}
+			bulk_ops::fill_span(Span<uint16_t>(reinterpret_cast<uint16_t *>(channel.data), volume), uint16_t(defval));
 			break;
 
 		case DEPTH_32_BIT:
-			for (size_t i = 0; i < volume; ++i) {
-				reinterpret_cast<uint32_t *>(channel.data)[i] = defval;
-			}
+			bulk_ops::fill_span(Span<uint32_t>(reinterpret_cast<uint32_t *>(channel.data), volume), uint32_t(defval));
 			break;
 
 		case DEPTH_64_BIT:
-			for (size_t i = 0; i < volume; ++i) {
-				reinterpret_cast<uint64_t *>(channel.data)[i] = defval;
-			}
+			bulk_ops::fill_span(Span<uint64_t>(reinterpret_cast<uint64_t *>(channel.data), volume), defval);
 			break;
 
 		default:
@@ -349,8 +370,16 @@ void VoxelBufferInternal::fill_area(uint64_t defval, Vector3i min, Vector3i max,
 		return;
 	}
 
+	// Row-wise filling assumes linear ordering
+	set_channel_layout(channel_index, CHANNEL_LAYOUT_ZXY);
+
 	Channel &channel = _channels[channel_index];
 
+	// Writes operate on dense data, compact storage converts back transparently
+	if (channel.format != Channel::FORMAT_DENSE) {
+		densify_channel(channel);
+	}
+
 	if (channel.data == nullptr) {
 		if (channel.defval == defval) {
 			return;
@@ -359,6 +388,8 @@ void VoxelBufferInternal::fill_area(uint64_t defval, Vector3i min, Vector3i max,
 		}
 	}
 
+	ensure_channel_unique(channel, true);
+
 	Vector3i pos;
 	const size_t volume = get_volume();
 
@@ -374,21 +405,18 @@ void VoxelBufferInternal::fill_area(uint64_t defval, Vector3i min, Vector3i max,
 					break;
 
 				case DEPTH_16_BIT:
-					for (int i = 0; i < area_size.y; ++i) {
-						((uint16_t *)channel.data)[dst_ri + i] = defval;
-					}
+					// Columns are contiguous in ZXY order, so each one is a bulk kernel call
+					bulk_ops::fill_span(
+							Span<uint16_t>(((uint16_t *)channel.data) + dst_ri, area_size.y), uint16_t(defval));
 					break;
 
 				case DEPTH_32_BIT:
-					for (int i = 0; i < area_size.y; ++i) {
-						((uint32_t *)channel.data)[dst_ri + i] = defval;
-					}
+					bulk_ops::fill_span(
+							Span<uint32_t>(((uint32_t *)channel.data) + dst_ri, area_size.y), uint32_t(defval));
 					break;
 
 				case DEPTH_64_BIT:
-					for (int i = 0; i < area_size.y; ++i) {
-						((uint64_t *)channel.data)[dst_ri + i] = defval;
-					}
+					bulk_ops::fill_span(Span<uint64_t>(((uint64_t *)channel.data) + dst_ri, area_size.y), defval);
 					break;
 
 				default:
@@ -426,6 +454,10 @@ bool VoxelBufferInternal::is_uniform(const Channel &channel) {
 		// Channel has been optimized
 		return true;
 	}
+	if (channel.format != Channel::FORMAT_DENSE) {
+		// Compaction analysis only keeps these formats when several values differ
+		return false;
+	}
 
 	// Channel isn't optimized, so must look at each voxel
 	switch (channel.depth) {
@@ -471,6 +503,14 @@ void VoxelBufferInternal::compress_uniform_channels() {
 	for (unsigned int i = 0; i < MAX_CHANNELS; ++i) {
 		Channel &channel = _channels[i];
 		compress_if_uniform(channel);
+		if (channel.data != nullptr) {
+			// Not all-uniform; mostly-uniform channels (floating islands are mostly air) can
+			// still shed most of their memory with per-tile storage, and wide channels holding
+			// few distinct values (blocky TYPE data) with a palette
+			if (!compress_channel_to_tiled(channel)) {
+				compress_channel_to_paletted(channel);
+			}
+		}
 	}
 }
 
@@ -486,6 +526,8 @@ void VoxelBufferInternal::decompress_channel(unsigned int channel_index) {
 	Channel &channel = _channels[channel_index];
 	if (channel.data == nullptr) {
 		ZN_ASSERT_RETURN(create_channel(channel_index, channel.defval));
+	} else if (channel.format != Channel::FORMAT_DENSE) {
+		densify_channel(channel);
 	}
 }
 
@@ -495,6 +537,12 @@ VoxelBufferInternal::Compression VoxelBufferInternal::get_channel_compression(un
 	if (channel.data == nullptr) {
 		return COMPRESSION_UNIFORM;
 	}
+	if (channel.format == Channel::FORMAT_TILED) {
+		return COMPRESSION_TILED;
+	}
+	if (channel.format == Channel::FORMAT_PALETTED) {
+		return COMPRESSION_PALETTED;
+	}
 	return COMPRESSION_NONE;
 }
 
@@ -521,10 +569,19 @@ void VoxelBufferInternal::copy_from(const VoxelBufferInternal &other, unsigned i
 	ZN_ASSERT_RETURN(other_channel.depth == channel.depth);
 
 	if (other_channel.data != nullptr) {
+		if (channel.data != nullptr &&
+				(channel.size_in_bytes != other_channel.size_in_bytes || channel.format != other_channel.format)) {
+			// Tiled payloads have content-dependent sizes, realloc to match the source
+			delete_channel(channel_index);
+		}
 		if (channel.data == nullptr) {
-			ZN_ASSERT_RETURN(create_channel_noinit(channel_index, _size));
+			channel.data = allocate_channel_data(other_channel.size_in_bytes);
+			ZN_ASSERT_RETURN(channel.data != nullptr);
+			channel.cow_refcount = allocate_channel_refcount();
+			channel.size_in_bytes = other_channel.size_in_bytes;
 		}
-		ZN_ASSERT(channel.size_in_bytes == other_channel.size_in_bytes);
+		// The whole payload is overwritten; raw copy is format-agnostic
+		ensure_channel_unique(channel, false);
 		memcpy(channel.data, other_channel.data, channel.size_in_bytes);
 
 	} else if (channel.data != nullptr) {
@@ -533,6 +590,9 @@ void VoxelBufferInternal::copy_from(const VoxelBufferInternal &other, unsigned i
 
 	channel.defval = other_channel.defval;
 	channel.depth = other_channel.depth;
+	// Raw copy preserves whatever ordering and format the source had
+	channel.layout = other_channel.layout;
+	channel.format = other_channel.format;
 }
 
 // TODO Disallow copying from overlapping areas of the same buffer
@@ -545,6 +605,14 @@ void VoxelBufferInternal::copy_from(const VoxelBufferInternal &other, Vector3i s
 	const Channel &other_channel = other._channels[channel_index];
 
 	ZN_ASSERT_RETURN(other_channel.depth == channel.depth);
+	// Region copies assume linear ordering on both sides. Convert the source first if needed.
+	ZN_ASSERT_RETURN(other_channel.layout == CHANNEL_LAYOUT_ZXY);
+	set_channel_layout(channel_index, CHANNEL_LAYOUT_ZXY);
+
+	// Writes operate on dense data, compact storage converts back transparently
+	if (channel.format != Channel::FORMAT_DENSE) {
+		densify_channel(channel);
+	}
 
 	if (channel.data == nullptr && other_channel.data == nullptr && channel.defval == other_channel.defval) {
 		// No action needed
@@ -557,8 +625,17 @@ void VoxelBufferInternal::copy_from(const VoxelBufferInternal &other, Vector3i s
 			// We assume that this case is not frequent enough to bother, and compression can happen later
 			ZN_ASSERT_RETURN(create_channel(channel_index, channel.defval));
 		}
+		ensure_channel_unique(channel, true);
 		const unsigned int item_size = get_depth_byte_count(channel.depth);
 		Span<const uint8_t> src(other_channel.data, other_channel.size_in_bytes);
+		if (other_channel.format != Channel::FORMAT_DENSE) {
+			// Compact sources are decoded up-front; region reads from blocks resident in compact
+			// form happen on every mesh of their area, a linear decode is the cheap part of that
+			static thread_local std::vector<uint8_t> tls_decoded_channel;
+			tls_decoded_channel.resize(get_size_in_bytes_for_volume(other._size, other_channel.depth));
+			other.decode_channel_to_dense(other_channel, to_span(tls_decoded_channel));
+			src = to_span_const(tls_decoded_channel);
+		}
 		Span<uint8_t> dst(channel.data, channel.size_in_bytes);
 		copy_3d_region_zxy(dst, _size, dst_min, src, other._size, src_min, src_max, item_size);
 
@@ -587,6 +664,93 @@ void VoxelBufferInternal::duplicate_to(VoxelBufferInternal &dst, bool include_me
 	}
 }
 
+void VoxelBufferInternal::convert_channel_depth(unsigned int channel_index, Depth new_depth, bool normalized) {
+	ZN_ASSERT_RETURN(channel_index < MAX_CHANNELS);
+	ZN_ASSERT_RETURN(new_depth >= 0 && new_depth < DEPTH_COUNT);
+	Channel &channel = _channels[channel_index];
+	if (channel.depth == new_depth) {
+		return;
+	}
+
+	const unsigned int new_bits = get_depth_bit_count(new_depth);
+	const uint64_t max_raw = new_bits >= 64 ? ~uint64_t(0) : ((uint64_t(1) << new_bits) - 1);
+	// `set_voxel` takes raw values through `int`, which cannot carry 64-bit integers
+	ZN_ASSERT_RETURN_MSG(
+			normalized || new_bits <= 32, "Raw conversion to 64-bit channels is not supported");
+
+	if (is_uniform(channel)) {
+		const uint64_t old_value = channel.defval;
+		const Depth old_depth = channel.depth;
+		channel.depth = new_depth;
+		if (normalized) {
+			channel.defval = real_to_raw_voxel(raw_voxel_to_real(old_value, old_depth), new_depth);
+		} else {
+			channel.defval = math::min(old_value, max_raw);
+		}
+		return;
+	}
+
+	// Dense: convert into a scratch buffer of the target format, then steal its payload
+	VoxelBufferInternal tmp;
+	tmp.create(_size);
+	tmp.set_channel_depth(channel_index, new_depth);
+	tmp.decompress_channel(channel_index);
+
+	const Vector3i size = _size;
+	Vector3i pos;
+	for (pos.z = 0; pos.z < size.z; ++pos.z) {
+		for (pos.x = 0; pos.x < size.x; ++pos.x) {
+			for (pos.y = 0; pos.y < size.y; ++pos.y) {
+				if (normalized) {
+					tmp.set_voxel_f(get_voxel_f(pos.x, pos.y, pos.z, channel_index), pos.x, pos.y, pos.z,
+							channel_index);
+				} else {
+					tmp.set_voxel(math::min(get_voxel(pos.x, pos.y, pos.z, channel_index), max_raw), pos.x, pos.y,
+							pos.z, channel_index);
+				}
+			}
+		}
+	}
+
+	delete_channel(channel_index);
+	Channel &tmp_channel = tmp._channels[channel_index];
+	channel = tmp_channel;
+	// Ownership moved; the scratch buffer must not free the payload
+	tmp_channel.data = nullptr;
+	tmp_channel.cow_refcount = nullptr;
+}
+
+void VoxelBufferInternal::copy_shared_from(const VoxelBufferInternal &src, bool include_metadata) {
+	ZN_PROFILE_SCOPE();
+
+	clear();
+
+	_size = src._size;
+
+	for (unsigned int i = 0; i < _channels.size(); ++i) {
+		const Channel &src_channel = src._channels[i];
+		Channel &channel = _channels[i];
+
+		channel.defval = src_channel.defval;
+		channel.depth = src_channel.depth;
+		channel.layout = src_channel.layout;
+		channel.format = src_channel.format;
+		channel.size_in_bytes = src_channel.size_in_bytes;
+
+		if (src_channel.data != nullptr) {
+			ZN_ASSERT(src_channel.cow_refcount != nullptr);
+			// The payload is shared, writes on either side will detach a unique copy
+			src_channel.cow_refcount->fetch_add(1, std::memory_order_acq_rel);
+			channel.data = src_channel.data;
+			channel.cow_refcount = src_channel.cow_refcount;
+		}
+	}
+
+	if (include_metadata) {
+		copy_voxel_metadata(src);
+	}
+}
+
 void VoxelBufferInternal::move_to(VoxelBufferInternal &dst) {
 	if (this == &dst) {
 		ZN_PRINT_VERBOSE("Moving VoxelBufferInternal to itself?");
@@ -604,13 +768,24 @@ void VoxelBufferInternal::move_to(VoxelBufferInternal &dst) {
 	for (unsigned int i = 0; i < _channels.size(); ++i) {
 		Channel &channel = _channels[i];
 		channel.data = nullptr;
+		channel.cow_refcount = nullptr;
 		channel.size_in_bytes = 0;
+		channel.format = Channel::FORMAT_DENSE;
 	}
 }
 
 bool VoxelBufferInternal::get_channel_raw(unsigned int channel_index, Span<uint8_t> &slice) const {
 	const Channel &channel = _channels[channel_index];
 	if (channel.data != nullptr) {
+		if (channel.format != Channel::FORMAT_DENSE) {
+			// Raw access means dense layout; same `const` caveat as the detach below
+			const_cast<VoxelBufferInternal *>(this)->densify_channel(const_cast<Channel &>(channel));
+		}
+		// The returned span is writable, so payloads shared by copy-on-write must be detached.
+		// This accessor predates COW and is `const` while handing out mutable data; changing that
+		// would touch every caller, so the detach is done here. Read-only users should prefer
+		// `get_channel_raw_read_only`, which never detaches.
+		ensure_channel_unique(const_cast<Channel &>(channel), true);
 		slice = Span<uint8_t>(channel.data, 0, channel.size_in_bytes);
 		return true;
 	}
@@ -618,6 +793,18 @@ bool VoxelBufferInternal::get_channel_raw(unsigned int channel_index, Span<uint8
 	return false;
 }
 
+bool VoxelBufferInternal::get_channel_raw_read_only(unsigned int channel_index, Span<const uint8_t> &slice) const {
+	const Channel &channel = _channels[channel_index];
+	// Compact channels have no dense bytes to hand out; callers fall back to generic access
+	// (or use `get_channel_as_dense`)
+	if (channel.data != nullptr && channel.format == Channel::FORMAT_DENSE) {
+		slice = Span<const uint8_t>(channel.data, 0, channel.size_in_bytes);
+		return true;
+	}
+	slice = Span<const uint8_t>();
+	return false;
+}
+
 bool VoxelBufferInternal::create_channel(int i, uint64_t defval) {
 	if (!create_channel_noinit(i, _size)) {
 		return false;
@@ -641,7 +828,9 @@ bool VoxelBufferInternal::create_channel_noinit(int i, Vector3i size) {
 	CRASH_COND(channel.data != nullptr); // The channel must not already be allocated
 	channel.data = allocate_channel_data(size_in_bytes);
 	ZN_ASSERT_RETURN_V(channel.data != nullptr, false);
+	channel.cow_refcount = allocate_channel_refcount();
 	channel.size_in_bytes = size_in_bytes;
+	channel.format = Channel::FORMAT_DENSE;
 	return true;
 }
 
@@ -652,11 +841,457 @@ void VoxelBufferInternal::delete_channel(int i) {
 
 void VoxelBufferInternal::delete_channel(Channel &channel) {
 	ZN_ASSERT_RETURN(channel.data != nullptr);
-	// Don't use `_size` to obtain `data` byte count, since we could have changed `_size` up-front during a create().
-	// `size_in_bytes` reflects what is currently allocated inside `data`, regardless of anything else.
-	free_channel_data(channel.data, channel.size_in_bytes);
+	ZN_ASSERT(channel.cow_refcount != nullptr);
+	// The payload can be shared with other buffers, only the last reference frees it
+	if (channel.cow_refcount->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		// Don't use `_size` to obtain `data` byte count, since we could have changed `_size` up-front during a
+		// create(). `size_in_bytes` reflects what is currently allocated inside `data`, regardless of anything else.
+		free_channel_data(channel.data, channel.size_in_bytes);
+		ZN_DELETE(channel.cow_refcount);
+	}
 	channel.data = nullptr;
+	channel.cow_refcount = nullptr;
 	channel.size_in_bytes = 0;
+	channel.format = Channel::FORMAT_DENSE;
+}
+
+void VoxelBufferInternal::ensure_channel_unique(Channel &channel, bool preserve_contents) {
+	if (channel.data == nullptr) {
+		return;
+	}
+	ZN_ASSERT(channel.cow_refcount != nullptr);
+	if (channel.cow_refcount->load(std::memory_order_acquire) == 1) {
+		// Sole owner, the caller can write in place.
+		// No other thread can be incrementing concurrently: sharing requires the same external
+		// synchronization as reading the buffer, which excludes writers.
+		return;
+	}
+
+	uint8_t *new_data = allocate_channel_data(channel.size_in_bytes);
+	ZN_ASSERT_RETURN(new_data != nullptr);
+	if (preserve_contents) {
+		memcpy(new_data, channel.data, channel.size_in_bytes);
+	}
+
+	if (channel.cow_refcount->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		// Other holders went away in the meantime
+		free_channel_data(channel.data, channel.size_in_bytes);
+		ZN_DELETE(channel.cow_refcount);
+	}
+	channel.data = new_data;
+	channel.cow_refcount = allocate_channel_refcount();
+}
+
+namespace {
+// Tiled channels always use a 4x4x4 grid of tiles
+const unsigned int TILE_GRID_SIZE = 4;
+const unsigned int TILE_COUNT = TILE_GRID_SIZE * TILE_GRID_SIZE * TILE_GRID_SIZE;
+// [uint64 dense_tile_mask][uint64 tile_values[64]]
+const unsigned int TILED_HEADER_SIZE = sizeof(uint64_t) + TILE_COUNT * sizeof(uint64_t);
+
+inline unsigned int get_tile_index(unsigned int tx, unsigned int ty, unsigned int tz) {
+	// Same ZXY convention as voxels
+	return ty + TILE_GRID_SIZE * (tx + TILE_GRID_SIZE * tz);
+}
+
+inline uint64_t read_raw_value(const uint8_t *data, size_t i, VoxelBufferInternal::Depth depth) {
+	switch (depth) {
+		case VoxelBufferInternal::DEPTH_8_BIT:
+			return data[i];
+		case VoxelBufferInternal::DEPTH_16_BIT:
+			return reinterpret_cast<const uint16_t *>(data)[i];
+		case VoxelBufferInternal::DEPTH_32_BIT:
+			return reinterpret_cast<const uint32_t *>(data)[i];
+		case VoxelBufferInternal::DEPTH_64_BIT:
+			return reinterpret_cast<const uint64_t *>(data)[i];
+		default:
+			CRASH_NOW();
+			return 0;
+	}
+}
+} // namespace
+
+// A channel can be stored tiled when the buffer is cubic with a size divisible by the tile grid,
+// and uses the linear layout (tiles address their sub-arrays linearly)
+bool VoxelBufferInternal::compress_channel_to_tiled(Channel &channel) {
+	if (channel.data == nullptr || channel.format != Channel::FORMAT_DENSE ||
+			channel.layout != CHANNEL_LAYOUT_ZXY) {
+		return false;
+	}
+	if (_size.x != _size.y || _size.y != _size.z || (_size.x % TILE_GRID_SIZE) != 0) {
+		return false;
+	}
+
+	const unsigned int tile_size = _size.x / TILE_GRID_SIZE;
+	const unsigned int tile_volume = tile_size * tile_size * tile_size;
+	const unsigned int value_size = get_depth_byte_count(channel.depth);
+	const unsigned int tile_bytes = tile_volume * value_size;
+
+	// First pass: find which tiles hold a single value
+	uint64_t dense_mask = 0;
+	FixedArray<uint64_t, TILE_COUNT> tile_values;
+	unsigned int dense_tile_count = 0;
+
+	for (unsigned int tz = 0; tz < TILE_GRID_SIZE; ++tz) {
+		for (unsigned int tx = 0; tx < TILE_GRID_SIZE; ++tx) {
+			for (unsigned int ty = 0; ty < TILE_GRID_SIZE; ++ty) {
+				const unsigned int t = get_tile_index(tx, ty, tz);
+				const Vector3i tile_origin(tx * tile_size, ty * tile_size, tz * tile_size);
+				const uint64_t first_value =
+						read_raw_value(channel.data, get_index(tile_origin, _size), channel.depth);
+				bool tile_uniform = true;
+				for (unsigned int z = 0; z < tile_size && tile_uniform; ++z) {
+					for (unsigned int x = 0; x < tile_size && tile_uniform; ++x) {
+						// Y is the innermost coordinate, a tile row is contiguous
+						const size_t row_begin = get_index(
+								tile_origin + Vector3i(x, 0, z), _size);
+						for (unsigned int y = 0; y < tile_size; ++y) {
+							if (read_raw_value(channel.data, row_begin + y, channel.depth) != first_value) {
+								tile_uniform = false;
+								break;
+							}
+						}
+					}
+				}
+				if (tile_uniform) {
+					tile_values[t] = first_value;
+				} else {
+					dense_mask |= uint64_t(1) << t;
+					++dense_tile_count;
+				}
+			}
+		}
+	}
+
+	// Only convert when it pays off clearly; borderline cases aren't worth the slower reads
+	const size_t tiled_size = TILED_HEADER_SIZE + size_t(dense_tile_count) * tile_bytes;
+	if (tiled_size * 2 > channel.size_in_bytes) {
+		return false;
+	}
+
+	// Second pass: build the tiled payload
+	uint8_t *tiled_data = allocate_channel_data(tiled_size);
+	ZN_ASSERT_RETURN_V(tiled_data != nullptr, false);
+
+	uint64_t *header = reinterpret_cast<uint64_t *>(tiled_data);
+	header[0] = dense_mask;
+	uint64_t *value_slots = header + 1;
+
+	size_t payload_offset = TILED_HEADER_SIZE;
+	for (unsigned int tz = 0; tz < TILE_GRID_SIZE; ++tz) {
+		for (unsigned int tx = 0; tx < TILE_GRID_SIZE; ++tx) {
+			for (unsigned int ty = 0; ty < TILE_GRID_SIZE; ++ty) {
+				const unsigned int t = get_tile_index(tx, ty, tz);
+				if ((dense_mask & (uint64_t(1) << t)) == 0) {
+					value_slots[t] = tile_values[t];
+					continue;
+				}
+				// Dense tile: the value slot stores the payload offset of its data
+				value_slots[t] = payload_offset;
+				uint8_t *tile_dst = tiled_data + payload_offset;
+				const Vector3i tile_origin(tx * tile_size, ty * tile_size, tz * tile_size);
+				size_t di = 0;
+				for (unsigned int z = 0; z < tile_size; ++z) {
+					for (unsigned int x = 0; x < tile_size; ++x) {
+						const size_t row_begin = get_index(tile_origin + Vector3i(x, 0, z), _size);
+						memcpy(tile_dst + di * value_size, channel.data + row_begin * value_size,
+								tile_size * value_size);
+						di += tile_size;
+					}
+				}
+				payload_offset += tile_bytes;
+			}
+		}
+	}
+
+	delete_channel(channel);
+	channel.data = tiled_data;
+	channel.cow_refcount = allocate_channel_refcount();
+	channel.size_in_bytes = tiled_size;
+	channel.format = Channel::FORMAT_TILED;
+	return true;
+}
+
+uint64_t VoxelBufferInternal::get_voxel_tiled(const Channel &channel, int x, int y, int z) const {
+	const unsigned int tile_size = _size.x / TILE_GRID_SIZE;
+	const unsigned int t = get_tile_index(x / tile_size, y / tile_size, z / tile_size);
+	const uint64_t dense_mask = *reinterpret_cast<const uint64_t *>(channel.data);
+	const uint64_t slot = reinterpret_cast<const uint64_t *>(channel.data)[1 + t];
+	if ((dense_mask & (uint64_t(1) << t)) == 0) {
+		return slot;
+	}
+	const unsigned int lx = x % tile_size;
+	const unsigned int ly = y % tile_size;
+	const unsigned int lz = z % tile_size;
+	const size_t i = ly + tile_size * (lx + tile_size * lz);
+	return read_raw_value(channel.data + slot, i, channel.depth);
+}
+
+void VoxelBufferInternal::decode_tiled_channel(const Channel &channel, Span<uint8_t> dst) const {
+	ZN_ASSERT_RETURN(channel.format == Channel::FORMAT_TILED);
+	const size_t dense_size = get_size_in_bytes_for_volume(_size, channel.depth);
+	ZN_ASSERT_RETURN(dst.size() >= dense_size);
+
+	const unsigned int tile_size = _size.x / TILE_GRID_SIZE;
+	const unsigned int value_size = get_depth_byte_count(channel.depth);
+	const uint64_t dense_mask = *reinterpret_cast<const uint64_t *>(channel.data);
+	const uint64_t *value_slots = reinterpret_cast<const uint64_t *>(channel.data) + 1;
+
+	for (unsigned int tz = 0; tz < TILE_GRID_SIZE; ++tz) {
+		for (unsigned int tx = 0; tx < TILE_GRID_SIZE; ++tx) {
+			for (unsigned int ty = 0; ty < TILE_GRID_SIZE; ++ty) {
+				const unsigned int t = get_tile_index(tx, ty, tz);
+				const Vector3i tile_origin(tx * tile_size, ty * tile_size, tz * tile_size);
+
+				if ((dense_mask & (uint64_t(1) << t)) != 0) {
+					const uint8_t *tile_src = channel.data + value_slots[t];
+					size_t si = 0;
+					for (unsigned int z = 0; z < tile_size; ++z) {
+						for (unsigned int x = 0; x < tile_size; ++x) {
+							const size_t row_begin = get_index(tile_origin + Vector3i(x, 0, z), _size);
+							memcpy(dst.data() + row_begin * value_size, tile_src + si * value_size,
+									tile_size * value_size);
+							si += tile_size;
+						}
+					}
+
+				} else {
+					const uint64_t v = value_slots[t];
+					for (unsigned int z = 0; z < tile_size; ++z) {
+						for (unsigned int x = 0; x < tile_size; ++x) {
+							const size_t row_begin = get_index(tile_origin + Vector3i(x, 0, z), _size);
+							uint8_t *row = dst.data() + row_begin * value_size;
+							switch (channel.depth) {
+								case DEPTH_8_BIT:
+									memset(row, v, tile_size);
+									break;
+								case DEPTH_16_BIT:
+									for (unsigned int y = 0; y < tile_size; ++y) {
+										reinterpret_cast<uint16_t *>(row)[y] = v;
+									}
+									break;
+								case DEPTH_32_BIT:
+									for (unsigned int y = 0; y < tile_size; ++y) {
+										reinterpret_cast<uint32_t *>(row)[y] = v;
+									}
+									break;
+								case DEPTH_64_BIT:
+									for (unsigned int y = 0; y < tile_size; ++y) {
+										reinterpret_cast<uint64_t *>(row)[y] = v;
+									}
+									break;
+								default:
+									CRASH_NOW();
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+void VoxelBufferInternal::densify_channel(Channel &channel) {
+	ZN_ASSERT_RETURN(channel.format != Channel::FORMAT_DENSE);
+	const size_t dense_size = get_size_in_bytes_for_volume(_size, channel.depth);
+	uint8_t *dense_data = allocate_channel_data(dense_size);
+	ZN_ASSERT_RETURN(dense_data != nullptr);
+	decode_channel_to_dense(channel, Span<uint8_t>(dense_data, dense_size));
+	delete_channel(channel);
+	channel.data = dense_data;
+	channel.cow_refcount = allocate_channel_refcount();
+	channel.size_in_bytes = dense_size;
+	channel.format = Channel::FORMAT_DENSE;
+}
+
+void VoxelBufferInternal::decode_channel_to_dense(const Channel &channel, Span<uint8_t> dst) const {
+	switch (channel.format) {
+		case Channel::FORMAT_TILED:
+			decode_tiled_channel(channel, dst);
+			break;
+		case Channel::FORMAT_PALETTED:
+			decode_paletted_channel(channel, dst);
+			break;
+		default:
+			CRASH_NOW();
+	}
+}
+
+uint64_t VoxelBufferInternal::get_voxel_compact(const Channel &channel, int x, int y, int z) const {
+	switch (channel.format) {
+		case Channel::FORMAT_TILED:
+			return get_voxel_tiled(channel, x, y, z);
+		case Channel::FORMAT_PALETTED:
+			return get_voxel_paletted(channel, x, y, z);
+		default:
+			CRASH_NOW();
+			return 0;
+	}
+}
+
+bool VoxelBufferInternal::compress_channel_to_paletted(Channel &channel) {
+	if (channel.data == nullptr || channel.format != Channel::FORMAT_DENSE ||
+			channel.layout != CHANNEL_LAYOUT_ZXY) {
+		return false;
+	}
+	if (get_depth_byte_count(channel.depth) < 2) {
+		// 8-bit channels can't be made smaller by 8-bit indices
+		return false;
+	}
+
+	const size_t volume = get_volume();
+
+	// First pass: gather distinct values
+	static thread_local std::unordered_map<uint64_t, uint8_t> tls_palette_map;
+	tls_palette_map.clear();
+	FixedArray<uint64_t, 256> palette;
+
+	for (size_t i = 0; i < volume; ++i) {
+		const uint64_t v = read_raw_value(channel.data, i, channel.depth);
+		auto insertion = tls_palette_map.insert({ v, uint8_t(tls_palette_map.size()) });
+		if (insertion.second) {
+			if (tls_palette_map.size() > 256) {
+				// Too many distinct values
+				return false;
+			}
+			palette[insertion.first->second] = v;
+		}
+	}
+	const size_t palette_count = tls_palette_map.size();
+
+	// Only convert when it pays off clearly
+	const size_t paletted_size = sizeof(uint64_t) * (1 + palette_count) + volume;
+	if (paletted_size * 4 > size_t(channel.size_in_bytes) * 3) {
+		return false;
+	}
+
+	uint8_t *paletted_data = allocate_channel_data(paletted_size);
+	ZN_ASSERT_RETURN_V(paletted_data != nullptr, false);
+
+	uint64_t *header = reinterpret_cast<uint64_t *>(paletted_data);
+	header[0] = palette_count;
+	for (size_t i = 0; i < palette_count; ++i) {
+		header[1 + i] = palette[i];
+	}
+
+	uint8_t *indices = paletted_data + sizeof(uint64_t) * (1 + palette_count);
+	for (size_t i = 0; i < volume; ++i) {
+		indices[i] = tls_palette_map[read_raw_value(channel.data, i, channel.depth)];
+	}
+
+	delete_channel(channel);
+	channel.data = paletted_data;
+	channel.cow_refcount = allocate_channel_refcount();
+	channel.size_in_bytes = paletted_size;
+	channel.format = Channel::FORMAT_PALETTED;
+	return true;
+}
+
+uint64_t VoxelBufferInternal::get_voxel_paletted(const Channel &channel, int x, int y, int z) const {
+	const uint64_t *header = reinterpret_cast<const uint64_t *>(channel.data);
+	const uint64_t palette_count = header[0];
+	const uint8_t *indices = channel.data + sizeof(uint64_t) * (1 + palette_count);
+	const size_t i = get_index(x, y, z);
+	return header[1 + indices[i]];
+}
+
+void VoxelBufferInternal::decode_paletted_channel(const Channel &channel, Span<uint8_t> dst) const {
+	ZN_ASSERT_RETURN(channel.format == Channel::FORMAT_PALETTED);
+	const size_t dense_size = get_size_in_bytes_for_volume(_size, channel.depth);
+	ZN_ASSERT_RETURN(dst.size() >= dense_size);
+
+	const uint64_t *header = reinterpret_cast<const uint64_t *>(channel.data);
+	const uint64_t palette_count = header[0];
+	const uint64_t *palette = header + 1;
+	const uint8_t *indices = channel.data + sizeof(uint64_t) * (1 + palette_count);
+	const size_t volume = get_volume();
+
+	switch (channel.depth) {
+		case DEPTH_8_BIT:
+			for (size_t i = 0; i < volume; ++i) {
+				dst[i] = palette[indices[i]];
+			}
+			break;
+		case DEPTH_16_BIT: {
+			uint16_t *dst16 = reinterpret_cast<uint16_t *>(dst.data());
+			for (size_t i = 0; i < volume; ++i) {
+				dst16[i] = palette[indices[i]];
+			}
+		} break;
+		case DEPTH_32_BIT: {
+			uint32_t *dst32 = reinterpret_cast<uint32_t *>(dst.data());
+			for (size_t i = 0; i < volume; ++i) {
+				dst32[i] = palette[indices[i]];
+			}
+		} break;
+		case DEPTH_64_BIT: {
+			uint64_t *dst64 = reinterpret_cast<uint64_t *>(dst.data());
+			for (size_t i = 0; i < volume; ++i) {
+				dst64[i] = palette[indices[i]];
+			}
+		} break;
+		default:
+			CRASH_NOW();
+	}
+}
+
+bool VoxelBufferInternal::get_channel_paletted_view(
+		unsigned int channel_index, Span<const uint8_t> &out_indices, Span<const uint64_t> &out_palette) const {
+	ZN_ASSERT_RETURN_V(channel_index < MAX_CHANNELS, false);
+	const Channel &channel = _channels[channel_index];
+	if (channel.data == nullptr || channel.format != Channel::FORMAT_PALETTED) {
+		return false;
+	}
+	const uint64_t *header = reinterpret_cast<const uint64_t *>(channel.data);
+	const uint64_t palette_count = header[0];
+	out_palette = Span<const uint64_t>(header + 1, palette_count);
+	out_indices = Span<const uint8_t>(
+			channel.data + sizeof(uint64_t) * (1 + palette_count), 0, get_volume());
+	return true;
+}
+
+bool VoxelBufferInternal::set_channel_paletted(
+		unsigned int channel_index, Span<const uint64_t> palette, Span<const uint8_t> indices) {
+	ZN_ASSERT_RETURN_V(channel_index < MAX_CHANNELS, false);
+	ZN_ASSERT_RETURN_V(palette.size() > 0 && palette.size() <= 256, false);
+	ZN_ASSERT_RETURN_V(indices.size() == size_t(get_volume()), false);
+	Channel &channel = _channels[channel_index];
+	ZN_ASSERT_RETURN_V(get_depth_byte_count(channel.depth) >= 2, false);
+	ZN_ASSERT_RETURN_V(channel.layout == CHANNEL_LAYOUT_ZXY, false);
+
+	if (channel.data != nullptr) {
+		delete_channel(channel);
+	}
+
+	const size_t paletted_size = sizeof(uint64_t) * (1 + palette.size()) + indices.size();
+	channel.data = allocate_channel_data(paletted_size);
+	ZN_ASSERT_RETURN_V(channel.data != nullptr, false);
+	channel.cow_refcount = allocate_channel_refcount();
+	channel.size_in_bytes = paletted_size;
+	channel.format = Channel::FORMAT_PALETTED;
+
+	uint64_t *header = reinterpret_cast<uint64_t *>(channel.data);
+	header[0] = palette.size();
+	memcpy(header + 1, palette.data(), palette.size() * sizeof(uint64_t));
+	memcpy(channel.data + sizeof(uint64_t) * (1 + palette.size()), indices.data(), indices.size());
+	return true;
+}
+
+bool VoxelBufferInternal::get_channel_as_dense(
+		unsigned int channel_index, std::vector<uint8_t> &temp, Span<const uint8_t> &out_span) const {
+	ZN_ASSERT_RETURN_V(channel_index < MAX_CHANNELS, false);
+	const Channel &channel = _channels[channel_index];
+	if (channel.data == nullptr) {
+		return false;
+	}
+	if (channel.format != Channel::FORMAT_DENSE) {
+		temp.resize(get_size_in_bytes_for_volume(_size, channel.depth));
+		decode_channel_to_dense(channel, to_span(temp));
+		out_span = to_span_const(temp);
+		return true;
+	}
+	out_span = Span<const uint8_t>(channel.data, 0, channel.size_in_bytes);
+	return true;
 }
 
 void VoxelBufferInternal::downscale_to(
@@ -681,7 +1316,15 @@ void VoxelBufferInternal::downscale_to(
 			continue;
 		}
 
-		// Nearest-neighbor downscaling
+		// Nearest-neighbor downscaling.
+		// When depths differ, raw values can't be copied; SDF goes through its normalized float
+		// representation with a small positional dither before requantization, which breaks up
+		// the banding that used to make narrow depths unusable. Other channels convert raw.
+		const bool requantize = src_channel.depth != dst_channel.depth;
+		const bool dither = requantize && channel_index == CHANNEL_SDF &&
+				get_depth_bit_count(dst_channel.depth) < get_depth_bit_count(src_channel.depth);
+		// Half a destination quantization step, in normalized units
+		const float dither_amplitude = dither ? 0.5f / float((uint64_t(1) << (get_depth_bit_count(dst_channel.depth) - 1)) - 1) : 0.f;
 
 		Vector3i pos;
 		for (pos.z = dst_min.z; pos.z < dst_max.z; ++pos.z) {
@@ -692,6 +1335,18 @@ void VoxelBufferInternal::downscale_to(
 					// TODO Remove check once it works
 					ZN_ASSERT(is_position_valid(src_pos.x, src_pos.y, src_pos.z));
 
+					if (requantize && channel_index == CHANNEL_SDF) {
+						// `get_voxel_f` resolves uniform channels through their default value
+						float f = get_voxel_f(src_pos.x, src_pos.y, src_pos.z, channel_index);
+						if (dither) {
+							// Cheap 2-bit positional hash, alternating the rounding direction
+							const int h = (pos.x ^ (pos.y << 1) ^ (pos.z << 2)) & 3;
+							f += dither_amplitude * (float(h) * (2.f / 3.f) - 1.f);
+						}
+						dst.set_voxel_f(f, pos.x, pos.y, pos.z, channel_index);
+						continue;
+					}
+
 					uint64_t v;
 					if (src_channel.data) {
 						// TODO Optimized version?
@@ -725,6 +1380,16 @@ bool VoxelBufferInternal::equals(const VoxelBufferInternal &p_other) const {
 			return false;
 		}
 
+		if (channel.layout != other_channel.layout) {
+			// Note: could still be logically equal, but comparing across layouts is not worth the complexity here
+			return false;
+		}
+
+		if (channel.format != other_channel.format) {
+			// Same note as layouts: logically-equal contents in different formats count as different
+			return false;
+		}
+
 		if (channel.data == nullptr) {
 			if (channel.defval != other_channel.defval) {
 				return false;
@@ -763,6 +1428,52 @@ VoxelBufferInternal::Depth VoxelBufferInternal::get_channel_depth(unsigned int c
 	return _channels[channel_index].depth;
 }
 
+void VoxelBufferInternal::set_channel_layout(unsigned int channel_index, ChannelLayout new_layout) {
+	ZN_ASSERT_RETURN(channel_index < MAX_CHANNELS);
+	ZN_ASSERT_RETURN(new_layout >= 0 && new_layout < CHANNEL_LAYOUT_COUNT);
+	Channel &channel = _channels[channel_index];
+	if (channel.layout == new_layout) {
+		return;
+	}
+	// Layout conversion operates on dense data
+	if (channel.format != Channel::FORMAT_DENSE) {
+		densify_channel(channel);
+	}
+	if (new_layout == CHANNEL_LAYOUT_MORTON) {
+		// Morton indexing is dense only over cubic power-of-two volumes
+		ZN_ASSERT_RETURN_MSG(_size.x == _size.y && _size.y == _size.z && math::is_power_of_two(_size.x),
+				"Morton layout requires a cubic power-of-two sized buffer");
+	}
+	if (channel.data != nullptr) {
+		// Reorder through a second buffer, the permutation can't be done in place cheaply
+		uint8_t *new_data = allocate_channel_data(channel.size_in_bytes);
+		ZN_ASSERT_RETURN(new_data != nullptr);
+		const unsigned int item_size = get_depth_byte_count(channel.depth);
+		Vector3i pos;
+		for (pos.z = 0; pos.z < _size.z; ++pos.z) {
+			for (pos.x = 0; pos.x < _size.x; ++pos.x) {
+				for (pos.y = 0; pos.y < _size.y; ++pos.y) {
+					const size_t src_i = get_index_in_layout(pos.x, pos.y, pos.z, channel.layout);
+					const size_t dst_i = get_index_in_layout(pos.x, pos.y, pos.z, new_layout);
+					memcpy(new_data + dst_i * item_size, channel.data + src_i * item_size, item_size);
+				}
+			}
+		}
+		if (channel.cow_refcount->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			free_channel_data(channel.data, channel.size_in_bytes);
+			ZN_DELETE(channel.cow_refcount);
+		}
+		channel.data = new_data;
+		channel.cow_refcount = allocate_channel_refcount();
+	}
+	channel.layout = new_layout;
+}
+
+VoxelBufferInternal::ChannelLayout VoxelBufferInternal::get_channel_layout(unsigned int channel_index) const {
+	ZN_ASSERT_RETURN_V(channel_index < MAX_CHANNELS, CHANNEL_LAYOUT_ZXY);
+	return _channels[channel_index].layout;
+}
+
 float VoxelBufferInternal::get_sdf_quantization_scale(Depth d) {
 	switch (d) {
 		// Normalized
@@ -787,6 +1498,23 @@ void VoxelBufferInternal::get_range_f(float &out_min, float &out_max, ChannelId
 		return;
 	}
 
+	if (channel.format != Channel::FORMAT_DENSE) {
+		// No linear data to scan, gather per voxel. This path is cold.
+		Vector3i pos;
+		for (pos.z = 0; pos.z < _size.z; ++pos.z) {
+			for (pos.x = 0; pos.x < _size.x; ++pos.x) {
+				for (pos.y = 0; pos.y < _size.y; ++pos.y) {
+					const float v = raw_voxel_to_real(get_voxel_compact(channel, pos.x, pos.y, pos.z), channel.depth);
+					min_value = math::min(v, min_value);
+					max_value = math::max(v, max_value);
+				}
+			}
+		}
+		out_min = min_value;
+		out_max = max_value;
+		return;
+	}
+
 	const uint64_t volume = get_volume();
 
 	switch (channel.depth) {
@@ -798,20 +1526,22 @@ void VoxelBufferInternal::get_range_f(float &out_min, float &out_max, ChannelId
 			}
 			break;
 		case DEPTH_16_BIT: {
-			const int16_t *data = reinterpret_cast<const int16_t *>(channel.data);
-			for (unsigned int i = 0; i < volume; ++i) {
-				const float v = s16_to_snorm(data[i]);
-				min_value = math::min(v, min_value);
-				max_value = math::max(v, max_value);
-			}
+			// Min/max over raw quantized values gives the same result as comparing decoded values,
+			// since the conversion is monotonic
+			int16_t min_raw = 0;
+			int16_t max_raw = 0;
+			bulk_ops::min_max_span_s16(
+					Span<const int16_t>(reinterpret_cast<const int16_t *>(channel.data), volume), min_raw, max_raw);
+			min_value = math::min(float(s16_to_snorm(min_raw)), min_value);
+			max_value = math::max(float(s16_to_snorm(max_raw)), max_value);
 		} break;
 		case DEPTH_32_BIT: {
-			const float *data = reinterpret_cast<const float *>(channel.data);
-			for (unsigned int i = 0; i < volume; ++i) {
-				const float v = data[i];
-				min_value = math::min(v, min_value);
-				max_value = math::max(v, max_value);
-			}
+			float min_raw = 0.f;
+			float max_raw = 0.f;
+			bulk_ops::min_max_span_f32(
+					Span<const float>(reinterpret_cast<const float *>(channel.data), volume), min_raw, max_raw);
+			min_value = math::min(min_raw, min_value);
+			max_value = math::max(max_raw, max_value);
 		} break;
 		case DEPTH_64_BIT: {
 			const double *data = reinterpret_cast<const double *>(channel.data);
@@ -920,16 +1650,23 @@ void VoxelBufferInternal::copy_voxel_metadata_in_area(
 	const Box3i clipped_src_box = src_box.clipped(Box3i(src_box.pos - dst_origin, _size));
 	const Vector3i clipped_dst_offset = dst_origin + clipped_src_box.pos - src_box.pos;
 
+	// Collect then merge once; per-entry `insert_or_assign` re-shifts the flat map every time,
+	// which is quadratic when copying metadata-heavy areas (machines, wires)
+	typedef FlatMapMoveOnly<Vector3i, VoxelMetadata>::Pair Pair;
+	std::vector<Pair> pairs;
 	for (FlatMapMoveOnly<Vector3i, VoxelMetadata>::ConstIterator src_it = src_buffer._voxel_metadata.begin();
 			src_it != src_buffer._voxel_metadata.end(); ++src_it) {
 		if (src_box.contains(src_it->key)) {
 			const Vector3i dst_pos = src_it->key + clipped_dst_offset;
 			ZN_ASSERT(is_position_valid(dst_pos));
 
-			VoxelMetadata &meta = _voxel_metadata.insert_or_assign(dst_pos, VoxelMetadata());
-			meta.copy_from(src_it->value);
+			pairs.resize(pairs.size() + 1);
+			Pair &p = pairs.back();
+			p.key = dst_pos;
+			p.value.copy_from(src_it->value);
 		}
 	}
+	_voxel_metadata.insert_or_assign_bulk(to_span(pairs));
 }
 
 void VoxelBufferInternal::copy_voxel_metadata(const VoxelBufferInternal &src_buffer) {
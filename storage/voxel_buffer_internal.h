@@ -5,10 +5,12 @@
 #include "../util/fixed_array.h"
 #include "../util/flat_map.h"
 #include "../util/math/box3i.h"
+#include "../util/math/morton.h"
 #include "../util/thread/rw_lock.h"
 #include "funcs.h"
 #include "voxel_metadata.h"
 
+#include <atomic>
 #include <limits>
 
 namespace zylann::voxel {
@@ -42,6 +44,12 @@ public:
 	enum Compression {
 		COMPRESSION_NONE = 0,
 		COMPRESSION_UNIFORM,
+		// Per-tile storage for partially-uniform channels, see `Channel::FORMAT_TILED`. Never
+		// written to files: serialization stores such channels as dense.
+		COMPRESSION_TILED,
+		// Palette of distinct values + 8-bit indices, see `Channel::FORMAT_PALETTED`. Unlike
+		// tiled, this one IS written to files (format version 5).
+		COMPRESSION_PALETTED,
 		//COMPRESSION_RLE,
 		COMPRESSION_COUNT
 	};
@@ -54,6 +62,17 @@ public:
 		DEPTH_COUNT
 	};
 
+	// In-memory ordering of voxels within a channel.
+	// Serialized data is always linear ZXY, Morton is converted on serialization.
+	enum ChannelLayout { //
+		// Flat [z][x][y] array, the default. Required by all bulk/span operations.
+		CHANNEL_LAYOUT_ZXY = 0,
+		// Z-order curve. Opt-in, for random stencil access patterns such as mesher gathers.
+		// Only supported on cubic power-of-two sized buffers.
+		CHANNEL_LAYOUT_MORTON,
+		CHANNEL_LAYOUT_COUNT
+	};
+
 	static inline uint32_t get_depth_byte_count(VoxelBufferInternal::Depth d) {
 		ZN_ASSERT(d >= 0 && d < VoxelBufferInternal::DEPTH_COUNT);
 		return 1 << d;
@@ -90,15 +109,41 @@ public:
 	static const uint32_t MAX_SIZE = 65535;
 
 	struct Channel {
+		enum Format { //
+			// Flat array of all voxels
+			FORMAT_DENSE = 0,
+			// 4x4x4 grid of tiles, each either a uniform value or a dense sub-array. Produced by
+			// `compress_uniform_channels` on channels that are mostly one value (air) but not
+			// entirely; any write densifies the channel transparently first.
+			// Payload layout: [uint64 dense_tile_mask][uint64 tile_values[64]][dense tiles...].
+			// For dense tiles, the value slot holds the byte offset of the tile's data instead.
+			FORMAT_TILED,
+			// Palette of up to 256 distinct values with one byte per voxel, for channels holding
+			// few distinct values at wide depths (typically TYPE channels of blocky worlds).
+			// Payload layout: [uint64 palette_count][uint64 palette[count]][uint8 indices...].
+			// Any write densifies the channel transparently first.
+			FORMAT_PALETTED
+		};
+
 		// Allocated when the channel is populated.
 		// Flat array, in order [z][x][y] because it allows faster vertical-wise access (the engine is Y-up).
 		uint8_t *data = nullptr;
 
+		// Reference count of `data`, allocated alongside it. It is above 1 when the payload is
+		// shared with other buffers (see `copy_shared_from`), in which case writes detach a unique
+		// copy first (copy-on-write).
+		std::atomic_uint32_t *cow_refcount = nullptr;
+
 		// Default value when data is null
 		uint64_t defval = 0;
 
 		Depth depth = DEFAULT_CHANNEL_DEPTH;
 
+		ChannelLayout layout = CHANNEL_LAYOUT_ZXY;
+
+		// Storage format of `data`. See `Format`.
+		uint8_t format = FORMAT_DENSE;
+
 		// Storing gigabytes in a single buffer is neither supported nor practical.
 		uint32_t size_in_bytes = 0;
 
@@ -175,7 +220,7 @@ public:
 			unsigned int channel_index) {
 		ZN_ASSERT_RETURN(channel_index < MAX_CHANNELS);
 
-		const Channel &channel = _channels[channel_index];
+		Channel &channel = _channels[channel_index];
 #ifdef DEBUG_ENABLED
 		// Size of source and destination values must match
 		ZN_ASSERT_RETURN(channel.depth == get_depth_from_size(sizeof(T)));
@@ -184,7 +229,10 @@ public:
 		// This function always decompresses the destination.
 		// To keep it compressed, either check what you are about to copy,
 		// or schedule a recompression for later.
+		set_channel_layout(channel_index, CHANNEL_LAYOUT_ZXY);
 		decompress_channel(channel_index);
+		// The payload can be shared by copy-on-write, writes must detach it first
+		ensure_channel_unique(channel, true);
 
 		Span<T> dst(static_cast<T *>(channel.data), channel.size_in_bytes / sizeof(T));
 		copy_3d_region_zxy<T>(dst, _size, dst_min, src, src_size, src_min, src_max);
@@ -209,6 +257,45 @@ public:
 
 		if (channel.data == nullptr) {
 			fill_3d_region_zxy<T>(dst, dst_size, dst_min, dst_min + (src_max - src_min), channel.defval);
+		} else if (channel.format != Channel::FORMAT_DENSE) {
+			// Compact storage has no linear indexing, gather per voxel. Rare path: areas being
+			// read for edits get densified by the following writes anyway.
+			Vector3iUtil::sort_min_max(src_min, src_max);
+			clip_copy_region(src_min, src_max, _size, dst_min, dst_size);
+			const Vector3i area_size = src_max - src_min;
+			if (area_size.x <= 0 || area_size.y <= 0 || area_size.z <= 0) {
+				return;
+			}
+			Vector3i pos;
+			for (pos.z = 0; pos.z < area_size.z; ++pos.z) {
+				for (pos.x = 0; pos.x < area_size.x; ++pos.x) {
+					for (pos.y = 0; pos.y < area_size.y; ++pos.y) {
+						const Vector3i src_pos = src_min + pos;
+						dst[Vector3iUtil::get_zxy_index(dst_min + pos, dst_size)] =
+								T(get_voxel_compact(channel, src_pos.x, src_pos.y, src_pos.z));
+					}
+				}
+			}
+		} else if (channel.layout != CHANNEL_LAYOUT_ZXY) {
+			// Slow path: source indices are not linear in this layout, gather per voxel
+			Vector3iUtil::sort_min_max(src_min, src_max);
+			clip_copy_region(src_min, src_max, _size, dst_min, dst_size);
+			const Vector3i area_size = src_max - src_min;
+			if (area_size.x <= 0 || area_size.y <= 0 || area_size.z <= 0) {
+				return;
+			}
+			const T *src_data = static_cast<const T *>(static_cast<const void *>(channel.data));
+			Vector3i pos;
+			for (pos.z = 0; pos.z < area_size.z; ++pos.z) {
+				for (pos.x = 0; pos.x < area_size.x; ++pos.x) {
+					for (pos.y = 0; pos.y < area_size.y; ++pos.y) {
+						const Vector3i src_pos = src_min + pos;
+						const size_t src_i =
+								get_index_in_layout(src_pos.x, src_pos.y, src_pos.z, channel.layout);
+						dst[Vector3iUtil::get_zxy_index(dst_min + pos, dst_size)] = src_data[src_i];
+					}
+				}
+			}
 		} else {
 			Span<const T> src(static_cast<const T *>(channel.data), channel.size_in_bytes / sizeof(T));
 			copy_3d_region_zxy<T>(dst, dst_size, dst_min, src, _size, src_min, src_max);
@@ -250,6 +337,14 @@ public:
 		return y + _size.y * (x + _size.x * z); // ZXY index
 	}
 
+	// Index of a voxel within a specific channel, accounting for its in-memory layout
+	inline size_t get_index_in_layout(unsigned int x, unsigned int y, unsigned int z, ChannelLayout layout) const {
+		if (layout == CHANNEL_LAYOUT_MORTON) {
+			return math::morton3(x, y, z);
+		}
+		return get_index(x, y, z);
+	}
+
 	template <typename F>
 	inline void for_each_index_and_pos(const Box3i &box, F f) {
 		const Vector3i min_pos = box.pos;
@@ -270,8 +365,12 @@ public:
 	// Data_T action_func(Vector3i pos, Data_T in_v)
 	template <typename F, typename Data_T>
 	void write_box_template(const Box3i &box, unsigned int channel_index, F action_func, Vector3i offset) {
+		// Span iteration below assumes linear ordering
+		set_channel_layout(channel_index, CHANNEL_LAYOUT_ZXY);
 		decompress_channel(channel_index);
 		Channel &channel = _channels[channel_index];
+		// The payload can be shared by copy-on-write, writes must detach it first
+		ensure_channel_unique(channel, true);
 #ifdef DEBUG_ENABLED
 		ZN_ASSERT_RETURN(Box3i(Vector3i(), _size).contains(box));
 		ZN_ASSERT_RETURN(get_depth_byte_count(channel.depth) == sizeof(Data_T));
@@ -288,10 +387,15 @@ public:
 	template <typename F, typename Data0_T, typename Data1_T>
 	void write_box_2_template(
 			const Box3i &box, unsigned int channel_index0, unsigned channel_index1, F action_func, Vector3i offset) {
+		set_channel_layout(channel_index0, CHANNEL_LAYOUT_ZXY);
+		set_channel_layout(channel_index1, CHANNEL_LAYOUT_ZXY);
 		decompress_channel(channel_index0);
 		decompress_channel(channel_index1);
 		Channel &channel0 = _channels[channel_index0];
 		Channel &channel1 = _channels[channel_index1];
+		// The payloads can be shared by copy-on-write, writes must detach them first
+		ensure_channel_unique(channel0, true);
+		ensure_channel_unique(channel1, true);
 #ifdef DEBUG_ENABLED
 		ZN_ASSERT_RETURN(Box3i(Vector3i(), _size).contains(box));
 		ZN_ASSERT_RETURN(get_depth_byte_count(channel0.depth) == sizeof(Data0_T));
@@ -381,6 +485,18 @@ public:
 	}
 
 	void duplicate_to(VoxelBufferInternal &dst, bool include_metadata) const;
+	// Makes this buffer a snapshot of `src` whose decompressed channels share their payloads with
+	// `src`: either side only duplicates a channel when writing to it afterwards (copy-on-write).
+	// Much cheaper than `duplicate_to` when the copy is mostly going to be read, like for saving.
+	// Requires the same external synchronization with writers of `src` as `duplicate_to`.
+	void copy_shared_from(const VoxelBufferInternal &src, bool include_metadata);
+
+	// Converts a channel's stored values to another bit depth, in place. When `normalized` is
+	// true, values convert through their real representation (SDF-style channels); otherwise raw
+	// integers are preserved, clamped to the new depth's range (type/index channels). Meant as an
+	// offline pre-conversion so prefabs match their target volume's format and pastes hit the
+	// zero-copy path instead of converting per voxel on every stamp.
+	void convert_channel_depth(unsigned int channel_index, Depth new_depth, bool normalized);
 	void move_to(VoxelBufferInternal &dst);
 
 	inline bool is_position_valid(unsigned int x, unsigned int y, unsigned int z) const {
@@ -401,6 +517,10 @@ public:
 
 	bool get_channel_raw(unsigned int channel_index, Span<uint8_t> &slice) const;
 
+	// Read-only access to channel data. Unlike `get_channel_raw`, this does not detach payloads
+	// shared by copy-on-write, so it must be preferred everywhere the data is only read.
+	bool get_channel_raw_read_only(unsigned int channel_index, Span<const uint8_t> &slice) const;
+
 	template <typename T>
 	bool get_channel_data(unsigned int channel_index, Span<T> &dst) const {
 		Span<uint8_t> dst8;
@@ -416,6 +536,28 @@ public:
 	void set_channel_depth(unsigned int channel_index, Depth new_depth);
 	Depth get_channel_depth(unsigned int channel_index) const;
 
+	// Changes the in-memory ordering of a channel, converting existing data if any.
+	// Morton layout requires the buffer to be cubic with a power-of-two size.
+	// Voxel accessors handle any layout; bulk/span operations convert back to ZXY on demand.
+	void set_channel_layout(unsigned int channel_index, ChannelLayout new_layout);
+	ChannelLayout get_channel_layout(unsigned int channel_index) const;
+
+	// Serializer helper: hands out the channel's dense bytes. Returns them directly for dense
+	// channels, decodes compact ones (tiled, paletted) into `temp`. Returns false for uniform
+	// channels.
+	bool get_channel_as_dense(unsigned int channel_index, std::vector<uint8_t> &temp,
+			Span<const uint8_t> &out_span) const;
+
+	// Direct view of a paletted channel: per-voxel 8-bit indices and the value table they point
+	// into. Returns false if the channel isn't paletted. Used by serialization and by meshers
+	// able to consume paletted data without expanding it.
+	bool get_channel_paletted_view(unsigned int channel_index, Span<const uint8_t> &out_indices,
+			Span<const uint64_t> &out_palette) const;
+
+	// Rebuilds a paletted channel from its serialized parts. Fails if sizes are inconsistent.
+	bool set_channel_paletted(
+			unsigned int channel_index, Span<const uint64_t> palette, Span<const uint8_t> indices);
+
 	// When using lower than 32-bit resolution for terrain signed distance fields,
 	// it should be scaled to better fit the range of represented values since the storage is normalized to -1..1.
 	// This returns that scale for a given depth configuration.
@@ -480,12 +622,26 @@ public:
 
 private:
 	bool create_channel_noinit(int i, Vector3i size);
+
+	// Detaches the channel from a shared payload so it can be written to.
+	// `preserve_contents` can be false when the whole payload is about to be overwritten.
+	static void ensure_channel_unique(Channel &channel, bool preserve_contents);
 	bool create_channel(int i, uint64_t defval);
 	void delete_channel(int i);
 	void compress_if_uniform(Channel &channel);
 	static void delete_channel(Channel &channel);
 	static void clear_channel(Channel &channel, uint64_t clear_value);
 	static bool is_uniform(const Channel &channel);
+	// Compact-format internals, see `Channel::Format`
+	bool compress_channel_to_tiled(Channel &channel);
+	bool compress_channel_to_paletted(Channel &channel);
+	void densify_channel(Channel &channel);
+	void decode_tiled_channel(const Channel &channel, Span<uint8_t> dst) const;
+	void decode_paletted_channel(const Channel &channel, Span<uint8_t> dst) const;
+	void decode_channel_to_dense(const Channel &channel, Span<uint8_t> dst) const;
+	uint64_t get_voxel_tiled(const Channel &channel, int x, int y, int z) const;
+	uint64_t get_voxel_paletted(const Channel &channel, int x, int y, int z) const;
+	uint64_t get_voxel_compact(const Channel &channel, int x, int y, int z) const;
 
 private:
 	// Each channel can store arbitary data.
@@ -1,16 +1,130 @@
 #include "voxel_data_block.h"
+
+#include <core/os/time.h>
 #include "../util/log.h"
 #include "../util/string_funcs.h"
 
+#include <limits>
+
 namespace zylann::voxel {
 
+uint8_t VoxelDataBlock::get_or_compute_face_openness() const {
+	uint8_t cached = _face_openness.load(std::memory_order_acquire);
+	if ((cached & 0x80) != 0) {
+		return cached & 0x3f;
+	}
+
+	uint8_t bits = 0;
+	{
+		RWLockRead rlock(_voxels->get_lock());
+		const VoxelBufferInternal &vb = *_voxels;
+		const unsigned int channel = VoxelBufferInternal::CHANNEL_SDF;
+		const Vector3i bs = vb.get_size();
+
+		if (vb.get_channel_compression(channel) == VoxelBufferInternal::COMPRESSION_UNIFORM) {
+			if (vb.get_voxel_f(0, 0, 0, channel) >= 0.f) {
+				bits = 0x3f;
+			}
+		} else {
+			// Scan each face plane for any non-solid voxel
+			for (unsigned int axis = 0; axis < 3; ++axis) {
+				const unsigned int axis_u = (axis + 1) % 3;
+				const unsigned int axis_v = (axis + 2) % 3;
+				for (unsigned int side = 0; side < 2; ++side) {
+					const unsigned int face_bit = 1 << (axis * 2 + side);
+					Vector3i pos;
+					pos[axis] = side == 0 ? 0 : bs[axis] - 1;
+					bool open = false;
+					for (int v = 0; v < bs[axis_v] && !open; ++v) {
+						pos[axis_v] = v;
+						for (int u = 0; u < bs[axis_u]; ++u) {
+							pos[axis_u] = u;
+							if (vb.get_voxel_f(pos.x, pos.y, pos.z, channel) >= 0.f) {
+								open = true;
+								break;
+							}
+						}
+					}
+					if (open) {
+						bits |= face_bit;
+					}
+				}
+			}
+		}
+		// Published under the lock, like the uniform class: writers invalidate after their write
+		_face_openness.store(0x80 | bits, std::memory_order_release);
+	}
+	return bits;
+}
+
 void VoxelDataBlock::set_modified(bool modified) {
+	if (modified) {
+		// Content is changing, a pressure sweep may compress it again later
+		_compaction_attempted = false;
+		_face_openness.store(0, std::memory_order_release);
+		++_edit_version;
+		if (!_modified) {
+			// Age accounting starts at the first edit since the last save
+			_modified_time_ms = uint32_t(Time::get_singleton()->get_ticks_msec());
+		}
+	}
+
 #ifdef TOOLS_ENABLED
 	if (_modified == false && modified) {
 		ZN_PRINT_VERBOSE(format("Marking block {} as modified", position));
 	}
 #endif
+	if (modified) {
+		// The content is about to change (or just did), the cached classification no longer holds
+		_uniform_class.store(UNIFORM_CLASS_UNKNOWN, std::memory_order_release);
+	}
 	_modified = modified;
 }
 
+void VoxelDataBlock::journal_edit(Box3i box) {
+	if (!_journal_valid) {
+		return;
+	}
+	const Box3i block_bounds(Vector3i(), _voxels != nullptr ? _voxels->get_size() : Vector3i());
+	box.clip(block_bounds);
+	if (Vector3iUtil::get_volume(box.size) == 0) {
+		return;
+	}
+
+	// Merge with an existing box when they touch, otherwise take a new slot
+	for (unsigned int i = 0; i < _journal_count; ++i) {
+		if (_journal_boxes[i].intersects(box)) {
+			_journal_boxes[i].merge_with(box);
+			return;
+		}
+	}
+	if (_journal_count < MAX_JOURNAL_BOXES) {
+		_journal_boxes[_journal_count++] = box;
+		return;
+	}
+
+	// No slot left: merge into the closest box, and if the journal ends up covering most of the
+	// block, give up tracking, a full save is cheaper than a delta of everything
+	unsigned int best_index = 0;
+	int64_t best_volume = std::numeric_limits<int64_t>::max();
+	for (unsigned int i = 0; i < _journal_count; ++i) {
+		Box3i merged = _journal_boxes[i];
+		merged.merge_with(box);
+		const int64_t volume = Vector3iUtil::get_volume(merged.size);
+		if (volume < best_volume) {
+			best_volume = volume;
+			best_index = i;
+		}
+	}
+	_journal_boxes[best_index].merge_with(box);
+
+	int64_t total_volume = 0;
+	for (unsigned int i = 0; i < _journal_count; ++i) {
+		total_volume += Vector3iUtil::get_volume(_journal_boxes[i].size);
+	}
+	if (_voxels != nullptr && total_volume * 2 > Vector3iUtil::get_volume(_voxels->get_size())) {
+		invalidate_edit_journal();
+	}
+}
+
 } // namespace zylann::voxel
@@ -46,14 +46,83 @@ public:
 	void set_voxels(std::shared_ptr<VoxelBufferInternal> &buffer) {
 		ERR_FAIL_COND(buffer == nullptr);
 		_voxels = buffer;
+		_uniform_class.store(UNIFORM_CLASS_UNKNOWN, std::memory_order_release);
+		_face_openness.store(0, std::memory_order_release);
 	}
 
 	void set_modified(bool modified);
 
+	// Which faces of the block have at least one non-solid voxel (SDF >= 0), as bits indexed
+	// (axis * 2 + positive_side): -X,+X,-Y,+Y,-Z,+Z. Used by occlusion flooding: air can only
+	// pass between two blocks when both touching faces are open. Cached and invalidated like the
+	// uniform class whenever the block is modified or its voxels replaced.
+	uint8_t get_or_compute_face_openness() const;
+
+	// Monotonic counter bumped every time the block is marked modified. Used as the version in
+	// network delta replication, so receivers can drop stale or duplicate deltas. Never reset
+	// while the block object lives (see the note near the old `_version` idea below): full-block
+	// syncs re-baseline receivers instead.
+	inline uint32_t get_edit_version() const {
+		return _edit_version;
+	}
+
+	// Memory-governor bookkeeping: whether an in-place compression of this block's channels was
+	// already attempted since it last changed, so pressure sweeps don't rescan settled blocks
+	inline bool was_compaction_attempted() const {
+		return _compaction_attempted;
+	}
+	inline void mark_compaction_attempted() {
+		_compaction_attempted = true;
+	}
+
+	// Edit journal: regions that diverged from deterministic generator output since this block
+	// came to exist, when that is known. Lets saves write compact deltas instead of full blocks.
+	static const unsigned int MAX_JOURNAL_BOXES = 4;
+
+	// The block matches generator output exactly (fresh generation)
+	inline void init_edit_journal_empty() {
+		_journal_valid = true;
+		_journal_count = 0;
+	}
+
+	// The block was reconstructed from a saved delta, these regions diverge from the generator
+	inline void init_edit_journal(Span<const Box3i> boxes) {
+		_journal_valid = boxes.size() <= MAX_JOURNAL_BOXES;
+		_journal_count = 0;
+		if (_journal_valid) {
+			for (unsigned int i = 0; i < boxes.size(); ++i) {
+				_journal_boxes[_journal_count++] = boxes[i];
+			}
+		}
+	}
+
+	// Unknown provenance (full save, bulk load): only full saves are safe
+	inline void invalidate_edit_journal() {
+		_journal_valid = false;
+		_journal_count = 0;
+	}
+
+	// Records an edited region in block-local voxel coordinates. When the journal outgrows what a
+	// compact delta is worth, it invalidates itself and the block goes back to full saves.
+	void journal_edit(Box3i box);
+
+	inline bool has_edit_journal() const {
+		return _journal_valid;
+	}
+	inline Span<const Box3i> get_edit_journal() const {
+		return Span<const Box3i>(_journal_boxes.data(), _journal_count);
+	}
+
 	inline bool is_modified() const {
 		return _modified;
 	}
 
+	// Milliseconds timestamp of when the block last became modified, for checkpoint age
+	// accounting. Only meaningful while `is_modified()` is true.
+	inline uint32_t get_modified_time_ms() const {
+		return _modified_time_ms;
+	}
+
 	void set_needs_lodding(bool need_lodding) {
 		_needs_lodding = need_lodding;
 	}
@@ -63,30 +132,91 @@ public:
 	}
 
 	inline void set_edited(bool edited) {
-		_edited = true;
+		_edited = edited;
 	}
 
 	inline bool is_edited() const {
 		return _edited;
 	}
 
+	// Classification of the block's content, cached so schedulers can skip meshing of fully
+	// uniform regions without locking the buffer every time. Reset whenever the block is marked
+	// modified or its voxels are replaced.
+	enum UniformClass : uint8_t {
+		UNIFORM_CLASS_UNKNOWN = 0, // Not computed yet
+		// All channels are uniform and hold "empty" values (positive SDF, type 0, color 0),
+		// no mesher produces geometry from this
+		UNIFORM_CLASS_AIR,
+		// All channels are uniform and SDF is negative. Only meshless for SDF-based meshers.
+		UNIFORM_CLASS_MATTER,
+		// Anything that can still produce geometry
+		UNIFORM_CLASS_MIXED
+	};
+
+	uint8_t get_or_compute_uniform_class() const {
+		uint8_t uniform_class = _uniform_class.load(std::memory_order_acquire);
+		if (uniform_class != UNIFORM_CLASS_UNKNOWN) {
+			return uniform_class;
+		}
+		uniform_class = UNIFORM_CLASS_MIXED;
+		{
+			RWLockRead rlock(_voxels->get_lock());
+			const VoxelBufferInternal &vb = *_voxels;
+			bool all_uniform = true;
+			for (unsigned int channel = 0; channel < VoxelBufferInternal::MAX_CHANNELS; ++channel) {
+				if (vb.get_channel_compression(channel) != VoxelBufferInternal::COMPRESSION_UNIFORM) {
+					all_uniform = false;
+					break;
+				}
+			}
+			if (all_uniform) {
+				const float sdf = vb.get_voxel_f(0, 0, 0, VoxelBufferInternal::CHANNEL_SDF);
+				if (sdf < 0.f) {
+					uniform_class = UNIFORM_CLASS_MATTER;
+				} else if (vb.get_voxel(Vector3i(), VoxelBufferInternal::CHANNEL_TYPE) == 0 &&
+						vb.get_voxel(Vector3i(), VoxelBufferInternal::CHANNEL_COLOR) == 0) {
+					uniform_class = UNIFORM_CLASS_AIR;
+				}
+			}
+			// Published while still holding the lock: writers take the write lock before modifying
+			// and invalidate afterwards, so a stale class can never overwrite their invalidation
+			_uniform_class.store(uniform_class, std::memory_order_release);
+		}
+		return uniform_class;
+	}
+
 private:
 	VoxelDataBlock(Vector3i bpos, std::shared_ptr<VoxelBufferInternal> &buffer, unsigned int p_lod_index) :
 			position(bpos), lod_index(p_lod_index), _voxels(buffer) {}
 
 	std::shared_ptr<VoxelBufferInternal> _voxels;
 
+	// See `journal_edit`
+	FixedArray<Box3i, MAX_JOURNAL_BOXES> _journal_boxes;
+	uint8_t _journal_count = 0;
+	bool _journal_valid = false;
+	bool _compaction_attempted = false;
+	uint32_t _edit_version = 0;
+
 	// The block was edited, which requires its LOD counterparts to be recomputed
 	bool _needs_lodding = false;
 
 	// Indicates if this block is different from the time it was loaded (should be saved)
 	bool _modified = false;
+	// See `get_modified_time_ms`
+	uint32_t _modified_time_ms = 0;
 
 	// Tells if the block has ever been edited.
 	// If `false`, the same data can be obtained by running the generator.
 	// Once it becomes `true`, it usually never comes back to `false` unless reverted.
 	bool _edited = false;
 
+	// See `UniformClass`. Atomic and mutable because it is a lazily computed cache, read by update
+	// tasks while the main thread can reset it when edits mark the block modified.
+	mutable std::atomic_uint8_t _uniform_class = { UNIFORM_CLASS_UNKNOWN };
+	// Bit 7 set when computed, bits 0..5 are the face-open flags. 0 = not computed yet.
+	mutable std::atomic_uint8_t _face_openness = { 0 };
+
 	// TODO Optimization: design a proper way to implement client-side caching for multiplayer
 	//
 	// Represents how many times the block was edited.
@@ -32,6 +32,37 @@ public:
 		});
 	}
 
+	// Hands whole blocks to `block_action(VoxelBufferInternal &voxels, Box3i local_box,
+	// Vector3i voxel_offset)`, so callers can run optimized kernels over rows instead of going
+	// through a per-voxel functor
+	template <typename Block_F>
+	void write_box_blocks(Box3i voxel_box, Block_F block_action) {
+		_box_loop(voxel_box, block_action);
+	}
+
+	// Like `write_box_blocks`, but blocks whose channel is uniform first go through
+	// `uniform_filter(raw_uniform_value, touched_box_in_voxels)`; returning false skips the block
+	// entirely, leaving it compressed instead of materializing it for a write that would change
+	// nothing. Large SDF brushes skip most uniform air blocks when digging and most uniform
+	// matter blocks when adding, which make up the bulk of their bounding box.
+	template <typename Block_F, typename UniformFilter_F>
+	void write_box_blocks_sparse(
+			Box3i voxel_box, unsigned int channel, Block_F block_action, UniformFilter_F uniform_filter) {
+		_box_loop(voxel_box,
+				[channel, &block_action, &uniform_filter](
+						VoxelBufferInternal &voxels, Box3i local_box, Vector3i voxel_offset) {
+					if (voxels.get_channel_compression(channel) == VoxelBufferInternal::COMPRESSION_UNIFORM) {
+						const uint64_t uniform_value = voxels.get_voxel(Vector3i(), channel);
+						const Box3i touched_box(local_box.pos + voxel_offset, local_box.size);
+						if (!uniform_filter(uniform_value, touched_box)) {
+							// The operation can't change this block, keep it compressed
+							return;
+						}
+					}
+					block_action(voxels, local_box, voxel_offset);
+				});
+	}
+
 	// void action(Vector3i pos, D0 &value, D1 &value)
 	template <typename F>
 	void write_box_2(const Box3i &voxel_box, unsigned int channel0, unsigned int channel1, F action) {
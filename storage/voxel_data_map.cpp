@@ -1,10 +1,12 @@
 #include "voxel_data_map.h"
+#include "../util/lightweight_profiler.h"
 #include "../constants/cube_tables.h"
 #include "../generators/voxel_generator.h"
 #include "../util/macros.h"
 #include "../util/memory.h"
 #include "../util/string_funcs.h"
 
+#include <algorithm>
 #include <limits>
 
 namespace zylann::voxel {
@@ -61,6 +63,27 @@ int VoxelDataMap::get_voxel(Vector3i pos, unsigned int c) const {
 	return block->get_voxels_const().get_voxel(to_local(pos), c);
 }
 
+void VoxelDataMap::capture_snapshot(Box3i voxel_box, VoxelDataMapSnapshot &out_snapshot) const {
+	ZN_PROFILE_SCOPE();
+	out_snapshot.clear();
+	out_snapshot._block_size_po2 = _block_size_pow2;
+
+	const Box3i bbox = voxel_box.downscaled(get_block_size());
+	bbox.for_each_cell([this, &out_snapshot](Vector3i bpos) {
+		const VoxelDataBlock *block = get_block(bpos);
+		if (block == nullptr) {
+			return;
+		}
+		std::shared_ptr<VoxelBufferInternal> snapshot_voxels = make_shared_instance<VoxelBufferInternal>();
+		{
+			RWLockRead rlock(block->get_voxels_const().get_lock());
+			// Copy-on-write: only refcounts, actual data is never duplicated here
+			snapshot_voxels->copy_shared_from(block->get_voxels_const(), false);
+		}
+		out_snapshot._blocks.insert(std::make_pair(bpos, std::move(snapshot_voxels)));
+	});
+}
+
 VoxelDataBlock *VoxelDataMap::create_default_block(Vector3i bpos) {
 	std::shared_ptr<VoxelBufferInternal> buffer = make_shared_instance<VoxelBufferInternal>();
 	buffer->create(_block_size, _block_size, _block_size);
@@ -112,7 +135,7 @@ void VoxelDataMap::set_default_voxel(int value, unsigned int channel) {
 	_default_voxel[channel] = value;
 }
 
-int VoxelDataMap::get_default_voxel(unsigned int channel) {
+int VoxelDataMap::get_default_voxel(unsigned int channel) const {
 	ERR_FAIL_INDEX_V(channel, VoxelBufferInternal::MAX_CHANNELS, 0);
 	return _default_voxel[channel];
 }
@@ -156,6 +179,8 @@ void VoxelDataMap::set_block(Vector3i bpos, VoxelDataBlock *block) {
 	unsigned int i = _blocks.size();
 	_blocks.push_back(block);
 	_blocks_map.insert(std::make_pair(bpos, i));
+	_concurrent_index.add(bpos, block);
+	_iteration_order_dirty = true;
 }
 
 void VoxelDataMap::remove_block_internal(Vector3i bpos, unsigned int index) {
@@ -177,6 +202,33 @@ void VoxelDataMap::remove_block_internal(Vector3i bpos, unsigned int index) {
 		auto it = _blocks_map.find(moved_block->position);
 		CRASH_COND(it == _blocks_map.end());
 		it->second = index;
+		_iteration_order_dirty = true;
+	}
+}
+
+void VoxelDataMap::ensure_spatial_iteration_order() {
+	if (!_iteration_order_dirty) {
+		return;
+	}
+	_iteration_order_dirty = false;
+	ZN_PROFILE_SCOPE();
+
+	std::sort(_blocks.begin(), _blocks.end(), [](const VoxelDataBlock *a, const VoxelDataBlock *b) {
+		if (a->position.z != b->position.z) {
+			return a->position.z < b->position.z;
+		}
+		if (a->position.x != b->position.x) {
+			return a->position.x < b->position.x;
+		}
+		return a->position.y < b->position.y;
+	});
+
+	for (unsigned int i = 0; i < _blocks.size(); ++i) {
+		auto it = _blocks_map.find(_blocks[i]->position);
+#ifdef DEBUG_ENABLED
+		CRASH_COND(it == _blocks_map.end());
+#endif
+		it->second = i;
 	}
 }
 
@@ -214,6 +266,7 @@ bool VoxelDataMap::is_block_surrounded(Vector3i pos) const {
 
 void VoxelDataMap::copy(Vector3i min_pos, VoxelBufferInternal &dst_buffer, unsigned int channels_mask,
 		void *callback_data, void (*gen_func)(void *, VoxelBufferInternal &, Vector3i)) const {
+	ZN_LIGHT_PROFILE_SCOPE("data_map_copy");
 	const Vector3i max_pos = min_pos + dst_buffer.get_size();
 
 	const Vector3i min_block_pos = voxel_to_block(min_pos);
@@ -275,6 +328,30 @@ void VoxelDataMap::copy(Vector3i min_pos, VoxelBufferInternal &dst_buffer, unsig
 void VoxelDataMap::paste(Vector3i min_pos, VoxelBufferInternal &src_buffer, unsigned int channels_mask, bool use_mask,
 		uint64_t mask_value, bool create_new_blocks) {
 	//
+	ZN_LIGHT_PROFILE_SCOPE("data_map_paste");
+
+	// Block-aligned whole-block pastes (prefab stamping) share channel payloads copy-on-write
+	// instead of running convert-copy loops: the paste itself copies nothing, the prefab buffer
+	// stays intact for re-stamping, and an actual copy only happens if the block gets edited
+	// later. Requires an unmasked full-channel paste of a buffer exactly one block large.
+	const unsigned int all_channels_mask = (1 << VoxelBufferInternal::MAX_CHANNELS) - 1;
+	if (!use_mask && (channels_mask & all_channels_mask) == all_channels_mask &&
+			src_buffer.get_size() == Vector3iUtil::create(get_block_size()) &&
+			block_to_voxel(voxel_to_block(min_pos)) == min_pos) {
+		const Vector3i bpos = voxel_to_block(min_pos);
+		VoxelDataBlock *block = get_block(bpos);
+		if (block == nullptr && create_new_blocks) {
+			block = create_default_block(bpos);
+		}
+		if (block != nullptr) {
+			VoxelBufferInternal &dst_buffer = block->get_voxels();
+			RWLockWrite lock(dst_buffer.get_lock());
+			// Metadata is not part of pastes, like the general path below
+			dst_buffer.copy_shared_from(src_buffer, false);
+		}
+		return;
+	}
+
 	const Vector3i max_pos = min_pos + src_buffer.get_size();
 
 	const Vector3i min_block_pos = voxel_to_block(min_pos);
@@ -328,6 +405,8 @@ void VoxelDataMap::paste(Vector3i min_pos, VoxelBufferInternal &src_buffer, unsi
 }
 
 void VoxelDataMap::clear() {
+	// Unpublish everything before deleting, so shared readers can't reach freed blocks
+	_concurrent_index.clear();
 	for (auto it = _blocks.begin(); it != _blocks.end(); ++it) {
 		VoxelDataBlock *block = *it;
 		if (block == nullptr) {
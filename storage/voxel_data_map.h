@@ -3,7 +3,9 @@
 
 #include "../util/fixed_array.h"
 #include "../util/profiling.h"
+#include "concurrent_block_index.h"
 #include "voxel_data_block.h"
+#include "voxel_data_snapshot.h"
 
 #include <unordered_map>
 
@@ -54,13 +56,17 @@ public:
 	unsigned int get_lod_index() const;
 
 	int get_voxel(Vector3i pos, unsigned int c = 0) const;
+
+	// Captures copy-on-write snapshots of the blocks intersecting `voxel_box` into `out_snapshot`.
+	// Cheap: each block is locked for a refcount bump, not a data copy. See VoxelDataMapSnapshot.
+	void capture_snapshot(Box3i voxel_box, VoxelDataMapSnapshot &out_snapshot) const;
 	void set_voxel(int value, Vector3i pos, unsigned int c = 0);
 
 	float get_voxel_f(Vector3i pos, unsigned int c = VoxelBufferInternal::CHANNEL_SDF) const;
 	void set_voxel_f(real_t value, Vector3i pos, unsigned int c = VoxelBufferInternal::CHANNEL_SDF);
 
 	void set_default_voxel(int value, unsigned int channel = 0);
-	int get_default_voxel(unsigned int channel = 0);
+	int get_default_voxel(unsigned int channel = 0) const;
 
 	inline void copy(Vector3i min_pos, VoxelBufferInternal &dst_buffer, unsigned int channels_mask) const {
 		copy(min_pos, dst_buffer, channels_mask, nullptr, nullptr);
@@ -90,6 +96,9 @@ public:
 #endif
 			VoxelDataBlock *block = _blocks[i];
 			ERR_FAIL_COND(block == nullptr);
+			// Unpublish from the concurrent index first: its shard lock guarantees no shared reader
+			// still uses the block once we delete it
+			_concurrent_index.remove(bpos);
 			pre_delete(*block);
 			memdelete(block);
 			remove_block_internal(bpos, i);
@@ -102,10 +111,34 @@ public:
 	bool has_block(Vector3i pos) const;
 	bool is_block_surrounded(Vector3i pos) const;
 
+	// Thread-safe block lookups that don't require holding the owner's map-wide lock.
+	// They remain coherent because all structural modifications of the map keep the sharded index in sync.
+	// Hot read paths (meshing, generation) should prefer these over locking `VoxelDataLodMap::Lod::map_lock`
+	// in read mode, which serializes on a single lock with many worker threads.
+
+	inline bool has_block_shared(Vector3i bpos) const {
+		return _concurrent_index.has(bpos);
+	}
+
+	// Runs `f(VoxelDataBlock &)` if the block is present. See `ConcurrentBlockIndex::with_block`.
+	template <typename F>
+	inline bool with_block_shared(Vector3i bpos, F f) const {
+		return _concurrent_index.with_block(bpos, f);
+	}
+
 	void clear();
 
 	int get_block_count() const;
 
+	// Iteration happens over a dense pointer array, but structural changes (hash-placed inserts,
+	// swap-removes) leave it in spatially random order, so per-frame walks touch blocks
+	// scattered across memory. This re-sorts the array in scanline order (Z, X, Y, matching the
+	// ZXY data layout) and fixes up indices, making iteration-heavy passes walk blocks of
+	// adjacent positions consecutively. Deferred on purpose: callers must hold EXCLUSIVE access
+	// to the map (sorting under a shared read lock would race with concurrent iterations), so
+	// the owner calls this from its structural-update section when the order went dirty.
+	void ensure_spatial_iteration_order();
+
 	template <typename Op_T>
 	inline void for_each_block(Op_T op) {
 		for (auto it = _blocks.begin(); it != _blocks.end(); ++it) {
@@ -200,6 +233,9 @@ private:
 	std::unordered_map<Vector3i, unsigned int> _blocks_map;
 	std::vector<VoxelDataBlock *> _blocks;
 
+	// Read-optimized mirror of `_blocks_map`, see `has_block_shared` / `with_block_shared`
+	ConcurrentBlockIndex _concurrent_index;
+
 	// This was a possible optimization in a single-threaded scenario, but it's not in multithread.
 	// We want to be able to do shared read-accesses but this is a mutable variable.
 	// If we want this back, it may be thread-local in some way.
@@ -211,6 +247,8 @@ private:
 	unsigned int _block_size;
 	unsigned int _block_size_pow2;
 	unsigned int _block_size_mask;
+	// See `ensure_spatial_iteration_order`
+	bool _iteration_order_dirty = false;
 
 	unsigned int _lod_index = 0;
 };
@@ -222,8 +260,44 @@ struct VoxelDataLodMap {
 		// Otherwise it may be locked in read mode.
 		// It is possible to unlock it after we are done querying the map.
 		RWLock map_lock;
+
+		// Spatial edit registry: boxes (in block coordinates) currently being written by edits
+		// that released the map lock after referencing their blocks. Unloading skips blocks
+		// inside them and retries on a later cycle, so edits to different areas and structural
+		// map changes proceed fully in parallel without losing writes to blocks removed
+		// mid-operation.
+		mutable Mutex edited_boxes_mutex;
+		std::vector<Box3i> edited_boxes;
+
+		inline void add_edited_box(Box3i box_in_blocks) {
+			MutexLock lock(edited_boxes_mutex);
+			edited_boxes.push_back(box_in_blocks);
+		}
+
+		inline void remove_edited_box(Box3i box_in_blocks) {
+			MutexLock lock(edited_boxes_mutex);
+			for (size_t i = 0; i < edited_boxes.size(); ++i) {
+				if (edited_boxes[i] == box_in_blocks) {
+					edited_boxes[i] = edited_boxes.back();
+					edited_boxes.pop_back();
+					return;
+				}
+			}
+		}
+
+		inline bool is_block_in_edited_boxes(Vector3i block_pos) const {
+			MutexLock lock(edited_boxes_mutex);
+			for (size_t i = 0; i < edited_boxes.size(); ++i) {
+				if (edited_boxes[i].contains(block_pos)) {
+					return true;
+				}
+			}
+			return false;
+		}
 	};
-	// Each LOD works in a set of coordinates spanning 2x more voxels the higher their index is
+	// Each LOD works in a set of coordinates spanning 2x more voxels the higher their index is.
+	// Maps may use different block sizes per LOD (they only ever grow with the index), so block
+	// sizes must be queried from the map of the LOD being worked on, not assumed from LOD0.
 	FixedArray<Lod, constants::MAX_LOD> lods;
 	unsigned int lod_count = 1;
 };
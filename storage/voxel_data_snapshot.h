@@ -0,0 +1,90 @@
+#ifndef VOXEL_DATA_SNAPSHOT_H
+#define VOXEL_DATA_SNAPSHOT_H
+
+#include "voxel_buffer_internal.h"
+#include "../util/math/box3i.h"
+#include "../util/span.h"
+
+#include <memory>
+#include <unordered_map>
+
+namespace zylann::voxel {
+
+class VoxelDataMap;
+
+// Read-only view of an area of a VoxelDataMap, captured as copy-on-write block snapshots.
+// Capturing takes each block's read lock only for the duration of a refcount bump; after that,
+// queries touch no locks at all: concurrent edits detach their own unique copies and can never
+// modify the snapshot's payloads. Meant for gameplay-side queries (physics sweeps, repeated
+// single-voxel reads) that would otherwise take a lock per voxel and stall while big async edits
+// hold the write side.
+class VoxelDataMapSnapshot {
+public:
+	void clear() {
+		_blocks.clear();
+	}
+
+	// Returns the default value when the position falls outside the captured (or loaded) area
+	uint64_t get_voxel(Vector3i pos, unsigned int channel, uint64_t default_value) const {
+		const Vector3i bpos = pos >> _block_size_po2;
+		auto it = _blocks.find(bpos);
+		if (it == _blocks.end()) {
+			return default_value;
+		}
+		const Vector3i rpos = pos - (bpos << _block_size_po2);
+		// No lock: the snapshot owns its reference to the payload, writers detach before writing
+		return it->second->get_voxel(rpos, channel);
+	}
+
+	// Gathers a whole box of voxels into a flat ZXY buffer in one pass: each block is resolved
+	// once instead of once per voxel, so batch consumers (collision broad phases) scan a local
+	// buffer with tight compare loops instead of hashing per voxel.
+	void gather_box(Box3i box, unsigned int channel, uint64_t default_value, Span<uint64_t> out_values) const {
+		ZN_ASSERT_RETURN(out_values.size() == size_t(Vector3iUtil::get_volume(box.size)));
+
+		const int block_size = 1 << _block_size_po2;
+		const Box3i blocks_box = box.downscaled(block_size);
+
+		// Pre-fill with defaults so missing blocks need no per-voxel handling
+		for (size_t i = 0; i < out_values.size(); ++i) {
+			out_values[i] = default_value;
+		}
+
+		blocks_box.for_each_cell([this, box, block_size, &out_values](Vector3i bpos) {
+			auto it = _blocks.find(bpos);
+			if (it == _blocks.end()) {
+				return;
+			}
+			const VoxelBufferInternal &voxels = *it->second;
+			const Vector3i block_origin = bpos * block_size;
+			Box3i local_box(box.pos - block_origin, box.size);
+			local_box.clip(Box3i(Vector3i(), Vector3iUtil::create(block_size)));
+
+			Vector3i rpos;
+			for (rpos.z = local_box.pos.z; rpos.z < local_box.pos.z + local_box.size.z; ++rpos.z) {
+				for (rpos.y = local_box.pos.y; rpos.y < local_box.pos.y + local_box.size.y; ++rpos.y) {
+					for (rpos.x = local_box.pos.x; rpos.x < local_box.pos.x + local_box.size.x; ++rpos.x) {
+						const Vector3i voxel_pos = block_origin + rpos;
+						const Vector3i out_pos = voxel_pos - box.pos;
+						const unsigned int out_index = Vector3iUtil::get_zxy_index(out_pos, box.size);
+						out_values[out_index] = voxels.get_voxel(rpos, channel);
+					}
+				}
+			}
+		});
+	}
+
+	unsigned int get_block_count() const {
+		return _blocks.size();
+	}
+
+private:
+	friend class VoxelDataMap;
+
+	std::unordered_map<Vector3i, std::shared_ptr<VoxelBufferInternal>> _blocks;
+	unsigned int _block_size_po2 = 0;
+};
+
+} // namespace zylann::voxel
+
+#endif // VOXEL_DATA_SNAPSHOT_H
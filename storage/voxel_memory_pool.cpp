@@ -1,15 +1,117 @@
 #include "voxel_memory_pool.h"
 #include "../util/macros.h"
 #include "../util/memory.h"
+#include "../util/memory_accounting.h"
 #include "../util/profiling.h"
 #include "../util/string_funcs.h"
 
+// Platform backing for hugepage slabs. Best-effort everywhere: when the OS can't provide large
+// pages the slabs still work as plain memory, keeping the allocator behavior identical.
+#if defined(__linux__)
+#include <sys/mman.h>
+#elif defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
 namespace zylann::voxel {
 
 namespace {
+
 VoxelMemoryPool *g_memory_pool = nullptr;
+
+// Address ranges of slabs that were freed, kept as numbers only. Thread-exit cleanup running
+// after the pool was destroyed (the main thread's TLS destructor at shutdown) uses them to tell
+// slab-carved block pointers from heap blocks: the former died with their slab and must be
+// skipped, the latter still need freeing. Intentionally immortal (never deleted), since those
+// destructors can run after static teardown. Worst case, a heap block whose address happens to
+// land in a retired range gets skipped - a one-time leak at process exit.
+struct RetiredSlabRanges {
+	Mutex mutex;
+	std::vector<std::pair<uintptr_t, uintptr_t>> ranges;
+};
+
+RetiredSlabRanges &get_retired_slab_ranges() {
+	static RetiredSlabRanges *singleton = ZN_NEW(RetiredSlabRanges);
+	return *singleton;
+}
+
+bool is_in_retired_slabs(const uint8_t *block) {
+	const uintptr_t p = reinterpret_cast<uintptr_t>(block);
+	RetiredSlabRanges &retired = get_retired_slab_ranges();
+	MutexLock lock(retired.mutex);
+	for (unsigned int i = 0; i < retired.ranges.size(); ++i) {
+		if (p >= retired.ranges[i].first && p < retired.ranges[i].second) {
+			return true;
+		}
+	}
+	return false;
+}
+
+uint8_t *alloc_slab_os(size_t size) {
+#if defined(__linux__)
+	void *mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (mem == MAP_FAILED) {
+		return nullptr;
+	}
+	// Advisory transparent hugepages: no privileges or boot-time reservations needed, and the
+	// kernel silently ignores it when THP is unavailable
+	madvise(mem, size, MADV_HUGEPAGE);
+	return static_cast<uint8_t *>(mem);
+#elif defined(_WIN32)
+	// Large pages need SeLockMemoryPrivilege, which most processes don't have; try, then fall
+	// back to a regular committed region
+	void *mem = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+	if (mem == nullptr) {
+		mem = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	}
+	return static_cast<uint8_t *>(mem);
+#else
+	return static_cast<uint8_t *>(ZN_ALLOC(size));
+#endif
+}
+
+void free_slab_os(uint8_t *slab, size_t size) {
+#if defined(__linux__)
+	munmap(slab, size);
+#elif defined(_WIN32)
+	VirtualFree(slab, 0, MEM_RELEASE);
+#else
+	ZN_FREE(slab);
+#endif
+}
+
 } // namespace
 
+thread_local VoxelMemoryPool::ThreadMagazines VoxelMemoryPool::_thread_magazines;
+
+VoxelMemoryPool::ThreadMagazines::~ThreadMagazines() {
+	// The thread is exiting, hand cached blocks back to the central pools so they aren't lost.
+	// At process exit the pool can be destroyed before this runs, in which case free them directly.
+	for (unsigned int pot = 0; pot < magazines.size(); ++pot) {
+		Magazine &magazine = magazines[pot];
+		if (magazine.count == 0) {
+			continue;
+		}
+		if (g_memory_pool != nullptr) {
+			Pool &pool = g_memory_pool->_pot_pools[pot];
+			MutexLock lock(pool.mutex);
+			for (unsigned int i = 0; i < magazine.count; ++i) {
+				pool.blocks.push_back(magazine.blocks[i]);
+			}
+		} else {
+			for (unsigned int i = 0; i < magazine.count; ++i) {
+				// Blocks carved out of a retired slab died with it; freeing those interior
+				// pointers would corrupt the allocator. Heap blocks still get freed normally.
+				if (!is_in_retired_slabs(magazine.blocks[i])) {
+					ZN_FREE(magazine.blocks[i]);
+				}
+			}
+		}
+		magazine.count = 0;
+	}
+}
+
 void VoxelMemoryPool::create_singleton() {
 	ZN_ASSERT(g_memory_pool == nullptr);
 	g_memory_pool = ZN_NEW(VoxelMemoryPool);
@@ -29,6 +131,61 @@ VoxelMemoryPool &VoxelMemoryPool::get_singleton() {
 
 VoxelMemoryPool::VoxelMemoryPool() {}
 
+void VoxelMemoryPool::set_slab_backing_enabled(bool enabled) {
+	MutexLock lock(_slab_arena.mutex);
+	_slab_arena.enabled = enabled;
+}
+
+bool VoxelMemoryPool::is_slab_backing_enabled() const {
+	MutexLock lock(_slab_arena.mutex);
+	return _slab_arena.enabled;
+}
+
+uint8_t *VoxelMemoryPool::allocate_block_memory(size_t capacity) {
+	{
+		MutexLock lock(_slab_arena.mutex);
+		if (_slab_arena.enabled && capacity <= SLAB_SIZE) {
+			// Pooled capacities are powers of two, so aligning the offset keeps every block
+			// naturally aligned within the slab
+			size_t offset = math::alignup(_slab_arena.current_offset, capacity);
+			if (_slab_arena.slabs.size() == 0 || offset + capacity > SLAB_SIZE) {
+				uint8_t *slab = alloc_slab_os(SLAB_SIZE);
+				if (slab == nullptr) {
+					ZN_PRINT_ERROR("Could not allocate slab, falling back on heap");
+				} else {
+					_slab_arena.slabs.push_back(slab);
+					_total_memory += SLAB_SIZE;
+					offset = 0;
+				}
+			}
+			if (_slab_arena.slabs.size() > 0 && offset + capacity <= SLAB_SIZE) {
+				uint8_t *block = _slab_arena.slabs.back() + offset;
+				_slab_arena.current_offset = offset + capacity;
+				return block;
+			}
+		}
+	}
+	uint8_t *block = static_cast<uint8_t *>(ZN_ALLOC(capacity));
+	if (block != nullptr) {
+		_total_memory += capacity;
+	}
+	return block;
+}
+
+void VoxelMemoryPool::get_slabs(std::vector<uint8_t *> &out_slabs) const {
+	MutexLock lock(_slab_arena.mutex);
+	out_slabs = _slab_arena.slabs;
+}
+
+bool VoxelMemoryPool::is_in_slabs(const uint8_t *block, const std::vector<uint8_t *> &slabs) {
+	for (unsigned int i = 0; i < slabs.size(); ++i) {
+		if (block >= slabs[i] && block < slabs[i] + SLAB_SIZE) {
+			return true;
+		}
+	}
+	return false;
+}
+
 VoxelMemoryPool::~VoxelMemoryPool() {
 #ifdef TOOLS_ENABLED
 	if (is_verbose_output_enabled()) {
@@ -47,6 +204,9 @@ uint8_t *VoxelMemoryPool::allocate(size_t size) {
 	if (size > get_highest_supported_size()) {
 		// Sorry, memory is not pooled past this size
 		block = (uint8_t *)ZN_ALLOC(size * sizeof(uint8_t));
+		if (block != nullptr) {
+			_total_memory += size;
+		}
 #ifdef DEBUG_ENABLED
 		if (block != nullptr) {
 			_debug_nonpooled_used_blocks.add(block);
@@ -55,21 +215,40 @@ uint8_t *VoxelMemoryPool::allocate(size_t size) {
 	} else {
 		const unsigned int pot = get_pool_index_from_size(size);
 		Pool &pool = _pot_pools[pot];
-		pool.mutex.lock();
-		if (pool.blocks.size() > 0) {
-			block = pool.blocks.back();
-			pool.blocks.pop_back();
-			pool.mutex.unlock();
+		Magazine &magazine = _thread_magazines.magazines[pot];
+
+		if (magazine.count > 0) {
+			// Fast path, no locking
+			--magazine.count;
+			block = magazine.blocks[magazine.count];
+			++_magazine_hit_count;
+
 		} else {
-			pool.mutex.unlock();
-			ZN_PROFILE_SCOPE_NAMED("new alloc");
-			// All allocations done in this pool have the same size,
-			// which must be greater or equal to `size`
-			const size_t capacity = get_size_from_pool_index(pot);
+			{
+				// Refill half the magazine with a single lock acquisition
+				MutexLock lock(pool.mutex);
+				while (magazine.count < MAGAZINE_CAPACITY / 2 && pool.blocks.size() > 0) {
+					magazine.blocks[magazine.count] = pool.blocks.back();
+					pool.blocks.pop_back();
+					++magazine.count;
+				}
+			}
+			++_magazine_refill_count;
+
+			if (magazine.count > 0) {
+				--magazine.count;
+				block = magazine.blocks[magazine.count];
+
+			} else {
+				ZN_PROFILE_SCOPE_NAMED("new alloc");
+				// All allocations done in this pool have the same size,
+				// which must be greater or equal to `size`
+				const size_t capacity = get_size_from_pool_index(pot);
 #ifdef DEBUG_ENABLED
-			ZN_ASSERT(capacity >= size);
+				ZN_ASSERT(capacity >= size);
 #endif
-			block = (uint8_t *)ZN_ALLOC(capacity * sizeof(uint8_t));
+				block = allocate_block_memory(capacity);
+			}
 		}
 #ifdef DEBUG_ENABLED
 		if (block != nullptr) {
@@ -82,6 +261,7 @@ uint8_t *VoxelMemoryPool::allocate(size_t size) {
 	} else {
 		++_used_blocks;
 		_used_memory += size;
+		MemoryAccounting::get_singleton().add(MemoryAccounting::CATEGORY_VOXEL_BUFFERS, size);
 	}
 	return block;
 }
@@ -97,6 +277,7 @@ void VoxelMemoryPool::recycle(uint8_t *block, size_t size) {
 		_debug_nonpooled_used_blocks.remove(block);
 #endif
 		ZN_FREE(block);
+		_total_memory -= size;
 	} else {
 		const unsigned int pot = get_pool_index_from_size(size);
 		Pool &pool = _pot_pools[pot];
@@ -104,36 +285,81 @@ void VoxelMemoryPool::recycle(uint8_t *block, size_t size) {
 		// Make sure this allocation was done by this pool in this scenario
 		pool.debug_used_blocks.remove(block);
 #endif
-		MutexLock lock(pool.mutex);
-		pool.blocks.push_back(block);
+		Magazine &magazine = _thread_magazines.magazines[pot];
+		if (magazine.count == MAGAZINE_CAPACITY) {
+			// Full, release half to the central pool with a single lock acquisition
+			MutexLock lock(pool.mutex);
+			while (magazine.count > MAGAZINE_CAPACITY / 2) {
+				--magazine.count;
+				pool.blocks.push_back(magazine.blocks[magazine.count]);
+			}
+			++_magazine_spill_count;
+		}
+		magazine.blocks[magazine.count] = block;
+		++magazine.count;
 	}
 	--_used_blocks;
 	_used_memory -= size;
+	MemoryAccounting::get_singleton().remove(MemoryAccounting::CATEGORY_VOXEL_BUFFERS, size);
 }
 
 void VoxelMemoryPool::clear_unused_blocks() {
+	// Note: this only clears the central pools. Blocks cached in thread magazines stay with their
+	// thread, which is fine since each holds at most MAGAZINE_CAPACITY blocks per size class.
+	// Slab-backed blocks stay pooled: their memory can't be returned to the OS individually.
+	static thread_local std::vector<uint8_t *> tls_slabs;
+	get_slabs(tls_slabs);
+
 	for (unsigned int pot = 0; pot < _pot_pools.size(); ++pot) {
 		Pool &pool = _pot_pools[pot];
 		MutexLock lock(pool.mutex);
+		size_t kept_count = 0;
 		for (unsigned int i = 0; i < pool.blocks.size(); ++i) {
-			void *block = pool.blocks[i];
-			ZN_FREE(block);
+			uint8_t *block = pool.blocks[i];
+			if (is_in_slabs(block, tls_slabs)) {
+				pool.blocks[kept_count] = block;
+				++kept_count;
+			} else {
+				ZN_FREE(block);
+				_total_memory -= get_size_from_pool_index(pot);
+			}
 		}
-		_total_memory -= get_size_from_pool_index(pot) * pool.blocks.size();
-		pool.blocks.clear();
+		pool.blocks.resize(kept_count);
 	}
 }
 
 void VoxelMemoryPool::clear() {
+	static thread_local std::vector<uint8_t *> tls_slabs;
+	get_slabs(tls_slabs);
+
 	for (unsigned int pot = 0; pot < _pot_pools.size(); ++pot) {
 		Pool &pool = _pot_pools[pot];
 		MutexLock lock(pool.mutex);
 		for (unsigned int i = 0; i < pool.blocks.size(); ++i) {
-			void *block = pool.blocks[i];
-			ZN_FREE(block);
+			uint8_t *block = pool.blocks[i];
+			if (!is_in_slabs(block, tls_slabs)) {
+				ZN_FREE(block);
+			}
 		}
 		pool.blocks.clear();
 	}
+	{
+		MutexLock lock(_slab_arena.mutex);
+		if (_slab_arena.slabs.size() > 0) {
+			// Remember the ranges so late thread-exit cleanup can skip pointers carved from them
+			RetiredSlabRanges &retired = get_retired_slab_ranges();
+			MutexLock ranges_lock(retired.mutex);
+			for (unsigned int i = 0; i < _slab_arena.slabs.size(); ++i) {
+				const uintptr_t begin = reinterpret_cast<uintptr_t>(_slab_arena.slabs[i]);
+				retired.ranges.push_back(std::make_pair(begin, begin + SLAB_SIZE));
+			}
+		}
+		for (unsigned int i = 0; i < _slab_arena.slabs.size(); ++i) {
+			free_slab_os(_slab_arena.slabs[i], SLAB_SIZE);
+		}
+		_slab_arena.slabs.clear();
+		_slab_arena.current_offset = 0;
+	}
 	_used_memory = 0;
 	_total_memory = 0;
 	_used_blocks = 0;
@@ -146,6 +372,10 @@ void VoxelMemoryPool::debug_print() {
 		MutexLock lock(pool.mutex);
 		println(format("Pool {}: {} blocks (capacity {})", pot, pool.blocks.size(), pool.blocks.capacity()));
 	}
+	// Refills and spills each cost one central lock acquisition, hits are lock-free.
+	// If hits don't dominate under load, MAGAZINE_CAPACITY is too small.
+	println(format("Magazines (capacity {}): {} hits, {} refills, {} spills", MAGAZINE_CAPACITY,
+			uint64_t(_magazine_hit_count), uint64_t(_magazine_refill_count), uint64_t(_magazine_spill_count)));
 }
 
 unsigned int VoxelMemoryPool::debug_get_used_blocks() const {
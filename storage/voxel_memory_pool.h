@@ -51,6 +51,25 @@ private:
 #endif
 	};
 
+	// We handle allocations with up to 2^20 = 1,048,576 bytes.
+	// This is chosen based on practical needs.
+	static const unsigned int POT_POOL_COUNT = 21;
+
+	// Per-thread front-end over the central pools, like tcmalloc's thread caches. Threads serve
+	// allocations from their magazine and only take the central mutex to grab or release half a
+	// magazine at once, which removes lock contention from the hot path.
+	static const unsigned int MAGAZINE_CAPACITY = 16;
+
+	struct Magazine {
+		FixedArray<uint8_t *, MAGAZINE_CAPACITY> blocks;
+		unsigned int count = 0;
+	};
+
+	struct ThreadMagazines {
+		FixedArray<Magazine, POT_POOL_COUNT> magazines;
+		~ThreadMagazines();
+	};
+
 public:
 	static void create_singleton();
 	static void destroy_singleton();
@@ -62,6 +81,15 @@ public:
 	uint8_t *allocate(size_t size);
 	void recycle(uint8_t *block, size_t size);
 
+	// When enabled, new pooled blocks are carved from large slabs requested with hugepage
+	// backing from the OS (best-effort, falls back to the regular heap). Hundreds of MB of hot
+	// voxel data on default 4K pages show up as dTLB misses in generation and meshing scans;
+	// huge pages cut that down. Slab memory is never returned to the OS while the process runs,
+	// so this is meant for dense-world servers, not memory-constrained targets.
+	// Enable before most allocations happen; already-allocated blocks stay heap-backed.
+	void set_slab_backing_enabled(bool enabled);
+	bool is_slab_backing_enabled() const;
+
 	void clear_unused_blocks();
 
 	void debug_print();
@@ -88,18 +116,45 @@ private:
 		return size_t(1) << i;
 	}
 
-	// We handle allocations with up to 2^20 = 1,048,576 bytes.
-	// This is chosen based on practical needs.
+	// Allocates backing memory for one pooled block of `capacity` bytes, from a slab when slab
+	// backing is enabled, from the heap otherwise
+	uint8_t *allocate_block_memory(size_t capacity);
+	// Copies the current slab list so callers can range-check many pointers without holding the
+	// arena lock per block
+	void get_slabs(std::vector<uint8_t *> &out_slabs) const;
+	static bool is_in_slabs(const uint8_t *block, const std::vector<uint8_t *> &slabs);
+
+	// One x86-64 huge page
+	static const size_t SLAB_SIZE = 2 * 1024 * 1024;
+
+	struct SlabArena {
+		mutable Mutex mutex;
+		// Append-only while the pool lives; slabs are only unmapped in `clear()`
+		std::vector<uint8_t *> slabs;
+		size_t current_offset = 0;
+		bool enabled = false;
+	};
+
 	// Each slot in this array corresponds to allocations
 	// that contain 2^index bytes in them.
-	FixedArray<Pool, 21> _pot_pools;
+	FixedArray<Pool, POT_POOL_COUNT> _pot_pools;
+	SlabArena _slab_arena;
 #ifdef DEBUG_ENABLED
 	DebugUsedBlocks _debug_nonpooled_used_blocks;
 #endif
 
+	static thread_local ThreadMagazines _thread_magazines;
+
 	std::atomic_uint32_t _used_blocks = 0;
-	size_t _used_memory = 0;
-	size_t _total_memory = 0;
+	// Atomic because allocations and frees update them from any thread, not always under a lock
+	std::atomic_size_t _used_memory = { 0 };
+	std::atomic_size_t _total_memory = { 0 };
+
+	// Stats to help sizing MAGAZINE_CAPACITY: hits are allocations served without locking,
+	// refills and spills each cost one central lock acquisition.
+	std::atomic_uint64_t _magazine_hit_count = 0;
+	std::atomic_uint64_t _magazine_refill_count = 0;
+	std::atomic_uint64_t _magazine_spill_count = 0;
 };
 
 } // namespace zylann::voxel
@@ -8,9 +8,32 @@
 
 namespace zylann::voxel::CompressedData {
 
+namespace {
+
+void delta_encode(Span<const uint8_t> src, std::vector<uint8_t> &dst, unsigned int stride) {
+	dst.resize(src.size());
+	for (size_t i = src.size(); i-- > stride;) {
+		dst[i] = uint8_t(src[i] - src[i - stride]);
+	}
+	for (size_t i = 0; i < stride && i < src.size(); ++i) {
+		dst[i] = src[i];
+	}
+}
+
+void delta_decode_in_place(std::vector<uint8_t> &data, unsigned int stride) {
+	for (size_t i = stride; i < data.size(); ++i) {
+		data[i] = uint8_t(data[i] + data[i - stride]);
+	}
+}
+
+} // namespace
+
+bool decompress_lz4_segmented(MemoryReader &f, Span<const uint8_t> src, std::vector<uint8_t> &dst);
+
 bool decompress_lz4(MemoryReader &f, Span<const uint8_t> src, std::vector<uint8_t> &dst) {
 	const uint32_t decompressed_size = f.get_32();
-	const uint32_t header_size = sizeof(uint8_t) + sizeof(uint32_t);
+	// Whatever was read so far is the header
+	const uint32_t header_size = f.pos;
 
 	dst.resize(decompressed_size);
 
@@ -31,7 +54,14 @@ bool decompress(Span<const uint8_t> src, std::vector<uint8_t> &dst) {
 
 	MemoryReader f(src, ENDIANESS_LITTLE_ENDIAN);
 
-	const Compression comp = static_cast<Compression>(f.get_8());
+	const uint8_t comp_value = f.get_8();
+	if (comp_value >= CUSTOM_CODEC_ID_BEGIN && comp_value < CUSTOM_CODEC_ID_END) {
+		const CodecFuncs &funcs = g_custom_codecs[comp_value];
+		ZN_ASSERT_RETURN_V_MSG(funcs.decompress_func != nullptr, false,
+				format("Data uses unregistered codec {}", int(comp_value)));
+		return funcs.decompress_func(src.sub(1), dst);
+	}
+	const Compression comp = static_cast<Compression>(comp_value);
 	ZN_ASSERT_RETURN_V(comp >= 0 && comp < COMPRESSION_COUNT, false);
 
 	switch (comp) {
@@ -52,6 +82,34 @@ bool decompress(Span<const uint8_t> src, std::vector<uint8_t> &dst) {
 			ZN_ASSERT_RETURN_V(decompress_lz4(f, src, dst), false);
 			break;
 
+		case COMPRESSION_LZ4_SEGMENTED:
+			ZN_ASSERT_RETURN_V(decompress_lz4_segmented(f, src, dst), false);
+			break;
+
+		case COMPRESSION_LZ4_FILTERED: {
+			const unsigned int filter_stride = f.get_8();
+			ZN_ASSERT_RETURN_V(filter_stride >= 1 && filter_stride <= 8, false);
+			ZN_ASSERT_RETURN_V(decompress_lz4(f, src, dst), false);
+			delta_decode_in_place(dst, filter_stride);
+		} break;
+
+		case COMPRESSION_LZ4_SECTIONED: {
+			std::vector<SectionInfo> sections;
+			ZN_ASSERT_RETURN_V(read_section_table(src, sections), false);
+			size_t total_size = 0;
+			for (unsigned int i = 0; i < sections.size(); ++i) {
+				total_size += sections[i].decompressed_size;
+			}
+			dst.resize(total_size);
+			size_t dst_pos = 0;
+			static thread_local std::vector<uint8_t> tls_section;
+			for (unsigned int i = 0; i < sections.size(); ++i) {
+				ZN_ASSERT_RETURN_V(decompress_section(src, sections[i], tls_section), false);
+				memcpy(dst.data() + dst_pos, tls_section.data(), tls_section.size());
+				dst_pos += tls_section.size();
+			}
+		} break;
+
 		default:
 			ZN_PRINT_ERROR("Invalid compression header");
 			return false;
@@ -65,7 +123,8 @@ bool compress_lz4(MemoryWriter &f, Span<const uint8_t> src, std::vector<uint8_t>
 
 	f.store_32(src.size());
 
-	const uint32_t header_size = sizeof(uint8_t) + sizeof(uint32_t);
+	// Whatever was written so far is the header
+	const size_t header_size = dst.size();
 	dst.resize(header_size + LZ4_compressBound(src.size()));
 
 	const uint32_t compressed_size = LZ4_compress_default(
@@ -79,9 +138,247 @@ bool compress_lz4(MemoryWriter &f, Span<const uint8_t> src, std::vector<uint8_t>
 	return true;
 }
 
+bool compress_filtered(Span<const uint8_t> src, std::vector<uint8_t> &dst, unsigned int filter_stride) {
+	ZN_PROFILE_SCOPE();
+	ZN_ASSERT_RETURN_V(filter_stride >= 1 && filter_stride <= 8, false);
+
+	static thread_local std::vector<uint8_t> tls_filtered_data;
+	delta_encode(src, tls_filtered_data, filter_stride);
+
+	dst.clear();
+	dst.reserve(get_compress_bound(src.size(), COMPRESSION_LZ4_FILTERED));
+	MemoryWriter f(dst, ENDIANESS_LITTLE_ENDIAN);
+	f.store_8(COMPRESSION_LZ4_FILTERED);
+	f.store_8(filter_stride);
+	return compress_lz4(f, to_span_const(tls_filtered_data), dst);
+}
+
+bool compress_segmented(Span<const Span<const uint8_t>> segments, std::vector<uint8_t> &dst) {
+	ZN_PROFILE_SCOPE();
+	ZN_ASSERT_RETURN_V(segments.size() > 0 && segments.size() <= 255, false);
+
+	size_t total_size = 0;
+	for (unsigned int i = 0; i < segments.size(); ++i) {
+		total_size += segments[i].size();
+	}
+	ZN_ASSERT_RETURN_V(total_size <= std::numeric_limits<uint32_t>::max(), false);
+
+	// Exact worst case: stream header, then per segment a compressed size and the LZ4 bound.
+	// Reserved up front so the per-segment resizes below never reallocate.
+	size_t bound = 1 + sizeof(uint32_t) + 1;
+	for (unsigned int i = 0; i < segments.size(); ++i) {
+		bound += sizeof(uint32_t) + LZ4_compressBound(segments[i].size());
+	}
+
+	dst.clear();
+	dst.reserve(bound);
+	MemoryWriter f(dst, ENDIANESS_LITTLE_ENDIAN);
+	f.store_8(COMPRESSION_LZ4_SEGMENTED);
+	f.store_32(total_size);
+	f.store_8(segments.size());
+
+	LZ4_stream_t stream;
+	LZ4_initStream(&stream, sizeof(stream));
+
+	for (unsigned int i = 0; i < segments.size(); ++i) {
+		const Span<const uint8_t> segment = segments[i];
+		const size_t header_pos = dst.size();
+		f.store_32(0); // Compressed size, patched below
+		const size_t data_pos = dst.size();
+		dst.resize(data_pos + LZ4_compressBound(segment.size()));
+
+		// The streaming API keeps referencing previous segments as dictionary, they must stay in place
+		const int compressed_size = LZ4_compress_fast_continue(&stream, (const char *)segment.data(),
+				(char *)dst.data() + data_pos, segment.size(), dst.size() - data_pos, 1);
+		ZN_ASSERT_RETURN_V(compressed_size > 0, false);
+		dst.resize(data_pos + compressed_size);
+
+		// Patch compressed size in place (little endian)
+		dst[header_pos] = compressed_size & 0xff;
+		dst[header_pos + 1] = (compressed_size >> 8) & 0xff;
+		dst[header_pos + 2] = (compressed_size >> 16) & 0xff;
+		dst[header_pos + 3] = (compressed_size >> 24) & 0xff;
+	}
+
+	return true;
+}
+
+bool compress_sectioned(Span<const Span<const uint8_t>> sections, std::vector<uint8_t> &dst) {
+	ZN_PROFILE_SCOPE();
+	ZN_ASSERT_RETURN_V(sections.size() > 0 && sections.size() <= 255, false);
+
+	// Exact worst case: mode byte, count byte, the table, then per-section LZ4 bounds
+	size_t bound = 2 + sections.size() * 2 * sizeof(uint32_t);
+	for (unsigned int i = 0; i < sections.size(); ++i) {
+		ZN_ASSERT_RETURN_V(sections[i].size() <= std::numeric_limits<uint32_t>::max(), false);
+		bound += LZ4_compressBound(sections[i].size());
+	}
+
+	dst.clear();
+	dst.reserve(bound);
+	MemoryWriter f(dst, ENDIANESS_LITTLE_ENDIAN);
+	f.store_8(COMPRESSION_LZ4_SECTIONED);
+	f.store_8(sections.size());
+
+	const size_t table_pos = dst.size();
+	for (unsigned int i = 0; i < sections.size(); ++i) {
+		f.store_32(sections[i].size());
+		f.store_32(0); // Compressed size, patched below
+	}
+
+	for (unsigned int i = 0; i < sections.size(); ++i) {
+		const Span<const uint8_t> section = sections[i];
+		const size_t data_pos = dst.size();
+		dst.resize(data_pos + LZ4_compressBound(section.size()));
+
+		// No dictionary chaining: every section stands alone so readers can pick just one
+		const int compressed_size = LZ4_compress_default(
+				(const char *)section.data(), (char *)dst.data() + data_pos, section.size(), dst.size() - data_pos);
+		ZN_ASSERT_RETURN_V(compressed_size > 0, false);
+		dst.resize(data_pos + compressed_size);
+
+		// Patch compressed size in place (little endian)
+		const size_t entry_pos = table_pos + i * 2 * sizeof(uint32_t) + sizeof(uint32_t);
+		dst[entry_pos] = compressed_size & 0xff;
+		dst[entry_pos + 1] = (compressed_size >> 8) & 0xff;
+		dst[entry_pos + 2] = (compressed_size >> 16) & 0xff;
+		dst[entry_pos + 3] = (compressed_size >> 24) & 0xff;
+	}
+
+	return true;
+}
+
+bool read_section_table(Span<const uint8_t> src, std::vector<SectionInfo> &out_sections) {
+	out_sections.clear();
+	if (src.size() < 2 || src[0] != COMPRESSION_LZ4_SECTIONED) {
+		return false;
+	}
+	MemoryReader f(src, ENDIANESS_LITTLE_ENDIAN);
+	f.pos = 1;
+	const unsigned int section_count = f.get_8();
+	ZN_ASSERT_RETURN_V(section_count > 0, false);
+	ZN_ASSERT_RETURN_V(f.pos + section_count * 2 * sizeof(uint32_t) <= src.size(), false);
+
+	uint32_t payload_offset = 2 + section_count * 2 * sizeof(uint32_t);
+	for (unsigned int i = 0; i < section_count; ++i) {
+		SectionInfo section;
+		section.decompressed_size = f.get_32();
+		section.compressed_size = f.get_32();
+		section.payload_offset = payload_offset;
+		ZN_ASSERT_RETURN_V(size_t(payload_offset) + section.compressed_size <= src.size(), false);
+		payload_offset += section.compressed_size;
+		out_sections.push_back(section);
+	}
+	return true;
+}
+
+bool decompress_section(Span<const uint8_t> src, const SectionInfo &section, std::vector<uint8_t> &dst) {
+	dst.resize(section.decompressed_size);
+	const int decompressed_size = LZ4_decompress_safe((const char *)src.data() + section.payload_offset,
+			(char *)dst.data(), section.compressed_size, dst.size());
+	ZN_ASSERT_RETURN_V_MSG(decompressed_size >= 0 && uint32_t(decompressed_size) == section.decompressed_size, false,
+			format("Expected {} bytes, obtained {}", section.decompressed_size, decompressed_size));
+	return true;
+}
+
+bool decompress_lz4_segmented(MemoryReader &f, Span<const uint8_t> src, std::vector<uint8_t> &dst) {
+	const uint32_t total_size = f.get_32();
+	const unsigned int segment_count = f.get_8();
+
+	dst.resize(total_size);
+
+	LZ4_streamDecode_t stream;
+	ZN_ASSERT_RETURN_V(LZ4_setStreamDecode(&stream, nullptr, 0) == 1, false);
+
+	size_t dst_pos = 0;
+	for (unsigned int i = 0; i < segment_count; ++i) {
+		const uint32_t compressed_size = f.get_32();
+		ZN_ASSERT_RETURN_V(f.pos + compressed_size <= src.size(), false);
+
+		const int decompressed_size = LZ4_decompress_safe_continue(&stream, (const char *)src.data() + f.pos,
+				(char *)dst.data() + dst_pos, compressed_size, dst.size() - dst_pos);
+		ZN_ASSERT_RETURN_V_MSG(
+				decompressed_size >= 0, false, format("LZ4 segment decompression error {}", decompressed_size));
+
+		f.pos += compressed_size;
+		dst_pos += decompressed_size;
+	}
+
+	ZN_ASSERT_RETURN_V_MSG(
+			dst_pos == total_size, false, format("Expected {} bytes, obtained {}", total_size, dst_pos));
+	return true;
+}
+
+size_t get_compress_bound(size_t src_size, Compression comp) {
+	switch (comp) {
+		case COMPRESSION_NONE:
+			// Format byte + raw copy
+			return 1 + src_size;
+		case COMPRESSION_LZ4_BE:
+		case COMPRESSION_LZ4:
+			// Format byte + decompressed size + LZ4 bound
+			return 1 + sizeof(uint32_t) + LZ4_compressBound(src_size);
+		case COMPRESSION_LZ4_FILTERED:
+			// Format byte + stride byte + decompressed size + LZ4 bound (filtering is 1:1)
+			return 2 + sizeof(uint32_t) + LZ4_compressBound(src_size);
+		default:
+			ZN_PRINT_ERROR("Invalid compression header");
+			return 0;
+	}
+}
+
+namespace {
+// Registered custom codecs, indexed by id. Written once at startup (see `register_codec`),
+// read from streaming threads afterwards.
+CodecFuncs g_custom_codecs[256];
+uint8_t g_preferred_codec = 0;
+} // namespace
+
+bool register_codec(uint8_t id, CodecFuncs funcs) {
+	ZN_ASSERT_RETURN_V(id >= CUSTOM_CODEC_ID_BEGIN && id < CUSTOM_CODEC_ID_END, false);
+	ZN_ASSERT_RETURN_V(funcs.compress_func != nullptr && funcs.decompress_func != nullptr, false);
+	g_custom_codecs[id] = funcs;
+	return true;
+}
+
+bool set_preferred_codec(uint8_t id) {
+	if (id == 0) {
+		g_preferred_codec = 0;
+		return true;
+	}
+	ZN_ASSERT_RETURN_V(id >= CUSTOM_CODEC_ID_BEGIN && id < CUSTOM_CODEC_ID_END, false);
+	ZN_ASSERT_RETURN_V(g_custom_codecs[id].compress_func != nullptr, false);
+	g_preferred_codec = id;
+	return true;
+}
+
+uint8_t get_preferred_codec() {
+	return g_preferred_codec;
+}
+
+static bool compress_with_custom_codec(uint8_t id, Span<const uint8_t> src, std::vector<uint8_t> &dst) {
+	const CodecFuncs &funcs = g_custom_codecs[id];
+	ZN_ASSERT_RETURN_V(funcs.compress_func != nullptr, false);
+	static thread_local std::vector<uint8_t> tls_payload;
+	if (!funcs.compress_func(src, tls_payload)) {
+		return false;
+	}
+	dst.clear();
+	dst.reserve(1 + tls_payload.size());
+	dst.push_back(id);
+	dst.insert(dst.end(), tls_payload.begin(), tls_payload.end());
+	return true;
+}
+
 bool compress(Span<const uint8_t> src, std::vector<uint8_t> &dst, Compression comp) {
 	ZN_PROFILE_SCOPE();
 
+	// Plain LZ4 saves route through the preferred custom codec when one was registered; the
+	// structured modes (sectioned, filtered, segmented) keep their built-in framing
+	if (comp == COMPRESSION_LZ4 && g_preferred_codec != 0) {
+		return compress_with_custom_codec(g_preferred_codec, src, dst);
+	}
+
 	switch (comp) {
 		case COMPRESSION_NONE: {
 			dst.resize(src.size() + 1);
@@ -101,11 +398,18 @@ bool compress(Span<const uint8_t> src, std::vector<uint8_t> &dst, Compression co
 			// Write header
 			// Must clear first because MemoryWriter writes from the end
 			dst.clear();
+			// One right-sized allocation on a thread's first use, none afterwards
+			dst.reserve(get_compress_bound(src.size(), comp));
 			MemoryWriter f(dst, ENDIANESS_LITTLE_ENDIAN);
 			f.store_8(comp);
 			compress_lz4(f, src, dst);
 		} break;
 
+		case COMPRESSION_LZ4_FILTERED:
+			// Callers knowing the layout of their data should prefer `compress_filtered` with a
+			// meaningful stride
+			return compress_filtered(src, dst, 1);
+
 		default:
 			ZN_PRINT_ERROR("Invalid compression header");
 			return false;
@@ -2,7 +2,9 @@
 #define VOXEL_COMPRESSED_DATA_H
 
 #include "../util/span.h"
+#include <cstddef>
 #include <cstdint>
+#include <vector>
 
 namespace zylann::voxel::CompressedData {
 
@@ -22,10 +24,77 @@ enum Compression {
 	// All following bytes are compressed data using LZ4 defaults.
 	// This is the fastest compression format.
 	COMPRESSION_LZ4 = 2,
-	COMPRESSION_COUNT = 3
+	// Same codec as COMPRESSION_LZ4, but the source was compressed as a sequence of dependent segments
+	// (LZ4 streaming API), so writers can compress straight from non-contiguous buffers without first
+	// assembling them into one. Layout: uint32_t total decompressed size (little endian), uint8_t segment
+	// count, then for each segment a uint32_t compressed size followed by its compressed bytes.
+	// Decompression produces one contiguous buffer, like COMPRESSION_LZ4.
+	COMPRESSION_LZ4_SEGMENTED = 3,
+	// Denser but slower tier meant for archival. The source is delta-filtered with a fixed stride
+	// before LZ4, which turns smooth sequences (like SDF gradients) into long runs of near-zero
+	// bytes that LZ4 matches much better. The next uint8_t is the filter stride, then a uint32_t
+	// with the size of decompressed data (little endian), then LZ4 data of the filtered buffer.
+	COMPRESSION_LZ4_FILTERED = 4,
+	// Like COMPRESSION_LZ4_SEGMENTED, but each section is compressed independently (no
+	// cross-section dictionary), so single sections can be decompressed without touching the
+	// others. Layout: uint8_t section count, then for each section a uint32_t decompressed size
+	// and uint32_t compressed size (little endian), then the compressed payloads in order.
+	// Decompression as a whole produces one contiguous buffer, like the other modes.
+	COMPRESSION_LZ4_SECTIONED = 5,
+	COMPRESSION_COUNT = 6
 };
 
+// Custom codec ids occupy this range of the leading format byte; values below are the built-in
+// compression modes above, values from 0xD0 are reserved for raw serializer markers (deltas,
+// uniform records). Custom codecs let games plug faster implementations (SIMD builds of LZ4,
+// dictionary variants, entropy-light codecs) without forking the streams: registration happens
+// at startup, which is where runtime CPU-feature dispatch belongs - register the implementation
+// variant the detected CPU runs best.
+static const uint8_t CUSTOM_CODEC_ID_BEGIN = 64;
+static const uint8_t CUSTOM_CODEC_ID_END = 192; // Exclusive
+
+struct CodecFuncs {
+	// Both work on raw payloads; the leading id byte is handled by the registry
+	bool (*compress_func)(Span<const uint8_t> src, std::vector<uint8_t> &dst) = nullptr;
+	bool (*decompress_func)(Span<const uint8_t> src, std::vector<uint8_t> &dst) = nullptr;
+};
+
+// Registers a codec under an id of the custom range. Not thread-safe: do it before streaming
+// starts. Returns false on invalid id or incomplete function pair.
+bool register_codec(uint8_t id, CodecFuncs funcs);
+
+// When set to a registered custom codec, plain LZ4 saves go through it instead; 0 restores the
+// built-in codec. Loads accept every known id regardless, so existing saves keep reading and
+// blocks migrate opportunistically as they get re-saved.
+bool set_preferred_codec(uint8_t id);
+uint8_t get_preferred_codec();
+
+// Describes one section of a COMPRESSION_LZ4_SECTIONED payload, see `read_section_table`
+struct SectionInfo {
+	uint32_t decompressed_size;
+	uint32_t compressed_size;
+	// Offset of the compressed payload from the start of the whole compressed blob
+	uint32_t payload_offset;
+};
+
+// Exact worst-case output size of `compress` for a given input size. Callers right-size pooled
+// buffers with it up front, so compression performs no allocation beyond the first use and
+// save-path memory behavior stays deterministic.
+size_t get_compress_bound(size_t src_size, Compression comp);
 bool compress(Span<const uint8_t> src, std::vector<uint8_t> &dst, Compression comp);
+// Compresses a sequence of buffers as if they were one contiguous one, without copying them together first.
+// Always uses COMPRESSION_LZ4_SEGMENTED.
+bool compress_segmented(Span<const Span<const uint8_t>> segments, std::vector<uint8_t> &dst);
+// Variant of `compress_segmented` producing independently-decompressible sections
+// (COMPRESSION_LZ4_SECTIONED), at a slight ratio cost since sections don't share a dictionary.
+bool compress_sectioned(Span<const Span<const uint8_t>> sections, std::vector<uint8_t> &dst);
+// Parses the section table of a COMPRESSION_LZ4_SECTIONED blob. Returns false for other modes.
+bool read_section_table(Span<const uint8_t> src, std::vector<SectionInfo> &out_sections);
+// Decompresses a single section described by `read_section_table`
+bool decompress_section(Span<const uint8_t> src, const SectionInfo &section, std::vector<uint8_t> &dst);
+// Variant of `compress` for COMPRESSION_LZ4_FILTERED, letting callers pick the delta stride.
+// It should be the byte size of the dominant channel's voxels (falls back to 1 from `compress`).
+bool compress_filtered(Span<const uint8_t> src, std::vector<uint8_t> &dst, unsigned int filter_stride);
 bool decompress(Span<const uint8_t> src, std::vector<uint8_t> &dst);
 
 } // namespace zylann::voxel::CompressedData
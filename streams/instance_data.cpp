@@ -11,7 +11,10 @@ const uint32_t TRAILING_MAGIC = 0x900df00d;
 enum FormatVersion {
 	INSTANCE_BLOCK_FORMAT_VERSION_0 = 0,
 	// Now using little-endian.
-	INSTANCE_BLOCK_FORMAT_VERSION_1 = 1
+	INSTANCE_BLOCK_FORMAT_VERSION_1 = 1,
+	// Adds delta layers (see `FORMAT_DELTA_V2`). Only used when a block contains at least one,
+	// so fully-edited blocks remain loadable by older versions.
+	INSTANCE_BLOCK_FORMAT_VERSION_2 = 2
 };
 } //namespace
 
@@ -65,7 +68,12 @@ bool serialize_instance_block_data(const InstanceBlockData &src, std::vector<uin
 	ERR_FAIL_COND_V(src.position_range < 0.f, false);
 	const float position_range = math::max(src.position_range, InstanceBlockData::POSITION_RANGE_MINIMUM);
 
-	w.store_8(INSTANCE_BLOCK_FORMAT_VERSION_1);
+	bool has_delta_layers = false;
+	for (size_t i = 0; i < src.layers.size(); ++i) {
+		has_delta_layers = has_delta_layers || src.layers[i].is_delta;
+	}
+
+	w.store_8(has_delta_layers ? INSTANCE_BLOCK_FORMAT_VERSION_2 : INSTANCE_BLOCK_FORMAT_VERSION_1);
 	w.store_8(src.layers.size());
 	w.store_float(position_range);
 
@@ -86,10 +94,19 @@ bool serialize_instance_block_data(const InstanceBlockData &src, std::vector<uin
 		}
 
 		w.store_16(layer.id);
-		w.store_16(layer.instances.size());
+		w.store_16(layer.is_delta ? 0 : layer.instances.size());
 		w.store_float(scale_min);
 		w.store_float(scale_max);
-		w.store_8(instance_format);
+		w.store_8(layer.is_delta ? InstanceBlockData::FORMAT_DELTA_V2 : instance_format);
+
+		if (layer.is_delta) {
+			w.store_32(layer.generated_count);
+			w.store_32(layer.removed_indices.size());
+			for (size_t j = 0; j < layer.removed_indices.size(); ++j) {
+				w.store_32(layer.removed_indices[j]);
+			}
+			continue;
+		}
 
 		const float scale_norm_scale = 1.f / (scale_max - scale_min);
 
@@ -118,7 +135,6 @@ bool serialize_instance_block_data(const InstanceBlockData &src, std::vector<uin
 }
 
 bool deserialize_instance_block_data(InstanceBlockData &dst, Span<const uint8_t> src) {
-	const uint8_t expected_version = INSTANCE_BLOCK_FORMAT_VERSION_1;
 	const uint8_t expected_instance_format = InstanceBlockData::FORMAT_SIMPLE_11B_V1;
 
 	zylann::MemoryReader r(src, zylann::ENDIANESS_LITTLE_ENDIAN);
@@ -127,7 +143,8 @@ bool deserialize_instance_block_data(InstanceBlockData &dst, Span<const uint8_t>
 	if (version == INSTANCE_BLOCK_FORMAT_VERSION_0) {
 		r.endianess = zylann::ENDIANESS_BIG_ENDIAN;
 	} else {
-		ERR_FAIL_COND_V(version != expected_version, false);
+		ERR_FAIL_COND_V(
+				version != INSTANCE_BLOCK_FORMAT_VERSION_1 && version != INSTANCE_BLOCK_FORMAT_VERSION_2, false);
 	}
 
 	const uint8_t layers_count = r.get_8();
@@ -149,6 +166,22 @@ bool deserialize_instance_block_data(InstanceBlockData &dst, Span<const uint8_t>
 		const float scale_range = layer.scale_max - layer.scale_min;
 
 		const uint8_t instance_format = r.get_8();
+
+		if (instance_format == InstanceBlockData::FORMAT_DELTA_V2) {
+			ERR_FAIL_COND_V(version < INSTANCE_BLOCK_FORMAT_VERSION_2, false);
+			layer.is_delta = true;
+			layer.generated_count = r.get_32();
+			const uint32_t removed_count = r.get_32();
+			ERR_FAIL_COND_V(removed_count > layer.generated_count, false);
+			layer.removed_indices.resize(removed_count);
+			for (size_t j = 0; j < layer.removed_indices.size(); ++j) {
+				const uint32_t index = r.get_32();
+				ERR_FAIL_COND_V(index >= layer.generated_count, false);
+				layer.removed_indices[j] = index;
+			}
+			continue;
+		}
+
 		ERR_FAIL_COND_V(instance_format != expected_instance_format, false);
 
 		for (size_t j = 0; j < layer.instances.size(); ++j) {
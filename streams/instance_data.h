@@ -26,7 +26,15 @@ struct InstanceBlockData {
 		// - uint8_t y;
 		// - uint8_t z;
 		// - uint8_t w;
-		FORMAT_SIMPLE_11B_V1 = 0
+		FORMAT_SIMPLE_11B_V1 = 0,
+		// Delta layer: instead of storing transforms, stores how many instances the generator
+		// produced and which of them were removed (indices in generation order). Loading
+		// re-runs the generator and applies the removals, so lightly-edited generated areas save
+		// orders of magnitude less data.
+		// - uint32_t generated_count;
+		// - uint32_t removed_count;
+		// - uint32_t removed_indices[removed_count];
+		FORMAT_DELTA_V2 = 1
 	};
 
 	static const int POSITION_RESOLUTION = 65536;
@@ -43,6 +51,13 @@ struct InstanceBlockData {
 		float scale_min;
 		float scale_max;
 		std::vector<InstanceData> instances;
+		// Delta representation (FORMAT_DELTA_V2): when set, `instances` is empty and the layer is
+		// reconstructed by re-running the generator and removing `removed_indices` (in generation
+		// order) from its output. `generated_count` validates that the generator still produces
+		// the same output as when the delta was saved.
+		bool is_delta = false;
+		uint32_t generated_count = 0;
+		std::vector<uint32_t> removed_indices;
 	};
 
 	float position_range;
@@ -5,13 +5,32 @@
 #include "../../util/profiling.h"
 #include "../../util/string_funcs.h"
 #include "../file_utils.h"
+#include <core/io/dir_access.h>
 #include <core/io/file_access.h>
 #include <algorithm>
+#include <cstring>
+
+// Optional read path mapping the whole file in memory, so block payloads are served by the OS page
+// cache without syscalls. Only POSIX and Windows are covered, other platforms keep using FileAccess.
+#if defined(__unix__) || defined(__APPLE__)
+#define VOXEL_REGION_FILE_MAPPING_SUPPORTED
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#define VOXEL_REGION_FILE_MAPPING_SUPPORTED
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
 
 namespace zylann::voxel {
 
 namespace {
-const uint8_t FORMAT_VERSION = 3;
+const uint8_t FORMAT_VERSION = 4;
+
+// Version 3 is like 4, but has no per-block checksum table
+const uint8_t FORMAT_VERSION_LEGACY_3 = 3;
 
 // Version 2 is like 3, but does not include any format information
 const uint8_t FORMAT_VERSION_LEGACY_2 = 2;
@@ -63,8 +82,27 @@ static uint32_t get_header_size_v3(const RegionFormat &format) {
 			Vector3iUtil::get_volume(format.region_size) * sizeof(RegionBlockInfo);
 }
 
-static bool save_header(
-		FileAccess &f, uint8_t version, const RegionFormat &format, const std::vector<RegionBlockInfo> &block_infos) {
+static uint32_t get_header_size_v4(const RegionFormat &format) {
+	// v3 header plus the per-block checksum table
+	return get_header_size_v3(format) + Vector3iUtil::get_volume(format.region_size) * sizeof(uint64_t);
+}
+
+static uint32_t get_header_size(uint8_t version, const RegionFormat &format) {
+	return version >= FORMAT_VERSION ? get_header_size_v4(format) : get_header_size_v3(format);
+}
+
+// Checksum of a block's serialized payload (FNV-1a 64). Cheap enough to run on every save and
+// load, and collisions only matter against random corruption, not adversaries.
+static uint64_t compute_block_checksum(Span<const uint8_t> data) {
+	uint64_t h = 0xcbf29ce484222325ull;
+	for (size_t i = 0; i < data.size(); ++i) {
+		h = (h ^ data[i]) * 0x100000001b3ull;
+	}
+	return h;
+}
+
+static bool save_header(FileAccess &f, uint8_t version, const RegionFormat &format,
+		const std::vector<RegionBlockInfo> &block_infos, const std::vector<uint64_t> &block_checksums) {
 	f.seek(0);
 
 	f.store_buffer(reinterpret_cast<const uint8_t *>(FORMAT_REGION_MAGIC), 4);
@@ -98,16 +136,22 @@ static bool save_header(
 	// TODO Deal with endianess, this should be little-endian
 	f.store_buffer(reinterpret_cast<const uint8_t *>(block_infos.data()), block_infos.size() * sizeof(RegionBlockInfo));
 
+	if (version >= FORMAT_VERSION) {
+		CRASH_COND(block_checksums.size() != block_infos.size());
+		f.store_buffer(
+				reinterpret_cast<const uint8_t *>(block_checksums.data()), block_checksums.size() * sizeof(uint64_t));
+	}
+
 	const size_t blocks_begin_offset = f.get_position();
 #ifdef DEBUG_ENABLED
-	CRASH_COND(blocks_begin_offset != get_header_size_v3(format));
+	CRASH_COND(blocks_begin_offset != get_header_size(version, format));
 #endif
 
 	return true;
 }
 
-static bool load_header(
-		FileAccess &f, uint8_t &out_version, RegionFormat &out_format, std::vector<RegionBlockInfo> &out_block_infos) {
+static bool load_header(FileAccess &f, uint8_t &out_version, RegionFormat &out_format,
+		std::vector<RegionBlockInfo> &out_block_infos, std::vector<uint64_t> &out_block_checksums) {
 	ERR_FAIL_COND_V(f.get_position() != 0, false);
 	ERR_FAIL_COND_V(f.get_length() < MAGIC_AND_VERSION_SIZE, false);
 
@@ -118,7 +162,8 @@ static bool load_header(
 
 	const uint8_t version = f.get_8();
 
-	if (version == FORMAT_VERSION) {
+	// v3 and v4 share the format section; v4 only appends the checksum table after block infos
+	if (version == FORMAT_VERSION || version == FORMAT_VERSION_LEGACY_3) {
 		out_format.block_size_po2 = f.get_8();
 
 		out_format.region_size.x = f.get_8();
@@ -162,11 +207,103 @@ static bool load_header(
 	const size_t read_size = f.get_buffer((uint8_t *)out_block_infos.data(), blocks_len);
 	ERR_FAIL_COND_V(read_size != blocks_len, false);
 
+	if (version == FORMAT_VERSION) {
+		out_block_checksums.resize(out_block_infos.size());
+		const size_t checksums_len = out_block_checksums.size() * sizeof(uint64_t);
+		const size_t checksums_read_size = f.get_buffer((uint8_t *)out_block_checksums.data(), checksums_len);
+		ERR_FAIL_COND_V(checksums_read_size != checksums_len, false);
+	} else {
+		// Older files have no recorded checksums; loads skip verification until migration
+		out_block_checksums.clear();
+		out_block_checksums.resize(out_block_infos.size(), 0);
+	}
+
 	return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Read-only view over the whole file. The OS keeps it coherent with writes done through the file
+// handle, but not with changes of the file's length, so it must be re-created when the file grows.
+struct RegionFile::FileMapping {
+	const uint8_t *data = nullptr;
+	size_t size = 0;
+#if defined(_WIN32)
+	HANDLE file_handle = INVALID_HANDLE_VALUE;
+	HANDLE mapping_handle = nullptr;
+#endif
+
+#ifdef VOXEL_REGION_FILE_MAPPING_SUPPORTED
+	static FileMapping *create(const String &fpath) {
+#if defined(_WIN32)
+		const Char16String fpath_utf16 = fpath.utf16();
+		HANDLE file_handle = CreateFileW(reinterpret_cast<LPCWSTR>(fpath_utf16.get_data()), GENERIC_READ,
+				FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file_handle == INVALID_HANDLE_VALUE) {
+			return nullptr;
+		}
+		LARGE_INTEGER file_size;
+		if (GetFileSizeEx(file_handle, &file_size) == 0 || file_size.QuadPart <= 0) {
+			CloseHandle(file_handle);
+			return nullptr;
+		}
+		HANDLE mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping_handle == nullptr) {
+			CloseHandle(file_handle);
+			return nullptr;
+		}
+		const void *mem = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+		if (mem == nullptr) {
+			CloseHandle(mapping_handle);
+			CloseHandle(file_handle);
+			return nullptr;
+		}
+		FileMapping *mapping = memnew(FileMapping);
+		mapping->data = static_cast<const uint8_t *>(mem);
+		mapping->size = file_size.QuadPart;
+		mapping->file_handle = file_handle;
+		mapping->mapping_handle = mapping_handle;
+		return mapping;
+#else
+		const CharString fpath_utf8 = fpath.utf8();
+		const int fd = ::open(fpath_utf8.get_data(), O_RDONLY);
+		if (fd == -1) {
+			return nullptr;
+		}
+		struct stat file_status;
+		if (fstat(fd, &file_status) == -1 || file_status.st_size <= 0) {
+			::close(fd);
+			return nullptr;
+		}
+		void *mem = mmap(nullptr, file_status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		// The mapping holds its own reference to the file
+		::close(fd);
+		if (mem == MAP_FAILED) {
+			return nullptr;
+		}
+		FileMapping *mapping = memnew(FileMapping);
+		mapping->data = static_cast<const uint8_t *>(mem);
+		mapping->size = file_status.st_size;
+		return mapping;
+#endif
+	}
+#endif
+
+	~FileMapping() {
+#if defined(_WIN32)
+		if (data != nullptr) {
+			UnmapViewOfFile(data);
+			CloseHandle(mapping_handle);
+			CloseHandle(file_handle);
+		}
+#elif defined(VOXEL_REGION_FILE_MAPPING_SUPPORTED)
+		if (data != nullptr) {
+			munmap(const_cast<uint8_t *>(data), size);
+		}
+#endif
+	}
+};
+
 RegionFile::RegionFile() {
 	// Defaults
 	_header.format.block_size_po2 = 4;
@@ -278,9 +415,46 @@ Error RegionFile::close() {
 		_file_access.unref();
 	}
 	_sectors.clear();
+	drop_file_mapping();
 	return err;
 }
 
+void RegionFile::set_mapped_reads_enabled(bool enabled) {
+	_mapped_reads_enabled = enabled;
+	if (!enabled) {
+		drop_file_mapping();
+	}
+}
+
+bool RegionFile::is_mapped_reads_enabled() const {
+	return _mapped_reads_enabled;
+}
+
+// Creates or refreshes the read-only mapping. Returns false when unsupported or when the file can't
+// be mapped, in which case callers use the regular file handle.
+bool RegionFile::ensure_file_mapping() {
+#ifdef VOXEL_REGION_FILE_MAPPING_SUPPORTED
+	if (!_mapped_reads_enabled || _file_access == nullptr) {
+		return false;
+	}
+	if (_file_mapping == nullptr) {
+		// Writes can still be sitting in the file handle's buffer
+		_file_access->flush();
+		_file_mapping = FileMapping::create(_file_path);
+	}
+	return _file_mapping != nullptr;
+#else
+	return false;
+#endif
+}
+
+void RegionFile::drop_file_mapping() {
+	if (_file_mapping != nullptr) {
+		memdelete(_file_mapping);
+		_file_mapping = nullptr;
+	}
+}
+
 bool RegionFile::is_open() const {
 	return _file_access != nullptr;
 }
@@ -292,6 +466,8 @@ bool RegionFile::set_format(const RegionFormat &format) {
 	// This will be the format used to create the next file if not found on open()
 	_header.format = format;
 	_header.blocks.resize(Vector3iUtil::get_volume(format.region_size));
+	_header.block_checksums.clear();
+	_header.block_checksums.resize(_header.blocks.size(), 0);
 
 	return true;
 }
@@ -331,14 +507,81 @@ Error RegionFile::load_block(Vector3i position, VoxelBufferInternal &out_block)
 	const unsigned int sector_index = block_info.get_sector_index();
 	const unsigned int block_begin = _blocks_begin_offset + sector_index * _header.format.sector_size;
 
+	if (ensure_file_mapping()) {
+		// Read the payload from the mapped view, served by the page cache without syscalls
+		const FileMapping &mapping = *_file_mapping;
+		if (uint64_t(block_begin) + sizeof(uint32_t) <= mapping.size) {
+			// Little-endian, like the rest of the format
+			uint32_t block_data_size;
+			memcpy(&block_data_size, mapping.data + block_begin, sizeof(uint32_t));
+			const uint64_t payload_begin = block_begin + sizeof(uint32_t);
+
+			ERR_FAIL_COND_V_MSG(payload_begin + block_data_size > mapping.size, ERR_PARSE_ERROR,
+					String("Failed to read block {0}").format(varray(position)));
+			const Span<const uint8_t> payload(mapping.data + payload_begin, block_data_size);
+			// Catch corruption before the deserializer runs on garbage
+			const uint64_t expected_checksum = _header.block_checksums[lut_index];
+			if (expected_checksum != 0 && compute_block_checksum(payload) != expected_checksum) {
+				ERR_PRINT(String("Checksum mismatch in block {0} of {1}").format(varray(position, _file_path)));
+				return ERR_FILE_CORRUPT;
+			}
+			ERR_FAIL_COND_V_MSG(!BlockSerializer::decompress_and_deserialize(payload, out_block), ERR_PARSE_ERROR,
+					String("Failed to read block {0}").format(varray(position)));
+
+			return OK;
+		}
+		// The mapping is shorter than expected, fall back on the file handle
+	}
+
 	f.seek(block_begin);
 
 	unsigned int block_data_size = f.get_32();
 	CRASH_COND(f.eof_reached());
 
-	ERR_FAIL_COND_V_MSG(!BlockSerializer::decompress_and_deserialize(f, block_data_size, out_block), ERR_PARSE_ERROR,
+	// Buffered so the checksum can be verified before deserialization
+	static thread_local std::vector<uint8_t> tls_payload;
+	tls_payload.resize(block_data_size);
+	ERR_FAIL_COND_V_MSG(f.get_buffer(tls_payload.data(), tls_payload.size()) != tls_payload.size(), ERR_PARSE_ERROR,
 			String("Failed to read block {0}").format(varray(position)));
 
+	const uint64_t expected_checksum = _header.block_checksums[lut_index];
+	if (expected_checksum != 0 && compute_block_checksum(to_span_const(tls_payload)) != expected_checksum) {
+		ERR_PRINT(String("Checksum mismatch in block {0} of {1}").format(varray(position, _file_path)));
+		return ERR_FILE_CORRUPT;
+	}
+
+	ERR_FAIL_COND_V_MSG(!BlockSerializer::decompress_and_deserialize(to_span_const(tls_payload), out_block),
+			ERR_PARSE_ERROR, String("Failed to read block {0}").format(varray(position)));
+
+	return OK;
+}
+
+Error RegionFile::erase_block(Vector3i position) {
+	ERR_FAIL_COND_V(_file_access == nullptr, ERR_FILE_CANT_WRITE);
+	ERR_FAIL_COND_V(!is_valid_block_position(position), ERR_INVALID_PARAMETER);
+	FileAccess &f = **_file_access;
+
+	// The mapping would become stale, drop it and remap on the next read
+	drop_file_mapping();
+
+	// We should be allowed to migrate before write operations
+	if (_header.version != FORMAT_VERSION) {
+		ERR_FAIL_COND_V(migrate_to_latest(f) == false, ERR_UNAVAILABLE);
+	}
+
+	const unsigned int lut_index = get_block_index_in_header(position);
+	ERR_FAIL_COND_V(lut_index >= _header.blocks.size(), ERR_INVALID_PARAMETER);
+	RegionBlockInfo &block_info = _header.blocks[lut_index];
+
+	if (block_info.data == 0) {
+		// Never saved, nothing to erase
+		return OK;
+	}
+
+	remove_sectors_from_block(position, block_info.get_sector_count());
+	block_info.data = 0;
+	_header.block_checksums[lut_index] = 0;
+	_header_modified = true;
 	return OK;
 }
 
@@ -349,6 +592,9 @@ Error RegionFile::save_block(Vector3i position, VoxelBufferInternal &block) {
 	ERR_FAIL_COND_V(_file_access == nullptr, ERR_FILE_CANT_WRITE);
 	FileAccess &f = **_file_access;
 
+	// The mapping would become stale (the file can grow), drop it and remap on the next read
+	drop_file_mapping();
+
 	// We should be allowed to migrate before write operations
 	if (_header.version != FORMAT_VERSION) {
 		ERR_FAIL_COND_V(migrate_to_latest(f) == false, ERR_UNAVAILABLE);
@@ -367,7 +613,8 @@ Error RegionFile::save_block(Vector3i position, VoxelBufferInternal &block) {
 		// Check position matches the sectors rule
 		CRASH_COND((block_offset - _blocks_begin_offset) % _header.format.sector_size != 0);
 
-		BlockSerializer::SerializeResult res = BlockSerializer::serialize_and_compress(block);
+		BlockSerializer::SerializeResult res =
+				BlockSerializer::serialize_and_compress(block, _archive_compression_enabled);
 		ERR_FAIL_COND_V(!res.success, ERR_INVALID_PARAMETER);
 		f.store_32(res.data.size());
 		const unsigned int written_size = sizeof(uint32_t) + res.data.size();
@@ -386,6 +633,7 @@ Error RegionFile::save_block(Vector3i position, VoxelBufferInternal &block) {
 			_sectors.push_back(position);
 		}
 
+		_header.block_checksums[lut_index] = compute_block_checksum(to_span_const(res.data));
 		_header_modified = true;
 
 	} else {
@@ -397,7 +645,8 @@ Error RegionFile::save_block(Vector3i position, VoxelBufferInternal &block) {
 		const int old_sector_count = block_info.get_sector_count();
 		CRASH_COND(old_sector_count < 1);
 
-		BlockSerializer::SerializeResult res = BlockSerializer::serialize_and_compress(block);
+		BlockSerializer::SerializeResult res =
+				BlockSerializer::serialize_and_compress(block, _archive_compression_enabled);
 		ERR_FAIL_COND_V(!res.success, ERR_INVALID_PARAMETER);
 		const std::vector<uint8_t> &data = res.data;
 		const size_t written_size = sizeof(uint32_t) + data.size();
@@ -452,11 +701,98 @@ Error RegionFile::save_block(Vector3i position, VoxelBufferInternal &block) {
 		}
 
 		block_info.set_sector_count(new_sector_count);
+		// The payload changed either way, its checksum follows
+		_header.block_checksums[lut_index] = compute_block_checksum(to_span_const(data));
+		_header_modified = true;
 	}
 
 	return OK;
 }
 
+int64_t RegionFile::get_file_length() const {
+	if (_file_access == nullptr) {
+		return 0;
+	}
+	return _file_access->get_length();
+}
+
+int64_t RegionFile::get_live_length() const {
+	if (_file_access == nullptr) {
+		return 0;
+	}
+	return _blocks_begin_offset + int64_t(_sectors.size()) * _header.format.sector_size;
+}
+
+Error RegionFile::compact() {
+	ZN_PROFILE_SCOPE();
+	ERR_FAIL_COND_V(_file_access == nullptr, ERR_FILE_CANT_OPEN);
+
+	// Sectors are kept contiguous by `remove_sectors_from_block`, so all live data sits at the
+	// front of the file. Compacting means rewriting the file without the stale tail.
+	const int64_t live_length = get_live_length();
+	if (get_file_length() <= live_length) {
+		return OK;
+	}
+
+	{
+		FileAccess &f = **_file_access;
+		if (_header_modified) {
+			f.seek(MAGIC_AND_VERSION_SIZE);
+			ERR_FAIL_COND_V(!save_header(f), ERR_FILE_CANT_WRITE);
+		}
+		f.flush();
+	}
+
+	drop_file_mapping();
+
+	const String fpath = _file_path;
+	const String tmp_path = fpath + ".tmp";
+	{
+		Ref<FileAccess> tmp_f = FileAccess::open(tmp_path, FileAccess::WRITE);
+		ERR_FAIL_COND_V(tmp_f.is_null(), ERR_FILE_CANT_WRITE);
+
+		FileAccess &f = **_file_access;
+		f.seek(0);
+
+		std::vector<uint8_t> copy_buffer;
+		copy_buffer.resize(65536);
+		int64_t remaining = live_length;
+		while (remaining > 0) {
+			const int64_t to_copy = math::min(int64_t(copy_buffer.size()), remaining);
+			const uint64_t read_count = f.get_buffer(copy_buffer.data(), to_copy);
+			ERR_FAIL_COND_V(int64_t(read_count) != to_copy, ERR_FILE_CORRUPT);
+			tmp_f->store_buffer(copy_buffer.data(), to_copy);
+			remaining -= to_copy;
+		}
+	}
+
+	// The header was saved above so this only drops the handle
+	close();
+
+	Ref<DirAccess> da = DirAccess::open(fpath.get_base_dir());
+	ERR_FAIL_COND_V(da.is_null(), ERR_FILE_CANT_OPEN);
+
+	// Not all platforms overwrite on rename, so the old file is moved aside first. Every failure
+	// path below puts a working file back in place; a crash leaves at worst a .old or .tmp to
+	// clean up, never a missing region.
+	const String old_path = fpath + ".old";
+	// A .old can remain from an earlier crash, it would make the rename fail on some platforms
+	da->remove(old_path.get_file());
+	if (da->rename(fpath.get_file(), old_path.get_file()) != OK) {
+		da->remove(tmp_path.get_file());
+		open(fpath, false);
+		ERR_FAIL_V(ERR_FILE_CANT_WRITE);
+	}
+	if (da->rename(tmp_path.get_file(), fpath.get_file()) != OK) {
+		da->rename(old_path.get_file(), fpath.get_file());
+		open(fpath, false);
+		ERR_FAIL_V(ERR_FILE_CANT_WRITE);
+	}
+	da->remove(old_path.get_file());
+
+	return open(fpath, false);
+}
+
 void RegionFile::pad_to_sector_size(FileAccess &f) {
 	const int64_t rpos = f.get_position() - _blocks_begin_offset;
 	if (rpos == 0) {
@@ -550,7 +886,9 @@ bool RegionFile::save_header(FileAccess &f) {
 	if (_header.version != FORMAT_VERSION) {
 		ERR_FAIL_COND_V(migrate_to_latest(f) == false, false);
 	}
-	ERR_FAIL_COND_V(!zylann::voxel::save_header(f, _header.version, _header.format, _header.blocks), false);
+	ERR_FAIL_COND_V(!zylann::voxel::save_header(
+							f, _header.version, _header.format, _header.blocks, _header.block_checksums),
+			false);
 	_blocks_begin_offset = f.get_position();
 	_header_modified = false;
 	return true;
@@ -576,10 +914,54 @@ bool RegionFile::migrate_from_v2_to_v3(FileAccess &f, RegionFormat &format) {
 
 	f.seek(0);
 
-	// Set version because otherwise `save_header` will attempt to migrate again causing stack-overflow
-	_header.version = FORMAT_VERSION;
+	// Calling the namespace-level writer directly: the member `save_header` would try to migrate
+	// to the latest version again while this chain is still in the middle of it
+	_header.version = FORMAT_VERSION_LEGACY_3;
+	return zylann::voxel::save_header(f, _header.version, _header.format, _header.blocks, _header.block_checksums);
+}
+
+bool RegionFile::migrate_from_v3_to_v4(FileAccess &f) {
+	ZN_PRINT_VERBOSE(zylann::format("Migrating region file {} from v3 to v4", _file_path));
+
+	// The header grows by the checksum table, inserted between the block table and block data.
+	// `insert_bytes` shifts the data region with chunked copies.
+	const unsigned int checksum_table_size =
+			Vector3iUtil::get_volume(_header.format.region_size) * sizeof(uint64_t);
+	f.seek(get_header_size_v3(_header.format));
+	insert_bytes(f, checksum_table_size);
+	_blocks_begin_offset = get_header_size_v4(_header.format);
+
+	_header.block_checksums.clear();
+	_header.block_checksums.resize(_header.blocks.size(), 0);
+
+	// Compute checksums of existing blocks with one sequential pass in file order
+	struct BlockRef {
+		uint32_t sector_index;
+		uint32_t lut_index;
+	};
+	std::vector<BlockRef> refs;
+	for (unsigned int i = 0; i < _header.blocks.size(); ++i) {
+		if (_header.blocks[i].data != 0) {
+			refs.push_back(BlockRef{ _header.blocks[i].get_sector_index(), i });
+		}
+	}
+	std::sort(refs.begin(), refs.end(), [](const BlockRef &a, const BlockRef &b) { //
+		return a.sector_index < b.sector_index;
+	});
+
+	std::vector<uint8_t> payload;
+	for (unsigned int i = 0; i < refs.size(); ++i) {
+		const BlockRef &ref = refs[i];
+		f.seek(_blocks_begin_offset + ref.sector_index * _header.format.sector_size);
+		const uint32_t payload_size = f.get_32();
+		ERR_FAIL_COND_V(f.get_position() + payload_size > f.get_length(), false);
+		payload.resize(payload_size);
+		ERR_FAIL_COND_V(f.get_buffer(payload.data(), payload.size()) != payload.size(), false);
+		_header.block_checksums[ref.lut_index] = compute_block_checksum(to_span_const(payload));
+	}
 
-	return save_header(f);
+	_header.version = FORMAT_VERSION;
+	return zylann::voxel::save_header(f, _header.version, _header.format, _header.blocks, _header.block_checksums);
 }
 
 bool RegionFile::migrate_to_latest(FileAccess &f) {
@@ -596,7 +978,12 @@ bool RegionFile::migrate_to_latest(FileAccess &f) {
 
 	if (version == FORMAT_VERSION_LEGACY_2) {
 		ERR_FAIL_COND_V(!migrate_from_v2_to_v3(f, _header.format), false);
-		version = FORMAT_VERSION;
+		version = _header.version;
+	}
+
+	if (version == FORMAT_VERSION_LEGACY_3) {
+		ERR_FAIL_COND_V(!migrate_from_v3_to_v4(f), false);
+		version = _header.version;
 	}
 
 	if (version != FORMAT_VERSION) {
@@ -609,7 +996,9 @@ bool RegionFile::migrate_to_latest(FileAccess &f) {
 }
 
 Error RegionFile::load_header(FileAccess &f) {
-	ERR_FAIL_COND_V(!zylann::voxel::load_header(f, _header.version, _header.format, _header.blocks), ERR_PARSE_ERROR);
+	ERR_FAIL_COND_V(
+			!zylann::voxel::load_header(f, _header.version, _header.format, _header.blocks, _header.block_checksums),
+			ERR_PARSE_ERROR);
 	_blocks_begin_offset = f.get_position();
 	return OK;
 }
@@ -86,6 +86,9 @@ public:
 
 	Error load_block(Vector3i position, VoxelBufferInternal &out_block);
 	Error save_block(Vector3i position, VoxelBufferInternal &block);
+	// Frees the block's sectors (shifting following data down, keeping the file contiguous) and
+	// clears its header entry. No-op if the block was never saved.
+	Error erase_block(Vector3i position);
 
 	unsigned int get_header_block_count() const;
 	bool has_block(Vector3i position) const;
@@ -94,8 +97,34 @@ public:
 
 	void debug_check();
 
+	// Fragmentation introspection. Saves that grow a block rewrite it at the end of the file and
+	// shift the rest down, so live data stays contiguous but the file keeps its peak length; the
+	// difference between these two is reclaimable only by `compact()`.
+	int64_t get_file_length() const;
+	int64_t get_live_length() const;
+
+	// Rewrites the file without the stale tail and swaps the result in, then reopens it. The swap
+	// goes through a temporary file and a rename, so an ill-timed crash leaves either the old file
+	// or the compacted one (plus at worst a leftover .tmp).
+	Error compact();
+
 	bool is_valid_block_position(const Vector3 position) const;
 
+	// When enabled, block payloads are read through a read-only memory mapping of the file, served
+	// by the OS page cache instead of per-block seek+read calls. Writes still go through the regular
+	// file handle and invalidate the mapping, which is remapped on the next read, so this pays off
+	// on read-mostly usage. Has no effect on platforms without memory mapping support.
+	void set_mapped_reads_enabled(bool enabled);
+	bool is_mapped_reads_enabled() const;
+
+	// When enabled, saved blocks use the denser delta-filtered compression tier. See VoxelStream.
+	void set_archive_compression_enabled(bool enabled) {
+		_archive_compression_enabled = enabled;
+	}
+	bool is_archive_compression_enabled() const {
+		return _archive_compression_enabled;
+	}
+
 private:
 	bool save_header(FileAccess &f);
 	Error load_header(FileAccess &f);
@@ -108,6 +137,10 @@ private:
 
 	bool migrate_to_latest(FileAccess &f);
 	bool migrate_from_v2_to_v3(FileAccess &f, RegionFormat &format);
+	bool migrate_from_v3_to_v4(FileAccess &f);
+
+	bool ensure_file_mapping();
+	void drop_file_mapping();
 
 	struct Header {
 		uint8_t version = -1;
@@ -116,6 +149,10 @@ private:
 		// This table always has the same size,
 		// and the same index always corresponds to the same 3D position.
 		std::vector<RegionBlockInfo> blocks;
+		// Format v4: checksum of each block's serialized payload, same indexing as `blocks`.
+		// Verified before deserialization so a corrupted block fails the load instead of feeding
+		// garbage to a worker. 0 means "not recorded" (e.g. file not migrated yet).
+		std::vector<uint64_t> block_checksums;
 	};
 
 	Ref<FileAccess> _file_access;
@@ -138,6 +175,11 @@ private:
 	std::vector<Vector3u16> _sectors;
 	uint32_t _blocks_begin_offset;
 	String _file_path;
+
+	struct FileMapping;
+	FileMapping *_file_mapping = nullptr;
+	bool _mapped_reads_enabled = false;
+	bool _archive_compression_enabled = false;
 };
 
 } // namespace zylann::voxel
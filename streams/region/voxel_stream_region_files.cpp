@@ -219,6 +219,152 @@ void VoxelStreamRegionFiles::_save_block(VoxelBufferInternal &voxel_buffer, Vect
 	CachedRegion *cache = open_region(region_pos, lod, true);
 	ERR_FAIL_COND_MSG(cache == nullptr, "Could not save region file data");
 	ERR_FAIL_COND(cache->region.save_block(block_rpos, voxel_buffer) != OK);
+
+	schedule_compaction_if_fragmented(*cache);
+}
+
+bool VoxelStreamRegionFiles::erase_blocks_in_box(Vector3i min_block_pos, Vector3i max_block_pos, uint8_t lod) {
+	ZN_PROFILE_SCOPE();
+	VoxelFileLockerWrite file_wlock(_directory_path.utf8().get_data());
+	MutexLock lock(_mutex);
+
+	if (_meta_loaded == false) {
+		// Nothing saved yet
+		return true;
+	}
+	ERR_FAIL_COND_V(int(lod) >= _meta.lod_count, false);
+
+	const Vector3i region_size = Vector3iUtil::create(1 << _meta.region_size_po2);
+
+	// Work region by region so each file is opened once; blocks erase as sector-free operations
+	// instead of saving empties one by one
+	const Vector3i min_region_pos = get_region_position_from_blocks(min_block_pos);
+	const Vector3i max_region_pos =
+			get_region_position_from_blocks(max_block_pos - Vector3i(1, 1, 1)) + Vector3i(1, 1, 1);
+
+	Vector3i region_pos;
+	for (region_pos.z = min_region_pos.z; region_pos.z < max_region_pos.z; ++region_pos.z) {
+		for (region_pos.y = min_region_pos.y; region_pos.y < max_region_pos.y; ++region_pos.y) {
+			for (region_pos.x = min_region_pos.x; region_pos.x < max_region_pos.x; ++region_pos.x) {
+				// Don't create files for regions that were never saved
+				CachedRegion *cache = open_region(region_pos, lod, false);
+				if (cache == nullptr || !cache->file_exists) {
+					continue;
+				}
+
+				const Vector3i region_origin_blocks = region_pos * region_size;
+				Vector3i local_min = min_block_pos - region_origin_blocks;
+				Vector3i local_max = max_block_pos - region_origin_blocks;
+				local_min.x = math::max(local_min.x, 0);
+				local_min.y = math::max(local_min.y, 0);
+				local_min.z = math::max(local_min.z, 0);
+				local_max.x = math::min(local_max.x, region_size.x);
+				local_max.y = math::min(local_max.y, region_size.y);
+				local_max.z = math::min(local_max.z, region_size.z);
+
+				Vector3i local_pos;
+				for (local_pos.z = local_min.z; local_pos.z < local_max.z; ++local_pos.z) {
+					for (local_pos.y = local_min.y; local_pos.y < local_max.y; ++local_pos.y) {
+						for (local_pos.x = local_min.x; local_pos.x < local_max.x; ++local_pos.x) {
+							const Error err = cache->region.erase_block(local_pos);
+							ERR_FAIL_COND_V(err != OK, false);
+						}
+					}
+				}
+
+				schedule_compaction_if_fragmented(*cache);
+			}
+		}
+	}
+
+	return true;
+}
+
+void VoxelStreamRegionFiles::schedule_compaction_if_fragmented(CachedRegion &cache) {
+	// Grown blocks leave stale bytes past the live data; once enough accumulate, the region gets
+	// rewritten in the background. Runs at idle priority so it never competes with streaming.
+	const int64_t MIN_STALE_BYTES = 256 * 1024;
+
+	class CompactRegionTask : public IThreadedTask {
+	public:
+		Ref<VoxelStreamRegionFiles> stream;
+		Vector3i region_pos;
+		unsigned int lod;
+
+		void run(ThreadedTaskContext ctx) override {
+			stream->compact_region(region_pos, lod);
+		}
+		int get_priority() override {
+			// Maintenance work, all actual streaming goes first
+			return 500000;
+		}
+		void apply_result() override {}
+	};
+
+	const int64_t live_length = cache.region.get_live_length();
+	const int64_t stale_length = cache.region.get_file_length() - live_length;
+
+	if (cache.compaction_scheduled || stale_length < MIN_STALE_BYTES || stale_length < live_length / 2) {
+		return;
+	}
+	cache.compaction_scheduled = true;
+
+	CompactRegionTask *task = memnew(CompactRegionTask);
+	task->stream = Ref<VoxelStreamRegionFiles>(this);
+	task->region_pos = cache.position;
+	task->lod = cache.lod;
+	VoxelServer::get_singleton().push_async_io_task(task);
+}
+
+void VoxelStreamRegionFiles::compact_region(Vector3i region_pos, unsigned int lod) {
+	ZN_PROFILE_SCOPE();
+	MutexLock lock(_mutex);
+
+	CachedRegion *cache = get_region_from_cache(region_pos, lod);
+	if (cache == nullptr || !cache->file_exists) {
+		// Evicted since scheduling, not worth reopening just to compact
+		return;
+	}
+	cache->compaction_scheduled = false;
+
+	const int64_t stale_length = cache->region.get_file_length() - cache->region.get_live_length();
+	if (stale_length <= 0) {
+		return;
+	}
+
+	const Error err = cache->region.compact();
+	if (err != OK) {
+		ERR_PRINT(String("Failed to compact region {0} lod {1}, error {2}")
+						  .format(varray(cache->position, cache->lod, err)));
+		return;
+	}
+	ZN_PRINT_VERBOSE(format("Compacted region {} lod {}, reclaimed {} bytes",
+			cache->position, cache->lod, size_t(stale_length)));
+}
+
+Dictionary VoxelStreamRegionFiles::debug_get_region_fragmentation_info() const {
+	MutexLock lock(_mutex);
+
+	int64_t total_file_bytes = 0;
+	int64_t total_live_bytes = 0;
+	int64_t worst_stale_bytes = 0;
+
+	for (unsigned int i = 0; i < _region_cache.size(); ++i) {
+		const CachedRegion *cache = _region_cache[i];
+		const int64_t file_length = cache->region.get_file_length();
+		const int64_t live_length = cache->region.get_live_length();
+		total_file_bytes += file_length;
+		total_live_bytes += live_length;
+		worst_stale_bytes = math::max(worst_stale_bytes, file_length - live_length);
+	}
+
+	Dictionary d;
+	d["open_region_count"] = int(_region_cache.size());
+	d["file_bytes"] = total_file_bytes;
+	d["live_bytes"] = total_live_bytes;
+	d["stale_bytes"] = total_file_bytes - total_live_bytes;
+	d["worst_region_stale_bytes"] = worst_stale_bytes;
+	return d;
 }
 
 String VoxelStreamRegionFiles::get_directory() const {
@@ -307,6 +453,11 @@ FileResult VoxelStreamRegionFiles::save_meta() {
 	_meta_saved = true;
 	_meta_loaded = true;
 
+	if (!_region_index_built) {
+		// Usually a brand new world, the index starts empty and gets filled as regions are created
+		build_region_index();
+	}
+
 	return FILE_OK;
 }
 
@@ -387,6 +538,8 @@ FileResult VoxelStreamRegionFiles::load_meta() {
 	_meta_loaded = true;
 	_meta_saved = true;
 
+	build_region_index();
+
 	return FILE_OK;
 }
 
@@ -413,6 +566,58 @@ void VoxelStreamRegionFiles::close_all_regions() {
 		memdelete(cache);
 	}
 	_region_cache.clear();
+	_region_index.clear();
+	_region_index_built = false;
+}
+
+uint64_t VoxelStreamRegionFiles::encode_region_index_key(Vector3i region_pos, unsigned int lod) {
+	// Regions span huge amounts of voxels, 16 bits per axis is more than enough
+	return ((static_cast<uint64_t>(lod) & 0xff) << 48) | ((static_cast<uint64_t>(region_pos.x) & 0xffff) << 32) |
+			((static_cast<uint64_t>(region_pos.y) & 0xffff) << 16) | (static_cast<uint64_t>(region_pos.z) & 0xffff);
+}
+
+// Scans the region directories once and remembers which region files exist, so first-touch of
+// absent regions (most of the world) doesn't pay a filesystem call in the load thread
+void VoxelStreamRegionFiles::build_region_index() {
+	ZN_PROFILE_SCOPE();
+
+	_region_index.clear();
+	_region_index_built = true;
+
+	for (unsigned int lod = 0; lod < _meta.lod_count; ++lod) {
+		const String lod_dir_path = _directory_path.plus_file(String("regions/lod{0}").format(varray(lod)));
+		Ref<DirAccess> dir = DirAccess::open(lod_dir_path);
+		if (dir.is_null()) {
+			// The world may not have saved anything at this LOD yet
+			continue;
+		}
+		dir->list_dir_begin();
+		for (String fname = dir->get_next(); !fname.is_empty(); fname = dir->get_next()) {
+			if (dir->current_is_dir() || fname.get_extension() != RegionFormat::FILE_EXTENSION) {
+				continue;
+			}
+			// Names are `r.X.Y.Z.ext`
+			const PackedStringArray parts = fname.split(".");
+			if (parts.size() != 5 || parts[0] != "r") {
+				continue;
+			}
+			const Vector3i region_pos(parts[1].to_int(), parts[2].to_int(), parts[3].to_int());
+			_region_index.insert(encode_region_index_key(region_pos, lod));
+		}
+		dir->list_dir_end();
+	}
+
+	ZN_PRINT_VERBOSE(format("Region index built with {} regions", _region_index.size()));
+}
+
+void VoxelStreamRegionFiles::prefetch_region(Vector3i region_pos, unsigned int lod) {
+	MutexLock lock(_mutex);
+	if (!_meta_loaded) {
+		return;
+	}
+	// Opening parses the header, later loads of this region find it ready in the cache.
+	// Not prefetching further neighbors, one hop is enough and avoids cascading over the world.
+	open_region(region_pos, lod, false, false);
 }
 
 String VoxelStreamRegionFiles::get_region_file_path(const Vector3i &region_pos, unsigned int lod) const {
@@ -439,7 +644,7 @@ VoxelStreamRegionFiles::CachedRegion *VoxelStreamRegionFiles::get_region_from_ca
 }
 
 VoxelStreamRegionFiles::CachedRegion *VoxelStreamRegionFiles::open_region(
-		const Vector3i region_pos, unsigned int lod, bool create_if_not_found) {
+		const Vector3i region_pos, unsigned int lod, bool create_if_not_found, bool prefetch_neighbors) {
 	ZN_PROFILE_SCOPE();
 	ERR_FAIL_COND_V(!_meta_loaded, nullptr);
 	ERR_FAIL_COND_V(lod < 0, nullptr);
@@ -449,6 +654,12 @@ VoxelStreamRegionFiles::CachedRegion *VoxelStreamRegionFiles::open_region(
 		return cached_region;
 	}
 
+	// The index knows which region files exist, absent regions don't cost a filesystem call
+	if (!create_if_not_found && _region_index_built &&
+			_region_index.find(encode_region_index_key(region_pos, lod)) == _region_index.end()) {
+		return nullptr;
+	}
+
 	while (_region_cache.size() > _max_open_regions - 1) {
 		close_oldest_region();
 	}
@@ -469,6 +680,8 @@ VoxelStreamRegionFiles::CachedRegion *VoxelStreamRegionFiles::open_region(
 		format.sector_size = _meta.sector_size;
 
 		cached_region->region.set_format(format);
+		cached_region->region.set_mapped_reads_enabled(_mapped_reads_enabled);
+		cached_region->region.set_archive_compression_enabled(is_archive_compression_enabled());
 		cached_region->position = region_pos;
 		cached_region->lod = lod;
 	}
@@ -511,6 +724,42 @@ VoxelStreamRegionFiles::CachedRegion *VoxelStreamRegionFiles::open_region(
 	cached_region->file_exists = true;
 	cached_region->last_opened = Time::get_singleton()->get_ticks_usec();
 
+	if (create_if_not_found && _region_index_built) {
+		// The file may have just been created
+		_region_index.insert(encode_region_index_key(region_pos, lod));
+	}
+
+	if (prefetch_neighbors && _region_index_built) {
+		// Headers of adjacent existing regions get parsed ahead of time by async tasks, so moving
+		// into them doesn't stall the load thread on first touch
+		class PrefetchRegionTask : public IThreadedTask {
+		public:
+			Ref<VoxelStreamRegionFiles> stream;
+			Vector3i region_pos;
+			unsigned int lod;
+
+			void run(ThreadedTaskContext ctx) override {
+				stream->prefetch_region(region_pos, lod);
+			}
+			void apply_result() override {}
+		};
+
+		const Vector3i moore_dirs[6] = { Vector3i(-1, 0, 0), Vector3i(1, 0, 0), Vector3i(0, -1, 0), Vector3i(0, 1, 0),
+			Vector3i(0, 0, -1), Vector3i(0, 0, 1) };
+		for (unsigned int i = 0; i < 6; ++i) {
+			const Vector3i npos = region_pos + moore_dirs[i];
+			if (_region_index.find(encode_region_index_key(npos, lod)) == _region_index.end() ||
+					get_region_from_cache(npos, lod) != nullptr) {
+				continue;
+			}
+			PrefetchRegionTask *task = memnew(PrefetchRegionTask);
+			task->stream = Ref<VoxelStreamRegionFiles>(this);
+			task->region_pos = npos;
+			task->lod = lod;
+			VoxelServer::get_singleton().push_async_io_task(task);
+		}
+	}
+
 	return cached_region;
 }
 
@@ -861,6 +1110,22 @@ void VoxelStreamRegionFiles::set_lod_count(int p_lod_count) {
 	emit_changed();
 }
 
+void VoxelStreamRegionFiles::set_mapped_reads_enabled(bool enabled) {
+	MutexLock lock(_mutex);
+	if (_mapped_reads_enabled == enabled) {
+		return;
+	}
+	_mapped_reads_enabled = enabled;
+	for (unsigned int i = 0; i < _region_cache.size(); ++i) {
+		_region_cache[i]->region.set_mapped_reads_enabled(enabled);
+	}
+}
+
+bool VoxelStreamRegionFiles::is_mapped_reads_enabled() const {
+	MutexLock lock(_mutex);
+	return _mapped_reads_enabled;
+}
+
 void VoxelStreamRegionFiles::convert_files(Dictionary d) {
 	Meta meta;
 	meta.version = _meta.version;
@@ -909,8 +1174,16 @@ void VoxelStreamRegionFiles::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_sector_size"), &VoxelStreamRegionFiles::set_sector_size);
 
 	ClassDB::bind_method(D_METHOD("convert_files", "new_settings"), &VoxelStreamRegionFiles::convert_files);
+	ClassDB::bind_method(D_METHOD("debug_get_region_fragmentation_info"),
+			&VoxelStreamRegionFiles::debug_get_region_fragmentation_info);
+
+	ClassDB::bind_method(
+			D_METHOD("set_mapped_reads_enabled", "enabled"), &VoxelStreamRegionFiles::set_mapped_reads_enabled);
+	ClassDB::bind_method(D_METHOD("is_mapped_reads_enabled"), &VoxelStreamRegionFiles::is_mapped_reads_enabled);
 
 	ADD_PROPERTY(PropertyInfo(Variant::STRING, "directory", PROPERTY_HINT_DIR), "set_directory", "get_directory");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "mapped_reads_enabled"), "set_mapped_reads_enabled",
+			"is_mapped_reads_enabled");
 
 	ADD_GROUP("Dimensions", "");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "lod_count"), "set_lod_count", "get_lod_count");
@@ -5,8 +5,11 @@
 #include "../../util/thread/mutex.h"
 #include "../file_utils.h"
 #include "../voxel_stream.h"
+
 #include "region_file.h"
 
+#include <unordered_set>
+
 class FileAccess;
 
 namespace zylann::voxel {
@@ -32,6 +35,13 @@ public:
 	void load_voxel_blocks(Span<VoxelStream::VoxelQueryData> p_blocks) override;
 	void save_voxel_blocks(Span<VoxelStream::VoxelQueryData> p_blocks) override;
 
+	bool erase_blocks_in_box(Vector3i min_block_pos, Vector3i max_block_pos, uint8_t lod) override;
+
+	bool supports_variable_block_depths() const override {
+		// The region format fixes channel depths for every block
+		return false;
+	}
+
 	int get_used_channels_mask() const override;
 
 	String get_directory() const;
@@ -53,6 +63,15 @@ public:
 
 	void convert_files(Dictionary d);
 
+	// Aggregated fragmentation info of currently open regions, for monitoring long-running worlds.
+	// Stale bytes accumulate when saved blocks grow; background compaction reclaims them.
+	Dictionary debug_get_region_fragmentation_info() const;
+
+	// When enabled, region files serve block payloads through a read-only memory mapping instead of
+	// seek+read calls. Worth it on read-mostly usage like dedicated servers. See RegionFile.
+	void set_mapped_reads_enabled(bool enabled);
+	bool is_mapped_reads_enabled() const;
+
 protected:
 	static void _bind_methods();
 
@@ -75,7 +94,15 @@ private:
 	Vector3i get_region_position_from_blocks(const Vector3i &block_position) const;
 	void close_all_regions();
 	String get_region_file_path(const Vector3i &region_pos, unsigned int lod) const;
-	CachedRegion *open_region(const Vector3i region_pos, unsigned int lod, bool create_if_not_found);
+	CachedRegion *open_region(
+			const Vector3i region_pos, unsigned int lod, bool create_if_not_found, bool prefetch_neighbors = true);
+	// Opens a region (parsing its header) ahead of time, from an async task
+	void prefetch_region(Vector3i region_pos, unsigned int lod);
+	// Rewrites a region file without its stale bytes, from an async task
+	void compact_region(Vector3i region_pos, unsigned int lod);
+	void schedule_compaction_if_fragmented(CachedRegion &cache);
+	void build_region_index();
+	static uint64_t encode_region_index_key(Vector3i region_pos, unsigned int lod);
 	void close_region(CachedRegion *cache);
 	CachedRegion *get_region_from_cache(const Vector3i pos, int lod) const;
 	void close_oldest_region();
@@ -120,6 +147,8 @@ private:
 		Vector3i position;
 		int lod = 0;
 		bool file_exists = false;
+		// Only one compaction gets queued per region at a time
+		bool compaction_scheduled = false;
 		RegionFile region;
 		uint64_t last_opened = 0;
 		//uint64_t last_accessed;
@@ -131,7 +160,15 @@ private:
 	bool _meta_saved = false;
 	std::vector<CachedRegion *> _region_cache;
 	// TODO Add memory caches to increase capacity.
-	unsigned int _max_open_regions = MIN(8, FOPEN_MAX);
+	// Kept well below FOPEN_MAX, but large enough that revisiting areas doesn't thrash handles
+	unsigned int _max_open_regions = MIN(64, FOPEN_MAX);
+
+	// Which region files exist on disk, built once when metadata loads by scanning the region
+	// directories, and maintained when regions are created. Lets first-touch of absent regions
+	// return without any filesystem call.
+	std::unordered_set<uint64_t> _region_index;
+	bool _region_index_built = false;
+	bool _mapped_reads_enabled = false;
 
 	Mutex _mutex;
 };
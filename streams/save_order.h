@@ -0,0 +1,43 @@
+#ifndef VOXEL_SAVE_ORDER_H
+#define VOXEL_SAVE_ORDER_H
+
+#include "../util/math/vector3i.h"
+
+namespace zylann::voxel {
+
+// 64-bit Morton interleave (21 bits per axis), used to order block saves
+inline uint64_t morton3_64(uint64_t x, uint64_t y, uint64_t z) {
+	struct L {
+		static inline uint64_t part(uint64_t v) {
+			v &= 0x1fffff; // 21 bits
+			v = (v | v << 32) & 0x1f00000000ffff;
+			v = (v | v << 16) & 0x1f0000ff0000ff;
+			v = (v | v << 8) & 0x100f00f00f00f00f;
+			v = (v | v << 4) & 0x10c30c30c30c30c3;
+			v = (v | v << 2) & 0x1249249249249249;
+			return v;
+		}
+	};
+	return L::part(x) | (L::part(y) << 1) | (L::part(z) << 2);
+}
+
+// Key ordering dirty-block flushes so writes stream sequentially instead of seeking randomly:
+// grouped by LOD first, then along a space-filling curve. Morton order nests by every
+// power-of-two-aligned cube, which includes region files, so blocks of the same region come out
+// together and follow the curve within it; database streams benefit the same way through key
+// locality. Sorting by this before dispatching saves turns flush I/O sequential on spinning and
+// network storage.
+inline uint64_t sequential_save_order_key(Vector3i block_pos, unsigned int lod) {
+	// Bias into unsigned space; block coordinates fit well within +/- 2^20
+	const int64_t bias = int64_t(1) << 20;
+	const uint64_t m = morton3_64(
+			uint64_t(int64_t(block_pos.x) + bias), //
+			uint64_t(int64_t(block_pos.y) + bias), //
+			uint64_t(int64_t(block_pos.z) + bias));
+	// LOD in the top bits so each LOD's blocks (stored in separate regions) flush as one run
+	return (uint64_t(lod) << 60) | (m & 0x0fffffffffffffff);
+}
+
+} // namespace zylann::voxel
+
+#endif // VOXEL_SAVE_ORDER_H
@@ -2,9 +2,12 @@
 #include "../../thirdparty/sqlite/sqlite3.h"
 #include "../../util/godot/funcs.h"
 #include "../../util/log.h"
+#include "../../util/math/funcs.h"
+#include "../../util/thread/thread.h"
 #include "../../util/profiling.h"
 #include "../../util/string_funcs.h"
 #include "../compressed_data.h"
+#include <core/os/time.h>
 
 #include <limits>
 #include <string>
@@ -70,13 +73,17 @@ public:
 	VoxelStreamSQLiteInternal();
 	~VoxelStreamSQLiteInternal();
 
-	bool open(const char *fpath);
+	bool open(const char *fpath, bool read_only = false);
 	void close();
 
 	bool is_open() const {
 		return _db != nullptr;
 	}
 
+	bool is_read_only() const {
+		return _read_only;
+	}
+
 	// Returns the file path from SQLite
 	const char *get_file_path() const;
 
@@ -90,6 +97,9 @@ public:
 	bool end_transaction();
 
 	bool save_block(BlockLocation loc, const std::vector<uint8_t> &block_data, BlockType type);
+	// Deletes every block whose key lies in [begin, end], both inclusive. Used with key ranges
+	// sharing the same lod/x/y prefix, where z spans are contiguous.
+	bool erase_blocks_range(BlockLocation begin, BlockLocation end);
 	VoxelStream::ResultCode load_block(BlockLocation loc, std::vector<uint8_t> &out_block_data, BlockType type);
 
 	bool load_all_blocks(void *callback_data,
@@ -139,6 +149,8 @@ private:
 	sqlite3_stmt *_load_channels_statement = nullptr;
 	sqlite3_stmt *_save_channel_statement = nullptr;
 	sqlite3_stmt *_load_all_blocks_statement = nullptr;
+	sqlite3_stmt *_erase_blocks_range_statement = nullptr;
+	bool _read_only = false;
 };
 
 VoxelStreamSQLiteInternal::VoxelStreamSQLiteInternal() {}
@@ -147,11 +159,14 @@ VoxelStreamSQLiteInternal::~VoxelStreamSQLiteInternal() {
 	close();
 }
 
-bool VoxelStreamSQLiteInternal::open(const char *fpath) {
+bool VoxelStreamSQLiteInternal::open(const char *fpath, bool read_only) {
 	ZN_PROFILE_SCOPE();
 	close();
 
-	int rc = sqlite3_open_v2(fpath, &_db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr);
+	_read_only = read_only;
+
+	const int open_flags = read_only ? SQLITE_OPEN_READONLY : (SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+	int rc = sqlite3_open_v2(fpath, &_db, open_flags, nullptr);
 	if (rc != 0) {
 		ERR_PRINT(String("Could not open database: {0}").format(varray(sqlite3_errmsg(_db))));
 		close();
@@ -161,32 +176,54 @@ bool VoxelStreamSQLiteInternal::open(const char *fpath) {
 	sqlite3 *db = _db;
 	char *error_message = nullptr;
 
-	// Create tables if they dont exist
-	const char *tables[3] = { "CREATE TABLE IF NOT EXISTS meta (version INTEGER, block_size_po2 INTEGER)",
-		"CREATE TABLE IF NOT EXISTS blocks (loc INTEGER PRIMARY KEY, vb BLOB, instances BLOB)",
-		"CREATE TABLE IF NOT EXISTS channels (idx INTEGER PRIMARY KEY, depth INTEGER)" };
-	for (size_t i = 0; i < 3; ++i) {
-		rc = sqlite3_exec(db, tables[i], nullptr, nullptr, &error_message);
-		if (rc != SQLITE_OK) {
-			ERR_PRINT(String("Failed to create table: {0}").format(varray(error_message)));
-			sqlite3_free(error_message);
-			close();
-			return false;
+	if (!read_only) {
+		// WAL journaling lets read-only connections run while the writer streams saves in, instead
+		// of everything serializing on the database file lock. The mode is persistent, readers
+		// inherit it. NORMAL synchronous is the recommended pairing and remains consistent.
+		const char *pragmas[2] = { "PRAGMA journal_mode=WAL", "PRAGMA synchronous=NORMAL" };
+		for (size_t i = 0; i < 2; ++i) {
+			rc = sqlite3_exec(db, pragmas[i], nullptr, nullptr, &error_message);
+			if (rc != SQLITE_OK) {
+				// Not fatal, the database works in any journaling mode, just with less concurrency
+				ZN_PRINT_VERBOSE(format("Could not apply `{}`: {}", pragmas[i], error_message));
+				sqlite3_free(error_message);
+				error_message = nullptr;
+			}
+		}
+
+		// Create tables if they dont exist
+		const char *tables[3] = { "CREATE TABLE IF NOT EXISTS meta (version INTEGER, block_size_po2 INTEGER)",
+			"CREATE TABLE IF NOT EXISTS blocks (loc INTEGER PRIMARY KEY, vb BLOB, instances BLOB)",
+			"CREATE TABLE IF NOT EXISTS channels (idx INTEGER PRIMARY KEY, depth INTEGER)" };
+		for (size_t i = 0; i < 3; ++i) {
+			rc = sqlite3_exec(db, tables[i], nullptr, nullptr, &error_message);
+			if (rc != SQLITE_OK) {
+				ERR_PRINT(String("Failed to create table: {0}").format(varray(error_message)));
+				sqlite3_free(error_message);
+				close();
+				return false;
+			}
 		}
 	}
 
-	// Prepare statements
-	if (!prepare(db, &_update_voxel_block_statement,
-				"INSERT INTO blocks VALUES (:loc, :vb, null) "
-				"ON CONFLICT(loc) DO UPDATE SET vb=excluded.vb")) {
-		return false;
+	// Prepare statements. Write statements are only used on the writer connection.
+	if (!read_only) {
+		if (!prepare(db, &_update_voxel_block_statement,
+					"INSERT INTO blocks VALUES (:loc, :vb, null) "
+					"ON CONFLICT(loc) DO UPDATE SET vb=excluded.vb")) {
+			return false;
+		}
+		if (!prepare(db, &_update_instance_block_statement,
+					"INSERT INTO blocks VALUES (:loc, null, :instances) "
+					"ON CONFLICT(loc) DO UPDATE SET instances=excluded.instances")) {
+			return false;
+		}
 	}
-	if (!prepare(db, &_get_voxel_block_statement, "SELECT vb FROM blocks WHERE loc=:loc")) {
+	if (!prepare(db, &_erase_blocks_range_statement,
+				"DELETE FROM blocks WHERE loc >= :loc_begin AND loc <= :loc_end")) {
 		return false;
 	}
-	if (!prepare(db, &_update_instance_block_statement,
-				"INSERT INTO blocks VALUES (:loc, null, :instances) "
-				"ON CONFLICT(loc) DO UPDATE SET instances=excluded.instances")) {
+	if (!prepare(db, &_get_voxel_block_statement, "SELECT vb FROM blocks WHERE loc=:loc")) {
 		return false;
 	}
 	if (!prepare(db, &_get_instance_block_statement, "SELECT instances FROM blocks WHERE loc=:loc")) {
@@ -219,6 +256,12 @@ bool VoxelStreamSQLiteInternal::open(const char *fpath) {
 	// Is the database setup?
 	Meta meta = load_meta();
 	if (meta.version == -1) {
+		if (read_only) {
+			// The writer connection is responsible for initializing the database
+			ERR_PRINT("Cannot use a read-only connection on an uninitialized database");
+			close();
+			return false;
+		}
 		// Setup database
 		meta.version = VERSION;
 		// Defaults
@@ -250,6 +293,7 @@ void VoxelStreamSQLiteInternal::close() {
 	finalize(_load_channels_statement);
 	finalize(_save_channel_statement);
 	finalize(_load_all_blocks_statement);
+	finalize(_erase_blocks_range_statement);
 	sqlite3_close(_db);
 	_db = nullptr;
 	_opened_path.clear();
@@ -290,8 +334,37 @@ bool VoxelStreamSQLiteInternal::end_transaction() {
 	return true;
 }
 
+bool VoxelStreamSQLiteInternal::erase_blocks_range(BlockLocation begin, BlockLocation end) {
+	ERR_FAIL_COND_V(_read_only, false);
+	sqlite3 *db = _db;
+	sqlite3_stmt *s = _erase_blocks_range_statement;
+
+	int rc = sqlite3_reset(s);
+	if (rc != SQLITE_OK) {
+		ERR_PRINT(sqlite3_errmsg(db));
+		return false;
+	}
+	rc = sqlite3_bind_int64(s, 1, begin.encode());
+	if (rc != SQLITE_OK) {
+		ERR_PRINT(sqlite3_errmsg(db));
+		return false;
+	}
+	rc = sqlite3_bind_int64(s, 2, end.encode());
+	if (rc != SQLITE_OK) {
+		ERR_PRINT(sqlite3_errmsg(db));
+		return false;
+	}
+	rc = sqlite3_step(s);
+	if (rc != SQLITE_DONE) {
+		ERR_PRINT(sqlite3_errmsg(db));
+		return false;
+	}
+	return true;
+}
+
 bool VoxelStreamSQLiteInternal::save_block(BlockLocation loc, const std::vector<uint8_t> &block_data, BlockType type) {
 	ZN_PROFILE_SCOPE();
+	ERR_FAIL_COND_V(_read_only, false);
 
 	sqlite3 *db = _db;
 
@@ -594,10 +667,16 @@ VoxelStreamSQLite::~VoxelStreamSQLite() {
 		delete *it;
 	}
 	_connection_pool.clear();
+	if (_write_connection != nullptr) {
+		delete _write_connection;
+		_write_connection = nullptr;
+	}
 	ZN_PRINT_VERBOSE("~VoxelStreamSQLite done");
 }
 
 void VoxelStreamSQLite::set_database_path(String path) {
+	// Lock order: write connection first, then the pool
+	MutexLock wlock(_write_connection_mutex);
 	MutexLock lock(_connection_mutex);
 	if (path == _connection_path) {
 		return;
@@ -614,6 +693,10 @@ void VoxelStreamSQLite::set_database_path(String path) {
 			flush_cache(&con);
 		}
 	}
+	if (_write_connection != nullptr) {
+		delete _write_connection;
+		_write_connection = nullptr;
+	}
 	for (auto it = _connection_pool.begin(); it != _connection_pool.end(); ++it) {
 		delete *it;
 	}
@@ -635,13 +718,35 @@ void VoxelStreamSQLite::save_voxel_block(VoxelStream::VoxelQueryData &q) {
 	save_voxel_blocks(Span<VoxelStream::VoxelQueryData>(&q, 1));
 }
 
+void VoxelStreamSQLite::save_voxel_block_delta(VoxelStream::VoxelQueryData &q, Span<const Box3i> dirty_boxes) {
+	// TODO Get block size from database
+	const int bs_po2 = constants::DEFAULT_BLOCK_SIZE_PO2;
+	const Vector3i pos = q.origin_in_voxels >> (bs_po2 + q.lod);
+
+	if (!BlockLocation::validate(pos, q.lod)) {
+		ERR_PRINT(String("Block position {0} is outside of supported range").format(varray(pos)));
+		return;
+	}
+	if (!is_delta_saves_enabled() || dirty_boxes.size() == 0) {
+		_cache.save_voxel_block(pos, q.lod, q.voxel_buffer);
+	} else {
+		// The cache keeps the full block (so cached loads stay whole); only flushing writes the
+		// compact delta blob
+		_cache.save_voxel_block_delta(pos, q.lod, q.voxel_buffer, dirty_boxes);
+	}
+
+	if (should_flush_on_save()) {
+		flush_cache();
+	}
+}
+
 void VoxelStreamSQLite::load_voxel_blocks(Span<VoxelStream::VoxelQueryData> p_blocks) {
 	ZN_PROFILE_SCOPE();
 
 	// TODO Get block size from database
 	const int bs_po2 = constants::DEFAULT_BLOCK_SIZE_PO2;
 
-	// Check the cache first
+	// Check the caches first
 	std::vector<unsigned int> blocks_to_load;
 	for (unsigned int i = 0; i < p_blocks.size(); ++i) {
 		VoxelStream::VoxelQueryData &q = p_blocks[i];
@@ -650,6 +755,9 @@ void VoxelStreamSQLite::load_voxel_blocks(Span<VoxelStream::VoxelQueryData> p_bl
 		if (_cache.load_voxel_block(pos, q.lod, q.voxel_buffer)) {
 			q.result = RESULT_BLOCK_FOUND;
 
+		} else if (_prefetching_enabled && _prefetch_cache.load_voxel_block(pos, q.lod, q.voxel_buffer)) {
+			q.result = RESULT_BLOCK_FOUND;
+
 		} else {
 			blocks_to_load.push_back(i);
 		}
@@ -681,6 +789,22 @@ void VoxelStreamSQLite::load_voxel_blocks(Span<VoxelStream::VoxelQueryData> p_bl
 		const ResultCode res = con->load_block(loc, _temp_block_data, VoxelStreamSQLiteInternal::VOXELS);
 
 		if (res == RESULT_BLOCK_FOUND) {
+			if (BlockSerializer::is_compressed_delta_blob(to_span_const(_temp_block_data))) {
+				// Delta against generator output: only the stored regions go into the buffer,
+				// the requester has to generate the rest underneath
+				if (q.delta_boxes == nullptr) {
+					ERR_PRINT_ONCE("Found a delta-saved block but the requester cannot reconstruct it");
+					q.result = RESULT_ERROR;
+					continue;
+				}
+				if (!BlockSerializer::decompress_and_deserialize_delta(
+							to_span_const(_temp_block_data), q.voxel_buffer, *q.delta_boxes)) {
+					q.result = RESULT_ERROR;
+					continue;
+				}
+				q.result = RESULT_BLOCK_FOUND_PARTIAL;
+				continue;
+			}
 			// TODO Not sure if we should actually expect non-null. There can be legit not found blocks.
 			BlockSerializer::decompress_and_deserialize(to_span_const(_temp_block_data), q.voxel_buffer);
 		}
@@ -688,6 +812,67 @@ void VoxelStreamSQLite::load_voxel_blocks(Span<VoxelStream::VoxelQueryData> p_bl
 		q.result = res;
 	}
 
+	if (_prefetching_enabled) {
+		// Predict the next set of requests from how the centroid of this one moved, and read it ahead
+		// within the same transaction. This runs on the streaming thread, ahead of demand.
+		Vector3 centroid;
+		unsigned int count = 0;
+		for (unsigned int i = 0; i < blocks_to_load.size(); ++i) {
+			const VoxelStream::VoxelQueryData &q = p_blocks[blocks_to_load[i]];
+			if (q.lod == 0) {
+				centroid += Vector3(q.origin_in_voxels >> bs_po2);
+				++count;
+			}
+		}
+		if (count > 0) {
+			centroid /= count;
+			Vector3i velocity;
+			bool has_velocity = false;
+			{
+				MutexLock lock(_prefetch_mutex);
+				if (_has_last_load_centroid) {
+					velocity = Vector3i((centroid - _last_load_centroid).round());
+					has_velocity = velocity != Vector3i();
+				}
+				_last_load_centroid = centroid;
+				_has_last_load_centroid = true;
+			}
+			if (has_velocity) {
+				if (_prefetch_cache.get_indicative_block_count() >= PREFETCH_CACHE_SIZE) {
+					// Crude eviction; predictable movement will quickly refill the relevant area
+					_prefetch_cache.flush([](VoxelStreamCache::Block &block) {});
+				}
+				for (unsigned int i = 0; i < blocks_to_load.size(); ++i) {
+					const VoxelStream::VoxelQueryData &q = p_blocks[blocks_to_load[i]];
+					if (q.lod != 0) {
+						continue;
+					}
+					const Vector3i predicted_pos = (q.origin_in_voxels >> bs_po2) + velocity;
+
+					// Skip blocks we already have
+					if (_cache.has_voxel_block(predicted_pos, 0) || _prefetch_cache.has_voxel_block(predicted_pos, 0)) {
+						continue;
+					}
+
+					BlockLocation loc;
+					loc.x = predicted_pos.x;
+					loc.y = predicted_pos.y;
+					loc.z = predicted_pos.z;
+					loc.lod = 0;
+
+					const ResultCode res = con->load_block(loc, _temp_block_data, VoxelStreamSQLiteInternal::VOXELS);
+					if (res == RESULT_BLOCK_FOUND) {
+						VoxelBufferInternal prefetched;
+						if (BlockSerializer::decompress_and_deserialize(
+									to_span_const(_temp_block_data), prefetched)) {
+							_prefetch_cache.save_voxel_block(predicted_pos, 0, prefetched);
+						}
+					}
+				}
+			}
+		}
+	}
+
 	ERR_FAIL_COND(con->end_transaction() == false);
 
 	recycle_connection(con);
@@ -711,11 +896,86 @@ void VoxelStreamSQLite::save_voxel_blocks(Span<VoxelStream::VoxelQueryData> p_bl
 	}
 
 	// TODO We should consider using a serialized cache, and measure the threshold in bytes
-	if (_cache.get_indicative_block_count() >= CACHE_SIZE) {
+	if (should_flush_on_save()) {
 		flush_cache();
 	}
 }
 
+bool VoxelStreamSQLite::erase_blocks_in_box(Vector3i min_block_pos, Vector3i max_block_pos, uint8_t lod) {
+	ZN_PROFILE_SCOPE();
+	ERR_FAIL_COND_V(min_block_pos.x > max_block_pos.x || min_block_pos.y > max_block_pos.y ||
+					min_block_pos.z > max_block_pos.z,
+			false);
+	ERR_FAIL_COND_V(!BlockLocation::validate(min_block_pos, lod), false);
+	// The range is max-exclusive, the highest touched block is max - 1
+	ERR_FAIL_COND_V(!BlockLocation::validate(max_block_pos - Vector3i(1, 1, 1), lod), false);
+
+	// Anything cached for that area must not resurrect after the delete
+	flush_cache();
+
+	VoxelStreamSQLiteInternal *con = get_connection();
+	ERR_FAIL_COND_V(con == nullptr, false);
+
+	// Keys pack as (lod, x, y, z), so every (x, y) column of the box is one contiguous key range;
+	// a whole reset area deletes with x_extent * y_extent range statements in a single transaction
+	// Negative coordinates encode as large unsigned halves in the packed key, so a z interval
+	// crossing zero is not one contiguous key range; it splits into a negative and a
+	// non-negative part
+	struct ZRange {
+		int16_t z_min;
+		int16_t z_max; // Inclusive
+	};
+	ZRange z_ranges[2];
+	unsigned int z_range_count = 0;
+	if (min_block_pos.z < 0 && max_block_pos.z > 0) {
+		z_ranges[z_range_count++] = ZRange{ int16_t(min_block_pos.z), int16_t(-1) };
+		z_ranges[z_range_count++] = ZRange{ int16_t(0), int16_t(max_block_pos.z - 1) };
+	} else {
+		z_ranges[z_range_count++] = ZRange{ int16_t(min_block_pos.z), int16_t(max_block_pos.z - 1) };
+	}
+
+	ERR_FAIL_COND_V(con->begin_transaction() == false, false);
+	bool success = true;
+	for (int x = min_block_pos.x; x < max_block_pos.x && success; ++x) {
+		for (int y = min_block_pos.y; y < max_block_pos.y && success; ++y) {
+			for (unsigned int zi = 0; zi < z_range_count && success; ++zi) {
+				BlockLocation begin;
+				begin.x = x;
+				begin.y = y;
+				begin.z = z_ranges[zi].z_min;
+				begin.lod = lod;
+				BlockLocation end;
+				end.x = x;
+				end.y = y;
+				end.z = z_ranges[zi].z_max;
+				end.lod = lod;
+				success = con->erase_blocks_range(begin, end);
+			}
+		}
+	}
+	ERR_FAIL_COND_V(con->end_transaction() == false, false);
+
+	recycle_connection(con);
+	return success;
+}
+
+void VoxelStreamSQLite::set_cache_memory_cap_mb(int mb) {
+	_cache_memory_cap_bytes = uint64_t(math::max(mb, 0)) * 1024 * 1024;
+}
+
+int VoxelStreamSQLite::get_cache_memory_cap_mb() const {
+	return _cache_memory_cap_bytes / (1024 * 1024);
+}
+
+Dictionary VoxelStreamSQLite::get_cache_statistics() const {
+	Dictionary d;
+	d["blocks"] = _cache.get_indicative_block_count();
+	d["memory_bytes"] = int64_t(_cache.get_memory_usage());
+	d["hits"] = int64_t(_cache.get_hit_count());
+	d["misses"] = int64_t(_cache.get_miss_count());
+	return d;
+}
+
 bool VoxelStreamSQLite::supports_instance_blocks() const {
 	return true;
 }
@@ -796,7 +1056,7 @@ void VoxelStreamSQLite::save_instance_blocks(Span<VoxelStream::InstancesQueryDat
 	}
 
 	// TODO Optimization: we should consider using a serialized cache, and measure the threshold in bytes
-	if (_cache.get_indicative_block_count() >= CACHE_SIZE) {
+	if (should_flush_on_save()) {
 		flush_cache();
 	}
 }
@@ -807,9 +1067,113 @@ void VoxelStreamSQLite::load_all_blocks(FullLoadingResult &result) {
 	VoxelStreamSQLiteInternal *con = get_connection();
 	ERR_FAIL_COND(con == nullptr);
 
+	// Blobs are copied out of the database iteration in bounded chunks, and each chunk's
+	// decompression and deserialization (the CPU-heavy part of a full-map scan) fans out over
+	// temporary threads. Raw-blob residency stays bounded by the chunk size; row iteration itself
+	// is sequential I/O and stays on this thread.
+
+	struct RawBlock {
+		BlockLocation location;
+		std::vector<uint8_t> voxel_data;
+		std::vector<uint8_t> instances_data;
+	};
+
 	struct Context {
-		VoxelStreamSQLite &stream;
+		std::vector<RawBlock> chunk;
 		FullLoadingResult &result;
+
+		// Number of raw blobs deserialized in parallel per batch
+		static const unsigned int CHUNK_SIZE = 1024;
+
+		static void deserialize_raw_block(const RawBlock &raw, FullLoadingResult::Block &out_block, bool &out_valid) {
+			out_valid = false;
+			out_block.position = Vector3i(raw.location.x, raw.location.y, raw.location.z);
+			out_block.lod = raw.location.lod;
+
+			if (raw.voxel_data.size() > 0) {
+				std::shared_ptr<VoxelBufferInternal> voxels = make_shared_instance<VoxelBufferInternal>();
+				ERR_FAIL_COND(!BlockSerializer::decompress_and_deserialize(to_span_const(raw.voxel_data), *voxels));
+				out_block.voxels = voxels;
+			}
+
+			if (raw.instances_data.size() > 0) {
+				static thread_local std::vector<uint8_t> tls_instances_data;
+				if (!CompressedData::decompress(to_span_const(raw.instances_data), tls_instances_data)) {
+					ERR_PRINT("Failed to decompress instance block");
+					return;
+				}
+				out_block.instances_data = make_unique_instance<InstanceBlockData>();
+				if (!deserialize_instance_block_data(*out_block.instances_data, to_span_const(tls_instances_data))) {
+					ERR_PRINT("Failed to deserialize instance block");
+					return;
+				}
+			}
+
+			out_valid = true;
+		}
+
+		void flush_chunk() {
+			if (chunk.size() == 0) {
+				return;
+			}
+			ZN_PROFILE_SCOPE_NAMED("Deserialize chunk");
+
+			static thread_local std::vector<FullLoadingResult::Block> tls_blocks;
+			static thread_local std::vector<uint8_t> tls_valid;
+			tls_blocks.clear();
+			tls_blocks.resize(chunk.size());
+			tls_valid.clear();
+			tls_valid.resize(chunk.size(), 0);
+
+			struct Job {
+				Span<const RawBlock> raw_blocks;
+				Span<FullLoadingResult::Block> out_blocks;
+				Span<uint8_t> out_valid;
+
+				static void run(void *p_userdata) {
+					Job &job = *static_cast<Job *>(p_userdata);
+					for (unsigned int i = 0; i < job.raw_blocks.size(); ++i) {
+						bool valid = false;
+						deserialize_raw_block(job.raw_blocks[i], job.out_blocks[i], valid);
+						job.out_valid[i] = valid;
+					}
+				}
+			};
+
+			const unsigned int thread_count =
+					math::clamp(unsigned(chunk.size() / 64), 1u, math::min(8u, Thread::get_hardware_concurrency()));
+
+			if (thread_count <= 1) {
+				Job job{ to_span_const(chunk), to_span(tls_blocks), to_span(tls_valid) };
+				Job::run(&job);
+
+			} else {
+				FixedArray<Job, 8> jobs;
+				for (unsigned int i = 0; i < thread_count; ++i) {
+					const unsigned int begin = (i * chunk.size()) / thread_count;
+					const unsigned int end = ((i + 1) * chunk.size()) / thread_count;
+					jobs[i].raw_blocks = to_span_const(chunk).sub(begin, end - begin);
+					jobs[i].out_blocks = to_span(tls_blocks).sub(begin, end - begin);
+					jobs[i].out_valid = to_span(tls_valid).sub(begin, end - begin);
+				}
+				FixedArray<Thread, 7> threads;
+				for (unsigned int i = 1; i < thread_count; ++i) {
+					threads[i - 1].start(&Job::run, &jobs[i]);
+				}
+				Job::run(&jobs[0]);
+				for (unsigned int i = 1; i < thread_count; ++i) {
+					threads[i - 1].wait_to_finish();
+				}
+			}
+
+			for (unsigned int i = 0; i < tls_blocks.size(); ++i) {
+				if (tls_valid[i] != 0) {
+					result.blocks.push_back(std::move(tls_blocks[i]));
+				}
+			}
+			tls_blocks.clear();
+			chunk.clear();
+		}
 	};
 
 	// Using local function instead of a lambda for quite stupid reason admittedly:
@@ -826,37 +1190,23 @@ void VoxelStreamSQLite::load_all_blocks(FullLoadingResult &result) {
 				return;
 			}
 
-			FullLoadingResult::Block result_block;
-			result_block.position = Vector3i(location.x, location.y, location.z);
-			result_block.lod = location.lod;
+			RawBlock raw;
+			raw.location = location;
+			raw.voxel_data.assign(voxel_data.data(), voxel_data.data() + voxel_data.size());
+			raw.instances_data.assign(instances_data.data(), instances_data.data() + instances_data.size());
+			ctx->chunk.push_back(std::move(raw));
 
-			if (voxel_data.size() > 0) {
-				std::shared_ptr<VoxelBufferInternal> voxels = make_shared_instance<VoxelBufferInternal>();
-				ERR_FAIL_COND(!BlockSerializer::decompress_and_deserialize(voxel_data, *voxels));
-				result_block.voxels = voxels;
+			if (ctx->chunk.size() >= Context::CHUNK_SIZE) {
+				ctx->flush_chunk();
 			}
-
-			if (instances_data.size() > 0) {
-				std::vector<uint8_t> &temp_block_data = ctx->stream._temp_block_data;
-				if (!CompressedData::decompress(instances_data, temp_block_data)) {
-					ERR_PRINT("Failed to decompress instance block");
-					return;
-				}
-				result_block.instances_data = make_unique_instance<InstanceBlockData>();
-				if (!deserialize_instance_block_data(*result_block.instances_data, to_span_const(temp_block_data))) {
-					ERR_PRINT("Failed to deserialize instance block");
-					return;
-				}
-			}
-
-			ctx->result.blocks.push_back(std::move(result_block));
 		}
 	};
 
 	// Had to suffix `_outer`,
 	// because otherwise GCC thinks it shadows a variable inside the local function/captureless lambda
-	Context ctx_outer{ *this, result };
+	Context ctx_outer{ {}, result };
 	const bool request_result = con->load_all_blocks(&ctx_outer, L::process_block_func);
+	ctx_outer.flush_chunk();
 	ERR_FAIL_COND(request_result == false);
 }
 
@@ -865,11 +1215,38 @@ int VoxelStreamSQLite::get_used_channels_mask() const {
 	return VoxelBufferInternal::ALL_CHANNELS_MASK;
 }
 
+// Decides if pending saves should be committed to the database now.
+// To be called after new blocks were put in the cache.
+bool VoxelStreamSQLite::should_flush_on_save() {
+	const unsigned int count = _cache.get_indicative_block_count();
+	if (count == 0) {
+		return false;
+	}
+	// Save-heavy sessions (creative servers) can grow the cache by gigabytes between count-based
+	// flushes; the byte cap bounds it regardless of entry count
+	if (_cache_memory_cap_bytes > 0 && _cache.get_memory_usage() > _cache_memory_cap_bytes) {
+		return true;
+	}
+	MutexLock lock(_save_batch_mutex);
+	if (count >= _save_batch_size) {
+		return true;
+	}
+	if (_save_flush_interval_usec > 0) {
+		const uint64_t now = Time::get_singleton()->get_ticks_usec();
+		if (_first_pending_save_time_usec == 0) {
+			_first_pending_save_time_usec = now;
+		} else if (now - _first_pending_save_time_usec >= _save_flush_interval_usec) {
+			return true;
+		}
+	}
+	return false;
+}
+
 void VoxelStreamSQLite::flush_cache() {
-	VoxelStreamSQLiteInternal *con = get_connection();
+	VoxelStreamSQLiteInternal *con = lock_write_connection();
 	ERR_FAIL_COND(con == nullptr);
 	flush_cache(con);
-	recycle_connection(con);
+	unlock_write_connection();
 }
 
 // This function does not lock any mutex for internal use.
@@ -877,52 +1254,133 @@ void VoxelStreamSQLite::flush_cache(VoxelStreamSQLiteInternal *con) {
 	ZN_PROFILE_SCOPE();
 	ZN_PRINT_VERBOSE(format("VoxelStreamSQLite: Flushing cache ({} elements)", _cache.get_indicative_block_count()));
 
+	{
+		MutexLock lock(_save_batch_mutex);
+		_first_pending_save_time_usec = 0;
+	}
+
 	ERR_FAIL_COND(con == nullptr);
-	ERR_FAIL_COND(con->begin_transaction() == false);
 
-	std::vector<uint8_t> &temp_data = _temp_block_data;
-	std::vector<uint8_t> &temp_compressed_data = _temp_compressed_block_data;
+	// Move blocks out of the cache first, so serialization doesn't have to hold it
+	std::vector<VoxelStreamCache::Block> blocks;
+	_cache.flush_to(blocks);
 
-	// TODO Needs better error rollback handling
-	_cache.flush([con, &temp_data, &temp_compressed_data](VoxelStreamCache::Block &block) {
-		ERR_FAIL_COND(!BlockLocation::validate(block.position, block.lod));
+	struct SerializedBlock {
+		BlockLocation location;
+		std::vector<uint8_t> voxel_data;
+		std::vector<uint8_t> instance_data;
+		bool save_voxels = false;
+		bool valid = false;
+	};
 
-		BlockLocation loc;
-		loc.x = block.position.x;
-		loc.y = block.position.y;
-		loc.z = block.position.z;
-		loc.lod = block.lod;
-
-		// Save voxels
-		if (block.has_voxels) {
-			if (block.voxels_deleted) {
-				const std::vector<uint8_t> empty;
-				con->save_block(loc, empty, VoxelStreamSQLiteInternal::VOXELS);
-			} else {
-				BlockSerializer::SerializeResult res = BlockSerializer::serialize_and_compress(block.voxels);
-				ERR_FAIL_COND(!res.success);
-				con->save_block(loc, res.data, VoxelStreamSQLiteInternal::VOXELS);
+	std::vector<SerializedBlock> serialized_blocks(blocks.size());
+
+	struct SerializeJob {
+		Span<const VoxelStreamCache::Block> blocks;
+		Span<SerializedBlock> out_blocks;
+		bool archive_compression;
+
+		static void run(void *p_userdata) {
+			SerializeJob &job = *static_cast<SerializeJob *>(p_userdata);
+			for (unsigned int i = 0; i < job.blocks.size(); ++i) {
+				const VoxelStreamCache::Block &block = job.blocks[i];
+				SerializedBlock &out_block = job.out_blocks[i];
+
+				ERR_CONTINUE(!BlockLocation::validate(block.position, block.lod));
+				out_block.location.x = block.position.x;
+				out_block.location.y = block.position.y;
+				out_block.location.z = block.position.z;
+				out_block.location.lod = block.lod;
+
+				if (block.has_voxels) {
+					out_block.save_voxels = true;
+					// When voxels were deleted, the data stays empty
+					if (!block.voxels_deleted) {
+						if (block.is_delta && block.delta_boxes.size() > 0) {
+							// Only the edited regions get stored, loading regenerates the rest
+							BlockSerializer::SerializeResult res = BlockSerializer::serialize_and_compress_delta(
+									block.voxels, to_span_const(block.delta_boxes));
+							ERR_CONTINUE(!res.success);
+							out_block.voxel_data = res.data;
+						} else {
+							BlockSerializer::SerializeResult res =
+									BlockSerializer::serialize_and_compress(block.voxels, job.archive_compression);
+							ERR_CONTINUE(!res.success);
+							// The serializer's buffer is thread-local, it has to be copied
+							out_block.voxel_data = res.data;
+						}
+					}
+				}
+
+				if (block.instances != nullptr) {
+					static thread_local std::vector<uint8_t> tls_instance_data;
+					tls_instance_data.clear();
+					ERR_CONTINUE(!serialize_instance_block_data(*block.instances, tls_instance_data));
+					ERR_CONTINUE(!CompressedData::compress(to_span_const(tls_instance_data),
+							out_block.instance_data, CompressedData::COMPRESSION_NONE));
+				}
+
+				out_block.valid = true;
 			}
 		}
+	};
 
-		// Save instances
-		temp_compressed_data.clear();
-		if (block.instances != nullptr) {
-			temp_data.clear();
+	const bool archive_compression = is_archive_compression_enabled();
 
-			ERR_FAIL_COND(!serialize_instance_block_data(*block.instances, temp_data));
+	// Serialization is CPU-bound LZ4 work and blocks are independent of each other, so large
+	// flushes (notably the final save of a session) fan it out over temporary threads, in the same
+	// spirit as the sliding-box unload in VoxelLodTerrainUpdateTask. Writing stays on this thread.
+	const unsigned int MIN_BLOCKS_PER_THREAD = 32;
+	const unsigned int max_thread_count = math::min(8u, Thread::get_hardware_concurrency());
+	const unsigned int thread_count = math::clamp( //
+			unsigned(blocks.size() / MIN_BLOCKS_PER_THREAD), 1u, max_thread_count);
 
-			ERR_FAIL_COND(!CompressedData::compress(
-					to_span_const(temp_data), temp_compressed_data, CompressedData::COMPRESSION_NONE));
+	if (thread_count <= 1) {
+		SerializeJob job{ to_span_const(blocks), to_span(serialized_blocks), archive_compression };
+		SerializeJob::run(&job);
+
+	} else {
+		std::vector<SerializeJob> jobs(thread_count);
+		for (unsigned int i = 0; i < thread_count; ++i) {
+			const unsigned int begin = (i * blocks.size()) / thread_count;
+			const unsigned int end = ((i + 1) * blocks.size()) / thread_count;
+			jobs[i].blocks = to_span_const(blocks).sub(begin, end - begin);
+			jobs[i].out_blocks = to_span(serialized_blocks).sub(begin, end - begin);
+			jobs[i].archive_compression = archive_compression;
+		}
+		std::vector<Thread> threads(thread_count - 1);
+		for (unsigned int i = 1; i < thread_count; ++i) {
+			threads[i - 1].start(&SerializeJob::run, &jobs[i]);
 		}
-		con->save_block(loc, temp_compressed_data, VoxelStreamSQLiteInternal::INSTANCES);
+		SerializeJob::run(&jobs[0]);
+		for (unsigned int i = 0; i < threads.size(); ++i) {
+			threads[i].wait_to_finish();
+		}
+	}
+
+	// TODO Needs better error rollback handling
+	ERR_FAIL_COND(con->begin_transaction() == false);
 
+	for (unsigned int i = 0; i < serialized_blocks.size(); ++i) {
+		const SerializedBlock &out_block = serialized_blocks[i];
+		if (!out_block.valid) {
+			// Already printed an error while serializing
+			continue;
+		}
+		if (out_block.save_voxels) {
+			con->save_block(out_block.location, out_block.voxel_data, VoxelStreamSQLiteInternal::VOXELS);
+		}
+		con->save_block(out_block.location, out_block.instance_data, VoxelStreamSQLiteInternal::INSTANCES);
 		// TODO Optimization: add a version of the query that can update both at once
-	});
+	}
 
 	ERR_FAIL_COND(con->end_transaction() == false);
 }
 
+void VoxelStreamSQLite::flush() {
+	flush_cache();
+}
+
 VoxelStreamSQLiteInternal *VoxelStreamSQLite::get_connection() {
 	_connection_mutex.lock();
 	if (_connection_path.is_empty()) {
@@ -941,15 +1399,53 @@ VoxelStreamSQLiteInternal *VoxelStreamSQLite::get_connection() {
 	if (fpath.is_empty()) {
 		return nullptr;
 	}
+
+	// Make sure the writer exists first: it creates the database file, the schema and the WAL
+	// journaling mode that read-only connections inherit
+	{
+		VoxelStreamSQLiteInternal *wcon = lock_write_connection();
+		if (wcon == nullptr) {
+			return nullptr;
+		}
+		unlock_write_connection();
+	}
+
 	VoxelStreamSQLiteInternal *con = new VoxelStreamSQLiteInternal();
 	CharString fpath_utf8 = fpath.utf8();
-	if (!con->open(fpath_utf8)) {
+	if (!con->open(fpath_utf8, true)) {
 		delete con;
 		con = nullptr;
 	}
 	return con;
 }
 
+VoxelStreamSQLiteInternal *VoxelStreamSQLite::lock_write_connection() {
+	_write_connection_mutex.lock();
+	if (_write_connection == nullptr) {
+		_connection_mutex.lock();
+		const String fpath = _connection_path;
+		_connection_mutex.unlock();
+		if (fpath.is_empty()) {
+			_write_connection_mutex.unlock();
+			return nullptr;
+		}
+		VoxelStreamSQLiteInternal *con = new VoxelStreamSQLiteInternal();
+		CharString fpath_utf8 = fpath.utf8();
+		if (!con->open(fpath_utf8)) {
+			delete con;
+			_write_connection_mutex.unlock();
+			return nullptr;
+		}
+		_write_connection = con;
+	}
+	// The mutex stays held, serializing writers while readers keep going
+	return _write_connection;
+}
+
+void VoxelStreamSQLite::unlock_write_connection() {
+	_write_connection_mutex.unlock();
+}
+
 void VoxelStreamSQLite::recycle_connection(VoxelStreamSQLiteInternal *con) {
 	String con_path = con->get_opened_file_path();
 	_connection_mutex.lock();
@@ -963,12 +1459,66 @@ void VoxelStreamSQLite::recycle_connection(VoxelStreamSQLiteInternal *con) {
 	}
 }
 
+void VoxelStreamSQLite::set_prefetching_enabled(bool enabled) {
+	_prefetching_enabled = enabled;
+	if (!enabled) {
+		_prefetch_cache.flush([](VoxelStreamCache::Block &block) {});
+		MutexLock lock(_prefetch_mutex);
+		_has_last_load_centroid = false;
+	}
+}
+
+bool VoxelStreamSQLite::is_prefetching_enabled() const {
+	return _prefetching_enabled;
+}
+
+void VoxelStreamSQLite::set_save_batch_size(int size) {
+	ERR_FAIL_COND(size < 1);
+	MutexLock lock(_save_batch_mutex);
+	_save_batch_size = size;
+}
+
+int VoxelStreamSQLite::get_save_batch_size() const {
+	MutexLock lock(_save_batch_mutex);
+	return _save_batch_size;
+}
+
+void VoxelStreamSQLite::set_save_flush_interval_seconds(float seconds) {
+	ERR_FAIL_COND(seconds < 0.f);
+	MutexLock lock(_save_batch_mutex);
+	_save_flush_interval_usec = uint64_t(seconds * 1000000.0);
+}
+
+float VoxelStreamSQLite::get_save_flush_interval_seconds() const {
+	MutexLock lock(_save_batch_mutex);
+	return float(_save_flush_interval_usec / 1000000.0);
+}
+
 void VoxelStreamSQLite::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_database_path", "path"), &VoxelStreamSQLite::set_database_path);
+	ClassDB::bind_method(
+			D_METHOD("set_cache_memory_cap_mb", "mb"), &VoxelStreamSQLite::set_cache_memory_cap_mb);
+	ClassDB::bind_method(D_METHOD("get_cache_memory_cap_mb"), &VoxelStreamSQLite::get_cache_memory_cap_mb);
+	ClassDB::bind_method(D_METHOD("get_cache_statistics"), &VoxelStreamSQLite::get_cache_statistics);
 	ClassDB::bind_method(D_METHOD("get_database_path"), &VoxelStreamSQLite::get_database_path);
+	ClassDB::bind_method(D_METHOD("set_prefetching_enabled", "enabled"), &VoxelStreamSQLite::set_prefetching_enabled);
+	ClassDB::bind_method(D_METHOD("is_prefetching_enabled"), &VoxelStreamSQLite::is_prefetching_enabled);
+	ClassDB::bind_method(D_METHOD("set_save_batch_size", "size"), &VoxelStreamSQLite::set_save_batch_size);
+	ClassDB::bind_method(D_METHOD("get_save_batch_size"), &VoxelStreamSQLite::get_save_batch_size);
+	ClassDB::bind_method(D_METHOD("set_save_flush_interval_seconds", "seconds"),
+			&VoxelStreamSQLite::set_save_flush_interval_seconds);
+	ClassDB::bind_method(
+			D_METHOD("get_save_flush_interval_seconds"), &VoxelStreamSQLite::get_save_flush_interval_seconds);
 
 	ADD_PROPERTY(PropertyInfo(Variant::STRING, "database_path", PROPERTY_HINT_FILE), "set_database_path",
 			"get_database_path");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "cache_memory_cap_mb"), "set_cache_memory_cap_mb",
+			"get_cache_memory_cap_mb");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "prefetching_enabled"), "set_prefetching_enabled",
+			"is_prefetching_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "save_batch_size"), "set_save_batch_size", "get_save_batch_size");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "save_flush_interval_seconds"), "set_save_flush_interval_seconds",
+			"get_save_flush_interval_seconds");
 }
 
 } // namespace zylann::voxel
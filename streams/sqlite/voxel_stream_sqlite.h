@@ -29,18 +29,57 @@ public:
 	void load_voxel_blocks(Span<VoxelStream::VoxelQueryData> p_blocks) override;
 	void save_voxel_blocks(Span<VoxelStream::VoxelQueryData> p_blocks) override;
 
+	bool erase_blocks_in_box(Vector3i min_block_pos, Vector3i max_block_pos, uint8_t lod) override;
+
+	// Memory cap for the pending-save cache: crossing it forces a flush on the next save, since
+	// every cached block is a pending write and can only be evicted by writing it out.
+	// 0 disables the cap.
+	void set_cache_memory_cap_mb(int mb);
+	int get_cache_memory_cap_mb() const;
+
+	// Occupancy and hit rate of the pending-save cache
+	Dictionary get_cache_statistics() const;
+
 	bool supports_instance_blocks() const override;
 	void load_instance_blocks(Span<VoxelStream::InstancesQueryData> out_blocks) override;
 	void save_instance_blocks(Span<VoxelStream::InstancesQueryData> p_blocks) override;
 
-	bool supports_loading_all_blocks() const override {
+	bool supports_delta_saves() const override {
 		return true;
 	}
+	void save_voxel_block_delta(VoxelStream::VoxelQueryData &query, Span<const Box3i> dirty_boxes) override;
+
+	bool supports_loading_all_blocks() const override {
+		// Delta blobs need a generator to reconstruct, which bulk loading doesn't have; volumes
+		// then fall back to per-block streaming (and full load mode refuses the stream)
+		return !is_delta_saves_enabled();
+	}
 	void load_all_blocks(FullLoadingResult &result) override;
 
 	int get_used_channels_mask() const override;
 
 	void flush_cache();
+	// `VoxelStream` API, flushes the save cache
+	void flush() override;
+
+	// When enabled, the stream watches how the centroid of load requests moves between calls, and
+	// speculatively SELECTs the same set of blocks shifted one step ahead in that direction, within the
+	// same transaction. Predictable movement then turns future load tasks into cache hits.
+	// Prefetched blocks live in a separate read-only cache so they are never flushed back to the database.
+	void set_prefetching_enabled(bool enabled);
+	bool is_prefetching_enabled() const;
+
+	// Saves are coalesced in the cache and committed in a single transaction once this many blocks
+	// are pending. Higher values amortize transaction and fsync overhead when lots of blocks are
+	// saved in a burst (like a player quitting), at the cost of holding more unsaved data in memory.
+	void set_save_batch_size(int size);
+	int get_save_batch_size() const;
+
+	// Maximum time pending saves can wait before an incoming save forces a flush, even if the batch
+	// isn't full. 0 disables time-based flushing (blocks then wait until the batch fills up or the
+	// game flushes explicitly).
+	void set_save_flush_interval_seconds(float seconds);
+	float get_save_flush_interval_seconds() const;
 
 private:
 	// An SQlite3 database is safe to use with multiple threads in serialized mode,
@@ -57,16 +96,47 @@ private:
 	// Because of this, in our use case, it might be simpler to just leave SQLite in thread-safe mode,
 	// and synchronize ourselves.
 
+	// Gets a pooled read-only connection. With WAL journaling these run in parallel with each
+	// other and with the writer.
 	VoxelStreamSQLiteInternal *get_connection();
 	void recycle_connection(VoxelStreamSQLiteInternal *con);
+	// Gets the unique writer connection and keeps it locked; `unlock_write_connection` must be
+	// called when done with it. Returns null (already unlocked) when no database is set or it
+	// can't be opened.
+	VoxelStreamSQLiteInternal *lock_write_connection();
+	void unlock_write_connection();
 	void flush_cache(VoxelStreamSQLiteInternal *con);
+	bool should_flush_on_save();
 
 	static void _bind_methods();
 
 	String _connection_path;
+	// Read-only connections, used in parallel by loading tasks
 	std::vector<VoxelStreamSQLiteInternal *> _connection_pool;
 	Mutex _connection_mutex;
+	// SQLite allows a single writer at a time, so there is one write connection and its users
+	// serialize on this mutex while readers keep going.
+	// Lock order: `_write_connection_mutex` is always taken before `_connection_mutex`.
+	VoxelStreamSQLiteInternal *_write_connection = nullptr;
+	Mutex _write_connection_mutex;
 	VoxelStreamCache _cache;
+	// See `set_cache_memory_cap_mb`
+	uint64_t _cache_memory_cap_bytes = 256 * 1024 * 1024;
+
+	// Read-ahead state. The prefetch cache is only ever filled from database reads, never flushed back.
+	static const unsigned int PREFETCH_CACHE_SIZE = 256;
+	VoxelStreamCache _prefetch_cache;
+	bool _prefetching_enabled = false;
+	bool _has_last_load_centroid = false;
+	Vector3 _last_load_centroid;
+	Mutex _prefetch_mutex;
+
+	// Write-coalescing settings. The timestamp tracks the oldest block waiting in the cache,
+	// 0 when there is none.
+	unsigned int _save_batch_size = CACHE_SIZE;
+	uint64_t _save_flush_interval_usec = 0;
+	uint64_t _first_pending_save_time_usec = 0;
+	Mutex _save_batch_mutex;
 
 	// TODO I should consider specialized memory allocators
 	static thread_local std::vector<uint8_t> _temp_block_data;
@@ -185,6 +185,7 @@ void Data::clear() {
 	_layers.clear();
 	_materials.clear();
 	_root_node_id = -1;
+	_fpath = String();
 }
 
 Error Data::load_from_file(String fpath) {
@@ -243,23 +244,21 @@ Error Data::_load_from_file(String fpath) {
 
 		} else if (strcmp(chunk_id, "XYZI") == 0) {
 			UniquePtr<Model> model = make_unique_instance<Model>();
-			model->color_indexes.resize(last_size.x * last_size.y * last_size.z, 0);
 			model->size = last_size;
+			model->file_offset = f.get_position();
 
 			const uint32_t num_voxels = f.get_32();
-
-			for (uint32_t i = 0; i < num_voxels; ++i) {
-				Vector3i pos;
-				pos.x = f.get_8();
-				pos.y = f.get_8();
-				pos.z = f.get_8();
-				const uint32_t c = f.get_8();
-				pos = magica_to_opengl(pos);
-				ERR_FAIL_COND_V(pos.x >= model->size.x || pos.x < 0, ERR_PARSE_ERROR);
-				ERR_FAIL_COND_V(pos.y >= model->size.y || pos.y < 0, ERR_PARSE_ERROR);
-				ERR_FAIL_COND_V(pos.z >= model->size.z || pos.z < 0, ERR_PARSE_ERROR);
-				model->color_indexes[Vector3iUtil::get_zxy_index(pos, model->size)] = c;
-			}
+			// The payload must be exactly one count plus 4 bytes per voxel; validating it here
+			// means `load_model_voxels` can trust the recorded location later
+			ERR_FAIL_COND_V(chunk_size != 4 + 4 * num_voxels, ERR_PARSE_ERROR);
+			// Also bounds the read buffer used when decoding (a valid file has at most one voxel
+			// per cell, and sizes are capped at 256)
+			ERR_FAIL_COND_V(int64_t(num_voxels) > Vector3iUtil::get_volume(model->size), ERR_INVALID_DATA);
+			model->num_voxels = num_voxels;
+
+			// Voxels are decoded on demand in `load_model_voxels`, one model at a time, so import
+			// memory doesn't scale with the number of models in the scene
+			f.seek(model->file_offset + chunk_size);
 
 			_models.push_back(std::move(model));
 
@@ -552,11 +551,51 @@ Error Data::_load_from_file(String fpath) {
 		ERR_FAIL_COND_V_MSG(_root_node_id == -1, ERR_INVALID_DATA, "Root node not found");
 	}
 
+	_fpath = fpath;
+
 	ZN_PRINT_VERBOSE(format("Done loading {}", fpath));
 
 	return OK;
 }
 
+Error Data::load_model_voxels(unsigned int model_index, std::vector<uint8_t> &out_color_indexes) const {
+	ZN_PROFILE_SCOPE();
+	ERR_FAIL_COND_V(model_index >= _models.size(), ERR_INVALID_PARAMETER);
+	const Model &model = get_model(model_index);
+
+	Error open_err;
+	Ref<FileAccess> f_ref = FileAccess::open(_fpath, FileAccess::READ, &open_err);
+	if (f_ref == nullptr) {
+		return open_err;
+	}
+	FileAccess &f = **f_ref;
+	f.seek(model.file_offset);
+
+	const uint32_t num_voxels = f.get_32();
+	ERR_FAIL_COND_V(num_voxels != model.num_voxels, ERR_PARSE_ERROR);
+
+	// One sequential read of the payload, then decode from memory
+	static thread_local std::vector<uint8_t> tls_chunk;
+	tls_chunk.resize(size_t(num_voxels) * 4);
+	ERR_FAIL_COND_V(f.get_buffer(tls_chunk.data(), tls_chunk.size()) != tls_chunk.size(), ERR_PARSE_ERROR);
+
+	out_color_indexes.clear();
+	out_color_indexes.resize(Vector3iUtil::get_volume(model.size), 0);
+
+	for (uint32_t i = 0; i < num_voxels; ++i) {
+		const uint8_t *v = tls_chunk.data() + size_t(i) * 4;
+		Vector3i pos(v[0], v[1], v[2]);
+		const uint32_t c = v[3];
+		pos = magica_to_opengl(pos);
+		ERR_FAIL_COND_V(pos.x >= model.size.x || pos.x < 0, ERR_PARSE_ERROR);
+		ERR_FAIL_COND_V(pos.y >= model.size.y || pos.y < 0, ERR_PARSE_ERROR);
+		ERR_FAIL_COND_V(pos.z >= model.size.z || pos.z < 0, ERR_PARSE_ERROR);
+		out_color_indexes[Vector3iUtil::get_zxy_index(pos, model.size)] = c;
+	}
+
+	return OK;
+}
+
 unsigned int Data::get_model_count() const {
 	return _models.size();
 }
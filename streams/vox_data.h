@@ -24,10 +24,11 @@ namespace zylann::voxel::magica {
 
 struct Model {
 	Vector3i size;
-	// TODO Optimization: implement lazy loading/streaming to reduce intermediary memory allocations?
-	// Loading a full 256^3 model needs 16 megabytes, but a lot of areas might actually be uniform,
-	// and we might not need the actual model immediately
-	std::vector<uint8_t> color_indexes;
+	// Voxels are not materialized up-front: a full 256^3 model needs 16 megabytes and huge scenes
+	// are made of hundreds of models, which used to spike imports to gigabytes. Only the location
+	// of the XYZI payload is recorded, and `Data::load_model_voxels` decodes one model at a time.
+	uint64_t file_offset = 0;
+	uint32_t num_voxels = 0;
 };
 
 struct Node {
@@ -111,6 +112,12 @@ public:
 	unsigned int get_model_count() const;
 	const Model &get_model(unsigned int index) const;
 
+	// Decodes the voxels of one model into `out_color_indexes` (ZXY order, 0 = empty), resized to
+	// the model's volume. Works from the file, so the working set stays bounded by the largest
+	// model instead of the whole scene; each call opens its own read handle, so distinct models
+	// may be converted from multiple threads.
+	Error load_model_voxels(unsigned int model_index, std::vector<uint8_t> &out_color_indexes) const;
+
 	// Can return -1 if there is no scene graph
 	int get_root_node_id() const;
 	const Node *get_node(int id) const;
@@ -135,6 +142,8 @@ private:
 	std::unordered_map<int, UniquePtr<Material>> _materials;
 	int _root_node_id = -1;
 	FixedArray<Color8, 256> _palette;
+	// Path models are lazily read from, valid after a successful `load_from_file`
+	String _fpath;
 };
 
 } // namespace zylann::voxel::magica
@@ -13,8 +13,13 @@ Error VoxelVoxLoader::load_from_file(String fpath, Ref<gd::VoxelBuffer> p_voxels
 	Error load_err = data.load_from_file(fpath);
 	ERR_FAIL_COND_V(load_err != OK, load_err);
 
+	ERR_FAIL_COND_V(data.get_model_count() == 0, ERR_PARSE_ERROR);
 	const zylann::voxel::magica::Model &model = data.get_model(0);
 
+	std::vector<uint8_t> color_indexes;
+	const Error voxels_err = data.load_model_voxels(0, color_indexes);
+	ERR_FAIL_COND_V(voxels_err != OK, voxels_err);
+
 	const VoxelBufferInternal::ChannelId channel = VoxelBufferInternal::CHANNEL_COLOR;
 	Span<const Color8> src_palette = to_span_const(data.get_palette());
 	const VoxelBufferInternal::Depth depth = voxels.get_channel_depth(VoxelBufferInternal::CHANNEL_COLOR);
@@ -31,13 +36,13 @@ Error VoxelVoxLoader::load_from_file(String fpath, Ref<gd::VoxelBuffer> p_voxels
 
 		switch (depth) {
 			case VoxelBufferInternal::DEPTH_8_BIT: {
-				memcpy(dst_raw.data(), model.color_indexes.data(), model.color_indexes.size());
+				memcpy(dst_raw.data(), color_indexes.data(), color_indexes.size());
 			} break;
 
 			case VoxelBufferInternal::DEPTH_16_BIT: {
 				Span<uint16_t> dst = dst_raw.reinterpret_cast_to<uint16_t>();
 				for (size_t i = 0; i < dst.size(); ++i) {
-					dst[i] = model.color_indexes[i];
+					dst[i] = color_indexes[i];
 				}
 			} break;
 
@@ -50,7 +55,7 @@ Error VoxelVoxLoader::load_from_file(String fpath, Ref<gd::VoxelBuffer> p_voxels
 		switch (depth) {
 			case VoxelBufferInternal::DEPTH_8_BIT: {
 				for (size_t i = 0; i < dst_raw.size(); ++i) {
-					const uint8_t ci = model.color_indexes[i];
+					const uint8_t ci = color_indexes[i];
 					dst_raw[i] = src_palette[ci].to_u8();
 				}
 			} break;
@@ -58,7 +63,7 @@ Error VoxelVoxLoader::load_from_file(String fpath, Ref<gd::VoxelBuffer> p_voxels
 			case VoxelBufferInternal::DEPTH_16_BIT: {
 				Span<uint16_t> dst = dst_raw.reinterpret_cast_to<uint16_t>();
 				for (size_t i = 0; i < dst.size(); ++i) {
-					const uint8_t ci = model.color_indexes[i];
+					const uint8_t ci = color_indexes[i];
 					dst[i] = src_palette[ci].to_u16();
 				}
 			} break;
@@ -1,4 +1,5 @@
 #include "voxel_block_serializer.h"
+#include "../util/lightweight_profiler.h"
 #include "../storage/voxel_buffer_internal.h"
 #include "../storage/voxel_memory_pool.h"
 #include "../util/macros.h"
@@ -27,6 +28,10 @@ const unsigned int BLOCK_METADATA_HEADER_SIZE = sizeof(uint32_t);
 thread_local std::vector<uint8_t> tls_data;
 thread_local std::vector<uint8_t> tls_compressed_data;
 thread_local std::vector<uint8_t> tls_metadata_tmp;
+// Holds the metadata section built during size calculation, so each entry (and each Variant
+// encode) happens exactly once per save. See `build_metadata_blob`.
+thread_local std::vector<uint8_t> tls_metadata_blob;
+thread_local std::vector<uint8_t> tls_linear_channel_tmp;
 
 std::vector<uint8_t> &get_tls_data() {
 	return tls_data;
@@ -36,32 +41,78 @@ std::vector<uint8_t> &get_tls_compressed_data() {
 	return tls_compressed_data;
 }
 
-size_t get_metadata_size_in_bytes(const VoxelMetadata &meta) {
-	size_t size = 1; // Type
-	switch (meta.get_type()) {
+// Serializer-private pseudo-type, stored in place of an entry whose value is identical to an
+// earlier voxel entry of the same block. Sits in the reserved gap below TYPE_CUSTOM_BEGIN so it
+// can never collide with a runtime metadata type. Machines-and-wires games repeat the same value
+// on thousands of voxels; references make those entries 5 bytes instead of a full Variant encode.
+static const uint8_t METADATA_TYPE_SERIALIZED_REFERENCE = 31;
+static_assert(METADATA_TYPE_SERIALIZED_REFERENCE < VoxelMetadata::TYPE_CUSTOM_BEGIN,
+		"Reference marker must not collide with custom types");
+
+// Appends one metadata value to the blob. Returns false on unrecoverable encoding errors.
+static bool append_metadata_to_blob(const VoxelMetadata &meta, std::vector<uint8_t> &blob) {
+	MemoryWriter mw(blob, ENDIANESS_LITTLE_ENDIAN);
+	const uint8_t type = meta.get_type();
+	switch (type) {
 		case VoxelMetadata::TYPE_EMPTY:
-			break;
+			mw.store_8(type);
+			return true;
+
 		case VoxelMetadata::TYPE_U64:
-			size += sizeof(uint64_t);
-			break;
+			mw.store_8(type);
+			mw.store_64(meta.get_u64());
+			return true;
+
 		default:
-			if (meta.get_type() >= VoxelMetadata::TYPE_CUSTOM_BEGIN) {
+			if (type >= VoxelMetadata::TYPE_CUSTOM_BEGIN) {
 				const ICustomVoxelMetadata &custom = meta.get_custom();
-				size += custom.get_serialized_size();
-			} else {
-				ZN_PRINT_ERROR("Unknown metadata type");
-				return 0;
+				const size_t custom_size = custom.get_serialized_size();
+				mw.store_8(type);
+				const size_t pos = blob.size();
+				blob.resize(pos + custom_size);
+				const size_t written_size = custom.serialize(to_span(blob).sub(pos));
+				ZN_ASSERT_RETURN_V(written_size <= custom_size, false);
+				blob.resize(pos + written_size);
+				return true;
 			}
+			ZN_PRINT_ERROR("Unknown metadata type");
+			return false;
 	}
-	return size;
 }
 
-size_t get_metadata_size_in_bytes(const VoxelBufferInternal &buffer) {
-	size_t size = 0;
+// Builds the whole metadata section in one pass into `tls_metadata_blob` and returns its size
+// (0 means no metadata, and nothing gets serialized, like before metadata existed).
+// Voxel entries holding a Variant equal to an earlier entry are stored as references to that
+// entry's index, so repeated machine/wire values cost a few bytes instead of a fresh encode.
+size_t build_metadata_blob(const VoxelBufferInternal &buffer) {
+	std::vector<uint8_t> &blob = tls_metadata_blob;
+	blob.clear();
 
 	const FlatMapMoveOnly<Vector3i, VoxelMetadata> &voxel_metadata = buffer.get_voxel_metadata();
+	const VoxelMetadata &block_meta = buffer.get_block_metadata();
+
+	if (voxel_metadata.size() == 0 && block_meta.get_type() == VoxelMetadata::TYPE_EMPTY) {
+		return 0;
+	}
+
+	if (!append_metadata_to_blob(block_meta, blob)) {
+		blob.clear();
+		return 0;
+	}
+
+	// Previously written distinct Variant entries, candidates for referencing
+	struct DedupEntry {
+		uint32_t voxel_entry_index;
+		uint32_t hash;
+		const Variant *variant;
+	};
+	static thread_local std::vector<DedupEntry> tls_dedup;
+	tls_dedup.clear();
+
+	uint32_t voxel_entry_index = 0;
+
 	for (FlatMapMoveOnly<Vector3i, VoxelMetadata>::ConstIterator it = voxel_metadata.begin();
-			it != voxel_metadata.end(); ++it) {
+			it != voxel_metadata.end(); ++it, ++voxel_entry_index) {
 		const Vector3i pos = it->key;
 
 		ERR_FAIL_COND_V_MSG(pos.x < 0 || static_cast<uint32_t>(pos.x) >= VoxelBufferInternal::MAX_SIZE, 0,
@@ -71,81 +122,47 @@ size_t get_metadata_size_in_bytes(const VoxelBufferInternal &buffer) {
 		ERR_FAIL_COND_V_MSG(pos.z < 0 || static_cast<uint32_t>(pos.z) >= VoxelBufferInternal::MAX_SIZE, 0,
 				"Invalid voxel metadata Z position");
 
-		size += 3 * sizeof(uint16_t); // Positions are stored as 3 unsigned shorts
-		size += get_metadata_size_in_bytes(it->value);
-	}
-
-	// If no metadata is found at all, nothing is serialized, not even null.
-	// It spares 24 bytes (40 if real_t == double),
-	// and is backward compatible with saves made before introduction of metadata.
-
-	const VoxelMetadata &block_meta = buffer.get_block_metadata();
-
-	if (size != 0 || block_meta.get_type() != VoxelMetadata::TYPE_EMPTY) {
-		size += get_metadata_size_in_bytes(block_meta);
-	}
-
-	return size;
-}
-
-template <typename T>
-inline void write(uint8_t *&dst, T d) {
-	*(T *)dst = d;
-	dst += sizeof(T);
-}
+		// Serializing key as ushort because it's more than enough for a 3D dense array
+		static_assert(VoxelBufferInternal::MAX_SIZE <= std::numeric_limits<uint16_t>::max(),
+				"Maximum size exceeds serialization support");
+		{
+			MemoryWriter mw(blob, ENDIANESS_LITTLE_ENDIAN);
+			mw.store_16(pos.x);
+			mw.store_16(pos.y);
+			mw.store_16(pos.z);
+		}
 
-template <typename T>
-inline T read(uint8_t *&src) {
-	T d = *(T *)src;
-	src += sizeof(T);
-	return d;
-}
+		if (int(it->value.get_type()) == gd::METADATA_TYPE_VARIANT) {
+			const Variant &v = static_cast<const gd::VoxelMetadataVariant &>(it->value.get_custom()).data;
+			const uint32_t hash = v.hash();
 
-static void serialize_metadata(const VoxelMetadata &meta, MemoryWriterExistingBuffer &mw) {
-	const uint8_t type = meta.get_type();
-	switch (type) {
-		case VoxelMetadata::TYPE_EMPTY:
-			mw.store_8(type);
-			break;
-		case VoxelMetadata::TYPE_U64:
-			mw.store_8(type);
-			mw.store_64(meta.get_u64());
-			break;
-		default:
-			if (type >= VoxelMetadata::TYPE_CUSTOM_BEGIN) {
-				mw.store_8(type);
-				const size_t written_size = meta.get_custom().serialize(mw.data.data.sub(mw.data.pos));
-				ZN_ASSERT(mw.data.pos + written_size <= mw.data.data.size());
-				mw.data.pos += written_size;
-			} else {
-				ZN_PRINT_ERROR("Unknown metadata type");
-				mw.store_8(VoxelMetadata::TYPE_EMPTY);
+			const DedupEntry *found = nullptr;
+			for (unsigned int i = 0; i < tls_dedup.size(); ++i) {
+				const DedupEntry &e = tls_dedup[i];
+				if (e.hash == hash && e.variant->hash_compare(v)) {
+					found = &e;
+					break;
+				}
 			}
-			break;
-	}
-}
-
-// The target buffer MUST have correct size. Recoverable errors must have been checked before.
-void serialize_metadata(Span<uint8_t> p_dst, const VoxelBufferInternal &buffer) {
-	ByteSpanWithPosition bs(p_dst, 0);
-	MemoryWriterExistingBuffer mw(bs, ENDIANESS_LITTLE_ENDIAN);
 
-	const VoxelMetadata &block_meta = buffer.get_block_metadata();
-	serialize_metadata(block_meta, mw);
+			if (found != nullptr) {
+				MemoryWriter mw(blob, ENDIANESS_LITTLE_ENDIAN);
+				mw.store_8(METADATA_TYPE_SERIALIZED_REFERENCE);
+				mw.store_32(found->voxel_entry_index);
+				continue;
+			}
 
-	const FlatMapMoveOnly<Vector3i, VoxelMetadata> &voxel_metadata = buffer.get_voxel_metadata();
-	for (FlatMapMoveOnly<Vector3i, VoxelMetadata>::ConstIterator it = voxel_metadata.begin();
-			it != voxel_metadata.end(); ++it) {
-		// Serializing key as ushort because it's more than enough for a 3D dense array
-		static_assert(VoxelBufferInternal::MAX_SIZE <= std::numeric_limits<uint16_t>::max(),
-				"Maximum size exceeds serialization support");
-		const Vector3i pos = it->key;
-		mw.store_16(pos.x);
-		mw.store_16(pos.y);
-		mw.store_16(pos.z);
+			// The pointed Variant lives in the buffer's metadata storage, stable while serializing
+			tls_dedup.push_back(DedupEntry{ voxel_entry_index, hash, &v });
+		}
 
-		serialize_metadata(it->value, mw);
+		if (!append_metadata_to_blob(it->value, blob)) {
+			blob.clear();
+			return 0;
+		}
 	}
+
+	return blob.size();
 }
 
 template <typename T>
@@ -218,6 +235,19 @@ bool deserialize_metadata(Span<const uint8_t> p_src, VoxelBufferInternal &buffer
 		tls_pairs.resize(tls_pairs.size() + 1);
 		Pair &p = tls_pairs.back();
 		p.key = pos;
+
+		// Peek: references to an earlier entry are resolved here, regular values go through the
+		// usual path (which reads the type byte itself)
+		ZN_ASSERT_RETURN_V(mr.pos < mr.data.size(), false);
+		if (mr.data[mr.pos] == METADATA_TYPE_SERIALIZED_REFERENCE) {
+			mr.pos += 1;
+			const uint32_t ref_index = mr.get_32();
+			ZN_ASSERT_RETURN_V_MSG(ref_index + 1 < tls_pairs.size(), false,
+					format("Invalid metadata reference in voxel metadata {}", pos));
+			p.value.copy_from(tls_pairs[ref_index].value);
+			continue;
+		}
+
 		ZN_ASSERT_RETURN_V_MSG(
 				deserialize_metadata(p.value, mr), false, format("Failed to deserialize voxel metadata {}", pos));
 	}
@@ -242,10 +272,19 @@ size_t get_size_in_bytes(const VoxelBufferInternal &buffer, size_t &metadata_siz
 		size += 1;
 
 		switch (compression) {
-			case VoxelBufferInternal::COMPRESSION_NONE: {
+			case VoxelBufferInternal::COMPRESSION_NONE:
+			// Tiled channels are stored dense in files
+			case VoxelBufferInternal::COMPRESSION_TILED: {
 				size += VoxelBufferInternal::get_size_in_bytes_for_volume(size_in_voxels, depth);
 			} break;
 
+			case VoxelBufferInternal::COMPRESSION_PALETTED: {
+				Span<const uint8_t> indices;
+				Span<const uint64_t> palette;
+				ERR_FAIL_COND_V(!buffer.get_channel_paletted_view(channel_index, indices, palette), 0);
+				size += sizeof(uint64_t) * (1 + palette.size()) + indices.size();
+			} break;
+
 			case VoxelBufferInternal::COMPRESSION_UNIFORM: {
 				size += VoxelBufferInternal::get_depth_bit_count(depth) >> 3;
 			} break;
@@ -256,7 +295,7 @@ size_t get_size_in_bytes(const VoxelBufferInternal &buffer, size_t &metadata_siz
 		}
 	}
 
-	metadata_size = get_metadata_size_in_bytes(buffer);
+	metadata_size = build_metadata_blob(buffer);
 
 	size_t metadata_size_with_header = 0;
 	if (metadata_size > 0) {
@@ -266,9 +305,35 @@ size_t get_size_in_bytes(const VoxelBufferInternal &buffer, size_t &metadata_siz
 	return size + metadata_size_with_header + BLOCK_TRAILING_MAGIC_SIZE;
 }
 
+// Copies a whole channel into `dst` in linear ZXY order, regardless of the channel's in-memory layout
+static void copy_channel_to_linear_zxy(
+		const VoxelBufferInternal &voxel_buffer, unsigned int channel_index, Span<uint8_t> dst) {
+	const Vector3i size = voxel_buffer.get_size();
+	switch (voxel_buffer.get_channel_depth(channel_index)) {
+		case VoxelBufferInternal::DEPTH_8_BIT:
+			voxel_buffer.copy_to(dst, size, Vector3i(), Vector3i(), size, channel_index);
+			break;
+		case VoxelBufferInternal::DEPTH_16_BIT:
+			voxel_buffer.copy_to(dst.reinterpret_cast_to<uint16_t>(), size, Vector3i(), Vector3i(), size,
+					channel_index);
+			break;
+		case VoxelBufferInternal::DEPTH_32_BIT:
+			voxel_buffer.copy_to(dst.reinterpret_cast_to<uint32_t>(), size, Vector3i(), Vector3i(), size,
+					channel_index);
+			break;
+		case VoxelBufferInternal::DEPTH_64_BIT:
+			voxel_buffer.copy_to(dst.reinterpret_cast_to<uint64_t>(), size, Vector3i(), Vector3i(), size,
+					channel_index);
+			break;
+		default:
+			CRASH_NOW();
+	}
+}
+
 SerializeResult serialize(const VoxelBufferInternal &voxel_buffer) {
 	//
 	ZN_PROFILE_SCOPE();
+	ZN_LIGHT_PROFILE_SCOPE("block_serialize");
 
 	std::vector<uint8_t> &dst_data = tls_data;
 	std::vector<uint8_t> &metadata_tmp = tls_metadata_tmp;
@@ -301,18 +366,54 @@ SerializeResult serialize(const VoxelBufferInternal &voxel_buffer) {
 	for (unsigned int channel_index = 0; channel_index < VoxelBufferInternal::MAX_CHANNELS; ++channel_index) {
 		const VoxelBufferInternal::Compression compression = voxel_buffer.get_channel_compression(channel_index);
 		const VoxelBufferInternal::Depth depth = voxel_buffer.get_channel_depth(channel_index);
+		// Tiled storage is in-memory only: files keep the dense encoding so older versions and
+		// external tools can keep reading them. Paletted channels however ARE written natively,
+		// that's where the serialization size win comes from (format version 5).
+		const VoxelBufferInternal::Compression serialized_compression =
+				compression == VoxelBufferInternal::COMPRESSION_TILED ? VoxelBufferInternal::COMPRESSION_NONE
+																	  : compression;
 		// Low nibble: compression (up to 16 values allowed)
 		// High nibble: depth (up to 16 values allowed)
-		const uint8_t fmt = static_cast<uint8_t>(compression) | (static_cast<uint8_t>(depth) << 4);
+		const uint8_t fmt = static_cast<uint8_t>(serialized_compression) | (static_cast<uint8_t>(depth) << 4);
 		f.store_8(fmt);
 
 		switch (compression) {
-			case VoxelBufferInternal::COMPRESSION_NONE: {
-				Span<uint8_t> data;
-				ERR_FAIL_COND_V(!voxel_buffer.get_channel_raw(channel_index, data), SerializeResult(dst_data, false));
+			case VoxelBufferInternal::COMPRESSION_PALETTED: {
+				Span<const uint8_t> indices;
+				Span<const uint64_t> palette;
+				ERR_FAIL_COND_V(!voxel_buffer.get_channel_paletted_view(channel_index, indices, palette),
+						SerializeResult(dst_data, false));
+				f.store_64(palette.size());
+				f.store_buffer(Span<const uint8_t>(
+						reinterpret_cast<const uint8_t *>(palette.data()), palette.size() * sizeof(uint64_t)));
+				f.store_buffer(indices);
+			} break;
+
+			case VoxelBufferInternal::COMPRESSION_TILED: {
+				// Decode to dense in a scratch buffer; tiled channels always use the linear layout
+				std::vector<uint8_t> &tmp = tls_linear_channel_tmp;
+				Span<const uint8_t> data;
+				ERR_FAIL_COND_V(
+						!voxel_buffer.get_channel_as_dense(channel_index, tmp, data), SerializeResult(dst_data, false));
 				f.store_buffer(data);
 			} break;
 
+			case VoxelBufferInternal::COMPRESSION_NONE: {
+				// Read-only access, so copy-on-write payloads of save snapshots stay shared
+				Span<const uint8_t> data;
+				ERR_FAIL_COND_V(
+						!voxel_buffer.get_channel_raw_read_only(channel_index, data), SerializeResult(dst_data, false));
+				if (voxel_buffer.get_channel_layout(channel_index) != VoxelBufferInternal::CHANNEL_LAYOUT_ZXY) {
+					// The serialized format is always linear ZXY, reorder into a scratch buffer
+					std::vector<uint8_t> &tmp = tls_linear_channel_tmp;
+					tmp.resize(data.size());
+					copy_channel_to_linear_zxy(voxel_buffer, channel_index, to_span(tmp));
+					f.store_buffer(to_span_const(tmp));
+				} else {
+					f.store_buffer(data);
+				}
+			} break;
+
 			case VoxelBufferInternal::COMPRESSION_UNIFORM: {
 				const uint64_t v = voxel_buffer.get_voxel(Vector3i(), channel_index);
 				switch (depth) {
@@ -342,10 +443,9 @@ SerializeResult serialize(const VoxelBufferInternal &voxel_buffer) {
 	// we just discard all metadata as if it was empty.
 	if (expected_metadata_size > 0) {
 		f.store_32(expected_metadata_size);
-		metadata_tmp.resize(expected_metadata_size);
-		// This function brings me joy. </irony>
-		serialize_metadata(to_span(metadata_tmp), voxel_buffer);
-		f.store_buffer(to_span(metadata_tmp));
+		// Built in one pass during size calculation, each Variant was encoded exactly once
+		CRASH_COND(tls_metadata_blob.size() != expected_metadata_size);
+		f.store_buffer(to_span(tls_metadata_blob));
 	}
 
 	f.store_32(BLOCK_TRAILING_MAGIC);
@@ -548,6 +648,14 @@ bool migrate_v2_to_v3(Span<const uint8_t> p_data, std::vector<uint8_t> &dst) {
 } // namespace legacy
 
 bool deserialize(Span<const uint8_t> p_data, VoxelBufferInternal &out_voxel_buffer) {
+	return deserialize_channels(p_data, out_voxel_buffer, 0xffffffff);
+}
+
+// Channels excluded from `channels_mask` are skipped without allocating or copying, and stay at
+// their defaults in the output buffer. Metadata is only read with a full mask: partially-read
+// buffers are for read-only consumption and must never flow back into a save.
+bool deserialize_channels(Span<const uint8_t> p_data, VoxelBufferInternal &out_voxel_buffer,
+		unsigned int channels_mask) {
 	ZN_PROFILE_SCOPE();
 
 	std::vector<uint8_t> &metadata_tmp = tls_metadata_tmp;
@@ -564,15 +672,21 @@ bool deserialize(Span<const uint8_t> p_data, VoxelBufferInternal &out_voxel_buff
 		case 2: {
 			std::vector<uint8_t> migrated_data;
 			ERR_FAIL_COND_V(!legacy::migrate_v2_to_v3(p_data, migrated_data), false);
-			return deserialize(to_span(migrated_data), out_voxel_buffer);
+			return deserialize_channels(to_span(migrated_data), out_voxel_buffer, channels_mask);
 		} break;
 
 		case 3: {
 			std::vector<uint8_t> migrated_data;
 			ERR_FAIL_COND_V(!legacy::migrate_v3_to_v4(p_data, migrated_data), false);
-			return deserialize(to_span(migrated_data), out_voxel_buffer);
+			return deserialize_channels(to_span(migrated_data), out_voxel_buffer, channels_mask);
 		} break;
 
+		case 4:
+		case 5:
+			// Version 5 only added the paletted compression mode and version 6 only added
+			// metadata references; older data reads identically
+			break;
+
 		default:
 			ERR_FAIL_COND_V(format_version != BLOCK_FORMAT_VERSION, false);
 	}
@@ -594,10 +708,21 @@ bool deserialize(Span<const uint8_t> p_data, VoxelBufferInternal &out_voxel_buff
 		VoxelBufferInternal::Compression compression = (VoxelBufferInternal::Compression)compression_value;
 		VoxelBufferInternal::Depth depth = (VoxelBufferInternal::Depth)depth_value;
 
+		const bool channel_wanted = ((channels_mask >> channel_index) & 1) != 0;
+
 		out_voxel_buffer.set_channel_depth(channel_index, depth);
 
 		switch (compression) {
 			case VoxelBufferInternal::COMPRESSION_NONE: {
+				if (!channel_wanted) {
+					const size_t data_len = Vector3iUtil::get_volume(out_voxel_buffer.get_size()) *
+							VoxelBufferInternal::get_depth_byte_count(depth);
+					ERR_FAIL_COND_V(f.get_position() + data_len > p_data.size(), false);
+					f.pos += data_len;
+					break;
+				}
+				// Serialized data is linear ZXY, make sure the destination channel is too
+				out_voxel_buffer.set_channel_layout(channel_index, VoxelBufferInternal::CHANNEL_LAYOUT_ZXY);
 				out_voxel_buffer.decompress_channel(channel_index);
 
 				Span<uint8_t> buffer;
@@ -629,7 +754,28 @@ bool deserialize(Span<const uint8_t> p_data, VoxelBufferInternal &out_voxel_buff
 					default:
 						CRASH_NOW();
 				}
-				out_voxel_buffer.clear_channel(channel_index, v);
+				if (channel_wanted) {
+					out_voxel_buffer.clear_channel(channel_index, v);
+				}
+			} break;
+
+			case VoxelBufferInternal::COMPRESSION_PALETTED: {
+				const uint64_t palette_count = f.get_64();
+				ERR_FAIL_COND_V(palette_count == 0 || palette_count > 256, false);
+				const size_t volume = Vector3iUtil::get_volume(out_voxel_buffer.get_size());
+				ERR_FAIL_COND_V(
+						f.get_position() + palette_count * sizeof(uint64_t) + volume > p_data.size(), false);
+				if (!channel_wanted) {
+					f.pos += palette_count * sizeof(uint64_t) + volume;
+					break;
+				}
+				Span<const uint64_t> palette =
+						Span<const uint8_t>(p_data.data() + f.get_position(), palette_count * sizeof(uint64_t))
+								.reinterpret_cast_to<const uint64_t>();
+				f.pos += palette_count * sizeof(uint64_t);
+				Span<const uint8_t> indices(p_data.data() + f.get_position(), volume);
+				f.pos += volume;
+				ERR_FAIL_COND_V(!out_voxel_buffer.set_channel_paletted(channel_index, palette, indices), false);
 			} break;
 
 			default:
@@ -641,9 +787,13 @@ bool deserialize(Span<const uint8_t> p_data, VoxelBufferInternal &out_voxel_buff
 	if (p_data.size() - f.get_position() > BLOCK_TRAILING_MAGIC_SIZE) {
 		const size_t metadata_size = f.get_32();
 		ERR_FAIL_COND_V(f.get_position() + metadata_size > p_data.size(), false);
-		metadata_tmp.resize(metadata_size);
-		f.get_buffer(to_span(metadata_tmp));
-		deserialize_metadata(to_span(metadata_tmp), out_voxel_buffer);
+		if (channels_mask == 0xffffffff) {
+			metadata_tmp.resize(metadata_size);
+			f.get_buffer(to_span(metadata_tmp));
+			deserialize_metadata(to_span(metadata_tmp), out_voxel_buffer);
+		} else {
+			f.pos += metadata_size;
+		}
 	}
 
 	// Failure at this indicates file corruption
@@ -652,11 +802,237 @@ bool deserialize(Span<const uint8_t> p_data, VoxelBufferInternal &out_voxel_buff
 	return true;
 }
 
+// Tells if the buffer has the simple shape the zero-copy compression path supports:
+// exactly one dense linear channel, everything else uniform, and no metadata.
+static bool find_single_dense_channel(const VoxelBufferInternal &voxel_buffer, unsigned int &out_channel_index) {
+	unsigned int dense_count = 0;
+	for (unsigned int channel_index = 0; channel_index < VoxelBufferInternal::MAX_CHANNELS; ++channel_index) {
+		const VoxelBufferInternal::Compression compression = voxel_buffer.get_channel_compression(channel_index);
+		if (compression == VoxelBufferInternal::COMPRESSION_TILED ||
+				compression == VoxelBufferInternal::COMPRESSION_PALETTED) {
+			// This path only passes through one dense payload, compact channels need the full path
+			return false;
+		}
+		if (compression == VoxelBufferInternal::COMPRESSION_NONE) {
+			out_channel_index = channel_index;
+			++dense_count;
+		}
+	}
+	return dense_count == 1 &&
+			voxel_buffer.get_channel_layout(out_channel_index) == VoxelBufferInternal::CHANNEL_LAYOUT_ZXY &&
+			voxel_buffer.get_block_metadata().get_type() == VoxelMetadata::TYPE_EMPTY &&
+			voxel_buffer.get_voxel_metadata().size() == 0;
+}
+
+// Fully-uniform blocks (air, solid stone) dominate most saves, and running the full serializer
+// and LZ4 on them produced payloads that were nearly all wrapper overhead. They get a dedicated
+// value-only record instead, stored raw: compressing ~30 bytes saves nothing. Tagged with a
+// marker that can't collide with format version bytes or compression headers.
+static const uint8_t BLOCK_UNIFORM_FORMAT_MARKER = 0xD2;
+static const uint8_t BLOCK_UNIFORM_FORMAT_VERSION = 1;
+
+static bool is_uniform_blob(Span<const uint8_t> p_data) {
+	return p_data.size() > 0 && p_data[0] == BLOCK_UNIFORM_FORMAT_MARKER;
+}
+
+static bool is_fully_uniform(const VoxelBufferInternal &voxel_buffer) {
+	for (unsigned int channel_index = 0; channel_index < VoxelBufferInternal::MAX_CHANNELS; ++channel_index) {
+		if (voxel_buffer.get_channel_compression(channel_index) != VoxelBufferInternal::COMPRESSION_UNIFORM) {
+			return false;
+		}
+	}
+	return voxel_buffer.get_block_metadata().get_type() == VoxelMetadata::TYPE_EMPTY &&
+			voxel_buffer.get_voxel_metadata().size() == 0;
+}
+
+static SerializeResult serialize_uniform(const VoxelBufferInternal &voxel_buffer) {
+	std::vector<uint8_t> &dst_data = tls_compressed_data;
+	dst_data.clear();
+
+	MemoryWriter f(dst_data, ENDIANESS_LITTLE_ENDIAN);
+
+	f.store_8(BLOCK_UNIFORM_FORMAT_MARKER);
+	f.store_8(BLOCK_UNIFORM_FORMAT_VERSION);
+	f.store_16(voxel_buffer.get_size().x);
+	f.store_16(voxel_buffer.get_size().y);
+	f.store_16(voxel_buffer.get_size().z);
+
+	for (unsigned int channel_index = 0; channel_index < VoxelBufferInternal::MAX_CHANNELS; ++channel_index) {
+		const VoxelBufferInternal::Depth depth = voxel_buffer.get_channel_depth(channel_index);
+		// Same nibble layout as the full format
+		const uint8_t fmt = VoxelBufferInternal::COMPRESSION_UNIFORM | (static_cast<uint8_t>(depth) << 4);
+		f.store_8(fmt);
+
+		const uint64_t v = voxel_buffer.get_voxel(Vector3i(), channel_index);
+		switch (depth) {
+			case VoxelBufferInternal::DEPTH_8_BIT:
+				f.store_8(v);
+				break;
+			case VoxelBufferInternal::DEPTH_16_BIT:
+				f.store_16(v);
+				break;
+			case VoxelBufferInternal::DEPTH_32_BIT:
+				f.store_32(v);
+				break;
+			case VoxelBufferInternal::DEPTH_64_BIT:
+				f.store_64(v);
+				break;
+			default:
+				CRASH_NOW();
+		}
+	}
+
+	f.store_32(BLOCK_TRAILING_MAGIC);
+	return SerializeResult(dst_data, true);
+}
+
+static bool deserialize_uniform(Span<const uint8_t> p_data, VoxelBufferInternal &out_voxel_buffer) {
+	ERR_FAIL_COND_V(p_data.size() < sizeof(uint32_t), false);
+	const uint32_t magic = *reinterpret_cast<const uint32_t *>(&p_data[p_data.size() - sizeof(uint32_t)]);
+	ERR_FAIL_COND_V(magic != BLOCK_TRAILING_MAGIC, false);
+
+	MemoryReader f(p_data, ENDIANESS_LITTLE_ENDIAN);
+
+	ERR_FAIL_COND_V(f.get_8() != BLOCK_UNIFORM_FORMAT_MARKER, false);
+	ERR_FAIL_COND_V(f.get_8() != BLOCK_UNIFORM_FORMAT_VERSION, false);
+
+	const unsigned int size_x = f.get_16();
+	const unsigned int size_y = f.get_16();
+	const unsigned int size_z = f.get_16();
+
+	out_voxel_buffer.create(Vector3i(size_x, size_y, size_z));
+
+	for (unsigned int channel_index = 0; channel_index < VoxelBufferInternal::MAX_CHANNELS; ++channel_index) {
+		const uint8_t fmt = f.get_8();
+		const uint8_t compression_value = fmt & 0xf;
+		const uint8_t depth_value = (fmt >> 4) & 0xf;
+		ERR_FAIL_COND_V(compression_value != VoxelBufferInternal::COMPRESSION_UNIFORM, false);
+		ERR_FAIL_COND_V(depth_value >= VoxelBufferInternal::DEPTH_COUNT, false);
+		const VoxelBufferInternal::Depth depth = (VoxelBufferInternal::Depth)depth_value;
+
+		out_voxel_buffer.set_channel_depth(channel_index, depth);
+
+		uint64_t v;
+		switch (depth) {
+			case VoxelBufferInternal::DEPTH_8_BIT:
+				v = f.get_8();
+				break;
+			case VoxelBufferInternal::DEPTH_16_BIT:
+				v = f.get_16();
+				break;
+			case VoxelBufferInternal::DEPTH_32_BIT:
+				v = f.get_32();
+				break;
+			case VoxelBufferInternal::DEPTH_64_BIT:
+				v = f.get_64();
+				break;
+			default:
+				CRASH_NOW();
+		}
+		out_voxel_buffer.clear_channel(channel_index, v);
+	}
+
+	return true;
+}
+
 SerializeResult serialize_and_compress(const VoxelBufferInternal &voxel_buffer) {
+	return serialize_and_compress(voxel_buffer, false);
+}
+
+SerializeResult serialize_and_compress(const VoxelBufferInternal &voxel_buffer, bool archive_compression) {
 	ZN_PROFILE_SCOPE();
+	ZN_LIGHT_PROFILE_SCOPE("block_serialize_and_compress");
 
 	std::vector<uint8_t> &compressed_data = tls_compressed_data;
 
+	if (is_fully_uniform(voxel_buffer)) {
+		// Covers both tiers: the record is smaller than any compressed full-format payload
+		return serialize_uniform(voxel_buffer);
+	}
+
+	if (archive_compression) {
+		// Denser tier: the serialized stream is delta-filtered with the byte size of the SDF
+		// channel's voxels as stride, which is where most of the entropy of smooth terrain lives.
+		SerializeResult res = serialize(voxel_buffer);
+		ERR_FAIL_COND_V(!res.success, SerializeResult(compressed_data, false));
+		const unsigned int filter_stride = VoxelBufferInternal::get_depth_byte_count(
+				voxel_buffer.get_channel_depth(VoxelBufferInternal::CHANNEL_SDF));
+		res.success = CompressedData::compress_filtered(
+				Span<const uint8_t>(res.data.data(), 0, res.data.size()), compressed_data, filter_stride);
+		ERR_FAIL_COND_V(!res.success, SerializeResult(compressed_data, false));
+		return SerializeResult(compressed_data, true);
+	}
+
+	unsigned int dense_channel_index = 0;
+	if (find_single_dense_channel(voxel_buffer, dense_channel_index) &&
+			Vector3iUtil::get_volume(voxel_buffer.get_size()) > 0) {
+		// Common shape of a terrain block: one dense channel and nothing else.
+		// LZ4 reads the channel memory directly; only the small wrapping bytes go through a scratch buffer,
+		// so the whole serialized stream is never assembled in an intermediate copy.
+		// Read-only access, so copy-on-write payloads of save snapshots stay shared
+		Span<const uint8_t> channel_data;
+		const bool got_raw = voxel_buffer.get_channel_raw_read_only(dense_channel_index, channel_data);
+		ZN_ASSERT(got_raw);
+
+		std::vector<uint8_t> &wrapper_data = tls_data;
+		wrapper_data.clear();
+		MemoryWriter f(wrapper_data, ENDIANESS_LITTLE_ENDIAN);
+
+		f.store_8(BLOCK_FORMAT_VERSION);
+		f.store_16(voxel_buffer.get_size().x);
+		f.store_16(voxel_buffer.get_size().y);
+		f.store_16(voxel_buffer.get_size().z);
+
+		size_t split_pos = 0;
+		for (unsigned int channel_index = 0; channel_index < VoxelBufferInternal::MAX_CHANNELS; ++channel_index) {
+			const VoxelBufferInternal::Compression compression =
+					voxel_buffer.get_channel_compression(channel_index);
+			const VoxelBufferInternal::Depth depth = voxel_buffer.get_channel_depth(channel_index);
+			const uint8_t fmt = static_cast<uint8_t>(compression) | (static_cast<uint8_t>(depth) << 4);
+			f.store_8(fmt);
+
+			if (channel_index == dense_channel_index) {
+				// The payload is passed as its own segment instead of being copied here
+				split_pos = wrapper_data.size();
+				continue;
+			}
+
+			const uint64_t v = voxel_buffer.get_voxel(Vector3i(), channel_index);
+			switch (depth) {
+				case VoxelBufferInternal::DEPTH_8_BIT:
+					f.store_8(v);
+					break;
+				case VoxelBufferInternal::DEPTH_16_BIT:
+					f.store_16(v);
+					break;
+				case VoxelBufferInternal::DEPTH_32_BIT:
+					f.store_32(v);
+					break;
+				case VoxelBufferInternal::DEPTH_64_BIT:
+					f.store_64(v);
+					break;
+				default:
+					CRASH_NOW();
+			}
+		}
+
+		// No metadata by precondition
+		f.store_32(BLOCK_TRAILING_MAGIC);
+
+		// Spans are taken only now, the scratch buffer won't reallocate anymore
+		FixedArray<Span<const uint8_t>, 3> segments;
+		segments[0] = Span<const uint8_t>(wrapper_data.data(), split_pos);
+		segments[1] = to_span_const(channel_data);
+		segments[2] = Span<const uint8_t>(wrapper_data.data() + split_pos, wrapper_data.size() - split_pos);
+
+		// Independently-compressed sections: readers needing only some channels (or none) can
+		// skip decompressing the dense payload entirely, see `decompress_and_deserialize_channels`
+		if (CompressedData::compress_sectioned(to_span_const(segments), compressed_data)) {
+			return SerializeResult(compressed_data, true);
+		}
+		// On failure, fall through to the regular path
+	}
+
 	SerializeResult res = serialize(voxel_buffer);
 	ERR_FAIL_COND_V(!res.success, SerializeResult(compressed_data, false));
 	const std::vector<uint8_t> &data = res.data;
@@ -670,6 +1046,11 @@ SerializeResult serialize_and_compress(const VoxelBufferInternal &voxel_buffer)
 
 bool decompress_and_deserialize(Span<const uint8_t> p_data, VoxelBufferInternal &out_voxel_buffer) {
 	ZN_PROFILE_SCOPE();
+	ZN_LIGHT_PROFILE_SCOPE("block_decompress_and_deserialize");
+
+	if (is_uniform_blob(p_data)) {
+		return deserialize_uniform(p_data, out_voxel_buffer);
+	}
 
 	std::vector<uint8_t> &data = tls_data;
 
@@ -679,6 +1060,307 @@ bool decompress_and_deserialize(Span<const uint8_t> p_data, VoxelBufferInternal
 	return deserialize(to_span_const(data), out_voxel_buffer);
 }
 
+bool decompress_and_deserialize_channels(
+		Span<const uint8_t> p_data, VoxelBufferInternal &out_voxel_buffer, unsigned int channels_mask) {
+	ZN_PROFILE_SCOPE();
+
+	if (channels_mask == 0xffffffff) {
+		return decompress_and_deserialize(p_data, out_voxel_buffer);
+	}
+	if (is_uniform_blob(p_data)) {
+		// Tiny either way, and uniform channels cost nothing to apply
+		return deserialize_uniform(p_data, out_voxel_buffer);
+	}
+
+	if (p_data.size() > 0 && p_data[0] == CompressedData::COMPRESSION_LZ4_SECTIONED) {
+		// Single-dense-channel save: head (everything before the dense payload), the payload
+		// itself, and the tail. Only the needed sections get decompressed, so a read excluding
+		// the dense channel touches a few dozen bytes of a multi-kilobyte record.
+		std::vector<CompressedData::SectionInfo> sections;
+		ERR_FAIL_COND_V(!CompressedData::read_section_table(p_data, sections), false);
+		ERR_FAIL_COND_V(sections.size() != 3, false);
+
+		static thread_local std::vector<uint8_t> tls_head;
+		static thread_local std::vector<uint8_t> tls_tail;
+		static thread_local std::vector<uint8_t> tls_dense_payload;
+		ERR_FAIL_COND_V(!CompressedData::decompress_section(p_data, sections[0], tls_head), false);
+		ERR_FAIL_COND_V(!CompressedData::decompress_section(p_data, sections[2], tls_tail), false);
+
+		MemoryReader hf(to_span_const(tls_head), ENDIANESS_LITTLE_ENDIAN);
+		MemoryReader tf(to_span_const(tls_tail), ENDIANESS_LITTLE_ENDIAN);
+
+		const uint8_t version = hf.get_8();
+		// Version 5 introduced this layout and later versions did not change it
+		ERR_FAIL_COND_V(version < 5 || version > BLOCK_FORMAT_VERSION, false);
+		const unsigned int size_x = hf.get_16();
+		const unsigned int size_y = hf.get_16();
+		const unsigned int size_z = hf.get_16();
+		out_voxel_buffer.create(Vector3i(size_x, size_y, size_z));
+
+		// The head ends right after the dense channel's format byte, the rest is in the tail
+		MemoryReader *reader = &hf;
+
+		for (unsigned int channel_index = 0; channel_index < VoxelBufferInternal::MAX_CHANNELS; ++channel_index) {
+			const uint8_t fmt = reader->get_8();
+			const uint8_t compression_value = fmt & 0xf;
+			const uint8_t depth_value = (fmt >> 4) & 0xf;
+			ERR_FAIL_COND_V(depth_value >= VoxelBufferInternal::DEPTH_COUNT, false);
+			const VoxelBufferInternal::Depth depth = (VoxelBufferInternal::Depth)depth_value;
+			const bool channel_wanted = ((channels_mask >> channel_index) & 1) != 0;
+
+			out_voxel_buffer.set_channel_depth(channel_index, depth);
+
+			if (compression_value == VoxelBufferInternal::COMPRESSION_NONE) {
+				if (channel_wanted) {
+					ERR_FAIL_COND_V(
+							!CompressedData::decompress_section(p_data, sections[1], tls_dense_payload), false);
+					out_voxel_buffer.set_channel_layout(channel_index, VoxelBufferInternal::CHANNEL_LAYOUT_ZXY);
+					out_voxel_buffer.decompress_channel(channel_index);
+					Span<uint8_t> buffer;
+					CRASH_COND(!out_voxel_buffer.get_channel_raw(channel_index, buffer));
+					ERR_FAIL_COND_V(buffer.size() != tls_dense_payload.size(), false);
+					memcpy(buffer.data(), tls_dense_payload.data(), buffer.size());
+				}
+				reader = &tf;
+
+			} else if (compression_value == VoxelBufferInternal::COMPRESSION_UNIFORM) {
+				uint64_t v;
+				switch (depth) {
+					case VoxelBufferInternal::DEPTH_8_BIT:
+						v = reader->get_8();
+						break;
+					case VoxelBufferInternal::DEPTH_16_BIT:
+						v = reader->get_16();
+						break;
+					case VoxelBufferInternal::DEPTH_32_BIT:
+						v = reader->get_32();
+						break;
+					case VoxelBufferInternal::DEPTH_64_BIT:
+						v = reader->get_64();
+						break;
+					default:
+						CRASH_NOW();
+				}
+				if (channel_wanted) {
+					out_voxel_buffer.clear_channel(channel_index, v);
+				}
+
+			} else {
+				// This layout only carries one dense channel and uniform ones, and no metadata
+				ERR_PRINT("Unexpected compression mode in sectioned block");
+				return false;
+			}
+		}
+
+		ERR_FAIL_COND_V(tf.get_32() != BLOCK_TRAILING_MAGIC, false);
+		return true;
+	}
+
+	std::vector<uint8_t> &data = tls_data;
+	if (!CompressedData::decompress(p_data, data)) {
+		return false;
+	}
+	return deserialize_channels(to_span_const(data), out_voxel_buffer, channels_mask);
+}
+
+// Delta blobs are tagged with a marker that can't collide with full-format version bytes
+static const uint8_t BLOCK_DELTA_FORMAT_MARKER = 0xD1;
+static const uint8_t BLOCK_DELTA_FORMAT_VERSION = 1;
+
+bool is_delta_blob(Span<const uint8_t> p_data) {
+	return p_data.size() > 0 && p_data[0] == BLOCK_DELTA_FORMAT_MARKER;
+}
+
+SerializeResult serialize_delta(const VoxelBufferInternal &voxel_buffer, Span<const Box3i> boxes) {
+	ZN_PROFILE_SCOPE();
+
+	std::vector<uint8_t> &dst_data = tls_data;
+	dst_data.clear();
+
+	ERR_FAIL_COND_V(boxes.size() == 0 || boxes.size() > 255, SerializeResult(dst_data, false));
+
+	MemoryWriter f(dst_data, ENDIANESS_LITTLE_ENDIAN);
+
+	f.store_8(BLOCK_DELTA_FORMAT_MARKER);
+	f.store_8(BLOCK_DELTA_FORMAT_VERSION);
+	f.store_16(voxel_buffer.get_size().x);
+	f.store_16(voxel_buffer.get_size().y);
+	f.store_16(voxel_buffer.get_size().z);
+	f.store_8(boxes.size());
+
+	const Vector3i buffer_size = voxel_buffer.get_size();
+
+	for (unsigned int box_index = 0; box_index < boxes.size(); ++box_index) {
+		const Box3i box = boxes[box_index].clipped(Box3i(Vector3i(), buffer_size));
+		ERR_FAIL_COND_V(Vector3iUtil::get_volume(box.size) == 0, SerializeResult(dst_data, false));
+
+		f.store_16(box.pos.x);
+		f.store_16(box.pos.y);
+		f.store_16(box.pos.z);
+		f.store_16(box.size.x);
+		f.store_16(box.size.y);
+		f.store_16(box.size.z);
+
+		for (unsigned int channel_index = 0; channel_index < VoxelBufferInternal::MAX_CHANNELS; ++channel_index) {
+			const VoxelBufferInternal::Depth depth = voxel_buffer.get_channel_depth(channel_index);
+			const bool uniform = voxel_buffer.get_channel_compression(channel_index) ==
+					VoxelBufferInternal::COMPRESSION_UNIFORM;
+			// Same nibble layout as the full format
+			const uint8_t fmt = (uniform ? VoxelBufferInternal::COMPRESSION_UNIFORM
+										 : VoxelBufferInternal::COMPRESSION_NONE) |
+					(static_cast<uint8_t>(depth) << 4);
+			f.store_8(fmt);
+
+			if (uniform) {
+				f.store_64(voxel_buffer.get_voxel(Vector3i(), channel_index));
+				continue;
+			}
+
+			// Dense region extraction, linear ZXY within the box
+			const unsigned int value_size = VoxelBufferInternal::get_depth_byte_count(depth);
+			std::vector<uint8_t> &tmp = tls_linear_channel_tmp;
+			tmp.resize(Vector3iUtil::get_volume(box.size) * value_size);
+			switch (depth) {
+				case VoxelBufferInternal::DEPTH_8_BIT:
+					voxel_buffer.copy_to(to_span(tmp), box.size, Vector3i(), box.pos, box.pos + box.size,
+							channel_index);
+					break;
+				case VoxelBufferInternal::DEPTH_16_BIT:
+					voxel_buffer.copy_to(to_span(tmp).reinterpret_cast_to<uint16_t>(), box.size, Vector3i(),
+							box.pos, box.pos + box.size, channel_index);
+					break;
+				case VoxelBufferInternal::DEPTH_32_BIT:
+					voxel_buffer.copy_to(to_span(tmp).reinterpret_cast_to<uint32_t>(), box.size, Vector3i(),
+							box.pos, box.pos + box.size, channel_index);
+					break;
+				case VoxelBufferInternal::DEPTH_64_BIT:
+					voxel_buffer.copy_to(to_span(tmp).reinterpret_cast_to<uint64_t>(), box.size, Vector3i(),
+							box.pos, box.pos + box.size, channel_index);
+					break;
+				default:
+					CRASH_NOW();
+			}
+			f.store_buffer(to_span_const(tmp));
+		}
+	}
+
+	f.store_32(BLOCK_TRAILING_MAGIC);
+	return SerializeResult(dst_data, true);
+}
+
+bool deserialize_delta(
+		Span<const uint8_t> p_data, VoxelBufferInternal &voxel_buffer, std::vector<Box3i> &out_boxes) {
+	ZN_PROFILE_SCOPE();
+
+	ERR_FAIL_COND_V(p_data.size() < sizeof(uint32_t), false);
+	const uint32_t magic = *reinterpret_cast<const uint32_t *>(&p_data[p_data.size() - sizeof(uint32_t)]);
+	ERR_FAIL_COND_V(magic != BLOCK_TRAILING_MAGIC, false);
+
+	MemoryReader f(p_data, ENDIANESS_LITTLE_ENDIAN);
+
+	ERR_FAIL_COND_V(f.get_8() != BLOCK_DELTA_FORMAT_MARKER, false);
+	ERR_FAIL_COND_V(f.get_8() != BLOCK_DELTA_FORMAT_VERSION, false);
+
+	const unsigned int size_x = f.get_16();
+	const unsigned int size_y = f.get_16();
+	const unsigned int size_z = f.get_16();
+	ERR_FAIL_COND_V(Vector3i(size_x, size_y, size_z) != voxel_buffer.get_size(), false);
+
+	const unsigned int box_count = f.get_8();
+
+	for (unsigned int box_index = 0; box_index < box_count; ++box_index) {
+		Box3i box;
+		box.pos.x = f.get_16();
+		box.pos.y = f.get_16();
+		box.pos.z = f.get_16();
+		box.size.x = f.get_16();
+		box.size.y = f.get_16();
+		box.size.z = f.get_16();
+		ERR_FAIL_COND_V(!Box3i(Vector3i(), voxel_buffer.get_size()).encloses(box), false);
+		out_boxes.push_back(box);
+
+		for (unsigned int channel_index = 0; channel_index < VoxelBufferInternal::MAX_CHANNELS; ++channel_index) {
+			const uint8_t fmt = f.get_8();
+			const uint8_t compression_value = fmt & 0xf;
+			const uint8_t depth_value = (fmt >> 4) & 0xf;
+			ERR_FAIL_COND_V(depth_value >= VoxelBufferInternal::DEPTH_COUNT, false);
+			const VoxelBufferInternal::Depth depth = VoxelBufferInternal::Depth(depth_value);
+			ERR_FAIL_COND_V(depth != voxel_buffer.get_channel_depth(channel_index), false);
+
+			if (compression_value == VoxelBufferInternal::COMPRESSION_UNIFORM) {
+				const uint64_t v = f.get_64();
+				voxel_buffer.fill_area(v, box.pos, box.pos + box.size, channel_index);
+				continue;
+			}
+			ERR_FAIL_COND_V(compression_value != VoxelBufferInternal::COMPRESSION_NONE, false);
+
+			const unsigned int value_size = VoxelBufferInternal::get_depth_byte_count(depth);
+			const size_t data_size = Vector3iUtil::get_volume(box.size) * value_size;
+			ERR_FAIL_COND_V(f.get_position() + data_size > p_data.size(), false);
+			Span<const uint8_t> src(p_data.data() + f.get_position(), data_size);
+			f.pos += data_size;
+
+			switch (depth) {
+				case VoxelBufferInternal::DEPTH_8_BIT:
+					voxel_buffer.copy_from(src, box.size, Vector3i(), box.size, box.pos, channel_index);
+					break;
+				case VoxelBufferInternal::DEPTH_16_BIT:
+					voxel_buffer.copy_from(src.reinterpret_cast_to<const uint16_t>(), box.size, Vector3i(),
+							box.size, box.pos, channel_index);
+					break;
+				case VoxelBufferInternal::DEPTH_32_BIT:
+					voxel_buffer.copy_from(src.reinterpret_cast_to<const uint32_t>(), box.size, Vector3i(),
+							box.size, box.pos, channel_index);
+					break;
+				case VoxelBufferInternal::DEPTH_64_BIT:
+					voxel_buffer.copy_from(src.reinterpret_cast_to<const uint64_t>(), box.size, Vector3i(),
+							box.size, box.pos, channel_index);
+					break;
+				default:
+					CRASH_NOW();
+			}
+		}
+	}
+
+	return true;
+}
+
+SerializeResult serialize_and_compress_delta(const VoxelBufferInternal &voxel_buffer, Span<const Box3i> boxes) {
+	std::vector<uint8_t> &compressed_data = tls_compressed_data;
+	SerializeResult res = serialize_delta(voxel_buffer, boxes);
+	ERR_FAIL_COND_V(!res.success, SerializeResult(compressed_data, false));
+	const std::vector<uint8_t> &data = res.data;
+	ERR_FAIL_COND_V(!CompressedData::compress(
+							Span<const uint8_t>(data.data(), 0, data.size()), compressed_data,
+							CompressedData::COMPRESSION_LZ4),
+			SerializeResult(compressed_data, false));
+	return SerializeResult(compressed_data, true);
+}
+
+bool decompress_and_deserialize_delta(
+		Span<const uint8_t> p_data, VoxelBufferInternal &voxel_buffer, std::vector<Box3i> &out_boxes) {
+	ZN_PROFILE_SCOPE();
+	std::vector<uint8_t> &data = tls_data;
+	ERR_FAIL_COND_V(!CompressedData::decompress(p_data, data), false);
+	return deserialize_delta(to_span_const(data), voxel_buffer, out_boxes);
+}
+
+bool is_compressed_delta_blob(Span<const uint8_t> p_data) {
+	ZN_PROFILE_SCOPE();
+	if (is_uniform_blob(p_data)) {
+		// Uniform records are stored raw, running them through decompression would only print
+		// errors
+		return false;
+	}
+	// TODO Optimization: peeking the first decompressed byte without a full decompression would
+	// be nicer, but the compression wrappers don't expose that
+	std::vector<uint8_t> &data = tls_data;
+	if (!CompressedData::decompress(p_data, data)) {
+		return false;
+	}
+	return is_delta_blob(to_span_const(data));
+}
+
 bool decompress_and_deserialize(FileAccess &f, unsigned int size_to_read, VoxelBufferInternal &out_voxel_buffer) {
 	ZN_PROFILE_SCOPE();
 
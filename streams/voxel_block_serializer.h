@@ -1,6 +1,7 @@
 #ifndef VOXEL_BLOCK_SERIALIZER_H
 #define VOXEL_BLOCK_SERIALIZER_H
 
+#include "../util/math/box3i.h"
 #include "../util/span.h"
 
 #include <cstdint>
@@ -15,8 +16,9 @@ class VoxelBufferInternal;
 
 namespace BlockSerializer {
 
-// Latest version, used when serializing
-static const uint8_t BLOCK_FORMAT_VERSION = 4;
+// Latest version, used when serializing.
+// Version 5 added the paletted channel compression; version 4 data reads identically.
+static const uint8_t BLOCK_FORMAT_VERSION = 6;
 
 struct SerializeResult {
 	// The lifetime of the pointed object is only valid in the calling thread,
@@ -29,10 +31,39 @@ struct SerializeResult {
 
 SerializeResult serialize(const VoxelBufferInternal &voxel_buffer);
 bool deserialize(Span<const uint8_t> p_data, VoxelBufferInternal &out_voxel_buffer);
+// Partial variant: channels excluded from the mask are skipped without allocating or copying
+// and stay at their defaults, and metadata is not read. Partially-read buffers are for
+// read-only consumption (collision refresh, existence checks, tooling) and must never flow
+// back into a save, which would destroy the skipped channels.
+bool deserialize_channels(
+		Span<const uint8_t> p_data, VoxelBufferInternal &out_voxel_buffer, unsigned int channels_mask);
+
+// Delta blobs store only the edited regions of a block, as a diff against deterministic
+// generator output; loading requires regenerating the block and applying the delta on top.
+// This is what keeps write amplification low for lightly-edited blocks.
+bool is_delta_blob(Span<const uint8_t> p_data);
+SerializeResult serialize_delta(const VoxelBufferInternal &voxel_buffer, Span<const Box3i> boxes);
+SerializeResult serialize_and_compress_delta(const VoxelBufferInternal &voxel_buffer, Span<const Box3i> boxes);
+// Applies the delta's regions onto `voxel_buffer` (expected to already contain generator output)
+// and returns the regions through `out_boxes`
+bool deserialize_delta(
+		Span<const uint8_t> p_data, VoxelBufferInternal &voxel_buffer, std::vector<Box3i> &out_boxes);
+bool decompress_and_deserialize_delta(
+		Span<const uint8_t> p_data, VoxelBufferInternal &voxel_buffer, std::vector<Box3i> &out_boxes);
+// Tells if compressed data holds a delta blob, without fully decompressing it
+bool is_compressed_delta_blob(Span<const uint8_t> p_data);
 
 SerializeResult serialize_and_compress(const VoxelBufferInternal &voxel_buffer);
+// When `archive_compression` is enabled, blocks are compressed with the denser delta-filtered tier
+// (see `CompressedData::COMPRESSION_LZ4_FILTERED`), which trades CPU for smaller long-term saves.
+SerializeResult serialize_and_compress(const VoxelBufferInternal &voxel_buffer, bool archive_compression);
 bool decompress_and_deserialize(Span<const uint8_t> p_data, VoxelBufferInternal &out_voxel_buffer);
 bool decompress_and_deserialize(FileAccess &f, unsigned int size_to_read, VoxelBufferInternal &out_voxel_buffer);
+// Partial variant of `decompress_and_deserialize`, see `deserialize_channels` for the contract.
+// Single-dense-channel saves are stored as independently-compressed sections, so a masked read
+// excluding the dense channel skips its decompression entirely.
+bool decompress_and_deserialize_channels(
+		Span<const uint8_t> p_data, VoxelBufferInternal &out_voxel_buffer, unsigned int channels_mask);
 
 // Temporary thread-local buffers for internal use
 std::vector<uint8_t> &get_tls_data();
@@ -1,5 +1,6 @@
 #include "voxel_block_serializer_gd.h"
 #include "voxel_block_serializer.h"
+#include "../util/math/box3i.h"
 #include <core/io/stream_peer.h>
 
 namespace zylann::voxel::gd {
@@ -50,6 +51,93 @@ void VoxelBlockSerializer::deserialize(Ref<StreamPeer> peer, Ref<VoxelBuffer> vo
 	deserialize(**peer, voxel_buffer->get_buffer(), size, decompress);
 }
 
+namespace {
+const uint8_t DELTA_FORMAT_VERSION = 1;
+}
+
+int VoxelBlockSerializer::_b_serialize_delta(
+		Ref<StreamPeer> peer, Ref<VoxelBuffer> voxel_buffer, Vector3i box_min, Vector3i box_size, int version) {
+	ERR_FAIL_COND_V(voxel_buffer.is_null(), -1);
+	ERR_FAIL_COND_V(peer.is_null(), -1);
+	VoxelBufferInternal &src = voxel_buffer->get_buffer();
+	const Box3i box = Box3i(box_min, box_size).clipped(Box3i(Vector3i(), src.get_size()));
+	ERR_FAIL_COND_V(Vector3iUtil::get_volume(box.size) == 0, -1);
+	ERR_FAIL_COND_V(box.pos.x > 0xffff || box.pos.y > 0xffff || box.pos.z > 0xffff, -1);
+
+	// Extract the edited region into a small buffer and reuse the regular codec on it
+	VoxelBufferInternal sub_buffer;
+	sub_buffer.create(box.size);
+	sub_buffer.copy_format(src);
+	for (unsigned int channel = 0; channel < VoxelBufferInternal::MAX_CHANNELS; ++channel) {
+		sub_buffer.copy_from(src, box.pos, box.pos + box.size, Vector3i(), channel);
+	}
+	sub_buffer.compress_uniform_channels();
+
+	BlockSerializer::SerializeResult res = BlockSerializer::serialize_and_compress(sub_buffer);
+	ERR_FAIL_COND_V(!res.success, -1);
+
+	StreamPeer &p = **peer;
+	p.put_u8(DELTA_FORMAT_VERSION);
+	p.put_u32(uint32_t(version));
+	p.put_u16(box.pos.x);
+	p.put_u16(box.pos.y);
+	p.put_u16(box.pos.z);
+	p.put_u16(box.size.x);
+	p.put_u16(box.size.y);
+	p.put_u16(box.size.z);
+	p.put_u32(res.data.size());
+	p.put_data(res.data.data(), res.data.size());
+	// Header is 17 bytes
+	return 17 + res.data.size();
+}
+
+int VoxelBlockSerializer::_b_deserialize_delta(
+		Ref<StreamPeer> peer, Ref<VoxelBuffer> voxel_buffer, int size, int last_applied_version) {
+	ERR_FAIL_COND_V(voxel_buffer.is_null(), last_applied_version);
+	ERR_FAIL_COND_V(peer.is_null(), last_applied_version);
+	ERR_FAIL_COND_V(size < 17, last_applied_version);
+	StreamPeer &p = **peer;
+
+	const uint8_t format = p.get_u8();
+	ERR_FAIL_COND_V(format != DELTA_FORMAT_VERSION, last_applied_version);
+	const uint32_t version = p.get_u32();
+	Vector3i box_pos;
+	box_pos.x = p.get_u16();
+	box_pos.y = p.get_u16();
+	box_pos.z = p.get_u16();
+	Vector3i box_size;
+	box_size.x = p.get_u16();
+	box_size.y = p.get_u16();
+	box_size.z = p.get_u16();
+	const uint32_t payload_size = p.get_u32();
+	ERR_FAIL_COND_V(int(payload_size) != size - 17, last_applied_version);
+
+	std::vector<uint8_t> &compressed_data = BlockSerializer::get_tls_compressed_data();
+	compressed_data.resize(payload_size);
+	const Error err = p.get_data(compressed_data.data(), compressed_data.size());
+	ERR_FAIL_COND_V(err != OK, last_applied_version);
+
+	// Conflict-safe ordering: out-of-order or duplicate deltas are consumed from the stream but
+	// not applied; the receiver keeps its newer state until a full sync re-baselines
+	const uint32_t last_version = last_applied_version > 0 ? uint32_t(last_applied_version) : 0;
+	if (version <= last_version) {
+		return last_applied_version;
+	}
+
+	VoxelBufferInternal sub_buffer;
+	ERR_FAIL_COND_V(
+			!BlockSerializer::decompress_and_deserialize(to_span(compressed_data), sub_buffer), last_applied_version);
+	ERR_FAIL_COND_V(sub_buffer.get_size() != box_size, last_applied_version);
+
+	VoxelBufferInternal &dst = voxel_buffer->get_buffer();
+	const Box3i box = Box3i(box_pos, box_size).clipped(Box3i(Vector3i(), dst.get_size()));
+	for (unsigned int channel = 0; channel < VoxelBufferInternal::MAX_CHANNELS; ++channel) {
+		dst.copy_from(sub_buffer, Vector3i(), box.size, box.pos, channel);
+	}
+
+	return int(version);
+}
+
 int VoxelBlockSerializer::_b_serialize(Ref<StreamPeer> peer, Ref<VoxelBuffer> voxel_buffer, bool compress) {
 	return serialize(peer, voxel_buffer, compress);
 }
@@ -59,11 +147,33 @@ void VoxelBlockSerializer::_b_deserialize(
 	deserialize(peer, voxel_buffer, size, decompress);
 }
 
+void VoxelBlockSerializer::_b_deserialize_channels(
+		Ref<StreamPeer> peer, Ref<VoxelBuffer> voxel_buffer, int size, int channels_mask) {
+	ERR_FAIL_COND(voxel_buffer.is_null());
+	ERR_FAIL_COND(peer.is_null());
+	ERR_FAIL_COND(size <= 0);
+	std::vector<uint8_t> &compressed_data = BlockSerializer::get_tls_compressed_data();
+	compressed_data.resize(size);
+	const Error err = peer->get_data(compressed_data.data(), compressed_data.size());
+	ERR_FAIL_COND(err != OK);
+	const bool success = BlockSerializer::decompress_and_deserialize_channels(
+			to_span(compressed_data), voxel_buffer->get_buffer(), channels_mask);
+	ERR_FAIL_COND(!success);
+}
+
 void VoxelBlockSerializer::_bind_methods() {
 	ClassDB::bind_method(
 			D_METHOD("serialize", "peer", "voxel_buffer", "compress"), &VoxelBlockSerializer::_b_serialize);
 	ClassDB::bind_method(D_METHOD("deserialize", "peer", "voxel_buffer", "size", "decompress"),
 			&VoxelBlockSerializer::_b_deserialize);
+	ClassDB::bind_method(D_METHOD("deserialize_channels", "peer", "voxel_buffer", "size", "channels_mask"),
+			&VoxelBlockSerializer::_b_deserialize_channels);
+	ClassDB::bind_method(
+			D_METHOD("serialize_delta", "peer", "voxel_buffer", "box_min", "box_size", "version"),
+			&VoxelBlockSerializer::_b_serialize_delta);
+	ClassDB::bind_method(
+			D_METHOD("deserialize_delta", "peer", "voxel_buffer", "size", "last_applied_version"),
+			&VoxelBlockSerializer::_b_deserialize_delta);
 }
 
 } // namespace zylann::voxel::gd
@@ -23,6 +23,19 @@ public:
 private:
 	int _b_serialize(Ref<StreamPeer> peer, Ref<VoxelBuffer> voxel_buffer, bool compress);
 	void _b_deserialize(Ref<StreamPeer> peer, Ref<VoxelBuffer> voxel_buffer, int size, bool decompress);
+	// Partial read: only channels in `channels_mask` are materialized, the rest stay at their
+	// defaults. The result is for read-only use and must not be serialized back.
+	void _b_deserialize_channels(Ref<StreamPeer> peer, Ref<VoxelBuffer> voxel_buffer, int size, int channels_mask);
+
+	// Edit-delta wire format for multiplayer replication: only the edited box of the block
+	// travels ([version][box][compressed sub-buffer]), so a shovel dig costs ~100 bytes instead
+	// of a whole block. `version` is the block's edit version (VoxelTool.get_block_edit_version);
+	// receivers pass their last applied version and stale or duplicate deltas are dropped,
+	// making application order-safe as long as full-block syncs re-baseline.
+	int _b_serialize_delta(Ref<StreamPeer> peer, Ref<VoxelBuffer> voxel_buffer, Vector3i box_min, Vector3i box_size,
+			int version);
+	// Returns the version applied, or `last_applied_version` unchanged when the delta was stale
+	int _b_deserialize_delta(Ref<StreamPeer> peer, Ref<VoxelBuffer> voxel_buffer, int size, int last_applied_version);
 
 	static void _bind_methods();
 };
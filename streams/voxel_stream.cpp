@@ -1,5 +1,6 @@
 #include "voxel_stream.h"
 #include "../storage/voxel_buffer_gd.h"
+#include "../util/macros.h"
 #include <core/object/script_language.h>
 
 using namespace zylann::voxel;
@@ -46,6 +47,78 @@ void VoxelStream::save_instance_blocks(Span<InstancesQueryData> p_blocks) {
 	// Can be implemented in subclasses
 }
 
+bool VoxelStream::erase_blocks_in_box(Vector3i min_block_pos, Vector3i max_block_pos, uint8_t lod) {
+	// Not supported by default
+	return false;
+}
+
+void VoxelStream::flush() {
+	// Default: nothing buffered
+}
+
+void VoxelStream::save_voxel_block_delta(VoxelQueryData &query, Span<const Box3i> dirty_boxes) {
+	// Default: streams without delta support just save the whole block
+	save_voxel_block(query);
+}
+
+void VoxelStream::set_delta_saves_enabled(bool enabled) {
+	RWLockWrite wlock(_parameters_lock);
+	_parameters.delta_saves_enabled = enabled;
+}
+
+bool VoxelStream::is_delta_saves_enabled() const {
+	RWLockRead rlock(_parameters_lock);
+	return _parameters.delta_saves_enabled;
+}
+
+void VoxelStream::record_load_io(Vector3i block_position, int lod, uint64_t duration_usec) {
+	_io_stats.load_count.fetch_add(1, std::memory_order_relaxed);
+	_io_stats.load_time_total_usec.fetch_add(duration_usec, std::memory_order_relaxed);
+	IoStats::update_max(_io_stats.load_time_max_usec, duration_usec);
+
+	const int threshold_ms = get_slow_io_log_threshold_ms();
+	if (threshold_ms > 0 && duration_usec > uint64_t(threshold_ms) * 1000) {
+		_io_stats.slow_op_count.fetch_add(1, std::memory_order_relaxed);
+		WARN_PRINT(String("Slow voxel block load: {0} lod {1} took {2} ms on {3}")
+						   .format(varray(block_position, lod, double(duration_usec) / 1000.0, get_class())));
+	}
+}
+
+void VoxelStream::record_save_io(Vector3i block_position, int lod, uint64_t duration_usec) {
+	_io_stats.save_count.fetch_add(1, std::memory_order_relaxed);
+	_io_stats.save_time_total_usec.fetch_add(duration_usec, std::memory_order_relaxed);
+	IoStats::update_max(_io_stats.save_time_max_usec, duration_usec);
+
+	const int threshold_ms = get_slow_io_log_threshold_ms();
+	if (threshold_ms > 0 && duration_usec > uint64_t(threshold_ms) * 1000) {
+		_io_stats.slow_op_count.fetch_add(1, std::memory_order_relaxed);
+		WARN_PRINT(String("Slow voxel block save: {0} lod {1} took {2} ms on {3}")
+						   .format(varray(block_position, lod, double(duration_usec) / 1000.0, get_class())));
+	}
+}
+
+void VoxelStream::set_slow_io_log_threshold_ms(int threshold_ms) {
+	RWLockWrite wlock(_parameters_lock);
+	_parameters.slow_io_log_threshold_ms = threshold_ms;
+}
+
+int VoxelStream::get_slow_io_log_threshold_ms() const {
+	RWLockRead rlock(_parameters_lock);
+	return _parameters.slow_io_log_threshold_ms;
+}
+
+Dictionary VoxelStream::get_io_statistics() const {
+	Dictionary d;
+	d["load_count"] = ZN_SIZE_T_TO_VARIANT(_io_stats.load_count.load(std::memory_order_relaxed));
+	d["load_time_total_usec"] = ZN_SIZE_T_TO_VARIANT(_io_stats.load_time_total_usec.load(std::memory_order_relaxed));
+	d["load_time_max_usec"] = ZN_SIZE_T_TO_VARIANT(_io_stats.load_time_max_usec.load(std::memory_order_relaxed));
+	d["save_count"] = ZN_SIZE_T_TO_VARIANT(_io_stats.save_count.load(std::memory_order_relaxed));
+	d["save_time_total_usec"] = ZN_SIZE_T_TO_VARIANT(_io_stats.save_time_total_usec.load(std::memory_order_relaxed));
+	d["save_time_max_usec"] = ZN_SIZE_T_TO_VARIANT(_io_stats.save_time_max_usec.load(std::memory_order_relaxed));
+	d["slow_op_count"] = ZN_SIZE_T_TO_VARIANT(_io_stats.slow_op_count.load(std::memory_order_relaxed));
+	return d;
+}
+
 void VoxelStream::load_all_blocks(FullLoadingResult &result) {
 	ERR_PRINT(String("{0} does not support `load_all_blocks`").format(varray(get_class_name())));
 }
@@ -64,6 +137,16 @@ bool VoxelStream::get_save_generator_output() const {
 	return _parameters.save_generator_output;
 }
 
+void VoxelStream::set_archive_compression_enabled(bool enabled) {
+	RWLockWrite wlock(_parameters_lock);
+	_parameters.archive_compression = enabled;
+}
+
+bool VoxelStream::is_archive_compression_enabled() const {
+	RWLockRead rlock(_parameters_lock);
+	return _parameters.archive_compression;
+}
+
 int VoxelStream::get_block_size_po2() const {
 	return constants::DEFAULT_BLOCK_SIZE_PO2;
 }
@@ -126,9 +209,33 @@ void VoxelStream::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_save_generator_output"), &VoxelStream::get_save_generator_output);
 
 	ClassDB::bind_method(D_METHOD("get_block_size"), &VoxelStream::_b_get_block_size);
+	ClassDB::bind_method(D_METHOD("erase_blocks_in_box", "min_block_pos", "max_block_pos", "lod"),
+			&VoxelStream::erase_blocks_in_box);
+
+	ClassDB::bind_method(D_METHOD("set_slow_io_log_threshold_ms", "threshold_ms"),
+			&VoxelStream::set_slow_io_log_threshold_ms);
+	ClassDB::bind_method(
+			D_METHOD("get_slow_io_log_threshold_ms"), &VoxelStream::get_slow_io_log_threshold_ms);
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "slow_io_log_threshold_ms", PROPERTY_HINT_RANGE, "0,10000,1"),
+			"set_slow_io_log_threshold_ms", "get_slow_io_log_threshold_ms");
+
+	ClassDB::bind_method(D_METHOD("get_io_statistics"), &VoxelStream::get_io_statistics);
+
+	ClassDB::bind_method(
+			D_METHOD("set_delta_saves_enabled", "enabled"), &VoxelStream::set_delta_saves_enabled);
+	ClassDB::bind_method(D_METHOD("is_delta_saves_enabled"), &VoxelStream::is_delta_saves_enabled);
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "delta_saves_enabled"), "set_delta_saves_enabled",
+			"is_delta_saves_enabled");
+
+	ClassDB::bind_method(D_METHOD("set_archive_compression_enabled", "enabled"),
+			&VoxelStream::set_archive_compression_enabled);
+	ClassDB::bind_method(
+			D_METHOD("is_archive_compression_enabled"), &VoxelStream::is_archive_compression_enabled);
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "save_generator_output"), "set_save_generator_output",
 			"get_save_generator_output");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "archive_compression_enabled"), "set_archive_compression_enabled",
+			"is_archive_compression_enabled");
 
 	BIND_ENUM_CONSTANT(RESULT_ERROR);
 	BIND_ENUM_CONSTANT(RESULT_BLOCK_FOUND);
@@ -1,12 +1,16 @@
 #ifndef VOXEL_STREAM_H
 #define VOXEL_STREAM_H
 
+#include "../util/math/box3i.h"
 #include "../util/memory.h"
+#include "../util/span.h"
 #include "../util/thread/rw_lock.h"
 #include "instance_data.h"
 
 #include <core/io/resource.h>
 
+#include <atomic>
+
 namespace zylann::voxel {
 
 class VoxelBufferInternal;
@@ -38,6 +42,10 @@ public:
 		RESULT_BLOCK_NOT_FOUND,
 		// The block was found, so the requester won't use the generator.
 		RESULT_BLOCK_FOUND,
+		// The stored data was a delta against generator output; only the regions reported through
+		// `VoxelQueryData::delta_boxes` were written into the buffer, the requester must generate
+		// the rest underneath them.
+		RESULT_BLOCK_FOUND_PARTIAL,
 
 		_RESULT_COUNT
 	};
@@ -48,6 +56,10 @@ public:
 		int lod;
 		// This is currently not used in save queries. Maybe it should?
 		ResultCode result;
+		// Only loads: when non-null and the stored data is a delta against generator output
+		// (see delta saves), the stream fills these with the stored regions, writes them into
+		// the buffer, and returns RESULT_BLOCK_FOUND_PARTIAL. The caller must generate the rest.
+		std::vector<Box3i> *delta_boxes = nullptr;
 	};
 
 	struct InstancesQueryData {
@@ -79,6 +91,77 @@ public:
 	virtual void load_instance_blocks(Span<InstancesQueryData> out_blocks);
 	virtual void save_instance_blocks(Span<InstancesQueryData> p_blocks);
 
+	// Makes sure data previously saved through this stream has been written out, in case the
+	// implementation holds saves in memory to batch them. Blocking call.
+	virtual void flush();
+
+	// Whether blocks of differing channel depths can be saved (database-style backends).
+	// Region-style formats declare fixed depths applying to every block and return false.
+	virtual bool supports_variable_block_depths() const {
+		return true;
+	}
+
+	// Bulk-erases every saved block within the given box of block coordinates (max exclusive) at
+	// the given LOD, at the storage level. Returns false when the backend doesn't support it, in
+	// which case callers fall back on saving empties block by block. World resets use this to
+	// avoid minutes of pointless serialization.
+	virtual bool erase_blocks_in_box(Vector3i min_block_pos, Vector3i max_block_pos, uint8_t lod);
+
+	// Tells if this stream can store lightly-edited blocks as deltas against generator output.
+	// See `set_delta_saves_enabled`.
+	virtual bool supports_delta_saves() const {
+		return false;
+	}
+
+	// Saves only the given edited regions of a block, as a delta against deterministic generator
+	// output. Streams not supporting it (or when the feature is off) fall back to a full save.
+	virtual void save_voxel_block_delta(VoxelQueryData &query, Span<const Box3i> dirty_boxes);
+
+	// Cumulative I/O timing, recorded by the streaming tasks around every block load/save. Lets
+	// production separate storage latency (network databases...) from scheduling problems.
+	// Thread-safe.
+	struct IoStats {
+		std::atomic_uint64_t load_count = { 0 };
+		std::atomic_uint64_t load_time_total_usec = { 0 };
+		std::atomic_uint64_t load_time_max_usec = { 0 };
+		std::atomic_uint64_t save_count = { 0 };
+		std::atomic_uint64_t save_time_total_usec = { 0 };
+		std::atomic_uint64_t save_time_max_usec = { 0 };
+		std::atomic_uint64_t slow_op_count = { 0 };
+
+		static void update_max(std::atomic_uint64_t &max_value, uint64_t v) {
+			uint64_t cur = max_value.load(std::memory_order_relaxed);
+			while (v > cur && !max_value.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {
+			}
+		}
+	};
+
+	IoStats &get_io_stats() {
+		return _io_stats;
+	}
+	const IoStats &get_io_stats() const {
+		return _io_stats;
+	}
+
+	// Records one operation's duration, logging it when it exceeds the slow threshold
+	void record_load_io(Vector3i block_position, int lod, uint64_t duration_usec);
+	void record_save_io(Vector3i block_position, int lod, uint64_t duration_usec);
+
+	// Operations slower than this get logged with their position and duration. 0 disables logging
+	// (counters keep accumulating).
+	void set_slow_io_log_threshold_ms(int threshold_ms);
+	int get_slow_io_log_threshold_ms() const;
+
+	// Script-facing counters snapshot
+	Dictionary get_io_statistics() const;
+
+	// When enabled on a supporting stream, blocks whose edits are tracked get saved as compact
+	// deltas against generator output, cutting write amplification of small edits. Requires the
+	// volume to use a deterministic generator. Disables bulk full loading, so it is incompatible
+	// with full load mode.
+	void set_delta_saves_enabled(bool enabled);
+	bool is_delta_saves_enabled() const;
+
 	struct FullLoadingResult {
 		struct Block {
 			std::shared_ptr<VoxelBufferInternal> voxels;
@@ -113,6 +196,12 @@ public:
 	void set_save_generator_output(bool enabled);
 	bool get_save_generator_output() const;
 
+	// When enabled, saved blocks use a denser but slower compression tier (delta-filtered LZ4)
+	// better suited for long-term archival of large worlds than the default. Files written either
+	// way load back transparently.
+	void set_archive_compression_enabled(bool enabled);
+	bool is_archive_compression_enabled() const;
+
 private:
 	static void _bind_methods();
 
@@ -126,10 +215,14 @@ private:
 
 	struct Parameters {
 		bool save_generator_output = false;
+		bool archive_compression = false;
+		bool delta_saves_enabled = false;
+		int slow_io_log_threshold_ms = 100;
 	};
 
 	Parameters _parameters;
 	RWLock _parameters_lock;
+	IoStats _io_stats;
 };
 
 } // namespace zylann::voxel
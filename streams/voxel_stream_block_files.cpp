@@ -145,7 +145,8 @@ void VoxelStreamBlockFiles::save_voxel_block(VoxelStream::VoxelQueryData &q) {
 		f->store_buffer((uint8_t *)FORMAT_BLOCK_MAGIC, 4);
 		f->store_8(FORMAT_VERSION);
 
-		BlockSerializer::SerializeResult res = BlockSerializer::serialize_and_compress(q.voxel_buffer);
+		BlockSerializer::SerializeResult res =
+				BlockSerializer::serialize_and_compress(q.voxel_buffer, is_archive_compression_enabled());
 		if (!res.success) {
 			ERR_PRINT("Failed to save block");
 			return;
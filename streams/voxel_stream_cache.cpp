@@ -2,14 +2,30 @@
 
 namespace zylann::voxel {
 
+namespace {
+// Approximate payload size of a buffer: allocated channel data, whatever its storage format
+uint64_t estimate_buffer_bytes(const VoxelBufferInternal &vb) {
+	uint64_t total = 0;
+	for (unsigned int channel = 0; channel < VoxelBufferInternal::MAX_CHANNELS; ++channel) {
+		Span<const uint8_t> data;
+		if (vb.get_channel_raw_read_only(channel, data)) {
+			total += data.size();
+		}
+	}
+	return total;
+}
+} // namespace
+
 bool VoxelStreamCache::load_voxel_block(Vector3i position, uint8_t lod_index, VoxelBufferInternal &out_voxels) {
-	const Lod &lod = _cache[lod_index];
-	lod.rw_lock.read_lock();
-	auto it = lod.blocks.find(position);
+	Lod &lod = _cache[lod_index];
+	Shard &shard = lod.shards[get_shard_index(position)];
+	shard.rw_lock.read_lock();
+	auto it = shard.blocks.find(position);
 
-	if (it == lod.blocks.end()) {
+	if (it == shard.blocks.end()) {
 		// Not in cache, will have to query
-		lod.rw_lock.read_unlock();
+		shard.rw_lock.read_unlock();
+		_miss_count.fetch_add(1, std::memory_order_relaxed);
 		return false;
 
 	} else {
@@ -21,17 +37,30 @@ bool VoxelStreamCache::load_voxel_block(Vector3i position, uint8_t lod_index, Vo
 		// and the requests wants us to populate the buffer it provides
 		vb.duplicate_to(out_voxels, true);
 
-		lod.rw_lock.read_unlock();
+		shard.rw_lock.read_unlock();
+		_hit_count.fetch_add(1, std::memory_order_relaxed);
 		return true;
 	}
 }
 
+bool VoxelStreamCache::has_voxel_block(Vector3i position, uint8_t lod_index) {
+	Lod &lod = _cache[lod_index];
+	Shard &shard = lod.shards[get_shard_index(position)];
+	shard.rw_lock.read_lock();
+	auto it = shard.blocks.find(position);
+	const bool found = it != shard.blocks.end() && it->second.has_voxels;
+	shard.rw_lock.read_unlock();
+	return found;
+}
+
 void VoxelStreamCache::save_voxel_block(Vector3i position, uint8_t lod_index, VoxelBufferInternal &voxels) {
 	Lod &lod = _cache[lod_index];
-	RWLockWrite wlock(lod.rw_lock);
-	auto it = lod.blocks.find(position);
+	Shard &shard = lod.shards[get_shard_index(position)];
+	const uint64_t incoming_bytes = estimate_buffer_bytes(voxels);
+	RWLockWrite wlock(shard.rw_lock);
+	auto it = shard.blocks.find(position);
 
-	if (it == lod.blocks.end()) {
+	if (it == shard.blocks.end()) {
 		// Not cached yet, create an entry
 		Block b;
 		b.position = position;
@@ -39,25 +68,49 @@ void VoxelStreamCache::save_voxel_block(Vector3i position, uint8_t lod_index, Vo
 		// TODO Optimization: if we know the buffer is not shared, we could use move instead
 		voxels.duplicate_to(b.voxels, true);
 		b.has_voxels = true;
-		lod.blocks.insert(std::make_pair(position, std::move(b)));
+		shard.blocks.insert(std::make_pair(position, std::move(b)));
 		++_count;
+		_memory_usage.fetch_add(incoming_bytes, std::memory_order_relaxed);
 
 	} else {
 		// Cached already, overwrite
+		const uint64_t previous_bytes = estimate_buffer_bytes(it->second.voxels);
 		voxels.move_to(it->second.voxels);
 		it->second.has_voxels = true;
+		// A full save supersedes any pending delta
+		it->second.is_delta = false;
+		it->second.delta_boxes.clear();
+		_memory_usage.fetch_add(incoming_bytes, std::memory_order_relaxed);
+		_memory_usage.fetch_sub(previous_bytes, std::memory_order_relaxed);
+	}
+}
+
+void VoxelStreamCache::save_voxel_block_delta(
+		Vector3i position, uint8_t lod_index, VoxelBufferInternal &voxels, Span<const Box3i> delta_boxes) {
+	save_voxel_block(position, lod_index, voxels);
+	Lod &lod = _cache[lod_index];
+	Shard &shard = lod.shards[get_shard_index(position)];
+	RWLockWrite wlock(shard.rw_lock);
+	auto it = shard.blocks.find(position);
+	ERR_FAIL_COND(it == shard.blocks.end());
+	Block &b = it->second;
+	b.is_delta = true;
+	b.delta_boxes.clear();
+	for (unsigned int i = 0; i < delta_boxes.size(); ++i) {
+		b.delta_boxes.push_back(delta_boxes[i]);
 	}
 }
 
 bool VoxelStreamCache::load_instance_block(
 		Vector3i position, uint8_t lod_index, UniquePtr<InstanceBlockData> &out_instances) {
-	const Lod &lod = _cache[lod_index];
-	lod.rw_lock.read_lock();
-	auto it = lod.blocks.find(position);
+	Lod &lod = _cache[lod_index];
+	Shard &shard = lod.shards[get_shard_index(position)];
+	shard.rw_lock.read_lock();
+	auto it = shard.blocks.find(position);
 
-	if (it == lod.blocks.end()) {
+	if (it == shard.blocks.end()) {
 		// Not in cache, will have to query
-		lod.rw_lock.read_unlock();
+		shard.rw_lock.read_unlock();
 		return false;
 
 	} else {
@@ -72,7 +125,7 @@ bool VoxelStreamCache::load_instance_block(
 			it->second.instances->copy_to(*out_instances);
 		}
 
-		lod.rw_lock.read_unlock();
+		shard.rw_lock.read_unlock();
 		return true;
 	}
 }
@@ -80,16 +133,17 @@ bool VoxelStreamCache::load_instance_block(
 void VoxelStreamCache::save_instance_block(
 		Vector3i position, uint8_t lod_index, UniquePtr<InstanceBlockData> instances) {
 	Lod &lod = _cache[lod_index];
-	RWLockWrite wlock(lod.rw_lock);
-	auto it = lod.blocks.find(position);
+	Shard &shard = lod.shards[get_shard_index(position)];
+	RWLockWrite wlock(shard.rw_lock);
+	auto it = shard.blocks.find(position);
 
-	if (it == lod.blocks.end()) {
+	if (it == shard.blocks.end()) {
 		// Not cached yet, create an entry
 		Block b;
 		b.position = position;
 		b.lod = lod_index;
 		b.instances = std::move(instances);
-		lod.blocks.insert(std::make_pair(position, std::move(b)));
+		shard.blocks.insert(std::make_pair(position, std::move(b)));
 		++_count;
 
 	} else {
@@ -4,6 +4,7 @@
 #include "../storage/voxel_buffer_internal.h"
 #include "../util/memory.h"
 #include "instance_data.h"
+#include <atomic>
 #include <unordered_map>
 
 namespace zylann::voxel {
@@ -24,13 +25,24 @@ public:
 
 		VoxelBufferInternal voxels;
 		UniquePtr<InstanceBlockData> instances;
+
+		// When set, `voxels` still holds the full block, but only `delta_boxes` diverge from
+		// generator output, so flushing stores them as a compact delta blob
+		bool is_delta = false;
+		std::vector<Box3i> delta_boxes;
 	};
 
 	// Copies cached block into provided buffer
 	bool load_voxel_block(Vector3i position, uint8_t lod_index, VoxelBufferInternal &out_voxels);
 
+	// Tells if a block with voxel data is present, without copying it
+	bool has_voxel_block(Vector3i position, uint8_t lod_index);
+
 	// Stores provided block into the cache. The cache will take ownership of the provided data.
 	void save_voxel_block(Vector3i position, uint8_t lod_index, VoxelBufferInternal &voxels);
+	// Same, but marks the block to be stored as a delta against generator output
+	void save_voxel_block_delta(
+			Vector3i position, uint8_t lod_index, VoxelBufferInternal &voxels, Span<const Box3i> delta_boxes);
 
 	// Copies cached data into the provided pointer. A new instance will be made if found.
 	bool load_instance_block(Vector3i position, uint8_t lod_index, UniquePtr<InstanceBlockData> &out_instances);
@@ -40,29 +52,81 @@ public:
 
 	unsigned int get_indicative_block_count() const;
 
+	// Approximate bytes held by cached voxel payloads, maintained on insert/overwrite/flush.
+	// Owners use it to trigger a flush when the cache grows past their memory cap, since every
+	// entry is a pending save and can't be dropped, only written out.
+	uint64_t get_memory_usage() const {
+		return _memory_usage.load(std::memory_order_relaxed);
+	}
+
+	// Lifetime load statistics
+	uint64_t get_hit_count() const {
+		return _hit_count.load(std::memory_order_relaxed);
+	}
+	uint64_t get_miss_count() const {
+		return _miss_count.load(std::memory_order_relaxed);
+	}
+
+	// Moves all cached blocks out, in no particular order. Same semantics as `flush`, but lets the
+	// caller process blocks after the cache is released, for example to serialize them in parallel.
+	void flush_to(std::vector<Block> &out_blocks) {
+		for (unsigned int lod_index = 0; lod_index < _cache.size(); ++lod_index) {
+			Lod &lod = _cache[lod_index];
+			for (unsigned int shard_index = 0; shard_index < SHARD_COUNT; ++shard_index) {
+				Shard &shard = lod.shards[shard_index];
+				RWLockWrite wlock(shard.rw_lock);
+				for (auto it = shard.blocks.begin(); it != shard.blocks.end(); ++it) {
+					out_blocks.push_back(std::move(it->second));
+				}
+				shard.blocks.clear();
+			}
+		}
+		_count = 0;
+		_memory_usage.store(0, std::memory_order_relaxed);
+	}
+
 	template <typename F>
 	void flush(F save_func) {
 		_count = 0;
 		for (unsigned int lod_index = 0; lod_index < _cache.size(); ++lod_index) {
 			Lod &lod = _cache[lod_index];
-			RWLockWrite wlock(lod.rw_lock);
-			for (auto it = lod.blocks.begin(); it != lod.blocks.end(); ++it) {
-				Block &block = it->second;
-				save_func(block);
+			for (unsigned int shard_index = 0; shard_index < SHARD_COUNT; ++shard_index) {
+				Shard &shard = lod.shards[shard_index];
+				RWLockWrite wlock(shard.rw_lock);
+				for (auto it = shard.blocks.begin(); it != shard.blocks.end(); ++it) {
+					Block &block = it->second;
+					save_func(block);
+				}
+				shard.blocks.clear();
 			}
-			lod.blocks.clear();
 		}
+		_memory_usage.store(0, std::memory_order_relaxed);
 	}
 
 private:
-	struct Lod {
+	// Position-hashed shards so concurrent saves and loads in different areas don't contend on
+	// one lock per LOD. Power of two.
+	static const unsigned int SHARD_COUNT = 16;
+
+	struct Shard {
 		// Not using pointers for values, since unordered_map does not invalidate pointers to values
 		std::unordered_map<Vector3i, Block> blocks;
 		RWLock rw_lock;
 	};
 
+	struct Lod {
+		FixedArray<Shard, SHARD_COUNT> shards;
+	};
+
+	static inline unsigned int get_shard_index(Vector3i position) {
+		return Vector3iHasher::hash(position) & (SHARD_COUNT - 1);
+	}
+
 	FixedArray<Lod, constants::MAX_LOD> _cache;
 	unsigned int _count = 0;
+	std::atomic_uint64_t _memory_usage = { 0 };
+	std::atomic_uint64_t _hit_count = { 0 };
+	std::atomic_uint64_t _miss_count = { 0 };
 };
 
 } // namespace zylann::voxel
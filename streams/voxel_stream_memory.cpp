@@ -0,0 +1,226 @@
+#include "voxel_stream_memory.h"
+#include "../storage/voxel_buffer_internal.h"
+#include "../util/math/conv.h"
+#include "../util/memory.h"
+#include "../util/profiling.h"
+#include "instance_data.h"
+#include "voxel_block_serializer.h"
+
+namespace zylann::voxel {
+
+void VoxelStreamMemory::load_voxel_block(VoxelStream::VoxelQueryData &q) {
+	load_voxel_blocks(Span<VoxelStream::VoxelQueryData>(&q, 1));
+}
+
+void VoxelStreamMemory::save_voxel_block(VoxelStream::VoxelQueryData &q) {
+	save_voxel_blocks(Span<VoxelStream::VoxelQueryData>(&q, 1));
+}
+
+void VoxelStreamMemory::load_voxel_blocks(Span<VoxelStream::VoxelQueryData> p_blocks) {
+	ZN_PROFILE_SCOPE();
+	const unsigned int block_size_po2 = get_block_size_po2();
+
+	MutexLock lock(_mutex);
+	for (unsigned int i = 0; i < p_blocks.size(); ++i) {
+		VoxelStream::VoxelQueryData &q = p_blocks[i];
+		ERR_CONTINUE(q.lod < 0 || q.lod >= int(_lods.size()));
+		const Lod &lod = _lods[q.lod];
+		const Vector3i block_pos = q.origin_in_voxels >> (block_size_po2 + q.lod);
+
+		auto it = lod.voxel_blocks.find(block_pos);
+		if (it == lod.voxel_blocks.end()) {
+			q.result = RESULT_BLOCK_NOT_FOUND;
+			continue;
+		}
+		if (!BlockSerializer::decompress_and_deserialize(to_span_const(it->second.data), q.voxel_buffer)) {
+			q.result = RESULT_ERROR;
+			continue;
+		}
+		q.result = RESULT_BLOCK_FOUND;
+	}
+}
+
+void VoxelStreamMemory::save_voxel_blocks(Span<VoxelStream::VoxelQueryData> p_blocks) {
+	ZN_PROFILE_SCOPE();
+	const unsigned int block_size_po2 = get_block_size_po2();
+
+	for (unsigned int i = 0; i < p_blocks.size(); ++i) {
+		VoxelStream::VoxelQueryData &q = p_blocks[i];
+		ERR_CONTINUE(q.lod < 0 || q.lod >= int(_lods.size()));
+
+		// Serialization happens outside the lock, only the map insert is guarded
+		BlockSerializer::SerializeResult res = BlockSerializer::serialize_and_compress(q.voxel_buffer);
+		ERR_CONTINUE(!res.success);
+
+		const Vector3i block_pos = q.origin_in_voxels >> (block_size_po2 + q.lod);
+
+		MutexLock lock(_mutex);
+		Lod &lod = _lods[q.lod];
+		StoredBlock &block = lod.voxel_blocks[block_pos];
+		_memory_usage -= block.data.size();
+		block.data = res.data;
+		block.save_id = _next_save_id++;
+		_memory_usage += block.data.size();
+		_eviction_queue.push_back(EvictionEntry{ block_pos, block.save_id, uint8_t(q.lod) });
+
+		// Re-saves leave stale entries behind; compact when they dominate so a long uncapped
+		// session doesn't grow the queue unboundedly
+		size_t live_block_count = 0;
+		for (unsigned int lod_index = 0; lod_index < _lods.size(); ++lod_index) {
+			live_block_count += _lods[lod_index].voxel_blocks.size();
+		}
+		if (_eviction_queue.size() > 64 && _eviction_queue.size() > 8 * live_block_count) {
+			std::deque<EvictionEntry> compacted;
+			for (const EvictionEntry &entry : _eviction_queue) {
+				auto entry_it = _lods[entry.lod].voxel_blocks.find(entry.position);
+				if (entry_it != _lods[entry.lod].voxel_blocks.end() && entry_it->second.save_id == entry.save_id) {
+					compacted.push_back(entry);
+				}
+			}
+			_eviction_queue = std::move(compacted);
+		}
+
+		evict_while_over_cap();
+	}
+}
+
+bool VoxelStreamMemory::supports_instance_blocks() const {
+	return true;
+}
+
+void VoxelStreamMemory::load_instance_blocks(Span<VoxelStream::InstancesQueryData> out_blocks) {
+	ZN_PROFILE_SCOPE();
+	MutexLock lock(_mutex);
+	for (unsigned int i = 0; i < out_blocks.size(); ++i) {
+		VoxelStream::InstancesQueryData &q = out_blocks[i];
+		ERR_CONTINUE(q.lod >= _lods.size());
+		const Lod &lod = _lods[q.lod];
+
+		auto it = lod.instance_blocks.find(q.position);
+		if (it == lod.instance_blocks.end()) {
+			q.result = RESULT_BLOCK_NOT_FOUND;
+			continue;
+		}
+		q.data = make_unique_instance<InstanceBlockData>();
+		if (!deserialize_instance_block_data(*q.data, to_span_const(it->second))) {
+			q.data = nullptr;
+			q.result = RESULT_ERROR;
+			continue;
+		}
+		q.result = RESULT_BLOCK_FOUND;
+	}
+}
+
+void VoxelStreamMemory::save_instance_blocks(Span<VoxelStream::InstancesQueryData> p_blocks) {
+	ZN_PROFILE_SCOPE();
+	for (unsigned int i = 0; i < p_blocks.size(); ++i) {
+		VoxelStream::InstancesQueryData &q = p_blocks[i];
+		ERR_CONTINUE(q.lod >= _lods.size());
+
+		std::vector<uint8_t> data;
+		if (q.data != nullptr) {
+			ERR_CONTINUE(!serialize_instance_block_data(*q.data, data));
+		}
+
+		MutexLock lock(_mutex);
+		Lod &lod = _lods[q.lod];
+		if (data.size() == 0) {
+			// Null data means the block has no instances anymore
+			auto it = lod.instance_blocks.find(q.position);
+			if (it != lod.instance_blocks.end()) {
+				_memory_usage -= it->second.size();
+				lod.instance_blocks.erase(it);
+			}
+			continue;
+		}
+		std::vector<uint8_t> &stored = lod.instance_blocks[q.position];
+		_memory_usage -= stored.size();
+		stored = std::move(data);
+		_memory_usage += stored.size();
+	}
+}
+
+bool VoxelStreamMemory::erase_blocks_in_box(Vector3i min_block_pos, Vector3i max_block_pos, uint8_t lod_index) {
+	ZN_PROFILE_SCOPE();
+	ERR_FAIL_COND_V(lod_index >= _lods.size(), false);
+	const Box3i box = Box3i::from_min_max(min_block_pos, max_block_pos);
+
+	MutexLock lock(_mutex);
+	Lod &lod = _lods[lod_index];
+	for (auto it = lod.voxel_blocks.begin(); it != lod.voxel_blocks.end();) {
+		if (box.contains(it->first)) {
+			_memory_usage -= it->second.data.size();
+			it = lod.voxel_blocks.erase(it);
+		} else {
+			++it;
+		}
+	}
+	for (auto it = lod.instance_blocks.begin(); it != lod.instance_blocks.end();) {
+		if (box.contains(it->first)) {
+			_memory_usage -= it->second.size();
+			it = lod.instance_blocks.erase(it);
+		} else {
+			++it;
+		}
+	}
+	return true;
+}
+
+void VoxelStreamMemory::evict_while_over_cap() {
+	// Caller must hold `_mutex`
+	if (_memory_cap_mb == 0) {
+		return;
+	}
+	const size_t cap_bytes = size_t(_memory_cap_mb) * 1024 * 1024;
+	while (_memory_usage > cap_bytes && _eviction_queue.size() > 0) {
+		const EvictionEntry entry = _eviction_queue.front();
+		_eviction_queue.pop_front();
+		Lod &lod = _lods[entry.lod];
+		auto it = lod.voxel_blocks.find(entry.position);
+		if (it == lod.voxel_blocks.end() || it->second.save_id != entry.save_id) {
+			// Erased since, or re-saved (a fresh entry exists further down the queue)
+			continue;
+		}
+		// The block falls back to generator output on its next load
+		_memory_usage -= it->second.data.size();
+		lod.voxel_blocks.erase(it);
+	}
+}
+
+void VoxelStreamMemory::set_memory_cap_mb(int mb) {
+	ERR_FAIL_COND(mb < 0);
+	MutexLock lock(_mutex);
+	_memory_cap_mb = mb;
+	evict_while_over_cap();
+}
+
+int VoxelStreamMemory::get_memory_cap_mb() const {
+	return _memory_cap_mb;
+}
+
+int64_t VoxelStreamMemory::get_memory_usage() const {
+	MutexLock lock(_mutex);
+	return int64_t(_memory_usage);
+}
+
+void VoxelStreamMemory::clear() {
+	MutexLock lock(_mutex);
+	for (unsigned int i = 0; i < _lods.size(); ++i) {
+		_lods[i].voxel_blocks.clear();
+		_lods[i].instance_blocks.clear();
+	}
+	_eviction_queue.clear();
+	_memory_usage = 0;
+}
+
+void VoxelStreamMemory::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_memory_cap_mb", "mb"), &VoxelStreamMemory::set_memory_cap_mb);
+	ClassDB::bind_method(D_METHOD("get_memory_cap_mb"), &VoxelStreamMemory::get_memory_cap_mb);
+	ClassDB::bind_method(D_METHOD("get_memory_usage"), &VoxelStreamMemory::get_memory_usage);
+	ClassDB::bind_method(D_METHOD("clear"), &VoxelStreamMemory::clear);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "memory_cap_mb", PROPERTY_HINT_RANGE, "0,4096,1"),
+			"set_memory_cap_mb", "get_memory_cap_mb");
+}
+
+} // namespace zylann::voxel
@@ -0,0 +1,84 @@
+#ifndef VOXEL_STREAM_MEMORY_H
+#define VOXEL_STREAM_MEMORY_H
+
+#include "../constants/voxel_constants.h"
+#include "../util/fixed_array.h"
+#include "../util/math/vector3i.h"
+#include "../util/thread/mutex.h"
+#include "voxel_stream.h"
+
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+namespace zylann::voxel {
+
+// Keeps saved blocks in memory (LZ4-compressed), with no disk I/O at all.
+// For sessions editing terrain heavily without ever persisting it (minigame rounds, test maps):
+// running such a session on a file-backed stream wastes I/O on data that dies with the round,
+// while running with no stream loses the whole edit-tracking machinery. Everything vanishes when
+// the resource is freed.
+// An optional memory cap bounds the footprint; when exceeded, the oldest saves are dropped and
+// those blocks fall back to generator output on their next load (their edits are lost, which is
+// the accepted trade-off of capping an ephemeral session).
+class VoxelStreamMemory : public VoxelStream {
+	GDCLASS(VoxelStreamMemory, VoxelStream)
+public:
+	void load_voxel_block(VoxelStream::VoxelQueryData &q) override;
+	void save_voxel_block(VoxelStream::VoxelQueryData &q) override;
+	void load_voxel_blocks(Span<VoxelStream::VoxelQueryData> p_blocks) override;
+	void save_voxel_blocks(Span<VoxelStream::VoxelQueryData> p_blocks) override;
+
+	bool supports_instance_blocks() const override;
+	void load_instance_blocks(Span<VoxelStream::InstancesQueryData> out_blocks) override;
+	void save_instance_blocks(Span<VoxelStream::InstancesQueryData> p_blocks) override;
+
+	bool erase_blocks_in_box(Vector3i min_block_pos, Vector3i max_block_pos, uint8_t lod) override;
+
+	// 0 disables the cap
+	void set_memory_cap_mb(int mb);
+	int get_memory_cap_mb() const;
+
+	// Current compressed footprint of all stored blocks, in bytes
+	int64_t get_memory_usage() const;
+	// Drops everything, as if the stream was freshly created
+	void clear();
+
+protected:
+	static void _bind_methods();
+
+private:
+	void evict_while_over_cap();
+
+	struct StoredBlock {
+		std::vector<uint8_t> data;
+		// Increments on every save; eviction entries referring to an older save are stale
+		uint64_t save_id = 0;
+	};
+
+	struct EvictionEntry {
+		Vector3i position;
+		uint64_t save_id;
+		uint8_t lod;
+	};
+
+	struct Lod {
+		std::unordered_map<Vector3i, StoredBlock> voxel_blocks;
+		std::unordered_map<Vector3i, std::vector<uint8_t>> instance_blocks;
+	};
+
+	// Everything behind one mutex: operations are memcpy-and-hash cheap, so contention is far
+	// below what sharding would be worth
+	mutable Mutex _mutex;
+	FixedArray<Lod, constants::MAX_LOD> _lods;
+	// Voxel saves in order, oldest first. Re-saved blocks get a fresh entry; stale ones are
+	// recognized by their save id and skipped when popped.
+	std::deque<EvictionEntry> _eviction_queue;
+	uint64_t _next_save_id = 1;
+	size_t _memory_usage = 0;
+	unsigned int _memory_cap_mb = 0;
+};
+
+} // namespace zylann::voxel
+
+#endif // VOXEL_STREAM_MEMORY_H
@@ -1,4 +1,6 @@
 #include "voxel_box_mover.h"
+
+#include <core/config/engine.h>
 #include "../../meshers/blocky/voxel_mesher_blocky.h"
 #include "../../meshers/cubes/voxel_mesher_cubes.h"
 #include "../../util/godot/funcs.h"
@@ -152,6 +154,34 @@ Vector3 VoxelBoxMover::get_motion(Vector3 p_pos, Vector3 p_motion, AABB p_aabb,
 
 	Vector3i i(min_x, min_y, min_z);
 
+	// Copy-on-write snapshot of the queried area: each block is locked once for a refcount bump,
+	// then every voxel read below is lock-free. The per-voxel reads used to take a lock each,
+	// stalling physics whenever a big async edit held the write side of a buffer.
+	// Swarms of creatures query overlapping regions many times per tick, so the snapshot is
+	// reused within the same physics frame when the new envelope fits the captured one.
+	const Box3i envelope_box(
+			Vector3i(min_x, min_y, min_z), Vector3i(max_x - min_x, max_y - min_y, max_z - min_z));
+	static thread_local VoxelDataMapSnapshot tls_snapshot;
+	static thread_local Box3i tls_snapshot_box;
+	static thread_local uint64_t tls_snapshot_frame = 0;
+	static thread_local ObjectID tls_snapshot_terrain;
+	const uint64_t physics_frame = Engine::get_singleton()->get_physics_frames();
+	if (tls_snapshot_frame != physics_frame || tls_snapshot_terrain != p_terrain->get_instance_id() ||
+			!tls_snapshot_box.encloses(envelope_box)) {
+		// Capture with one block of margin so nearby follow-up queries hit the cache
+		const Box3i capture_box = envelope_box.padded(int(voxels.get_block_size()));
+		voxels.capture_snapshot(capture_box, tls_snapshot);
+		tls_snapshot_box = capture_box;
+		tls_snapshot_frame = physics_frame;
+		tls_snapshot_terrain = p_terrain->get_instance_id();
+	}
+	const VoxelDataMapSnapshot &snapshot = tls_snapshot;
+
+	// Single gather of the whole envelope into a flat buffer; block resolution happens once per
+	// block and the occupancy scans below become tight compare loops over local memory
+	static thread_local std::vector<uint64_t> tls_gathered;
+	tls_gathered.resize(Vector3iUtil::get_volume(envelope_box.size));
+
 	Ref<VoxelMesherBlocky> mesher_blocky;
 	Ref<VoxelMesherCubes> mesher_cubes;
 
@@ -160,11 +190,16 @@ Vector3 VoxelBoxMover::get_motion(Vector3 p_pos, Vector3 p_motion, AABB p_aabb,
 		ERR_FAIL_COND_V_MSG(library_ref.is_null(), Vector3(), "VoxelMesherBlocky has no library assigned");
 		VoxelBlockyLibrary &library = **library_ref;
 		const int channel = VoxelBufferInternal::CHANNEL_TYPE;
+		const uint64_t default_voxel = voxels.get_default_voxel(channel);
+		snapshot.gather_box(envelope_box, channel, default_voxel, to_span(tls_gathered));
 
+		// ZXY iteration matches the gathered buffer's layout, so the index just increments
+		unsigned int gathered_index = 0;
 		for (i.z = min_z; i.z < max_z; ++i.z) {
-			for (i.y = min_y; i.y < max_y; ++i.y) {
-				for (i.x = min_x; i.x < max_x; ++i.x) {
-					const int type_id = voxels.get_voxel(i, channel);
+			for (i.x = min_x; i.x < max_x; ++i.x) {
+				for (i.y = min_y; i.y < max_y; ++i.y) {
+					const int type_id = tls_gathered[gathered_index];
+					++gathered_index;
 
 					if (library.has_voxel(type_id)) {
 						const VoxelBlockyModel &voxel_type = library.get_voxel_const(type_id);
@@ -187,14 +222,19 @@ Vector3 VoxelBoxMover::get_motion(Vector3 p_pos, Vector3 p_motion, AABB p_aabb,
 
 	} else if (try_get_as(p_terrain->get_mesher(), mesher_cubes)) {
 		const int channel = VoxelBufferInternal::CHANNEL_COLOR;
+		const uint64_t default_voxel = voxels.get_default_voxel(channel);
+		snapshot.gather_box(envelope_box, channel, default_voxel, to_span(tls_gathered));
 
+		// ZXY iteration matches the gathered buffer's layout, so the index just increments
+		unsigned int gathered_index = 0;
 		for (i.z = min_z; i.z < max_z; ++i.z) {
-			for (i.y = min_y; i.y < max_y; ++i.y) {
-				for (i.x = min_x; i.x < max_x; ++i.x) {
-					const int color_data = voxels.get_voxel(i, channel);
-					if (color_data != 0) {
+			for (i.x = min_x; i.x < max_x; ++i.x) {
+				for (i.y = min_y; i.y < max_y; ++i.y) {
+					// Compare against air over the local buffer, trivially vectorizable
+					if (tls_gathered[gathered_index] != 0) {
 						potential_boxes.push_back(AABB(i, Vector3(1, 1, 1)));
 					}
+					++gathered_index;
 				}
 			}
 		}
@@ -25,6 +25,18 @@ public:
 		_position_in_voxels = bpos * size;
 	}
 
+	// Re-initializes a recycled block (see `VoxelMeshMap::try_acquire_recycled_block`) as if it
+	// had just been constructed at this position
+	void reuse(const Vector3i bpos, unsigned int size) {
+		position = bpos;
+		_position_in_voxels = bpos * size;
+		_mesh_state = MESH_NEVER_UPDATED;
+		mark_whole_block_dirty();
+		mesh_updates_in_flight = 0;
+		mesh_viewers = RefCount();
+		collision_viewers = RefCount();
+	}
+
 	void set_mesh_state(MeshState ms) {
 		_mesh_state = ms;
 	}
@@ -33,8 +45,55 @@ public:
 		return _mesh_state;
 	}
 
+	// Tracks which region of the block actually changed since the last successfully applied mesh,
+	// so update requests can tell the mesher which geometry it may reuse. Boxes are in terrain
+	// voxel coordinates. Mesh requests can be dropped or complete out of order, so the box only
+	// shrinks back when all requests in flight have been responded (see `mesh_updates_in_flight`).
+	enum DirtyState {
+		DIRTY_WHOLE_BLOCK = 0, // Conservative default, everything must be remeshed
+		DIRTY_BOX, // Only the dirty box changed since the last applied mesh
+		DIRTY_NONE // The applied mesh covers all edits made so far
+	};
+
+	void mark_area_edited(const Box3i &box_in_voxels) {
+		switch (_dirty_state) {
+			case DIRTY_WHOLE_BLOCK:
+				// The whole block is already dirty, it stays that way
+				break;
+			case DIRTY_BOX:
+				_dirty_box_in_voxels.merge_with(box_in_voxels);
+				break;
+			case DIRTY_NONE:
+				_dirty_box_in_voxels = box_in_voxels;
+				_dirty_state = DIRTY_BOX;
+				break;
+		}
+	}
+
+	void mark_whole_block_dirty() {
+		_dirty_state = DIRTY_WHOLE_BLOCK;
+	}
+
+	// To be called when a mesh update was applied while no other update is in flight or pending
+	void mark_mesh_clean() {
+		_dirty_state = DIRTY_NONE;
+	}
+
+	bool has_dirty_box() const {
+		return _dirty_state == DIRTY_BOX;
+	}
+
+	const Box3i &get_dirty_box() const {
+		return _dirty_box_in_voxels;
+	}
+
+	// Number of mesh update requests sent for this block and not responded yet
+	unsigned int mesh_updates_in_flight = 0;
+
 private:
 	MeshState _mesh_state = MESH_NEVER_UPDATED;
+	Box3i _dirty_box_in_voxels;
+	DirtyState _dirty_state = DIRTY_WHOLE_BLOCK;
 };
 
 } // namespace zylann::voxel
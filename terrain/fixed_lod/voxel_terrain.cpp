@@ -4,8 +4,10 @@
 #include "../../edition/voxel_tool_terrain.h"
 #include "../../server/voxel_server.h"
 #include "../../server/voxel_server_updater.h"
+#include "../../streams/save_order.h"
 #include "../../storage/voxel_buffer_gd.h"
 #include "../../util/container_funcs.h"
+#include "../../util/godot/funcs.h"
 #include "../../util/macros.h"
 #include "../../util/math/conv.h"
 #include "../../util/profiling.h"
@@ -16,10 +18,19 @@
 
 #include <core/config/engine.h>
 #include <core/core_string_names.h>
+#include <core/os/time.h>
 #include <scene/3d/mesh_instance_3d.h>
 
+#include <algorithm>
+
 namespace zylann::voxel {
 
+namespace {
+inline uint32_t get_ticks_msec() {
+	return Time::get_singleton()->get_ticks_msec();
+}
+} // namespace
+
 VoxelTerrain::VoxelTerrain() {
 	// Note: don't do anything heavy in the constructor.
 	// Godot may create and destroy dozens of instances of all node types on startup,
@@ -31,6 +42,9 @@ VoxelTerrain::VoxelTerrain() {
 	// Infinite by default
 	_bounds_in_voxels = Box3i::from_center_extents(Vector3i(), Vector3iUtil::create(constants::MAX_VOLUME_EXTENT));
 
+	// Blocks come and go constantly while viewers move, recycling avoids RID churn
+	_mesh_map.set_block_recycling_enabled(true);
+
 	struct ApplyMeshUpdateTask : public ITimeSpreadTask {
 		void run(TimeSpreadTaskContext &ctx) override {
 			if (!VoxelServer::get_singleton().is_volume_valid(volume_id)) {
@@ -56,7 +70,15 @@ VoxelTerrain::VoxelTerrain() {
 		task->volume_id = self->_volume_id;
 		task->self = self;
 		task->data = ob;
-		VoxelServer::get_singleton().push_main_thread_time_spread_task(task);
+		// Blocks close to a viewer get their lane served first, so when uploads burst, it's the
+		// distant ones that get spread over more frames
+		const int block_size_in_voxels = self->get_mesh_block_size();
+		Vector3 block_center = (Vector3(ob.position) + Vector3(0.5f, 0.5f, 0.5f)) * block_size_in_voxels;
+		if (self->is_inside_tree()) {
+			block_center = self->get_global_transform().xform(block_center);
+		}
+		VoxelServer::get_singleton().push_main_thread_time_spread_task(
+				task, VoxelServer::get_singleton().get_main_thread_time_spread_priority(block_center));
 	};
 	callbacks.data_output_callback = [](void *cb_data, VoxelServer::BlockDataOutput &ob) {
 		VoxelTerrain *self = reinterpret_cast<VoxelTerrain *>(cb_data);
@@ -200,6 +222,7 @@ unsigned int VoxelTerrain::get_mesh_block_size_pow2() const {
 
 void VoxelTerrain::set_mesh_block_size(unsigned int mesh_block_size) {
 	mesh_block_size = math::clamp(mesh_block_size, get_data_block_size(), constants::MAX_BLOCK_SIZE);
+	_paired_viewers_dirty = true;
 
 	unsigned int po2;
 	switch (mesh_block_size) {
@@ -252,6 +275,7 @@ void VoxelTerrain::restart_stream() {
 void VoxelTerrain::_on_stream_params_changed() {
 	stop_streamer();
 	stop_updater();
+	_paired_viewers_dirty = true;
 
 	if (_stream.is_valid()) {
 		const int stream_block_size_po2 = _stream->get_block_size_po2();
@@ -348,6 +372,10 @@ int VoxelTerrain::get_collision_mask() const {
 	return _collision_mask;
 }
 
+void VoxelTerrain::set_collision_simplify_distance(float distance) {
+	_collision_simplify_distance = math::max(distance, 0.f);
+}
+
 void VoxelTerrain::set_collision_margin(float margin) {
 	_collision_margin = margin;
 	_mesh_map.for_each_block([margin](VoxelMeshBlockVT &block) { //
@@ -366,6 +394,7 @@ unsigned int VoxelTerrain::get_max_view_distance() const {
 void VoxelTerrain::set_max_view_distance(unsigned int distance_in_voxels) {
 	ERR_FAIL_COND(distance_in_voxels < 0);
 	_max_view_distance_voxels = distance_in_voxels;
+	_paired_viewers_dirty = true;
 
 	if (_instancer != nullptr) {
 		_instancer->set_mesh_lod_distance(_max_view_distance_voxels);
@@ -374,6 +403,7 @@ void VoxelTerrain::set_max_view_distance(unsigned int distance_in_voxels) {
 
 void VoxelTerrain::set_block_enter_notification_enabled(bool enable) {
 	_block_enter_notification_enabled = enable;
+	_paired_viewers_dirty = true;
 
 	if (enable == false) {
 		const Vector3i *key = nullptr;
@@ -399,6 +429,7 @@ bool VoxelTerrain::is_area_edit_notification_enabled() const {
 
 void VoxelTerrain::set_automatic_loading_enabled(bool enable) {
 	_automatic_loading_enabled = enable;
+	_paired_viewers_dirty = true;
 }
 
 bool VoxelTerrain::is_automatic_loading_enabled() const {
@@ -411,6 +442,8 @@ void VoxelTerrain::set_material(unsigned int id, Ref<Material> material) {
 	Ref<Material> old_material = _materials[id];
 
 	if (material != old_material) {
+		// Shared deduplicated meshes have the material baked in, future blocks must not reuse them
+		VoxelServer::get_singleton().get_mesh_dedup_cache().clear_volume(_volume_id);
 		// Update existing meshes
 		_mesh_map.for_each_block([material, old_material](VoxelMeshBlockVT &block) {
 			Ref<Mesh> mesh = block.get_mesh();
@@ -435,7 +468,15 @@ Ref<Material> VoxelTerrain::get_material(unsigned int id) const {
 	return _materials[id];
 }
 
-void VoxelTerrain::try_schedule_mesh_update(VoxelMeshBlockVT &mesh_block) {
+void VoxelTerrain::try_schedule_mesh_update(VoxelMeshBlockVT &mesh_block, const Box3i *edited_box_in_voxels) {
+	// Keep track of what changed even if an update was already scheduled,
+	// so the mesher can be told which region it may skip
+	if (edited_box_in_voxels != nullptr) {
+		mesh_block.mark_area_edited(*edited_box_in_voxels);
+	} else {
+		mesh_block.mark_whole_block_dirty();
+	}
+
 	if (mesh_block.get_mesh_state() == VoxelMeshBlockVT::MESH_UPDATE_NOT_SENT) {
 		// Already in the list
 		return;
@@ -520,8 +561,16 @@ void VoxelTerrain::view_mesh_block(Vector3i bpos, bool mesh_flag, bool collision
 	VoxelMeshBlockVT *block = _mesh_map.get_block(bpos);
 
 	if (block == nullptr) {
-		// Create if not found
-		block = memnew(VoxelMeshBlockVT(bpos, get_mesh_block_size()));
+		// Create if not found, preferring a recycled block so its RenderingServer resources don't
+		// have to be re-allocated
+		block = _mesh_map.try_acquire_recycled_block();
+		if (block != nullptr) {
+			block->reuse(bpos, get_mesh_block_size());
+			// The setting can have changed while the block was dormant
+			block->set_gi_mode(DirectMeshInstance::GIMode(get_gi_mode()));
+		} else {
+			block = memnew(VoxelMeshBlockVT(bpos, get_mesh_block_size()));
+		}
 		block->set_world(get_world_3d());
 		_mesh_map.set_block(bpos, block);
 	}
@@ -575,9 +624,77 @@ void VoxelTerrain::unview_data_block(Vector3i bpos) {
 		// The block is loaded
 		block->viewers.remove();
 		if (block->viewers.get() == 0) {
-			// The block itself is no longer wanted
+			// Not unloaded immediately: strafing along the view-box edge re-enters the same
+			// blocks constantly (traces showed 30% of loads were re-loads within seconds).
+			// The block stays resident for a grace period instead, see `process_unload_parole`.
+			// Memory pressure shortens the grace to nothing.
+			const uint32_t grace_msec = VoxelServer::get_singleton().is_memory_over_budget()
+					? 0
+					: get_unload_grace_time_msec(bpos);
+			_parole_blocks[bpos] = get_ticks_msec() + grace_msec;
+		}
+	}
+}
+
+uint32_t VoxelTerrain::get_unload_grace_time_msec(Vector3i bpos) const {
+	// Base grace plus a multiple per recorded re-entry of the block's area, up to ~13 seconds,
+	// which covers the re-load window observed in traces
+	static const uint32_t BASE_GRACE_MSEC = 1500;
+	static const unsigned int MAX_SCORE = 8;
+	uint8_t score = 0;
+	auto it = _area_reuse_scores.find(bpos >> 2);
+	if (it != _area_reuse_scores.end()) {
+		score = math::min(it->second, uint8_t(MAX_SCORE));
+	}
+	return BASE_GRACE_MSEC * (1 + score);
+}
+
+void VoxelTerrain::process_unload_parole() {
+	ZN_PROFILE_SCOPE();
+	if (_parole_blocks.size() == 0) {
+		return;
+	}
+	const uint32_t now = get_ticks_msec();
+
+	for (auto it = _parole_blocks.begin(); it != _parole_blocks.end();) {
+		const Vector3i bpos = it->first;
+		const VoxelDataBlock *block = _data_map.get_block(bpos);
+
+		if (block == nullptr) {
+			// Already unloaded by another path (bounds change, clear)
+			it = _parole_blocks.erase(it);
+			continue;
+		}
+
+		if (block->viewers.get() > 0) {
+			// Re-entered before the grace ended: that's a load we didn't have to redo.
+			// The area proves it gets revisited, lengthen future graces there.
+			uint8_t &score = _area_reuse_scores[bpos >> 2];
+			if (score < 8) {
+				++score;
+			}
+			++_stats.unload_rescues;
+			it = _parole_blocks.erase(it);
+			continue;
+		}
+
+		if (now >= it->second) {
+			// Grace expired without a re-entry, the area cools down
+			auto score_it = _area_reuse_scores.find(bpos >> 2);
+			if (score_it != _area_reuse_scores.end()) {
+				if (score_it->second <= 1) {
+					_area_reuse_scores.erase(score_it);
+				} else {
+					--score_it->second;
+				}
+			}
+			++_stats.grace_unloads;
 			unload_data_block(bpos);
+			it = _parole_blocks.erase(it);
+			continue;
 		}
+
+		++it;
 	}
 }
 
@@ -621,7 +738,8 @@ struct ScheduleSaveAction {
 			if (with_copy) {
 				RWLockRead lock(block.get_voxels().get_lock());
 				b.voxels = make_shared_instance<VoxelBufferInternal>();
-				block.get_voxels_const().duplicate_to(*b.voxels, true);
+				// Copy-on-write snapshot: channels are only duplicated if edited before the save
+				b.voxels->copy_shared_from(block.get_voxels_const(), true);
 			} else {
 				b.voxels = block.get_voxels_shared();
 			}
@@ -642,6 +760,10 @@ void VoxelTerrain::unload_data_block(Vector3i bpos) {
 			// Note: no need to copy the block because it gets removed from the map anyways
 			ScheduleSaveAction{ _blocks_to_save, false }(block);
 		}
+		// Keep a compressed copy in memory so circling players reload it without hitting the
+		// stream. Done after scheduling the save, contents match what gets written.
+		VoxelServer::get_singleton().get_cold_block_cache().put(
+				_volume_id, 0, block.position, block.get_voxels_const());
 	});
 
 	_loading_blocks.erase(bpos);
@@ -730,6 +852,9 @@ Dictionary VoxelTerrain::_b_get_statistics() const {
 	d["dropped_block_loads"] = _stats.dropped_block_loads;
 	d["dropped_block_meshs"] = _stats.dropped_block_meshs;
 	d["updated_blocks"] = _stats.updated_blocks;
+	// Unload hysteresis effectiveness: rescues are re-loads that never had to happen
+	d["unload_rescues"] = ZN_SIZE_T_TO_VARIANT(_stats.unload_rescues);
+	d["grace_unloads"] = ZN_SIZE_T_TO_VARIANT(_stats.grace_unloads);
 
 	return d;
 }
@@ -761,6 +886,9 @@ void VoxelTerrain::stop_updater() {
 		if (block.get_mesh_state() == VoxelMeshBlockVT::MESH_UPDATE_SENT) {
 			block.set_mesh_state(VoxelMeshBlockVT::MESH_UPDATE_NOT_SENT);
 		}
+		// Invalidated requests won't come back, and the mesher might change
+		block.mesh_updates_in_flight = 0;
+		block.mark_whole_block_dirty();
 	});
 }
 
@@ -842,12 +970,12 @@ void VoxelTerrain::post_edit_voxel(Vector3i pos) {
 void VoxelTerrain::try_schedule_mesh_update_from_data(const Box3i &box_in_voxels) {
 	// We pad by 1 because neighbor blocks might be affected visually (for example, baked ambient occlusion)
 	const Box3i mesh_box = box_in_voxels.padded(1).downscaled(get_mesh_block_size());
-	mesh_box.for_each_cell([this](Vector3i pos) {
+	mesh_box.for_each_cell([this, &box_in_voxels](Vector3i pos) {
 		VoxelMeshBlockVT *block = _mesh_map.get_block(pos);
 		// There isn't necessarily a mesh block, if the edit happens in a boundary,
 		// or if it is done next to a viewer that doesn't need meshes
 		if (block != nullptr) {
-			try_schedule_mesh_update(*block);
+			try_schedule_mesh_update(*block, &box_in_voxels);
 		}
 	});
 }
@@ -913,10 +1041,23 @@ void VoxelTerrain::_notification(int p_what) {
 
 		case NOTIFICATION_ENTER_WORLD:
 			_mesh_map.for_each_block(SetWorldAction(*get_world_3d()));
+			// Compile material pipelines now rather than hitching on the first rendered chunk
+			if (_mesher.is_valid()) {
+				FixedArray<Ref<Material>, VoxelMesherBlocky::MAX_MATERIALS> materials;
+				unsigned int material_count = 0;
+				for (unsigned int i = 0; i < VoxelMesherBlocky::MAX_MATERIALS; ++i) {
+					if (_materials[i].is_valid()) {
+						materials[material_count] = _materials[i];
+						++material_count;
+					}
+				}
+				_material_warmup.begin(**_mesher, to_span_const(materials, material_count), *get_world_3d());
+			}
 			break;
 
 		case NOTIFICATION_EXIT_WORLD:
 			_mesh_map.for_each_block(SetWorldAction(nullptr));
+			_material_warmup.clear();
 			break;
 
 		case NOTIFICATION_VISIBILITY_CHANGED:
@@ -926,6 +1067,8 @@ void VoxelTerrain::_notification(int p_what) {
 		case NOTIFICATION_TRANSFORM_CHANGED: {
 			const Transform3D transform = get_global_transform();
 			VoxelServer::get_singleton().set_volume_transform(_volume_id, transform);
+			// View boxes are computed in local space, they depend on our transform
+			_paired_viewers_dirty = true;
 
 			if (!is_inside_tree()) {
 				// The transform and other properties can be set by the scene loader,
@@ -947,15 +1090,16 @@ void VoxelTerrain::_notification(int p_what) {
 void VoxelTerrain::send_block_data_requests() {
 	ZN_PROFILE_SCOPE();
 
-	// Blocks to load
-	for (size_t i = 0; i < _blocks_pending_load.size(); ++i) {
-		const Vector3i block_pos = _blocks_pending_load[i];
-		// TODO Batch request
-		VoxelServer::get_singleton().request_block_load(_volume_id, block_pos, 0, _instancer != nullptr);
-	}
+	// Blocks to load. When only a generator is used, nearby blocks get grouped into batch tasks.
+	VoxelServer::get_singleton().request_block_loads(
+			_volume_id, to_span_const(_blocks_pending_load), 0, _instancer != nullptr);
 
 	// Blocks to save
 	if (_stream.is_valid()) {
+		// Ordered so writes stream sequentially through region files instead of seeking randomly
+		std::sort(_blocks_to_save.begin(), _blocks_to_save.end(), [](const BlockToSave &a, const BlockToSave &b) {
+			return sequential_save_order_key(a.position, 0) < sequential_save_order_key(b.position, 0);
+		});
 		for (unsigned int i = 0; i < _blocks_to_save.size(); ++i) {
 			ZN_PRINT_VERBOSE(format("Requesting save of block {}", _blocks_to_save[i].position));
 			const BlockToSave b = _blocks_to_save[i];
@@ -1010,6 +1154,12 @@ void VoxelTerrain::notify_data_block_enter(VoxelDataBlock &block, uint32_t viewe
 		// loading it
 		return;
 	}
+	if (GDVIRTUAL_IS_OVERRIDDEN(_on_data_blocks_entered)) {
+		// Batched path: queued and delivered in one script call per frame, so loading a large
+		// area doesn't invoke hundreds of calls at once
+		_pending_block_enter_notifications.push_back(PendingBlockEnterNotification{ block.position, viewer_id });
+		return;
+	}
 	if (_data_block_enter_info_obj == nullptr) {
 		_data_block_enter_info_obj = gd_make_unique<VoxelDataBlockEnterInfo>();
 	}
@@ -1026,11 +1176,128 @@ void VoxelTerrain::_process() {
 	process_viewers();
 	//process_received_data_blocks();
 	process_meshing();
+
+	if (VoxelServer::get_singleton().is_telemetry_enabled()) {
+		VoxelServer::get_singleton().set_volume_debug_block_counts(
+				_volume_id, _data_map.get_block_count(), _mesh_map.get_block_count());
+	}
+
+	if (VoxelServer::get_singleton().is_memory_over_budget()) {
+		shed_memory_pass();
+	}
+
+	process_unload_parole();
+
+	process_block_enter_notifications();
+
+	_material_warmup.process();
+}
+
+// Delivers queued block-enter notifications as one script call with an array of infos. The batch
+// size adapts to how long the previous call took, aiming at a couple of milliseconds per frame,
+// so gameplay logic (spawners, quest triggers) processes arrivals without frame spikes.
+void VoxelTerrain::process_block_enter_notifications() {
+	if (_pending_block_enter_notifications.size() == 0) {
+		return;
+	}
+	ZN_PROFILE_SCOPE();
+
+	const unsigned int count =
+			math::min(unsigned(_pending_block_enter_notifications.size()), _block_enter_batch_size);
+
+	while (_block_enter_info_pool.size() < count) {
+		_block_enter_info_pool.push_back(gd_make_unique<VoxelDataBlockEnterInfo>());
+	}
+
+	Array infos;
+	unsigned int added = 0;
+	for (unsigned int i = 0; i < count; ++i) {
+		const PendingBlockEnterNotification &pending = _pending_block_enter_notifications[i];
+		if (!VoxelServer::get_singleton().viewer_exists(pending.viewer_id)) {
+			continue;
+		}
+		VoxelDataBlock *block = _data_map.get_block(pending.block_position);
+		if (block == nullptr) {
+			// Unloaded before delivery
+			continue;
+		}
+		VoxelDataBlockEnterInfo *info = _block_enter_info_pool[added].get();
+		info->network_peer_id = VoxelServer::get_singleton().get_viewer_network_peer_id(pending.viewer_id);
+		info->voxel_block = block;
+		infos.append(info);
+		++added;
+	}
+	_pending_block_enter_notifications.erase(
+			_pending_block_enter_notifications.begin(), _pending_block_enter_notifications.begin() + count);
+
+	if (added == 0) {
+		return;
+	}
+
+	const uint64_t time_before = Time::get_singleton()->get_ticks_usec();
+	if (!GDVIRTUAL_CALL(_on_data_blocks_entered, infos)) {
+		WARN_PRINT_ONCE("VoxelTerrain::_on_data_blocks_entered is unimplemented!");
+	}
+	const uint64_t spent_usec = Time::get_singleton()->get_ticks_usec() - time_before;
+
+	// Pointers must not outlive the call
+	for (unsigned int i = 0; i < added; ++i) {
+		_block_enter_info_pool[i]->voxel_block = nullptr;
+	}
+
+	// Aim the next batch at roughly 2ms of script time
+	const uint64_t TARGET_USEC = 2000;
+	const uint64_t per_item_usec = math::max(spent_usec / added, uint64_t(1));
+	_block_enter_batch_size = math::clamp(unsigned(TARGET_USEC / per_item_usec), 16u, 1024u);
+}
+
+// Runs while the memory governor reports pressure (see `VoxelServer::is_memory_over_budget`).
+// Tries in-place compression of resident blocks (uniform/tiled storage is a fraction of the dense
+// size), a bounded number per frame since compressing scans whole buffers. Blocks are marked so
+// settled ones aren't rescanned; editing a block clears its mark. Actual unloading remains driven
+// by viewer distance: evicting blocks still in view would only trade memory for re-load churn.
+void VoxelTerrain::shed_memory_pass() {
+	ZN_PROFILE_SCOPE();
+	unsigned int budget = 64;
+	_data_map.for_each_block([&budget](VoxelDataBlock &block) {
+		if (budget == 0 || block.was_compaction_attempted()) {
+			return;
+		}
+		VoxelBufferInternal &voxels = block.get_voxels();
+		{
+			RWLockWrite wlock(voxels.get_lock());
+			voxels.compress_uniform_channels();
+		}
+		block.mark_compaction_attempted();
+		--budget;
+	});
 }
 
 void VoxelTerrain::process_viewers() {
 	ProfilingClock profiling_clock;
 
+	const bool can_load_blocks = (_automatic_loading_enabled && (_stream.is_valid() || _generator.is_valid())) &&
+			(Engine::get_singleton()->is_editor_hint() == false || _run_stream_in_editor);
+
+	// Viewers are stationary most frames (they only "move" at block granularity), and nothing else
+	// about the node changed either, so the whole diffing pass below would be a no-op. Detecting
+	// that from the server's state version reclaims steady-state main-thread time.
+	const uint64_t viewers_state_version = VoxelServer::get_singleton().get_viewers_state_version();
+	// The version quantizes positions to the default block size, so terrains with smaller blocks
+	// (exotic streams can declare them) must not rely on it
+	if (!_paired_viewers_dirty && viewers_state_version == _last_viewers_state_version &&
+			get_data_block_size_pow2() >= constants::DEFAULT_BLOCK_SIZE_PO2) {
+		_stats.time_detect_required_blocks = profiling_clock.restart();
+		// Blocks can still be queued by other means (edits, responses), keep those flowing
+		if (can_load_blocks && _blocks_pending_load.size() > 0) {
+			send_block_data_requests();
+		}
+		_stats.time_request_blocks_to_load = profiling_clock.restart();
+		return;
+	}
+	_last_viewers_state_version = viewers_state_version;
+	_paired_viewers_dirty = false;
+
 	// Ordered by ascending index in paired viewers list
 	std::vector<size_t> unpaired_viewer_indexes;
 
@@ -1047,7 +1314,11 @@ void VoxelTerrain::process_viewers() {
 				// Interpret removal as nullified view distance so the same code handling loading of blocks
 				// will be used to unload those viewed by this viewer.
 				// We'll actually remove unpaired viewers in a second pass.
+				p.prev_state = p.state;
 				p.state.view_distance_voxels = 0;
+				p.state.data_box = Box3i();
+				p.state.mesh_box = Box3i();
+				p.state.collision_box = Box3i();
 				unpaired_viewer_indexes.push_back(i);
 			}
 		}
@@ -1091,6 +1362,14 @@ void VoxelTerrain::process_viewers() {
 				state.requires_collisions = VoxelServer::get_singleton().is_viewer_requiring_collisions(viewer_id);
 				state.requires_meshes = VoxelServer::get_singleton().is_viewer_requiring_visuals(viewer_id);
 
+				// Collisions can stop at a shorter distance than visuals
+				unsigned int collision_distance_voxels = state.view_distance_voxels;
+				if (viewer.collision_distance != 0) {
+					collision_distance_voxels = math::min(collision_distance_voxels,
+							static_cast<unsigned int>(
+									static_cast<float>(viewer.collision_distance) * view_distance_scale));
+				}
+
 				// Update data and mesh view boxes
 
 				const int data_block_size = self.get_data_block_size();
@@ -1112,7 +1391,18 @@ void VoxelTerrain::process_viewers() {
 							Box3i::from_center_extents(mesh_block_pos, Vector3iUtil::create(view_distance_mesh_blocks))
 									.clipped(bounds_in_mesh_blocks);
 
+					if (state.requires_collisions) {
+						const int collision_distance_mesh_blocks =
+								math::ceildiv(int(collision_distance_voxels), mesh_block_size);
+						state.collision_box = Box3i::from_center_extents(mesh_block_pos,
+								Vector3iUtil::create(collision_distance_mesh_blocks))
+													  .clipped(bounds_in_mesh_blocks);
+					} else {
+						state.collision_box = Box3i();
+					}
+
 				} else {
+					state.collision_box = Box3i();
 					view_distance_data_blocks = math::ceildiv(state.view_distance_voxels, data_block_size);
 
 					data_block_pos = math::floordiv(state.local_position_voxels, data_block_size);
@@ -1131,9 +1421,6 @@ void VoxelTerrain::process_viewers() {
 		VoxelServer::get_singleton().for_each_viewer(u);
 	}
 
-	const bool can_load_blocks = (_automatic_loading_enabled && (_stream.is_valid() || _generator.is_valid())) &&
-			(Engine::get_singleton()->is_editor_hint() == false || _run_stream_in_editor);
-
 	// Find out which blocks need to appear and which need to be unloaded
 	{
 		ZN_PROFILE_SCOPE();
@@ -1179,39 +1466,49 @@ void VoxelTerrain::process_viewers() {
 					ZN_PROFILE_SCOPE();
 
 					// Unview blocks that just fell out of range
-					prev_mesh_box.difference(new_mesh_box, [this, &viewer](Box3i out_of_range_box) {
-						out_of_range_box.for_each_cell([this, &viewer](Vector3i bpos) {
-							unview_mesh_block(
-									bpos, viewer.prev_state.requires_meshes, viewer.prev_state.requires_collisions);
+					if (viewer.prev_state.requires_meshes) {
+						prev_mesh_box.difference(new_mesh_box, [this](Box3i out_of_range_box) {
+							out_of_range_box.for_each_cell([this](Vector3i bpos) { //
+								unview_mesh_block(bpos, true, false);
+							});
 						});
-					});
+					}
 
 					// View blocks that just entered the range
-					new_mesh_box.difference(prev_mesh_box, [this, &viewer](Box3i box_to_load) {
-						box_to_load.for_each_cell([this, &viewer](Vector3i bpos) {
-							// Load or update block
-							view_mesh_block(bpos, viewer.state.requires_meshes, viewer.state.requires_collisions);
+					if (viewer.state.requires_meshes) {
+						new_mesh_box.difference(prev_mesh_box, [this](Box3i box_to_load) {
+							box_to_load.for_each_cell([this](Vector3i bpos) {
+								// Load or update block
+								view_mesh_block(bpos, true, false);
+							});
 						});
-					});
+					}
 				}
 
-				// Blocks that remained within range of the viewer may need some changes too if viewer flags were
-				// modified. This operates on a DISTINCT set of blocks than the one above.
+				// Collision refcounts follow their own box, which is empty when the viewer doesn't
+				// need collisions, so flag flips are covered by the same diff
+				const Box3i &new_collision_box = viewer.state.collision_box;
+				const Box3i &prev_collision_box = viewer.prev_state.collision_box;
 
-				if (viewer.state.requires_collisions != viewer.prev_state.requires_collisions) {
-					const Box3i box = new_mesh_box.clipped(prev_mesh_box);
-					if (viewer.state.requires_collisions) {
-						box.for_each_cell([this](Vector3i bpos) { //
-							view_mesh_block(bpos, false, true);
-						});
+				if (prev_collision_box != new_collision_box) {
+					ZN_PROFILE_SCOPE();
 
-					} else {
-						box.for_each_cell([this](Vector3i bpos) { //
+					prev_collision_box.difference(new_collision_box, [this](Box3i out_of_range_box) {
+						out_of_range_box.for_each_cell([this](Vector3i bpos) { //
 							unview_mesh_block(bpos, false, true);
 						});
-					}
+					});
+
+					new_collision_box.difference(prev_collision_box, [this](Box3i box_to_load) {
+						box_to_load.for_each_cell([this](Vector3i bpos) { //
+							view_mesh_block(bpos, false, true);
+						});
+					});
 				}
 
+				// Blocks that remained within range of the viewer may need some changes too if viewer flags were
+				// modified. This operates on a DISTINCT set of blocks than the one above.
+
 				if (viewer.state.requires_meshes != viewer.prev_state.requires_meshes) {
 					const Box3i box = new_mesh_box.clipped(prev_mesh_box);
 					if (viewer.state.requires_meshes) {
@@ -1430,6 +1727,14 @@ void VoxelTerrain::process_meshing() {
 			VoxelServer::BlockMeshInput mesh_request;
 			mesh_request.render_block_position = mesh_block_pos;
 			mesh_request.lod = 0;
+			if (mesh_block->has_dirty_box()) {
+				// Only edits happened since the last update was sent, tell the mesher about it
+				mesh_request.dirty_box = mesh_block->get_dirty_box();
+				mesh_request.has_dirty_box = true;
+			}
+			// Let the worker cook the collision triangle soup too
+			mesh_request.collision_hint = _generate_collisions && mesh_block->collision_viewers.get() > 0;
+			mesh_request.collision_simplify_distance = _collision_simplify_distance;
 			//mesh_request.data_blocks_count = data_box.size.volume();
 
 			// This iteration order is specifically chosen to match VoxelServer and threaded access
@@ -1458,6 +1763,7 @@ void VoxelTerrain::process_meshing() {
 			VoxelServer::get_singleton().request_block_mesh(_volume_id, mesh_request);
 
 			mesh_block->set_mesh_state(VoxelMeshBlockVT::MESH_UPDATE_SENT);
+			++mesh_block->mesh_updates_in_flight;
 		}
 
 		_blocks_pending_update.clear();
@@ -1481,19 +1787,34 @@ void VoxelTerrain::apply_mesh_update(const VoxelServer::BlockMeshOutput &ob) {
 		return;
 	}
 
+	if (block->mesh_updates_in_flight > 0) {
+		--block->mesh_updates_in_flight;
+	}
+
 	if (ob.type == VoxelServer::BlockMeshOutput::TYPE_DROPPED) {
 		// That block is loaded, but its meshing request was dropped.
 		// TODO Not sure what to do in this case, the code sending update queries has to be tweaked
 		ZN_PRINT_VERBOSE("Received a block mesh drop while we were still expecting it");
+		// We no longer know which of its edits made it into a mesh, don't let the mesher reuse geometry
+		block->mark_whole_block_dirty();
 		++_stats.dropped_block_meshs;
 		return;
 	}
 
+	// Identical geometry (flat oceans, plains) shares one uploaded mesh across blocks
+	MeshDedupCache &mesh_dedup_cache = VoxelServer::get_singleton().get_mesh_dedup_cache();
 	Ref<ArrayMesh> mesh;
+	bool mesh_from_dedup_cache = false;
+	if (ob.content_hash != 0) {
+		mesh = mesh_dedup_cache.try_get(_volume_id, ob.content_hash);
+		mesh_from_dedup_cache = mesh.is_valid();
+	}
 
 	//need to put both blocky and smooth surfaces into one list
 	std::vector<Array> collidable_surfaces;
 
+	const bool use_packed_surfaces = ob.packed_surfaces.size() > 0;
+
 	int surface_index = 0;
 	for (unsigned int i = 0; i < ob.surfaces.surfaces.size(); ++i) {
 		Array surface = ob.surfaces.surfaces[i];
@@ -1508,6 +1829,11 @@ void VoxelTerrain::apply_mesh_update(const VoxelServer::BlockMeshOutput &ob) {
 
 		collidable_surfaces.push_back(surface);
 
+		if (mesh_from_dedup_cache || use_packed_surfaces) {
+			// Either already uploaded by another block, or uploaded from pre-packed buffers below
+			continue;
+		}
+
 		if (mesh.is_null()) {
 			mesh.instantiate();
 		}
@@ -1518,11 +1844,30 @@ void VoxelTerrain::apply_mesh_update(const VoxelServer::BlockMeshOutput &ob) {
 		++surface_index;
 	}
 
-	if (mesh.is_valid() && is_mesh_empty(**mesh)) {
+	if (use_packed_surfaces && !mesh_from_dedup_cache) {
+		// Surfaces were packed in the RenderingServer's native layout on the worker; adding them
+		// here skips Variant unpacking and vertex packing on the main thread
+		for (unsigned int i = 0; i < ob.packed_surfaces.size(); ++i) {
+			const VoxelServer::BlockMeshOutput::PackedSurface &packed = ob.packed_surfaces[i];
+			const RenderingServer::SurfaceData &sd = packed.data;
+			if (mesh.is_null()) {
+				mesh.instantiate();
+			}
+			mesh->add_surface(sd.format, Mesh::PrimitiveType(sd.primitive), sd.vertex_data, sd.attribute_data,
+					sd.skin_data, sd.vertex_count, sd.index_data, sd.index_count, sd.aabb);
+			mesh->surface_set_material(i, _materials[packed.src_index]);
+		}
+	}
+
+	if (mesh.is_valid() && !mesh_from_dedup_cache && is_mesh_empty(**mesh)) {
 		mesh = Ref<Mesh>();
 		collidable_surfaces.clear();
 	}
 
+	if (mesh.is_valid() && !mesh_from_dedup_cache && ob.content_hash != 0) {
+		mesh_dedup_cache.put(_volume_id, ob.content_hash, mesh);
+	}
+
 	if (_instancer != nullptr) {
 		if (mesh.is_null() && block != nullptr) {
 			// No surface anymore in this block
@@ -1539,14 +1884,32 @@ void VoxelTerrain::apply_mesh_update(const VoxelServer::BlockMeshOutput &ob) {
 
 	block->set_mesh(mesh, DirectMeshInstance::GIMode(get_gi_mode()));
 	if (gen_collisions) {
-		block->set_collision_mesh(to_span_const(collidable_surfaces), get_tree()->is_debugging_collisions_hint(), this,
-				_collision_margin);
+		if (ob.has_collision_shape_faces) {
+			// The triangle soup was cooked on the worker, only the shape gets created here
+			block->set_collision_shape(create_concave_polygon_shape(ob.collision_shape_faces),
+					get_tree()->is_debugging_collisions_hint(), this, _collision_margin);
+		} else {
+			block->set_collision_mesh(to_span_const(collidable_surfaces),
+					get_tree()->is_debugging_collisions_hint(), this, _collision_margin);
+		}
 		block->set_collision_layer(_collision_layer);
 		block->set_collision_mask(_collision_mask);
 	}
 	block->set_visible(true);
 	block->set_parent_visible(is_visible());
 	block->set_parent_transform(get_global_transform());
+
+	if (block->mesh_updates_in_flight == 0 &&
+			block->get_mesh_state() == VoxelMeshBlockVT::MESH_UPDATE_SENT) {
+		// No other update is in flight or pending, so everything edited so far is in the mesh
+		block->mark_mesh_clean();
+	}
+
+	if (ob.surfaces.polish_pass_skipped) {
+		// The latency-critical edit response skipped simplification; schedule a regular rebuild,
+		// whose simplified mesh hot-swaps in whenever it completes
+		try_schedule_mesh_update(*block);
+	}
 }
 
 Ref<VoxelTool> VoxelTerrain::get_voxel_tool() {
@@ -1568,6 +1931,7 @@ void VoxelTerrain::set_run_stream_in_editor(bool enable) {
 	}
 
 	_run_stream_in_editor = enable;
+	_paired_viewers_dirty = true;
 
 	if (Engine::get_singleton()->is_editor_hint()) {
 		if (_run_stream_in_editor) {
@@ -1587,6 +1951,7 @@ bool VoxelTerrain::is_stream_running_in_editor() const {
 void VoxelTerrain::set_bounds(Box3i box) {
 	_bounds_in_voxels =
 			box.clipped(Box3i::from_center_extents(Vector3i(), Vector3iUtil::create(constants::MAX_VOLUME_EXTENT)));
+	_paired_viewers_dirty = true;
 
 	// Round to block size
 	_bounds_in_voxels = _bounds_in_voxels.snapped(get_data_block_size());
@@ -1704,6 +2069,9 @@ void VoxelTerrain::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_collision_margin"), &VoxelTerrain::get_collision_margin);
 	ClassDB::bind_method(D_METHOD("set_collision_margin", "margin"), &VoxelTerrain::set_collision_margin);
+	ClassDB::bind_method(D_METHOD("get_collision_simplify_distance"), &VoxelTerrain::get_collision_simplify_distance);
+	ClassDB::bind_method(D_METHOD("set_collision_simplify_distance", "distance"),
+			&VoxelTerrain::set_collision_simplify_distance);
 
 	ClassDB::bind_method(D_METHOD("voxel_to_data_block", "voxel_pos"), &VoxelTerrain::_b_voxel_to_data_block);
 	ClassDB::bind_method(D_METHOD("data_block_to_voxel", "block_pos"), &VoxelTerrain::_b_data_block_to_voxel);
@@ -1738,6 +2106,7 @@ void VoxelTerrain::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("has_data_block", "block_position"), &VoxelTerrain::has_data_block);
 
 	GDVIRTUAL_BIND(_on_data_block_entered, "info");
+	GDVIRTUAL_BIND(_on_data_blocks_entered, "infos");
 	GDVIRTUAL_BIND(_on_area_edited, "area_origin", "area_size");
 
 	ADD_GROUP("Bounds", "");
@@ -1754,6 +2123,8 @@ void VoxelTerrain::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "collision_mask", PROPERTY_HINT_LAYERS_3D_PHYSICS), "set_collision_mask",
 			"get_collision_mask");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "collision_margin"), "set_collision_margin", "get_collision_margin");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "collision_simplify_distance"), "set_collision_simplify_distance",
+			"get_collision_simplify_distance");
 
 	ADD_GROUP("Networking", "");
 
@@ -5,6 +5,7 @@
 #include "../../storage/voxel_data_map.h"
 #include "../../util/godot/funcs.h"
 #include "../voxel_data_block_enter_info.h"
+#include "../material_warmup.h"
 #include "../voxel_mesh_map.h"
 #include "../voxel_node.h"
 #include "voxel_mesh_block_vt.h"
@@ -62,6 +63,13 @@ public:
 	void set_collision_mask(int mask);
 	int get_collision_mask() const;
 
+	// Distance beyond which collision triangles get decimated on the worker before cooking.
+	// 0 disables decimation.
+	void set_collision_simplify_distance(float distance);
+	float get_collision_simplify_distance() const {
+		return _collision_simplify_distance;
+	}
+
 	void set_collision_margin(float margin);
 	float get_collision_margin() const;
 
@@ -121,6 +129,10 @@ public:
 		uint32_t time_request_blocks_to_load = 0;
 		uint32_t time_process_load_responses = 0;
 		uint32_t time_request_blocks_to_update = 0;
+		// Lifetime totals of the unload hysteresis: rescues are blocks re-entered during their
+		// grace period (loads that didn't have to be redone), grace unloads actually expired
+		uint64_t unload_rescues = 0;
+		uint64_t grace_unloads = 0;
 	};
 
 	const Stats &get_stats() const;
@@ -152,6 +164,10 @@ private:
 
 	void _process();
 	void process_viewers();
+	void shed_memory_pass();
+	void process_unload_parole();
+	void process_block_enter_notifications();
+	uint32_t get_unload_grace_time_msec(Vector3i bpos) const;
 	//void process_received_data_blocks();
 	void process_meshing();
 	void apply_mesh_update(const VoxelServer::BlockMeshOutput &ob);
@@ -173,7 +189,7 @@ private:
 	void unload_data_block(Vector3i bpos);
 	void unload_mesh_block(Vector3i bpos);
 	//void make_data_block_dirty(Vector3i bpos);
-	void try_schedule_mesh_update(VoxelMeshBlockVT &block);
+	void try_schedule_mesh_update(VoxelMeshBlockVT &block, const Box3i *edited_box_in_voxels = nullptr);
 	void try_schedule_mesh_update_from_data(const Box3i &box_in_voxels);
 
 	void save_all_modified_blocks(bool with_copy);
@@ -193,6 +209,11 @@ private:
 	// This can be either when the block exists and the viewer gets close enough, or when it gets loaded.
 	// This only happens if data block enter notifications are enabled.
 	GDVIRTUAL1(_on_data_block_entered, VoxelDataBlockEnterInfo *);
+	// Batched variant: one call per frame with an array of VoxelDataBlockEnterInfo. When a script
+	// overrides it, per-block notifications are queued and delivered under an adaptive per-frame
+	// amount instead of firing hundreds of calls in one frame. Like the single-block variant, the
+	// objects are pooled and must not be kept past the call.
+	GDVIRTUAL1(_on_data_blocks_entered, Array);
 
 	// Called each time voxels are edited within a region.
 	GDVIRTUAL2(_on_area_edited, Vector3i, Vector3i);
@@ -219,6 +240,9 @@ private:
 			Vector3i local_position_voxels;
 			Box3i data_box; // In block coordinates
 			Box3i mesh_box;
+			// Sub-box of `mesh_box` within which this viewer needs collisions; empty when it
+			// doesn't need any. See `VoxelViewer::collision_distance`.
+			Box3i collision_box;
 			int view_distance_voxels = 0;
 			bool requires_collisions = false;
 			bool requires_meshes = false;
@@ -230,6 +254,19 @@ private:
 
 	std::vector<PairedViewer> _paired_viewers;
 
+	// Unload hysteresis: blocks out of every view box stay resident for a grace period scaled by
+	// how often their area gets re-entered, so strafing along the view-box edge doesn't thrash
+	// load/unload. Deadlines in milliseconds, see `process_unload_parole`.
+	std::unordered_map<Vector3i, uint32_t> _parole_blocks;
+	// Re-entry score per 4x4x4-block area (block position >> 2), bumped on rescue, decayed on
+	// expiry; scales the grace period
+	std::unordered_map<Vector3i, uint8_t> _area_reuse_scores;
+	// Viewer-change detection, so stationary viewers don't pay for box diffing every frame.
+	// The version covers server-side viewer changes; the flag covers local ones (transform,
+	// bounds, settings affecting view boxes).
+	uint64_t _last_viewers_state_version = 0;
+	bool _paired_viewers_dirty = true;
+
 	// Voxel storage
 	VoxelDataMap _data_map;
 	// Mesh storage
@@ -272,6 +309,7 @@ private:
 	unsigned int _collision_layer = 1;
 	unsigned int _collision_mask = 1;
 	float _collision_margin = constants::DEFAULT_COLLISION_MARGIN;
+	float _collision_simplify_distance = 0.f;
 	bool _run_stream_in_editor = true;
 	//bool _stream_enabled = false;
 	bool _block_enter_notification_enabled = false;
@@ -280,8 +318,18 @@ private:
 	bool _automatic_loading_enabled = true;
 
 	Ref<Material> _materials[VoxelMesherBlocky::MAX_MATERIALS];
+	// Pre-compiles material pipelines when entering the world, see MaterialPipelineWarmup
+	MaterialPipelineWarmup _material_warmup;
 
 	GodotObjectUniquePtr<VoxelDataBlockEnterInfo> _data_block_enter_info_obj;
+	// Batched notification state, see `process_block_enter_notifications`
+	struct PendingBlockEnterNotification {
+		Vector3i block_position;
+		uint32_t viewer_id;
+	};
+	std::vector<PendingBlockEnterNotification> _pending_block_enter_notifications;
+	std::vector<GodotObjectUniquePtr<VoxelDataBlockEnterInfo>> _block_enter_info_pool;
+	unsigned int _block_enter_batch_size = 64;
 
 	VoxelInstancer *_instancer = nullptr;
 
@@ -1,6 +1,7 @@
 #include "voxel_instance_generator.h"
 #include "../../util/container_funcs.h"
 #include "../../util/profiling.h"
+#include "../../util/span.h"
 
 #include <core/core_string_names.h>
 #include <scene/resources/mesh.h>
@@ -236,9 +237,75 @@ void VoxelInstanceGenerator::generate_transforms(std::vector<Transform3D> &out_t
 	}
 
 	std::vector<float> &noise_cache = g_noise_cache;
+	// The cache is thread-local, it could hold values from a previous run
+	noise_cache.clear();
+
+	bool noise_filter_done = false;
+
+#ifdef VOXEL_ENABLE_FAST_NOISE_2
+	// Filter out by noise, batched path.
+	// All candidate positions are evaluated with one SIMD batch, then survivors are compacted with
+	// a single stable pass (the serial form of a prefix-sum compaction), so there is no per-vertex
+	// virtual call and no branch-heavy removal loop.
+	if (_fast_noise_2.is_valid() && _fast_noise_2->is_valid()) {
+		ZN_PROFILE_SCOPE_NAMED("noise filter (FastNoise2)");
+
+		static thread_local std::vector<float> g_noise_series_x;
+		static thread_local std::vector<float> g_noise_series_y;
+		static thread_local std::vector<float> g_noise_series_z;
+
+		const size_t count = vertex_cache.size();
+		noise_cache.resize(count);
+		g_noise_series_x.resize(count);
+		g_noise_series_z.resize(count);
+
+		switch (_noise_dimension) {
+			case DIMENSION_2D: {
+				for (size_t i = 0; i < count; ++i) {
+					const Vector3 pos = vertex_cache[i] + block_local_transform.origin;
+					g_noise_series_x[i] = pos.x;
+					g_noise_series_z[i] = pos.z;
+				}
+				_fast_noise_2->get_noise_2d_series(to_span_const(g_noise_series_x), to_span_const(g_noise_series_z),
+						to_span(noise_cache));
+			} break;
+
+			case DIMENSION_3D: {
+				g_noise_series_y.resize(count);
+				for (size_t i = 0; i < count; ++i) {
+					const Vector3 pos = vertex_cache[i] + block_local_transform.origin;
+					g_noise_series_x[i] = pos.x;
+					g_noise_series_y[i] = pos.y;
+					g_noise_series_z[i] = pos.z;
+				}
+				_fast_noise_2->get_noise_3d_series(to_span_const(g_noise_series_x), to_span_const(g_noise_series_y),
+						to_span_const(g_noise_series_z), to_span(noise_cache));
+			} break;
+
+			default:
+				ERR_FAIL();
+		}
+
+		// Compact survivors
+		size_t dst_index = 0;
+		for (size_t i = 0; i < count; ++i) {
+			if (noise_cache[i] >= 0.f) {
+				vertex_cache[dst_index] = vertex_cache[i];
+				normal_cache[dst_index] = normal_cache[i];
+				noise_cache[dst_index] = noise_cache[i];
+				++dst_index;
+			}
+		}
+		vertex_cache.resize(dst_index);
+		normal_cache.resize(dst_index);
+		noise_cache.resize(dst_index);
+
+		noise_filter_done = true;
+	}
+#endif
 
 	// Filter out by noise
-	if (_noise.is_valid()) {
+	if (!noise_filter_done && _noise.is_valid()) {
 		ZN_PROFILE_SCOPE_NAMED("noise filter");
 
 		noise_cache.clear();
@@ -416,7 +483,7 @@ void VoxelInstanceGenerator::generate_transforms(std::vector<Transform3D> &out_t
 					break;
 			}
 
-			if (_noise.is_valid() && _noise_on_scale > 0.f) {
+			if (noise_cache.size() > 0 && _noise_on_scale > 0.f) {
 #ifdef DEBUG_ENABLED
 				CRASH_COND(vertex_index >= noise_cache.size());
 #endif
@@ -625,6 +692,28 @@ void VoxelInstanceGenerator::set_noise(Ref<Noise> noise) {
 	emit_changed();
 }
 
+#ifdef VOXEL_ENABLE_FAST_NOISE_2
+void VoxelInstanceGenerator::set_fast_noise_2(Ref<FastNoise2> noise) {
+	if (_fast_noise_2 == noise) {
+		return;
+	}
+	if (_fast_noise_2.is_valid()) {
+		_fast_noise_2->disconnect(CoreStringNames::get_singleton()->changed,
+				callable_mp(this, &VoxelInstanceGenerator::_on_noise_changed));
+	}
+	_fast_noise_2 = noise;
+	if (_fast_noise_2.is_valid()) {
+		_fast_noise_2->connect(CoreStringNames::get_singleton()->changed,
+				callable_mp(this, &VoxelInstanceGenerator::_on_noise_changed));
+	}
+	emit_changed();
+}
+
+Ref<FastNoise2> VoxelInstanceGenerator::get_fast_noise_2() const {
+	return _fast_noise_2;
+}
+#endif
+
 Ref<Noise> VoxelInstanceGenerator::get_noise() const {
 	return _noise;
 }
@@ -705,6 +794,11 @@ void VoxelInstanceGenerator::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_noise", "noise"), &VoxelInstanceGenerator::set_noise);
 	ClassDB::bind_method(D_METHOD("get_noise"), &VoxelInstanceGenerator::get_noise);
 
+#ifdef VOXEL_ENABLE_FAST_NOISE_2
+	ClassDB::bind_method(D_METHOD("set_fast_noise_2", "noise"), &VoxelInstanceGenerator::set_fast_noise_2);
+	ClassDB::bind_method(D_METHOD("get_fast_noise_2"), &VoxelInstanceGenerator::get_fast_noise_2);
+#endif
+
 	ClassDB::bind_method(D_METHOD("set_noise_dimension", "dim"), &VoxelInstanceGenerator::set_noise_dimension);
 	ClassDB::bind_method(D_METHOD("get_noise_dimension"), &VoxelInstanceGenerator::get_noise_dimension);
 
@@ -752,6 +846,10 @@ void VoxelInstanceGenerator::_bind_methods() {
 
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "noise", PROPERTY_HINT_RESOURCE_TYPE, "FastNoiseLite"), "set_noise",
 			"get_noise");
+#ifdef VOXEL_ENABLE_FAST_NOISE_2
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "fast_noise_2", PROPERTY_HINT_RESOURCE_TYPE, "FastNoise2"),
+			"set_fast_noise_2", "get_fast_noise_2");
+#endif
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "noise_dimension", PROPERTY_HINT_ENUM, "2D,3D"), "set_noise_dimension",
 			"get_noise_dimension");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "noise_on_scale", PROPERTY_HINT_RANGE, "0.0, 1.0, 0.01"),
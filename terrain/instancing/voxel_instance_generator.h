@@ -5,6 +5,10 @@
 #include "../../util/math/vector3i.h"
 #include <modules/noise/noise.h>
 
+#ifdef VOXEL_ENABLE_FAST_NOISE_2
+#include "../../util/noise/fast_noise_2.h"
+#endif
+
 #include <limits>
 #include <vector>
 
@@ -105,6 +109,13 @@ public:
 	void set_noise(Ref<Noise> noise);
 	Ref<Noise> get_noise() const;
 
+#ifdef VOXEL_ENABLE_FAST_NOISE_2
+	// SIMD-batched alternative to `noise`. When set, it takes precedence and the density filter
+	// evaluates all candidate positions in one batch instead of one virtual call per instance.
+	void set_fast_noise_2(Ref<FastNoise2> noise);
+	Ref<FastNoise2> get_fast_noise_2() const;
+#endif
+
 	void set_noise_dimension(Dimension dim);
 	Dimension get_noise_dimension() const;
 
@@ -134,6 +145,9 @@ private:
 	EmitMode _emit_mode = EMIT_FROM_VERTICES;
 	Distribution _scale_distribution = DISTRIBUTION_QUADRATIC;
 	Ref<Noise> _noise;
+#ifdef VOXEL_ENABLE_FAST_NOISE_2
+	Ref<FastNoise2> _fast_noise_2;
+#endif
 	Dimension _noise_dimension = DIMENSION_3D;
 	float _noise_on_scale = 0.f;
 
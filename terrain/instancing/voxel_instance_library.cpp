@@ -99,6 +99,9 @@ void VoxelInstanceLibrary::on_library_item_changed(int id, VoxelInstanceLibraryI
 }
 
 void VoxelInstanceLibrary::notify_listeners(int item_id, VoxelInstanceLibraryItem::ChangeType change) {
+	// Cached item resolutions are keyed on this
+	++_change_generation;
+
 	for (unsigned int i = 0; i < _listeners.size(); ++i) {
 		IListener *listener = _listeners[i];
 		listener->on_library_item_changed(item_id, change);
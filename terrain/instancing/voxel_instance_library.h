@@ -30,6 +30,12 @@ public:
 	const VoxelInstanceLibraryItem *get_item_const(int id) const;
 	VoxelInstanceLibraryItem *get_item(int id);
 
+	// Incremented whenever items get added, removed or changed, so resolved item pointers can be
+	// cached and invalidated cheaply (see VoxelInstancer)
+	inline uint32_t get_change_generation() const {
+		return _change_generation;
+	}
+
 	template <typename F>
 	void for_each_item(F f) {
 		for (Map<int, Ref<VoxelInstanceLibraryItem>>::Element *E = _items.front(); E != nullptr; E = E->next()) {
@@ -58,6 +64,8 @@ private:
 	// Using a Map keeps items ordered, so the last item has highest ID
 	Map<int, Ref<VoxelInstanceLibraryItem>> _items;
 
+	uint32_t _change_generation = 0;
+
 	std::vector<IListener *> _listeners;
 };
 
@@ -60,6 +60,8 @@ void VoxelInstancer::clear_blocks() {
 	for (unsigned int lod_index = 0; lod_index < _lods.size(); ++lod_index) {
 		Lod &lod = _lods[lod_index];
 		lod.modified_blocks.clear();
+		// In-flight async preparations must not re-create blocks either
+		lod.entered_render_blocks.clear();
 	}
 }
 
@@ -238,6 +240,16 @@ void VoxelInstancer::process_gizmos() {
 
 #endif
 
+VoxelInstanceLibraryItem *VoxelInstancer::get_library_item_cached(const Layer &layer, int item_id) const {
+	ERR_FAIL_COND_V(_library.is_null(), nullptr);
+	const uint32_t generation = _library->get_change_generation();
+	if (layer.cached_item == nullptr || layer.cached_item_generation != generation) {
+		layer.cached_item = _library->get_item(item_id);
+		layer.cached_item_generation = generation;
+	}
+	return layer.cached_item;
+}
+
 VoxelInstancer::Layer &VoxelInstancer::get_layer(int id) {
 	auto it = _layers.find(id);
 	ZN_ASSERT(it != _layers.end());
@@ -293,7 +305,7 @@ void VoxelInstancer::process_mesh_lods() {
 	for (auto it = _blocks.begin(); it != _blocks.end(); ++it) {
 		Block &block = **it;
 
-		const VoxelInstanceLibraryItem *item_base = _library->get_item_const(block.layer_id);
+		const VoxelInstanceLibraryItem *item_base = get_library_item_cached(get_layer(block.layer_id), block.layer_id);
 		ERR_CONTINUE(item_base == nullptr);
 		// TODO Optimization: would be nice to not need this cast by iterating only the same item types
 		const VoxelInstanceLibraryMultiMeshItem *item = Object::cast_to<VoxelInstanceLibraryMultiMeshItem>(item_base);
@@ -341,6 +353,144 @@ void VoxelInstancer::process_mesh_lods() {
 				multimesh->set_mesh(item->get_mesh(block.current_mesh_lod));
 			}
 		}
+
+		// All-or-nothing switching renders a whole block at the detailed mesh as long as its
+		// center is near, even though in a dense vegetation block most instances can sit beyond
+		// the boundary. While a boundary crosses the block itself, partition its instances by
+		// distance instead, so only the near bucket pays full vertex cost.
+		if (_mesh_lod_splitting_enabled) {
+			update_mesh_lod_split(block, *item, lod, mesh_lod_count, cam_pos_local, lod_block_size);
+		} else {
+			clear_mesh_lod_split(block);
+		}
+	}
+}
+
+void VoxelInstancer::update_mesh_lod_split(Block &block, const VoxelInstanceLibraryMultiMeshItem &item,
+		const Lod &lod, int mesh_lod_count, Vector3 cam_pos_local, int lod_block_size) {
+	Ref<MultiMesh> multimesh = block.multimesh_instance.get_multimesh();
+	if (multimesh.is_null()) {
+		clear_mesh_lod_split(block);
+		return;
+	}
+
+	const int hs = lod_block_size >> 1;
+	const Vector3 block_center_local(block.grid_position * lod_block_size + Vector3i(hs, hs, hs));
+	const float block_distance = cam_pos_local.distance_to(block_center_local);
+	// Circumscribed radius: a boundary sphere closer to the center than this can cross the block
+	const float block_radius = 0.5f * Math::sqrt(3.f) * float(lod_block_size);
+
+	// Nearest mesh LOD boundary actually crossing the block, if any. Only the boundaries on
+	// either side of the current mesh LOD can do so, thanks to the hysteresis switching above.
+	int boundary_index = -1;
+	float boundary_distance = 0.f;
+	for (int j = math::max(int(block.current_mesh_lod) - 1, 0);
+			j <= math::min(int(block.current_mesh_lod), mesh_lod_count - 2); ++j) {
+		const float b = Math::sqrt(lod.mesh_lod_distances[j].exit_distance_squared);
+		if (Math::abs(block_distance - b) < block_radius) {
+			boundary_index = j;
+			boundary_distance = b;
+			break;
+		}
+	}
+
+	if (boundary_index == -1) {
+		clear_mesh_lod_split(block);
+		return;
+	}
+
+	if (block.mesh_lod_split_active && boundary_index == block.split_boundary_index &&
+			cam_pos_local.distance_squared_to(block.split_last_cam_pos) <
+					math::squared(0.125f * float(lod_block_size))) {
+		// The viewer barely moved since the partition was built, bucket membership can only have
+		// changed marginally
+		return;
+	}
+
+	// Partition the canonical population by per-instance distance. Reads go through the
+	// RenderingServer like the save path does; they only happen for boundary-crossing blocks
+	// after real viewer movement.
+	const int instance_count = get_visible_instance_count(**multimesh);
+	static thread_local std::vector<Transform3D> tls_near_transforms;
+	static thread_local std::vector<Transform3D> tls_far_transforms;
+	tls_near_transforms.clear();
+	tls_far_transforms.clear();
+	const Vector3 block_origin(block.grid_position * lod_block_size);
+	const float boundary_distance_squared = boundary_distance * boundary_distance;
+	for (int i = 0; i < instance_count; ++i) {
+		const Transform3D t = multimesh->get_instance_transform(i);
+		if (cam_pos_local.distance_squared_to(block_origin + t.origin) < boundary_distance_squared) {
+			tls_near_transforms.push_back(t);
+		} else {
+			tls_far_transforms.push_back(t);
+		}
+	}
+
+	Ref<World3D> maybe_world = get_world_3d();
+	ERR_FAIL_COND(maybe_world.is_null());
+	World3D &world = **maybe_world;
+	const Transform3D block_transform = get_global_transform() * Transform3D(Basis(), block_origin);
+
+	set_split_bucket(block.split_near_instance, item.get_mesh(boundary_index), to_span_const(tls_near_transforms),
+			world, block_transform, item);
+	set_split_bucket(block.split_far_instance, item.get_mesh(boundary_index + 1), to_span_const(tls_far_transforms),
+			world, block_transform, item);
+
+	// The canonical multimesh keeps the full population for edits and saves but stops rendering
+	block.multimesh_instance.set_visible(false);
+	block.mesh_lod_split_active = true;
+	block.split_boundary_index = boundary_index;
+	block.split_last_cam_pos = cam_pos_local;
+}
+
+void VoxelInstancer::set_split_bucket(DirectMultiMeshInstance &dmmi, Ref<Mesh> mesh,
+		Span<const Transform3D> transforms, World3D &world, const Transform3D &block_transform,
+		const VoxelInstanceLibraryMultiMeshItem &item) {
+	if (transforms.size() == 0) {
+		if (dmmi.is_valid()) {
+			dmmi.set_multimesh(Ref<MultiMesh>());
+			dmmi.destroy();
+		}
+		return;
+	}
+	Ref<MultiMesh> multimesh = dmmi.get_multimesh();
+	if (multimesh.is_null()) {
+		multimesh.instantiate();
+		multimesh->set_transform_format(MultiMesh::TRANSFORM_3D);
+		multimesh->set_use_colors(false);
+		multimesh->set_use_custom_data(false);
+	}
+	PackedFloat32Array bulk_array;
+	DirectMultiMeshInstance::make_transform_3d_bulk_array(transforms, bulk_array);
+	multimesh->set_instance_count(transforms.size());
+	multimesh->set_mesh(mesh);
+	if (!dmmi.is_valid()) {
+		dmmi.create();
+		dmmi.set_visible(is_visible());
+	}
+	dmmi.set_multimesh(multimesh);
+	dmmi.set_transform_buffer(bulk_array);
+	dmmi.set_world(&world);
+	dmmi.set_transform(block_transform);
+	dmmi.set_material_override(item.get_material_override());
+	dmmi.set_cast_shadows_setting(item.get_cast_shadows_setting());
+}
+
+void VoxelInstancer::clear_mesh_lod_split(Block &block) {
+	if (!block.mesh_lod_split_active) {
+		return;
+	}
+	block.mesh_lod_split_active = false;
+	if (block.split_near_instance.is_valid()) {
+		block.split_near_instance.set_multimesh(Ref<MultiMesh>());
+		block.split_near_instance.destroy();
+	}
+	if (block.split_far_instance.is_valid()) {
+		block.split_far_instance.set_multimesh(Ref<MultiMesh>());
+		block.split_far_instance.destroy();
+	}
+	if (block.multimesh_instance.is_valid()) {
+		block.multimesh_instance.set_visible(is_visible_in_tree());
 	}
 }
 
@@ -353,7 +503,13 @@ void VoxelInstancer::update_visibility() {
 	for (auto it = _blocks.begin(); it != _blocks.end(); ++it) {
 		Block &block = **it;
 		if (block.multimesh_instance.is_valid()) {
-			block.multimesh_instance.set_visible(visible);
+			block.multimesh_instance.set_visible(visible && !block.mesh_lod_split_active);
+		}
+		if (block.split_near_instance.is_valid()) {
+			block.split_near_instance.set_visible(visible);
+		}
+		if (block.split_far_instance.is_valid()) {
+			block.split_far_instance.set_visible(visible);
 		}
 	}
 }
@@ -364,6 +520,12 @@ void VoxelInstancer::set_world(World3D *world) {
 		if (block.multimesh_instance.is_valid()) {
 			block.multimesh_instance.set_world(world);
 		}
+		if (block.split_near_instance.is_valid()) {
+			block.split_near_instance.set_world(world);
+		}
+		if (block.split_far_instance.is_valid()) {
+			block.split_far_instance.set_world(world);
+		}
 	}
 }
 
@@ -563,6 +725,8 @@ void VoxelInstancer::update_layer_meshes(int layer_id) {
 		if (block.layer_id != layer_id || !block.multimesh_instance.is_valid()) {
 			continue;
 		}
+		// Rebuilt next update with the new meshes and materials
+		clear_mesh_lod_split(block);
 		block.multimesh_instance.set_material_override(item->get_material_override());
 		block.multimesh_instance.set_cast_shadows_setting(item->get_cast_shadows_setting());
 		Ref<MultiMesh> multimesh = block.multimesh_instance.get_multimesh();
@@ -734,7 +898,8 @@ void VoxelInstancer::on_data_block_loaded(
 		Vector3i grid_position, unsigned int lod_index, UniquePtr<InstanceBlockData> instances) {
 	ERR_FAIL_COND(lod_index >= _lods.size());
 	Lod &lod = _lods[lod_index];
-	lod.loaded_instances_data.insert(std::make_pair(grid_position, std::move(instances)));
+	lod.loaded_instances_data.insert(
+			std::make_pair(grid_position, std::shared_ptr<InstanceBlockData>(std::move(instances))));
 }
 
 void VoxelInstancer::on_mesh_block_enter(Vector3i render_grid_position, unsigned int lod_index, Array surface_arrays) {
@@ -753,6 +918,9 @@ void VoxelInstancer::on_mesh_block_exit(Vector3i render_grid_position, unsigned
 
 	Lod &lod = _lods[lod_index];
 
+	// Instances prepared asynchronously for this block must no longer be applied
+	lod.entered_render_blocks.erase(render_grid_position);
+
 	// Remove data blocks
 	const int render_to_data_factor = 1 << (_parent_mesh_block_size_po2 - _parent_data_block_size_po2);
 	ERR_FAIL_COND(render_to_data_factor <= 0 || render_to_data_factor > 2);
@@ -855,6 +1023,14 @@ void VoxelInstancer::update_block_from_transforms(int block_index, Span<const Tr
 #endif
 	Block &block = *_blocks[block_index];
 
+	// The canonical population changes wholesale, any render split is stale
+	clear_mesh_lod_split(block);
+
+	// Callers knowing the transforms came from the generator set tracking back up afterwards
+	block.tracks_generated_instances = false;
+	block.generated_instance_count = 0;
+	block.generated_instance_indices.clear();
+
 	// Update multimesh
 	const VoxelInstanceLibraryMultiMeshItem *item = Object::cast_to<VoxelInstanceLibraryMultiMeshItem>(&item_base);
 	if (item != nullptr) {
@@ -863,6 +1039,8 @@ void VoxelInstancer::update_block_from_transforms(int block_index, Span<const Tr
 				block.multimesh_instance.set_multimesh(Ref<MultiMesh>());
 				block.multimesh_instance.destroy();
 			}
+			block.instance_cells.clear();
+			block.instance_cells_valid = false;
 
 		} else {
 			Ref<MultiMesh> multimesh = block.multimesh_instance.get_multimesh();
@@ -877,9 +1055,6 @@ void VoxelInstancer::update_block_from_transforms(int block_index, Span<const Tr
 			PackedFloat32Array bulk_array;
 			DirectMultiMeshInstance::make_transform_3d_bulk_array(transforms, bulk_array);
 			multimesh->set_instance_count(transforms.size());
-			// TODO Waiting for Godot to expose the method on the resource object
-			//multimesh->set_as_bulk_array(bulk_array);
-			RenderingServer::get_singleton()->multimesh_set_buffer(multimesh->get_rid(), bulk_array);
 
 			if (item->get_mesh_lod_count() > 0) {
 				multimesh->set_mesh(item->get_mesh(item->get_mesh_lod_count() - 1));
@@ -890,6 +1065,10 @@ void VoxelInstancer::update_block_from_transforms(int block_index, Span<const Tr
 				block.multimesh_instance.set_visible(is_visible());
 			}
 			block.multimesh_instance.set_multimesh(multimesh);
+			// Uploads the whole buffer and keeps a local copy, so later edits of this block only
+			// send the instances that changed
+			block.multimesh_instance.set_transform_buffer(bulk_array);
+			rebuild_instance_cell_index(block);
 			block.multimesh_instance.set_world(&world);
 			block.multimesh_instance.set_transform(block_transform);
 			block.multimesh_instance.set_material_override(item->get_material_override());
@@ -1004,101 +1183,309 @@ void VoxelInstancer::create_render_blocks(Vector3i render_grid_position, int lod
 	ZN_PROFILE_SCOPE();
 	ERR_FAIL_COND(_library.is_null());
 
-	// TODO Query one or multiple data blocks if any
+	// Transform generation (noise over the surface) and edited-data merging are the expensive
+	// parts; they run on a worker with data snapshotted here, and only the RenderingServer-facing
+	// work comes back to the main thread, spread under the time budget. Moving fast over dense
+	// forests used to spike the frame doing all of this synchronously.
+
+	// Self-contained inputs for one layer
+	struct LayerJob {
+		uint16_t layer_id;
+		Ref<VoxelInstanceLibraryItem> item;
+		// Edited data per octant of the render block, in ZYX octant order; null when untouched
+		std::vector<std::shared_ptr<const InstanceBlockData>> edited_data_per_octant;
+	};
 
-	Lod &lod = _lods[lod_index];
-	const Transform3D parent_transform = get_global_transform();
-	Ref<World3D> maybe_world = get_world_3d();
-	ERR_FAIL_COND(maybe_world.is_null());
-	World3D &world = **maybe_world;
+	class PrepareInstancesTask : public IThreadedTask {
+	public:
+		ObjectID instancer_object_id;
+		Vector3i render_grid_position;
+		int lod_index;
+		Array surface_arrays;
+		Transform3D block_local_transform;
+		int lod_render_block_size;
+		int render_to_data_factor;
+		VoxelInstanceGenerator::UpMode up_mode;
+		Vector3 block_world_center;
+		std::vector<LayerJob> jobs;
+		std::vector<VoxelInstancer::PreparedInstanceLayer> results;
+
+		void run(ThreadedTaskContext ctx) override {
+			ZN_PROFILE_SCOPE();
 
-	const int mesh_block_size = (1 << _parent_mesh_block_size_po2);
-	const int lod_block_size = mesh_block_size << lod_index;
-	const Transform3D block_local_transform = Transform3D(Basis(), render_grid_position * lod_block_size);
-	const Transform3D block_transform = parent_transform * block_local_transform;
+			for (unsigned int job_index = 0; job_index < jobs.size(); ++job_index) {
+				LayerJob &job = jobs[job_index];
+
+				VoxelInstancer::PreparedInstanceLayer result;
+				result.layer_id = job.layer_id;
+				result.item = job.item;
+				result.all_from_generator = true;
+
+				uint8_t gen_octant_mask = 0xff;
+				// Set when the saved data for this layer is a delta over generator output.
+				// Only supported when one data block covers the render block.
+				const InstanceBlockData::LayerData *delta_layer_data = nullptr;
+
+				// Fill in edited data
+				for (unsigned int octant_index = 0; octant_index < job.edited_data_per_octant.size();
+						++octant_index) {
+					const std::shared_ptr<const InstanceBlockData> &instances_data =
+							job.edited_data_per_octant[octant_index];
+					if (instances_data == nullptr) {
+						continue;
+					}
 
-	const int render_to_data_factor = mesh_block_size / (1 << _parent_data_block_size_po2);
-	const Vector3i data_min_pos = render_grid_position * render_to_data_factor;
-	const Vector3i data_max_pos = data_min_pos + Vector3iUtil::create(render_to_data_factor);
+					const InstanceBlockData::LayerData *layer_data =
+							find_layer_data(*instances_data, job.layer_id);
+					if (layer_data == nullptr) {
+						continue;
+					}
 
-	const int lod_render_block_size = mesh_block_size << lod_index;
+					if (layer_data->is_delta) {
+						// Delta-saved layer: the generator output is reproduced below, then the
+						// recorded removals are applied. The octant bit stays set so it generates.
+						delta_layer_data = layer_data;
 
-	for (auto layer_it = lod.layers.begin(); layer_it != lod.layers.end(); ++layer_it) {
-		const int layer_id = *layer_it;
+					} else {
+						for (auto it = layer_data->instances.begin(); it != layer_data->instances.end(); ++it) {
+							const InstanceBlockData::InstanceData &d = *it;
+							result.transforms.push_back(d.transform);
+						}
 
-		Layer &layer = get_layer(layer_id);
+						// These transforms don't correspond to generator output anymore
+						result.all_from_generator = false;
 
-		if (layer.blocks.find(render_grid_position) != layer.blocks.end()) {
-			// The block was already made?
-			continue;
+						// Unset bit for this octant so it won't be generated
+						gen_octant_mask &= ~(1 << octant_index);
+					}
+				}
+
+				// Generate the rest
+				if (gen_octant_mask != 0 && surface_arrays.size() != 0 && job.item->get_generator().is_valid()) {
+					PackedVector3Array vertices = surface_arrays[ArrayMesh::ARRAY_VERTEX];
+
+					if (vertices.size() != 0) {
+						PackedVector3Array normals = surface_arrays[ArrayMesh::ARRAY_NORMAL];
+						ERR_CONTINUE(normals.size() == 0);
+
+						ZN_PROFILE_SCOPE();
+
+						static thread_local std::vector<Transform3D> s_generated_transforms;
+						s_generated_transforms.clear();
+
+						job.item->get_generator()->generate_transforms(s_generated_transforms,
+								render_grid_position, lod_index, job.layer_id, surface_arrays,
+								block_local_transform, up_mode, gen_octant_mask, lod_render_block_size);
+
+						result.generated_count = s_generated_transforms.size();
+
+						if (delta_layer_data != nullptr && render_to_data_factor == 1) {
+							if (delta_layer_data->generated_count == result.generated_count) {
+								// Apply the recorded removals to reproduce the edited state
+								static thread_local std::vector<uint8_t> tls_removed_flags;
+								tls_removed_flags.clear();
+								tls_removed_flags.resize(result.generated_count, 0);
+								for (auto it = delta_layer_data->removed_indices.begin();
+										it != delta_layer_data->removed_indices.end(); ++it) {
+									tls_removed_flags[*it] = 1;
+								}
+								for (unsigned int i = 0; i < s_generated_transforms.size(); ++i) {
+									if (tls_removed_flags[i] == 0) {
+										result.transforms.push_back(s_generated_transforms[i]);
+										result.generated_indices.push_back(i);
+									}
+								}
+
+							} else {
+								// The generator or its settings changed since the delta was saved,
+								// the removals can't be mapped anymore. Recorded edits are lost.
+								ZN_PRINT_VERBOSE(
+										format("Instance delta mismatch in block {}: expected {} generated, got {}",
+												render_grid_position, delta_layer_data->generated_count,
+												result.generated_count));
+								for (unsigned int i = 0; i < s_generated_transforms.size(); ++i) {
+									result.transforms.push_back(s_generated_transforms[i]);
+									result.generated_indices.push_back(i);
+								}
+							}
+
+						} else {
+							for (unsigned int i = 0; i < s_generated_transforms.size(); ++i) {
+								result.transforms.push_back(s_generated_transforms[i]);
+								result.generated_indices.push_back(i);
+							}
+						}
+					}
+				}
+
+				results.push_back(std::move(result));
+			}
 		}
 
-		_transform_cache.clear();
+		void apply_result() override {
+			// Only the scene tree owner may apply; it can have been freed while we were working
+			Object *obj = ObjectDB::get_instance(instancer_object_id);
+			if (obj == nullptr) {
+				return;
+			}
+			VoxelInstancer *instancer = Object::cast_to<VoxelInstancer>(obj);
+			ERR_FAIL_COND(instancer == nullptr);
+
+			// Final RenderingServer and physics work goes through the budgeted main-thread runner,
+			// close blocks first
+			class ApplyInstancesTask : public ITimeSpreadTask {
+			public:
+				ObjectID instancer_object_id;
+				Vector3i render_grid_position;
+				int lod_index;
+				std::vector<VoxelInstancer::PreparedInstanceLayer> results;
+
+				void run(TimeSpreadTaskContext &ctx) override {
+					Object *obj = ObjectDB::get_instance(instancer_object_id);
+					if (obj == nullptr) {
+						return;
+					}
+					VoxelInstancer *instancer = Object::cast_to<VoxelInstancer>(obj);
+					ERR_FAIL_COND(instancer == nullptr);
+					instancer->apply_prepared_render_block(render_grid_position, lod_index, results);
+				}
+			};
+
+			ApplyInstancesTask *task = memnew(ApplyInstancesTask);
+			task->instancer_object_id = instancer_object_id;
+			task->render_grid_position = render_grid_position;
+			task->lod_index = lod_index;
+			task->results = std::move(results);
+			VoxelServer::get_singleton().push_main_thread_time_spread_task(
+					task, VoxelServer::get_singleton().get_main_thread_time_spread_priority(block_world_center));
+		}
+	};
 
-		uint8_t gen_octant_mask = 0xff;
+	Lod &lod = _lods[lod_index];
+	lod.entered_render_blocks.insert(render_grid_position);
+
+	const int mesh_block_size = (1 << _parent_mesh_block_size_po2);
+	const int lod_block_size = mesh_block_size << lod_index;
+	const int render_to_data_factor = mesh_block_size / (1 << _parent_data_block_size_po2);
+	const Vector3i data_min_pos = render_grid_position * render_to_data_factor;
+	const Vector3i data_max_pos = data_min_pos + Vector3iUtil::create(render_to_data_factor);
 
-		// Fill in edited data
-		unsigned int octant_index = 0;
+	PrepareInstancesTask *task = memnew(PrepareInstancesTask);
+	task->instancer_object_id = get_instance_id();
+	task->render_grid_position = render_grid_position;
+	task->lod_index = lod_index;
+	task->surface_arrays = surface_arrays;
+	task->block_local_transform = Transform3D(Basis(), render_grid_position * lod_block_size);
+	task->lod_render_block_size = lod_block_size;
+	task->render_to_data_factor = render_to_data_factor;
+	task->up_mode = static_cast<VoxelInstanceGenerator::UpMode>(_up_mode);
+	task->block_world_center = get_global_transform().xform(
+			task->block_local_transform.origin + 0.5 * Vector3(lod_block_size, lod_block_size, lod_block_size));
+
+	// Snapshot edited data covering this render block, shared with the worker (entries are not
+	// mutated after loading)
+	std::vector<std::shared_ptr<const InstanceBlockData>> edited_data_per_octant;
+	{
 		Vector3i data_grid_pos;
 		for (data_grid_pos.z = data_min_pos.z; data_grid_pos.z < data_max_pos.z; ++data_grid_pos.z) {
 			for (data_grid_pos.y = data_min_pos.y; data_grid_pos.y < data_max_pos.y; ++data_grid_pos.y) {
 				for (data_grid_pos.x = data_min_pos.x; data_grid_pos.x < data_max_pos.x; ++data_grid_pos.x) {
 					auto instances_data_it = lod.loaded_instances_data.find(data_grid_pos);
-
 					if (instances_data_it != lod.loaded_instances_data.end()) {
-						// This area has user-edited instances
+						edited_data_per_octant.push_back(instances_data_it->second);
+					} else {
+						edited_data_per_octant.push_back(nullptr);
+					}
+				}
+			}
+		}
+	}
 
-						const InstanceBlockData *instances_data = instances_data_it->second.get();
-						CRASH_COND(instances_data == nullptr);
+	for (auto layer_it = lod.layers.begin(); layer_it != lod.layers.end(); ++layer_it) {
+		const int layer_id = *layer_it;
 
-						const InstanceBlockData::LayerData *layer_data = find_layer_data(*instances_data, layer_id);
+		Layer &layer = get_layer(layer_id);
 
-						if (layer_data == nullptr) {
-							continue;
-						}
+		if (layer.blocks.find(render_grid_position) != layer.blocks.end()) {
+			// The block was already made?
+			continue;
+		}
 
-						for (auto it = layer_data->instances.begin(); it != layer_data->instances.end(); ++it) {
-							const InstanceBlockData::InstanceData &d = *it;
-							_transform_cache.push_back(d.transform);
-						}
+		VoxelInstanceLibraryItem *item = get_library_item_cached(layer, layer_id);
+		CRASH_COND(item == nullptr);
 
-						// Unset bit for this octant so it won't be generated
-						gen_octant_mask &= ~(1 << octant_index);
-					}
+		LayerJob job;
+		job.layer_id = layer_id;
+		job.item = Ref<VoxelInstanceLibraryItem>(item);
+		job.edited_data_per_octant = edited_data_per_octant;
+		task->jobs.push_back(std::move(job));
+	}
 
-					++octant_index;
-				}
-			}
-		}
+	if (task->jobs.size() == 0) {
+		memdelete(task);
+		return;
+	}
 
-		const VoxelInstanceLibraryItem *item = _library->get_item(layer_id);
-		CRASH_COND(item == nullptr);
+	VoxelServer::get_singleton().push_async_task(task);
+}
 
-		// Generate the rest
-		if (gen_octant_mask != 0 && surface_arrays.size() != 0 && item->get_generator().is_valid()) {
-			PackedVector3Array vertices = surface_arrays[ArrayMesh::ARRAY_VERTEX];
+void VoxelInstancer::apply_prepared_render_block(
+		Vector3i render_grid_position, int lod_index, std::vector<PreparedInstanceLayer> &layers) {
+	ZN_PROFILE_SCOPE();
+	if (_library.is_null() || lod_index >= int(_lods.size()) || !is_inside_tree()) {
+		return;
+	}
+	{
+		const Lod &lod = _lods[lod_index];
+		if (lod.entered_render_blocks.find(render_grid_position) == lod.entered_render_blocks.end()) {
+			// The render block exited while instances were being prepared
+			return;
+		}
+	}
 
-			if (vertices.size() != 0) {
-				PackedVector3Array normals = surface_arrays[ArrayMesh::ARRAY_NORMAL];
-				ERR_FAIL_COND(normals.size() == 0);
+	Ref<World3D> maybe_world = get_world_3d();
+	ERR_FAIL_COND(maybe_world.is_null());
+	World3D &world = **maybe_world;
 
-				ZN_PROFILE_SCOPE();
+	const int mesh_block_size = (1 << _parent_mesh_block_size_po2);
+	const int lod_block_size = mesh_block_size << lod_index;
+	const int render_to_data_factor = mesh_block_size / (1 << _parent_data_block_size_po2);
+	const Transform3D block_local_transform = Transform3D(Basis(), render_grid_position * lod_block_size);
+	const Transform3D block_transform = get_global_transform() * block_local_transform;
 
-				static thread_local std::vector<Transform3D> s_generated_transforms;
-				s_generated_transforms.clear();
+	for (unsigned int i = 0; i < layers.size(); ++i) {
+		PreparedInstanceLayer &prepared = layers[i];
 
-				item->get_generator()->generate_transforms(s_generated_transforms, render_grid_position, lod_index,
-						layer_id, surface_arrays, block_local_transform,
-						static_cast<VoxelInstanceGenerator::UpMode>(_up_mode), gen_octant_mask, lod_render_block_size);
+		// Layers and items can have changed while the preparation ran
+		auto layer_map_it = _layers.find(prepared.layer_id);
+		if (layer_map_it == _layers.end()) {
+			continue;
+		}
+		Layer &layer = layer_map_it->second;
+		if (layer.blocks.find(render_grid_position) != layer.blocks.end()) {
+			continue;
+		}
+		const VoxelInstanceLibraryItem *item = get_library_item_cached(layer, prepared.layer_id);
+		if (item == nullptr || item != prepared.item.ptr()) {
+			// The library changed since preparation, the transforms may no longer match
+			continue;
+		}
 
-				for (auto it = s_generated_transforms.begin(); it != s_generated_transforms.end(); ++it) {
-					_transform_cache.push_back(*it);
-				}
+		update_block_from_transforms(-1, to_span_const(prepared.transforms), render_grid_position, layer, *item,
+				prepared.layer_id, world, block_transform);
+
+		if (prepared.all_from_generator && render_to_data_factor == 1 && prepared.generated_indices.size() > 0 &&
+				Object::cast_to<VoxelInstanceLibraryMultiMeshItem>(item) != nullptr) {
+			// All instances of the block map to generator output, remember their generation-order
+			// indices so edits can be saved as deltas
+			auto block_it = layer.blocks.find(render_grid_position);
+			if (block_it != layer.blocks.end()) {
+				Block &block = *_blocks[block_it->second];
+				block.tracks_generated_instances = true;
+				block.generated_instance_count = prepared.generated_count;
+				block.generated_instance_indices = std::move(prepared.generated_indices);
 			}
 		}
-
-		update_block_from_transforms(-1, to_span_const(_transform_cache), render_grid_position, layer, *item, layer_id,
-				world, block_transform);
 	}
 }
 
@@ -1126,7 +1513,7 @@ void VoxelInstancer::save_block(Vector3i data_grid_pos, int lod_index) const {
 	for (auto it = lod.layers.begin(); it != lod.layers.end(); ++it) {
 		const int layer_id = *it;
 
-		const VoxelInstanceLibraryItem *item = _library->get_item_const(layer_id);
+		const VoxelInstanceLibraryItem *item = get_library_item_cached(get_layer_const(layer_id), layer_id);
 		CRASH_COND(item == nullptr);
 		if (!item->is_persistent()) {
 			continue;
@@ -1172,7 +1559,27 @@ void VoxelInstancer::save_block(Vector3i data_grid_pos, int lod_index) const {
 
 			const int instance_count = get_visible_instance_count(**multimesh);
 
-			if (render_to_data_factor == 1) {
+			if (render_to_data_factor == 1 && render_block.tracks_generated_instances &&
+					render_block.generated_instance_indices.size() == unsigned(instance_count)) {
+				// Delta save: everything still maps to generator output, so only removed
+				// generated instances are recorded instead of every transform
+				layer_data.is_delta = true;
+				layer_data.generated_count = render_block.generated_instance_count;
+
+				static thread_local std::vector<uint8_t> tls_present_flags;
+				tls_present_flags.clear();
+				tls_present_flags.resize(render_block.generated_instance_count, 0);
+				for (auto it = render_block.generated_instance_indices.begin();
+						it != render_block.generated_instance_indices.end(); ++it) {
+					tls_present_flags[*it] = 1;
+				}
+				for (uint32_t i = 0; i < render_block.generated_instance_count; ++i) {
+					if (tls_present_flags[i] == 0) {
+						layer_data.removed_indices.push_back(i);
+					}
+				}
+
+			} else if (render_to_data_factor == 1) {
 				layer_data.instances.resize(instance_count);
 
 				// TODO Optimization: it would be nice to get the whole array at once
@@ -1232,6 +1639,73 @@ void VoxelInstancer::save_block(Vector3i data_grid_pos, int lod_index) const {
 	VoxelServer::get_singleton().request_instance_block_save(volume_id, std::move(data), data_grid_pos, lod_index);
 }
 
+namespace {
+inline Vector3i instance_cell_from_position(Vector3 position_local) {
+	return math::floor_to_int(position_local) >> VoxelInstancer::INSTANCE_CELL_SIZE_PO2;
+}
+} // namespace
+
+void VoxelInstancer::rebuild_instance_cell_index(Block &block) {
+	ZN_PROFILE_SCOPE();
+	block.instance_cells.clear();
+	if (!block.multimesh_instance.is_valid() || !block.multimesh_instance.has_transform_buffer()) {
+		// Without the local buffer, positions would have to be pulled from the RenderingServer;
+		// such blocks keep the linear scan
+		block.instance_cells_valid = false;
+		return;
+	}
+	const unsigned int instance_count = block.multimesh_instance.get_buffered_instance_count();
+	for (unsigned int i = 0; i < instance_count; ++i) {
+		const Transform3D t = block.multimesh_instance.get_buffered_transform(i);
+		block.instance_cells[instance_cell_from_position(t.origin)].push_back(i);
+	}
+	block.instance_cells_valid = true;
+}
+
+void VoxelInstancer::instance_cells_remove(Block &block, Vector3 position_local, uint32_t instance_index) {
+	if (!block.instance_cells_valid) {
+		return;
+	}
+	auto it = block.instance_cells.find(instance_cell_from_position(position_local));
+	if (it == block.instance_cells.end()) {
+		// Out of sync, safer to fall back to linear scans than to miss instances
+		block.instance_cells_valid = false;
+		return;
+	}
+	std::vector<uint32_t> &indices = it->second;
+	for (unsigned int i = 0; i < indices.size(); ++i) {
+		if (indices[i] == instance_index) {
+			indices[i] = indices.back();
+			indices.pop_back();
+			if (indices.size() == 0) {
+				block.instance_cells.erase(it);
+			}
+			return;
+		}
+	}
+	block.instance_cells_valid = false;
+}
+
+void VoxelInstancer::instance_cells_relocate(
+		Block &block, Vector3 position_local, uint32_t old_index, uint32_t new_index) {
+	if (!block.instance_cells_valid || old_index == new_index) {
+		return;
+	}
+	auto it = block.instance_cells.find(instance_cell_from_position(position_local));
+	if (it == block.instance_cells.end()) {
+		block.instance_cells_valid = false;
+		return;
+	}
+	std::vector<uint32_t> &indices = it->second;
+	for (unsigned int i = 0; i < indices.size(); ++i) {
+		if (indices[i] == old_index) {
+			indices[i] = new_index;
+			return;
+		}
+	}
+	block.instance_cells_valid = false;
+}
+
 void VoxelInstancer::remove_floating_multimesh_instances(Block &block, const Transform3D &parent_transform,
 		Box3i p_voxel_box, const VoxelTool &voxel_tool, int block_size_po2) {
 	if (!block.multimesh_instance.is_valid()) {
@@ -1248,13 +1722,47 @@ void VoxelInstancer::remove_floating_multimesh_instances(Block &block, const Tra
 	const Transform3D block_global_transform =
 			Transform3D(parent_transform.basis, parent_transform.xform(block.grid_position << block_size_po2));
 
-	// Let's check all instances one by one
-	// Note: the fact we have to query VisualServer in and out is pretty bad though.
-	// - We probably have to sync with its thread in MT mode
-	// - A hashmap RID lookup is performed to check `RID_Owner::id_map`
-	for (int instance_index = 0; instance_index < instance_count; ++instance_index) {
-		// TODO Optimize: This is terrible in MT mode! Think about keeping a local copy...
-		const Transform3D mm_transform = multimesh->get_instance_transform(instance_index);
+	// Most blocks maintain a local copy of the transform buffer, which avoids querying the
+	// VisualServer in and out (that would sync with its thread in MT mode, and do a hashmap RID
+	// lookup in `RID_Owner::id_map` every call).
+	const bool use_local_buffer = block.multimesh_instance.has_transform_buffer();
+
+	// With a valid spatial hash, only instances in cells overlapping the edited box are
+	// candidates, instead of scanning the whole population (10k+ under forests). Candidates are
+	// processed in descending index order so swap-removals can't disturb pending ones, and each
+	// is still re-checked exactly like the linear scan does.
+	static thread_local std::vector<uint32_t> tls_candidate_indices;
+	tls_candidate_indices.clear();
+	const bool use_cells = block.instance_cells_valid && use_local_buffer;
+	if (use_cells) {
+		const Box3i local_box(p_voxel_box.pos - math::floor_to_int(block_global_transform.origin), p_voxel_box.size);
+		const Box3i cell_box = local_box.padded(1).downscaled(1 << INSTANCE_CELL_SIZE_PO2);
+		cell_box.for_each_cell([&block](Vector3i cell_pos) {
+			auto it = block.instance_cells.find(cell_pos);
+			if (it != block.instance_cells.end()) {
+				for (const uint32_t index : it->second) {
+					tls_candidate_indices.push_back(index);
+				}
+			}
+		});
+		std::sort(tls_candidate_indices.begin(), tls_candidate_indices.end(),
+				[](uint32_t a, uint32_t b) { return a > b; });
+	} else {
+		for (int i = instance_count - 1; i >= 0; --i) {
+			tls_candidate_indices.push_back(i);
+		}
+	}
+
+	for (const uint32_t candidate_index : tls_candidate_indices) {
+		const int instance_index = candidate_index;
+		if (instance_index >= instance_count) {
+			// Stale hash entry; fall back to correctness over speed next time
+			block.instance_cells_valid = false;
+			continue;
+		}
+		const Transform3D mm_transform = use_local_buffer
+				? block.multimesh_instance.get_buffered_transform(instance_index)
+				: multimesh->get_instance_transform(instance_index);
 		const Vector3i voxel_pos(math::floor_to_int(mm_transform.origin + block_global_transform.origin));
 
 		if (!p_voxel_box.contains(voxel_pos)) {
@@ -1270,9 +1778,30 @@ void VoxelInstancer::remove_floating_multimesh_instances(Block &block, const Tra
 
 		// Remove the MultiMesh instance
 		const int last_instance_index = --instance_count;
-		// TODO This is terrible in MT mode! Think about keeping a local copy...
-		const Transform3D last_trans = multimesh->get_instance_transform(last_instance_index);
-		multimesh->set_instance_transform(instance_index, last_trans);
+		const Transform3D last_trans = use_local_buffer
+				? block.multimesh_instance.get_buffered_transform(last_instance_index)
+				: multimesh->get_instance_transform(last_instance_index);
+		if (use_local_buffer) {
+			block.multimesh_instance.set_buffered_transform(instance_index, last_trans);
+		} else {
+			multimesh->set_instance_transform(instance_index, last_trans);
+		}
+
+		// Keep the spatial hash in sync with the swap removal
+		instance_cells_remove(block, mm_transform.origin, instance_index);
+		instance_cells_relocate(block, last_trans.origin, last_instance_index, instance_index);
+
+		// Keep delta-save tracking in sync with the swap removal
+		if (block.tracks_generated_instances) {
+			if (block.generated_instance_indices.size() == unsigned(last_instance_index + 1)) {
+				block.generated_instance_indices[instance_index] =
+						block.generated_instance_indices[last_instance_index];
+				block.generated_instance_indices.pop_back();
+			} else {
+				// Out of sync, fall back on full saves
+				block.tracks_generated_instances = false;
+			}
+		}
 
 		// Remove the body if this block has some
 		// TODO In the case of bodies, we could use an overlap check
@@ -1302,6 +1831,9 @@ void VoxelInstancer::remove_floating_multimesh_instances(Block &block, const Tra
 	}
 
 	if (instance_count < initial_instance_count) {
+		// Only the compacted range is sent, not the whole buffer
+		block.multimesh_instance.flush_buffered_transforms();
+
 		// According to the docs, set_instance_count() resets the array so we only hide them instead
 		multimesh->set_visible_instance_count(instance_count);
 
@@ -1386,13 +1918,34 @@ void VoxelInstancer::on_area_edited(Box3i p_voxel_box) {
 	const int render_block_size = 1 << _parent_mesh_block_size_po2;
 	const int data_block_size = 1 << _parent_data_block_size_po2;
 
-	Ref<VoxelTool> maybe_voxel_tool = _parent->get_voxel_tool();
-	ERR_FAIL_COND(maybe_voxel_tool.is_null());
-	VoxelTool &voxel_tool = **maybe_voxel_tool;
-	voxel_tool.set_channel(VoxelBufferInternal::CHANNEL_SDF);
+	// Checking every instance of a forest against the ground and updating multimeshes and bodies
+	// is too much for one frame, and none of it can leave the main thread (physics and
+	// RenderingServer work). Each affected block is queued as a time-spread task instead, closest
+	// blocks first, so a big edit costs several calm frames instead of one spike. The tasks
+	// revalidate everything when they run, since blocks can unload in the meantime.
+	class RemoveFloatingInstancesTask : public ITimeSpreadTask {
+	public:
+		ObjectID instancer_object_id;
+		uint16_t layer_id;
+		Vector3i render_block_position;
+		Box3i voxel_box;
+
+		void run(TimeSpreadTaskContext &ctx) override {
+			Object *obj = ObjectDB::get_instance(instancer_object_id);
+			if (obj == nullptr) {
+				// The instancer can have been freed since the edit
+				return;
+			}
+			VoxelInstancer *instancer = Object::cast_to<VoxelInstancer>(obj);
+			ERR_FAIL_COND(instancer == nullptr);
+			instancer->remove_floating_instances_in_block(layer_id, render_block_position, voxel_box);
+		}
+	};
 
 	const Transform3D parent_transform = get_global_transform();
-	const int base_block_size_po2 = 1 << _parent_mesh_block_size_po2;
+	const TimeSpreadTaskRunner::Priority task_priority =
+			VoxelServer::get_singleton().get_main_thread_time_spread_priority(
+					parent_transform.xform(Vector3(p_voxel_box.pos) + 0.5 * Vector3(p_voxel_box.size)));
 
 	for (unsigned int lod_index = 0; lod_index < _lods.size(); ++lod_index) {
 		Lod &lod = _lods[lod_index];
@@ -1405,26 +1958,45 @@ void VoxelInstancer::on_area_edited(Box3i p_voxel_box) {
 		const Box3i data_blocks_box = p_voxel_box.downscaled(data_block_size << lod_index);
 
 		for (auto layer_it = lod.layers.begin(); layer_it != lod.layers.end(); ++layer_it) {
-			const Layer &layer = get_layer(*layer_it);
-			const std::vector<UniquePtr<Block>> &blocks = _blocks;
-			const int block_size_po2 = base_block_size_po2 + layer.lod_index;
+			const int layer_id = *layer_it;
+			const Layer &layer = get_layer(layer_id);
+
+			// Layers constrained to an altitude band can't have instances where the edit doesn't
+			// reach, so the whole layer can be skipped (grass doesn't care about an edit high up a
+			// mountain). Only meaningful with a vertical up axis.
+			if (_up_mode == UP_MODE_POSITIVE_Y) {
+				const VoxelInstanceLibraryItem *item = get_library_item_cached(layer, layer_id);
+				Ref<VoxelInstanceGenerator> generator =
+						item != nullptr ? item->get_generator() : Ref<VoxelInstanceGenerator>();
+				if (generator.is_valid()) {
+					const float min_h = generator->get_min_height();
+					const float max_h = generator->get_max_height();
+					// Same condition the generator uses to enable its height filter
+					if (min_h != std::numeric_limits<float>::min() || max_h != std::numeric_limits<float>::max()) {
+						// Offsetting along the normal can push origins slightly out of the band
+						const float margin = Math::abs(generator->get_offset_along_normal()) + 1.f;
+						if (float(p_voxel_box.pos.y) > max_h + margin ||
+								float(p_voxel_box.pos.y + p_voxel_box.size.y) < min_h - margin) {
+							continue;
+						}
+					}
+				}
+			}
 
-			render_blocks_box.for_each_cell([layer, &blocks, &voxel_tool, p_voxel_box, parent_transform, block_size_po2,
-													&lod, data_blocks_box](Vector3i block_pos) {
+			render_blocks_box.for_each_cell([this, layer_id, &layer, &lod, data_blocks_box, p_voxel_box,
+													task_priority](Vector3i block_pos) {
 				const auto block_it = layer.blocks.find(block_pos);
 				if (block_it == layer.blocks.end()) {
 					// No instancing block here
 					return;
 				}
 
-				Block &block = *blocks[block_it->second];
-
-				if (block.scene_instances.size() > 0) {
-					remove_floating_scene_instances(block, parent_transform, p_voxel_box, voxel_tool, block_size_po2);
-				} else {
-					remove_floating_multimesh_instances(
-							block, parent_transform, p_voxel_box, voxel_tool, block_size_po2);
-				}
+				RemoveFloatingInstancesTask *task = memnew(RemoveFloatingInstancesTask);
+				task->instancer_object_id = get_instance_id();
+				task->layer_id = layer_id;
+				task->render_block_position = block_pos;
+				task->voxel_box = p_voxel_box;
+				VoxelServer::get_singleton().push_main_thread_time_spread_task(task, task_priority);
 
 				// All instances have to be frozen as edited.
 				// Because even if none of them were removed or added, the ground on which they can spawn has changed,
@@ -1437,6 +2009,43 @@ void VoxelInstancer::on_area_edited(Box3i p_voxel_box) {
 	}
 }
 
+void VoxelInstancer::remove_floating_instances_in_block(
+		uint16_t layer_id, Vector3i render_block_position, Box3i voxel_box) {
+	ZN_PROFILE_SCOPE();
+	if (_parent == nullptr || !is_inside_tree()) {
+		return;
+	}
+	const auto layer_map_it = _layers.find(layer_id);
+	if (layer_map_it == _layers.end()) {
+		// The layer was removed since the edit
+		return;
+	}
+	const Layer &layer = layer_map_it->second;
+	const auto block_it = layer.blocks.find(render_block_position);
+	if (block_it == layer.blocks.end()) {
+		// The block was unloaded since the edit
+		return;
+	}
+	Block &block = *_blocks[block_it->second];
+
+	Ref<VoxelTool> maybe_voxel_tool = _parent->get_voxel_tool();
+	ERR_FAIL_COND(maybe_voxel_tool.is_null());
+	VoxelTool &voxel_tool = **maybe_voxel_tool;
+	voxel_tool.set_channel(VoxelBufferInternal::CHANNEL_SDF);
+
+	const Transform3D parent_transform = get_global_transform();
+	const int base_block_size_po2 = 1 << _parent_mesh_block_size_po2;
+	const int block_size_po2 = base_block_size_po2 + layer.lod_index;
+
+	if (block.scene_instances.size() > 0) {
+		remove_floating_scene_instances(block, parent_transform, voxel_box, voxel_tool, block_size_po2);
+	} else {
+		remove_floating_multimesh_instances(block, parent_transform, voxel_box, voxel_tool, block_size_po2);
+		// The canonical population changed, any render split is stale
+		clear_mesh_lod_split(block);
+	}
+}
+
 // This is called if a user destroys or unparents the body node while it's still attached to the ground
 void VoxelInstancer::on_body_removed(
 		Vector3i data_block_position, unsigned int render_block_index, unsigned int instance_index) {
@@ -1453,10 +2062,34 @@ void VoxelInstancer::on_body_removed(
 		ERR_FAIL_COND(int(instance_index) >= visible_count);
 
 		--visible_count;
-		// TODO Optimize: This is terrible in MT mode! Think about keeping a local copy...
-		const Transform3D last_trans = multimesh->get_instance_transform(visible_count);
-		multimesh->set_instance_transform(instance_index, last_trans);
+		// The local buffer copy must stay in sync, so blocks having one go through it
+		if (block.multimesh_instance.has_transform_buffer()) {
+			const Transform3D removed_trans = block.multimesh_instance.get_buffered_transform(instance_index);
+			const Transform3D last_trans = block.multimesh_instance.get_buffered_transform(visible_count);
+			block.multimesh_instance.set_buffered_transform(instance_index, last_trans);
+			block.multimesh_instance.flush_buffered_transforms();
+			// Keep the spatial hash in sync with the swap removal
+			instance_cells_remove(block, removed_trans.origin, instance_index);
+			instance_cells_relocate(block, last_trans.origin, visible_count, instance_index);
+		} else {
+			const Transform3D last_trans = multimesh->get_instance_transform(visible_count);
+			multimesh->set_instance_transform(instance_index, last_trans);
+			block.instance_cells_valid = false;
+		}
 		multimesh->set_visible_instance_count(visible_count);
+
+		// The canonical population changed, any render split is stale
+		clear_mesh_lod_split(block);
+
+		// Keep delta-save tracking in sync with the swap removal
+		if (block.tracks_generated_instances) {
+			if (block.generated_instance_indices.size() == unsigned(visible_count + 1)) {
+				block.generated_instance_indices[instance_index] = block.generated_instance_indices[visible_count];
+				block.generated_instance_indices.pop_back();
+			} else {
+				block.tracks_generated_instances = false;
+			}
+		}
 	}
 
 	// Unregister the body
@@ -1518,6 +2151,22 @@ void VoxelInstancer::set_mesh_lod_distance(float p_lod_distance) {
 	_mesh_lod_distance = p_lod_distance;
 }
 
+void VoxelInstancer::set_split_mesh_lods_enabled(bool enabled) {
+	if (enabled == _mesh_lod_splitting_enabled) {
+		return;
+	}
+	_mesh_lod_splitting_enabled = enabled;
+	if (!enabled) {
+		for (auto it = _blocks.begin(); it != _blocks.end(); ++it) {
+			clear_mesh_lod_split(**it);
+		}
+	}
+}
+
+bool VoxelInstancer::is_split_mesh_lods_enabled() const {
+	return _mesh_lod_splitting_enabled;
+}
+
 int VoxelInstancer::debug_get_block_count() const {
 	return _blocks.size();
 }
@@ -1648,6 +2297,10 @@ void VoxelInstancer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_up_mode", "mode"), &VoxelInstancer::set_up_mode);
 	ClassDB::bind_method(D_METHOD("get_up_mode"), &VoxelInstancer::get_up_mode);
 
+	ClassDB::bind_method(
+			D_METHOD("set_split_mesh_lods_enabled", "enabled"), &VoxelInstancer::set_split_mesh_lods_enabled);
+	ClassDB::bind_method(D_METHOD("is_split_mesh_lods_enabled"), &VoxelInstancer::is_split_mesh_lods_enabled);
+
 	ClassDB::bind_method(D_METHOD("debug_get_block_count"), &VoxelInstancer::debug_get_block_count);
 	ClassDB::bind_method(D_METHOD("debug_get_instance_counts"), &VoxelInstancer::debug_get_instance_counts);
 	ClassDB::bind_method(D_METHOD("debug_dump_as_scene", "fpath"), &VoxelInstancer::debug_dump_as_scene);
@@ -1657,6 +2310,8 @@ void VoxelInstancer::_bind_methods() {
 			"set_library", "get_library");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "up_mode", PROPERTY_HINT_ENUM, "PositiveY,Sphere"), "set_up_mode",
 			"get_up_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "split_mesh_lods"), "set_split_mesh_lods_enabled",
+			"is_split_mesh_lods_enabled");
 
 	BIND_CONSTANT(MAX_LOD);
 
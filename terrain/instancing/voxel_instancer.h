@@ -67,6 +67,23 @@ public:
 
 	void on_data_block_loaded(Vector3i grid_position, unsigned int lod_index, UniquePtr<InstanceBlockData> instances);
 	void on_mesh_block_enter(Vector3i render_grid_position, unsigned int lod_index, Array surface_arrays);
+
+	// Result of the asynchronous instance preparation (transform generation and edited-data
+	// merging run on a worker); only the RenderingServer-facing work remains when applying
+	struct PreparedInstanceLayer {
+		uint16_t layer_id = 0;
+		Ref<VoxelInstanceLibraryItem> item;
+		std::vector<Transform3D> transforms;
+		// Generation-order index of each transform, when they all come from the generator
+		std::vector<uint32_t> generated_indices;
+		uint32_t generated_count = 0;
+		bool all_from_generator = false;
+	};
+
+	// Internal: applies prepared instances to a render block, under the main-thread time budget.
+	// See `create_render_blocks`.
+	void apply_prepared_render_block(
+			Vector3i render_grid_position, int lod_index, std::vector<PreparedInstanceLayer> &layers);
 	void on_mesh_block_exit(Vector3i render_grid_position, unsigned int lod_index);
 	void on_area_edited(Box3i p_voxel_box);
 	void on_body_removed(Vector3i data_block_position, unsigned int render_block_index, unsigned int instance_index);
@@ -80,6 +97,12 @@ public:
 	void set_data_block_size_po2(unsigned int p_data_block_size_po2);
 	void set_mesh_lod_distance(float p_lod_distance);
 
+	// When enabled, blocks crossed by a mesh LOD boundary render as two distance buckets (near
+	// bucket with the detailed mesh, far bucket with the next mesh LOD) instead of switching
+	// all-or-nothing, cutting vertex throughput of dense vegetation around the player
+	void set_split_mesh_lods_enabled(bool enabled);
+	bool is_split_mesh_lods_enabled() const;
+
 	// Debug
 
 	int debug_get_block_count() const;
@@ -116,6 +139,12 @@ private:
 	// Get a layer assuming it exists
 	Layer &get_layer(int id);
 	const Layer &get_layer_const(int id) const;
+	// Resolves a library item once per library change, so steady-state block updates do no map
+	// lookup at all
+	VoxelInstanceLibraryItem *get_library_item_cached(const Layer &layer, int item_id) const;
+
+	// Deferred part of `on_area_edited`, run under the main-thread time-spread budget
+	void remove_floating_instances_in_block(uint16_t layer_id, Vector3i render_block_position, Box3i voxel_box);
 
 	void regenerate_layer(uint16_t layer_id, bool regenerate_blocks);
 	void update_layer_meshes(int layer_id);
@@ -142,10 +171,24 @@ private:
 	void on_library_item_changed(int item_id, VoxelInstanceLibraryItem::ChangeType change) override;
 
 	struct Block;
+	struct Lod;
+
+	void update_mesh_lod_split(Block &block, const VoxelInstanceLibraryMultiMeshItem &item, const Lod &lod,
+			int mesh_lod_count, Vector3 cam_pos_local, int lod_block_size);
+	void set_split_bucket(DirectMultiMeshInstance &dmmi, Ref<Mesh> mesh, Span<const Transform3D> transforms,
+			World3D &world, const Transform3D &block_transform, const VoxelInstanceLibraryMultiMeshItem &item);
+	void clear_mesh_lod_split(Block &block);
 
 	static void remove_floating_multimesh_instances(Block &block, const Transform3D &parent_transform,
 			Box3i p_voxel_box, const VoxelTool &voxel_tool, int block_size_po2);
 
+	// Instance spatial hash maintenance, see `Block::instance_cells`
+	static const int INSTANCE_CELL_SIZE_PO2 = 2;
+	static void rebuild_instance_cell_index(Block &block);
+	static void instance_cells_remove(Block &block, Vector3 position_local, uint32_t instance_index);
+	static void instance_cells_relocate(
+			Block &block, Vector3 position_local, uint32_t old_index, uint32_t new_index);
+
 	static void remove_floating_scene_instances(Block &block, const Transform3D &parent_transform, Box3i p_voxel_box,
 			const VoxelTool &voxel_tool, int block_size_po2);
 
@@ -165,6 +208,33 @@ private:
 		// Indices in the vector correspond to index of the instance in multimesh.
 		std::vector<VoxelInstancerRigidBody *> bodies;
 		std::vector<SceneInstance> scene_instances;
+
+		// Distance-bucketed mesh LOD split, active while a mesh LOD boundary crosses the block
+		// itself (see `process_mesh_lods`). The canonical multimesh above keeps the full
+		// population for edits and saves but stops rendering; instances are partitioned by
+		// distance into these two render-only multimeshes, the near bucket with the detailed
+		// mesh and the far bucket with the next mesh LOD.
+		DirectMultiMeshInstance split_near_instance;
+		DirectMultiMeshInstance split_far_instance;
+		bool mesh_lod_split_active = false;
+		uint8_t split_boundary_index = 0;
+		// Camera position (in parent space) at the last partition build
+		Vector3 split_last_cam_pos;
+
+		// Spatial hash over instance positions (block-local voxels divided into cells of
+		// 1 << INSTANCE_CELL_SIZE_PO2), so box-bounded removal queries only visit overlapping
+		// cells instead of scanning every instance. Rebuilt when the population changes
+		// wholesale, maintained through swap-removals; false means fall back to a linear scan.
+		std::unordered_map<Vector3i, std::vector<uint32_t>> instance_cells;
+		bool instance_cells_valid = false;
+
+		// When the multimesh instances of this block came straight from the generator, tracks
+		// which index in the generation order each current instance corresponds to, so edits can
+		// be saved as a delta (generated count + removed indices) instead of full transforms.
+		// Disabled when instances come from a full save or tracking gets out of sync.
+		bool tracks_generated_instances = false;
+		uint32_t generated_instance_count = 0;
+		std::vector<uint32_t> generated_instance_indices;
 	};
 
 	struct Layer {
@@ -172,6 +242,11 @@ private:
 		// Blocks indexed by grid position.
 		// Keys follow the mesh block coordinate system.
 		std::unordered_map<Vector3i, unsigned int> blocks;
+
+		// Resolved library item, re-looked-up only when the library's change generation moves.
+		// Mutable because it's a cache, usable from const contexts like saving.
+		mutable VoxelInstanceLibraryItem *cached_item = nullptr;
+		mutable uint32_t cached_item_generation = 0;
 	};
 
 	struct MeshLodDistances {
@@ -200,7 +275,14 @@ private:
 		// it will get generated instances.
 		// Keys follows the data block coordinate system.
 		// Can't use `HashMap` because it lacks move semantics.
-		std::unordered_map<Vector3i, UniquePtr<InstanceBlockData>> loaded_instances_data;
+		// Shared so asynchronous render block preparation can snapshot entries without copying.
+		// Contents are not mutated after loading.
+		std::unordered_map<Vector3i, std::shared_ptr<InstanceBlockData>> loaded_instances_data;
+
+		// Render block positions currently entered. Asynchronously prepared instances only get
+		// applied if their block is still in here, otherwise a block exiting while preparation
+		// was in flight would leave orphan instances behind.
+		std::unordered_set<Vector3i> entered_render_blocks;
 
 		FixedArray<MeshLodDistances, VoxelInstanceLibraryMultiMeshItem::MAX_MESH_LODS> mesh_lod_distances;
 	};
@@ -223,6 +305,7 @@ private:
 	unsigned int _parent_data_block_size_po2 = constants::DEFAULT_BLOCK_SIZE_PO2;
 	unsigned int _parent_mesh_block_size_po2 = constants::DEFAULT_BLOCK_SIZE_PO2;
 	float _mesh_lod_distance = 0.f;
+	bool _mesh_lod_splitting_enabled = true;
 
 #ifdef TOOLS_ENABLED
 	DebugRenderer _debug_renderer;
@@ -0,0 +1,115 @@
+#include "material_warmup.h"
+#include "../meshers/voxel_mesher.h"
+#include "../storage/voxel_buffer_internal.h"
+#include "../util/profiling.h"
+
+#include <scene/resources/mesh.h>
+
+namespace zylann::voxel {
+
+namespace {
+
+// Builds a tiny mesh with the exact vertex layout the mesher produces for real blocks.
+// The buffer holds a flat boundary in every channel a mesher might read, so SDF, blocky and
+// color meshers all produce at least one quad.
+Ref<ArrayMesh> build_representative_mesh(VoxelMesher &mesher) {
+	ZN_PROFILE_SCOPE();
+
+	const unsigned int min_padding = mesher.get_minimum_padding();
+	const unsigned int max_padding = mesher.get_maximum_padding();
+	const int size = 8 + min_padding + max_padding;
+
+	VoxelBufferInternal vb;
+	vb.create(size, size, size);
+
+	const int half = size / 2;
+	// Matter in the lower half
+	vb.fill_area_f(-1.f, Vector3i(0, 0, 0), Vector3i(size, half, size), VoxelBufferInternal::CHANNEL_SDF);
+	vb.fill_area(1, Vector3i(0, 0, 0), Vector3i(size, half, size), VoxelBufferInternal::CHANNEL_TYPE);
+	vb.fill_area(1, Vector3i(0, 0, 0), Vector3i(size, half, size), VoxelBufferInternal::CHANNEL_COLOR);
+
+	VoxelMesher::Output output;
+	VoxelMesher::Input input = { vb, nullptr, nullptr, Vector3i(), 0 };
+	mesher.build(output, input);
+
+	Ref<ArrayMesh> mesh;
+	for (unsigned int i = 0; i < output.surfaces.size(); ++i) {
+		const Array &surface = output.surfaces[i];
+		if (surface.is_empty()) {
+			continue;
+		}
+		if (mesh.is_null()) {
+			mesh.instantiate();
+		}
+		mesh->add_surface_from_arrays(
+				output.primitive_type, surface, Array(), Dictionary(), output.mesh_flags);
+	}
+	return mesh;
+}
+
+} // namespace
+
+void MaterialPipelineWarmup::begin(VoxelMesher &mesher, Span<const Ref<Material>> materials, World3D *world) {
+	ZN_PROFILE_SCOPE();
+	clear();
+
+	if (world == nullptr) {
+		return;
+	}
+
+	Ref<ArrayMesh> mesh = build_representative_mesh(mesher);
+	if (mesh.is_null()) {
+		return;
+	}
+
+	// Degenerate placement: far below any plausible world content, scaled to sub-pixel size.
+	// The huge custom AABB keeps the instances from being culled, so the renderer actually draws
+	// them and compiles their pipelines.
+	const Transform3D transform(Basis().scaled(Vector3(0.001, 0.001, 0.001)), Vector3(0, -100000, 0));
+	const AABB always_visible_aabb(Vector3(-500000, -500000, -500000), Vector3(1000000, 1000000, 1000000));
+
+	for (unsigned int i = 0; i < materials.size(); ++i) {
+		UniquePtr<DirectMeshInstance> instance = make_unique_instance<DirectMeshInstance>();
+		instance->create();
+		instance->set_mesh(mesh);
+		instance->set_material_override(materials[i]);
+		instance->set_cast_shadows_setting(RenderingServer::SHADOW_CASTING_SETTING_OFF);
+		instance->set_transform(transform);
+		instance->set_custom_aabb(always_visible_aabb);
+		instance->set_world(world);
+		_instances.push_back(std::move(instance));
+	}
+	// A null material still exercises the default pipeline for this vertex format
+	if (materials.size() == 0) {
+		UniquePtr<DirectMeshInstance> instance = make_unique_instance<DirectMeshInstance>();
+		instance->create();
+		instance->set_mesh(mesh);
+		instance->set_cast_shadows_setting(RenderingServer::SHADOW_CASTING_SETTING_OFF);
+		instance->set_transform(transform);
+		instance->set_custom_aabb(always_visible_aabb);
+		instance->set_world(world);
+		_instances.push_back(std::move(instance));
+	}
+
+	// A few frames is enough for the renderer to have drawn them at least once
+	_frames_left = 4;
+}
+
+bool MaterialPipelineWarmup::process() {
+	if (_instances.size() == 0) {
+		return false;
+	}
+	--_frames_left;
+	if (_frames_left <= 0) {
+		clear();
+		return false;
+	}
+	return true;
+}
+
+void MaterialPipelineWarmup::clear() {
+	_instances.clear();
+	_frames_left = 0;
+}
+
+} // namespace zylann::voxel
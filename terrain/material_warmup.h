@@ -0,0 +1,41 @@
+#ifndef VOXEL_MATERIAL_WARMUP_H
+#define VOXEL_MATERIAL_WARMUP_H
+
+#include "../util/godot/direct_mesh_instance.h"
+#include "../util/memory.h"
+#include "../util/span.h"
+
+#include <vector>
+
+class World3D;
+
+namespace zylann::voxel {
+
+class VoxelMesher;
+
+// First-use pipeline warm-up for terrain materials. The first time a material renders with a
+// given vertex format, the driver compiles pipelines and the frame hitches; transition-heavy
+// terrains hit this for every material permutation while streaming in. This builds one tiny
+// representative mesh with the volume's mesher (so the vertex format matches exactly what blocks
+// will produce) and renders it once per material: degenerate sub-pixel geometry far underground,
+// kept un-culled by a huge custom AABB, so pipelines compile during load instead of on the first
+// visible chunk.
+class MaterialPipelineWarmup {
+public:
+	// Creates the warm-up instances. No-op when the mesher produces nothing or `world` is null.
+	void begin(VoxelMesher &mesher, Span<const Ref<Material>> materials, World3D *world);
+
+	// Call once per frame; the instances free themselves after a few frames, enough for the
+	// renderer to have drawn them. Returns true while instances are still held.
+	bool process();
+
+	void clear();
+
+private:
+	std::vector<UniquePtr<DirectMeshInstance>> _instances;
+	int _frames_left = 0;
+};
+
+} // namespace zylann::voxel
+
+#endif // VOXEL_MATERIAL_WARMUP_H
@@ -5,6 +5,8 @@
 #include "../../server/voxel_server_gd.h"
 #include "../../server/voxel_server_updater.h"
 #include "../../storage/voxel_buffer_gd.h"
+#include "../../streams/save_order.h"
+#include "../../streams/voxel_block_serializer.h"
 #include "../../util/container_funcs.h"
 #include "../../util/godot/funcs.h"
 #include "../../util/log.h"
@@ -15,6 +17,7 @@
 #include "../../util/tasks/async_dependency_tracker.h"
 #include "../../util/thread/mutex.h"
 #include "../../util/thread/rw_lock.h"
+#include "../../util/thread/thread.h"
 #include "../instancing/voxel_instancer.h"
 #include "voxel_lod_terrain_update_task.h"
 
@@ -23,10 +26,41 @@
 #include <scene/3d/mesh_instance_3d.h>
 #include <scene/resources/packed_scene.h>
 
+#include <algorithm>
+
 namespace zylann::voxel {
 
 namespace {
 
+// Direct path using surfaces already packed in the RenderingServer's native layout on the
+// worker; `add_surface` skips Variant unpacking and vertex packing on the main thread
+Ref<ArrayMesh> build_mesh_from_packed(
+		Span<const VoxelServer::BlockMeshOutput::PackedSurface> packed_surfaces, Ref<Material> material) {
+	ZN_PROFILE_SCOPE();
+	Ref<ArrayMesh> mesh;
+
+	unsigned int surface_index = 0;
+	for (unsigned int i = 0; i < packed_surfaces.size(); ++i) {
+		const RenderingServer::SurfaceData &sd = packed_surfaces[i].data;
+
+		if (mesh.is_null()) {
+			mesh.instantiate();
+		}
+
+		mesh->add_surface(sd.format, Mesh::PrimitiveType(sd.primitive), sd.vertex_data, sd.attribute_data,
+				sd.skin_data, sd.vertex_count, sd.index_data, sd.index_count, sd.aabb);
+		mesh->surface_set_material(surface_index, material);
+		// No multi-material supported yet
+		++surface_index;
+	}
+
+	if (mesh.is_valid() && is_mesh_empty(**mesh)) {
+		mesh = Ref<Mesh>();
+	}
+
+	return mesh;
+}
+
 Ref<ArrayMesh> build_mesh(
 		Span<const Array> surfaces, Mesh::PrimitiveType primitive, int flags, Ref<Material> material) {
 	ZN_PROFILE_SCOPE();
@@ -105,11 +139,22 @@ struct ScheduleSaveAction {
 			b.voxels = make_shared_instance<VoxelBufferInternal>();
 			{
 				RWLockRead lock(block.get_voxels().get_lock());
-				block.get_voxels_const().duplicate_to(*b.voxels, true);
+				// Copy-on-write snapshot: channels are only duplicated if edited before the save
+				b.voxels->copy_shared_from(block.get_voxels_const(), true);
 			}
 
 			b.position = block.position;
 			b.lod = block.lod_index;
+
+			// Blocks with a valid edit journal can be saved as compact deltas against generator
+			// output; the journal persists across saves since deltas are always rewritten whole
+			if (block.has_edit_journal()) {
+				const Span<const Box3i> journal = block.get_edit_journal();
+				for (unsigned int i = 0; i < journal.size(); ++i) {
+					b.delta_boxes[b.delta_box_count++] = journal[i];
+				}
+			}
+
 			blocks_to_save.push_back(b);
 			block.set_modified(false);
 		}
@@ -169,7 +214,15 @@ VoxelLodTerrain::VoxelLodTerrain() {
 		task->volume_id = self->get_volume_id();
 		task->self = self;
 		task->data = ob;
-		VoxelServer::get_singleton().push_main_thread_time_spread_task(task);
+		// Blocks close to a viewer get their lane served first, so when uploads burst, it's the
+		// distant LODs that get spread over more frames
+		const int block_size_in_voxels = self->get_mesh_block_size() << ob.lod;
+		Vector3 block_center = (Vector3(ob.position) + Vector3(0.5f, 0.5f, 0.5f)) * block_size_in_voxels;
+		if (self->is_inside_tree()) {
+			block_center = self->get_global_transform().xform(block_center);
+		}
+		VoxelServer::get_singleton().push_main_thread_time_spread_task(
+				task, VoxelServer::get_singleton().get_main_thread_time_spread_priority(block_center));
 	};
 	callbacks.data_output_callback = [](void *cb_data, VoxelServer::BlockDataOutput &ob) {
 		VoxelLodTerrain *self = reinterpret_cast<VoxelLodTerrain *>(cb_data);
@@ -188,11 +241,102 @@ VoxelLodTerrain::VoxelLodTerrain() {
 
 VoxelLodTerrain::~VoxelLodTerrain() {
 	ZN_PRINT_VERBOSE("Destroy VoxelLodTerrain");
+	stop_warm_up();
 	abort_async_edits();
 	VoxelServer::get_singleton().remove_volume(_volume_id);
 	// Instancer can take care of itself
 }
 
+void VoxelLodTerrain::warm_up_points(PackedVector3Array points, float view_distance) {
+	// Idempotent: warming again replaces the previous pass
+	stop_warm_up();
+
+	// Each point costs a paired viewer in every volume; paths should be sampled coarsely
+	const int max_points = 16;
+	ERR_FAIL_COND_MSG(points.size() > max_points,
+			String("Too many warm-up points, sample the path down to at most {0}").format(varray(max_points)));
+	const int min_distance = get_mesh_block_size();
+	const int max_distance = math::max(min_distance, int(get_lod_distance() * (1 << (get_lod_count() - 1))));
+	const unsigned int clamped_distance = math::clamp(int(view_distance), min_distance, max_distance);
+
+	VoxelServer &server = VoxelServer::get_singleton();
+	for (int i = 0; i < points.size(); ++i) {
+		const uint32_t viewer_id = server.add_viewer();
+		server.set_viewer_position(viewer_id, points[i]);
+		server.set_viewer_distance(viewer_id, clamped_distance);
+		// Visuals drive the mesh pipeline; collisions would only add physics cooking the real
+		// player may never touch
+		server.set_viewer_requires_visuals(viewer_id, true);
+		server.set_viewer_requires_collisions(viewer_id, false);
+		_warmup_viewer_ids.push_back(viewer_id);
+	}
+}
+
+void VoxelLodTerrain::stop_warm_up() {
+	VoxelServer &server = VoxelServer::get_singleton();
+	for (unsigned int i = 0; i < _warmup_viewer_ids.size(); ++i) {
+		server.remove_viewer(_warmup_viewer_ids[i]);
+	}
+	_warmup_viewer_ids.clear();
+}
+
+bool VoxelLodTerrain::is_warming_up() const {
+	return _warmup_viewer_ids.size() > 0;
+}
+
+float VoxelLodTerrain::get_area_streaming_completion(AABB aabb, int lod_index) const {
+	ERR_FAIL_COND_V(lod_index < 0 || lod_index >= get_lod_count(), 0.f);
+	ERR_FAIL_COND_V(aabb.size.x < 0 || aabb.size.y < 0 || aabb.size.z < 0, 0.f);
+
+	const int mesh_block_size_po2 = get_mesh_block_size_pow2() + lod_index;
+	const Box3i voxel_box(math::floor_to_int(aabb.position), math::ceil_to_int(aabb.size));
+	Box3i block_box = voxel_box.downscaled(1 << mesh_block_size_po2);
+	// Keep pathological queries bounded; gameplay areas are a handful of blocks
+	const int MAX_EXTENT = 32;
+	block_box.size.x = math::min(block_box.size.x, MAX_EXTENT);
+	block_box.size.y = math::min(block_box.size.y, MAX_EXTENT);
+	block_box.size.z = math::min(block_box.size.z, MAX_EXTENT);
+
+	unsigned int total = 0;
+	unsigned int complete = 0;
+	const VoxelLodTerrainUpdateData::Lod &lod = _update_data->state.lods[lod_index];
+	{
+		RWLockRead rlock(lod.mesh_map_state.map_lock);
+		block_box.for_each_cell([&lod, &total, &complete](Vector3i bpos) {
+			auto it = lod.mesh_map_state.map.find(bpos);
+			if (it == lod.mesh_map_state.map.end()) {
+				// Not tracked: either out of range or not streamed in yet. Counted as
+				// incomplete so spawn gating doesn't fire early at area borders.
+				++total;
+				return;
+			}
+			++total;
+			if (it->second.state.load(std::memory_order_relaxed) == VoxelLodTerrainUpdateData::MESH_UP_TO_DATE) {
+				++complete;
+			}
+		});
+	}
+
+	if (total == 0) {
+		return 1.f;
+	}
+	return float(complete) / float(total);
+}
+
+Array VoxelLodTerrain::get_lod_streaming_stats() const {
+	Array result;
+	for (int lod_index = 0; lod_index < get_lod_count(); ++lod_index) {
+		const VoxelLodTerrainUpdateData::LodStreamingStats &gauges = _update_data->state.streaming_stats[lod_index];
+		Dictionary d;
+		d["loading_data_blocks"] = int(gauges.loading_data_blocks.load(std::memory_order_relaxed));
+		d["mesh_blocks"] = int(gauges.mesh_blocks.load(std::memory_order_relaxed));
+		d["mesh_blocks_up_to_date"] = int(gauges.mesh_blocks_up_to_date.load(std::memory_order_relaxed));
+		d["mesh_blocks_pending_update"] = int(gauges.mesh_blocks_pending_update.load(std::memory_order_relaxed));
+		result.push_back(d);
+	}
+	return result;
+}
+
 Ref<Material> VoxelLodTerrain::get_material() const {
 	return _material;
 }
@@ -229,6 +373,7 @@ void VoxelLodTerrain::set_stream(Ref<VoxelStream> p_stream) {
 	_streaming_dependency = make_shared_instance<StreamingDependency>();
 	_streaming_dependency->stream = _stream;
 	_streaming_dependency->generator = _generator;
+	_streaming_dependency->sdf_low_precision_lod_start = get_effective_sdf_depth_policy();
 	_streaming_dependency->valid = true;
 
 #ifdef TOOLS_ENABLED
@@ -269,6 +414,7 @@ void VoxelLodTerrain::set_generator(Ref<VoxelGenerator> p_generator) {
 	_streaming_dependency = make_shared_instance<StreamingDependency>();
 	_streaming_dependency->stream = _stream;
 	_streaming_dependency->generator = p_generator;
+	_streaming_dependency->sdf_low_precision_lod_start = get_effective_sdf_depth_policy();
 	_streaming_dependency->valid = true;
 
 #ifdef TOOLS_ENABLED
@@ -314,6 +460,12 @@ void VoxelLodTerrain::set_mesher(Ref<VoxelMesher> p_mesher) {
 	_meshing_dependency = make_shared_instance<MeshingDependency>();
 	_meshing_dependency->mesher = _mesher;
 	_meshing_dependency->generator = _generator;
+
+	// Meshers that only read SDF-like channels produce nothing from uniformly solid blocks,
+	// which lets the update task skip scheduling meshes there
+	_update_data->settings.can_skip_uniform_matter = _mesher.is_valid() &&
+			(_mesher->get_used_channels_mask() &
+					((1 << VoxelBufferInternal::CHANNEL_TYPE) | (1 << VoxelBufferInternal::CHANNEL_COLOR))) == 0;
 	_meshing_dependency->valid = true;
 
 	if (_mesher.is_valid()) {
@@ -457,6 +609,74 @@ bool VoxelLodTerrain::is_full_load_mode_enabled() const {
 	return _update_data->settings.full_load_mode;
 }
 
+void VoxelLodTerrain::set_speculative_meshing_enabled(bool enabled) {
+	if (enabled != _update_data->settings.speculative_meshing_enabled) {
+		_update_data->wait_for_end_of_task();
+		_update_data->settings.speculative_meshing_enabled = enabled;
+	}
+}
+
+bool VoxelLodTerrain::is_speculative_meshing_enabled() const {
+	return _update_data->settings.speculative_meshing_enabled;
+}
+
+void VoxelLodTerrain::set_occlusion_culling_enabled(bool enabled) {
+	if (enabled != _update_data->settings.occlusion_culling_enabled) {
+		_update_data->wait_for_end_of_task();
+		_update_data->settings.occlusion_culling_enabled = enabled;
+		if (!enabled) {
+			// Wake everything that was suppressed, or sealed areas would stay unmeshed forever
+			VoxelLodTerrainUpdateData::Lod &lod0 = _update_data->state.lods[0];
+			for (auto it = lod0.occlusion_suppressed_mesh_blocks.begin();
+					it != lod0.occlusion_suppressed_mesh_blocks.end(); ++it) {
+				auto mesh_block_it = lod0.mesh_map_state.map.find(*it);
+				if (mesh_block_it != lod0.mesh_map_state.map.end()) {
+					VoxelLodTerrainUpdateData::MeshState expected = VoxelLodTerrainUpdateData::MESH_UP_TO_DATE;
+					mesh_block_it->second.state.compare_exchange_strong(
+							expected, VoxelLodTerrainUpdateData::MESH_NEED_UPDATE);
+				}
+			}
+			lod0.occlusion_suppressed_mesh_blocks.clear();
+			_update_data->state.occlusion_flood_valid = false;
+		}
+		_update_data->state.occlusion_dirty = true;
+	}
+}
+
+bool VoxelLodTerrain::is_occlusion_culling_enabled() const {
+	return _update_data->settings.occlusion_culling_enabled;
+}
+
+void VoxelLodTerrain::set_distant_data_block_size(unsigned int size) {
+	ERR_FAIL_COND_MSG(size != 0 && size != 16 && size != 32, "Only 0 (disabled), 16 and 32 are supported");
+	if (size == _distant_data_block_size) {
+		return;
+	}
+	_distant_data_block_size = size;
+	// Maps have to be rebuilt with the new per-LOD sizes
+	_on_stream_params_changed();
+}
+
+unsigned int VoxelLodTerrain::get_distant_data_block_size() const {
+	return _distant_data_block_size;
+}
+
+void VoxelLodTerrain::set_distant_data_block_size_lod_start(unsigned int lod_index) {
+	// LOD0 always keeps the base size, otherwise edits would pay for the larger blocks
+	lod_index = math::clamp(lod_index, 1u, constants::MAX_LOD - 1);
+	if (lod_index == _distant_data_block_size_lod_start) {
+		return;
+	}
+	_distant_data_block_size_lod_start = lod_index;
+	if (_distant_data_block_size != 0) {
+		_on_stream_params_changed();
+	}
+}
+
+unsigned int VoxelLodTerrain::get_distant_data_block_size_lod_start() const {
+	return _distant_data_block_size_lod_start;
+}
+
 void VoxelLodTerrain::set_threaded_update_enabled(bool enabled) {
 	if (enabled != _threaded_update_enabled) {
 		if (_threaded_update_enabled) {
@@ -646,9 +866,8 @@ void VoxelLodTerrain::post_edit_area(Box3i p_box) {
 	VoxelDataLodMap::Lod &data_lod0 = _data->lods[0];
 	{
 		RWLockRead rlock(data_lod0.map_lock);
-		MutexLock lock(_update_data->state.blocks_pending_lodding_lod0_mutex);
 
-		bbox.for_each_cell([this, &data_lod0](Vector3i block_pos_lod0) {
+		bbox.for_each_cell([this, &data_lod0, p_box](Vector3i block_pos_lod0) {
 			VoxelDataBlock *block = data_lod0.map.get_block(block_pos_lod0);
 			//ERR_FAIL_COND(block == nullptr);
 			if (block == nullptr) {
@@ -658,10 +877,26 @@ void VoxelLodTerrain::post_edit_area(Box3i p_box) {
 			//RWLockWrite wlock(block->get_voxels_shared()->get_lock());
 			block->set_modified(true);
 
+			{
+				// Track which part of the block diverged from generator output, so saves can
+				// write compact deltas. The unpadded box is used: padding only exists for meshing
+				// concerns and doesn't change data in neighbor blocks.
+				const int data_block_size = get_data_block_size();
+				const Box3i local_box = Box3i(p_box.pos - block_pos_lod0 * data_block_size, p_box.size);
+				block->journal_edit(local_box);
+			}
+
 			// TODO That boolean is also modified by the threaded update task (always set to false)
 			if (!block->get_needs_lodding()) {
 				block->set_needs_lodding(true);
-				_update_data->state.blocks_pending_lodding_lod0.push_back(block_pos_lod0);
+				// Wait-free: edits never contend with a running update task. Single producer
+				// (main thread), single consumer (the update task).
+				VoxelLodTerrainUpdateData::State &state = _update_data->state;
+				if (!state.blocks_pending_lodding_lod0_ring.try_push(block_pos_lod0)) {
+					// Massive edit burst filled the ring, spill under the lock
+					MutexLock lock(state.blocks_pending_lodding_lod0_mutex);
+					state.blocks_pending_lodding_lod0_overflow.push_back(block_pos_lod0);
+				}
 			}
 		});
 	}
@@ -669,6 +904,9 @@ void VoxelLodTerrain::post_edit_area(Box3i p_box) {
 	if (_instancer != nullptr) {
 		_instancer->on_area_edited(p_box);
 	}
+
+	// Edits can open or seal passages, the occlusion flood must recompute
+	_update_data->state.occlusion_dirty = true;
 }
 
 void VoxelLodTerrain::push_async_edit(IThreadedTask *task, Box3i box, std::shared_ptr<AsyncDependencyTracker> tracker) {
@@ -768,27 +1006,161 @@ void VoxelLodTerrain::stop_streamer() {
 }
 
 void VoxelLodTerrain::set_lod_distance(float p_lod_distance) {
-	if (p_lod_distance == _update_data->settings.lod_distance) {
+	// Distance must be greater than a threshold,
+	// otherwise lods will decimate too fast and it will look messy
+	const float lod_distance =
+			math::clamp(p_lod_distance, constants::MINIMUM_LOD_DISTANCE, constants::MAXIMUM_LOD_DISTANCE);
+	_requested_lod_distance = lod_distance;
+	apply_lod_distance(lod_distance);
+}
+
+void VoxelLodTerrain::apply_lod_distance(float lod_distance) {
+	if (lod_distance == _update_data->settings.lod_distance) {
 		return;
 	}
 
 	_update_data->wait_for_end_of_task();
 
-	// Distance must be greater than a threshold,
-	// otherwise lods will decimate too fast and it will look messy
-	const float lod_distance =
-			math::clamp(p_lod_distance, constants::MINIMUM_LOD_DISTANCE, constants::MAXIMUM_LOD_DISTANCE);
 	_update_data->settings.lod_distance = lod_distance;
 	_update_data->state.force_update_octrees_next_update = true;
-	VoxelServer::get_singleton().set_volume_octree_lod_distance(_volume_id, get_lod_distance());
+	VoxelServer::get_singleton().set_volume_octree_lod_distance(_volume_id, lod_distance);
 
 	if (_instancer != nullptr) {
+		// Scales instance visibility along, so instancing load degrades with the terrain
 		_instancer->set_mesh_lod_distance(lod_distance);
 	}
 }
 
 float VoxelLodTerrain::get_lod_distance() const {
-	return _update_data->settings.lod_distance;
+	// The user-facing value; the effective one may be temporarily scaled down by adaptive LOD
+	return _requested_lod_distance;
+}
+
+uint8_t VoxelLodTerrain::get_effective_sdf_depth_policy() const {
+	if (_sdf_low_precision_lod_start == 0) {
+		return 255;
+	}
+	// Region-style streams declare fixed channel depths applying to every block; saving 8-bit
+	// blocks into them would fail format verification
+	if (_stream.is_valid() && !_stream->supports_variable_block_depths()) {
+		WARN_PRINT_ONCE("sdf_low_precision_lod_start is ignored with streams using a fixed block format");
+		return 255;
+	}
+	return _sdf_low_precision_lod_start;
+}
+
+void VoxelLodTerrain::set_sdf_low_precision_lod_start(int lod_index) {
+	lod_index = math::clamp(lod_index, 0, int(constants::MAX_LOD) - 1);
+	if (unsigned(lod_index) == _sdf_low_precision_lod_start) {
+		return;
+	}
+	_sdf_low_precision_lod_start = lod_index;
+
+	// Tasks read the policy from the dependency; rebuild it like stream changes do so in-flight
+	// tasks keep their previous snapshot
+	_streaming_dependency->valid = false;
+	_streaming_dependency = make_shared_instance<StreamingDependency>();
+	_streaming_dependency->stream = _stream;
+	_streaming_dependency->generator = _generator;
+	_streaming_dependency->sdf_low_precision_lod_start = get_effective_sdf_depth_policy();
+	_streaming_dependency->valid = true;
+}
+
+int VoxelLodTerrain::get_sdf_low_precision_lod_start() const {
+	return _sdf_low_precision_lod_start;
+}
+
+void VoxelLodTerrain::set_checkpoint_enabled(bool enabled) {
+	_checkpoint_enabled = enabled;
+}
+
+bool VoxelLodTerrain::is_checkpoint_enabled() const {
+	return _checkpoint_enabled;
+}
+
+void VoxelLodTerrain::set_checkpoint_dirty_block_threshold(int count) {
+	_checkpoint_dirty_block_threshold = math::max(count, 1);
+}
+
+int VoxelLodTerrain::get_checkpoint_dirty_block_threshold() const {
+	return _checkpoint_dirty_block_threshold;
+}
+
+void VoxelLodTerrain::set_checkpoint_max_age_seconds(float seconds) {
+	_checkpoint_max_age_seconds = math::max(seconds, 1.f);
+}
+
+float VoxelLodTerrain::get_checkpoint_max_age_seconds() const {
+	return _checkpoint_max_age_seconds;
+}
+
+void VoxelLodTerrain::set_checkpoint_io_budget_msec(int msec) {
+	_checkpoint_io_budget_msec = math::clamp(msec, 1, 1000);
+}
+
+int VoxelLodTerrain::get_checkpoint_io_budget_msec() const {
+	return _checkpoint_io_budget_msec;
+}
+
+void VoxelLodTerrain::set_adaptive_lod_enabled(bool enabled) {
+	if (enabled == _adaptive_lod_enabled) {
+		return;
+	}
+	_adaptive_lod_enabled = enabled;
+	if (!enabled) {
+		// Snap back to what the user asked for
+		apply_lod_distance(_requested_lod_distance);
+	}
+}
+
+bool VoxelLodTerrain::is_adaptive_lod_enabled() const {
+	return _adaptive_lod_enabled;
+}
+
+void VoxelLodTerrain::set_adaptive_lod_min_distance(float distance) {
+	_adaptive_lod_min_distance =
+			math::clamp(distance, constants::MINIMUM_LOD_DISTANCE, constants::MAXIMUM_LOD_DISTANCE);
+}
+
+float VoxelLodTerrain::get_adaptive_lod_min_distance() const {
+	return _adaptive_lod_min_distance;
+}
+
+// Scales the effective LOD distance from queue-depth feedback: shrink fast while meshing and
+// main-thread backlogs balloon, creep back up once they drain. Asymmetric steps with a dead band
+// in between avoid oscillation, and adjustments are rate-limited since changing the distance
+// forces octree updates.
+void VoxelLodTerrain::process_adaptive_lod() {
+	if (!_adaptive_lod_enabled) {
+		return;
+	}
+	const uint32_t now = get_ticks_msec();
+	if (now - _last_adaptive_lod_time_msec < 500) {
+		return;
+	}
+	_last_adaptive_lod_time_msec = now;
+
+	const VoxelServer::Stats stats = VoxelServer::get_singleton().get_stats();
+	const unsigned int backlog = stats.general.tasks + stats.main_thread_tasks;
+
+	const unsigned int HIGH_BACKLOG = 512;
+	const unsigned int LOW_BACKLOG = 64;
+
+	const float effective = _update_data->settings.lod_distance;
+	float target = effective;
+
+	if (backlog > HIGH_BACKLOG) {
+		target = math::max(effective * 0.9f, _adaptive_lod_min_distance);
+	} else if (backlog < LOW_BACKLOG && effective < _requested_lod_distance) {
+		target = math::min(effective * 1.05f, _requested_lod_distance);
+	} else {
+		return;
+	}
+
+	if (Math::abs(target - effective) < 0.5f) {
+		return;
+	}
+	apply_lod_distance(math::clamp(target, constants::MINIMUM_LOD_DISTANCE, constants::MAXIMUM_LOD_DISTANCE));
 }
 
 void VoxelLodTerrain::set_lod_count(int p_lod_count) {
@@ -836,11 +1208,29 @@ void VoxelLodTerrain::reset_maps() {
 	_data = make_shared_instance<VoxelDataLodMap>();
 	_data->lod_count = lod_count;
 
+	// Distant block sizes only make sense when all data comes from the generator: streams store
+	// blocks of one fixed size, and full load mode is what guarantees no per-block streaming.
+	const bool distant_size_active = _distant_data_block_size != 0 && _update_data->settings.full_load_mode &&
+			_stream.is_null() && _distant_data_block_size <= get_mesh_block_size();
+	if (_distant_data_block_size != 0 && !distant_size_active) {
+		WARN_PRINT("Distant data block size is set but cannot be used. It requires full load mode, "
+				   "no stream, and a mesh block size at least as big.");
+	}
+	unsigned int distant_po2 = 0;
+	while ((1u << distant_po2) < _distant_data_block_size) {
+		++distant_po2;
+	}
+
 	for (unsigned int lod_index = 0; lod_index < state.lods.size(); ++lod_index) {
 		VoxelDataLodMap::Lod &data_lod = _data->lods[lod_index];
 		// Instance new maps if we have more lods, or clear them otherwise
 		if (lod_index < lod_count) {
-			data_lod.map.create(data_lod.map.get_block_size_pow2(), lod_index);
+			unsigned int block_size_po2 = data_lod.map.get_block_size_pow2();
+			if (distant_size_active && lod_index >= _distant_data_block_size_lod_start &&
+					distant_po2 > block_size_po2) {
+				block_size_po2 = distant_po2;
+			}
+			data_lod.map.create(block_size_po2, lod_index);
 		} else {
 			data_lod.map.clear();
 		}
@@ -883,11 +1273,13 @@ int VoxelLodTerrain::get_lod_count() const {
 
 void VoxelLodTerrain::set_generate_collisions(bool enabled) {
 	_generate_collisions = enabled;
+	_update_data->settings.collision_enabled = enabled;
 }
 
 void VoxelLodTerrain::set_collision_lod_count(int lod_count) {
 	ERR_FAIL_COND(lod_count < 0);
 	_collision_lod_count = static_cast<unsigned int>(math::min(lod_count, get_lod_count()));
+	_update_data->settings.collision_lod_count = _collision_lod_count;
 }
 
 int VoxelLodTerrain::get_collision_lod_count() const {
@@ -1008,6 +1400,13 @@ void VoxelLodTerrain::_notification(int p_what) {
 					block.set_world(world);
 				});
 			}
+
+			// Compile material pipelines now rather than hitching on the first rendered chunk.
+			// Transition meshes use per-block duplicates of the same shader, so one instance
+			// covers them too.
+			if (_mesher.is_valid() && _material.is_valid()) {
+				_material_warmup.begin(**_mesher, Span<const Ref<Material>>(&_material, 1), world);
+			}
 #ifdef TOOLS_ENABLED
 			if (is_showing_gizmos()) {
 				_debug_renderer.set_world(is_visible_in_tree() ? world : nullptr);
@@ -1018,6 +1417,7 @@ void VoxelLodTerrain::_notification(int p_what) {
 		} break;
 
 		case NOTIFICATION_EXIT_WORLD: {
+			_material_warmup.clear();
 			VoxelLodTerrainUpdateData::State &state = _update_data->state;
 			for (unsigned int lod_index = 0; lod_index < state.lods.size(); ++lod_index) {
 				VoxelMeshMap<VoxelMeshBlockVLT> &mesh_map = _mesh_maps_per_lod[lod_index];
@@ -1103,6 +1503,88 @@ inline bool check_block_sizes(int data_block_size, int mesh_block_size) {
 // 	}
 // }
 
+void VoxelLodTerrain::process_checkpointing() {
+	if (!_checkpoint_enabled || _stream.is_null()) {
+		return;
+	}
+
+	// Dirty accounting once per second is plenty; the scan below is a cheap pointer walk
+	const uint32_t now_ms = uint32_t(Time::get_singleton()->get_ticks_msec());
+	if (now_ms - _last_checkpoint_check_msec < 1000) {
+		return;
+	}
+	_last_checkpoint_check_msec = now_ms;
+
+	// Gather dirty blocks with their ages. Map read locks only, like other concurrent observers.
+	struct DirtyRef {
+		uint32_t modified_time_ms;
+		Vector3i position;
+		uint8_t lod;
+	};
+	static thread_local std::vector<DirtyRef> tls_dirty_refs;
+	tls_dirty_refs.clear();
+	uint32_t oldest_age_ms = 0;
+	for (unsigned int lod_index = 0; lod_index < _data->lod_count; ++lod_index) {
+		VoxelDataLodMap::Lod &data_lod = _data->lods[lod_index];
+		RWLockRead rlock(data_lod.map_lock);
+		data_lod.map.for_each_block([&tls_dirty_refs, &oldest_age_ms, now_ms](VoxelDataBlock &block) {
+			if (block.is_modified()) {
+				const uint32_t age_ms = now_ms - block.get_modified_time_ms();
+				oldest_age_ms = math::max(oldest_age_ms, age_ms);
+				tls_dirty_refs.push_back(DirtyRef{ block.get_modified_time_ms(), block.position, block.lod_index });
+			}
+		});
+	}
+
+	if (tls_dirty_refs.size() < _checkpoint_dirty_block_threshold &&
+			oldest_age_ms < uint32_t(_checkpoint_max_age_seconds * 1000.f)) {
+		return;
+	}
+
+	// I/O pacing: the per-second budget divided by the stream's measured mean save time bounds
+	// how many blocks this pass may schedule. The saves themselves run on the streaming pool.
+	uint64_t mean_save_usec = 2000;
+	{
+		const VoxelStream::IoStats &io_stats = _stream->get_io_stats();
+		const uint64_t save_count = io_stats.save_count.load(std::memory_order_relaxed);
+		if (save_count > 0) {
+			mean_save_usec =
+					math::max(io_stats.save_time_total_usec.load(std::memory_order_relaxed) / save_count, //
+							uint64_t(1));
+		}
+	}
+	const unsigned int max_saves_this_pass =
+			math::max(1u, unsigned((uint64_t(_checkpoint_io_budget_msec) * 1000) / mean_save_usec));
+
+	// Oldest dirty blocks first, so a crash loses the most recent edits only
+	std::sort(tls_dirty_refs.begin(), tls_dirty_refs.end(), [](const DirtyRef &a, const DirtyRef &b) { //
+		return a.modified_time_ms < b.modified_time_ms;
+	});
+	if (tls_dirty_refs.size() > max_saves_this_pass) {
+		tls_dirty_refs.resize(max_saves_this_pass);
+	}
+
+	std::vector<VoxelLodTerrainUpdateData::BlockToSave> blocks_to_save;
+	for (const DirtyRef &ref : tls_dirty_refs) {
+		VoxelDataLodMap::Lod &data_lod = _data->lods[ref.lod];
+		RWLockRead rlock(data_lod.map_lock);
+		VoxelDataBlock *block = data_lod.map.get_block(ref.position);
+		if (block == nullptr || !block->is_modified()) {
+			// Unloaded or saved through another path since the scan
+			continue;
+		}
+		ScheduleSaveAction{ blocks_to_save }(*block);
+	}
+
+	if (blocks_to_save.size() > 0) {
+		_stats.checkpointed_blocks += blocks_to_save.size();
+		BufferedTaskScheduler task_scheduler;
+		VoxelLodTerrainUpdateTask::send_block_save_requests(
+				_volume_id, to_span(blocks_to_save), _streaming_dependency, get_data_block_size(), task_scheduler);
+		task_scheduler.flush();
+	}
+}
+
 void VoxelLodTerrain::_process(float delta) {
 	ZN_PROFILE_SCOPE();
 
@@ -1130,6 +1612,29 @@ void VoxelLodTerrain::_process(float delta) {
 	}
 #endif
 
+	if (VoxelServer::get_singleton().is_telemetry_enabled()) {
+		unsigned int data_block_count = 0;
+		for (unsigned int lod_index = 0; lod_index < _update_data->settings.lod_count; ++lod_index) {
+			const VoxelDataLodMap::Lod &data_lod = _data->lods[lod_index];
+			RWLockRead rlock(data_lod.map_lock);
+			data_block_count += data_lod.map.get_block_count();
+		}
+		unsigned int mesh_block_count = 0;
+		for (unsigned int lod_index = 0; lod_index < _update_data->settings.lod_count; ++lod_index) {
+			mesh_block_count += _mesh_maps_per_lod[lod_index].get_block_count();
+		}
+		VoxelServer::get_singleton().set_volume_debug_block_counts(_volume_id, data_block_count, mesh_block_count);
+	}
+
+	if (VoxelServer::get_singleton().is_memory_over_budget()) {
+		shed_memory_pass();
+	}
+
+	_material_warmup.process();
+
+	process_adaptive_lod();
+	process_checkpointing();
+
 	if (_update_data->task_is_complete) {
 		ZN_PROFILE_SCOPE();
 
@@ -1151,13 +1656,64 @@ void VoxelLodTerrain::_process(float delta) {
 			VoxelServer::get_singleton().push_async_task(task);
 
 		} else {
-			task->run(ThreadedTaskContext{ 0 });
-			memdelete(task);
-			apply_main_thread_update_tasks();
+			// Non-threaded mode still runs the task on the pool, but joins it at the end of the
+			// frame instead of next frame: VoxelServer::process runs after scene nodes, waits for
+			// every volume registered this way and applies their outputs. Several terrains in a
+			// scene thus overlap their updates and the frame pays the slowest, not the sum.
+			VoxelServer::get_singleton().push_async_task(task);
+			VoxelServer::get_singleton().push_synchronous_update_join(get_instance_id(), [](Object &object) {
+				VoxelLodTerrain *terrain = Object::cast_to<VoxelLodTerrain>(&object);
+				ERR_FAIL_COND(terrain == nullptr);
+				terrain->finish_synchronous_update();
+			});
 		}
 	}
 }
 
+void VoxelLodTerrain::finish_synchronous_update() {
+	ZN_PROFILE_SCOPE();
+	// The completion mutex is only held while the task runs, so it being free doesn't mean the
+	// task is done: a worker may not have picked it up yet. Poll the flag and use the mutex to
+	// wait out an in-progress run; the pickup window is tiny in practice.
+	while (_update_data->task_is_complete == false) {
+		_update_data->wait_for_end_of_task();
+		if (_update_data->task_is_complete == false) {
+			Thread::sleep_usec(100);
+		}
+	}
+	apply_main_thread_update_tasks();
+}
+
+// Runs while the memory governor reports pressure (see `VoxelServer::is_memory_over_budget`).
+// Tries in-place compression of resident blocks (uniform/tiled storage is a fraction of the dense
+// size), one LOD per frame and a bounded number of blocks since compressing scans whole buffers.
+// Blocks are marked so settled ones aren't rescanned; editing a block clears its mark. Actual
+// unloading remains driven by the sliding boxes: evicting blocks the octree still requires would
+// only trade memory for re-load churn.
+void VoxelLodTerrain::shed_memory_pass() {
+	ZN_PROFILE_SCOPE();
+	const unsigned int lod_count = _update_data->settings.lod_count;
+	if (lod_count == 0) {
+		return;
+	}
+	_memory_shed_lod_cursor = (_memory_shed_lod_cursor + 1) % lod_count;
+	VoxelDataLodMap::Lod &data_lod = _data->lods[_memory_shed_lod_cursor];
+	unsigned int budget = 64;
+	RWLockRead rlock(data_lod.map_lock);
+	data_lod.map.for_each_block([&budget](VoxelDataBlock &block) {
+		if (budget == 0 || block.was_compaction_attempted()) {
+			return;
+		}
+		VoxelBufferInternal &voxels = block.get_voxels();
+		{
+			RWLockWrite wlock(voxels.get_lock());
+			voxels.compress_uniform_channels();
+		}
+		block.mark_compaction_attempted();
+		--budget;
+	});
+}
+
 void VoxelLodTerrain::apply_main_thread_update_tasks() {
 	ZN_PROFILE_SCOPE();
 	// Dequeue outputs of the threadable part of the update for actions taking place on the main thread
@@ -1237,6 +1793,7 @@ void VoxelLodTerrain::apply_main_thread_update_tasks() {
 			//CRASH_COND(block == nullptr);
 			if (block->active) {
 				block->set_transition_mask(tu.transition_mask);
+				schedule_remesh_if_missing_transitions(*block);
 			}
 		}
 
@@ -1275,6 +1832,9 @@ bool thread_safe_contains(const std::unordered_set<T> &set, T v, BinaryMutex &mu
 }
 
 void VoxelLodTerrain::apply_data_block_response(VoxelServer::BlockDataOutput &ob) {
+	// New data changes the occlusion connectivity graph
+	_update_data->state.occlusion_dirty = true;
+
 	ZN_PROFILE_SCOPE();
 
 	if (ob.type == VoxelServer::BlockDataOutput::TYPE_SAVED) {
@@ -1332,6 +1892,16 @@ void VoxelLodTerrain::apply_data_block_response(VoxelServer::BlockDataOutput &ob
 		VoxelDataBlock *block = data_lod.map.set_block_buffer(ob.position, ob.voxels, false);
 		CRASH_COND(block == nullptr);
 		block->set_edited(ob.type == VoxelServer::BlockDataOutput::TYPE_LOADED);
+
+		// Seed the edit journal from the block's provenance, so lightly-edited blocks can keep
+		// being saved as deltas against generator output
+		if (ob.type == VoxelServer::BlockDataOutput::TYPE_GENERATED) {
+			block->init_edit_journal_empty();
+		} else if (ob.delta_boxes.size() > 0) {
+			block->init_edit_journal(to_span_const(ob.delta_boxes));
+		} else {
+			block->invalidate_edit_journal();
+		}
 	}
 
 	{
@@ -1346,6 +1916,23 @@ void VoxelLodTerrain::apply_data_block_response(VoxelServer::BlockDataOutput &ob
 	}
 }
 
+// Transition meshes are only built for the sides displayed at the time a block was meshed. When a
+// side gets enabled later (a neighbor changed LOD), the block needs a remesh to produce it.
+void VoxelLodTerrain::schedule_remesh_if_missing_transitions(VoxelMeshBlockVLT &block) {
+	if ((block.get_transition_mask() & ~block.built_transition_sides) == 0) {
+		return;
+	}
+	VoxelLodTerrainUpdateData::Lod &lod = _update_data->state.lods[block.lod_index];
+	RWLockRead rlock(lod.mesh_map_state.map_lock);
+	auto mesh_block_it = lod.mesh_map_state.map.find(block.position);
+	if (mesh_block_it != lod.mesh_map_state.map.end()) {
+		// Only flip blocks that are considered up to date, pending updates will build the sides
+		// anyways
+		VoxelLodTerrainUpdateData::MeshState expected = VoxelLodTerrainUpdateData::MESH_UP_TO_DATE;
+		mesh_block_it->second.state.compare_exchange_strong(expected, VoxelLodTerrainUpdateData::MESH_NEED_UPDATE);
+	}
+}
+
 void VoxelLodTerrain::apply_mesh_update(const VoxelServer::BlockMeshOutput &ob) {
 	// The following is done on the main thread because Godot doesn't really support multithreaded Mesh allocation.
 	// This also proved to be very slow compared to the meshing process itself...
@@ -1399,8 +1986,23 @@ void VoxelLodTerrain::apply_mesh_update(const VoxelServer::BlockMeshOutput &ob)
 
 	const VoxelMesher::Output &mesh_data = ob.surfaces;
 
-	Ref<ArrayMesh> mesh =
-			build_mesh(to_span_const(mesh_data.surfaces), mesh_data.primitive_type, mesh_data.mesh_flags, _material);
+	// Differential upload: sculpting edits often remesh a block into the same topology with only
+	// some vertices moved. When that happens, the changed buffer region is patched into the
+	// existing GPU mesh, skipping the whole ArrayMesh rebuild and re-upload.
+	bool gpu_patched = false;
+	if (block != nullptr && ob.lod == 0 && ob.packed_surfaces.size() == 1) {
+		gpu_patched = block->try_patch_surface(ob.packed_surfaces[0].data);
+	}
+
+	Ref<ArrayMesh> mesh;
+	if (gpu_patched) {
+		mesh = block->get_mesh();
+	} else {
+		mesh = ob.packed_surfaces.size() > 0
+				? build_mesh_from_packed(to_span_const(ob.packed_surfaces), _material)
+				: build_mesh(
+						  to_span_const(mesh_data.surfaces), mesh_data.primitive_type, mesh_data.mesh_flags, _material);
+	}
 
 	if (mesh.is_null()) {
 		if (block != nullptr) {
@@ -1470,7 +2072,32 @@ void VoxelLodTerrain::apply_mesh_update(const VoxelServer::BlockMeshOutput &ob)
 		block->set_transition_mask(transition_mask);
 	}
 
-	block->set_mesh(mesh, DirectMeshInstance::GIMode(get_gi_mode()));
+	block->built_transition_sides = ob.built_transition_sides_mask;
+	schedule_remesh_if_missing_transitions(*block);
+
+	if (ob.surfaces.polish_pass_skipped) {
+		// The latency-critical edit response skipped simplification; request a regular rebuild,
+		// whose simplified mesh hot-swaps in whenever it completes
+		VoxelLodTerrainUpdateData::Lod &lod_data = _update_data->state.lods[ob.lod];
+		RWLockRead rlock(lod_data.mesh_map_state.map_lock);
+		auto mesh_block_it = lod_data.mesh_map_state.map.find(ob.position);
+		if (mesh_block_it != lod_data.mesh_map_state.map.end()) {
+			VoxelLodTerrainUpdateData::MeshState expected = VoxelLodTerrainUpdateData::MESH_UP_TO_DATE;
+			mesh_block_it->second.state.compare_exchange_strong(
+					expected, VoxelLodTerrainUpdateData::MESH_NEED_UPDATE);
+		}
+	}
+
+	if (!gpu_patched) {
+		block->set_mesh(mesh, DirectMeshInstance::GIMode(get_gi_mode()));
+		// Keep the packed surface of single-surface LOD 0 blocks, so the next edit-driven update
+		// can be diffed against it; other blocks don't get edited in place
+		if (ob.lod == 0 && ob.packed_surfaces.size() == 1) {
+			block->store_surface_data(ob.packed_surfaces[0].data);
+		} else {
+			block->clear_stored_surface_data();
+		}
+	}
 	{
 		ZN_PROFILE_SCOPE_NAMED("Transition meshes");
 		for (unsigned int dir = 0; dir < mesh_data.transition_surfaces.size(); ++dir) {
@@ -1485,8 +2112,14 @@ void VoxelLodTerrain::apply_mesh_update(const VoxelServer::BlockMeshOutput &ob)
 	if (has_collision) {
 		if (_collision_update_delay == 0 ||
 				static_cast<int>(now - block->last_collider_update_time) > _collision_update_delay) {
-			block->set_collision_mesh(to_span_const(mesh_data.surfaces), get_tree()->is_debugging_collisions_hint(),
-					this, _collision_margin);
+			if (ob.has_collision_shape_faces) {
+				// The triangle soup was cooked on the worker, only the shape gets created here
+				block->set_collision_shape(create_concave_polygon_shape(ob.collision_shape_faces),
+						get_tree()->is_debugging_collisions_hint(), this, _collision_margin);
+			} else {
+				block->set_collision_mesh(to_span_const(mesh_data.surfaces),
+						get_tree()->is_debugging_collisions_hint(), this, _collision_margin);
+			}
 			block->set_collision_layer(_collision_layer);
 			block->set_collision_mask(_collision_mask);
 			block->last_collider_update_time = now;
@@ -1674,6 +2307,209 @@ void VoxelLodTerrain::save_all_modified_blocks(bool with_copy) {
 	task_scheduler.flush();
 }
 
+void VoxelLodTerrain::flush_modified_blocks(const Callable &progress_callback) {
+	ZN_PROFILE_SCOPE();
+
+	// Synchronous counterpart of `save_all_modified_blocks`, meant for shutdowns and server
+	// restarts: instead of queueing save tasks behind the streaming thread, blocks are saved
+	// through the stream in batches right here, with progress reported between batches. The
+	// CPU-heavy serialization is parallelized by streams buffering their writes (see
+	// `VoxelStreamSQLite::flush_cache`).
+	ERR_FAIL_COND_MSG(_stream.is_null(), "There is no stream to save to");
+
+	_update_data->wait_for_end_of_task();
+
+	VoxelLodTerrainUpdateTask::flush_pending_lod_edits(
+			_update_data->state, *_data, _generator, _update_data->settings.full_load_mode, get_mesh_block_size());
+
+	std::vector<VoxelLodTerrainUpdateData::BlockToSave> blocks_to_save;
+	for (unsigned int i = 0; i < _data->lod_count; ++i) {
+		VoxelDataLodMap::Lod &data_lod = _data->lods[i];
+		RWLockRead rlock(data_lod.map_lock);
+		data_lod.map.for_each_block(ScheduleSaveAction{ blocks_to_save });
+	}
+
+	if (_instancer != nullptr && _stream->supports_instance_blocks()) {
+		// Instances are lighter, they keep going through the async path
+		_instancer->save_all_modified_blocks();
+	}
+
+	// Order batches so writes stream sequentially through region files
+	std::sort(blocks_to_save.begin(), blocks_to_save.end(),
+			[](const VoxelLodTerrainUpdateData::BlockToSave &a, const VoxelLodTerrainUpdateData::BlockToSave &b) {
+				return sequential_save_order_key(a.position, a.lod) < sequential_save_order_key(b.position, b.lod);
+			});
+
+	const unsigned int total = blocks_to_save.size();
+	const int data_block_size = get_data_block_size();
+	unsigned int saved_count = 0;
+
+	const unsigned int SAVE_BATCH_SIZE = 256;
+
+	std::vector<VoxelStream::VoxelQueryData> queries;
+	while (saved_count < total) {
+		const unsigned int batch_count = math::min(SAVE_BATCH_SIZE, total - saved_count);
+		queries.clear();
+		for (unsigned int i = 0; i < batch_count; ++i) {
+			VoxelLodTerrainUpdateData::BlockToSave &b = blocks_to_save[saved_count + i];
+			queries.push_back(VoxelStream::VoxelQueryData{ //
+					*b.voxels, (b.position << b.lod) * data_block_size, b.lod });
+		}
+		_stream->save_voxel_blocks(to_span(queries));
+		saved_count += batch_count;
+
+		if (progress_callback.is_valid()) {
+			const Variant saved_v = saved_count;
+			const Variant total_v = total;
+			const Variant *args[2] = { &saved_v, &total_v };
+			Callable::CallError err;
+			Variant retval; // We don't care about the return value, Callable API requires it
+			progress_callback.call(args, 2, retval, err);
+			if (err.error != Callable::CallError::CALL_OK) {
+				// Don't abort: failing to report progress must not prevent saving
+				ERR_PRINT("Progress callback failed");
+			}
+		}
+	}
+
+	// Make sure buffered saves actually hit storage now, not on a later incidental flush
+	_stream->flush();
+}
+
+namespace {
+const uint32_t WARMUP_SNAPSHOT_MAGIC = 0x53574E5A; // "ZNWS"
+const uint8_t WARMUP_SNAPSHOT_VERSION = 1;
+} // namespace
+
+bool VoxelLodTerrain::save_warmup_snapshot(String file_path) {
+	ZN_PROFILE_SCOPE();
+	ERR_FAIL_COND_V(_update_data == nullptr, false);
+
+	_update_data->wait_for_end_of_task();
+
+	Ref<FileAccess> f = FileAccess::open(file_path, FileAccess::WRITE);
+	ERR_FAIL_COND_V_MSG(f.is_null(), false, String("Could not open {0} for writing").format(varray(file_path)));
+
+	const unsigned int lod_count = _update_data->settings.lod_count;
+
+	f->store_32(WARMUP_SNAPSHOT_MAGIC);
+	f->store_8(WARMUP_SNAPSHOT_VERSION);
+	f->store_8(lod_count);
+	for (unsigned int lod_index = 0; lod_index < lod_count; ++lod_index) {
+		f->store_8(_data->lods[lod_index].map.get_block_size_pow2());
+	}
+
+	unsigned int block_count = 0;
+	const uint64_t block_count_position = f->get_position();
+	f->store_32(0); // Patched afterwards
+
+	for (unsigned int lod_index = 0; lod_index < lod_count; ++lod_index) {
+		VoxelDataLodMap::Lod &data_lod = _data->lods[lod_index];
+		RWLockRead rlock(data_lod.map_lock);
+
+		data_lod.map.for_each_block([&f, &block_count, lod_index](const VoxelDataBlock &block) {
+			RWLockRead block_rlock(block.get_voxels_const().get_lock());
+			BlockSerializer::SerializeResult res =
+					BlockSerializer::serialize_and_compress(block.get_voxels_const());
+			ERR_FAIL_COND(!res.success);
+
+			f->store_8(lod_index);
+			f->store_32(block.position.x);
+			f->store_32(block.position.y);
+			f->store_32(block.position.z);
+			const uint8_t flags = (block.is_edited() ? 1 : 0) | (block.is_modified() ? 2 : 0);
+			f->store_8(flags);
+			f->store_32(res.data.size());
+			f->store_buffer(res.data.data(), res.data.size());
+			++block_count;
+		});
+	}
+
+	// Patch the block count now that we know it
+	const uint64_t end_position = f->get_position();
+	f->seek(block_count_position);
+	f->store_32(block_count);
+	f->seek(end_position);
+
+	ZN_PRINT_VERBOSE(format("Saved warmup snapshot with {} blocks to {}", block_count,
+			String(file_path).utf8().get_data()));
+	return true;
+}
+
+bool VoxelLodTerrain::load_warmup_snapshot(String file_path) {
+	ZN_PROFILE_SCOPE();
+	ERR_FAIL_COND_V(_update_data == nullptr, false);
+
+	Ref<FileAccess> f = FileAccess::open(file_path, FileAccess::READ);
+	if (f.is_null()) {
+		// Not an error, there may simply be no snapshot yet
+		return false;
+	}
+
+	_update_data->wait_for_end_of_task();
+
+	ERR_FAIL_COND_V(f->get_32() != WARMUP_SNAPSHOT_MAGIC, false);
+	ERR_FAIL_COND_V(f->get_8() != WARMUP_SNAPSHOT_VERSION, false);
+
+	const unsigned int lod_count = f->get_8();
+	if (lod_count != _update_data->settings.lod_count) {
+		ZN_PRINT_VERBOSE("Warmup snapshot LOD count differs from the terrain's, ignoring it");
+		return false;
+	}
+	for (unsigned int lod_index = 0; lod_index < lod_count; ++lod_index) {
+		const unsigned int block_size_po2 = f->get_8();
+		if (block_size_po2 != _data->lods[lod_index].map.get_block_size_pow2()) {
+			ZN_PRINT_VERBOSE("Warmup snapshot block sizes differ from the terrain's, ignoring it");
+			return false;
+		}
+	}
+
+	const unsigned int block_count = f->get_32();
+
+	static thread_local std::vector<uint8_t> tls_blob;
+
+	unsigned int loaded_count = 0;
+	for (unsigned int i = 0; i < block_count; ++i) {
+		const unsigned int lod_index = f->get_8();
+		Vector3i position;
+		position.x = f->get_32();
+		position.y = f->get_32();
+		position.z = f->get_32();
+		const uint8_t flags = f->get_8();
+		const unsigned int blob_size = f->get_32();
+
+		ERR_FAIL_COND_V(lod_index >= lod_count, false);
+		tls_blob.resize(blob_size);
+		const uint64_t read_count = f->get_buffer(tls_blob.data(), blob_size);
+		ERR_FAIL_COND_V(read_count != blob_size, false);
+
+		std::shared_ptr<VoxelBufferInternal> voxels = make_shared_instance<VoxelBufferInternal>();
+		if (!BlockSerializer::decompress_and_deserialize(to_span_const(tls_blob), *voxels)) {
+			ERR_PRINT("Failed to deserialize a warmup snapshot block, ignoring the rest");
+			return false;
+		}
+
+		VoxelDataLodMap::Lod &data_lod = _data->lods[lod_index];
+		{
+			RWLockWrite wlock(data_lod.map_lock);
+			VoxelDataBlock *block = data_lod.map.set_block_buffer(position, voxels, true);
+			ERR_FAIL_COND_V(block == nullptr, false);
+			block->set_edited((flags & 1) != 0);
+			block->set_modified((flags & 2) != 0);
+			// Unknown provenance, only full saves are safe for these
+			block->invalidate_edit_journal();
+		}
+		++loaded_count;
+	}
+
+	// The update task must re-evaluate everything with the warm data in place
+	_update_data->state.force_update_octrees_next_update = true;
+
+	ZN_PRINT_VERBOSE(format("Loaded warmup snapshot with {} blocks from {}", loaded_count,
+			String(file_path).utf8().get_data()));
+	return true;
+}
+
 const VoxelLodTerrain::Stats &VoxelLodTerrain::get_stats() const {
 	return _stats;
 }
@@ -1699,6 +2535,7 @@ Dictionary VoxelLodTerrain::_b_get_statistics() const {
 
 	// Process
 	d["dropped_block_loads"] = _stats.dropped_block_loads;
+	d["checkpointed_blocks"] = int64_t(_stats.checkpointed_blocks);
 	d["dropped_block_meshs"] = _stats.dropped_block_meshs;
 
 	return d;
@@ -1794,6 +2631,10 @@ void VoxelLodTerrain::_b_save_modified_blocks() {
 	save_all_modified_blocks(true);
 }
 
+void VoxelLodTerrain::_b_flush_modified_blocks(const Callable &progress_callback) {
+	flush_modified_blocks(progress_callback);
+}
+
 void VoxelLodTerrain::_b_set_voxel_bounds(AABB aabb) {
 	ERR_FAIL_COND(!math::is_valid_size(aabb.size));
 	set_voxel_bounds(Box3i(math::round_to_int(aabb.position), math::round_to_int(aabb.size)));
@@ -2072,7 +2913,7 @@ void VoxelLodTerrain::update_gizmos() {
 	// Edited blocks
 	if (_show_edited_blocks && _edited_blocks_gizmos_lod_index < lod_count) {
 		const VoxelDataLodMap::Lod &data_lod = _data->lods[_edited_blocks_gizmos_lod_index];
-		const int data_block_size = get_data_block_size() << _edited_blocks_gizmos_lod_index;
+		const int data_block_size = data_lod.map.get_block_size() << _edited_blocks_gizmos_lod_index;
 		const Basis basis(Basis().scaled(Vector3(data_block_size, data_block_size, data_block_size)));
 
 		RWLockRead rlock(data_lod.map_lock);
@@ -2250,6 +3091,52 @@ void VoxelLodTerrain::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_full_load_mode_enabled"), &VoxelLodTerrain::set_full_load_mode_enabled);
 	ClassDB::bind_method(D_METHOD("is_full_load_mode_enabled"), &VoxelLodTerrain::is_full_load_mode_enabled);
 
+	ClassDB::bind_method(D_METHOD("set_speculative_meshing_enabled", "enabled"),
+			&VoxelLodTerrain::set_speculative_meshing_enabled);
+	ClassDB::bind_method(
+			D_METHOD("is_speculative_meshing_enabled"), &VoxelLodTerrain::is_speculative_meshing_enabled);
+
+	ClassDB::bind_method(D_METHOD("set_occlusion_culling_enabled", "enabled"),
+			&VoxelLodTerrain::set_occlusion_culling_enabled);
+	ClassDB::bind_method(
+			D_METHOD("is_occlusion_culling_enabled"), &VoxelLodTerrain::is_occlusion_culling_enabled);
+
+	ClassDB::bind_method(D_METHOD("set_checkpoint_enabled", "enabled"), &VoxelLodTerrain::set_checkpoint_enabled);
+	ClassDB::bind_method(D_METHOD("is_checkpoint_enabled"), &VoxelLodTerrain::is_checkpoint_enabled);
+	ClassDB::bind_method(D_METHOD("set_checkpoint_dirty_block_threshold", "count"),
+			&VoxelLodTerrain::set_checkpoint_dirty_block_threshold);
+	ClassDB::bind_method(D_METHOD("get_checkpoint_dirty_block_threshold"),
+			&VoxelLodTerrain::get_checkpoint_dirty_block_threshold);
+	ClassDB::bind_method(D_METHOD("set_checkpoint_max_age_seconds", "seconds"),
+			&VoxelLodTerrain::set_checkpoint_max_age_seconds);
+	ClassDB::bind_method(
+			D_METHOD("get_checkpoint_max_age_seconds"), &VoxelLodTerrain::get_checkpoint_max_age_seconds);
+	ClassDB::bind_method(D_METHOD("set_checkpoint_io_budget_msec", "msec"),
+			&VoxelLodTerrain::set_checkpoint_io_budget_msec);
+	ClassDB::bind_method(
+			D_METHOD("get_checkpoint_io_budget_msec"), &VoxelLodTerrain::get_checkpoint_io_budget_msec);
+
+	ClassDB::bind_method(
+			D_METHOD("set_adaptive_lod_enabled", "enabled"), &VoxelLodTerrain::set_adaptive_lod_enabled);
+	ClassDB::bind_method(D_METHOD("is_adaptive_lod_enabled"), &VoxelLodTerrain::is_adaptive_lod_enabled);
+	ClassDB::bind_method(D_METHOD("set_adaptive_lod_min_distance", "distance"),
+			&VoxelLodTerrain::set_adaptive_lod_min_distance);
+	ClassDB::bind_method(
+			D_METHOD("get_adaptive_lod_min_distance"), &VoxelLodTerrain::get_adaptive_lod_min_distance);
+
+	ClassDB::bind_method(D_METHOD("set_sdf_low_precision_lod_start", "lod_index"),
+			&VoxelLodTerrain::set_sdf_low_precision_lod_start);
+	ClassDB::bind_method(
+			D_METHOD("get_sdf_low_precision_lod_start"), &VoxelLodTerrain::get_sdf_low_precision_lod_start);
+
+	ClassDB::bind_method(D_METHOD("set_distant_data_block_size", "size"),
+			&VoxelLodTerrain::set_distant_data_block_size);
+	ClassDB::bind_method(D_METHOD("get_distant_data_block_size"), &VoxelLodTerrain::get_distant_data_block_size);
+	ClassDB::bind_method(D_METHOD("set_distant_data_block_size_lod_start", "lod_index"),
+			&VoxelLodTerrain::set_distant_data_block_size_lod_start);
+	ClassDB::bind_method(D_METHOD("get_distant_data_block_size_lod_start"),
+			&VoxelLodTerrain::get_distant_data_block_size_lod_start);
+
 	ClassDB::bind_method(D_METHOD("get_statistics"), &VoxelLodTerrain::_b_get_statistics);
 	ClassDB::bind_method(
 			D_METHOD("voxel_to_data_block_position", "lod_index"), &VoxelLodTerrain::voxel_to_data_block_position);
@@ -2258,6 +3145,12 @@ void VoxelLodTerrain::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_voxel_tool"), &VoxelLodTerrain::get_voxel_tool);
 	ClassDB::bind_method(D_METHOD("save_modified_blocks"), &VoxelLodTerrain::_b_save_modified_blocks);
+	ClassDB::bind_method(D_METHOD("flush_modified_blocks", "progress_callback"),
+			&VoxelLodTerrain::_b_flush_modified_blocks, DEFVAL(Callable()));
+	ClassDB::bind_method(
+			D_METHOD("save_warmup_snapshot", "file_path"), &VoxelLodTerrain::save_warmup_snapshot);
+	ClassDB::bind_method(
+			D_METHOD("load_warmup_snapshot", "file_path"), &VoxelLodTerrain::load_warmup_snapshot);
 
 	ClassDB::bind_method(D_METHOD("set_run_stream_in_editor"), &VoxelLodTerrain::set_run_stream_in_editor);
 	ClassDB::bind_method(D_METHOD("is_stream_running_in_editor"), &VoxelLodTerrain::is_stream_running_in_editor);
@@ -2266,6 +3159,14 @@ void VoxelLodTerrain::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_voxel_bounds"), &VoxelLodTerrain::_b_get_voxel_bounds);
 
 	ClassDB::bind_method(D_METHOD("set_process_callback", "mode"), &VoxelLodTerrain::set_process_callback);
+
+	ClassDB::bind_method(
+			D_METHOD("warm_up_points", "points", "view_distance"), &VoxelLodTerrain::warm_up_points);
+	ClassDB::bind_method(D_METHOD("stop_warm_up"), &VoxelLodTerrain::stop_warm_up);
+	ClassDB::bind_method(D_METHOD("is_warming_up"), &VoxelLodTerrain::is_warming_up);
+	ClassDB::bind_method(D_METHOD("get_area_streaming_completion", "aabb", "lod_index"),
+			&VoxelLodTerrain::get_area_streaming_completion, DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("get_lod_streaming_stats"), &VoxelLodTerrain::get_lod_streaming_stats);
 	ClassDB::bind_method(D_METHOD("get_process_callback"), &VoxelLodTerrain::get_process_callback);
 
 	ClassDB::bind_method(
@@ -2330,6 +3231,28 @@ void VoxelLodTerrain::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "mesh_block_size"), "set_mesh_block_size", "get_mesh_block_size");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "full_load_mode_enabled"), "set_full_load_mode_enabled",
 			"is_full_load_mode_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "speculative_meshing_enabled"), "set_speculative_meshing_enabled",
+			"is_speculative_meshing_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "occlusion_culling_enabled"), "set_occlusion_culling_enabled",
+			"is_occlusion_culling_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "checkpoint_enabled"), "set_checkpoint_enabled",
+			"is_checkpoint_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "checkpoint_dirty_block_threshold", PROPERTY_HINT_RANGE, "1,65536,1"),
+			"set_checkpoint_dirty_block_threshold", "get_checkpoint_dirty_block_threshold");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "checkpoint_max_age_seconds", PROPERTY_HINT_RANGE, "1,3600,1"),
+			"set_checkpoint_max_age_seconds", "get_checkpoint_max_age_seconds");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "checkpoint_io_budget_msec", PROPERTY_HINT_RANGE, "1,1000,1"),
+			"set_checkpoint_io_budget_msec", "get_checkpoint_io_budget_msec");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "adaptive_lod_enabled"), "set_adaptive_lod_enabled",
+			"is_adaptive_lod_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "adaptive_lod_min_distance"), "set_adaptive_lod_min_distance",
+			"get_adaptive_lod_min_distance");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "sdf_low_precision_lod_start"), "set_sdf_low_precision_lod_start",
+			"get_sdf_low_precision_lod_start");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "distant_data_block_size"), "set_distant_data_block_size",
+			"get_distant_data_block_size");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "distant_data_block_size_lod_start"),
+			"set_distant_data_block_size_lod_start", "get_distant_data_block_size_lod_start");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "threaded_update_enabled"), "set_threaded_update_enabled",
 			"is_threaded_update_enabled");
 }
@@ -4,6 +4,7 @@
 #include "../../server/mesh_block_task.h"
 #include "../../server/voxel_server.h"
 #include "../../storage/voxel_data_map.h"
+#include "../material_warmup.h"
 #include "../voxel_mesh_map.h"
 #include "../voxel_node.h"
 #include "lod_octree.h"
@@ -50,6 +51,46 @@ public:
 	void set_lod_distance(float p_lod_distance);
 	float get_lod_distance() const;
 
+	// Cache-warming pass for loading screens: spawns hidden streaming viewers at the given
+	// points (a spawn point set, or a camera path sampled by the caller) so the load, generation
+	// and meshing pipeline fills its caches and mesh blocks ahead of the real viewer arriving.
+	// Bounded by `view_distance` around each point; runs at regular task priority, which is
+	// effectively idle time while a loading screen shows. Call `stop_warm_up` at fade-in (the
+	// warmed area stays resident through the usual unload rules); poll VoxelServer stats for
+	// quiescence to know when warming finished.
+	void warm_up_points(PackedVector3Array points, float view_distance);
+	void stop_warm_up();
+	bool is_warming_up() const;
+
+	// Streaming state for gameplay decisions (e.g. gating spawns until the local area is
+	// meshed). The AABB is in terrain-local voxel coordinates; returns the fraction of mesh
+	// blocks of the given LOD inside it that are meshed and current (1.0 when the area holds no
+	// mesh blocks). Reads shared state briefly under a read lock, callable every frame.
+	float get_area_streaming_completion(AABB aabb, int lod_index) const;
+	// Per-LOD gauges republished by each update (loading data blocks, mesh block counts);
+	// lock-free read of the latest published values
+	Array get_lod_streaming_stats() const;
+
+	// Feedback controller: when enabled, the effective LOD distance scales down toward the
+	// configured minimum while meshing queues balloon, and creeps back up to the configured
+	// distance when they drain. Graceful degradation for dense scenes instead of runaway queues.
+	void set_adaptive_lod_enabled(bool enabled);
+	bool is_adaptive_lod_enabled() const;
+
+	// Checkpointing: when enabled, modified blocks are saved incrementally in the background
+	// once the dirty count or the oldest dirty age trips a threshold, oldest-first, with I/O
+	// pacing so a crash loses minutes at most without the stutter a naive autosave causes.
+	void set_checkpoint_enabled(bool enabled);
+	bool is_checkpoint_enabled() const;
+	void set_checkpoint_dirty_block_threshold(int count);
+	int get_checkpoint_dirty_block_threshold() const;
+	void set_checkpoint_max_age_seconds(float seconds);
+	float get_checkpoint_max_age_seconds() const;
+	void set_checkpoint_io_budget_msec(int msec);
+	int get_checkpoint_io_budget_msec() const;
+	void set_adaptive_lod_min_distance(float distance);
+	float get_adaptive_lod_min_distance() const;
+
 	void set_lod_count(int p_lod_count);
 	int get_lod_count() const;
 
@@ -88,9 +129,43 @@ public:
 	void set_full_load_mode_enabled(bool enabled);
 	bool is_full_load_mode_enabled() const;
 
+	// When enabled, child data and meshes of octree nodes the viewer moves toward are requested
+	// ahead of the split distance, making LOD swaps near-instant at the cost of some extra work
+	void set_speculative_meshing_enabled(bool enabled);
+	bool is_speculative_meshing_enabled() const;
+
+	// First LOD index whose freshly created data blocks use 8-bit SDF instead of 16-bit, with
+	// dithered requantization when mips are downscaled. Halves memory and serialization cost of
+	// the distant LOD pyramid; 0 disables. Only effective without a stream declaring fixed
+	// channel depths (region files), since their format applies to every block.
+	void set_sdf_low_precision_lod_start(int lod_index);
+	int get_sdf_low_precision_lod_start() const;
+
+	// Experimental cave culling: defers meshing of LOD-0 blocks that air can't reach from the
+	// viewer. See VoxelLodTerrainUpdateData::Settings::occlusion_culling_enabled for caveats.
+	void set_occlusion_culling_enabled(bool enabled);
+	bool is_occlusion_culling_enabled() const;
+
+	// Optionally makes distant LODs use larger data blocks than near LODs, trading edit/remesh
+	// granularity for less per-block overhead where detail doesn't matter. 0 means disabled
+	// (all LODs use the same size). Only effective in full load mode without a stream, because
+	// streams store blocks of a single fixed size.
+	void set_distant_data_block_size(unsigned int size);
+	unsigned int get_distant_data_block_size() const;
+
+	// First LOD index at which the distant data block size applies. LOD0 always keeps the base
+	// size so edits stay cheap.
+	void set_distant_data_block_size_lod_start(unsigned int lod_index);
+	unsigned int get_distant_data_block_size_lod_start() const;
+
 	void set_threaded_update_enabled(bool enabled);
 	bool is_threaded_update_enabled() const;
 
+	// Waits for this volume's update task and applies its main-thread outputs. Called by
+	// VoxelServer at the end of the frame for volumes not using threaded updates, see
+	// `VoxelServer::push_synchronous_update_join`.
+	void finish_synchronous_update();
+
 	bool is_area_editable(Box3i p_box) const;
 	VoxelSingleValue get_voxel(Vector3i pos, unsigned int channel, VoxelSingleValue defval);
 	bool try_set_voxel_without_update(Vector3i pos, unsigned int channel, uint64_t value);
@@ -193,7 +268,9 @@ public:
 		uint32_t time_mesh_requests = 0;
 		// Total time spent in the last update task, in microseconds.
 		// This only includes the threadable part, not the whole `process` function.
-		uint32_t time_update_task = 0;
+		uint32_t time_update_task = 0;		// Lifetime count of blocks saved by background checkpointing
+		uint64_t checkpointed_blocks = 0;
+
 	};
 
 	const Stats &get_stats() const;
@@ -250,9 +327,16 @@ protected:
 
 private:
 	void _process(float delta);
+	void shed_memory_pass();
+	void process_adaptive_lod();
+	void process_checkpointing();
+	uint8_t get_effective_sdf_depth_policy() const;
+	// Changes the effective LOD distance without touching the user-requested one
+	void apply_lod_distance(float lod_distance);
 	void apply_main_thread_update_tasks();
 
 	void apply_mesh_update(const VoxelServer::BlockMeshOutput &ob);
+	void schedule_remesh_if_missing_transitions(VoxelMeshBlockVLT &block);
 	void apply_data_block_response(VoxelServer::BlockDataOutput &ob);
 
 	void start_updater();
@@ -268,6 +352,16 @@ private:
 	void _on_stream_params_changed();
 
 	void save_all_modified_blocks(bool with_copy);
+	// Saves all modified blocks synchronously through the stream, in batches, optionally reporting
+	// progress as `progress_callback(saved_count, total)` between batches. Meant for shutdowns.
+	void flush_modified_blocks(const Callable &progress_callback);
+
+	// Warmup snapshot: writes every loaded data block to one sequential file, so the next boot
+	// can bulk-load them instead of re-streaming and regenerating the whole area. Returns true on
+	// success. Meant to be called at shutdown (after saving modified blocks) and at startup before
+	// streaming begins.
+	bool save_warmup_snapshot(String file_path);
+	bool load_warmup_snapshot(String file_path);
 
 	// TODO Put in common with VoxelLodTerrainUpdateTask
 	// void send_block_save_requests(Span<BlockToSave> blocks_to_save);
@@ -276,6 +370,7 @@ private:
 	void process_fading_blocks(float delta);
 
 	void _b_save_modified_blocks();
+	void _b_flush_modified_blocks(const Callable &progress_callback);
 	void _b_set_voxel_bounds(AABB aabb);
 	AABB _b_get_voxel_bounds() const;
 	Array _b_debug_print_sdf_top_down(Vector3i center, Vector3i extents);
@@ -292,9 +387,30 @@ private:
 
 private:
 	uint32_t _volume_id = 0;
+	// Streaming viewers created by `warm_up_points`
+	std::vector<uint32_t> _warmup_viewer_ids;
+	// Rotates over LODs between memory-pressure sweeps, see `shed_memory_pass`
+	unsigned int _memory_shed_lod_cursor = 0;
+	// Adaptive LOD state, see `process_adaptive_lod`. The requested distance is what the user
+	// set; the effective one lives in the update settings and may be scaled below it.
+	float _requested_lod_distance = 48.f;
+	bool _adaptive_lod_enabled = false;
+
+	// See `set_checkpoint_enabled`
+	bool _checkpoint_enabled = false;
+	unsigned int _checkpoint_dirty_block_threshold = 512;
+	float _checkpoint_max_age_seconds = 60.f;
+	unsigned int _checkpoint_io_budget_msec = 10;
+	uint32_t _last_checkpoint_check_msec = 0;
+	float _adaptive_lod_min_distance = 24.f;
+	// See `set_sdf_low_precision_lod_start`. 0 = disabled.
+	unsigned int _sdf_low_precision_lod_start = 0;
+	uint32_t _last_adaptive_lod_time_msec = 0;
 	ProcessCallback _process_callback = PROCESS_CALLBACK_IDLE;
 
 	Ref<Material> _material;
+	// Pre-compiles material pipelines when entering the world, see MaterialPipelineWarmup
+	MaterialPipelineWarmup _material_warmup;
 	std::vector<Ref<ShaderMaterial>> _shader_material_pool;
 
 	FixedArray<VoxelMeshMap<VoxelMeshBlockVLT>, constants::MAX_LOD> _mesh_maps_per_lod;
@@ -307,6 +423,10 @@ private:
 	int _collision_update_delay = 0;
 	FixedArray<std::vector<Vector3i>, constants::MAX_LOD> _deferred_collision_updates_per_lod;
 
+	// 0 = disabled, otherwise 16 or 32. See `set_distant_data_block_size`.
+	unsigned int _distant_data_block_size = 0;
+	unsigned int _distant_data_block_size_lod_start = 2;
+
 	float _lod_fade_duration = 0.f;
 	// Note, direct pointers to mesh blocks should be safe because these blocks are always destroyed from the same
 	// thread that updates fading blocks. If a mesh block is destroyed, these maps should be updated at the same time.
@@ -6,6 +6,7 @@
 #include "../../storage/voxel_data_map.h"
 #include "../../streams/voxel_stream.h"
 #include "../../util/fixed_array.h"
+#include "../../util/thread/spsc_ring.h"
 #include "../voxel_mesh_map.h"
 #include "lod_octree.h"
 
@@ -22,6 +23,10 @@ namespace voxel {
 struct VoxelLodTerrainUpdateData {
 	struct OctreeItem {
 		LodOctree octree;
+		// True when the last fitting pass over this octree did nothing and nothing was blocked.
+		// Together with the viewer staying beyond the octree's influence radius, it lets the
+		// update skip walking this tree entirely. See `process_octrees_fitting`.
+		bool no_pending_activity = false;
 	};
 
 	struct TransitionUpdate {
@@ -38,6 +43,10 @@ struct VoxelLodTerrainUpdateData {
 		std::shared_ptr<VoxelBufferInternal> voxels;
 		Vector3i position;
 		uint8_t lod;
+		// Edit journal of the block when it is valid: regions diverging from generator output,
+		// letting the save be written as a compact delta (see delta saves on VoxelStream)
+		FixedArray<Box3i, 4> delta_boxes;
+		uint8_t delta_box_count = 0;
 	};
 
 	// These values don't change during the update task.
@@ -53,6 +62,20 @@ struct VoxelLodTerrainUpdateData {
 		bool full_load_mode = false;
 		bool run_stream_in_editor = true;
 		unsigned int mesh_block_size_po2 = 4;
+		// Mirrors of the node's collision settings, so mesh tasks can cook collision data
+		bool collision_enabled = true;
+		unsigned int collision_lod_count = 0;
+		// True when the mesher only reads SDF-like channels, in which case uniformly solid areas
+		// are known to produce no geometry, like uniformly empty ones
+		bool can_skip_uniform_matter = false;
+		// Request child data and meshes of octree nodes the viewer is moving toward before the
+		// split distance is crossed, so splits don't wait on the whole load->mesh chain
+		bool speculative_meshing_enabled = true;
+		// Experimental cave culling: meshing of LOD-0 blocks not reachable by air from the
+		// viewer is deferred until an edit or movement opens a path, see
+		// `update_occlusion_flood`. Can cause missing geometry if a sealed area becomes visible
+		// through means the flood can't see, so it is opt-in.
+		bool occlusion_culling_enabled = false;
 	};
 
 	enum MeshState {
@@ -110,6 +133,17 @@ struct VoxelLodTerrainUpdateData {
 		std::vector<Vector3i> mesh_blocks_to_activate;
 		std::vector<Vector3i> mesh_blocks_to_deactivate;
 
+		// Data blocks whose unload was deferred because an edit was writing them at the time.
+		// Retried every update until the edit ends (or the block comes back in view).
+		std::vector<Vector3i> deferred_data_unloads;
+
+		// Occlusion culling, only used on LOD 0. Data blocks reachable by air from the viewer
+		// (plus their face neighbors, whose walls are visible). Rebuilt by the update task.
+		std::unordered_set<Vector3i> occlusion_reachable_data_blocks;
+		// Mesh blocks whose update was suppressed while unreachable; re-scheduled when the flood
+		// reaches them
+		std::unordered_set<Vector3i> occlusion_suppressed_mesh_blocks;
+
 		inline bool has_loading_block(const Vector3i &pos) const {
 			return loading_blocks.find(pos) != loading_blocks.end();
 		}
@@ -135,7 +169,26 @@ struct VoxelLodTerrainUpdateData {
 	};
 
 	// Data modified by the update task
+	// Per-LOD streaming gauges, republished by the update task at the end of each run. Atomics
+	// so scripts can read them lock-free through the volume's API while the task keeps running;
+	// being one update late is fine for gameplay decisions like gating spawns.
+	struct LodStreamingStats {
+		std::atomic_uint32_t loading_data_blocks = { 0 };
+		std::atomic_uint32_t mesh_blocks = { 0 };
+		std::atomic_uint32_t mesh_blocks_up_to_date = { 0 };
+		std::atomic_uint32_t mesh_blocks_pending_update = { 0 };
+	};
+
 	struct State {
+		// See `LodStreamingStats`
+		FixedArray<LodStreamingStats, constants::MAX_LOD> streaming_stats;
+
+		// Occlusion culling bookkeeping, see `update_occlusion_flood`. The dirty flag is set from
+		// the main thread when data blocks load or edits land; the rest belongs to the update task.
+		std::atomic_bool occlusion_dirty = { true };
+		Vector3i occlusion_last_viewer_data_block = Vector3i(0x7fffffff, 0x7fffffff, 0x7fffffff);
+		bool occlusion_flood_valid = false;
+
 		// This terrain type is a sparse grid of octrees.
 		// Indexed by a grid coordinate whose step is the size of the highest-LOD block.
 		// Not using a pointer because Map storage is stable.
@@ -151,7 +204,15 @@ struct VoxelLodTerrainUpdateData {
 		// This is the entry point for notifying data changes, which will cause mesh updates.
 		// Contains blocks that were edited and need their LOD counterparts to be updated.
 		// Scheduling is only done at LOD0 because it is the only editable LOD.
-		std::vector<Vector3i> blocks_pending_lodding_lod0;
+		// Edit input queue: LOD-0 blocks edited since the last update. The main thread pushes on
+		// every edit through the wait-free ring, so `_process` and edits never contend with a
+		// running update task; the mutex-guarded list only catches ring overflow during massive
+		// edit bursts. The task drains both once per run. This follows the snapshot-in /
+		// commands-out structure the rest of this data already uses: the task reads immutable
+		// settings, consumes input queues at its start and publishes results in the
+		// `mesh_blocks_to_*` output lists applied after completion.
+		SpscRing<Vector3i, 1024> blocks_pending_lodding_lod0_ring;
+		std::vector<Vector3i> blocks_pending_lodding_lod0_overflow;
 		BinaryMutex blocks_pending_lodding_lod0_mutex;
 
 		std::vector<AsyncEdit> pending_async_edits;
@@ -4,11 +4,15 @@
 #include "../../server/mesh_block_task.h"
 #include "../../server/save_block_data_task.h"
 #include "../../server/voxel_server.h"
+#include "../../streams/save_order.h"
 #include "../../util/container_funcs.h"
 #include "../../util/math/conv.h"
 #include "../../util/profiling.h"
 #include "../../util/profiling_clock.h"
 #include "../../util/string_funcs.h"
+#include "../../util/thread/thread.h"
+
+#include <algorithm>
 
 namespace zylann::voxel {
 
@@ -21,9 +25,9 @@ void VoxelLodTerrainUpdateTask::flush_pending_lod_edits(VoxelLodTerrainUpdateDat
 	// i.e there is no way for a block to be loaded if its parent LOD isn't loaded already.
 	// In the future we may implement storing of edits to be applied later if blocks can't be found.
 
-	const int data_block_size = data.lods[0].map.get_block_size();
-	const int data_block_size_po2 = data.lods[0].map.get_block_size_pow2();
-	const int data_to_mesh_factor = mesh_block_size / data_block_size;
+	// Block sizes can differ between LODs (see `VoxelLodTerrain::set_distant_data_block_size`),
+	// so every size-dependent computation below uses the sizes of the LODs involved.
+	const int data_to_mesh_factor = mesh_block_size / data.lods[0].map.get_block_size();
 	const unsigned int lod_count = data.lod_count;
 
 	static thread_local FixedArray<std::vector<Vector3i>, constants::MAX_LOD> tls_blocks_to_process_per_lod;
@@ -31,18 +35,22 @@ void VoxelLodTerrainUpdateTask::flush_pending_lod_edits(VoxelLodTerrainUpdateDat
 	// Make sure LOD0 gets updates even if _lod_count is 1
 	VoxelLodTerrainUpdateData::Lod &lod0 = state.lods[0];
 	{
-		// Consume scheduled positions from LOD0
+		// Consume scheduled positions from LOD0: the wait-free ring first, then any overflow
+		// spilled during edit bursts
 		std::vector<Vector3i> &dst_lod0 = tls_blocks_to_process_per_lod[0];
+		dst_lod0.clear();
 
-		MutexLock lock(state.blocks_pending_lodding_lod0_mutex);
-
-		// Not sure if could just use `=`? What would std::vector do with capacity?
-		dst_lod0.resize(state.blocks_pending_lodding_lod0.size());
-		memcpy(dst_lod0.data(), state.blocks_pending_lodding_lod0.data(), dst_lod0.size() * sizeof(Vector3i));
-
-		// Make sure LOD0 has its list cleared, because in case there is only 1 LOD,
-		// the chain of updates will not be entered
-		state.blocks_pending_lodding_lod0.clear();
+		Vector3i pos;
+		while (state.blocks_pending_lodding_lod0_ring.try_pop(pos)) {
+			dst_lod0.push_back(pos);
+		}
+		{
+			MutexLock lock(state.blocks_pending_lodding_lod0_mutex);
+			for (unsigned int i = 0; i < state.blocks_pending_lodding_lod0_overflow.size(); ++i) {
+				dst_lod0.push_back(state.blocks_pending_lodding_lod0_overflow[i]);
+			}
+			state.blocks_pending_lodding_lod0_overflow.clear();
+		}
 	}
 	{
 		VoxelDataLodMap::Lod &data_lod0 = data.lods[0];
@@ -66,8 +74,6 @@ void VoxelLodTerrainUpdateTask::flush_pending_lod_edits(VoxelLodTerrainUpdateDat
 		}
 	}
 
-	const int half_bs = data_block_size >> 1;
-
 	// Process downscales upwards in pairs of consecutive LODs.
 	// This ensures we don't process multiple times the same blocks.
 	// Only LOD0 is editable at the moment, so we'll downscale from there
@@ -86,9 +92,17 @@ void VoxelLodTerrainUpdateTask::flush_pending_lod_edits(VoxelLodTerrainUpdateDat
 		// Besides, in per-block streaming mode, it is not needed because blocks are supposed to be present
 		RWLockRead wlock(dst_data_lod.map_lock);
 
+		const int src_block_size_po2 = src_data_lod.map.get_block_size_pow2();
+		const int dst_block_size_po2 = dst_data_lod.map.get_block_size_pow2();
+		// A source block always falls within exactly one destination block, because parent blocks
+		// are never smaller than half a child block (`reset_maps` only lets sizes grow with LOD)
+		const int src_to_dst_shift = dst_block_size_po2 + 1 - src_block_size_po2;
+		CRASH_COND(src_to_dst_shift < 0);
+		const int dst_data_to_mesh_factor = mesh_block_size >> dst_block_size_po2;
+
 		for (unsigned int i = 0; i < src_lod_blocks_to_process.size(); ++i) {
 			const Vector3i src_bpos = src_lod_blocks_to_process[i];
-			const Vector3i dst_bpos = src_bpos >> 1;
+			const Vector3i dst_bpos = src_bpos >> src_to_dst_shift;
 
 			VoxelDataBlock *src_block = src_data_lod.map.get_block(src_bpos);
 			VoxelDataBlock *dst_block = dst_data_lod.map.get_block(dst_bpos);
@@ -100,12 +114,12 @@ void VoxelLodTerrainUpdateTask::flush_pending_lod_edits(VoxelLodTerrainUpdateDat
 					// TODO Doing this on the main thread can be very demanding and cause a stall.
 					// We should find a way to make it asynchronous, not need mips, or not edit outside viewers area.
 					std::shared_ptr<VoxelBufferInternal> voxels = make_shared_instance<VoxelBufferInternal>();
-					voxels->create(Vector3iUtil::create(data_block_size));
+					voxels->create(Vector3iUtil::create(dst_data_lod.map.get_block_size()));
 					if (generator.is_valid()) {
 						ZN_PROFILE_SCOPE_NAMED("Generate");
 						VoxelGenerator::VoxelQueryData q{ //
 							*voxels, //
-							dst_bpos << (dst_lod_index + data_block_size_po2), //
+							dst_bpos << (dst_lod_index + dst_block_size_po2), //
 							dst_lod_index
 						};
 						generator->generate_block(q);
@@ -125,7 +139,7 @@ void VoxelLodTerrainUpdateTask::flush_pending_lod_edits(VoxelLodTerrainUpdateDat
 			//CRASH_COND(dst_block == nullptr);
 
 			{
-				const Vector3i mesh_block_pos = math::floordiv(dst_bpos, data_to_mesh_factor);
+				const Vector3i mesh_block_pos = math::floordiv(dst_bpos, dst_data_to_mesh_factor);
 				auto mesh_block_it = dst_lod.mesh_map_state.map.find(mesh_block_pos);
 				if (mesh_block_it != dst_lod.mesh_map_state.map.end()) {
 					schedule_mesh_update(mesh_block_it->second, mesh_block_pos, dst_lod.blocks_pending_update);
@@ -140,7 +154,12 @@ void VoxelLodTerrainUpdateTask::flush_pending_lod_edits(VoxelLodTerrainUpdateDat
 				dst_lod_blocks_to_process.push_back(dst_bpos);
 			}
 
-			const Vector3i rel = src_bpos - (dst_bpos << 1);
+			// Where the downscaled source block lands inside the destination block, in voxels
+			const Vector3i dst_rel_origin = (src_bpos << (src_block_size_po2 - 1)) - (dst_bpos << dst_block_size_po2);
+
+			// The mip write diverges this region from generator output, keep delta saves possible
+			dst_block->journal_edit(
+					Box3i(dst_rel_origin, Vector3iUtil::create(src_data_lod.map.get_block_size() >> 1)));
 
 			// Update lower LOD
 			// This must always be done after an edit before it gets saved, otherwise LODs won't match and it will look
@@ -149,8 +168,8 @@ void VoxelLodTerrainUpdateTask::flush_pending_lod_edits(VoxelLodTerrainUpdateDat
 			{
 				ZN_PROFILE_SCOPE_NAMED("Downscale");
 				RWLockWrite lock(src_block->get_voxels().get_lock());
-				src_block->get_voxels().downscale_to(
-						dst_block->get_voxels(), Vector3i(), src_block->get_voxels_const().get_size(), rel * half_bs);
+				src_block->get_voxels().downscale_to(dst_block->get_voxels(), Vector3i(),
+						src_block->get_voxels_const().get_size(), dst_rel_origin);
 			}
 		}
 
@@ -166,6 +185,7 @@ void VoxelLodTerrainUpdateTask::flush_pending_lod_edits(VoxelLodTerrainUpdateDat
 
 struct BeforeUnloadDataAction {
 	std::vector<VoxelLodTerrainUpdateData::BlockToSave> &blocks_to_save;
+	uint32_t volume_id;
 	bool save;
 
 	void operator()(VoxelDataBlock &block) {
@@ -180,14 +200,20 @@ struct BeforeUnloadDataAction {
 			b.lod = block.lod_index;
 			blocks_to_save.push_back(b);
 		}
+
+		// Keep a compressed copy in memory: players circling an area reload these without
+		// touching the stream. Done after scheduling the save, contents match what gets written.
+		VoxelServer::get_singleton().get_cold_block_cache().put(
+				volume_id, block.lod_index, block.position, block.get_voxels_const());
 	}
 };
 
 static void unload_data_block_no_lock(VoxelLodTerrainUpdateData::Lod &lod, VoxelDataLodMap::Lod &data_lod,
-		Vector3i block_pos, std::vector<VoxelLodTerrainUpdateData::BlockToSave> &blocks_to_save, bool can_save) {
+		Vector3i block_pos, std::vector<VoxelLodTerrainUpdateData::BlockToSave> &blocks_to_save, bool can_save,
+		uint32_t volume_id) {
 	ZN_PROFILE_SCOPE();
 
-	data_lod.map.remove_block(block_pos, BeforeUnloadDataAction{ blocks_to_save, can_save });
+	data_lod.map.remove_block(block_pos, BeforeUnloadDataAction{ blocks_to_save, volume_id, can_save });
 
 	//print_line(String("Unloading data block {0} lod {1}").format(varray(block_pos.to_vec3(), lod_index)));
 	MutexLock lock(lod.loading_blocks_mutex);
@@ -202,156 +228,208 @@ static void unload_data_block_no_lock(VoxelLodTerrainUpdateData::Lod &lod, Voxel
 	// It is a member only to re-use its capacity memory over frames.
 }
 
-static void process_unload_data_blocks_sliding_box(VoxelLodTerrainUpdateData::State &state, VoxelDataLodMap &data,
+// Runs the sliding-box data unload of one LOD. Returns false when the LOD's box does not intersect
+// the bounds at all (neither now nor before). Bodies of different LODs are independent of each
+// other, as long as each gets its own `blocks_to_save` list.
+static bool process_unload_data_blocks_sliding_box_lod(VoxelLodTerrainUpdateData::State &state, VoxelDataLodMap &data,
 		Vector3 p_viewer_pos, std::vector<VoxelLodTerrainUpdateData::BlockToSave> &blocks_to_save, bool can_save,
-		const VoxelLodTerrainUpdateData::Settings &settings) {
-	ZN_PROFILE_SCOPE_NAMED("Sliding box data unload");
-	// TODO Could it actually be enough to have a rolling update on all blocks?
+		const VoxelLodTerrainUpdateData::Settings &settings, int lod_index, uint32_t volume_id) {
+	ZN_PROFILE_SCOPE();
 
-	// This should be the same distance relatively to each LOD
-	const int data_block_size = data.lods[0].map.get_block_size();
-	const int data_block_size_po2 = data.lods[0].map.get_block_size_pow2();
+	const int data_block_size = data.lods[lod_index].map.get_block_size();
+	const int data_block_size_po2 = data.lods[lod_index].map.get_block_size_pow2();
 	const int data_block_region_extent =
 			VoxelServer::get_octree_lod_block_region_extent(settings.lod_distance, data_block_size);
-
 	const int mesh_block_size = 1 << settings.mesh_block_size_po2;
 
-	const int lod_count = data.lod_count;
-
-	// Ignore largest lod because it can extend a little beyond due to the view distance setting.
-	// Instead, those blocks are unloaded by the octree forest management.
-	// Iterating from big to small LOD so we can exit earlier if bounds don't intersect.
-	for (int lod_index = lod_count - 2; lod_index >= 0; --lod_index) {
-		ZN_PROFILE_SCOPE();
-		VoxelLodTerrainUpdateData::Lod &lod = state.lods[lod_index];
+	VoxelLodTerrainUpdateData::Lod &lod = state.lods[lod_index];
 
-		// Each LOD keeps a box of loaded blocks, and only some of the blocks will get polygonized.
-		// The player can edit them so changes can be propagated to lower lods.
+	// Each LOD keeps a box of loaded blocks, and only some of the blocks will get polygonized.
+	// The player can edit them so changes can be propagated to lower lods.
 
-		const unsigned int block_size_po2 = data_block_size_po2 + lod_index;
-		const Vector3i viewer_block_pos_within_lod =
-				VoxelDataMap::voxel_to_block_b(math::floor_to_int(p_viewer_pos), block_size_po2);
+	const unsigned int block_size_po2 = data_block_size_po2 + lod_index;
+	const Vector3i viewer_block_pos_within_lod =
+			VoxelDataMap::voxel_to_block_b(math::floor_to_int(p_viewer_pos), block_size_po2);
 
-		const Box3i bounds_in_blocks = Box3i( //
-				settings.bounds_in_voxels.pos >> block_size_po2, //
-				settings.bounds_in_voxels.size >> block_size_po2);
+	const Box3i bounds_in_blocks = Box3i( //
+			settings.bounds_in_voxels.pos >> block_size_po2, //
+			settings.bounds_in_voxels.size >> block_size_po2);
 
-		const Box3i new_box =
-				Box3i::from_center_extents(viewer_block_pos_within_lod, Vector3iUtil::create(data_block_region_extent));
-		const Box3i prev_box = Box3i::from_center_extents(
-				lod.last_viewer_data_block_pos, Vector3iUtil::create(lod.last_view_distance_data_blocks));
+	const Box3i new_box =
+			Box3i::from_center_extents(viewer_block_pos_within_lod, Vector3iUtil::create(data_block_region_extent));
+	const Box3i prev_box = Box3i::from_center_extents(
+			lod.last_viewer_data_block_pos, Vector3iUtil::create(lod.last_view_distance_data_blocks));
 
-		if (!new_box.intersects(bounds_in_blocks) && !prev_box.intersects(bounds_in_blocks)) {
-			// If this box doesn't intersect either now or before, there is no chance a smaller one will
-			break;
-		}
+	if (!new_box.intersects(bounds_in_blocks) && !prev_box.intersects(bounds_in_blocks)) {
+		return false;
+	}
 
-		// Eliminate pending blocks that aren't needed
+	// Eliminate pending blocks that aren't needed
 
-		if (prev_box != new_box) {
-			ZN_PROFILE_SCOPE_NAMED("Unload data");
-			VoxelDataLodMap::Lod &data_lod = data.lods[lod_index];
-			RWLockWrite wlock(data_lod.map_lock);
-			prev_box.difference(new_box, [&lod, &data_lod, &blocks_to_save, can_save](Box3i out_of_range_box) {
-				out_of_range_box.for_each_cell([&lod, &data_lod, &blocks_to_save, can_save](Vector3i pos) {
-					//print_line(String("Immerge {0}").format(varray(pos.to_vec3())));
-					unload_data_block_no_lock(lod, data_lod, pos, blocks_to_save, can_save);
-				});
+	if (prev_box != new_box) {
+		ZN_PROFILE_SCOPE_NAMED("Unload data");
+		VoxelDataLodMap::Lod &data_lod = data.lods[lod_index];
+		RWLockWrite wlock(data_lod.map_lock);
+		prev_box.difference(new_box, [&lod, &data_lod, &blocks_to_save, can_save, volume_id](Box3i out_of_range_box) {
+			out_of_range_box.for_each_cell([&lod, &data_lod, &blocks_to_save, can_save, volume_id](Vector3i pos) {
+				//print_line(String("Immerge {0}").format(varray(pos.to_vec3())));
+				if (data_lod.is_block_in_edited_boxes(pos)) {
+					// An edit is writing this block without holding the map lock; unloading now
+					// would lose its writes. Deferred and retried until the edit ends.
+					lod.deferred_data_unloads.push_back(pos);
+					return;
+				}
+				unload_data_block_no_lock(lod, data_lod, pos, blocks_to_save, can_save, volume_id);
 			});
-		}
+		});
 
-		{
-			ZN_PROFILE_SCOPE_NAMED("Cancel updates");
-			// Cancel block updates that are not within the padded region
-			// (since neighbors are always required to remesh)
-
-			const Box3i padded_new_box = new_box.padded(-1);
-			Box3i mesh_box;
-			if (mesh_block_size > data_block_size) {
-				const int factor = mesh_block_size / data_block_size;
-				mesh_box = padded_new_box.downscaled_inner(factor);
-			} else {
-				mesh_box = padded_new_box;
-			}
+		// Holding the write lock already: restore spatial iteration order if streaming churn
+		// scrambled it, so per-frame walks (checkpointing, memory shedding, saves) visit blocks
+		// of adjacent positions consecutively
+		data_lod.map.ensure_spatial_iteration_order();
+	}
 
-			unordered_remove_if(lod.blocks_pending_update, [&lod, mesh_box](Vector3i bpos) {
-				if (mesh_box.contains(bpos)) {
-					return false;
-				} else {
-					auto mesh_block_it = lod.mesh_map_state.map.find(bpos);
-					if (mesh_block_it != lod.mesh_map_state.map.end()) {
-						mesh_block_it->second.state = VoxelLodTerrainUpdateData::MESH_NEED_UPDATE;
+	if (lod.deferred_data_unloads.size() > 0) {
+		// Unloads previously skipped because an edit was writing those blocks
+		ZN_PROFILE_SCOPE_NAMED("Deferred unloads");
+		VoxelDataLodMap::Lod &data_lod = data.lods[lod_index];
+		RWLockWrite wlock(data_lod.map_lock);
+		unordered_remove_if(lod.deferred_data_unloads,
+				[&lod, &data_lod, &blocks_to_save, can_save, volume_id, new_box](Vector3i pos) {
+					if (new_box.contains(pos)) {
+						// Back in view, it should stay loaded
+						return true;
 					}
+					if (data_lod.is_block_in_edited_boxes(pos)) {
+						return false;
+					}
+					unload_data_block_no_lock(lod, data_lod, pos, blocks_to_save, can_save, volume_id);
 					return true;
-				}
-			});
+				});
+	}
+
+	{
+		ZN_PROFILE_SCOPE_NAMED("Cancel updates");
+		// Cancel block updates that are not within the padded region
+		// (since neighbors are always required to remesh)
+
+		const Box3i padded_new_box = new_box.padded(-1);
+		Box3i mesh_box;
+		if (mesh_block_size > data_block_size) {
+			const int factor = mesh_block_size / data_block_size;
+			mesh_box = padded_new_box.downscaled_inner(factor);
+		} else {
+			mesh_box = padded_new_box;
 		}
 
-		lod.last_viewer_data_block_pos = viewer_block_pos_within_lod;
-		lod.last_view_distance_data_blocks = data_block_region_extent;
+		unordered_remove_if(lod.blocks_pending_update, [&lod, mesh_box](Vector3i bpos) {
+			if (mesh_box.contains(bpos)) {
+				return false;
+			} else {
+				auto mesh_block_it = lod.mesh_map_state.map.find(bpos);
+				if (mesh_block_it != lod.mesh_map_state.map.end()) {
+					mesh_block_it->second.state = VoxelLodTerrainUpdateData::MESH_NEED_UPDATE;
+				}
+				return true;
+			}
+		});
 	}
+
+	lod.last_viewer_data_block_pos = viewer_block_pos_within_lod;
+	lod.last_view_distance_data_blocks = data_block_region_extent;
+	return true;
 }
 
-static void process_unload_mesh_blocks_sliding_box(VoxelLodTerrainUpdateData::State &state, Vector3 p_viewer_pos,
-		const VoxelLodTerrainUpdateData::Settings &settings) {
-	ZN_PROFILE_SCOPE_NAMED("Sliding box mesh unload");
+static void process_unload_data_blocks_sliding_box(VoxelLodTerrainUpdateData::State &state, VoxelDataLodMap &data,
+		Vector3 p_viewer_pos, std::vector<VoxelLodTerrainUpdateData::BlockToSave> &blocks_to_save, bool can_save,
+		const VoxelLodTerrainUpdateData::Settings &settings, uint32_t volume_id) {
+	ZN_PROFILE_SCOPE_NAMED("Sliding box data unload");
 	// TODO Could it actually be enough to have a rolling update on all blocks?
 
-	// This should be the same distance relatively to each LOD
+	const int lod_count = data.lod_count;
+
+	// Ignore largest lod because it can extend a little beyond due to the view distance setting.
+	// Instead, those blocks are unloaded by the octree forest management.
+	// Iterating from big to small LOD so we can exit earlier if bounds don't intersect.
+	for (int lod_index = lod_count - 2; lod_index >= 0; --lod_index) {
+		if (!process_unload_data_blocks_sliding_box_lod(
+					state, data, p_viewer_pos, blocks_to_save, can_save, settings, lod_index, volume_id)) {
+			// If this box doesn't intersect either now or before, there is no chance a smaller one will
+			break;
+		}
+	}
+}
+
+// Runs the sliding-box mesh unload of one LOD. Returns false when the LOD's box does not intersect
+// the bounds at all (neither now nor before). Bodies of different LODs are independent.
+static bool process_unload_mesh_blocks_sliding_box_lod(VoxelLodTerrainUpdateData::State &state, Vector3 p_viewer_pos,
+		const VoxelLodTerrainUpdateData::Settings &settings, int lod_index) {
+	ZN_PROFILE_SCOPE();
+
 	const int mesh_block_size_po2 = settings.mesh_block_size_po2;
 	const int mesh_block_size = 1 << mesh_block_size_po2;
 	const int mesh_block_region_extent =
 			VoxelServer::get_octree_lod_block_region_extent(settings.lod_distance, mesh_block_size);
 
-	// Ignore largest lod because it can extend a little beyond due to the view distance setting.
-	// Instead, those blocks are unloaded by the octree forest management.
-	// Iterating from big to small LOD so we can exit earlier if bounds don't intersect.
-	for (int lod_index = settings.lod_count - 2; lod_index >= 0; --lod_index) {
-		ZN_PROFILE_SCOPE();
-		VoxelLodTerrainUpdateData::Lod &lod = state.lods[lod_index];
+	VoxelLodTerrainUpdateData::Lod &lod = state.lods[lod_index];
 
-		unsigned int block_size_po2 = mesh_block_size_po2 + lod_index;
-		const Vector3i viewer_block_pos_within_lod = math::floor_to_int(p_viewer_pos) >> block_size_po2;
+	unsigned int block_size_po2 = mesh_block_size_po2 + lod_index;
+	const Vector3i viewer_block_pos_within_lod = math::floor_to_int(p_viewer_pos) >> block_size_po2;
 
-		const Box3i bounds_in_blocks = Box3i( //
-				settings.bounds_in_voxels.pos >> block_size_po2, //
-				settings.bounds_in_voxels.size >> block_size_po2);
+	const Box3i bounds_in_blocks = Box3i( //
+			settings.bounds_in_voxels.pos >> block_size_po2, //
+			settings.bounds_in_voxels.size >> block_size_po2);
 
-		const Box3i new_box =
-				Box3i::from_center_extents(viewer_block_pos_within_lod, Vector3iUtil::create(mesh_block_region_extent));
-		const Box3i prev_box = Box3i::from_center_extents(
-				lod.last_viewer_mesh_block_pos, Vector3iUtil::create(lod.last_view_distance_mesh_blocks));
+	const Box3i new_box =
+			Box3i::from_center_extents(viewer_block_pos_within_lod, Vector3iUtil::create(mesh_block_region_extent));
+	const Box3i prev_box = Box3i::from_center_extents(
+			lod.last_viewer_mesh_block_pos, Vector3iUtil::create(lod.last_view_distance_mesh_blocks));
 
-		if (!new_box.intersects(bounds_in_blocks) && !prev_box.intersects(bounds_in_blocks)) {
-			// If this box doesn't intersect either now or before, there is no chance a smaller one will
-			break;
-		}
+	if (!new_box.intersects(bounds_in_blocks) && !prev_box.intersects(bounds_in_blocks)) {
+		return false;
+	}
 
-		// Eliminate pending blocks that aren't needed
-
-		if (prev_box != new_box) {
-			ZN_PROFILE_SCOPE_NAMED("Unload meshes");
-			RWLockWrite wlock(lod.mesh_map_state.map_lock);
-			prev_box.difference(new_box, [&lod](Box3i out_of_range_box) {
-				out_of_range_box.for_each_cell([&lod](Vector3i pos) {
-					//print_line(String("Immerge {0}").format(varray(pos.to_vec3())));
-					//unload_mesh_block(pos, lod_index);
-					lod.mesh_map_state.map.erase(pos);
-					lod.mesh_blocks_to_unload.push_back(pos);
-				});
-			});
-		}
+	// Eliminate pending blocks that aren't needed
 
-		{
-			ZN_PROFILE_SCOPE_NAMED("Cancel updates");
-			// Cancel block updates that are not within the new region
-			unordered_remove_if(lod.blocks_pending_update, [new_box](Vector3i bpos) { //
-				return !new_box.contains(bpos);
+	if (prev_box != new_box) {
+		ZN_PROFILE_SCOPE_NAMED("Unload meshes");
+		RWLockWrite wlock(lod.mesh_map_state.map_lock);
+		prev_box.difference(new_box, [&lod](Box3i out_of_range_box) {
+			out_of_range_box.for_each_cell([&lod](Vector3i pos) {
+				//print_line(String("Immerge {0}").format(varray(pos.to_vec3())));
+				//unload_mesh_block(pos, lod_index);
+				lod.mesh_map_state.map.erase(pos);
+				lod.mesh_blocks_to_unload.push_back(pos);
 			});
-		}
+		});
+	}
 
-		lod.last_viewer_mesh_block_pos = viewer_block_pos_within_lod;
-		lod.last_view_distance_mesh_blocks = mesh_block_region_extent;
+	{
+		ZN_PROFILE_SCOPE_NAMED("Cancel updates");
+		// Cancel block updates that are not within the new region
+		unordered_remove_if(lod.blocks_pending_update, [new_box](Vector3i bpos) { //
+			return !new_box.contains(bpos);
+		});
+	}
+
+	lod.last_viewer_mesh_block_pos = viewer_block_pos_within_lod;
+	lod.last_view_distance_mesh_blocks = mesh_block_region_extent;
+	return true;
+}
+
+static void process_unload_mesh_blocks_sliding_box(VoxelLodTerrainUpdateData::State &state, Vector3 p_viewer_pos,
+		const VoxelLodTerrainUpdateData::Settings &settings) {
+	ZN_PROFILE_SCOPE_NAMED("Sliding box mesh unload");
+	// TODO Could it actually be enough to have a rolling update on all blocks?
+
+	// Ignore largest lod because it can extend a little beyond due to the view distance setting.
+	// Instead, those blocks are unloaded by the octree forest management.
+	// Iterating from big to small LOD so we can exit earlier if bounds don't intersect.
+	for (int lod_index = settings.lod_count - 2; lod_index >= 0; --lod_index) {
+		if (!process_unload_mesh_blocks_sliding_box_lod(state, p_viewer_pos, settings, lod_index)) {
+			// If this box doesn't intersect either now or before, there is no chance a smaller one will
+			break;
+		}
 	}
 }
 
@@ -540,6 +618,41 @@ inline bool check_block_sizes(int data_block_size, int mesh_block_size) {
 			mesh_block_size >= data_block_size;
 }
 
+// Returns true when every data block covering the padded mesh area is uniform and of the same
+// class, in which case no mesher can produce geometry there and meshing can be skipped entirely.
+// Blocks outside the volume bounds count as air.
+static bool is_uniform_meshless_area(
+		const VoxelDataLodMap::Lod &data_lod, Box3i data_box, Box3i bounds, bool can_skip_uniform_matter) {
+	uint8_t common_class = VoxelDataBlock::UNIFORM_CLASS_UNKNOWN;
+
+	RWLockRead rlock(data_lod.map_lock);
+
+	const bool all_same_class = data_box.all_cells_match([&data_lod, &bounds, &common_class, can_skip_uniform_matter](
+																 Vector3i pos) {
+		uint8_t uniform_class = VoxelDataBlock::UNIFORM_CLASS_AIR;
+		if (bounds.contains(pos)) {
+			const VoxelDataBlock *block = data_lod.map.get_block(pos);
+			if (block == nullptr) {
+				// Only the outline was guaranteed loaded, classify conservatively
+				return false;
+			}
+			uniform_class = block->get_or_compute_uniform_class();
+		}
+		if (uniform_class == VoxelDataBlock::UNIFORM_CLASS_MIXED) {
+			return false;
+		}
+		if (uniform_class == VoxelDataBlock::UNIFORM_CLASS_MATTER && !can_skip_uniform_matter) {
+			return false;
+		}
+		if (common_class == VoxelDataBlock::UNIFORM_CLASS_UNKNOWN) {
+			common_class = uniform_class;
+		}
+		return uniform_class == common_class;
+	});
+
+	return all_same_class && common_class != VoxelDataBlock::UNIFORM_CLASS_UNKNOWN;
+}
+
 bool check_block_mesh_updated(VoxelLodTerrainUpdateData::State &state, VoxelDataLodMap &data,
 		VoxelLodTerrainUpdateData::MeshBlockState &mesh_block, Vector3i mesh_block_pos, uint8_t lod_index,
 		std::vector<VoxelLodTerrainUpdateData::BlockLocation> &blocks_to_load,
@@ -554,7 +667,7 @@ bool check_block_mesh_updated(VoxelLodTerrainUpdateData::State &state, VoxelData
 		case VoxelLodTerrainUpdateData::MESH_NEVER_UPDATED:
 		case VoxelLodTerrainUpdateData::MESH_NEED_UPDATE: {
 			const int mesh_block_size = 1 << settings.mesh_block_size_po2;
-			const int data_block_size = data.lods[0].map.get_block_size();
+			const int data_block_size = data.lods[lod_index].map.get_block_size();
 #ifdef DEBUG_ENABLED
 			ERR_FAIL_COND_V(!check_block_sizes(data_block_size, mesh_block_size), false);
 #endif
@@ -575,13 +688,13 @@ bool check_block_mesh_updated(VoxelLodTerrainUpdateData::State &state, VoxelData
 			bool surrounded = true;
 			if (settings.full_load_mode == false) {
 				const VoxelDataLodMap::Lod &data_lod = data.lods[lod_index];
-				// Check if neighbors are loaded
-				RWLockRead rlock(data_lod.map_lock);
+				// Check if neighbors are loaded.
+				// Uses the sharded index so concurrent update tasks don't serialize on `map_lock`
 				// TODO Optimization: could put in a temp vector and insert in one go after the loop?
 				MutexLock lock(lod.loading_blocks_mutex);
 				for (unsigned int i = 0; i < neighbor_positions_count; ++i) {
 					const Vector3i npos = neighbor_positions[i];
-					if (!data_lod.map.has_block(npos)) {
+					if (!data_lod.map.has_block_shared(npos)) {
 						// That neighbor is not loaded
 						surrounded = false;
 						if (!lod.has_loading_block(npos)) {
@@ -594,6 +707,14 @@ bool check_block_mesh_updated(VoxelLodTerrainUpdateData::State &state, VoxelData
 			}
 
 			if (surrounded) {
+				if (settings.full_load_mode == false &&
+						is_uniform_meshless_area(
+								data.lods[lod_index], data_box, bounds, settings.can_skip_uniform_matter)) {
+					// The whole padded area is uniformly empty or uniformly solid, no mesher would
+					// produce geometry from it, so no task is enqueued at all
+					mesh_block.state = VoxelLodTerrainUpdateData::MESH_UP_TO_DATE;
+					return true;
+				}
 				lod.blocks_pending_update.push_back(mesh_block_pos);
 				mesh_block.state = VoxelLodTerrainUpdateData::MESH_UPDATE_NOT_SENT;
 			}
@@ -645,7 +766,7 @@ static bool check_block_loaded_and_meshed(VoxelLodTerrainUpdateData::State &stat
 	VoxelLodTerrainUpdateData::Lod &lod = state.lods[lod_index];
 
 	const int mesh_block_size = 1 << settings.mesh_block_size_po2;
-	const int data_block_size = data.lods[0].map.get_block_size();
+	const int data_block_size = data.lods[lod_index].map.get_block_size();
 
 #ifdef DEBUG_ENABLED
 	ERR_FAIL_COND_V(!check_block_sizes(data_block_size, mesh_block_size), false);
@@ -808,6 +929,9 @@ static void process_octrees_fitting(VoxelLodTerrainUpdateData::State &state,
 		return;
 	}
 
+	// Last viewer position octree fitting ran with; subtree-skipping below compares both
+	// positions, so octrees verified unchanged at the previous position stay verified
+	const Vector3 previous_viewer_pos = Vector3(state.local_viewer_pos_previous_octree_update);
 	state.local_viewer_pos_previous_octree_update = p_viewer_pos;
 
 	static thread_local FixedArray<std::vector<Vector3i>, constants::MAX_LOD>
@@ -821,6 +945,22 @@ static void process_octrees_fitting(VoxelLodTerrainUpdateData::State &state,
 
 	const float lod_distance_octree_space = settings.lod_distance / octree_leaf_node_size;
 
+	// Speculative scheduling: extrapolate the viewer's motion between fitting runs, so children of
+	// nodes it is heading toward get requested before the split distance is crossed and the swap
+	// doesn't wait on the whole load->mesh chain. Fitting only runs when the viewer moved at least
+	// half a leaf, so the delta below is a meaningful direction. The lookahead is clamped so
+	// teleports don't spray requests across the map.
+	Vector3 speculative_viewer_pos = p_viewer_pos;
+	if (settings.speculative_meshing_enabled) {
+		Vector3 lookahead = (p_viewer_pos - previous_viewer_pos) * 4.f;
+		const float max_lookahead = settings.lod_distance;
+		const float len_sq = lookahead.length_squared();
+		if (len_sq > math::squared(max_lookahead)) {
+			lookahead *= max_lookahead / Math::sqrt(len_sq);
+		}
+		speculative_viewer_pos += lookahead;
+	}
+
 	unsigned int blocked_octree_nodes = 0;
 
 	// TODO Maintain a vector to make iteration faster?
@@ -837,8 +977,14 @@ static void process_octrees_fitting(VoxelLodTerrainUpdateData::State &state,
 			unsigned int blocked_count = 0;
 			float lod_distance_octree_space;
 			Vector3 viewer_pos_octree_space;
+			// Where the viewer is predicted to be soon, for speculative child requests
+			Vector3 speculative_viewer_pos_octree_space;
+			bool speculative_meshing_enabled;
+			// Set when any split or join happened, so steady trees can be detected
+			bool had_any_change = false;
 
 			void create_child(Vector3i node_pos, int lod_index, LodOctree::NodeData &data) {
+				had_any_change = true;
 				VoxelLodTerrainUpdateData::Lod &lod = state.lods[lod_index];
 				const Vector3i bpos = node_pos + (block_offset_lod0 >> lod_index);
 				auto mesh_block_it = lod.mesh_map_state.map.find(bpos);
@@ -856,6 +1002,7 @@ static void process_octrees_fitting(VoxelLodTerrainUpdateData::State &state,
 			}
 
 			void destroy_child(Vector3i node_pos, int lod_index) {
+				had_any_change = true;
 				VoxelLodTerrainUpdateData::Lod &lod = state.lods[lod_index];
 				const Vector3i bpos = node_pos + (block_offset_lod0 >> lod_index);
 				auto mesh_block_it = lod.mesh_map_state.map.find(bpos);
@@ -869,6 +1016,7 @@ static void process_octrees_fitting(VoxelLodTerrainUpdateData::State &state,
 			}
 
 			void show_parent(Vector3i node_pos, int lod_index) {
+				had_any_change = true;
 				VoxelLodTerrainUpdateData::Lod &lod = state.lods[lod_index];
 				Vector3i bpos = node_pos + (block_offset_lod0 >> lod_index);
 				auto mesh_block_it = lod.mesh_map_state.map.find(bpos);
@@ -906,6 +1054,22 @@ static void process_octrees_fitting(VoxelLodTerrainUpdateData::State &state,
 				ZN_PROFILE_SCOPE();
 				if (!LodOctree::is_below_split_distance(
 							node_pos, lod_index, viewer_pos_octree_space, lod_distance_octree_space)) {
+					if (speculative_meshing_enabled &&
+							LodOctree::is_below_split_distance(node_pos, lod_index,
+									speculative_viewer_pos_octree_space, lod_distance_octree_space)) {
+						// The viewer is predicted to cross this node's split distance soon: warm up
+						// its children now. Their task priority comes from viewer distance, so these
+						// requests naturally sort behind anything needed right away. The node does
+						// not split yet and nothing blocks on the result, so this is not counted as
+						// a blocked node.
+						const int child_lod_index = lod_index - 1;
+						const Vector3i offset = block_offset_lod0 >> child_lod_index;
+						for (int i = 0; i < 8; ++i) {
+							const Vector3i child_pos = LodOctree::get_child_position(node_pos, i) + offset;
+							check_block_loaded_and_meshed(
+									state, settings, data, child_pos, child_lod_index, data_blocks_to_load);
+						}
+					}
 					return false;
 				}
 				const int child_lod_index = lod_index - 1;
@@ -973,6 +1137,30 @@ static void process_octrees_fitting(VoxelLodTerrainUpdateData::State &state,
 		const Vector3i block_offset_lod0 = block_pos_maxlod << (settings.lod_count - 1);
 		const Vector3 relative_viewer_pos = p_viewer_pos - Vector3(mesh_block_size * block_offset_lod0);
 
+		VoxelLodTerrainUpdateData::OctreeItem &item = E->value();
+
+		{
+			// Octrees whose last fitting pass did nothing only need a walk again when the viewer
+			// gets close enough for any of their nodes' split spheres to matter. Distant steady
+			// trees (large horizontal worlds have many) skip the whole descent.
+			const unsigned int root_lod_factor = 1 << (settings.lod_count - 1);
+			// Root split distance, plus the root cube's extent covering every descendant's center
+			const float influence_radius = root_lod_factor * (lod_distance_octree_space + 1.f);
+			const Vector3 root_center_octree_space = 0.5f * Vector3(1, 1, 1) * root_lod_factor;
+			const Vector3 rel_prev_viewer_pos =
+					previous_viewer_pos - Vector3(mesh_block_size * block_offset_lod0);
+
+			if (!force_update_octrees && item.no_pending_activity &&
+					(relative_viewer_pos / octree_leaf_node_size).distance_squared_to(root_center_octree_space) >
+							math::squared(influence_radius) &&
+					(rel_prev_viewer_pos / octree_leaf_node_size).distance_squared_to(root_center_octree_space) >
+							math::squared(influence_radius)) {
+				continue;
+			}
+		}
+
+		const Vector3 relative_speculative_viewer_pos =
+				speculative_viewer_pos - Vector3(mesh_block_size * block_offset_lod0);
 		OctreeActions octree_actions{ //
 			state, //
 			settings, //
@@ -981,11 +1169,14 @@ static void process_octrees_fitting(VoxelLodTerrainUpdateData::State &state,
 			block_offset_lod0, //
 			0, //
 			lod_distance_octree_space, //
-			relative_viewer_pos / octree_leaf_node_size
+			relative_viewer_pos / octree_leaf_node_size, //
+			relative_speculative_viewer_pos / octree_leaf_node_size, //
+			settings.speculative_meshing_enabled
 		};
-		VoxelLodTerrainUpdateData::OctreeItem &item = E->value();
 		item.octree.update(octree_actions);
 
+		item.no_pending_activity = !octree_actions.had_any_change && octree_actions.blocked_count == 0;
+
 		blocked_octree_nodes += octree_actions.blocked_count;
 	}
 
@@ -1050,11 +1241,43 @@ static void init_sparse_octree_priority_dependency(PriorityDependency &dep, Vect
 			VoxelServer::get_octree_lod_block_region_extent(octree_lod_distance, data_block_size));
 }
 
+// When the generator supports LOD refinement, fetches a copy-on-write snapshot of the parent
+// block covering `block_pos`, so generation can seed far-from-surface voxels from it. Returns
+// null when there is no parent data or block sizes differ between the two LODs.
+static std::shared_ptr<VoxelBufferInternal> try_get_parent_block_snapshot(
+		const VoxelDataLodMap &data, Vector3i block_pos, int lod, uint8_t &out_octant) {
+	const unsigned int parent_lod = lod + 1;
+	if (parent_lod >= data.lod_count) {
+		return nullptr;
+	}
+	const VoxelDataLodMap::Lod &parent_data_lod = data.lods[parent_lod];
+	if (data.lods[lod].map.get_block_size_pow2() != parent_data_lod.map.get_block_size_pow2()) {
+		// With distant data block sizes the octant mapping doesn't hold
+		return nullptr;
+	}
+	std::shared_ptr<VoxelBufferInternal> snapshot;
+	{
+		RWLockRead rlock(parent_data_lod.map_lock);
+		const VoxelDataBlock *parent_block = parent_data_lod.map.get_block(block_pos >> 1);
+		if (parent_block == nullptr) {
+			return nullptr;
+		}
+		const std::shared_ptr<VoxelBufferInternal> parent_voxels = parent_block->get_voxels_shared();
+		snapshot = make_shared_instance<VoxelBufferInternal>();
+		RWLockRead vlock(parent_voxels->get_lock());
+		// Copy-on-write, only costs a refcount unless the parent gets edited
+		snapshot->copy_shared_from(*parent_voxels, false);
+	}
+	out_octant = (block_pos.x & 1) | ((block_pos.y & 1) << 1) | ((block_pos.z & 1) << 2);
+	return snapshot;
+}
+
 static void request_block_generate(uint32_t volume_id, unsigned int data_block_size,
 		std::shared_ptr<StreamingDependency> &stream_dependency, Vector3i block_pos, int lod,
 		std::shared_ptr<PriorityDependency::ViewersData> &shared_viewers_data, const Transform3D &volume_transform,
 		float lod_distance, std::shared_ptr<AsyncDependencyTracker> tracker, bool allow_drop,
-		BufferedTaskScheduler &task_scheduler) {
+		BufferedTaskScheduler &task_scheduler, std::shared_ptr<VoxelBufferInternal> coarse_voxels = nullptr,
+		uint8_t coarse_octant = 0) {
 	//
 	CRASH_COND(data_block_size > 255);
 	CRASH_COND(stream_dependency == nullptr);
@@ -1062,7 +1285,9 @@ static void request_block_generate(uint32_t volume_id, unsigned int data_block_s
 	// We should not have done this request in the first place if both stream and generator are null
 	ERR_FAIL_COND(stream_dependency->generator.is_null());
 
-	GenerateBlockTask *task = memnew(GenerateBlockTask);
+	GenerateBlockTask *task = GenerateBlockTask::create();
+	task->coarse_voxels = coarse_voxels;
+	task->coarse_octant = coarse_octant;
 	task->volume_id = volume_id;
 	task->position = block_pos;
 	task->lod = lod;
@@ -1080,25 +1305,34 @@ static void request_block_generate(uint32_t volume_id, unsigned int data_block_s
 static void request_block_load(uint32_t volume_id, unsigned int data_block_size,
 		std::shared_ptr<StreamingDependency> &stream_dependency, Vector3i block_pos, int lod, bool request_instances,
 		std::shared_ptr<PriorityDependency::ViewersData> &shared_viewers_data, const Transform3D &volume_transform,
-		float lod_distance, BufferedTaskScheduler &task_scheduler) {
+		float lod_distance, BufferedTaskScheduler &task_scheduler, const VoxelDataLodMap *data) {
 	//
 	CRASH_COND(data_block_size > 255);
 	CRASH_COND(stream_dependency == nullptr);
 
+	// Children loaded on subdivision can seed their far field from the parent block when the
+	// generator supports it, narrowing full evaluation to where detail actually changes
+	std::shared_ptr<VoxelBufferInternal> coarse_voxels;
+	uint8_t coarse_octant = 0;
+	if (data != nullptr && stream_dependency->generator.is_valid() &&
+			stream_dependency->generator->supports_lod_refinement()) {
+		coarse_voxels = try_get_parent_block_snapshot(*data, block_pos, lod, coarse_octant);
+	}
+
 	if (stream_dependency->stream.is_valid()) {
 		PriorityDependency priority_dependency;
 		init_sparse_octree_priority_dependency(priority_dependency, block_pos, lod, data_block_size,
 				shared_viewers_data, volume_transform, lod_distance);
 
-		LoadBlockDataTask *task = memnew(LoadBlockDataTask(
-				volume_id, block_pos, lod, data_block_size, request_instances, stream_dependency, priority_dependency));
+		LoadBlockDataTask *task = LoadBlockDataTask::create(volume_id, block_pos, lod, data_block_size,
+				request_instances, stream_dependency, priority_dependency, coarse_voxels, coarse_octant);
 
 		task_scheduler.push_io_task(task);
 
 	} else {
 		// Directly generate the block without checking the stream.
 		request_block_generate(volume_id, data_block_size, stream_dependency, block_pos, lod, shared_viewers_data,
-				volume_transform, lod_distance, nullptr, true, task_scheduler);
+				volume_transform, lod_distance, nullptr, true, task_scheduler, coarse_voxels, coarse_octant);
 	}
 }
 
@@ -1107,24 +1341,24 @@ static void send_block_data_requests(uint32_t volume_id,
 		std::shared_ptr<StreamingDependency> &stream_dependency,
 		std::shared_ptr<PriorityDependency::ViewersData> &shared_viewers_data, unsigned int data_block_size,
 		bool request_instances, const Transform3D &volume_transform, float lod_distance,
-		BufferedTaskScheduler &task_scheduler) {
+		BufferedTaskScheduler &task_scheduler, const VoxelDataLodMap *data) {
 	//
 	for (unsigned int i = 0; i < blocks_to_load.size(); ++i) {
 		const VoxelLodTerrainUpdateData::BlockLocation loc = blocks_to_load[i];
 		request_block_load(volume_id, data_block_size, stream_dependency, loc.position, loc.lod, request_instances,
-				shared_viewers_data, volume_transform, lod_distance, task_scheduler);
+				shared_viewers_data, volume_transform, lod_distance, task_scheduler, data);
 	}
 }
 
 static void request_voxel_block_save(uint32_t volume_id, std::shared_ptr<VoxelBufferInternal> &voxels,
 		Vector3i block_pos, int lod, std::shared_ptr<StreamingDependency> &stream_dependency,
-		unsigned int data_block_size, BufferedTaskScheduler &task_scheduler) {
+		unsigned int data_block_size, BufferedTaskScheduler &task_scheduler, Span<const Box3i> delta_boxes) {
 	//
 	CRASH_COND(stream_dependency == nullptr);
 	ERR_FAIL_COND(stream_dependency->stream.is_null());
 
-	SaveBlockDataTask *task =
-			memnew(SaveBlockDataTask(volume_id, block_pos, lod, data_block_size, voxels, stream_dependency));
+	SaveBlockDataTask *task = SaveBlockDataTask::create(
+			volume_id, block_pos, lod, data_block_size, voxels, stream_dependency, delta_boxes);
 
 	// No priority data, saving doesnt need sorting
 
@@ -1135,11 +1369,18 @@ void VoxelLodTerrainUpdateTask::send_block_save_requests(uint32_t volume_id,
 		Span<VoxelLodTerrainUpdateData::BlockToSave> blocks_to_save,
 		std::shared_ptr<StreamingDependency> &stream_dependency, unsigned int data_block_size,
 		BufferedTaskScheduler &task_scheduler) {
+	// Hash-map iteration order would scatter writes across region files; ordering by LOD and
+	// space-filling curve makes them stream sequentially (see `sequential_save_order_key`)
+	std::sort(blocks_to_save.data(), blocks_to_save.data() + blocks_to_save.size(),
+			[](const VoxelLodTerrainUpdateData::BlockToSave &a, const VoxelLodTerrainUpdateData::BlockToSave &b) {
+				return sequential_save_order_key(a.position, a.lod) < sequential_save_order_key(b.position, b.lod);
+			});
+
 	for (unsigned int i = 0; i < blocks_to_save.size(); ++i) {
 		VoxelLodTerrainUpdateData::BlockToSave &b = blocks_to_save[i];
 		ZN_PRINT_VERBOSE(format("Requesting save of block {} lod {}", b.position, b.lod));
-		request_voxel_block_save(
-				volume_id, b.voxels, b.position, b.lod, stream_dependency, data_block_size, task_scheduler);
+		request_voxel_block_save(volume_id, b.voxels, b.position, b.lod, stream_dependency, data_block_size,
+				task_scheduler, Span<const Box3i>(b.delta_boxes.data(), b.delta_box_count));
 	}
 }
 
@@ -1154,12 +1395,14 @@ static void request_block_mesh(uint32_t volume_id, const VoxelServer::BlockMeshI
 	ERR_FAIL_COND(data_block_size > 255);
 
 	// We'll allocate this quite often. If it becomes a problem, it should be easy to pool.
-	MeshBlockTask *task = memnew(MeshBlockTask);
+	MeshBlockTask *task = MeshBlockTask::create();
 	task->volume_id = volume_id;
 	task->blocks = input.data_blocks;
 	task->blocks_count = input.data_blocks_count;
 	task->position = input.render_block_position;
 	task->lod = input.lod;
+	task->collision_hint = input.collision_hint;
+	task->transition_sides_mask = input.transition_sides_mask;
 	task->meshing_dependency = meshing_dependency;
 	task->data_block_size = data_block_size;
 	task->data = data;
@@ -1170,6 +1413,115 @@ static void request_block_mesh(uint32_t volume_id, const VoxelServer::BlockMeshI
 	task_scheduler.push_main_task(task);
 }
 
+// Experimental cave culling: breadth-first flood from the viewer's data block across loaded
+// LOD-0 blocks, passing between blocks only where both touching faces have non-solid voxels
+// (face-open bits are cached per block and invalidated on edit). Blocks never reached, nor
+// adjacent to a reached block, can't be seen until something opens a path, so their mesh updates
+// are deferred. Recomputed when the viewer changes block or when loads/edits dirty the graph.
+static void update_occlusion_flood(VoxelLodTerrainUpdateData::State &state, const VoxelDataLodMap &data,
+		const Vector3i viewer_data_block_pos) {
+	ZN_PROFILE_SCOPE();
+	VoxelLodTerrainUpdateData::Lod &lod0 = state.lods[0];
+	std::unordered_set<Vector3i> &reachable = lod0.occlusion_reachable_data_blocks;
+	reachable.clear();
+
+	const VoxelDataLodMap::Lod &data_lod0 = data.lods[0];
+	RWLockRead rlock(data_lod0.map_lock);
+
+	static thread_local std::vector<Vector3i> tls_flood_queue;
+	tls_flood_queue.clear();
+
+	{
+		const VoxelDataBlock *start_block = data_lod0.map.get_block(viewer_data_block_pos);
+		if (start_block == nullptr) {
+			// The viewer's own block isn't loaded; reachability can't be established, leave the
+			// set empty and callers treat the flood as invalid (no suppression)
+			state.occlusion_flood_valid = false;
+			return;
+		}
+		reachable.insert(viewer_data_block_pos);
+		tls_flood_queue.push_back(viewer_data_block_pos);
+	}
+
+	while (tls_flood_queue.size() > 0) {
+		const Vector3i bpos = tls_flood_queue.back();
+		tls_flood_queue.pop_back();
+
+		const VoxelDataBlock *block = data_lod0.map.get_block(bpos);
+		// Visited blocks were checked before being queued
+		CRASH_COND(block == nullptr);
+		const uint8_t openness = block->get_or_compute_face_openness();
+
+		for (unsigned int axis = 0; axis < 3; ++axis) {
+			for (unsigned int side = 0; side < 2; ++side) {
+				if ((openness & (1 << (axis * 2 + side))) == 0) {
+					continue;
+				}
+				Vector3i npos = bpos;
+				npos[axis] += side == 0 ? -1 : 1;
+				if (reachable.find(npos) != reachable.end()) {
+					continue;
+				}
+				const VoxelDataBlock *neighbor = data_lod0.map.get_block(npos);
+				if (neighbor == nullptr) {
+					continue;
+				}
+				// Air passes when the neighbor's opposite face is open too
+				const unsigned int opposite_bit = 1 << (axis * 2 + (side ^ 1));
+				if ((neighbor->get_or_compute_face_openness() & opposite_bit) == 0) {
+					// The neighbor's wall is still visible from this side
+					reachable.insert(npos);
+					continue;
+				}
+				reachable.insert(npos);
+				tls_flood_queue.push_back(npos);
+			}
+		}
+	}
+
+	state.occlusion_flood_valid = true;
+}
+
+// Whether any data block covered by the mesh block was reached by the occlusion flood
+static bool is_mesh_block_occlusion_reachable(
+		const VoxelLodTerrainUpdateData::Lod &lod0, Vector3i mesh_block_pos, int render_to_data_factor) {
+	const Vector3i data_min = mesh_block_pos * render_to_data_factor;
+	Vector3i pos;
+	for (pos.z = 0; pos.z < render_to_data_factor; ++pos.z) {
+		for (pos.y = 0; pos.y < render_to_data_factor; ++pos.y) {
+			for (pos.x = 0; pos.x < render_to_data_factor; ++pos.x) {
+				if (lod0.occlusion_reachable_data_blocks.find(data_min + pos) !=
+						lod0.occlusion_reachable_data_blocks.end()) {
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+// Re-schedules suppressed mesh blocks the latest flood reaches
+static void reschedule_unsuppressed_mesh_blocks(
+		VoxelLodTerrainUpdateData::Lod &lod0, int render_to_data_factor) {
+	for (auto it = lod0.occlusion_suppressed_mesh_blocks.begin();
+			it != lod0.occlusion_suppressed_mesh_blocks.end();) {
+		auto mesh_block_it = lod0.mesh_map_state.map.find(*it);
+		if (mesh_block_it == lod0.mesh_map_state.map.end()) {
+			// The block got unloaded while suppressed
+			it = lod0.occlusion_suppressed_mesh_blocks.erase(it);
+			continue;
+		}
+		if (is_mesh_block_occlusion_reachable(lod0, *it, render_to_data_factor)) {
+			VoxelLodTerrainUpdateData::MeshState expected = VoxelLodTerrainUpdateData::MESH_UP_TO_DATE;
+			mesh_block_it->second.state.compare_exchange_strong(
+					expected, VoxelLodTerrainUpdateData::MESH_NEED_UPDATE);
+			it = lod0.occlusion_suppressed_mesh_blocks.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
 static void send_mesh_requests(uint32_t volume_id, VoxelLodTerrainUpdateData::State &state,
 		const VoxelLodTerrainUpdateData::Settings &settings, const std::shared_ptr<VoxelDataLodMap> &data_ptr,
 		std::shared_ptr<MeshingDependency> meshing_dependency,
@@ -1181,14 +1533,15 @@ static void send_mesh_requests(uint32_t volume_id, VoxelLodTerrainUpdateData::St
 	CRASH_COND(data_ptr == nullptr);
 	const VoxelDataLodMap &data = *data_ptr;
 
-	const int data_block_size = data.lods[0].map.get_block_size();
 	const int mesh_block_size = 1 << settings.mesh_block_size_po2;
-	const int render_to_data_factor = mesh_block_size / mesh_block_size;
 
 	for (unsigned int lod_index = 0; lod_index < settings.lod_count; ++lod_index) {
 		ZN_PROFILE_SCOPE();
 		VoxelLodTerrainUpdateData::Lod &lod = state.lods[lod_index];
 
+		const int data_block_size = data.lods[lod_index].map.get_block_size();
+		const int render_to_data_factor = mesh_block_size / data_block_size;
+
 		for (unsigned int bi = 0; bi < lod.blocks_pending_update.size(); ++bi) {
 			ZN_PROFILE_SCOPE();
 			const Vector3i mesh_block_pos = lod.blocks_pending_update[bi];
@@ -1200,10 +1553,27 @@ static void send_mesh_requests(uint32_t volume_id, VoxelLodTerrainUpdateData::St
 			// All blocks we get here must be in the scheduled state
 			ERR_CONTINUE(mesh_block.state != VoxelLodTerrainUpdateData::MESH_UPDATE_NOT_SENT);
 
+			if (settings.occlusion_culling_enabled && lod_index == 0 && state.occlusion_flood_valid &&
+					!is_mesh_block_occlusion_reachable(lod, mesh_block_pos, render_to_data_factor)) {
+				// Can't be seen until an edit or movement opens a path: pretend it's meshed so the
+				// octree keeps working, and wake it when the flood reaches it
+				mesh_block.state = VoxelLodTerrainUpdateData::MESH_UP_TO_DATE;
+				lod.occlusion_suppressed_mesh_blocks.insert(mesh_block_pos);
+				continue;
+			}
+
 			// Get block and its neighbors
 			VoxelServer::BlockMeshInput mesh_request;
 			mesh_request.render_block_position = mesh_block_pos;
 			mesh_request.lod = lod_index;
+			// Let the worker cook the collision triangle soup too
+			mesh_request.collision_hint = settings.collision_enabled &&
+					(settings.collision_lod_count == 0 || lod_index < settings.collision_lod_count);
+			// Only the transition sides currently displayed get built; if one gets enabled later,
+			// the block is scheduled for remesh (see `apply_mesh_update`). Most blocks never show
+			// transitions, so they skip all six builds.
+			mesh_request.transition_sides_mask = VoxelLodTerrainUpdateTask::get_transition_mask(
+					state, mesh_block_pos, lod_index, settings.lod_count);
 
 			const Box3i data_box =
 					Box3i(render_to_data_factor * mesh_block_pos, Vector3iUtil::create(render_to_data_factor))
@@ -1254,15 +1624,13 @@ static std::shared_ptr<AsyncDependencyTracker> preload_boxes_async(VoxelLodTerra
 
 	std::vector<TaskArguments> todo;
 
-	const unsigned int data_block_size = data.lods[0].map.get_block_size();
-
 	for (unsigned int lod_index = 0; lod_index < settings.lod_count; ++lod_index) {
 		for (unsigned int box_index = 0; box_index < voxel_boxes.size(); ++box_index) {
 			ZN_PROFILE_SCOPE_NAMED("Box");
 
 			VoxelLodTerrainUpdateData::Lod &lod = state.lods[lod_index];
 			const Box3i voxel_box = voxel_boxes[box_index];
-			const Box3i block_box = voxel_box.downscaled(data_block_size << lod_index);
+			const Box3i block_box = voxel_box.downscaled(data.lods[lod_index].map.get_block_size() << lod_index);
 
 			// ZN_PRINT_VERBOSE(String("Preloading box {0} at lod {1}")
 			// 						.format(varray(block_box.to_string(), lod_index)));
@@ -1301,8 +1669,9 @@ static std::shared_ptr<AsyncDependencyTracker> preload_boxes_async(VoxelLodTerra
 
 		for (unsigned int i = 0; i < todo.size(); ++i) {
 			const TaskArguments args = todo[i];
-			request_block_generate(volume_id, data_block_size, stream_dependency, args.block_pos, args.lod_index,
-					shared_viewers_data, volume_transform, settings.lod_distance, tracker, false, task_scheduler);
+			request_block_generate(volume_id, data.lods[args.lod_index].map.get_block_size(), stream_dependency,
+					args.block_pos, args.lod_index, shared_viewers_data, volume_transform, settings.lod_distance,
+					tracker, false, task_scheduler);
 		}
 
 	} else if (next_tasks.size() > 0) {
@@ -1409,14 +1778,93 @@ void VoxelLodTerrainUpdateTask::run(ThreadedTaskContext ctx) {
 
 	profiling_clock.restart();
 	{
-		// Unload data blocks falling out of block region extent
-		if (update_data.settings.full_load_mode == false) {
-			process_unload_data_blocks_sliding_box(
-					state, data, _viewer_pos, data_blocks_to_save, stream.is_valid(), settings);
-		}
+		// With many LODs, the per-LOD bodies of the sliding-box unload passes are what dominates
+		// this task, and they are independent of each other, so they get fanned out over temporary
+		// threads and joined here. Deliberately not the shared task pool: this task already runs on
+		// it, and several volumes doing a fork-join there at once could starve it. Each job gets its
+		// own save list, merged after the join.
+		const unsigned int unload_lod_count = settings.lod_count >= 1 ? settings.lod_count - 1 : 0;
+		if (unload_lod_count >= 8) {
+			ZN_PROFILE_SCOPE_NAMED("Sliding box unload (parallel)");
+
+			struct LodJob {
+				VoxelLodTerrainUpdateData::State *state;
+				VoxelDataLodMap *data;
+				Vector3 viewer_pos;
+				const VoxelLodTerrainUpdateData::Settings *settings;
+				bool process_data_blocks;
+				bool can_save;
+				int lod_index;
+				uint32_t volume_id;
+				std::vector<VoxelLodTerrainUpdateData::BlockToSave> blocks_to_save;
+
+				void run_lod() {
+					if (process_data_blocks) {
+						process_unload_data_blocks_sliding_box_lod(
+								*state, *data, viewer_pos, blocks_to_save, can_save, *settings, lod_index, volume_id);
+					}
+					process_unload_mesh_blocks_sliding_box_lod(*state, viewer_pos, *settings, lod_index);
+				}
+			};
+
+			struct ThreadJob {
+				Span<LodJob> jobs;
 
-		// Unload mesh blocks falling out of block region extent
-		process_unload_mesh_blocks_sliding_box(state, _viewer_pos, settings);
+				static void run(void *p_userdata) {
+					ThreadJob &thread_job = *static_cast<ThreadJob *>(p_userdata);
+					for (unsigned int i = 0; i < thread_job.jobs.size(); ++i) {
+						thread_job.jobs[i].run_lod();
+					}
+				}
+			};
+
+			std::vector<LodJob> lod_jobs(unload_lod_count);
+			for (unsigned int i = 0; i < unload_lod_count; ++i) {
+				LodJob &job = lod_jobs[i];
+				job.state = &state;
+				job.data = &data;
+				job.viewer_pos = _viewer_pos;
+				job.settings = &settings;
+				job.process_data_blocks = settings.full_load_mode == false;
+				job.can_save = stream.is_valid();
+				job.lod_index = i;
+				job.volume_id = _volume_id;
+			}
+
+			const unsigned int thread_count = math::min(unload_lod_count, 8u);
+			std::vector<ThreadJob> thread_jobs(thread_count);
+			for (unsigned int i = 0; i < thread_count; ++i) {
+				const unsigned int begin = (i * unload_lod_count) / thread_count;
+				const unsigned int end = ((i + 1) * unload_lod_count) / thread_count;
+				thread_jobs[i].jobs = Span<LodJob>(lod_jobs.data() + begin, end - begin);
+			}
+
+			std::vector<Thread> threads(thread_count - 1);
+			for (unsigned int i = 1; i < thread_count; ++i) {
+				threads[i - 1].start(&ThreadJob::run, &thread_jobs[i]);
+			}
+			ThreadJob::run(&thread_jobs[0]);
+			for (unsigned int i = 0; i < threads.size(); ++i) {
+				threads[i].wait_to_finish();
+			}
+
+			for (unsigned int i = 0; i < lod_jobs.size(); ++i) {
+				const std::vector<VoxelLodTerrainUpdateData::BlockToSave> &job_blocks_to_save =
+						lod_jobs[i].blocks_to_save;
+				data_blocks_to_save.insert(
+						data_blocks_to_save.end(), job_blocks_to_save.begin(), job_blocks_to_save.end());
+			}
+
+		} else {
+			// Unload data blocks falling out of block region extent
+			if (update_data.settings.full_load_mode == false) {
+				process_unload_data_blocks_sliding_box(
+						state, data, _viewer_pos, data_blocks_to_save, stream.is_valid(), settings, _volume_id);
+			}
+
+			// Unload mesh blocks falling out of block region extent
+			process_unload_mesh_blocks_sliding_box(state, _viewer_pos, settings);
+		}
 
 		// Create and remove octrees in a grid around the viewer.
 		// Mesh blocks drive the loading of voxel data and visuals.
@@ -1424,6 +1872,24 @@ void VoxelLodTerrainUpdateTask::run(ThreadedTaskContext ctx) {
 
 		state.stats.blocked_lods = 0;
 
+		if (settings.occlusion_culling_enabled) {
+			// Recompute reachability when the viewer changed block, data loaded or edits landed,
+			// then wake suppressed blocks the flood now reaches
+			const Vector3i viewer_data_block_pos =
+					math::floor_to_int(_viewer_pos) >> data.lods[0].map.get_block_size_pow2();
+			const bool dirty = state.occlusion_dirty.exchange(false, std::memory_order_acq_rel);
+			if (dirty || viewer_data_block_pos != state.occlusion_last_viewer_data_block ||
+					!state.occlusion_flood_valid) {
+				state.occlusion_last_viewer_data_block = viewer_data_block_pos;
+				update_occlusion_flood(state, data, viewer_data_block_pos);
+				if (state.occlusion_flood_valid) {
+					const int render_to_data_factor =
+							(1 << settings.mesh_block_size_po2) / data.lods[0].map.get_block_size();
+					reschedule_unsuppressed_mesh_blocks(state.lods[0], render_to_data_factor);
+				}
+			}
+		}
+
 		// Find which blocks we need to load and see, within each octree
 		if (stream_enabled) {
 			process_octrees_fitting(state, settings, data, _viewer_pos, data_blocks_to_load);
@@ -1444,7 +1910,7 @@ void VoxelLodTerrainUpdateTask::run(ThreadedTaskContext ctx) {
 			const unsigned int data_block_size = data.lods[0].map.get_block_size();
 			send_block_data_requests(_volume_id, to_span_const(data_blocks_to_load), _streaming_dependency,
 					_shared_viewers_data, data_block_size, _request_instances, _volume_transform, settings.lod_distance,
-					task_scheduler);
+					task_scheduler, &data);
 			send_block_save_requests(
 					_volume_id, to_span(data_blocks_to_save), _streaming_dependency, data_block_size, task_scheduler);
 		}
@@ -1461,6 +1927,39 @@ void VoxelLodTerrainUpdateTask::run(ThreadedTaskContext ctx) {
 
 	state.stats.time_mesh_requests = profiling_clock.restart();
 
+	// Republish per-LOD streaming gauges for lock-free script reads, see `LodStreamingStats`
+	for (unsigned int lod_index = 0; lod_index < settings.lod_count; ++lod_index) {
+		VoxelLodTerrainUpdateData::Lod &lod = state.lods[lod_index];
+		VoxelLodTerrainUpdateData::LodStreamingStats &gauges = state.streaming_stats[lod_index];
+		{
+			MutexLock lock(lod.loading_blocks_mutex);
+			gauges.loading_data_blocks.store(lod.loading_blocks.size(), std::memory_order_relaxed);
+		}
+		uint32_t mesh_count = 0;
+		uint32_t up_to_date_count = 0;
+		uint32_t pending_count = 0;
+		{
+			RWLockRead rlock(lod.mesh_map_state.map_lock);
+			for (auto it = lod.mesh_map_state.map.begin(); it != lod.mesh_map_state.map.end(); ++it) {
+				++mesh_count;
+				switch (it->second.state.load(std::memory_order_relaxed)) {
+					case VoxelLodTerrainUpdateData::MESH_UP_TO_DATE:
+						++up_to_date_count;
+						break;
+					case VoxelLodTerrainUpdateData::MESH_UPDATE_NOT_SENT:
+					case VoxelLodTerrainUpdateData::MESH_UPDATE_SENT:
+						++pending_count;
+						break;
+					default:
+						break;
+				}
+			}
+		}
+		gauges.mesh_blocks.store(mesh_count, std::memory_order_relaxed);
+		gauges.mesh_blocks_up_to_date.store(up_to_date_count, std::memory_order_relaxed);
+		gauges.mesh_blocks_pending_update.store(pending_count, std::memory_order_relaxed);
+	}
+
 	state.stats.time_total = profiling_clock.restart();
 }
 
@@ -27,6 +27,102 @@ VoxelMeshBlockVLT::VoxelMeshBlockVLT(const Vector3i bpos, unsigned int size, uns
 #endif
 }
 
+// Finds the byte range that differs between two buffers of equal size. Returns false when equal.
+static bool find_diff_range(const uint8_t *a, const uint8_t *b, size_t size, size_t &out_begin, size_t &out_end) {
+	size_t begin = 0;
+	while (begin < size && a[begin] == b[begin]) {
+		++begin;
+	}
+	if (begin == size) {
+		return false;
+	}
+	size_t end = size;
+	while (end > begin && a[end - 1] == b[end - 1]) {
+		--end;
+	}
+	out_begin = begin;
+	out_end = end;
+	return true;
+}
+
+bool VoxelMeshBlockVLT::try_patch_surface(const RenderingServer::SurfaceData &surface) {
+	ZN_PROFILE_SCOPE();
+
+	if (!_has_last_surface_data || !_mesh_instance.is_valid()) {
+		return false;
+	}
+	Ref<Mesh> mesh = _mesh_instance.get_mesh();
+	if (mesh.is_null()) {
+		return false;
+	}
+
+	const RenderingServer::SurfaceData &prev = _last_surface_data;
+
+	// Patching requires the exact same layout; any topology change means a full rebuild
+	if (prev.format != surface.format || prev.vertex_count != surface.vertex_count ||
+			prev.index_count != surface.index_count || prev.vertex_data.size() != surface.vertex_data.size() ||
+			prev.attribute_data.size() != surface.attribute_data.size() ||
+			prev.index_data.size() != surface.index_data.size()) {
+		return false;
+	}
+	if (prev.index_data != surface.index_data) {
+		return false;
+	}
+	// Region updates don't refresh the surface's AABB, so vertices may only move within it
+	if (!prev.aabb.encloses(surface.aabb)) {
+		return false;
+	}
+
+	if (mesh->get_surface_count() != 1) {
+		return false;
+	}
+
+	// Compute both diffs before touching the GPU, so bailing out can't leave a half-patched mesh
+	size_t vertex_begin = 0;
+	size_t vertex_end = 0;
+	const bool vertex_changed = surface.vertex_data.size() > 0 &&
+			find_diff_range(prev.vertex_data.ptr(), surface.vertex_data.ptr(), surface.vertex_data.size(),
+					vertex_begin, vertex_end);
+	// More than half the buffer changed: uploading it through a region update would not be much
+	// cheaper than a rebuild, and a rebuild also refreshes the AABB
+	if (vertex_changed && vertex_end - vertex_begin > size_t(surface.vertex_data.size()) / 2) {
+		return false;
+	}
+	size_t attribute_begin = 0;
+	size_t attribute_end = 0;
+	const bool attribute_changed = surface.attribute_data.size() > 0 &&
+			find_diff_range(prev.attribute_data.ptr(), surface.attribute_data.ptr(), surface.attribute_data.size(),
+					attribute_begin, attribute_end);
+
+	RenderingServer &rs = *RenderingServer::get_singleton();
+	const RID mesh_rid = mesh->get_rid();
+
+	Vector<uint8_t> region;
+	if (vertex_changed) {
+		region.resize(vertex_end - vertex_begin);
+		memcpy(region.ptrw(), surface.vertex_data.ptr() + vertex_begin, region.size());
+		rs.mesh_surface_update_vertex_region(mesh_rid, 0, vertex_begin, region);
+	}
+	if (attribute_changed) {
+		region.resize(attribute_end - attribute_begin);
+		memcpy(region.ptrw(), surface.attribute_data.ptr() + attribute_begin, region.size());
+		rs.mesh_surface_update_attribute_region(mesh_rid, 0, attribute_begin, region);
+	}
+
+	_last_surface_data = surface;
+	return true;
+}
+
+void VoxelMeshBlockVLT::store_surface_data(const RenderingServer::SurfaceData &surface) {
+	_last_surface_data = surface;
+	_has_last_surface_data = true;
+}
+
+void VoxelMeshBlockVLT::clear_stored_surface_data() {
+	_last_surface_data = RenderingServer::SurfaceData();
+	_has_last_surface_data = false;
+}
+
 VoxelMeshBlockVLT::~VoxelMeshBlockVLT() {
 	for (unsigned int i = 0; i < _transition_mesh_instances.size(); ++i) {
 		FreeMeshTask::try_add_and_destroy(_transition_mesh_instances[i]);
@@ -2,6 +2,7 @@
 #define VOXEL_MESH_BLOCK_VLT_H
 
 #include "../voxel_mesh_block.h"
+#include <servers/rendering_server.h>
 
 namespace zylann::voxel {
 
@@ -26,6 +27,9 @@ public:
 	// because blocks can use a cross-fade effect. Overlapping blocks of the same LOD group can be visible at once.
 	// Hence the need to use this boolean.
 	bool active = false;
+	// Which transition sides have built meshes. Sides enabled in the transition mask but not built
+	// yet get the block scheduled for remesh.
+	uint8_t built_transition_sides = 0xff;
 
 	bool got_first_mesh_update = false;
 
@@ -43,6 +47,17 @@ public:
 
 	void set_mesh(Ref<Mesh> mesh, DirectMeshInstance::GIMode gi_mode);
 
+	// Differential GPU upload: when an edit remeshes this block without changing topology (same
+	// counts and index buffer, a common case while sculpting with smooth brushes), the changed
+	// vertex region is patched into the existing GPU buffers instead of re-uploading a whole new
+	// mesh. Returns false when a full rebuild is needed. Requires a previously stored surface,
+	// see `store_surface_data`.
+	bool try_patch_surface(const RenderingServer::SurfaceData &surface);
+	// Keeps a copy of the last applied packed surface so the next update can be diffed against it.
+	// Only worth it for single-surface blocks that are likely to be remeshed by edits (LOD 0).
+	void store_surface_data(const RenderingServer::SurfaceData &surface);
+	void clear_stored_surface_data();
+
 	void set_transition_mask(uint8_t m);
 	inline uint8_t get_transition_mask() const {
 		return _transition_mask;
@@ -83,6 +98,11 @@ private:
 
 	uint8_t _transition_mask = 0;
 
+	// See `store_surface_data`. Buffers are copy-on-write so storing them does not duplicate
+	// memory until the next update is produced.
+	RenderingServer::SurfaceData _last_surface_data;
+	bool _has_last_surface_data = false;
+
 #ifdef VOXEL_DEBUG_LOD_MATERIALS
 	Ref<Material> _debug_material;
 	Ref<Material> _debug_transition_material;
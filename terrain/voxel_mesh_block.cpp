@@ -18,6 +18,24 @@ VoxelMeshBlock::~VoxelMeshBlock() {
 	FreeMeshTask::try_add_and_destroy(_mesh_instance);
 }
 
+void VoxelMeshBlock::make_dormant() {
+	if (_mesh_instance.is_valid()) {
+		Ref<Mesh> mesh = _mesh_instance.get_mesh();
+		if (mesh.is_valid()) {
+			// The mesh itself is freed progressively like regular destruction
+			FreeMeshTask::add(mesh);
+			_mesh_instance.set_mesh(Ref<Mesh>());
+		}
+		// Detached from the world but kept allocated
+		set_mesh_instance_visible(_mesh_instance, false);
+	}
+	drop_collision();
+	_world.unref();
+	// Back to the state a freshly constructed block has
+	_visible = false;
+	_parent_visible = true;
+}
+
 void VoxelMeshBlock::set_world(Ref<World3D> p_world) {
 	if (_world != p_world) {
 		_world = p_world;
@@ -135,28 +153,32 @@ void VoxelMeshBlock::set_collision_mesh(
 		return;
 	}
 
-	ERR_FAIL_COND(node == nullptr);
-	ERR_FAIL_COND_MSG(node->get_world_3d() != _world, "Physics body and attached node must be from the same world");
-
 	Ref<Shape3D> shape = create_concave_polygon_shape(surface_arrays);
+	set_collision_shape(shape, debug_collision, node, margin);
+}
+
+void VoxelMeshBlock::set_collision_shape(Ref<Shape3D> shape, bool debug_collision, Node3D *node, float margin) {
 	if (shape.is_null()) {
 		drop_collision();
 		return;
 	}
 
+	ERR_FAIL_COND(node == nullptr);
+	ERR_FAIL_COND_MSG(node->get_world_3d() != _world, "Physics body and attached node must be from the same world");
+
 	if (!_static_body.is_valid()) {
 		_static_body.create();
 		_static_body.set_world(*_world);
 		// This allows collision signals to provide the terrain node in the `collider` field
 		_static_body.set_attached_object(node);
-
-	} else {
-		_static_body.remove_shape(0);
 	}
 
 	shape->set_margin(margin);
 
-	_static_body.add_shape(shape);
+	// The shape was built and populated before reaching the physics server; updates swap the
+	// shape RID in one call instead of a remove+add pair, and the old shape is freed off the
+	// swap window (see `DirectStaticBody::set_shape`)
+	_static_body.set_shape(shape);
 	_static_body.set_debug(debug_collision, *_world);
 	_static_body.set_shape_enabled(0, _visible);
 }
@@ -44,6 +44,9 @@ public:
 	// Collisions
 
 	void set_collision_mesh(Span<const Array> surface_arrays, bool debug_collision, Node3D *node, float margin);
+	// Variant taking a ready-made shape, so the expensive construction (see
+	// `build_collision_shape_faces`) can happen off the main thread. A null shape drops collision.
+	void set_collision_shape(Ref<Shape3D> shape, bool debug_collision, Node3D *node, float margin);
 	void set_collision_layer(int layer);
 	void set_collision_mask(int mask);
 	void set_collision_margin(float margin);
@@ -58,6 +61,13 @@ public:
 	void set_parent_visible(bool parent_visible);
 	void set_parent_transform(const Transform3D &parent_transform);
 
+	// Recycling
+
+	// Releases the mesh (deferred, like destruction does) and the collider, but keeps the
+	// RenderingServer mesh instance allocated and the block itself alive, so it can be reassigned
+	// to another position without paying RID churn. See `VoxelMeshMap`.
+	void make_dormant();
+
 protected:
 	void _set_visible(bool visible);
 
@@ -37,11 +37,41 @@ public:
 			MeshBlock_T *block = _blocks[i];
 			ERR_FAIL_COND(block == nullptr);
 			pre_delete(*block);
-			queue_free_mesh_block(block);
+			if (_block_recycling_enabled && _dormant_blocks.size() < MAX_DORMANT_BLOCKS) {
+				block->make_dormant();
+				_dormant_blocks.push_back(block);
+			} else {
+				queue_free_mesh_block(block);
+			}
 			remove_block_internal(it, i);
 		}
 	}
 
+	// When enabled, a bounded set of removed blocks is kept dormant with their RenderingServer
+	// instances still allocated, and handed back by `try_acquire_recycled_block`. This avoids RID
+	// churn when viewers move fast, which is a measurable main-thread cost.
+	void set_block_recycling_enabled(bool enabled) {
+		_block_recycling_enabled = enabled;
+		if (!enabled) {
+			for (unsigned int i = 0; i < _dormant_blocks.size(); ++i) {
+				queue_free_mesh_block(_dormant_blocks[i]);
+			}
+			_dormant_blocks.clear();
+		}
+	}
+
+	// Returns a dormant block whose RenderingServer resources are already allocated, or null when
+	// the pool is empty. The caller must re-initialize it (position and state) before passing it
+	// to `set_block`.
+	MeshBlock_T *try_acquire_recycled_block() {
+		if (_dormant_blocks.size() == 0) {
+			return nullptr;
+		}
+		MeshBlock_T *block = _dormant_blocks.back();
+		_dormant_blocks.pop_back();
+		return block;
+	}
+
 	MeshBlock_T *get_block(Vector3i bpos) {
 		if (_last_accessed_block && _last_accessed_block->position == bpos) {
 			return _last_accessed_block;
@@ -110,6 +140,11 @@ public:
 		_blocks.clear();
 		_blocks_map.clear();
 		_last_accessed_block = nullptr;
+
+		for (auto it = _dormant_blocks.begin(); it != _dormant_blocks.end(); ++it) {
+			memdelete(*it);
+		}
+		_dormant_blocks.clear();
 	}
 
 	unsigned int get_block_count() const {
@@ -177,7 +212,9 @@ private:
 		ERR_FAIL_COND(block == nullptr);
 		FreeMeshBlockTask *task = memnew(FreeMeshBlockTask);
 		task->block = block;
-		VoxelServer::get_singleton().push_main_thread_time_spread_task(task);
+		// Cleanup is never urgent, visible work goes first
+		VoxelServer::get_singleton().push_main_thread_time_spread_task(
+				task, zylann::TimeSpreadTaskRunner::PRIORITY_LOW);
 	}
 
 private:
@@ -189,6 +226,11 @@ private:
 	// Voxel access will most frequently be in contiguous areas, so the same blocks are accessed.
 	// To prevent too much hashing, this reference is checked before.
 	mutable MeshBlock_T *_last_accessed_block;
+
+	// Bounded pool of dormant blocks, see `set_block_recycling_enabled`
+	static const unsigned int MAX_DORMANT_BLOCKS = 64;
+	std::vector<MeshBlock_T *> _dormant_blocks;
+	bool _block_recycling_enabled = false;
 };
 
 } // namespace zylann::voxel
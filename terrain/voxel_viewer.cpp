@@ -19,6 +19,17 @@ unsigned int VoxelViewer::get_view_distance() const {
 	return _view_distance;
 }
 
+void VoxelViewer::set_collision_distance(unsigned int distance) {
+	_collision_distance = distance;
+	if (is_active()) {
+		VoxelServer::get_singleton().set_viewer_collision_distance(_viewer_id, distance);
+	}
+}
+
+unsigned int VoxelViewer::get_collision_distance() const {
+	return _collision_distance;
+}
+
 void VoxelViewer::set_requires_visuals(bool enabled) {
 	_requires_visuals = enabled;
 	if (is_active()) {
@@ -71,11 +82,15 @@ void VoxelViewer::_notification(int p_what) {
 				VoxelServer::get_singleton().set_viewer_distance(_viewer_id, _view_distance);
 				VoxelServer::get_singleton().set_viewer_requires_visuals(_viewer_id, _requires_visuals);
 				VoxelServer::get_singleton().set_viewer_requires_collisions(_viewer_id, _requires_collisions);
+				VoxelServer::get_singleton().set_viewer_collision_distance(_viewer_id, _collision_distance);
 				VoxelServer::get_singleton().set_viewer_requires_data_block_notifications(
 						_viewer_id, _requires_data_block_notifications);
 				VoxelServer::get_singleton().set_viewer_network_peer_id(_viewer_id, _network_peer_id);
-				const Vector3 pos = get_global_transform().origin;
-				VoxelServer::get_singleton().set_viewer_position(_viewer_id, pos);
+				const Transform3D transform = get_global_transform();
+				VoxelServer::get_singleton().set_viewer_position(_viewer_id, transform.origin);
+				// Forward axis, like cameras
+				VoxelServer::get_singleton().set_viewer_direction(
+						_viewer_id, -transform.basis.get_column(Vector3::AXIS_Z).normalized());
 			}
 		} break;
 
@@ -87,8 +102,10 @@ void VoxelViewer::_notification(int p_what) {
 
 		case NOTIFICATION_TRANSFORM_CHANGED:
 			if (is_active()) {
-				const Vector3 pos = get_global_transform().origin;
-				VoxelServer::get_singleton().set_viewer_position(_viewer_id, pos);
+				const Transform3D transform = get_global_transform();
+				VoxelServer::get_singleton().set_viewer_position(_viewer_id, transform.origin);
+				VoxelServer::get_singleton().set_viewer_direction(
+						_viewer_id, -transform.basis.get_column(Vector3::AXIS_Z).normalized());
 			}
 			break;
 
@@ -105,6 +122,9 @@ void VoxelViewer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_view_distance", "distance"), &VoxelViewer::set_view_distance);
 	ClassDB::bind_method(D_METHOD("get_view_distance"), &VoxelViewer::get_view_distance);
 
+	ClassDB::bind_method(D_METHOD("set_collision_distance", "distance"), &VoxelViewer::set_collision_distance);
+	ClassDB::bind_method(D_METHOD("get_collision_distance"), &VoxelViewer::get_collision_distance);
+
 	ClassDB::bind_method(D_METHOD("set_requires_visuals", "enabled"), &VoxelViewer::set_requires_visuals);
 	ClassDB::bind_method(D_METHOD("is_requiring_visuals"), &VoxelViewer::is_requiring_visuals);
 
@@ -120,6 +140,7 @@ void VoxelViewer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_network_peer_id"), &VoxelViewer::get_network_peer_id);
 
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "view_distance"), "set_view_distance", "get_view_distance");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "collision_distance"), "set_collision_distance", "get_collision_distance");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "requires_visuals"), "set_requires_visuals", "is_requiring_visuals");
 	ADD_PROPERTY(
 			PropertyInfo(Variant::BOOL, "requires_collisions"), "set_requires_collisions", "is_requiring_collisions");
@@ -15,7 +15,11 @@ public:
 	// Distance in world space units
 	void set_view_distance(unsigned int distance);
 	unsigned int get_view_distance() const;
-	// TODO Collision distance
+
+	// Distance beyond which terrain doesn't need collisions for this viewer.
+	// 0 means collisions follow the view distance.
+	void set_collision_distance(unsigned int distance);
+	unsigned int get_collision_distance() const;
 
 	void set_requires_visuals(bool enabled);
 	bool is_requiring_visuals() const;
@@ -40,6 +44,7 @@ private:
 
 	uint32_t _viewer_id = 0;
 	unsigned int _view_distance = 128;
+	unsigned int _collision_distance = 0;
 	bool _requires_visuals = true;
 	bool _requires_collisions = true;
 	bool _requires_data_block_notifications = false;
@@ -1,12 +1,16 @@
 #include "tests.h"
+#include "../edition/mesh_sdf.h"
 #include "../edition/voxel_tool_terrain.h"
+#include "../generators/graph/image_range_grid.h"
 #include "../generators/graph/range_utility.h"
 #include "../generators/graph/voxel_generator_graph.h"
 #include "../meshers/blocky/voxel_blocky_library.h"
 #include "../meshers/cubes/voxel_mesher_cubes.h"
+#include "../storage/bulk_ops.h"
 #include "../storage/voxel_buffer_gd.h"
 #include "../storage/voxel_data_map.h"
 #include "../storage/voxel_metadata_variant.h"
+#include "../streams/compressed_data.h"
 #include "../streams/instance_data.h"
 #include "../streams/region/region_file.h"
 #include "../streams/region/voxel_stream_region_files.h"
@@ -20,6 +24,7 @@
 #include "../util/math/box3i.h"
 #include "../util/noise/fast_noise_lite/fast_noise_lite.h"
 #include "../util/string_funcs.h"
+#include "../util/struct_db.h"
 #include "test_octree.h"
 #include "testing.h"
 
@@ -28,6 +33,7 @@
 #endif
 
 #include <core/io/dir_access.h>
+#include <core/io/image.h>
 #include <core/io/stream_peer.h>
 #include <core/string/print_string.h>
 #include <core/templates/hash_map.h>
@@ -451,6 +457,47 @@ void test_voxel_graph_generator_expressions() {
 	ZYLANN_TEST_ASSERT(zfnl->reference_get_count() == 1);
 }
 
+void test_voxel_graph_chain_fusion() {
+	// A chain of native arithmetic nodes fuses into one operation on non-debug compiles; the
+	// result must match what the per-node interpretation produces
+	Ref<VoxelGeneratorGraph> generator;
+	generator.instantiate();
+
+	const uint32_t in_x = generator->create_node(VoxelGeneratorGraph::NODE_INPUT_X, Vector2(0, 0));
+	const uint32_t in_y = generator->create_node(VoxelGeneratorGraph::NODE_INPUT_Y, Vector2(0, 0));
+	const uint32_t out_sdf = generator->create_node(VoxelGeneratorGraph::NODE_OUTPUT_SDF, Vector2(0, 0));
+	const uint32_t n_mul = generator->create_node(VoxelGeneratorGraph::NODE_MULTIPLY, Vector2());
+	const uint32_t n_add = generator->create_node(VoxelGeneratorGraph::NODE_ADD, Vector2());
+	const uint32_t n_abs = generator->create_node(VoxelGeneratorGraph::NODE_ABS, Vector2());
+
+	// abs(x * 0.25 + y)
+	generator->set_node_default_input(n_mul, 1, 0.25f);
+	generator->add_connection(in_x, 0, n_mul, 0);
+	generator->add_connection(n_mul, 0, n_add, 0);
+	generator->add_connection(in_y, 0, n_add, 1);
+	generator->add_connection(n_add, 0, n_abs, 0);
+	generator->add_connection(n_abs, 0, out_sdf, 0);
+
+	const Vector3i sample_pos(10, -6, 3);
+	const float expected = Math::abs(10.f * 0.25f + -6.f);
+
+	{
+		// Debug compile keeps one operation per node
+		VoxelGraphRuntime::CompilationResult result = generator->compile(true);
+		ZYLANN_TEST_ASSERT_MSG(result.success,
+				String("Failed to compile graph: {0}: {1}").format(varray(result.node_id, result.message)));
+		const float sd = generator->generate_single(sample_pos, VoxelBufferInternal::CHANNEL_SDF).f;
+		ZYLANN_TEST_ASSERT(Math::is_equal_approx(sd, expected));
+	}
+	{
+		VoxelGraphRuntime::CompilationResult result = generator->compile(false);
+		ZYLANN_TEST_ASSERT_MSG(result.success,
+				String("Failed to compile graph: {0}: {1}").format(varray(result.node_id, result.message)));
+		const float sd = generator->generate_single(sample_pos, VoxelBufferInternal::CHANNEL_SDF).f;
+		ZYLANN_TEST_ASSERT(Math::is_equal_approx(sd, expected));
+	}
+}
+
 void test_voxel_graph_generator_texturing() {
 	Ref<VoxelGeneratorGraph> generator;
 	generator.instantiate();
@@ -830,6 +877,19 @@ void test_instance_data_serialization() {
 			layer.instances.push_back(L::create_instance(0, 1, 20, -1, 0, 2.14, 4));
 			src_data.layers.push_back(layer);
 		}
+		{
+			// Delta layer, saved as generator output minus removals
+			InstanceBlockData::LayerData layer;
+			layer.id = 3;
+			layer.scale_min = 1.f;
+			layer.scale_max = 1.f;
+			layer.is_delta = true;
+			layer.generated_count = 1000;
+			layer.removed_indices.push_back(4);
+			layer.removed_indices.push_back(42);
+			layer.removed_indices.push_back(999);
+			src_data.layers.push_back(layer);
+		}
 	}
 
 	std::vector<uint8_t> serialized_data;
@@ -859,6 +919,13 @@ void test_instance_data_serialization() {
 			ZYLANN_TEST_ASSERT(src_layer.scale_min == dst_layer.scale_min);
 			ZYLANN_TEST_ASSERT(src_layer.scale_max == dst_layer.scale_max);
 		}
+		ZYLANN_TEST_ASSERT(src_layer.is_delta == dst_layer.is_delta);
+		if (src_layer.is_delta) {
+			ZYLANN_TEST_ASSERT(src_layer.generated_count == dst_layer.generated_count);
+			ZYLANN_TEST_ASSERT(src_layer.removed_indices == dst_layer.removed_indices);
+			continue;
+		}
+
 		ZYLANN_TEST_ASSERT(src_layer.instances.size() == dst_layer.instances.size());
 
 		const float scale_error = math::max(src_layer.scale_max - src_layer.scale_min,
@@ -1131,6 +1198,114 @@ void test_voxel_buffer_create() {
 	generated_voxels.create(Vector3i(1, 16, 18));
 }
 
+void test_struct_db() {
+	StructDB<int> db;
+
+	const uint32_t id_a = db.create(10);
+	const uint32_t id_b = db.create(20);
+	const uint32_t id_c = db.create(30);
+	ZYLANN_TEST_ASSERT(db.count() == 3);
+	ZYLANN_TEST_ASSERT(db.get(id_a) == 10);
+	ZYLANN_TEST_ASSERT(db.get(id_b) == 20);
+	ZYLANN_TEST_ASSERT(db.get(id_c) == 30);
+
+	// Swap-removal must not break other IDs
+	db.destroy(id_b);
+	ZYLANN_TEST_ASSERT(db.count() == 2);
+	ZYLANN_TEST_ASSERT(!db.is_valid(id_b));
+	ZYLANN_TEST_ASSERT(db.get(id_a) == 10);
+	ZYLANN_TEST_ASSERT(db.get(id_c) == 30);
+	ZYLANN_TEST_ASSERT(db.try_get(id_b) == nullptr);
+
+	// Recycled index must produce a different ID
+	const uint32_t id_d = db.create(40);
+	ZYLANN_TEST_ASSERT(id_d != id_b);
+	ZYLANN_TEST_ASSERT(db.get(id_d) == 40);
+	ZYLANN_TEST_ASSERT(!db.is_valid(id_b));
+
+	// Iteration only visits live entries, and IDs round-trip
+	int sum = 0;
+	unsigned int visited = 0;
+	db.for_each_with_id([&sum, &visited, &db](int value, uint32_t id) {
+		sum += value;
+		++visited;
+		ZYLANN_TEST_ASSERT(db.get(id) == value);
+	});
+	ZYLANN_TEST_ASSERT(visited == 3);
+	ZYLANN_TEST_ASSERT(sum == 10 + 30 + 40);
+
+	db.destroy(id_a);
+	db.destroy(id_c);
+	db.destroy(id_d);
+	ZYLANN_TEST_ASSERT(db.count() == 0);
+}
+
+void test_voxel_buffer_convert_channel_depth() {
+	VoxelBufferInternal vb;
+	vb.create(Vector3i(8, 8, 8));
+	// Normalized conversion keeps SDF values within quantization error
+	vb.set_voxel_f(0.25f, Vector3i(1, 2, 3), VoxelBufferInternal::CHANNEL_SDF);
+	vb.convert_channel_depth(VoxelBufferInternal::CHANNEL_SDF, VoxelBufferInternal::DEPTH_8_BIT, true);
+	ZYLANN_TEST_ASSERT(vb.get_channel_depth(VoxelBufferInternal::CHANNEL_SDF) == VoxelBufferInternal::DEPTH_8_BIT);
+	const float sd = vb.get_voxel_f(1, 2, 3, VoxelBufferInternal::CHANNEL_SDF);
+	ZYLANN_TEST_ASSERT(Math::abs(sd - 0.25f) < 0.02f);
+
+	// Raw conversion keeps integer ids
+	vb.set_voxel(42, Vector3i(4, 5, 6), VoxelBufferInternal::CHANNEL_TYPE);
+	vb.convert_channel_depth(VoxelBufferInternal::CHANNEL_TYPE, VoxelBufferInternal::DEPTH_8_BIT, false);
+	ZYLANN_TEST_ASSERT(vb.get_voxel(Vector3i(4, 5, 6), VoxelBufferInternal::CHANNEL_TYPE) == 42);
+	// Uniform channels convert without materializing
+	vb.fill(7, VoxelBufferInternal::CHANNEL_INDICES);
+	vb.convert_channel_depth(VoxelBufferInternal::CHANNEL_INDICES, VoxelBufferInternal::DEPTH_32_BIT, false);
+	ZYLANN_TEST_ASSERT(vb.get_voxel(Vector3i(0, 0, 0), VoxelBufferInternal::CHANNEL_INDICES) == 7);
+}
+
+namespace {
+// Trivial store-raw codec for registry testing
+bool test_codec_compress(Span<const uint8_t> src, std::vector<uint8_t> &dst) {
+	dst.resize(src.size());
+	memcpy(dst.data(), src.data(), src.size());
+	return true;
+}
+bool test_codec_decompress(Span<const uint8_t> src, std::vector<uint8_t> &dst) {
+	dst.resize(src.size());
+	memcpy(dst.data(), src.data(), src.size());
+	return true;
+}
+} // namespace
+
+void test_compressed_data_codec_registry() {
+	const uint8_t codec_id = CompressedData::CUSTOM_CODEC_ID_BEGIN;
+	CompressedData::CodecFuncs funcs;
+	funcs.compress_func = test_codec_compress;
+	funcs.decompress_func = test_codec_decompress;
+	ZYLANN_TEST_ASSERT(CompressedData::register_codec(codec_id, funcs));
+	ZYLANN_TEST_ASSERT(CompressedData::set_preferred_codec(codec_id));
+
+	// Saves route through the preferred codec, loads recognize its id
+	std::vector<uint8_t> src;
+	for (unsigned int i = 0; i < 300; ++i) {
+		src.push_back(uint8_t(i * 7));
+	}
+	std::vector<uint8_t> compressed;
+	ZYLANN_TEST_ASSERT(
+			CompressedData::compress(to_span_const(src), compressed, CompressedData::COMPRESSION_LZ4));
+	ZYLANN_TEST_ASSERT(compressed.size() > 0 && compressed[0] == codec_id);
+	std::vector<uint8_t> decompressed;
+	ZYLANN_TEST_ASSERT(CompressedData::decompress(to_span_const(compressed), decompressed));
+	ZYLANN_TEST_ASSERT(decompressed == src);
+
+	// Built-in payloads keep reading while a custom codec is preferred
+	ZYLANN_TEST_ASSERT(CompressedData::set_preferred_codec(0));
+	std::vector<uint8_t> builtin_compressed;
+	ZYLANN_TEST_ASSERT(CompressedData::compress(
+			to_span_const(src), builtin_compressed, CompressedData::COMPRESSION_LZ4));
+	ZYLANN_TEST_ASSERT(builtin_compressed.size() > 0 && builtin_compressed[0] == CompressedData::COMPRESSION_LZ4);
+	std::vector<uint8_t> builtin_decompressed;
+	ZYLANN_TEST_ASSERT(CompressedData::decompress(to_span_const(builtin_compressed), builtin_decompressed));
+	ZYLANN_TEST_ASSERT(builtin_decompressed == src);
+}
+
 void test_block_serializer() {
 	// Create an example buffer
 	const Vector3i block_size(8, 9, 10);
@@ -1171,6 +1346,178 @@ void test_block_serializer() {
 		// Must be equal
 		ZYLANN_TEST_ASSERT(voxel_buffer.equals(deserialized_voxel_buffer));
 	}
+	{
+		// Serialize a buffer with a single dense channel, which goes through the segmented zero-copy path
+		VoxelBufferInternal single_channel_buffer;
+		single_channel_buffer.create(block_size);
+		single_channel_buffer.fill_area(45, Vector3i(1, 2, 3), Vector3i(5, 5, 5), 0);
+
+		BlockSerializer::SerializeResult result = BlockSerializer::serialize_and_compress(single_channel_buffer);
+		ZYLANN_TEST_ASSERT(result.success);
+		std::vector<uint8_t> data = result.data;
+
+		ZYLANN_TEST_ASSERT(data.size() > 0);
+
+		VoxelBufferInternal deserialized_voxel_buffer;
+		ZYLANN_TEST_ASSERT(BlockSerializer::decompress_and_deserialize(to_span_const(data), deserialized_voxel_buffer));
+
+		ZYLANN_TEST_ASSERT(single_channel_buffer.equals(deserialized_voxel_buffer));
+	}
+}
+
+void test_block_serializer_uniform() {
+	// Fully-uniform blocks take a compact value-only record through the compressed entry points
+	VoxelBufferInternal voxel_buffer;
+	voxel_buffer.create(Vector3i(16, 16, 16));
+	voxel_buffer.fill(42, 0);
+	voxel_buffer.fill(7, 1);
+
+	BlockSerializer::SerializeResult result = BlockSerializer::serialize_and_compress(voxel_buffer);
+	ZYLANN_TEST_ASSERT(result.success);
+	std::vector<uint8_t> data = result.data;
+
+	// Marker byte, version, 3 size fields, one format byte and value per channel, trailing magic:
+	// far below what the full format wrapped in LZ4 takes
+	ZYLANN_TEST_ASSERT(data.size() > 0);
+	ZYLANN_TEST_ASSERT(data.size() < 64);
+
+	VoxelBufferInternal deserialized_voxel_buffer;
+	ZYLANN_TEST_ASSERT(BlockSerializer::decompress_and_deserialize(to_span_const(data), deserialized_voxel_buffer));
+	ZYLANN_TEST_ASSERT(voxel_buffer.equals(deserialized_voxel_buffer));
+
+	// A block with a dense channel must not take the uniform record
+	voxel_buffer.set_voxel(1, Vector3i(3, 4, 5), 0);
+	BlockSerializer::SerializeResult dense_result = BlockSerializer::serialize_and_compress(voxel_buffer);
+	ZYLANN_TEST_ASSERT(dense_result.success);
+	std::vector<uint8_t> dense_data = dense_result.data;
+	VoxelBufferInternal dense_deserialized;
+	ZYLANN_TEST_ASSERT(
+			BlockSerializer::decompress_and_deserialize(to_span_const(dense_data), dense_deserialized));
+	ZYLANN_TEST_ASSERT(voxel_buffer.equals(dense_deserialized));
+}
+
+void test_block_serializer_channel_mask() {
+	// Partial reads materialize only the requested channels; on single-dense-channel saves the
+	// dense payload section isn't even decompressed when excluded
+	VoxelBufferInternal voxel_buffer;
+	voxel_buffer.create(Vector3i(16, 16, 16));
+	// Dense SDF channel, uniform type channel
+	voxel_buffer.fill(7, VoxelBufferInternal::CHANNEL_TYPE);
+	voxel_buffer.set_voxel_f(-0.5f, Vector3i(3, 4, 5), VoxelBufferInternal::CHANNEL_SDF);
+	voxel_buffer.set_voxel_f(0.25f, Vector3i(8, 2, 1), VoxelBufferInternal::CHANNEL_SDF);
+
+	BlockSerializer::SerializeResult result = BlockSerializer::serialize_and_compress(voxel_buffer);
+	ZYLANN_TEST_ASSERT(result.success);
+	std::vector<uint8_t> data = result.data;
+
+	{
+		// SDF-only read: SDF matches, TYPE stays default
+		VoxelBufferInternal partial;
+		ZYLANN_TEST_ASSERT(BlockSerializer::decompress_and_deserialize_channels(
+				to_span_const(data), partial, 1 << VoxelBufferInternal::CHANNEL_SDF));
+		ZYLANN_TEST_ASSERT(partial.get_size() == voxel_buffer.get_size());
+		ZYLANN_TEST_ASSERT(partial.get_voxel(Vector3i(3, 4, 5), VoxelBufferInternal::CHANNEL_SDF) ==
+				voxel_buffer.get_voxel(Vector3i(3, 4, 5), VoxelBufferInternal::CHANNEL_SDF));
+		ZYLANN_TEST_ASSERT(partial.get_voxel(Vector3i(0, 0, 0), VoxelBufferInternal::CHANNEL_TYPE) != 7);
+	}
+	{
+		// Type-only read skips the dense SDF payload
+		VoxelBufferInternal partial;
+		ZYLANN_TEST_ASSERT(BlockSerializer::decompress_and_deserialize_channels(
+				to_span_const(data), partial, 1 << VoxelBufferInternal::CHANNEL_TYPE));
+		ZYLANN_TEST_ASSERT(partial.get_voxel(Vector3i(0, 0, 0), VoxelBufferInternal::CHANNEL_TYPE) == 7);
+		ZYLANN_TEST_ASSERT(partial.is_uniform(VoxelBufferInternal::CHANNEL_SDF));
+	}
+	{
+		// Full-mask read through the same entry point stays exact
+		VoxelBufferInternal full;
+		ZYLANN_TEST_ASSERT(
+				BlockSerializer::decompress_and_deserialize_channels(to_span_const(data), full, 0xffffffff));
+		ZYLANN_TEST_ASSERT(voxel_buffer.equals(full));
+	}
+	{
+		// Also exercise the masked path on the general multi-dense format
+		voxel_buffer.set_voxel(3, Vector3i(1, 1, 1), VoxelBufferInternal::CHANNEL_TYPE);
+		BlockSerializer::SerializeResult multi_result = BlockSerializer::serialize_and_compress(voxel_buffer);
+		ZYLANN_TEST_ASSERT(multi_result.success);
+		std::vector<uint8_t> multi_data = multi_result.data;
+		VoxelBufferInternal partial;
+		ZYLANN_TEST_ASSERT(BlockSerializer::decompress_and_deserialize_channels(
+				to_span_const(multi_data), partial, 1 << VoxelBufferInternal::CHANNEL_TYPE));
+		ZYLANN_TEST_ASSERT(partial.get_voxel(Vector3i(1, 1, 1), VoxelBufferInternal::CHANNEL_TYPE) == 3);
+		ZYLANN_TEST_ASSERT(partial.is_uniform(VoxelBufferInternal::CHANNEL_SDF));
+	}
+}
+
+void test_block_serializer_metadata() {
+	const Vector3i block_size(16, 16, 16);
+
+	// Repeated values, like machines or wires stamped over many voxels
+	Dictionary machine;
+	machine["type"] = "wire";
+	machine["powered"] = true;
+
+	VoxelBufferInternal voxel_buffer;
+	voxel_buffer.create(block_size);
+	for (int i = 0; i < 40; ++i) {
+		VoxelMetadata *meta = voxel_buffer.get_or_create_voxel_metadata(Vector3i(i % 16, i / 16, 5));
+		ZYLANN_TEST_ASSERT(meta != nullptr);
+		gd::set_as_variant(*meta, machine);
+	}
+	{
+		// One distinct value in the middle
+		VoxelMetadata *meta = voxel_buffer.get_or_create_voxel_metadata(Vector3i(7, 7, 7));
+		ZYLANN_TEST_ASSERT(meta != nullptr);
+		gd::set_as_variant(*meta, "unique");
+	}
+	{
+		VoxelMetadata *meta = voxel_buffer.get_or_create_voxel_metadata(Vector3i(3, 4, 5));
+		ZYLANN_TEST_ASSERT(meta != nullptr);
+		meta->set_u64(12345);
+	}
+	gd::set_as_variant(voxel_buffer.get_block_metadata(), "block");
+
+	BlockSerializer::SerializeResult result = BlockSerializer::serialize(voxel_buffer);
+	ZYLANN_TEST_ASSERT(result.success);
+	std::vector<uint8_t> data = result.data;
+
+	// Repeated entries must have been stored as references: 40 copies of the dictionary would be
+	// far larger than one encode plus 5-byte references
+	{
+		Dictionary unique_dict = machine.duplicate();
+		VoxelBufferInternal naive_buffer;
+		naive_buffer.create(block_size);
+		VoxelMetadata *meta = naive_buffer.get_or_create_voxel_metadata(Vector3i(0, 0, 0));
+		gd::set_as_variant(*meta, unique_dict);
+		BlockSerializer::SerializeResult single_result = BlockSerializer::serialize(naive_buffer);
+		ZYLANN_TEST_ASSERT(single_result.success);
+		// 40 entries with one shared payload must cost less than 3 standalone payloads
+		ZYLANN_TEST_ASSERT(data.size() < single_result.data.size() * 3);
+	}
+
+	VoxelBufferInternal deserialized_buffer;
+	ZYLANN_TEST_ASSERT(BlockSerializer::deserialize(to_span_const(data), deserialized_buffer));
+
+	for (int i = 0; i < 40; ++i) {
+		const VoxelMetadata *meta = deserialized_buffer.get_voxel_metadata(Vector3i(i % 16, i / 16, 5));
+		ZYLANN_TEST_ASSERT(meta != nullptr);
+		const Variant v = gd::get_as_variant(*meta);
+		ZYLANN_TEST_ASSERT(v.get_type() == Variant::DICTIONARY);
+		ZYLANN_TEST_ASSERT(Dictionary(v)["type"] == Variant("wire"));
+		ZYLANN_TEST_ASSERT(Dictionary(v)["powered"] == Variant(true));
+	}
+	{
+		const VoxelMetadata *meta = deserialized_buffer.get_voxel_metadata(Vector3i(7, 7, 7));
+		ZYLANN_TEST_ASSERT(meta != nullptr);
+		ZYLANN_TEST_ASSERT(gd::get_as_variant(*meta) == Variant("unique"));
+	}
+	{
+		const VoxelMetadata *meta = deserialized_buffer.get_voxel_metadata(Vector3i(3, 4, 5));
+		ZYLANN_TEST_ASSERT(meta != nullptr);
+		ZYLANN_TEST_ASSERT(meta->get_type() == VoxelMetadata::TYPE_U64);
+		ZYLANN_TEST_ASSERT(meta->get_u64() == 12345);
+	}
+	ZYLANN_TEST_ASSERT(gd::get_as_variant(deserialized_buffer.get_block_metadata()) == Variant("block"));
 }
 
 void test_block_serializer_stream_peer() {
@@ -2099,6 +2446,384 @@ void test_voxel_mesher_cubes() {
 	ZYLANN_TEST_ASSERT(surface1_vertices_count == 20);
 }
 
+void test_voxel_buffer_morton_layout() {
+	// Encode/decode roundtrip
+	for (uint32_t x = 0; x < 16; x += 3) {
+		for (uint32_t y = 0; y < 16; y += 5) {
+			for (uint32_t z = 0; z < 16; z += 7) {
+				const uint32_t m = math::morton3(x, y, z);
+				uint32_t dx, dy, dz;
+				math::morton3_decode(m, dx, dy, dz);
+				ZYLANN_TEST_ASSERT(dx == x && dy == y && dz == z);
+			}
+		}
+	}
+	// Layout conversion preserves voxel values
+	VoxelBufferInternal vb;
+	vb.create(16, 16, 16);
+	Vector3i pos;
+	for (pos.z = 0; pos.z < 16; ++pos.z) {
+		for (pos.x = 0; pos.x < 16; ++pos.x) {
+			for (pos.y = 0; pos.y < 16; ++pos.y) {
+				vb.set_voxel(pos.x + pos.y * 16 + pos.z * 256, pos, VoxelBufferInternal::CHANNEL_TYPE);
+			}
+		}
+	}
+	vb.set_channel_layout(VoxelBufferInternal::CHANNEL_TYPE, VoxelBufferInternal::CHANNEL_LAYOUT_MORTON);
+	ZYLANN_TEST_ASSERT(vb.get_channel_layout(VoxelBufferInternal::CHANNEL_TYPE) ==
+			VoxelBufferInternal::CHANNEL_LAYOUT_MORTON);
+	for (pos.z = 0; pos.z < 16; ++pos.z) {
+		for (pos.x = 0; pos.x < 16; ++pos.x) {
+			for (pos.y = 0; pos.y < 16; ++pos.y) {
+				ZYLANN_TEST_ASSERT(int(vb.get_voxel(pos, VoxelBufferInternal::CHANNEL_TYPE)) ==
+						pos.x + pos.y * 16 + pos.z * 256);
+			}
+		}
+	}
+	vb.set_channel_layout(VoxelBufferInternal::CHANNEL_TYPE, VoxelBufferInternal::CHANNEL_LAYOUT_ZXY);
+	for (pos.z = 0; pos.z < 16; ++pos.z) {
+		for (pos.x = 0; pos.x < 16; ++pos.x) {
+			for (pos.y = 0; pos.y < 16; ++pos.y) {
+				ZYLANN_TEST_ASSERT(int(vb.get_voxel(pos, VoxelBufferInternal::CHANNEL_TYPE)) ==
+						pos.x + pos.y * 16 + pos.z * 256);
+			}
+		}
+	}
+}
+
+void test_voxel_buffer_bulk_ops() {
+	// Fill
+	{
+		std::vector<uint16_t> data(17 * 3 + 5, 0);
+		bulk_ops::fill_span(to_span(data), uint16_t(0xabcd));
+		for (unsigned int i = 0; i < data.size(); ++i) {
+			ZYLANN_TEST_ASSERT(data[i] == 0xabcd);
+		}
+	}
+	// Min/max matches the scalar loop, including the tail not covered by SIMD lanes
+	{
+		std::vector<int16_t> data;
+		for (int i = 0; i < 100; ++i) {
+			data.push_back((i * 2605) % 317 - 150);
+		}
+		int16_t expected_min = data[0];
+		int16_t expected_max = data[0];
+		for (unsigned int i = 0; i < data.size(); ++i) {
+			expected_min = math::min(expected_min, data[i]);
+			expected_max = math::max(expected_max, data[i]);
+		}
+		int16_t min_v;
+		int16_t max_v;
+		bulk_ops::min_max_span_s16(to_span_const(data), min_v, max_v);
+		ZYLANN_TEST_ASSERT(min_v == expected_min);
+		ZYLANN_TEST_ASSERT(max_v == expected_max);
+	}
+	// SDF combine
+	{
+		std::vector<int16_t> a;
+		std::vector<int16_t> b;
+		for (int i = 0; i < 50; ++i) {
+			a.push_back((i * 37) % 201 - 100);
+			b.push_back((i * 53) % 201 - 100);
+		}
+		std::vector<int16_t> a_union = a;
+		std::vector<int16_t> a_subtract = a;
+		bulk_ops::sdf_union_span_s16(to_span(a_union), to_span_const(b));
+		bulk_ops::sdf_subtract_span_s16(to_span(a_subtract), to_span_const(b));
+		for (unsigned int i = 0; i < a.size(); ++i) {
+			ZYLANN_TEST_ASSERT(a_union[i] == math::min(a[i], b[i]));
+			ZYLANN_TEST_ASSERT(a_subtract[i] == math::max(a[i], int16_t(-b[i])));
+		}
+	}
+}
+
+void test_voxel_buffer_cow() {
+	VoxelBufferInternal a;
+	a.create(8, 8, 8);
+	// Force the channel to allocate
+	a.set_voxel(100, 1, 1, 1, VoxelBufferInternal::CHANNEL_TYPE);
+	a.set_voxel(50, 3, 3, 3, VoxelBufferInternal::CHANNEL_TYPE);
+
+	VoxelBufferInternal b;
+	b.copy_shared_from(a, true);
+	ZYLANN_TEST_ASSERT(b.equals(a));
+
+	// Writing to the original detaches it, the snapshot must keep the old values
+	a.set_voxel(51, 3, 3, 3, VoxelBufferInternal::CHANNEL_TYPE);
+	ZYLANN_TEST_ASSERT(a.get_voxel(3, 3, 3, VoxelBufferInternal::CHANNEL_TYPE) == 51);
+	ZYLANN_TEST_ASSERT(b.get_voxel(3, 3, 3, VoxelBufferInternal::CHANNEL_TYPE) == 50);
+
+	// And writing to the snapshot does not affect the original
+	b.set_voxel(52, 5, 5, 5, VoxelBufferInternal::CHANNEL_TYPE);
+	ZYLANN_TEST_ASSERT(a.get_voxel(5, 5, 5, VoxelBufferInternal::CHANNEL_TYPE) == 0);
+	ZYLANN_TEST_ASSERT(b.get_voxel(5, 5, 5, VoxelBufferInternal::CHANNEL_TYPE) == 52);
+
+	// Dropping either side must leave the other fully usable
+	{
+		VoxelBufferInternal c;
+		c.copy_shared_from(a, false);
+	}
+	ZYLANN_TEST_ASSERT(a.get_voxel(1, 1, 1, VoxelBufferInternal::CHANNEL_TYPE) == 100);
+}
+
+void test_voxel_buffer_tiled() {
+	// Mostly-uniform channels get tiled storage from `compress_uniform_channels`, reads stay
+	// transparent, and any write densifies the channel back
+	VoxelBufferInternal vb;
+	vb.create(16, 16, 16);
+
+	// Mostly air with a small solid cluster, the floating-island case
+	vb.fill(0, VoxelBufferInternal::CHANNEL_TYPE);
+	for (int z = 4; z < 7; ++z) {
+		for (int y = 4; y < 7; ++y) {
+			for (int x = 4; x < 7; ++x) {
+				vb.set_voxel(7, x, y, z, VoxelBufferInternal::CHANNEL_TYPE);
+			}
+		}
+	}
+
+	VoxelBufferInternal reference;
+	reference.create(16, 16, 16);
+	reference.copy_from(vb);
+
+	vb.compress_uniform_channels();
+	// The conversion heuristic only tiles when at most half the dense size is needed
+	ZYLANN_TEST_ASSERT(vb.get_channel_compression(VoxelBufferInternal::CHANNEL_TYPE) ==
+			VoxelBufferInternal::COMPRESSION_TILED);
+
+	// Every voxel must read back the same
+	for (int z = 0; z < 16; ++z) {
+		for (int y = 0; y < 16; ++y) {
+			for (int x = 0; x < 16; ++x) {
+				ZYLANN_TEST_ASSERT(vb.get_voxel(x, y, z, VoxelBufferInternal::CHANNEL_TYPE) ==
+						reference.get_voxel(x, y, z, VoxelBufferInternal::CHANNEL_TYPE));
+			}
+		}
+	}
+
+	// Serialization stores tiled channels dense, so a roundtrip must restore the same contents
+	{
+		BlockSerializer::SerializeResult res = BlockSerializer::serialize_and_compress(vb);
+		ZYLANN_TEST_ASSERT(res.success);
+		VoxelBufferInternal deserialized;
+		ZYLANN_TEST_ASSERT(BlockSerializer::decompress_and_deserialize(to_span_const(res.data), deserialized));
+		ZYLANN_TEST_ASSERT(deserialized.equals(reference));
+	}
+
+	// A write densifies transparently and must not lose data
+	vb.set_voxel(9, 15, 15, 15, VoxelBufferInternal::CHANNEL_TYPE);
+	ZYLANN_TEST_ASSERT(vb.get_channel_compression(VoxelBufferInternal::CHANNEL_TYPE) ==
+			VoxelBufferInternal::COMPRESSION_NONE);
+	ZYLANN_TEST_ASSERT(vb.get_voxel(15, 15, 15, VoxelBufferInternal::CHANNEL_TYPE) == 9);
+	ZYLANN_TEST_ASSERT(vb.get_voxel(5, 5, 5, VoxelBufferInternal::CHANNEL_TYPE) == 7);
+}
+
+void test_voxel_buffer_paletted() {
+	// Wide channels holding few distinct values get palette storage; values must read back the
+	// same, survive a serialization roundtrip natively, and writes must densify transparently
+	VoxelBufferInternal vb;
+	vb.create(16, 16, 16);
+	vb.set_channel_depth(VoxelBufferInternal::CHANNEL_TYPE, VoxelBufferInternal::DEPTH_16_BIT);
+
+	// A checkerboard-ish mix of a few types, so no tile is uniform and tiling can't apply
+	for (int z = 0; z < 16; ++z) {
+		for (int y = 0; y < 16; ++y) {
+			for (int x = 0; x < 16; ++x) {
+				vb.set_voxel(1000 + ((x + y + z) % 5), x, y, z, VoxelBufferInternal::CHANNEL_TYPE);
+			}
+		}
+	}
+
+	VoxelBufferInternal reference;
+	reference.create(16, 16, 16);
+	reference.set_channel_depth(VoxelBufferInternal::CHANNEL_TYPE, VoxelBufferInternal::DEPTH_16_BIT);
+	reference.copy_from(vb);
+
+	vb.compress_uniform_channels();
+	ZYLANN_TEST_ASSERT(vb.get_channel_compression(VoxelBufferInternal::CHANNEL_TYPE) ==
+			VoxelBufferInternal::COMPRESSION_PALETTED);
+
+	for (int z = 0; z < 16; ++z) {
+		for (int y = 0; y < 16; ++y) {
+			for (int x = 0; x < 16; ++x) {
+				ZYLANN_TEST_ASSERT(vb.get_voxel(x, y, z, VoxelBufferInternal::CHANNEL_TYPE) ==
+						reference.get_voxel(x, y, z, VoxelBufferInternal::CHANNEL_TYPE));
+			}
+		}
+	}
+
+	// Palettes are serialized natively (format v5) and restored as palettes
+	{
+		BlockSerializer::SerializeResult res = BlockSerializer::serialize(vb);
+		ZYLANN_TEST_ASSERT(res.success);
+		VoxelBufferInternal deserialized;
+		ZYLANN_TEST_ASSERT(BlockSerializer::deserialize(to_span_const(res.data), deserialized));
+		ZYLANN_TEST_ASSERT(deserialized.get_channel_compression(VoxelBufferInternal::CHANNEL_TYPE) ==
+				VoxelBufferInternal::COMPRESSION_PALETTED);
+		ZYLANN_TEST_ASSERT(deserialized.equals(vb));
+	}
+
+	// A write densifies transparently without losing data
+	vb.set_voxel(2000, 0, 0, 0, VoxelBufferInternal::CHANNEL_TYPE);
+	ZYLANN_TEST_ASSERT(vb.get_channel_compression(VoxelBufferInternal::CHANNEL_TYPE) ==
+			VoxelBufferInternal::COMPRESSION_NONE);
+	ZYLANN_TEST_ASSERT(vb.get_voxel(0, 0, 0, VoxelBufferInternal::CHANNEL_TYPE) == 2000);
+	ZYLANN_TEST_ASSERT(vb.get_voxel(5, 5, 5, VoxelBufferInternal::CHANNEL_TYPE) ==
+			reference.get_voxel(5, 5, 5, VoxelBufferInternal::CHANNEL_TYPE));
+}
+
+void test_block_serializer_delta() {
+	// Delta blobs store only edited regions; applying them on top of the same base must
+	// reconstruct the edited block exactly
+	VoxelBufferInternal base;
+	base.create(16, 16, 16);
+	for (int z = 0; z < 16; ++z) {
+		for (int y = 0; y < 16; ++y) {
+			for (int x = 0; x < 16; ++x) {
+				base.set_voxel(x + y * 3 + z * 7, x, y, z, VoxelBufferInternal::CHANNEL_TYPE);
+			}
+		}
+	}
+
+	VoxelBufferInternal edited;
+	edited.create(16, 16, 16);
+	edited.copy_from(base);
+	const Box3i edit_box(Vector3i(4, 5, 6), Vector3i(3, 2, 4));
+	edited.fill_area(42, edit_box.pos, edit_box.pos + edit_box.size, VoxelBufferInternal::CHANNEL_TYPE);
+
+	BlockSerializer::SerializeResult res =
+			BlockSerializer::serialize_delta(edited, Span<const Box3i>(&edit_box, 1));
+	ZYLANN_TEST_ASSERT(res.success);
+	ZYLANN_TEST_ASSERT(BlockSerializer::is_delta_blob(to_span_const(res.data)));
+	// A delta of a small box must be much smaller than the full block
+	ZYLANN_TEST_ASSERT(res.data.size() < 1024);
+	std::vector<uint8_t> blob = res.data;
+
+	VoxelBufferInternal reconstructed;
+	reconstructed.create(16, 16, 16);
+	reconstructed.copy_from(base);
+	std::vector<Box3i> boxes;
+	ZYLANN_TEST_ASSERT(BlockSerializer::deserialize_delta(to_span_const(blob), reconstructed, boxes));
+	ZYLANN_TEST_ASSERT(boxes.size() == 1);
+	ZYLANN_TEST_ASSERT(boxes[0] == edit_box);
+	ZYLANN_TEST_ASSERT(reconstructed.equals(edited));
+}
+
+void test_mesh_sdf_bvh() {
+	// The BVH-accelerated bake must produce the same distances as the naive one.
+	// Signs can differ on cells equidistant to triangles of opposing orientation (a known
+	// ambiguity worked around by the boundary sign fix), so magnitudes are compared.
+	std::vector<Vector3> vertices = { Vector3(0, 0, 0), Vector3(10, 0, 0), Vector3(0, 10, 0), Vector3(0, 0, 10) };
+	std::vector<int> indices = { 0, 1, 2, 0, 2, 3, 0, 3, 1, 1, 3, 2 };
+
+	std::vector<mesh_sdf::Triangle> triangles;
+	Vector3f min_pos;
+	Vector3f max_pos;
+	ZYLANN_TEST_ASSERT(
+			mesh_sdf::prepare_triangles(to_span_const(vertices), to_span_const(indices), triangles, min_pos, max_pos));
+
+	const Vector3f box_min_pos = min_pos - Vector3f(2.f, 2.f, 2.f);
+	const Vector3f box_max_pos = max_pos + Vector3f(2.f, 2.f, 2.f);
+	const Vector3i res(12, 12, 12);
+
+	std::vector<float> grid_naive(Vector3iUtil::get_volume(res));
+	std::vector<float> grid_bvh(Vector3iUtil::get_volume(res));
+
+	mesh_sdf::generate_mesh_sdf_naive(to_span(grid_naive), res, to_span(triangles), box_min_pos, box_max_pos);
+
+	mesh_sdf::TriangleBvh bvh;
+	bvh.build(to_span(triangles));
+	mesh_sdf::generate_mesh_sdf_bvh(to_span(grid_bvh), res, Box3i(Vector3i(), res), bvh, box_min_pos, box_max_pos);
+
+	for (size_t i = 0; i < grid_naive.size(); ++i) {
+		ZYLANN_TEST_ASSERT(Math::abs(Math::abs(grid_naive[i]) - Math::abs(grid_bvh[i])) < 0.001f);
+	}
+}
+
+void test_compressed_data_filtered() {
+	// Smooth-ish 16-bit sequence, like quantized SDF data
+	std::vector<uint8_t> src;
+	for (int i = 0; i < 1000; ++i) {
+		const uint16_t v = 32768 + 800 * i / (1 + i / 100);
+		src.push_back(v & 0xff);
+		src.push_back(v >> 8);
+	}
+
+	std::vector<uint8_t> compressed;
+	ZYLANN_TEST_ASSERT(CompressedData::compress_filtered(to_span_const(src), compressed, 2));
+
+	std::vector<uint8_t> decompressed;
+	ZYLANN_TEST_ASSERT(CompressedData::decompress(to_span_const(compressed), decompressed));
+	ZYLANN_TEST_ASSERT(decompressed.size() == src.size());
+	ZYLANN_TEST_ASSERT(memcmp(decompressed.data(), src.data(), src.size()) == 0);
+}
+
+void test_image_range_grid_cache() {
+	zylann::testing::TestDirectory test_dir;
+	ZYLANN_TEST_ASSERT(test_dir.is_valid());
+	const String cache_path = test_dir.get_path().plus_file("image_range.bin");
+
+	Ref<Image> image;
+	image.instantiate();
+	image->create(64, 48, false, Image::FORMAT_RF);
+	for (int y = 0; y < image->get_height(); ++y) {
+		for (int x = 0; x < image->get_width(); ++x) {
+			image->set_pixel(x, y, Color(Math::sin(0.3f * x) * Math::cos(0.2f * y), 0.f, 0.f));
+		}
+	}
+
+	ImageRangeGrid grid;
+	grid.generate(**image);
+	ZYLANN_TEST_ASSERT(grid.save_to_file(cache_path));
+
+	ImageRangeGrid loaded_grid;
+	ZYLANN_TEST_ASSERT(loaded_grid.load_from_file(cache_path));
+
+	ZYLANN_TEST_ASSERT(loaded_grid.get_range().min == grid.get_range().min);
+	ZYLANN_TEST_ASSERT(loaded_grid.get_range().max == grid.get_range().max);
+	const math::Interval qx(3, 40);
+	const math::Interval qy(10, 30);
+	ZYLANN_TEST_ASSERT(loaded_grid.get_range(qx, qy).min == grid.get_range(qx, qy).min);
+	ZYLANN_TEST_ASSERT(loaded_grid.get_range(qx, qy).max == grid.get_range(qx, qy).max);
+
+	// Loading something that isn't a cache file must fail and leave the grid usable
+	ZYLANN_TEST_ASSERT(loaded_grid.load_from_file(test_dir.get_path().plus_file("missing.bin")) == false);
+}
+
+void test_interval_simd() {
+	// The SIMD reductions must match the naive 4-combination formulas
+	const float values[] = { -5.f, -1.5f, -0.25f, 0.f, 0.5f, 2.f, 10.f };
+	const unsigned int count = sizeof(values) / sizeof(values[0]);
+	for (unsigned int i = 0; i < count; ++i) {
+		for (unsigned int j = i; j < count; ++j) {
+			for (unsigned int k = 0; k < count; ++k) {
+				for (unsigned int l = k; l < count; ++l) {
+					const math::Interval a(values[i], values[j]);
+					const math::Interval b(values[k], values[l]);
+					{
+						const math::Interval p = a * b;
+						const real_t expected_min =
+								math::min(a.min * b.min, a.min * b.max, a.max * b.min, a.max * b.max);
+						const real_t expected_max =
+								math::max(a.min * b.min, a.min * b.max, a.max * b.min, a.max * b.max);
+						ZYLANN_TEST_ASSERT(p.min == expected_min);
+						ZYLANN_TEST_ASSERT(p.max == expected_max);
+					}
+					if (!b.contains(0.f)) {
+						const math::Interval q = a / b;
+						const real_t expected_min =
+								math::min(a.min / b.min, a.min / b.max, a.max / b.min, a.max / b.max);
+						const real_t expected_max =
+								math::max(a.min / b.min, a.min / b.max, a.max / b.min, a.max / b.max);
+						ZYLANN_TEST_ASSERT(q.min == expected_min);
+						ZYLANN_TEST_ASSERT(q.max == expected_max);
+					}
+				}
+			}
+		}
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #define VOXEL_TEST(fname)                                                                                              \
@@ -2117,6 +2842,7 @@ void run_voxel_tests() {
 	VOXEL_TEST(test_copy_3d_region_zxy);
 	VOXEL_TEST(test_voxel_graph_generator_default_graph_compilation);
 	VOXEL_TEST(test_voxel_graph_generator_expressions);
+	VOXEL_TEST(test_voxel_graph_chain_fusion);
 	VOXEL_TEST(test_voxel_graph_generator_texturing);
 	VOXEL_TEST(test_island_finder);
 	VOXEL_TEST(test_unordered_remove_if);
@@ -2126,7 +2852,13 @@ void run_voxel_tests() {
 	VOXEL_TEST(test_octree_find_in_box);
 	VOXEL_TEST(test_get_curve_monotonic_sections);
 	VOXEL_TEST(test_voxel_buffer_create);
+	VOXEL_TEST(test_struct_db);
+	VOXEL_TEST(test_voxel_buffer_convert_channel_depth);
+	VOXEL_TEST(test_compressed_data_codec_registry);
 	VOXEL_TEST(test_block_serializer);
+	VOXEL_TEST(test_block_serializer_uniform);
+	VOXEL_TEST(test_block_serializer_channel_mask);
+	VOXEL_TEST(test_block_serializer_metadata);
 	VOXEL_TEST(test_block_serializer_stream_peer);
 	VOXEL_TEST(test_region_file);
 	VOXEL_TEST(test_voxel_stream_region_files);
@@ -2139,6 +2871,16 @@ void run_voxel_tests() {
 	VOXEL_TEST(test_voxel_buffer_metadata);
 	VOXEL_TEST(test_voxel_buffer_metadata_gd);
 	VOXEL_TEST(test_voxel_mesher_cubes);
+	VOXEL_TEST(test_voxel_buffer_bulk_ops);
+	VOXEL_TEST(test_interval_simd);
+	VOXEL_TEST(test_image_range_grid_cache);
+	VOXEL_TEST(test_compressed_data_filtered);
+	VOXEL_TEST(test_mesh_sdf_bvh);
+	VOXEL_TEST(test_voxel_buffer_cow);
+	VOXEL_TEST(test_voxel_buffer_tiled);
+	VOXEL_TEST(test_voxel_buffer_paletted);
+	VOXEL_TEST(test_block_serializer_delta);
+	VOXEL_TEST(test_voxel_buffer_morton_layout);
 
 	print_line("------------ Voxel tests end -------------");
 }
@@ -283,6 +283,41 @@ public:
 		std::sort(_items.begin(), _items.end());
 	}
 
+	// Inserts or assigns many items at once with a single merge, instead of re-shifting the
+	// underlying vector for every new key like repeated `insert_or_assign` would.
+	// Keys within `pairs` must be unique; the span's contents are consumed.
+	void insert_or_assign_bulk(Span<Pair> pairs) {
+		if (pairs.size() == 0) {
+			return;
+		}
+		std::sort(pairs.data(), pairs.data() + pairs.size());
+		std::vector<Pair> merged;
+		merged.reserve(_items.size() + pairs.size());
+		size_t ai = 0;
+		size_t bi = 0;
+		while (ai < _items.size() && bi < pairs.size()) {
+			if (KComp::less_than(_items[ai].key, pairs[bi].key)) {
+				merged.push_back(std::move(_items[ai]));
+				++ai;
+			} else if (KComp::less_than(pairs[bi].key, _items[ai].key)) {
+				merged.push_back(std::move(pairs[bi]));
+				++bi;
+			} else {
+				// Same key, the new value replaces the old one
+				merged.push_back(std::move(pairs[bi]));
+				++ai;
+				++bi;
+			}
+		}
+		for (; ai < _items.size(); ++ai) {
+			merged.push_back(std::move(_items[ai]));
+		}
+		for (; bi < pairs.size(); ++bi) {
+			merged.push_back(std::move(pairs[bi]));
+		}
+		_items = std::move(merged);
+	}
+
 	const T *find(K key) const {
 		typename std::vector<Pair>::const_iterator it = std::lower_bound(_items.begin(), _items.end(), key);
 		if (it != _items.end() && it->key == key) {
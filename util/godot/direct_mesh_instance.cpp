@@ -73,6 +73,12 @@ void DirectMeshInstance::set_material_override(Ref<Material> material) {
 	}
 }
 
+void DirectMeshInstance::set_custom_aabb(AABB aabb) {
+	ERR_FAIL_COND(!_mesh_instance.is_valid());
+	RenderingServer &vs = *RenderingServer::get_singleton();
+	vs.instance_set_custom_aabb(_mesh_instance, aabb);
+}
+
 void DirectMeshInstance::set_visible(bool visible) {
 	ERR_FAIL_COND(!_mesh_instance.is_valid());
 	RenderingServer &vs = *RenderingServer::get_singleton();
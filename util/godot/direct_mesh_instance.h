@@ -24,6 +24,8 @@ public:
 	void set_material_override(Ref<Material> material);
 	void set_visible(bool visible);
 	void set_cast_shadows_setting(RenderingServer::ShadowCastingSetting mode);
+	// Overrides culling bounds, e.g. to keep a warm-up instance always rendered
+	void set_custom_aabb(AABB aabb);
 	void set_shader_instance_uniform(StringName key, Variant value);
 
 	// Convenience
@@ -1,4 +1,5 @@
 #include "direct_multimesh_instance.h"
+#include "../math/funcs.h"
 #include "../profiling.h"
 
 #include <scene/resources/world_3d.h>
@@ -29,6 +30,9 @@ void DirectMultiMeshInstance::destroy() {
 		_multimesh_instance = RID();
 		_multimesh.unref();
 	}
+	_transform_buffer = PackedFloat32Array();
+	_dirty_min_index = 0;
+	_dirty_max_index = -1;
 }
 
 void DirectMultiMeshInstance::set_world(World3D *world) {
@@ -51,6 +55,12 @@ void DirectMultiMeshInstance::set_multimesh(Ref<MultiMesh> multimesh) {
 	} else {
 		vs.instance_set_base(_multimesh_instance, RID());
 	}
+	if (_multimesh != multimesh) {
+		// The local copy belonged to the previous multimesh
+		_transform_buffer = PackedFloat32Array();
+		_dirty_min_index = 0;
+		_dirty_max_index = -1;
+	}
 	_multimesh = multimesh;
 }
 
@@ -104,6 +114,80 @@ inline void write_bulk_array_transform(float *dst, const Transform3D &t) {
 	dst[11] = t.origin.z;
 }
 
+namespace {
+
+const int TRANSFORM_3D_ITEM_SIZE = 12; // In number of floats
+
+// Below this many modified instances, they are sent individually rather than re-uploading the
+// whole buffer
+const int PARTIAL_UPLOAD_MAX_INSTANCES = 64;
+
+inline Transform3D read_bulk_array_transform(const float *src) {
+	return Transform3D(Basis(src[0], src[1], src[2], src[4], src[5], src[6], src[8], src[9], src[10]),
+			Vector3(src[3], src[7], src[11]));
+}
+
+} // namespace
+
+void DirectMultiMeshInstance::set_transform_buffer(const PackedFloat32Array &bulk_array) {
+	ERR_FAIL_COND(_multimesh.is_null());
+	ERR_FAIL_COND(bulk_array.size() % TRANSFORM_3D_ITEM_SIZE != 0);
+	// This is a cheap copy-on-write reference, the server snapshots its own copy on upload
+	_transform_buffer = bulk_array;
+	_dirty_min_index = 0;
+	_dirty_max_index = -1;
+	RenderingServer::get_singleton()->multimesh_set_buffer(_multimesh->get_rid(), _transform_buffer);
+}
+
+bool DirectMultiMeshInstance::has_transform_buffer() const {
+	return _transform_buffer.size() != 0;
+}
+
+unsigned int DirectMultiMeshInstance::get_buffered_instance_count() const {
+	return _transform_buffer.size() / TRANSFORM_3D_ITEM_SIZE;
+}
+
+Transform3D DirectMultiMeshInstance::get_buffered_transform(unsigned int instance_index) const {
+	ERR_FAIL_COND_V(instance_index >= get_buffered_instance_count(), Transform3D());
+	return read_bulk_array_transform(_transform_buffer.ptr() + instance_index * TRANSFORM_3D_ITEM_SIZE);
+}
+
+void DirectMultiMeshInstance::set_buffered_transform(unsigned int instance_index, const Transform3D &t) {
+	ERR_FAIL_COND(instance_index >= get_buffered_instance_count());
+	write_bulk_array_transform(_transform_buffer.ptrw() + instance_index * TRANSFORM_3D_ITEM_SIZE, t);
+	if (_dirty_min_index > _dirty_max_index) {
+		_dirty_min_index = int(instance_index);
+		_dirty_max_index = int(instance_index);
+	} else {
+		_dirty_min_index = math::min(_dirty_min_index, int(instance_index));
+		_dirty_max_index = math::max(_dirty_max_index, int(instance_index));
+	}
+}
+
+void DirectMultiMeshInstance::flush_buffered_transforms() {
+	ZN_PROFILE_SCOPE();
+	if (_dirty_min_index > _dirty_max_index) {
+		// Nothing changed
+		return;
+	}
+	ERR_FAIL_COND(_multimesh.is_null());
+	RenderingServer &vs = *RenderingServer::get_singleton();
+	const RID multimesh_rid = _multimesh->get_rid();
+
+	const int dirty_count = _dirty_max_index - _dirty_min_index + 1;
+	if (dirty_count <= PARTIAL_UPLOAD_MAX_INSTANCES) {
+		for (int i = _dirty_min_index; i <= _dirty_max_index; ++i) {
+			vs.multimesh_instance_set_transform(
+					multimesh_rid, i, read_bulk_array_transform(_transform_buffer.ptr() + i * TRANSFORM_3D_ITEM_SIZE));
+		}
+	} else {
+		vs.multimesh_set_buffer(multimesh_rid, _transform_buffer);
+	}
+
+	_dirty_min_index = 0;
+	_dirty_max_index = -1;
+}
+
 void DirectMultiMeshInstance::make_transform_3d_bulk_array(
 		Span<const Transform3D> transforms, PackedFloat32Array &bulk_array) {
 	ZN_PROFILE_SCOPE();
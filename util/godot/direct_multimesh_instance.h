@@ -29,6 +29,23 @@ public:
 	void set_material_override(Ref<Material> material);
 	void set_cast_shadows_setting(RenderingServer::ShadowCastingSetting mode);
 
+	// Local buffer mode.
+	// Keeps a CPU-side copy of the multimesh transform buffer, so instances can be read and
+	// modified without syncing with the RenderingServer's thread, and flushing uploads only the
+	// range of instances that changed instead of the whole buffer. The copy is cheap: arrays are
+	// copy-on-write, so the server effectively gets its own buffer on upload (the swap is atomic
+	// from the renderer's point of view). Only supports TRANSFORM_3D without colors or custom data.
+
+	// Assigns the local copy and uploads the whole buffer once.
+	void set_transform_buffer(const PackedFloat32Array &bulk_array);
+	bool has_transform_buffer() const;
+	unsigned int get_buffered_instance_count() const;
+	Transform3D get_buffered_transform(unsigned int instance_index) const;
+	void set_buffered_transform(unsigned int instance_index, const Transform3D &t);
+	// Sends pending changes to the RenderingServer. Small ranges are sent per-instance, bigger
+	// ones fall back to a whole-buffer upload.
+	void flush_buffered_transforms();
+
 	static void make_transform_3d_bulk_array(Span<const Transform3D> transforms, PackedFloat32Array &bulk_array);
 
 	struct TransformAndColor8 {
@@ -50,6 +67,11 @@ public:
 private:
 	RID _multimesh_instance;
 	Ref<MultiMesh> _multimesh;
+
+	// Local buffer mode state. The dirty range is in instance indices and empty when min > max.
+	PackedFloat32Array _transform_buffer;
+	int _dirty_min_index = 0;
+	int _dirty_max_index = -1;
 };
 
 } // namespace zylann
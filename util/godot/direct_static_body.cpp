@@ -30,6 +30,7 @@ void DirectStaticBody::destroy() {
 		_body = RID();
 		// The shape need to be destroyed after the body
 		_shape.unref();
+		_retired_shape.unref();
 	}
 	if (_debug_mesh_instance.is_valid()) {
 		_debug_mesh_instance.destroy();
@@ -62,6 +63,30 @@ void DirectStaticBody::add_shape(Ref<Shape3D> shape) {
 	}
 }
 
+void DirectStaticBody::set_shape(Ref<Shape3D> shape) {
+	ZN_PROFILE_SCOPE();
+	ERR_FAIL_COND(!_body.is_valid());
+	ERR_FAIL_COND(shape.is_null());
+	PhysicsServer3D &ps = *PhysicsServer3D::get_singleton();
+
+	if (_shape.is_null()) {
+		ps.body_add_shape(_body, shape->get_rid(), Transform3D(), false);
+	} else {
+		// Single server call; the previous swap's retiree gets released now, outside the window
+		// that replaced it
+		_retired_shape.unref();
+		ps.body_set_shape(_body, 0, shape->get_rid());
+		_retired_shape = _shape;
+	}
+	// No use case for multishape yet
+	_shape = shape;
+
+	if (_debug_mesh_instance.is_valid()) {
+		Ref<Mesh> mesh = _shape->get_debug_mesh();
+		_debug_mesh_instance.set_mesh(mesh);
+	}
+}
+
 void DirectStaticBody::remove_shape(int shape_index) {
 	ERR_FAIL_COND(!_body.is_valid());
 	PhysicsServer3D::get_singleton()->body_remove_shape(_body, shape_index);
@@ -23,6 +23,11 @@ public:
 	void set_transform(Transform3D transform);
 	void add_shape(Ref<Shape3D> shape);
 	void remove_shape(int shape_index);
+	// Replaces the body's single shape with one server call instead of a remove+add pair, and
+	// retires the previous shape so its destruction happens outside the swap. The new shape is
+	// expected to be fully populated beforehand (building it touches only its own orphan RID),
+	// so the only work inside the physics-locked window is the RID swap itself.
+	void set_shape(Ref<Shape3D> shape);
 	Ref<Shape3D> get_shape(int shape_index);
 	void set_world(World3D *world);
 	void set_shape_enabled(int shape_index, bool disabled);
@@ -35,6 +40,9 @@ public:
 private:
 	RID _body;
 	Ref<Shape3D> _shape;
+	// Previous shape kept alive across a swap; freed on the next swap or on destroy, off the
+	// critical window that replaced it
+	Ref<Shape3D> _retired_shape;
 	zylann::DirectMeshInstance _debug_mesh_instance;
 };
 
@@ -26,10 +26,10 @@ bool is_mesh_empty(const Mesh &mesh) {
 	return false;
 }
 
-// Faster version of Mesh::create_trimesh_shape()
+// Part of the faster version of Mesh::create_trimesh_shape()
 // See https://github.com/Zylann/godot_voxel/issues/54
 //
-Ref<ConcavePolygonShape3D> create_concave_polygon_shape(Span<const Array> surfaces) {
+PackedVector3Array build_collision_shape_faces(Span<const Array> surfaces) {
 	ZN_PROFILE_SCOPE();
 
 	PackedVector3Array face_points;
@@ -50,7 +50,7 @@ Ref<ConcavePolygonShape3D> create_concave_polygon_shape(Span<const Array> surfac
 	face_points.resize(face_points_size);
 
 	if (face_points_size < 3) {
-		return Ref<ConcavePolygonShape3D>();
+		return PackedVector3Array();
 	}
 
 	//copy the points into it
@@ -63,9 +63,9 @@ Ref<ConcavePolygonShape3D> create_concave_polygon_shape(Span<const Array> surfac
 		PackedVector3Array positions = surface_arrays[Mesh::ARRAY_VERTEX];
 		PackedInt32Array indices = surface_arrays[Mesh::ARRAY_INDEX];
 
-		ERR_FAIL_COND_V(positions.size() < 3, Ref<ConcavePolygonShape3D>());
-		ERR_FAIL_COND_V(indices.size() < 3, Ref<ConcavePolygonShape3D>());
-		ERR_FAIL_COND_V(indices.size() % 3 != 0, Ref<ConcavePolygonShape3D>());
+		ERR_FAIL_COND_V(positions.size() < 3, PackedVector3Array());
+		ERR_FAIL_COND_V(indices.size() < 3, PackedVector3Array());
+		ERR_FAIL_COND_V(indices.size() % 3 != 0, PackedVector3Array());
 
 		unsigned int face_points_count = face_points_offset + indices.size();
 
@@ -90,6 +90,20 @@ Ref<ConcavePolygonShape3D> create_concave_polygon_shape(Span<const Array> surfac
 		face_points_offset += indices.size();
 	}
 
+	return face_points;
+}
+
+Ref<ConcavePolygonShape3D> create_concave_polygon_shape(Span<const Array> surfaces) {
+	return create_concave_polygon_shape(build_collision_shape_faces(surfaces));
+}
+
+Ref<ConcavePolygonShape3D> create_concave_polygon_shape(PackedVector3Array face_points) {
+	ZN_PROFILE_SCOPE();
+
+	if (face_points.size() < 3) {
+		return Ref<ConcavePolygonShape3D>();
+	}
+
 	Ref<ConcavePolygonShape3D> shape;
 	{
 		ZN_PROFILE_SCOPE_NAMED("Godot shape");
@@ -225,44 +239,6 @@ void set_nodes_owner_except_root(Node *root, Node *owner) {
 	}
 }
 
-void copy_to(Vector<Vector3> &dst, const std::vector<Vector3f> &src) {
-	dst.resize(src.size());
-	// resize can fail in case allocation was not possible
-	ERR_FAIL_COND(dst.size() != static_cast<int>(src.size()));
-
-#ifdef REAL_T_IS_DOUBLE
-	// Convert floats to doubles
-	const unsigned int count = dst.size() * Vector3f::AXIS_COUNT;
-	real_t *dst_w = reinterpret_cast<real_t *>(dst.ptrw());
-	const float *src_r = reinterpret_cast<const float *>(src.data());
-	for (unsigned int i = 0; i < count; ++i) {
-		dst_w[i] = src_r[i];
-	}
-#else
-	static_assert(sizeof(Vector3) == sizeof(Vector3f));
-	memcpy(dst.ptrw(), reinterpret_cast<const Vector3 *>(src.data()), src.size() * sizeof(Vector3f));
-#endif
-}
-
-void copy_to(Vector<Vector2> &dst, const std::vector<Vector2f> &src) {
-	dst.resize(src.size());
-	// resize can fail in case allocation was not possible
-	ERR_FAIL_COND(dst.size() != static_cast<int>(src.size()));
-
-#ifdef REAL_T_IS_DOUBLE
-	// Convert floats to doubles
-	const unsigned int count = dst.size() * Vector2f::AXIS_COUNT;
-	real_t *dst_w = reinterpret_cast<real_t *>(dst.ptrw());
-	const float *src_r = reinterpret_cast<const float *>(src.data());
-	for (unsigned int i = 0; i < count; ++i) {
-		dst_w[i] = src_r[i];
-	}
-#else
-	static_assert(sizeof(Vector2) == sizeof(Vector2f));
-	memcpy(dst.ptrw(), reinterpret_cast<const Vector2 *>(src.data()), src.size() * sizeof(Vector2f));
-#endif
-}
-
 PackedStringArray to_godot(const std::vector<std::string_view> &svv) {
 	PackedStringArray psa;
 	psa.resize(svv.size());
@@ -7,8 +7,10 @@
 
 #include <core/object/ref_counted.h>
 
+#include <cstring>
 #include <iosfwd>
 #include <memory>
+#include <vector>
 
 class Mesh;
 class ConcavePolygonShape3D;
@@ -20,7 +22,14 @@ namespace zylann {
 bool is_surface_triangulated(Array surface);
 bool is_mesh_empty(const Mesh &mesh);
 
+// Builds the triangle-soup array feeding ConcavePolygonShape3D from mesh surfaces. This is the
+// expensive part of creating the shape and can run on any thread. Returns an empty array when
+// there is nothing to collide with.
+PackedVector3Array build_collision_shape_faces(Span<const Array> surfaces);
+
 Ref<ConcavePolygonShape3D> create_concave_polygon_shape(Span<const Array> surfaces);
+// Variant taking pre-cooked faces, see `build_collision_shape_faces`
+Ref<ConcavePolygonShape3D> create_concave_polygon_shape(PackedVector3Array face_points);
 
 // This API can be confusing so I made a wrapper
 int get_visible_instance_count(const MultiMesh &mm);
@@ -72,11 +81,48 @@ struct RefHasher {
 	}
 };
 
-void copy_to(Vector<Vector3> &dst, const std::vector<Vector3f> &src);
-void copy_to(Vector<Vector2> &dst, const std::vector<Vector2f> &src);
+template <typename TAllocator>
+void copy_to(Vector<Vector3> &dst, const std::vector<Vector3f, TAllocator> &src) {
+	dst.resize(src.size());
+	// resize can fail in case allocation was not possible
+	ERR_FAIL_COND(dst.size() != static_cast<int>(src.size()));
+
+#ifdef REAL_T_IS_DOUBLE
+	// Convert floats to doubles
+	const unsigned int count = dst.size() * Vector3f::AXIS_COUNT;
+	real_t *dst_w = reinterpret_cast<real_t *>(dst.ptrw());
+	const float *src_r = reinterpret_cast<const float *>(src.data());
+	for (unsigned int i = 0; i < count; ++i) {
+		dst_w[i] = src_r[i];
+	}
+#else
+	static_assert(sizeof(Vector3) == sizeof(Vector3f));
+	memcpy(dst.ptrw(), reinterpret_cast<const Vector3 *>(src.data()), src.size() * sizeof(Vector3f));
+#endif
+}
 
-template <typename T>
-void raw_copy_to(Vector<T> &to, const std::vector<T> &from) {
+template <typename TAllocator>
+void copy_to(Vector<Vector2> &dst, const std::vector<Vector2f, TAllocator> &src) {
+	dst.resize(src.size());
+	// resize can fail in case allocation was not possible
+	ERR_FAIL_COND(dst.size() != static_cast<int>(src.size()));
+
+#ifdef REAL_T_IS_DOUBLE
+	// Convert floats to doubles
+	const unsigned int count = dst.size() * Vector2f::AXIS_COUNT;
+	real_t *dst_w = reinterpret_cast<real_t *>(dst.ptrw());
+	const float *src_r = reinterpret_cast<const float *>(src.data());
+	for (unsigned int i = 0; i < count; ++i) {
+		dst_w[i] = src_r[i];
+	}
+#else
+	static_assert(sizeof(Vector2) == sizeof(Vector2f));
+	memcpy(dst.ptrw(), reinterpret_cast<const Vector2 *>(src.data()), src.size() * sizeof(Vector2f));
+#endif
+}
+
+template <typename T, typename TAllocator>
+void raw_copy_to(Vector<T> &to, const std::vector<T, TAllocator> &from) {
 	to.resize(from.size());
 	// resize can fail in case allocation was not possible
 	ERR_FAIL_COND(from.size() != static_cast<size_t>(to.size()));
@@ -0,0 +1,95 @@
+#include "lightweight_profiler.h"
+#include "errors.h"
+
+#include <core/os/time.h>
+
+#include <cstring>
+
+namespace zylann {
+
+uint16_t LightweightProfiler::register_zone(const char *name) {
+	MutexLock lock(_register_mutex);
+	for (unsigned int i = 0; i < _zone_count; ++i) {
+		if (strcmp(_zones[i].name, name) == 0) {
+			return i;
+		}
+	}
+	ZN_ASSERT_RETURN_V_MSG(_zone_count < MAX_ZONES, 0, "Too many lightweight profiling zones");
+	_zones[_zone_count].name = name;
+	return _zone_count++;
+}
+
+void LightweightProfiler::set_enabled(bool enabled) {
+	if (enabled && !is_enabled()) {
+		// Tick rates vary across machines (and the fallback clock isn't in cycles at all), so the
+		// conversion rate is measured over the enabled period instead of assumed
+		_calibration_ticks = get_ticks();
+		_calibration_usec = Time::get_singleton()->get_ticks_usec();
+	}
+	_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+double LightweightProfiler::get_ticks_per_usec() const {
+	if (_calibration_usec == 0) {
+		return 0.0;
+	}
+	const uint64_t elapsed_usec = Time::get_singleton()->get_ticks_usec() - _calibration_usec;
+	if (elapsed_usec == 0) {
+		return 0.0;
+	}
+	return double(get_ticks() - _calibration_ticks) / double(elapsed_usec);
+}
+
+void LightweightProfiler::get_zone_reports(std::vector<ZoneReport> &out_reports) const {
+	out_reports.clear();
+	const double ticks_per_usec = get_ticks_per_usec();
+	if (ticks_per_usec <= 0.0) {
+		return;
+	}
+	for (unsigned int i = 0; i < _zone_count; ++i) {
+		const Zone &zone = _zones[i];
+		ZoneReport report;
+		report.name = zone.name;
+		report.call_count = zone.call_count.load(std::memory_order_relaxed);
+		report.total_usec = uint64_t(zone.total_ticks.load(std::memory_order_relaxed) / ticks_per_usec);
+		report.max_usec = uint64_t(zone.max_ticks.load(std::memory_order_relaxed) / ticks_per_usec);
+		out_reports.push_back(report);
+	}
+}
+
+void LightweightProfiler::get_recent_events(std::vector<EventReport> &out_events) const {
+	out_events.clear();
+	const double ticks_per_usec = get_ticks_per_usec();
+	if (ticks_per_usec <= 0.0) {
+		return;
+	}
+	const uint64_t now_ticks = get_ticks();
+	// Oldest first. Events written concurrently during the copy may tear, which at worst yields
+	// one nonsensical entry in an incident dump.
+	const uint32_t cursor = _event_cursor.load(std::memory_order_relaxed);
+	for (unsigned int i = 0; i < EVENT_RING_SIZE; ++i) {
+		const Event &event = _events[(cursor + i) % EVENT_RING_SIZE];
+		if (event.end_ticks == 0 || event.zone_id >= _zone_count) {
+			continue;
+		}
+		EventReport report;
+		report.zone_name = _zones[event.zone_id].name;
+		report.age_usec = uint64_t((now_ticks - event.end_ticks) / ticks_per_usec);
+		report.duration_usec = uint64_t(event.duration_ticks / ticks_per_usec);
+		out_events.push_back(report);
+	}
+}
+
+void LightweightProfiler::reset() {
+	for (unsigned int i = 0; i < _zone_count; ++i) {
+		Zone &zone = _zones[i];
+		zone.call_count.store(0, std::memory_order_relaxed);
+		zone.total_ticks.store(0, std::memory_order_relaxed);
+		zone.max_ticks.store(0, std::memory_order_relaxed);
+	}
+	for (unsigned int i = 0; i < EVENT_RING_SIZE; ++i) {
+		_events[i].end_ticks = 0;
+	}
+}
+
+} // namespace zylann
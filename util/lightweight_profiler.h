@@ -0,0 +1,147 @@
+#ifndef ZN_LIGHTWEIGHT_PROFILER_H
+#define ZN_LIGHTWEIGHT_PROFILER_H
+
+#include "fixed_array.h"
+#include "thread/mutex.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+namespace zylann {
+
+// Runtime-toggleable profiling zones for production builds. Tracy zones are compiled out of
+// shipping builds (and profiled builds change timing), which left zero visibility into incidents
+// in the field. This keeps a small fixed set of zones always compiled: when disabled, a scope
+// costs one relaxed atomic load and a branch; when enabled, timestamps come straight from the
+// cycle counter and land in per-zone accumulators plus a lock-free ring of recent events.
+// Reports can be pulled at any time without stopping collection, so an incident can be captured
+// on demand without redeploying.
+class LightweightProfiler {
+public:
+	static const unsigned int MAX_ZONES = 64;
+	static const unsigned int EVENT_RING_SIZE = 4096;
+
+	static LightweightProfiler &get_singleton() {
+		static LightweightProfiler singleton;
+		return singleton;
+	}
+
+	static inline uint64_t get_ticks() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+		return __rdtsc();
+#else
+		return uint64_t(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+	}
+
+	// Idempotent per name; returns a stable zone id. Meant to be called once per call site
+	// through a function-local static (see `ZN_LIGHT_PROFILE_SCOPE`).
+	uint16_t register_zone(const char *name);
+
+	void set_enabled(bool enabled);
+	inline bool is_enabled() const {
+		return _enabled.load(std::memory_order_relaxed);
+	}
+
+	inline void record(uint16_t zone_id, uint64_t ticks) {
+		Zone &zone = _zones[zone_id];
+		zone.call_count.fetch_add(1, std::memory_order_relaxed);
+		zone.total_ticks.fetch_add(ticks, std::memory_order_relaxed);
+		// Racy max update, losing one occasionally only makes the maximum slightly conservative
+		uint64_t max_ticks = zone.max_ticks.load(std::memory_order_relaxed);
+		while (ticks > max_ticks && !zone.max_ticks.compare_exchange_weak(max_ticks, ticks, std::memory_order_relaxed)) {
+		}
+		// Overwriting ring: under contention two threads may claim the same slot, the loss of one
+		// event is irrelevant for incident captures
+		const uint32_t slot = _event_cursor.fetch_add(1, std::memory_order_relaxed) % EVENT_RING_SIZE;
+		Event &event = _events[slot];
+		event.end_ticks = get_ticks();
+		event.duration_ticks = ticks;
+		event.zone_id = zone_id;
+	}
+
+	struct Scope {
+		uint64_t begin_ticks;
+		uint16_t zone_id;
+		bool enabled;
+
+		inline Scope(uint16_t p_zone_id) : zone_id(p_zone_id) {
+			enabled = get_singleton().is_enabled();
+			if (enabled) {
+				begin_ticks = get_ticks();
+			}
+		}
+		inline ~Scope() {
+			if (enabled) {
+				get_singleton().record(zone_id, get_ticks() - begin_ticks);
+			}
+		}
+	};
+
+	struct ZoneReport {
+		const char *name;
+		uint64_t call_count;
+		uint64_t total_usec;
+		uint64_t max_usec;
+	};
+
+	struct EventReport {
+		const char *zone_name;
+		uint64_t age_usec; // How long before the dump the event ended
+		uint64_t duration_usec;
+	};
+
+	// Both reports convert ticks with a rate calibrated between `set_enabled(true)` and the call,
+	// and leave collection running. Zone accumulators are reset by `reset`, not by reporting.
+	void get_zone_reports(std::vector<ZoneReport> &out_reports) const;
+	void get_recent_events(std::vector<EventReport> &out_events) const;
+	void reset();
+
+private:
+	struct Zone {
+		const char *name = nullptr;
+		std::atomic_uint64_t call_count = { 0 };
+		std::atomic_uint64_t total_ticks = { 0 };
+		std::atomic_uint64_t max_ticks = { 0 };
+	};
+
+	struct Event {
+		uint64_t end_ticks = 0;
+		uint64_t duration_ticks = 0;
+		uint16_t zone_id = 0;
+	};
+
+	// Ticks per microsecond measured since enabling; 0 means unknown (disabled since startup)
+	double get_ticks_per_usec() const;
+
+	FixedArray<Zone, MAX_ZONES> _zones;
+	unsigned int _zone_count = 0;
+	Mutex _register_mutex;
+
+	FixedArray<Event, EVENT_RING_SIZE> _events;
+	std::atomic_uint32_t _event_cursor = { 0 };
+
+	std::atomic_bool _enabled = { false };
+	uint64_t _calibration_ticks = 0;
+	uint64_t _calibration_usec = 0;
+};
+
+} // namespace zylann
+
+// Always-compiled profiling scope, see `LightweightProfiler`. The name must be a string literal.
+#define ZN_LIGHT_PROFILE_SCOPE(name)                                                                                   \
+	static const uint16_t zn_lp_zone_id = zylann::LightweightProfiler::get_singleton().register_zone(name);            \
+	zylann::LightweightProfiler::Scope zn_lp_scope(zn_lp_zone_id)
+
+#endif // ZN_LIGHTWEIGHT_PROFILER_H
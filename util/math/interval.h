@@ -2,6 +2,7 @@
 #define ZN_INTERVAL_H
 
 #include "funcs.h"
+#include "interval_simd.h"
 #include <limits>
 
 namespace zylann::math {
@@ -114,11 +115,9 @@ struct Interval {
 	inline Interval operator*(const Interval &other) const {
 		// Note, if the two operands have the same source (i.e you are doing x^2), this may lead to suboptimal results.
 		// You may then prefer using a more dedicated function.
-		const real_t a = min * other.min;
-		const real_t b = min * other.max;
-		const real_t c = max * other.min;
-		const real_t d = max * other.max;
-		return Interval{ math::min(a, b, c, d), math::max(a, b, c, d) };
+		real_t rmin, rmax;
+		min_max_product4(min, max, other.min, other.max, rmin, rmax);
+		return Interval{ rmin, rmax };
 	}
 
 	inline void operator*=(real_t x) {
@@ -138,11 +137,9 @@ struct Interval {
 			// TODO May need something more precise
 			return Interval::from_infinity();
 		}
-		const real_t a = min / other.min;
-		const real_t b = min / other.max;
-		const real_t c = max / other.min;
-		const real_t d = max / other.max;
-		return Interval{ math::min(a, b, c, d), math::max(a, b, c, d) };
+		real_t rmin, rmax;
+		min_max_quotient4(min, max, other.min, other.max, rmin, rmax);
+		return Interval{ rmin, rmax };
 	}
 
 	inline Interval operator/(real_t x) const {
@@ -0,0 +1,115 @@
+#ifndef ZN_INTERVAL_SIMD_H
+#define ZN_INTERVAL_SIMD_H
+
+// SIMD kernels for interval arithmetic. Multiplying or dividing two intervals needs the min and max
+// of the 4 combinations of their bounds; doing the 4 operations and the reduction in one vector
+// keeps range analysis off generation flamegraphs, since it runs per node for every block at every
+// LOD. Every kernel has a scalar fallback so behavior is identical everywhere.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ZN_INTERVAL_SIMD_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define ZN_INTERVAL_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace zylann::math {
+
+// Writes the minimum and maximum of the 4 pairwise products of {a_min, a_max} and {b_min, b_max}.
+inline void min_max_product4(
+		const float a_min, const float a_max, const float b_min, const float b_max, float &out_min, float &out_max) {
+#if defined(ZN_INTERVAL_SIMD_SSE2)
+	const __m128 a = _mm_set_ps(a_max, a_max, a_min, a_min);
+	const __m128 b = _mm_set_ps(b_max, b_min, b_max, b_min);
+	const __m128 p = _mm_mul_ps(a, b);
+	const __m128 swapped = _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 0, 3, 2));
+	const __m128 min2 = _mm_min_ps(p, swapped);
+	const __m128 max2 = _mm_max_ps(p, swapped);
+	out_min = _mm_cvtss_f32(_mm_min_ss(min2, _mm_shuffle_ps(min2, min2, _MM_SHUFFLE(0, 0, 0, 1))));
+	out_max = _mm_cvtss_f32(_mm_max_ss(max2, _mm_shuffle_ps(max2, max2, _MM_SHUFFLE(0, 0, 0, 1))));
+#elif defined(ZN_INTERVAL_SIMD_NEON)
+	const float32x4_t a = { a_min, a_min, a_max, a_max };
+	const float32x4_t b = { b_min, b_max, b_min, b_max };
+	const float32x4_t p = vmulq_f32(a, b);
+	float32x2_t mins = vpmin_f32(vget_low_f32(p), vget_high_f32(p));
+	float32x2_t maxs = vpmax_f32(vget_low_f32(p), vget_high_f32(p));
+	mins = vpmin_f32(mins, mins);
+	maxs = vpmax_f32(maxs, maxs);
+	out_min = vget_lane_f32(mins, 0);
+	out_max = vget_lane_f32(maxs, 0);
+#else
+	const float a = a_min * b_min;
+	const float b2 = a_min * b_max;
+	const float c = a_max * b_min;
+	const float d = a_max * b_max;
+	out_min = a < b2 ? a : b2;
+	out_min = c < out_min ? c : out_min;
+	out_min = d < out_min ? d : out_min;
+	out_max = a > b2 ? a : b2;
+	out_max = c > out_max ? c : out_max;
+	out_max = d > out_max ? d : out_max;
+#endif
+}
+
+// Writes the minimum and maximum of the 4 pairwise quotients of {a_min, a_max} and {b_min, b_max}.
+// The divisor interval must not contain zero, callers handle that case separately.
+inline void min_max_quotient4(
+		const float a_min, const float a_max, const float b_min, const float b_max, float &out_min, float &out_max) {
+#if defined(ZN_INTERVAL_SIMD_SSE2)
+	const __m128 a = _mm_set_ps(a_max, a_max, a_min, a_min);
+	const __m128 b = _mm_set_ps(b_max, b_min, b_max, b_min);
+	const __m128 p = _mm_div_ps(a, b);
+	const __m128 swapped = _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 0, 3, 2));
+	const __m128 min2 = _mm_min_ps(p, swapped);
+	const __m128 max2 = _mm_max_ps(p, swapped);
+	out_min = _mm_cvtss_f32(_mm_min_ss(min2, _mm_shuffle_ps(min2, min2, _MM_SHUFFLE(0, 0, 0, 1))));
+	out_max = _mm_cvtss_f32(_mm_max_ss(max2, _mm_shuffle_ps(max2, max2, _MM_SHUFFLE(0, 0, 0, 1))));
+#else
+	// NEON before ARMv8 has no division instruction, the scalar path is used there
+	const float a = a_min / b_min;
+	const float b2 = a_min / b_max;
+	const float c = a_max / b_min;
+	const float d = a_max / b_max;
+	out_min = a < b2 ? a : b2;
+	out_min = c < out_min ? c : out_min;
+	out_min = d < out_min ? d : out_min;
+	out_max = a > b2 ? a : b2;
+	out_max = c > out_max ? c : out_max;
+	out_max = d > out_max ? d : out_max;
+#endif
+}
+
+// Double-precision builds (REAL_T_IS_DOUBLE) use the scalar path.
+
+inline void min_max_product4(const double a_min, const double a_max, const double b_min, const double b_max,
+		double &out_min, double &out_max) {
+	const double a = a_min * b_min;
+	const double b2 = a_min * b_max;
+	const double c = a_max * b_min;
+	const double d = a_max * b_max;
+	out_min = a < b2 ? a : b2;
+	out_min = c < out_min ? c : out_min;
+	out_min = d < out_min ? d : out_min;
+	out_max = a > b2 ? a : b2;
+	out_max = c > out_max ? c : out_max;
+	out_max = d > out_max ? d : out_max;
+}
+
+inline void min_max_quotient4(const double a_min, const double a_max, const double b_min, const double b_max,
+		double &out_min, double &out_max) {
+	const double a = a_min / b_min;
+	const double b2 = a_min / b_max;
+	const double c = a_max / b_min;
+	const double d = a_max / b_max;
+	out_min = a < b2 ? a : b2;
+	out_min = c < out_min ? c : out_min;
+	out_min = d < out_min ? d : out_min;
+	out_max = a > b2 ? a : b2;
+	out_max = c > out_max ? c : out_max;
+	out_max = d > out_max ? d : out_max;
+}
+
+} // namespace zylann::math
+
+#endif // ZN_INTERVAL_SIMD_H
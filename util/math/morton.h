@@ -0,0 +1,43 @@
+#ifndef ZN_MATH_MORTON_H
+#define ZN_MATH_MORTON_H
+
+#include <cstdint>
+
+namespace zylann::math {
+
+// 3D Morton (Z-order curve) encoding.
+// Interleaving coordinate bits keeps values of spatially close cells close in memory,
+// which improves cache hit rate when gathering small 3D neighborhoods.
+// 10 bits per axis, so coordinates must be below 1024.
+
+inline uint32_t morton3_part(uint32_t x) {
+	x &= 0x3ff;
+	x = (x | (x << 16)) & 0x030000ff;
+	x = (x | (x << 8)) & 0x0300f00f;
+	x = (x | (x << 4)) & 0x030c30c3;
+	x = (x | (x << 2)) & 0x09249249;
+	return x;
+}
+
+inline uint32_t morton3_unpart(uint32_t x) {
+	x &= 0x09249249;
+	x = (x | (x >> 2)) & 0x030c30c3;
+	x = (x | (x >> 4)) & 0x0300f00f;
+	x = (x | (x >> 8)) & 0x030000ff;
+	x = (x | (x >> 16)) & 0x000003ff;
+	return x;
+}
+
+inline uint32_t morton3(uint32_t x, uint32_t y, uint32_t z) {
+	return morton3_part(x) | (morton3_part(y) << 1) | (morton3_part(z) << 2);
+}
+
+inline void morton3_decode(uint32_t m, uint32_t &x, uint32_t &y, uint32_t &z) {
+	x = morton3_unpart(m);
+	y = morton3_unpart(m >> 1);
+	z = morton3_unpart(m >> 2);
+}
+
+} // namespace zylann::math
+
+#endif // ZN_MATH_MORTON_H
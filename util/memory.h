@@ -2,6 +2,8 @@
 #define ZYLANN_MEMORY_H
 
 #include <memory>
+#include <new>
+#include <vector>
 
 // Default new and delete operators.
 #ifdef ZN_GODOT
@@ -28,6 +30,47 @@
 
 namespace zylann {
 
+// STL-compatible allocator aligning storage to `Alignment` bytes. For containers whose contents
+// get processed with SIMD loads, where aligned addresses avoid peeling prologues.
+template <typename T, size_t Alignment>
+struct AlignedAllocator {
+	static_assert((Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+	static_assert(Alignment >= alignof(T), "Alignment must not be weaker than the type's");
+
+	using value_type = T;
+
+	AlignedAllocator() noexcept = default;
+
+	template <typename U>
+	AlignedAllocator(const AlignedAllocator<U, Alignment> &) noexcept {}
+
+	T *allocate(size_t n) {
+		return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+	}
+
+	void deallocate(T *p, size_t n) {
+		::operator delete(p, std::align_val_t(Alignment));
+	}
+
+	template <typename U>
+	struct rebind {
+		using other = AlignedAllocator<U, Alignment>;
+	};
+
+	template <typename U>
+	bool operator==(const AlignedAllocator<U, Alignment> &) const noexcept {
+		return true;
+	}
+	template <typename U>
+	bool operator!=(const AlignedAllocator<U, Alignment> &) const noexcept {
+		return false;
+	}
+};
+
+// Vector whose storage starts on a 32-byte boundary (one AVX register / half a cache line)
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T, 32>>;
+
 // Default, engine-agnostic implementation of unique pointers for this project. Allows to change it in one place.
 // Note: array allocations are not used at the moment. Containers are preferred.
 
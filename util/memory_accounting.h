@@ -0,0 +1,111 @@
+#ifndef ZYLANN_MEMORY_ACCOUNTING_H
+#define ZYLANN_MEMORY_ACCOUNTING_H
+
+#include "math/funcs.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace zylann {
+
+// Per-subsystem memory accounting, for attributing memory in production crashes (OOM triage on
+// memory-constrained platforms). Subsystems report their allocations at their choke points; each
+// category keeps a current total and an all-time peak. Updates are relaxed atomics, cheap enough
+// to stay enabled in release builds. This intentionally doesn't hook every `ZN_ALLOC`: the
+// wrappers carry no category, and the handful of subsystems that dominate memory all have
+// central points where sizes are known.
+class MemoryAccounting {
+public:
+	enum Category : uint8_t {
+		CATEGORY_VOXEL_BUFFERS = 0, // Pooled and non-pooled voxel block memory
+		CATEGORY_CACHES, // Compressed cold blocks, generated-block cache and similar tiers
+		CATEGORY_MESHING, // Mesh outputs held between build and upload
+		CATEGORY_STREAMING, // Serialization buffers and stream-side staging
+		CATEGORY_INSTANCING, // Instance data and prepared transform sets
+		CATEGORY_COUNT
+	};
+
+	static MemoryAccounting &get_singleton() {
+		static MemoryAccounting singleton;
+		return singleton;
+	}
+
+	static const char *get_category_name(Category category) {
+		switch (category) {
+			case CATEGORY_VOXEL_BUFFERS:
+				return "voxel_buffers";
+			case CATEGORY_CACHES:
+				return "caches";
+			case CATEGORY_MESHING:
+				return "meshing";
+			case CATEGORY_STREAMING:
+				return "streaming";
+			case CATEGORY_INSTANCING:
+				return "instancing";
+			default:
+				return "unknown";
+		}
+	}
+
+	inline void add(Category category, size_t bytes) {
+		Entry &entry = _entries[category];
+		const size_t current = entry.current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+		// Racy max update; losing an update once in a while only makes the peak marginally
+		// conservative, which is fine for triage
+		size_t peak = entry.peak.load(std::memory_order_relaxed);
+		while (current > peak && !entry.peak.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+		}
+		tls_task_current += bytes;
+		if (tls_task_current > tls_task_peak) {
+			tls_task_peak = tls_task_current;
+		}
+	}
+
+	inline void remove(Category category, size_t bytes) {
+		_entries[category].current.fetch_sub(bytes, std::memory_order_relaxed);
+		// Frees often happen on a different thread than the allocation (buffers commonly die on
+		// the main thread), so the thread-local balance is clamped instead of trusted to zero out
+		tls_task_current -= math::min(bytes, tls_task_current);
+	}
+
+	// Per-thread task watermark: worker threads reset it before running each task, then the task
+	// samples the peak when it finishes, attributing allocation spikes to a task type. Only
+	// categorized allocations performed by the running thread are seen, which covers the
+	// subsystems that dominate memory.
+	static void begin_thread_task_scope() {
+		tls_task_current = 0;
+		tls_task_peak = 0;
+	}
+	static size_t get_thread_task_peak_bytes() {
+		return tls_task_peak;
+	}
+
+	struct Report {
+		size_t current = 0;
+		size_t peak = 0;
+	};
+
+	Report get_report(Category category) const {
+		const Entry &entry = _entries[category];
+		Report report;
+		report.current = entry.current.load(std::memory_order_relaxed);
+		report.peak = entry.peak.load(std::memory_order_relaxed);
+		return report;
+	}
+
+private:
+	struct Entry {
+		std::atomic<size_t> current = { 0 };
+		std::atomic<size_t> peak = { 0 };
+	};
+
+	Entry _entries[CATEGORY_COUNT];
+
+	static inline thread_local size_t tls_task_current = 0;
+	static inline thread_local size_t tls_task_peak = 0;
+};
+
+} // namespace zylann
+
+#endif // ZYLANN_MEMORY_ACCOUNTING_H
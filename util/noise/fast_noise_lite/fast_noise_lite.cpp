@@ -1,4 +1,5 @@
 #include "fast_noise_lite.h"
+#include "../../errors.h"
 #include "../../math/funcs.h"
 #include <core/core_string_names.h>
 
@@ -363,4 +364,45 @@ void ZN_FastNoiseLite::_bind_methods() {
 	BIND_ENUM_CONSTANT(CELLULAR_RETURN_DISTANCE_2_DIV);
 }
 
+void ZN_FastNoiseLite::get_noise_2d_series(Span<const float> src_x, Span<const float> src_y, Span<float> dst) const {
+	ZN_ASSERT_RETURN(src_x.size() == dst.size() && src_y.size() == dst.size());
+
+	if (_warp_noise.is_valid()) {
+		const ZN_FastNoiseLiteGradient &warp_noise = **_warp_noise;
+		for (unsigned int i = 0; i < dst.size(); ++i) {
+			real_t x = src_x[i];
+			real_t y = src_y[i];
+			warp_noise.warp_2d(x, y);
+			dst[i] = _fn.GetNoise(x, y);
+		}
+
+	} else {
+		// Tight loop over the series, no per-sample warp check or dispatch
+		for (unsigned int i = 0; i < dst.size(); ++i) {
+			dst[i] = _fn.GetNoise(src_x[i], src_y[i]);
+		}
+	}
+}
+
+void ZN_FastNoiseLite::get_noise_3d_series(
+		Span<const float> src_x, Span<const float> src_y, Span<const float> src_z, Span<float> dst) const {
+	ZN_ASSERT_RETURN(src_x.size() == dst.size() && src_y.size() == dst.size() && src_z.size() == dst.size());
+
+	if (_warp_noise.is_valid()) {
+		const ZN_FastNoiseLiteGradient &warp_noise = **_warp_noise;
+		for (unsigned int i = 0; i < dst.size(); ++i) {
+			real_t x = src_x[i];
+			real_t y = src_y[i];
+			real_t z = src_z[i];
+			warp_noise.warp_3d(x, y, z);
+			dst[i] = _fn.GetNoise(x, y, z);
+		}
+
+	} else {
+		for (unsigned int i = 0; i < dst.size(); ++i) {
+			dst[i] = _fn.GetNoise(src_x[i], src_y[i], src_z[i]);
+		}
+	}
+}
+
 } // namespace zylann
@@ -3,6 +3,7 @@
 
 #include <core/io/resource.h>
 
+#include "../../span.h"
 #include "fast_noise_lite_gradient.h"
 
 namespace zylann {
@@ -138,6 +139,14 @@ public:
 		return _fn.GetNoise(x, y, z);
 	}
 
+	// Batched SoA evaluation over coordinate series, like the buffers `VoxelGraphRuntime`
+	// processes. The warp check and object dispatch are hoisted out of the loop and whole series
+	// are handed to the optimizer, instead of paying per-sample call overhead.
+	// All spans must have the same length.
+	void get_noise_2d_series(Span<const float> src_x, Span<const float> src_y, Span<float> dst) const;
+	void get_noise_3d_series(
+			Span<const float> src_x, Span<const float> src_y, Span<const float> src_z, Span<float> dst) const;
+
 	// TODO Have a separate cell noise? It outputs multiple things, but we only get one.
 	// To get the others the API forces to calculate it a second time, and it's the most expensive noise...
 
@@ -2,6 +2,7 @@
 #define OBJECT_POOL_H
 
 #include "memory.h"
+#include "thread/mutex.h"
 #include <vector>
 
 namespace zylann {
@@ -24,6 +25,19 @@ public:
 		_objects.push_back(obj);
 	}
 
+	// Moves up to `count` pooled free objects into `dst`. Lets fork-join users seed task-local
+	// pools from a shared one, so parallel passes don't re-allocate what the shared pool already
+	// holds. Returns how many were moved.
+	unsigned int transfer_to(ObjectPool<T> &dst, unsigned int count) {
+		unsigned int moved = 0;
+		while (moved < count && !_objects.empty()) {
+			dst._objects.push_back(_objects.back());
+			_objects.pop_back();
+			++moved;
+		}
+		return moved;
+	}
+
 	~ObjectPool() {
 		for (T *obj : _objects) {
 			ZN_DELETE(obj);
@@ -34,6 +48,40 @@ private:
 	std::vector<T *> _objects;
 };
 
+// Variant of `ObjectPool` usable from multiple threads. Objects can be created and recycled from
+// any thread; `init()` runs on recycle like in `ObjectPool`.
+template <class T>
+class ThreadSafeObjectPool {
+public:
+	T *create() {
+		{
+			MutexLock lock(_mutex);
+			if (!_objects.empty()) {
+				T *obj = _objects.back();
+				_objects.pop_back();
+				return obj;
+			}
+		}
+		return ZN_NEW(T);
+	}
+
+	void recycle(T *obj) {
+		obj->init();
+		MutexLock lock(_mutex);
+		_objects.push_back(obj);
+	}
+
+	~ThreadSafeObjectPool() {
+		for (T *obj : _objects) {
+			ZN_DELETE(obj);
+		}
+	}
+
+private:
+	Mutex _mutex;
+	std::vector<T *> _objects;
+};
+
 } // namespace zylann
 
 #endif // OBJECT_POOL_H
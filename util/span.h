@@ -116,8 +116,8 @@ private:
 	size_t _size;
 };
 
-template <typename T>
-Span<T> to_span(std::vector<T> &vec) {
+template <typename T, typename TAllocator>
+Span<T> to_span(std::vector<T, TAllocator> &vec) {
 	return Span<T>(vec.data(), 0, vec.size());
 }
 
@@ -128,8 +128,8 @@ Span<const T> const_span_from_position_and_size(const std::vector<T> &vec, unsig
 }
 
 // TODO Deprecate, now Span has a conversion constructor that can allow doing that
-template <typename T>
-Span<const T> to_span_const(const std::vector<T> &vec) {
+template <typename T, typename TAllocator>
+Span<const T> to_span_const(const std::vector<T, TAllocator> &vec) {
 	return Span<const T>(vec.data(), 0, vec.size());
 }
 
@@ -9,15 +9,25 @@ namespace zylann {
 // Stores uniquely-identified structs in a packed array.
 // Always use the IDs if you want to store a reference somewhere. Addresses aren't stable.
 // IDs are made unique with a generation system.
+// Internally a sparse index maps IDs to a dense array with swap-remove semantics: iteration
+// touches only live entries contiguously, and creation/removal are O(1) (free slots are kept in
+// a list instead of scanned for). With many small registrations (hundreds of prop volumes),
+// per-tick iteration cost follows population, not peak capacity.
 template <typename T>
 class StructDB {
 private:
-	struct Slot {
-		T data;
+	struct IndexSlot {
+		uint32_t dense_index = 0;
 		uint16_t version = 0;
 		bool valid = false;
 	};
 
+	struct DenseItem {
+		T data;
+		// Back-reference to the index slot, so swap-removal can fix it up
+		uint16_t index_slot;
+	};
+
 public:
 	static const uint16_t MAX_INDEX = 0xffff;
 	static const uint16_t MAX_VERSION = 0xffff;
@@ -36,156 +46,147 @@ public:
 
 	inline T &get(uint32_t id) {
 		const uint16_t i = get_index(id);
-		ZN_ASSERT(i < _slots.size());
-		const uint16_t v = get_version(id);
-		Slot &s = _slots[i];
-		ZN_ASSERT(s.version == v);
+		ZN_ASSERT(i < _index.size());
+		IndexSlot &s = _index[i];
+		ZN_ASSERT(s.version == get_version(id));
 		ZN_ASSERT(s.valid);
-		return s.data;
+		return _dense[s.dense_index].data;
 	}
 
 	inline const T &get(uint32_t id) const {
 		const uint16_t i = get_index(id);
-		ZN_ASSERT(i < _slots.size());
-		const uint16_t v = get_version(id);
-		const Slot &s = _slots[i];
-		ZN_ASSERT(s.version == v);
+		ZN_ASSERT(i < _index.size());
+		const IndexSlot &s = _index[i];
+		ZN_ASSERT(s.version == get_version(id));
 		ZN_ASSERT(s.valid);
-		return s.data;
+		return _dense[s.dense_index].data;
 	}
 
 	inline T *try_get(uint32_t id) {
 		const uint16_t i = get_index(id);
-		if (i >= _slots.size()) {
+		if (i >= _index.size()) {
 			return nullptr;
 		}
-		const uint16_t v = get_version(id);
-		Slot &s = _slots[i];
-		if (s.version != v || s.valid == false) {
+		IndexSlot &s = _index[i];
+		if (s.version != get_version(id) || s.valid == false) {
 			return nullptr;
 		}
-		return &s.data;
+		return &_dense[s.dense_index].data;
 	}
 
 	inline const T *try_get(uint32_t id) const {
 		const uint16_t i = get_index(id);
-		if (i >= _slots.size()) {
+		if (i >= _index.size()) {
 			return nullptr;
 		}
-		const uint16_t v = get_version(id);
-		const Slot &s = _slots[i];
-		if (s.version != v) {
+		const IndexSlot &s = _index[i];
+		if (s.version != get_version(id) || s.valid == false) {
 			return nullptr;
 		}
-		return &s.data;
+		return &_dense[s.dense_index].data;
 	}
 
 	inline uint32_t create(T data) {
-		uint16_t i = find_free_index();
+		uint16_t i;
 		uint16_t v;
-		if (i == _slots.size()) {
-			ZN_ASSERT(i != MAX_INDEX);
-			v = 0;
-			Slot s;
-			s.data = data;
-			s.valid = true;
+		if (_free_indices.size() > 0) {
+			i = _free_indices.back();
+			_free_indices.pop_back();
+			IndexSlot &s = _index[i];
+			ZN_ASSERT(s.version != MAX_VERSION);
+			v = s.version + 1;
 			s.version = v;
-			_slots.push_back(s);
+			s.valid = true;
+			s.dense_index = _dense.size();
 		} else {
-			Slot &s = _slots[i];
-			ZN_ASSERT(s.version != MAX_VERSION);
-			s.data = data;
+			ZN_ASSERT(_index.size() != MAX_INDEX);
+			i = _index.size();
+			v = 0;
+			IndexSlot s;
 			s.valid = true;
-			v = s.version + 1;
 			s.version = v;
+			s.dense_index = _dense.size();
+			_index.push_back(s);
 		}
+		DenseItem item;
+		item.data = data;
+		item.index_slot = i;
+		_dense.push_back(item);
 		return make_id(i, v);
 	}
 
 	inline void destroy(uint32_t id) {
 		const uint16_t i = get_index(id);
-		ZN_ASSERT(i < _slots.size());
-		Slot &s = _slots[i];
+		ZN_ASSERT(i < _index.size());
+		IndexSlot &s = _index[i];
 		ZN_ASSERT(s.valid);
-		s.data = T();
+
+		// Swap-remove in the dense array, fixing the moved item's index slot
+		const uint32_t dense_index = s.dense_index;
+		const uint32_t last_index = _dense.size() - 1;
+		if (dense_index != last_index) {
+			_dense[dense_index] = std::move(_dense[last_index]);
+			_index[_dense[dense_index].index_slot].dense_index = dense_index;
+		}
+		_dense.pop_back();
+
 		s.valid = false;
+		_free_indices.push_back(i);
 	}
 
 	inline bool is_valid(uint32_t id) const {
 		const uint16_t i = get_index(id);
-		if (i >= _slots.size()) {
+		if (i >= _index.size()) {
 			return false;
 		}
-		const Slot &s = _slots[i];
+		const IndexSlot &s = _index[i];
 		return s.valid && s.version == get_version(id);
 	}
 
 	inline uint32_t count() const {
-		uint32_t c = 0;
-		for (size_t i = 0; i < _slots.size(); ++i) {
-			const Slot &s = _slots[i];
-			if (s.valid) {
-				++c;
-			}
-		}
-		return c;
+		return _dense.size();
 	}
 
 	template <typename F>
 	inline void for_each(F f) {
-		for (size_t i = 0; i < _slots.size(); ++i) {
-			Slot &s = _slots[i];
-			if (s.valid) {
-				f(s.data);
-			}
+		for (size_t i = 0; i < _dense.size(); ++i) {
+			f(_dense[i].data);
 		}
 	}
 
 	template <typename F>
 	inline void for_each(F f) const {
-		for (size_t i = 0; i < _slots.size(); ++i) {
-			const Slot &s = _slots[i];
-			if (s.valid) {
-				f(s.data);
-			}
+		for (size_t i = 0; i < _dense.size(); ++i) {
+			f(_dense[i].data);
 		}
 	}
 
 	template <typename F>
 	inline void for_each_with_id(F f) {
-		for (size_t i = 0; i < _slots.size(); ++i) {
-			Slot &s = _slots[i];
-			if (s.valid) {
-				f(s.data, make_id(i, s.version));
-			}
+		for (size_t i = 0; i < _dense.size(); ++i) {
+			DenseItem &item = _dense[i];
+			f(item.data, make_id(item.index_slot, _index[item.index_slot].version));
 		}
 	}
 
 	template <typename F>
 	inline void for_each_with_id(F f) const {
-		for (size_t i = 0; i < _slots.size(); ++i) {
-			const Slot &s = _slots[i];
-			if (s.valid) {
-				f(s.data, make_id(i, s.version));
-			}
+		for (size_t i = 0; i < _dense.size(); ++i) {
+			const DenseItem &item = _dense[i];
+			f(item.data, make_id(item.index_slot, _index[item.index_slot].version));
 		}
 	}
 
 	inline void clear() {
-		_slots.clear();
+		_index.clear();
+		_dense.clear();
+		_free_indices.clear();
 	}
 
 private:
-	inline size_t find_free_index() const {
-		for (size_t i = 0; i < _slots.size(); ++i) {
-			if (_slots[i].valid == false) {
-				return i;
-			}
-		}
-		return _slots.size();
-	}
-
-	std::vector<Slot> _slots;
+	std::vector<IndexSlot> _index;
+	std::vector<DenseItem> _dense;
+	std::vector<uint16_t> _free_indices;
 };
 
 } // namespace zylann
@@ -1,5 +1,5 @@
 #include "async_dependency_tracker.h"
-#include "../memory.h"
+#include "threaded_task.h"
 #include "threaded_task_runner.h"
 
 namespace zylann {
@@ -29,19 +29,18 @@ AsyncDependencyTracker::AsyncDependencyTracker(
 AsyncDependencyTracker::~AsyncDependencyTracker() {
 	for (auto it = _next_tasks.begin(); it != _next_tasks.end(); ++it) {
 		IThreadedTask *task = *it;
-		// TODO Might want to allow customizing that, maybe calling a `->dispose()` function instead?
-		ZN_DELETE(task);
+		// Pooled tasks go back to their pool, others get deleted
+		task->dispose();
 	}
 }
 
 void AsyncDependencyTracker::post_complete() {
 	ZN_ASSERT_RETURN_MSG(_count > 0, "post_complete() called more times than expected");
-	ZN_ASSERT_RETURN_MSG(_aborted == false, "post_complete() called after abortion");
-	--_count;
-	// Note, this class only allows decrementing this counter up to zero
-	if (_count == 0) {
-		_next_tasks_schedule_callback(to_span(_next_tasks));
-		_next_tasks.clear();
+	// `fetch_sub` so only the thread completing the LAST dependency flushes, even when several
+	// complete concurrently
+	if (_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		MutexLock lock(_next_tasks_mutex);
+		flush_next_tasks_locked();
 	}
 	// The idea of putting next tasks inside this class instead of the tasks directly,
 	// is because it would require such tasks to do the job, but also because when waiting for multiple tasks,
@@ -49,4 +48,45 @@ void AsyncDependencyTracker::post_complete() {
 	// Putting next tasks in the tracker instead has a clear unique ownership.
 }
 
+void AsyncDependencyTracker::abort() {
+	_aborted = true;
+	// Cancellation propagates by disposing pending continuations right away, rather than leaving
+	// them parked until the tracker dies
+	MutexLock lock(_next_tasks_mutex);
+	for (auto it = _next_tasks.begin(); it != _next_tasks.end(); ++it) {
+		(*it)->dispose();
+	}
+	_next_tasks.clear();
+}
+
+void AsyncDependencyTracker::add_next_task(IThreadedTask *task) {
+	ZN_ASSERT_RETURN(task != nullptr);
+	ZN_ASSERT_RETURN_MSG(_next_tasks_schedule_callback != nullptr,
+			"Continuations require a scheduler callback, use the other constructor");
+
+	MutexLock lock(_next_tasks_mutex);
+	if (_aborted) {
+		task->dispose();
+		return;
+	}
+	if (_count.load(std::memory_order_acquire) == 0) {
+		// Dependencies already completed, run it now
+		_next_tasks_schedule_callback(Span<IThreadedTask *>(&task, 1));
+		return;
+	}
+	_next_tasks.push_back(task);
+}
+
+// The caller must hold `_next_tasks_mutex`
+void AsyncDependencyTracker::flush_next_tasks_locked() {
+	if (_aborted) {
+		for (auto it = _next_tasks.begin(); it != _next_tasks.end(); ++it) {
+			(*it)->dispose();
+		}
+	} else if (_next_tasks.size() > 0) {
+		_next_tasks_schedule_callback(to_span(_next_tasks));
+	}
+	_next_tasks.clear();
+}
+
 } // namespace zylann
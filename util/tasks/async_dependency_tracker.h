@@ -2,6 +2,7 @@
 #define ZYLANN_ASYNC_DEPENDENCY_TRACKER_H
 
 #include "../span.h"
+#include "../thread/mutex.h"
 #include <atomic>
 #include <vector>
 
@@ -9,7 +10,10 @@ namespace zylann {
 
 class IThreadedTask;
 
-// Tracks the status of one or more tasks.
+// Tracks the status of one or more tasks, and chains continuations to them: registered next
+// tasks auto-enqueue the moment the last dependency completes, from whichever thread that was,
+// so multi-stage pipelines don't pay a main-thread polling round-trip between stages. Aborting
+// disposes pending continuations immediately.
 class AsyncDependencyTracker {
 public:
 	// Creates a tracker which will track `initial_count` tasks.
@@ -28,10 +32,15 @@ public:
 	// Call this when one of the tracked dependencies is complete
 	void post_complete();
 
-	// Call this when one of the tracked dependencies is aborted
-	void abort() {
-		_aborted = true;
-	}
+	// Call this when one of the tracked dependencies is aborted. Pending continuation tasks are
+	// disposed immediately, propagating the cancellation down the chain.
+	void abort();
+
+	// Registers a continuation to auto-enqueue when the remaining count reaches zero. Safe to
+	// call while dependencies are completing on other threads: if they already all completed, the
+	// task is scheduled immediately; if the tracker was aborted, the task is disposed.
+	// Requires the tracker to have been created with a scheduler callback.
+	void add_next_task(IThreadedTask *task);
 
 	// Returns `true` if any of the tracked tasks was aborted.
 	// It usually means tasks depending on this tracker may be aborted as well.
@@ -53,8 +62,12 @@ public:
 	}
 
 private:
+	void flush_next_tasks_locked();
+
 	std::atomic_int _count;
 	std::atomic_bool _aborted;
+	// Protects `_next_tasks`; completions, registrations and aborts can race
+	Mutex _next_tasks_mutex;
 	std::vector<IThreadedTask *> _next_tasks;
 	ScheduleNextTasksCallback _next_tasks_schedule_callback = nullptr;
 };
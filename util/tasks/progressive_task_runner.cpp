@@ -4,56 +4,92 @@
 
 #include <core/os/time.h>
 
+#include <algorithm>
+
 namespace zylann {
 
 ProgressiveTaskRunner::~ProgressiveTaskRunner() {
 	flush();
-	ZN_ASSERT_RETURN_MSG(_tasks.size() == 0, "Tasks got created in destructors?");
+	ZN_ASSERT_RETURN_MSG(get_pending_count() == 0, "Tasks got created in destructors?");
 }
 
 void ProgressiveTaskRunner::push(IProgressiveTask *task) {
+	push(task, COMPLETION_TIME_MSEC);
+}
+
+void ProgressiveTaskRunner::push(IProgressiveTask *task, uint32_t lead_time_msec) {
 	ZN_ASSERT_RETURN(task != nullptr);
-	_tasks.push(task);
+	task->_due_time_msec = uint32_t(Time::get_singleton()->get_ticks_msec()) + lead_time_msec;
+	// Lock-free MPSC publish
+	IProgressiveTask *head = _incoming.load(std::memory_order_relaxed);
+	do {
+		task->_next = head;
+	} while (!_incoming.compare_exchange_weak(head, task, std::memory_order_release, std::memory_order_relaxed));
+	_pending_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ProgressiveTaskRunner::drain_incoming() {
+	IProgressiveTask *node = _incoming.exchange(nullptr, std::memory_order_acquire);
+	while (node != nullptr) {
+		IProgressiveTask *next = node->_next;
+		node->_next = nullptr;
+		_heap.push_back(node);
+		std::push_heap(_heap.begin(), _heap.end(), DeadlineGreater());
+		node = next;
+	}
 }
 
 void ProgressiveTaskRunner::process() {
+	drain_incoming();
+
 	const int64_t now_msec = Time::get_singleton()->get_ticks_msec();
 	const int64_t delta_msec = now_msec - _last_process_time_msec;
 	_last_process_time_msec = now_msec;
 	ZN_ASSERT_RETURN(delta_msec >= 0);
 
-	// The goal is to dequeue everything in S seconds.
+	// The goal is to dequeue everything within the completion time.
 	// So if we have N tasks and `process` is called F times per second, we must dequeue N / (S * F) tasks.
-	// Or put it another way, if we call `process` every D seconds, we must dequeue (D * N) / S tasks.
 	// We make sure a minimum amount is run so it cannot be stuck at 0.
 	// As the number of pending tasks decreases, we want to keep running the highest amount we calculated.
-	// we reset when we are done.
-
-	_dequeue_count = math::max(int64_t(_dequeue_count), (int64_t(_tasks.size()) * delta_msec) / COMPLETION_TIME_MSEC);
-	_dequeue_count = math::min(_dequeue_count, math::max(MIN_COUNT, static_cast<unsigned int>(_tasks.size())));
+	_dequeue_count = math::max(int64_t(_dequeue_count), (int64_t(_heap.size()) * delta_msec) / COMPLETION_TIME_MSEC);
+	_dequeue_count = math::min(_dequeue_count, math::max(MIN_COUNT, static_cast<unsigned int>(_heap.size())));
 
+	const uint32_t now32 = uint32_t(now_msec);
 	unsigned int count = _dequeue_count;
-	while (_tasks.size() > 0 && count > 0) {
-		IProgressiveTask *task = _tasks.front();
-		_tasks.pop();
+	while (_heap.size() > 0) {
+		IProgressiveTask *task = _heap.front();
+		// Tasks past their deadline run even when the per-frame amount is exhausted, so a flood
+		// of cheap tasks can never starve the occasional important one behind them
+		const bool overdue = int32_t(now32 - task->_due_time_msec) >= 0;
+		if (count == 0 && !overdue) {
+			break;
+		}
+		std::pop_heap(_heap.begin(), _heap.end(), DeadlineGreater());
+		_heap.pop_back();
 		task->run();
 		// TODO Call recycling function instead?
 		memdelete(task);
-		--count;
+		_pending_count.fetch_sub(1, std::memory_order_relaxed);
+		if (count > 0) {
+			--count;
+		}
 	}
 }
 
 void ProgressiveTaskRunner::flush() {
-	while (!_tasks.empty()) {
-		IProgressiveTask *task = _tasks.front();
-		_tasks.pop();
+	drain_incoming();
+	while (_heap.size() > 0) {
+		IProgressiveTask *task = _heap.front();
+		std::pop_heap(_heap.begin(), _heap.end(), DeadlineGreater());
+		_heap.pop_back();
 		task->run();
 		memdelete(task);
+		_pending_count.fetch_sub(1, std::memory_order_relaxed);
 	}
 }
 
 unsigned int ProgressiveTaskRunner::get_pending_count() const {
-	return _tasks.size();
+	return _pending_count.load(std::memory_order_relaxed);
 }
 
 } // namespace zylann
@@ -1,8 +1,9 @@
 #ifndef ZYLANN_PROGRESSIVE_TASK_RUNNER_H
 #define ZYLANN_PROGRESSIVE_TASK_RUNNER_H
 
+#include <atomic>
 #include <cstdint>
-#include <queue>
+#include <vector>
 
 namespace zylann {
 
@@ -13,24 +14,35 @@ namespace zylann {
 // I hate this workaround because it feels like we are almost not in control of a stable framerate.
 // "Make less meshes" is not enough, if it can't be dynamically adressed.
 
+class ProgressiveTaskRunner;
+
 class IProgressiveTask {
 public:
 	virtual ~IProgressiveTask() {}
 	virtual void run() = 0;
+
+private:
+	friend class ProgressiveTaskRunner;
+	// Intrusive scheduling state managed by ProgressiveTaskRunner
+	IProgressiveTask *_next = nullptr;
+	uint32_t _due_time_msec = 0;
 };
 
-// Runs a certain amount of tasks per frame such that all tasks should be completed in N seconds.
-// This has the effect of spreading the load over time and avoids CPU spikes.
-// This can be used in place of a time-slicing runner when the duration of tasks cannot be used as a cost metric.
-// This is the case of tasks that defer their workload to another system to run later. It is far from perfect though,
-// and is a last resort solution when optimization and threading are not possible.
-// Such tasks may preferably not require low latency in the game,
-// because they will likely run a bit later than a time-sliced task.
+// Spreads tasks over frames so deferred costs don't spike. Every task carries a deadline
+// (defaulting to half a second after it was pushed); each frame the runner executes tasks in
+// earliest-deadline order up to an adaptive per-frame amount, and tasks past their deadline run
+// regardless of it. Long queues of cheap tasks therefore can't starve occasional important ones
+// pushed behind them, which used to let dirty state grow without bound.
+// This can be used in place of a time-slicing runner when the duration of tasks cannot be used as
+// a cost metric, like tasks that defer their workload to another system to run later.
+// `push` is lock-free and may be called from any thread; `process` and `flush` must be called by
+// a single consumer thread (the main thread).
 class ProgressiveTaskRunner {
 public:
 	~ProgressiveTaskRunner();
 
 	void push(IProgressiveTask *task);
+	void push(IProgressiveTask *task, uint32_t lead_time_msec);
 	void process();
 	void flush();
 	unsigned int get_pending_count() const;
@@ -39,7 +51,21 @@ private:
 	static const unsigned int MIN_COUNT = 4;
 	static const unsigned int COMPLETION_TIME_MSEC = 500;
 
-	std::queue<IProgressiveTask *> _tasks;
+	void drain_incoming();
+
+	// Wrap-safe earliest-deadline-first ordering for the heap
+	struct DeadlineGreater {
+		inline bool operator()(const IProgressiveTask *a, const IProgressiveTask *b) const {
+			return int32_t(a->_due_time_msec - b->_due_time_msec) > 0;
+		}
+	};
+
+	// Producers publish onto this intrusive stack with atomic exchanges (MPSC); ordering is
+	// irrelevant here since the consumer re-orders by deadline
+	std::atomic<IProgressiveTask *> _incoming = { nullptr };
+	// Consumer-side min-heap by due time
+	std::vector<IProgressiveTask *> _heap;
+	std::atomic_uint32_t _pending_count = { 0 };
 	unsigned int _dequeue_count = MIN_COUNT;
 	int64_t _last_process_time_msec = 0;
 };
@@ -1,6 +1,8 @@
 #ifndef THREADED_TASK_H
 #define THREADED_TASK_H
 
+#include "../memory.h"
+
 #include <cstdint>
 
 namespace zylann {
@@ -30,10 +32,36 @@ public:
 		return 0;
 	}
 
+	// Quality-of-service class, sampled when the task is enqueued. Latency-critical tasks go to
+	// a dedicated queue that every worker serves first and that reserved workers serve
+	// exclusively, so bulk bursts can't delay them. The existing priority only reorders within a
+	// class. Implementations typically classify by viewer distance; the class is not re-sampled
+	// while queued.
+	enum QoS : uint8_t {
+		QOS_BULK = 0,
+		QOS_LATENCY_CRITICAL = 1,
+	};
+	virtual uint8_t get_qos_class() const {
+		return QOS_BULK;
+	}
+
+	// Fairness group for pools running with fair grouping (the streaming pool): tasks of
+	// different groups get served round-robin by accumulated service, so one group's bulk work
+	// can't starve another's. Streaming tasks return their volume id. Sampled at enqueue.
+	virtual uint32_t get_fair_group() const {
+		return 0;
+	}
+
 	// May return `true` in order for the thread pool to skip the task
 	virtual bool is_cancelled() {
 		return false;
 	}
+
+	// Called by the owner when it is done with the task, instead of deleting it directly.
+	// Pooled task types override this to return themselves to their pool.
+	virtual void dispose() {
+		ZN_DELETE(this);
+	}
 };
 
 } // namespace zylann
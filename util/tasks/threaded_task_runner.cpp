@@ -1,4 +1,15 @@
 #include "threaded_task_runner.h"
+
+// Thread affinity is OS-specific, Godot's thread API doesn't expose it
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+#include "../math/funcs.h"
+#include "../memory_accounting.h"
 #include "../profiling.h"
 #include "../string_funcs.h"
 
@@ -21,7 +32,11 @@ ThreadedTaskRunner::ThreadedTaskRunner() {}
 ThreadedTaskRunner::~ThreadedTaskRunner() {
 	destroy_all_threads();
 
-	if (_completed_tasks.size() != 0) {
+	bool has_ring_leftovers = false;
+	for (unsigned int i = 0; i < _threads.size(); ++i) {
+		has_ring_leftovers = has_ring_leftovers || !_threads[i].completed_ring.is_empty();
+	}
+	if (_completed_tasks.size() != 0 || has_ring_leftovers) {
 		// We don't have ownership over tasks, so it's an error to destroy the pool without handling them
 		ZN_PRINT_ERROR("There are unhandled completed tasks remaining!");
 	}
@@ -38,7 +53,21 @@ void ThreadedTaskRunner::create_thread(ThreadData &d, uint32_t i) {
 	d.thread.start(thread_func_static, &d);
 }
 
+void ThreadedTaskRunner::start_priority_refresh_thread_if_enabled() {
+	if (_priority_refresh_thread_enabled && !_priority_refresh_thread_running) {
+		_priority_refresh_thread_stop.store(false, std::memory_order_release);
+		_priority_refresh_thread.start(priority_refresh_thread_func_static, this);
+		_priority_refresh_thread_running = true;
+	}
+}
+
 void ThreadedTaskRunner::destroy_all_threads() {
+	if (_priority_refresh_thread_running) {
+		_priority_refresh_thread_stop.store(true, std::memory_order_release);
+		_priority_refresh_thread.wait_to_finish();
+		_priority_refresh_thread_running = false;
+	}
+
 	// We have only one semaphore to signal threads to resume, and one `post()` lets only one pass.
 	// We cannot tell one single thread to stop, because when we post and other threads are waiting, we can't guarantee
 	// the one to pass will be the one we want.
@@ -50,6 +79,7 @@ void ThreadedTaskRunner::destroy_all_threads() {
 	}
 	for (size_t i = 0; i < _thread_count; ++i) {
 		_tasks_semaphore.post();
+		_critical_tasks_semaphore.post();
 	}
 	for (size_t i = 0; i < _thread_count; ++i) {
 		ThreadData &d = _threads[i];
@@ -57,6 +87,11 @@ void ThreadedTaskRunner::destroy_all_threads() {
 	}
 }
 
+void ThreadedTaskRunner::set_priority_refresh_thread_enabled(bool enabled) {
+	// Must be set before threads are created, like other structural options
+	_priority_refresh_thread_enabled = enabled;
+}
+
 void ThreadedTaskRunner::set_name(const char *name) {
 	_name = name;
 }
@@ -66,11 +101,17 @@ void ThreadedTaskRunner::set_thread_count(uint32_t count) {
 		count = MAX_THREADS;
 	}
 	destroy_all_threads();
+	// With QoS reservation, roughly a quarter of the workers (at least one, and never all of
+	// them) only serve latency-critical tasks
+	const uint32_t reserved_count =
+			(_qos_reservation_enabled && count > 1) ? math::max(1u, count / 4u) : 0;
 	for (uint32_t i = _thread_count; i < count; ++i) {
 		ThreadData &d = _threads[i];
+		d.reserved_for_critical = i < reserved_count;
 		create_thread(d, i);
 	}
 	_thread_count = count;
+	start_priority_refresh_thread_if_enabled();
 }
 
 void ThreadedTaskRunner::set_batch_count(uint32_t count) {
@@ -81,13 +122,80 @@ void ThreadedTaskRunner::set_priority_update_period(uint32_t milliseconds) {
 	_priority_update_period = milliseconds;
 }
 
+void ThreadedTaskRunner::auto_tune() {
+	if (!_auto_tuning_enabled) {
+		return;
+	}
+	const uint64_t window_count = _service_task_count.load(std::memory_order_relaxed);
+	if (window_count < 16) {
+		// Not enough samples to say anything yet, keep the current settings
+		return;
+	}
+	_service_task_count.store(0, std::memory_order_relaxed);
+	const uint64_t window_time = _service_time_accum_usec.exchange(0, std::memory_order_relaxed);
+
+	const uint32_t window_mean = uint32_t(math::min(window_time / window_count, uint64_t(1000000)));
+	// Smooth over windows so one spiky batch doesn't swing the knobs
+	uint32_t mean = _mean_task_time_usec.load(std::memory_order_relaxed);
+	mean = mean == 0 ? window_mean : (3 * mean + window_mean) / 4;
+	_mean_task_time_usec.store(mean, std::memory_order_relaxed);
+
+	// Aim for roughly a millisecond of work per queue-lock acquisition: cheap tasks (blocky
+	// generation) amortize locking in big batches, expensive ones (graph generation) keep
+	// batches small so priority order stays sharp
+	const uint32_t TARGET_PICK_TIME_USEC = 1000;
+	const uint32_t batch_count = math::clamp(TARGET_PICK_TIME_USEC / math::max(mean, 1u), 1u, 16u);
+	_batch_count.store(batch_count, std::memory_order_relaxed);
+
+	// Re-evaluating priorities much more often than a fraction of the time the queue takes to
+	// drain is wasted work; much less often lets stale ordering linger
+	const uint64_t pending_tasks = get_debug_remaining_tasks();
+	const uint32_t threads = math::max(_thread_count, 1u);
+	const uint64_t drain_time_ms = (pending_tasks * mean) / (uint64_t(1000) * threads);
+	const uint32_t period = uint32_t(math::clamp(drain_time_ms / 4, uint64_t(32), uint64_t(500)));
+	_priority_update_period.store(period, std::memory_order_relaxed);
+}
+
+void ThreadedTaskRunner::set_work_stealing_enabled(bool enabled) {
+	_work_stealing_enabled = enabled;
+}
+
 void ThreadedTaskRunner::enqueue(IThreadedTask *task) {
 	ZN_ASSERT(task != nullptr);
-	{
+
+	TaskItem t;
+	t.task = task;
+	t.enqueue_time_ms = uint32_t(Time::get_singleton()->get_ticks_msec());
+	if (_fair_grouping_enabled) {
+		t.fair_group = task->get_fair_group();
+	}
+	if (_priority_refresh_thread_running) {
+		// Evaluated on the enqueueing thread, outside any queue lock; the refresh thread keeps it
+		// up to date afterwards
+		t.cached_priority = task->get_priority();
+		t.last_priority_update_time_ms = Time::get_singleton()->get_ticks_msec();
+	}
+
+	if (_qos_reservation_enabled && task->get_qos_class() == IThreadedTask::QOS_LATENCY_CRITICAL) {
+		// Dedicated queue served first by every worker and exclusively by reserved ones
+		{
+			MutexLock lock(_critical_tasks_mutex);
+			_critical_tasks.push(t);
+			++_debug_received_tasks;
+		}
+		_critical_tasks_semaphore.post();
+	} else if (_work_stealing_enabled && _thread_count > 0) {
+		// Distribute over per-thread queues, idle threads will steal if the distribution is uneven
+		const uint32_t thread_index = _next_enqueue_thread_index.fetch_add(1) % _thread_count;
+		ThreadData &d = _threads[thread_index];
+		{
+			MutexLock lock(d.local_tasks_mutex);
+			d.local_tasks.push(t);
+			++_debug_received_tasks;
+		}
+	} else {
 		MutexLock lock(_tasks_mutex);
-		TaskItem t;
-		t.task = task;
-		_tasks.push_back(t);
+		_tasks.push(t);
 		++_debug_received_tasks;
 	}
 	// TODO Do I need to post a certain amount of times?
@@ -100,16 +208,85 @@ void ThreadedTaskRunner::enqueue(Span<IThreadedTask *> new_tasks) {
 		ZN_ASSERT(new_tasks[i] != nullptr);
 	}
 #endif
-	{
+	if (_qos_reservation_enabled) {
+		// Critical tasks split off into their dedicated queue; the rest takes the normal path.
+		// Batches are typically uniform so this rarely does anything. Local vector on purpose,
+		// the tail of the batch re-enters this function.
+		std::vector<IThreadedTask *> bulk_tasks;
+		bool any_critical = false;
+		for (size_t i = 0; i < new_tasks.size(); ++i) {
+			// Classification is computed in `get_priority`, evaluate it first
+			const int priority = new_tasks[i]->get_priority();
+			if (new_tasks[i]->get_qos_class() == IThreadedTask::QOS_LATENCY_CRITICAL) {
+				TaskItem t;
+				t.task = new_tasks[i];
+				t.cached_priority = priority;
+				t.enqueue_time_ms = uint32_t(Time::get_singleton()->get_ticks_msec());
+				t.last_priority_update_time_ms = t.enqueue_time_ms;
+				{
+					MutexLock lock(_critical_tasks_mutex);
+					_critical_tasks.push(t);
+					++_debug_received_tasks;
+				}
+				_critical_tasks_semaphore.post();
+				_tasks_semaphore.post();
+				any_critical = true;
+			} else {
+				bulk_tasks.push_back(new_tasks[i]);
+			}
+		}
+		if (any_critical) {
+			if (bulk_tasks.size() == 0) {
+				return;
+			}
+			enqueue(to_span(bulk_tasks));
+			return;
+		}
+	}
+
+	if (_work_stealing_enabled && _thread_count > 0) {
+		// Spread the batch over per-thread queues, locking each queue once
+		const uint32_t first_thread_index = _next_enqueue_thread_index.fetch_add(new_tasks.size());
+		size_t src_index = 0;
+		for (uint32_t i = 0; i < _thread_count && src_index < new_tasks.size(); ++i) {
+			ThreadData &d = _threads[(first_thread_index + i) % _thread_count];
+			// Every thread gets an even share, earlier ones get the remainder
+			const size_t count = (new_tasks.size() - src_index + (_thread_count - 1 - i)) / (_thread_count - i);
+			MutexLock lock(d.local_tasks_mutex);
+			for (size_t j = 0; j < count; ++j) {
+				TaskItem t;
+				t.task = new_tasks[src_index];
+				t.enqueue_time_ms = uint32_t(Time::get_singleton()->get_ticks_msec());
+				if (_priority_refresh_thread_running) {
+					// Buckets sort by cached priority, so it must be real from the start when
+					// workers won't re-evaluate it inline
+					t.cached_priority = t.task->get_priority();
+					t.last_priority_update_time_ms = t.enqueue_time_ms;
+				}
+				d.local_tasks.push(t);
+				++src_index;
+			}
+		}
+		_debug_received_tasks.fetch_add(new_tasks.size(), std::memory_order_relaxed);
+	} else {
+		const uint32_t enqueue_time_ms = uint32_t(Time::get_singleton()->get_ticks_msec());
 		MutexLock lock(_tasks_mutex);
-		const size_t dst_begin = _tasks.size();
-		_tasks.resize(_tasks.size() + new_tasks.size());
 		for (size_t i = 0; i < new_tasks.size(); ++i) {
 			TaskItem t;
 			t.task = new_tasks[i];
-			_tasks[dst_begin + i] = t;
+			t.enqueue_time_ms = enqueue_time_ms;
+			if (_fair_grouping_enabled) {
+				t.fair_group = new_tasks[i]->get_fair_group();
+			}
+			if (_priority_refresh_thread_running) {
+				// Buckets sort by cached priority, so it must be real from the start when
+				// workers won't re-evaluate it inline
+				t.cached_priority = t.task->get_priority();
+				t.last_priority_update_time_ms = enqueue_time_ms;
+			}
+			_tasks.push(t);
 		}
-		_debug_received_tasks += new_tasks.size();
+		_debug_received_tasks.fetch_add(new_tasks.size(), std::memory_order_relaxed);
 	}
 	// TODO Do I need to post a certain amount of times?
 	for (size_t i = 0; i < new_tasks.size(); ++i) {
@@ -117,6 +294,28 @@ void ThreadedTaskRunner::enqueue(Span<IThreadedTask *> new_tasks) {
 	}
 }
 
+namespace {
+
+// Pins the calling thread to one logical CPU. Best-effort, unsupported platforms are a no-op.
+void pin_current_thread_to_cpu(unsigned int cpu_index) {
+#if defined(__linux__)
+	cpu_set_t cpuset;
+	CPU_ZERO(&cpuset);
+	CPU_SET(cpu_index % CPU_SETSIZE, &cpuset);
+	pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+#elif defined(_WIN32)
+	SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << (cpu_index % (sizeof(DWORD_PTR) * 8)));
+#else
+	(void)cpu_index;
+#endif
+}
+
+} // namespace
+
+void ThreadedTaskRunner::set_thread_pinning_enabled(bool enabled) {
+	_thread_pinning_enabled = enabled;
+}
+
 void ThreadedTaskRunner::thread_func_static(void *p_data) {
 	ThreadData &data = *static_cast<ThreadData *>(p_data);
 	ThreadedTaskRunner &pool = *data.pool;
@@ -129,10 +328,306 @@ void ThreadedTaskRunner::thread_func_static(void *p_data) {
 #endif
 	}
 
+	if (pool._thread_pinning_enabled) {
+		// Start from the last logical CPU so the main thread's usual home (CPU 0) is used last.
+		// With per-thread queues and thread-local memory magazines, pinning keeps each thread's
+		// working set local to its core's memory node.
+		const unsigned int cpu_count = math::max(1u, unsigned(Thread::get_hardware_concurrency()));
+		pin_current_thread_to_cpu((cpu_count - 1 - (data.index % cpu_count)) % cpu_count);
+	}
+
 	pool.thread_func(data);
 }
 
+void ThreadedTaskRunner::pick_best_tasks(BucketedTaskQueue &queue, std::vector<TaskItem> &out_tasks,
+		std::vector<IThreadedTask *> &out_cancelled, uint32_t count, uint64_t now) {
+	// When the dedicated refresh thread is running, it keeps cached priorities (and bucket
+	// placement) up to date and collects cancellations; workers then only pop, they never run
+	// evaluations while holding the queue lock
+	const bool evaluate_inline = !_priority_refresh_thread_running;
+	const uint32_t refresh_period = _priority_update_period.load(std::memory_order_relaxed);
+
+	for (uint32_t bi = 0; bi < count && queue.size() != 0; ++bi) {
+		if (_fair_grouping_enabled) {
+			// Weighted fair queuing: the least-served group wins, priority only breaks ties
+			// within it, so one group's bulk work can't starve the others. This needs a full
+			// scan; it only runs on the streaming pool, whose queues stay modest.
+			unsigned int best_bucket = 0;
+			size_t best_index = 0;
+			int best_priority = 999999;
+			bool found = false;
+
+			for (unsigned int bucket_index = 0; bucket_index < BucketedTaskQueue::BUCKET_COUNT; ++bucket_index) {
+				std::deque<TaskItem> &bucket = queue.buckets[bucket_index];
+				for (size_t i = 0; i < bucket.size(); ++i) {
+					TaskItem &item = bucket[i];
+					ZN_ASSERT(item.task != nullptr);
+
+					if (evaluate_inline && now - item.last_priority_update_time_ms > refresh_period) {
+						// Calling `get_priority()` first since it can update cancellation
+						item.cached_priority = item.task->get_priority();
+						if (item.task->is_cancelled()) {
+							out_cancelled.push_back(item.task);
+							queue.remove_at(bucket_index, i);
+							--i;
+							continue;
+						}
+						// Not migrated: the fair scan reads `cached_priority` directly, bucket
+						// placement doesn't affect its outcome
+						item.last_priority_update_time_ms = now;
+					}
+
+					const uint64_t service = get_group_service_count(item.fair_group);
+					const uint64_t best_service =
+							found ? get_group_service_count(queue.buckets[best_bucket][best_index].fair_group) : 0;
+					if (!found || service < best_service ||
+							(service == best_service && item.cached_priority < best_priority)) {
+						best_priority = item.cached_priority;
+						best_bucket = bucket_index;
+						best_index = i;
+						found = true;
+					}
+				}
+			}
+
+			if (!found) {
+				break;
+			}
+			const TaskItem picked = queue.buckets[best_bucket][best_index];
+			queue.remove_at(best_bucket, best_index);
+			++_group_service_counts[picked.fair_group];
+			// Counters only matter relative to each other; rebase periodically so a group
+			// idle for a while doesn't get an unbounded head start when it comes back
+			if (_group_service_counts.size() > 64) {
+				_group_service_counts.clear();
+			}
+			if (uint32_t(now) - picked.enqueue_time_ms > 1000) {
+				_starved_task_count.fetch_add(1, std::memory_order_relaxed);
+			}
+			out_tasks.push_back(picked);
+			continue;
+		}
+
+		// O(1) pop from the best bucket. With inline evaluation, a popped task whose refreshed
+		// priority belongs to a worse bucket gets lazily migrated there and the pop retried, a
+		// bounded number of times so pickup always makes progress.
+		unsigned int migration_attempts = 0;
+		bool picked_one = false;
+		while (!picked_one) {
+			const unsigned int bucket_index = queue.get_best_bucket_index();
+			if (bucket_index == BucketedTaskQueue::BUCKET_COUNT) {
+				break;
+			}
+			TaskItem item = queue.pop_from_bucket(bucket_index);
+			ZN_ASSERT(item.task != nullptr);
+
+			if (evaluate_inline && now - item.last_priority_update_time_ms > refresh_period) {
+				item.cached_priority = item.task->get_priority();
+				if (item.task->is_cancelled()) {
+					out_cancelled.push_back(item.task);
+					continue;
+				}
+				item.last_priority_update_time_ms = now;
+				const unsigned int new_bucket_index = BucketedTaskQueue::get_bucket_index(item.cached_priority);
+				if (new_bucket_index > bucket_index && migration_attempts < 4) {
+					queue.push(item);
+					++migration_attempts;
+					continue;
+				}
+			}
+
+			if (uint32_t(now) - item.enqueue_time_ms > 1000) {
+				_starved_task_count.fetch_add(1, std::memory_order_relaxed);
+			}
+			out_tasks.push_back(item);
+			picked_one = true;
+		}
+		if (!picked_one) {
+			break;
+		}
+	}
+}
+
+uint64_t ThreadedTaskRunner::get_group_service_count(uint32_t group) const {
+	auto it = _group_service_counts.find(group);
+	return it != _group_service_counts.end() ? it->second : 0;
+}
+
+unsigned int ThreadedTaskRunner::cancel_stale_tasks() {
+	ZN_PROFILE_SCOPE();
+
+	struct L {
+		static void sweep(BucketedTaskQueue &queue, std::vector<IThreadedTask *> &dropped, uint64_t now) {
+			// In-place compaction of each bucket; refreshed priorities are kept but placement is
+			// not migrated here, the regular refresh handles that
+			for (unsigned int bucket_index = 0; bucket_index < BucketedTaskQueue::BUCKET_COUNT; ++bucket_index) {
+				std::deque<TaskItem> &bucket = queue.buckets[bucket_index];
+				size_t w = 0;
+				for (size_t r = 0; r < bucket.size(); ++r) {
+					TaskItem &item = bucket[r];
+					// Calling `get_priority()` first since it can update cancellation (see `pick_best_tasks`)
+					item.cached_priority = item.task->get_priority();
+					if (item.task->is_cancelled()) {
+						dropped.push_back(item.task);
+						continue;
+					}
+					item.last_priority_update_time_ms = now;
+					bucket[w++] = bucket[r];
+				}
+				const size_t removed_count = bucket.size() - w;
+				bucket.resize(w);
+				queue.notify_removed(bucket_index, removed_count);
+			}
+		}
+	};
+
+	const uint64_t now = Time::get_singleton()->get_ticks_msec();
+	std::vector<IThreadedTask *> dropped;
+
+	{
+		MutexLock lock(_tasks_mutex);
+		L::sweep(_tasks, dropped, now);
+	}
+	if (_qos_reservation_enabled) {
+		MutexLock lock(_critical_tasks_mutex);
+		L::sweep(_critical_tasks, dropped, now);
+	}
+	if (_work_stealing_enabled) {
+		for (uint32_t i = 0; i < _thread_count; ++i) {
+			ThreadData &d = _threads[i];
+			MutexLock lock(d.local_tasks_mutex);
+			L::sweep(d.local_tasks, dropped, now);
+		}
+	}
+
+	if (dropped.size() > 0) {
+		MutexLock lock(_completed_tasks_mutex);
+		for (size_t i = 0; i < dropped.size(); ++i) {
+			_completed_tasks.push_back(dropped[i]);
+			++_debug_completed_tasks;
+		}
+	}
+	_dropped_task_count += dropped.size();
+
+	return dropped.size();
+}
+
+void ThreadedTaskRunner::priority_refresh_thread_func_static(void *p_data) {
+	ThreadedTaskRunner &pool = *static_cast<ThreadedTaskRunner *>(p_data);
+	Thread::set_name("Task priority refresh");
+	pool.priority_refresh_thread_func();
+}
+
+void ThreadedTaskRunner::refresh_queue_priorities(BucketedTaskQueue &queue, Mutex &mutex, uint64_t now,
+		std::vector<IThreadedTask *> &cancelled, std::vector<TaskItem> *out_promoted) {
+	// One bucket per lock acquisition, so workers popping from the same queue interleave instead
+	// of stalling behind one long pass. Each bucket is compacted in place; tasks whose refreshed
+	// priority lands in a different bucket are collected and re-pushed at the end (lazy
+	// migration: only changed tasks pay for moving).
+	std::vector<TaskItem> migrated;
+	for (unsigned int bucket_index = 0; bucket_index < BucketedTaskQueue::BUCKET_COUNT; ++bucket_index) {
+		MutexLock lock(mutex);
+		std::deque<TaskItem> &bucket = queue.buckets[bucket_index];
+		size_t w = 0;
+		for (size_t r = 0; r < bucket.size(); ++r) {
+			TaskItem &item = bucket[r];
+			// Can update cancellation, like the legacy inline path
+			item.cached_priority = item.task->get_priority();
+			if (item.task->is_cancelled()) {
+				cancelled.push_back(item.task);
+				continue;
+			}
+			item.last_priority_update_time_ms = now;
+			if (out_promoted != nullptr && item.task->get_qos_class() == IThreadedTask::QOS_LATENCY_CRITICAL) {
+				// The viewer got close since this was enqueued as bulk; promote it so reserved
+				// workers can pick it up ahead of the bulk backlog
+				out_promoted->push_back(item);
+				continue;
+			}
+			if (BucketedTaskQueue::get_bucket_index(item.cached_priority) != bucket_index) {
+				migrated.push_back(item);
+				continue;
+			}
+			bucket[w++] = bucket[r];
+		}
+		const size_t removed_count = bucket.size() - w;
+		bucket.resize(w);
+		queue.notify_removed(bucket_index, removed_count);
+	}
+
+	if (migrated.size() > 0) {
+		MutexLock lock(mutex);
+		for (size_t i = 0; i < migrated.size(); ++i) {
+			queue.push(migrated[i]);
+		}
+	}
+}
+
+void ThreadedTaskRunner::priority_refresh_thread_func() {
+	while (!_priority_refresh_thread_stop.load(std::memory_order_acquire)) {
+		// This thread only exists to keep priorities fresh, it yields generously. Sleeping in
+		// small slices keeps shutdown responsive.
+		for (uint32_t slept_ms = 0;
+				slept_ms < _priority_update_period.load(std::memory_order_relaxed) &&
+				!_priority_refresh_thread_stop.load(std::memory_order_acquire);
+				slept_ms += 10) {
+			Thread::sleep_usec(10 * 1000);
+		}
+		if (_priority_refresh_thread_stop.load(std::memory_order_acquire)) {
+			break;
+		}
+
+		ZN_PROFILE_SCOPE_NAMED("Task priority refresh");
+		const uint64_t now = Time::get_singleton()->get_ticks_msec();
+		std::vector<IThreadedTask *> cancelled;
+
+		std::vector<TaskItem> promoted;
+		std::vector<TaskItem> *out_promoted = _qos_reservation_enabled ? &promoted : nullptr;
+
+		refresh_queue_priorities(_tasks, _tasks_mutex, now, cancelled, out_promoted);
+		if (_qos_reservation_enabled) {
+			refresh_queue_priorities(_critical_tasks, _critical_tasks_mutex, now, cancelled, nullptr);
+		}
+		if (_work_stealing_enabled) {
+			for (uint32_t i = 0; i < _thread_count; ++i) {
+				ThreadData &d = _threads[i];
+				refresh_queue_priorities(d.local_tasks, d.local_tasks_mutex, now, cancelled, out_promoted);
+			}
+		}
+
+		if (promoted.size() > 0) {
+			{
+				MutexLock lock(_critical_tasks_mutex);
+				for (size_t i = 0; i < promoted.size(); ++i) {
+					_critical_tasks.push(promoted[i]);
+				}
+			}
+			for (size_t i = 0; i < promoted.size(); ++i) {
+				// Waking both reserved and regular workers, like a critical enqueue does
+				_critical_tasks_semaphore.post();
+				_tasks_semaphore.post();
+			}
+		}
+
+		if (cancelled.size() > 0) {
+			{
+				MutexLock lock(_completed_tasks_mutex);
+				for (size_t i = 0; i < cancelled.size(); ++i) {
+					_completed_tasks.push_back(cancelled[i]);
+					++_debug_completed_tasks;
+				}
+			}
+			_dropped_task_count += cancelled.size();
+		}
+	}
+}
+
 void ThreadedTaskRunner::thread_func(ThreadData &data) {
+	if (_work_stealing_enabled) {
+		thread_func_work_stealing(data);
+		return;
+	}
+
 	data.debug_state = STATE_RUNNING;
 
 	std::vector<TaskItem> tasks;
@@ -145,46 +640,136 @@ void ThreadedTaskRunner::thread_func(ThreadData &data) {
 			data.debug_state = STATE_PICKING;
 			const uint64_t now = Time::get_singleton()->get_ticks_msec();
 
-			MutexLock lock(_tasks_mutex);
+			if (_qos_reservation_enabled) {
+				// Everyone serves the latency-critical queue first
+				MutexLock lock(_critical_tasks_mutex);
+				pick_best_tasks(
+						_critical_tasks, tasks, cancelled_tasks, _batch_count.load(std::memory_order_relaxed), now);
+			}
+			if (tasks.empty() && !data.reserved_for_critical) {
+				MutexLock lock(_tasks_mutex);
+				pick_best_tasks(_tasks, tasks, cancelled_tasks, _batch_count.load(std::memory_order_relaxed), now);
+			}
+		}
 
-			// Pick best tasks
-			for (uint32_t bi = 0; bi < _batch_count && _tasks.size() != 0; ++bi) {
-				size_t best_index = 0; // Take first by default, this is a valid index
-				int best_priority = 999999;
+		if (cancelled_tasks.size() > 0) {
+			MutexLock lock(_completed_tasks_mutex);
+			for (size_t i = 0; i < cancelled_tasks.size(); ++i) {
+				_completed_tasks.push_back(cancelled_tasks[i]);
+				++_debug_completed_tasks;
+			}
+			_dropped_task_count += cancelled_tasks.size();
+		}
+		cancelled_tasks.clear();
 
-				// TODO This takes a lot of time when there are many queued tasks. Use a better container?
-				for (size_t i = 0; i < _tasks.size(); ++i) {
-					TaskItem &item = _tasks[i];
-					ZN_ASSERT(item.task != nullptr);
+		//print_line(String("Processing {0} tasks").format(varray(tasks.size())));
 
-					if (now - item.last_priority_update_time_ms > _priority_update_period) {
-						// Calling `get_priority()` first since it can update cancellation
-						// (not clear API tho, might review that in the future)
-						item.cached_priority = item.task->get_priority();
+		if (tasks.empty()) {
+			data.debug_state = STATE_WAITING;
 
-						if (item.task->is_cancelled()) {
-							cancelled_tasks.push_back(item.task);
-							_tasks[i] = _tasks.back();
-							_tasks.pop_back();
-							--i;
-							continue;
-						}
+			// Wait for more tasks. Reserved workers wait on the critical semaphore so they never
+			// consume a wakeup meant for a bulk task.
+			data.waiting = true;
+			if (data.reserved_for_critical) {
+				_critical_tasks_semaphore.wait();
+			} else {
+				_tasks_semaphore.wait();
+			}
+			data.waiting = false;
 
-						item.last_priority_update_time_ms = now;
-					}
+		} else {
+			data.debug_state = STATE_RUNNING;
 
-					if (item.cached_priority < best_priority) {
-						best_priority = item.cached_priority;
-						best_index = i;
-					}
+			const uint64_t batch_begin_usec = Time::get_singleton()->get_ticks_usec();
+			unsigned int executed_count = 0;
+			for (size_t i = 0; i < tasks.size(); ++i) {
+				TaskItem &item = tasks[i];
+				if (!item.task->is_cancelled()) {
+					ThreadedTaskContext ctx;
+					ctx.thread_index = data.index;
+					// Tasks sample this watermark at the end of their run to attribute
+					// allocation spikes to their type
+					MemoryAccounting::begin_thread_task_scope();
+					item.task->run(ctx);
+					ZN_PROFILE_PLOT(
+							"Task peak alloc", int64_t(MemoryAccounting::get_thread_task_peak_bytes()));
+					++_executed_task_count;
+					++executed_count;
+				} else {
+					++_dropped_task_count;
+				}
+			}
+			if (_auto_tuning_enabled && executed_count > 0) {
+				_service_time_accum_usec.fetch_add(
+						Time::get_singleton()->get_ticks_usec() - batch_begin_usec, std::memory_order_relaxed);
+				_service_task_count.fetch_add(executed_count, std::memory_order_relaxed);
+			}
+			for (size_t i = 0; i < tasks.size(); ++i) {
+				TaskItem &item = tasks[i];
+				// Wait-free delivery; the shared list is only a spillway when the consumer
+				// lags behind by a whole ring
+				if (!data.completed_ring.try_push(item.task)) {
+					MutexLock lock(_completed_tasks_mutex);
+					_completed_tasks.push_back(item.task);
 				}
+				++_debug_completed_tasks;
+			}
+
+			tasks.clear();
+		}
+	}
+
+	data.debug_state = STATE_STOPPED;
+}
+
+void ThreadedTaskRunner::thread_func_work_stealing(ThreadData &data) {
+	data.debug_state = STATE_RUNNING;
+
+	std::vector<TaskItem> tasks;
+	std::vector<IThreadedTask *> cancelled_tasks;
 
-				// If not all tasks were cancelled
-				if (_tasks.size() != 0) {
-					tasks.push_back(_tasks[best_index]);
-					ZN_ASSERT(best_index < _tasks.size());
-					_tasks[best_index] = _tasks.back();
-					_tasks.pop_back();
+	while (!data.stop) {
+		{
+			ZN_PROFILE_SCOPE_NAMED("Task pickup");
+
+			data.debug_state = STATE_PICKING;
+			const uint64_t now = Time::get_singleton()->get_ticks_msec();
+
+			if (_qos_reservation_enabled) {
+				// Everyone serves the latency-critical queue first
+				MutexLock lock(_critical_tasks_mutex);
+				pick_best_tasks(
+						_critical_tasks, tasks, cancelled_tasks, _batch_count.load(std::memory_order_relaxed), now);
+			}
+
+			// Our own queue next; reserved workers only ever run critical tasks
+			if (tasks.empty() && !data.reserved_for_critical) {
+				MutexLock lock(data.local_tasks_mutex);
+				pick_best_tasks(data.local_tasks, tasks, cancelled_tasks, _batch_count.load(std::memory_order_relaxed), now);
+			}
+
+			if (tasks.empty() && !data.reserved_for_critical) {
+				// Steal from the most loaded other thread.
+				// Queue sizes are read unlocked, this is only a heuristic to pick a victim.
+				uint32_t victim_index = data.index;
+				size_t victim_size = 0;
+				for (uint32_t i = 0; i < _thread_count; ++i) {
+					if (i == data.index) {
+						continue;
+					}
+					const size_t size = _threads[i].local_tasks.size();
+					if (size > victim_size) {
+						victim_size = size;
+						victim_index = i;
+					}
+				}
+				if (victim_index != data.index) {
+					ThreadData &victim = _threads[victim_index];
+					MutexLock lock(victim.local_tasks_mutex);
+					// Take half the victim's queue (at least a batch) so repeated steals converge to balance
+					const uint32_t steal_count =
+							math::max(uint32_t(victim.local_tasks.size() / 2), _batch_count.load(std::memory_order_relaxed));
+					pick_best_tasks(victim.local_tasks, tasks, cancelled_tasks, steal_count, now);
 				}
 			}
 		}
@@ -195,37 +780,59 @@ void ThreadedTaskRunner::thread_func(ThreadData &data) {
 				_completed_tasks.push_back(cancelled_tasks[i]);
 				++_debug_completed_tasks;
 			}
+			_dropped_task_count += cancelled_tasks.size();
 		}
 		cancelled_tasks.clear();
 
-		//print_line(String("Processing {0} tasks").format(varray(tasks.size())));
-
 		if (tasks.empty()) {
 			data.debug_state = STATE_WAITING;
 
-			// Wait for more tasks
+			// Wait for more tasks. Reserved workers wait on the critical semaphore so they never
+			// consume a wakeup meant for a bulk task.
 			data.waiting = true;
-			_tasks_semaphore.wait();
+			if (data.reserved_for_critical) {
+				_critical_tasks_semaphore.wait();
+			} else {
+				_tasks_semaphore.wait();
+			}
 			data.waiting = false;
 
 		} else {
 			data.debug_state = STATE_RUNNING;
 
+			const uint64_t batch_begin_usec = Time::get_singleton()->get_ticks_usec();
+			unsigned int executed_count = 0;
 			for (size_t i = 0; i < tasks.size(); ++i) {
 				TaskItem &item = tasks[i];
 				if (!item.task->is_cancelled()) {
 					ThreadedTaskContext ctx;
 					ctx.thread_index = data.index;
+					// Tasks sample this watermark at the end of their run to attribute
+					// allocation spikes to their type
+					MemoryAccounting::begin_thread_task_scope();
 					item.task->run(ctx);
+					ZN_PROFILE_PLOT(
+							"Task peak alloc", int64_t(MemoryAccounting::get_thread_task_peak_bytes()));
+					++_executed_task_count;
+					++executed_count;
+				} else {
+					++_dropped_task_count;
 				}
 			}
-			{
-				MutexLock lock(_completed_tasks_mutex);
-				for (size_t i = 0; i < tasks.size(); ++i) {
-					TaskItem &item = tasks[i];
+			if (_auto_tuning_enabled && executed_count > 0) {
+				_service_time_accum_usec.fetch_add(
+						Time::get_singleton()->get_ticks_usec() - batch_begin_usec, std::memory_order_relaxed);
+				_service_task_count.fetch_add(executed_count, std::memory_order_relaxed);
+			}
+			for (size_t i = 0; i < tasks.size(); ++i) {
+				TaskItem &item = tasks[i];
+				// Wait-free delivery; the shared list is only a spillway when the consumer
+				// lags behind by a whole ring
+				if (!data.completed_ring.try_push(item.task)) {
+					MutexLock lock(_completed_tasks_mutex);
 					_completed_tasks.push_back(item.task);
-					++_debug_completed_tasks;
 				}
+				++_debug_completed_tasks;
 			}
 
 			tasks.clear();
@@ -243,12 +850,25 @@ void ThreadedTaskRunner::wait_for_all_tasks() {
 
 	// Wait until all tasks have been taken
 	while (true) {
+		bool any_pending = false;
 		{
 			MutexLock lock(_tasks_mutex);
-			if (_tasks.size() == 0) {
-				break;
+			any_pending = _tasks.size() != 0;
+		}
+		if (!any_pending && _qos_reservation_enabled) {
+			MutexLock lock(_critical_tasks_mutex);
+			any_pending = _critical_tasks.size() != 0;
+		}
+		if (!any_pending && _work_stealing_enabled) {
+			for (uint32_t i = 0; i < _thread_count && !any_pending; ++i) {
+				ThreadData &d = _threads[i];
+				MutexLock lock(d.local_tasks_mutex);
+				any_pending = d.local_tasks.size() != 0;
 			}
 		}
+		if (!any_pending) {
+			break;
+		}
 
 		Thread::sleep_usec(2000);
 
@@ -291,7 +911,8 @@ ThreadedTaskRunner::State ThreadedTaskRunner::get_thread_debug_state(uint32_t i)
 }
 
 unsigned int ThreadedTaskRunner::get_debug_remaining_tasks() const {
-	return _debug_received_tasks - _debug_completed_tasks;
+	return _debug_received_tasks.load(std::memory_order_relaxed) -
+			_debug_completed_tasks.load(std::memory_order_relaxed);
 }
 
 } // namespace zylann
@@ -5,9 +5,15 @@
 #include "../span.h"
 #include "../thread/mutex.h"
 #include "../thread/semaphore.h"
+#include "../thread/spsc_ring.h"
 #include "../thread/thread.h"
 #include "threaded_task.h"
 
+#include "../math/funcs.h"
+
+#include <atomic>
+#include <deque>
+#include <unordered_map>
 #include <queue>
 #include <string>
 
@@ -39,16 +45,96 @@ public:
 		return _thread_count;
 	}
 
-	// TODO Add ability to change it while running
 	// Sets how many tasks each thread will attempt to dequeue on each iteration.
-	// Can't be changed after tasks have been queued.
 	void set_batch_count(uint32_t count);
+	uint32_t get_batch_count() const {
+		return _batch_count.load(std::memory_order_relaxed);
+	}
 
-	// TODO Add ability to change it while running
 	// Task priorities can change over time, but computing them too often with many tasks can be expensive,
 	// so they are cached. This sets how often task priorities will be polled.
-	// Can't be changed after tasks have been queued.
 	void set_priority_update_period(uint32_t milliseconds);
+	uint32_t get_priority_update_period() const {
+		return _priority_update_period.load(std::memory_order_relaxed);
+	}
+
+	// Weighted fair queuing between task groups (see IThreadedTask::get_fair_group): pickup
+	// serves the group with the least accumulated service first, priority only ordering within
+	// it. Used by the streaming pool so one volume's bulk load can't starve another's saves.
+	// Must be set before tasks are queued.
+	void set_fair_grouping_enabled(bool enabled) {
+		_fair_grouping_enabled = enabled;
+	}
+	bool is_fair_grouping_enabled() const {
+		return _fair_grouping_enabled;
+	}
+
+	// Tasks that waited more than a second before being picked up, a starvation indicator
+	uint64_t get_starved_task_count() const {
+		return _starved_task_count.load(std::memory_order_relaxed);
+	}
+
+	// Reserves a small subset of workers exclusively for latency-critical tasks (see
+	// IThreadedTask::get_qos_class). Critical tasks go to their own queue, served first by every
+	// worker and exclusively by the reserved ones, so a burst of expensive bulk tasks can't
+	// delay the block right under the player's shovel. Must be set before configuring threads.
+	void set_qos_reservation_enabled(bool enabled) {
+		_qos_reservation_enabled = enabled;
+	}
+	bool is_qos_reservation_enabled() const {
+		return _qos_reservation_enabled;
+	}
+
+	// When enabled, `auto_tune()` adapts the batch count and priority update period online from
+	// measured task service times: cheap tasks get picked in large batches so the queue lock is
+	// taken less often, expensive ones go one by one so priorities stay accurate, and the
+	// priority polling period follows how long the queue takes to drain. Deletes the guesswork
+	// of hand-tuning these per game.
+	void set_auto_tuning_enabled(bool enabled) {
+		_auto_tuning_enabled = enabled;
+	}
+	bool is_auto_tuning_enabled() const {
+		return _auto_tuning_enabled;
+	}
+
+	// Owner calls this periodically (e.g. once per frame) from any single thread
+	void auto_tune();
+
+	// Mean task service time over the recent tuning windows, for diagnostics
+	uint32_t get_mean_task_time_usec() const {
+		return _mean_task_time_usec.load(std::memory_order_relaxed);
+	}
+
+	// When enabled, tasks are distributed into per-thread queues instead of one shared queue, and idle
+	// threads steal from the most loaded one. This removes contention on the shared queue lock under
+	// heavy bursts, at the cost of slightly less globally-optimal priority ordering (each queue still
+	// re-polls priorities at the configured period, and stealing rebalances load between threads).
+	// Must be set before configuring thread count, and can't be changed after tasks have been queued.
+	void set_work_stealing_enabled(bool enabled);
+	bool is_work_stealing_enabled() const {
+		return _work_stealing_enabled;
+	}
+
+	// When enabled, a dedicated low-priority thread refreshes queued task priorities and collects
+	// cancellations periodically, in small slices so workers interleave. Workers then only pop by
+	// cached priority and never run distance evaluations while holding a queue lock, which used to
+	// stall them during the resort when tens of thousands of tasks were queued (teleports).
+	// New tasks get their initial priority evaluated on the enqueueing thread.
+	// Must be set before configuring thread count.
+	void set_priority_refresh_thread_enabled(bool enabled);
+	bool is_priority_refresh_thread_enabled() const {
+		return _priority_refresh_thread_enabled;
+	}
+
+	// When enabled, each worker thread pins itself to one logical CPU (round-robin over the
+	// machine). Together with per-thread task queues and the thread-local buffer magazines, this
+	// keeps a thread's working set on the memory node of its core, avoiding remote-memory
+	// penalties on multi-socket hosts. Best-effort: platforms without affinity APIs ignore it.
+	// Must be set before configuring thread count.
+	void set_thread_pinning_enabled(bool enabled);
+	bool is_thread_pinning_enabled() const {
+		return _thread_pinning_enabled;
+	}
 
 	// TODO Expect tasks to be unique ptrs?
 
@@ -58,28 +144,149 @@ public:
 	// Schedules multiple tasks at once. Involves less internal locking.
 	void enqueue(Span<IThreadedTask *> new_tasks);
 
-	// TODO Lambda might not be the best API. memcpying to a vector would ensure we lock for a shorter time.
+	// Hands back finished tasks. Must always be called from the same thread (the owner's
+	// processing thread): workers deliver through per-thread SPSC rings, which assume a single
+	// consumer. The mutex-protected list only receives overflow and deliveries from non-worker
+	// threads (enqueue-time drops, the priority refresh thread, bulk cancellations), so in steady
+	// state draining takes no contended lock and workers never wait on the consumer.
 	template <typename F>
 	void dequeue_completed_tasks(F f) {
-		MutexLock lock(_completed_tasks_mutex);
-		for (size_t i = 0; i < _completed_tasks.size(); ++i) {
-			IThreadedTask *task = _completed_tasks[i];
-			f(task);
+		unsigned int consumed_count = 0;
+		for (uint32_t thread_index = 0; thread_index < _thread_count; ++thread_index) {
+			ThreadData &d = _threads[thread_index];
+			IThreadedTask *task = nullptr;
+			while (d.completed_ring.try_pop(task)) {
+				f(task);
+				++consumed_count;
+			}
 		}
-		_completed_tasks.clear();
+		{
+			MutexLock lock(_completed_tasks_mutex);
+			for (size_t i = 0; i < _completed_tasks.size(); ++i) {
+				IThreadedTask *task = _completed_tasks[i];
+				f(task);
+				++consumed_count;
+			}
+			_completed_tasks.clear();
+		}
+		_consumed_completed_tasks.fetch_add(consumed_count, std::memory_order_relaxed);
+	}
+
+	// Approximate number of finished tasks waiting to be dequeued. Workers use it as a backlog
+	// signal, e.g. to shrink result payloads when the consumer falls behind during load bursts.
+	unsigned int get_completed_pending_count() const {
+		const uint32_t completed = _debug_completed_tasks.load(std::memory_order_relaxed);
+		const uint32_t consumed = _consumed_completed_tasks.load(std::memory_order_relaxed);
+		// Counters are updated independently, so clamp transient inversions
+		return completed > consumed ? completed - consumed : 0;
 	}
 
+	// Sweeps all queues once and drops queued tasks reporting cancellation, without waiting for
+	// them to reach the front. `get_priority()` is called to refresh cancellation state, like
+	// regular priority polling does. Dropped tasks go to the completed list so their owner still
+	// gets them back. Returns how many tasks were dropped.
+	unsigned int cancel_stale_tasks();
+
 	// Blocks and wait for all tasks to finish (assuming no more are getting added!)
 	void wait_for_all_tasks();
 
 	State get_thread_debug_state(uint32_t i) const;
 	unsigned int get_debug_remaining_tasks() const;
 
+	// Counters of what happened to picked-up tasks so far, so executed-vs-dropped ratios can be
+	// observed after bulk cancellations
+	uint64_t get_executed_task_count() const {
+		return _executed_task_count;
+	}
+	uint64_t get_dropped_task_count() const {
+		return _dropped_task_count;
+	}
+
 private:
 	struct TaskItem {
 		IThreadedTask *task = nullptr;
 		int cached_priority = 99999;
 		uint64_t last_priority_update_time_ms = 0;
+		// Fairness group, sampled at enqueue (see `set_fair_grouping_enabled`)
+		uint32_t fair_group = 0;
+		uint32_t enqueue_time_ms = 0;
+	};
+
+	// Bucketed priority queue: tasks land in one of 64 buckets by quantized cached priority and
+	// are served FIFO within a bucket. Popping the best task is O(1) (count-trailing-zeros on the
+	// nonempty mask), and a priority refresh only pays for tasks whose bucket actually changed.
+	// This replaced a linear best-of scan per pop that showed up as streaming hiccups with tens
+	// of thousands of queued tasks.
+	struct BucketedTaskQueue {
+		static const unsigned int BUCKET_COUNT = 64;
+
+		// 64 buckets of 64 priority units each resolve the near range exactly; everything
+		// farther lands in the last bucket, where precise ordering stops mattering
+		static inline unsigned int get_bucket_index(int priority) {
+			return unsigned(math::clamp(priority >> 6, 0, int(BUCKET_COUNT - 1)));
+		}
+
+		static inline unsigned int count_trailing_zeros(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+			return __builtin_ctzll(x);
+#else
+			unsigned int n = 0;
+			while ((x & 1) == 0) {
+				x >>= 1;
+				++n;
+			}
+			return n;
+#endif
+		}
+
+		inline void push(const TaskItem &item) {
+			const unsigned int bucket_index = get_bucket_index(item.cached_priority);
+			buckets[bucket_index].push_back(item);
+			nonempty_mask |= uint64_t(1) << bucket_index;
+			++count;
+		}
+
+		inline size_t size() const {
+			return count;
+		}
+
+		// Index of the best nonempty bucket, BUCKET_COUNT when the queue is empty
+		inline unsigned int get_best_bucket_index() const {
+			return nonempty_mask == 0 ? BUCKET_COUNT : count_trailing_zeros(nonempty_mask);
+		}
+
+		inline TaskItem pop_from_bucket(unsigned int bucket_index) {
+			std::deque<TaskItem> &bucket = buckets[bucket_index];
+			const TaskItem item = bucket.front();
+			bucket.pop_front();
+			if (bucket.empty()) {
+				nonempty_mask &= ~(uint64_t(1) << bucket_index);
+			}
+			--count;
+			return item;
+		}
+
+		inline void remove_at(unsigned int bucket_index, size_t item_index) {
+			std::deque<TaskItem> &bucket = buckets[bucket_index];
+			bucket.erase(bucket.begin() + item_index);
+			if (bucket.empty()) {
+				nonempty_mask &= ~(uint64_t(1) << bucket_index);
+			}
+			--count;
+		}
+
+		// Bookkeeping after a caller compacted `buckets[bucket_index]` in place, removing
+		// `removed_count` items
+		inline void notify_removed(unsigned int bucket_index, size_t removed_count) {
+			if (buckets[bucket_index].empty()) {
+				nonempty_mask &= ~(uint64_t(1) << bucket_index);
+			}
+			count -= removed_count;
+		}
+
+		FixedArray<std::deque<TaskItem>, BUCKET_COUNT> buckets;
+		uint64_t nonempty_mask = 0;
+		size_t count = 0;
 	};
 
 	struct ThreadData {
@@ -91,6 +298,17 @@ private:
 		State debug_state = STATE_STOPPED;
 		std::string name;
 
+		BucketedTaskQueue local_tasks;
+		Mutex local_tasks_mutex;
+
+		// Reserved workers only run latency-critical tasks, see `set_qos_reservation_enabled`
+		bool reserved_for_critical = false;
+
+		// Finished tasks this worker produced, consumed by `dequeue_completed_tasks`.
+		// Wait-free for the worker; when full (consumer not draining fast enough), the worker
+		// falls back to the shared mutex-protected list.
+		SpscRing<IThreadedTask *, 256> completed_ring;
+
 		void wait_to_finish_and_reset() {
 			thread.wait_to_finish();
 			pool = nullptr;
@@ -104,28 +322,86 @@ private:
 
 	static void thread_func_static(void *p_data);
 	void thread_func(ThreadData &data);
+	void thread_func_work_stealing(ThreadData &data);
+
+	static void priority_refresh_thread_func_static(void *p_data);
+	void priority_refresh_thread_func();
+	// Refreshes one queue in bounded slices, collecting cancelled tasks and lazily migrating
+	// tasks whose bucket changed. When `out_promoted` is non-null, tasks whose QoS class
+	// re-evaluates to latency-critical are moved out of the queue into it (see
+	// `set_qos_reservation_enabled`): the class is sampled at enqueue, so work queued while its
+	// block was far away would otherwise stay behind the whole bulk backlog even once a viewer
+	// stands on it.
+	void refresh_queue_priorities(BucketedTaskQueue &queue, Mutex &mutex, uint64_t now,
+			std::vector<IThreadedTask *> &cancelled, std::vector<TaskItem> *out_promoted);
+
+	// Moves up to `count` of the best-priority tasks from `queue` into `out_tasks`.
+	// Cancelled tasks encountered while re-polling priorities are moved into `out_cancelled`.
+	// The caller must hold the lock protecting `queue`.
+	uint64_t get_group_service_count(uint32_t group) const;
+
+	void pick_best_tasks(BucketedTaskQueue &queue, std::vector<TaskItem> &out_tasks,
+			std::vector<IThreadedTask *> &out_cancelled, uint32_t count, uint64_t now);
 
 	void create_thread(ThreadData &d, uint32_t i);
 	void destroy_all_threads();
+	void start_priority_refresh_thread_if_enabled();
 
 	FixedArray<ThreadData, MAX_THREADS> _threads;
 	uint32_t _thread_count = 0;
 
-	// TODO Optimization: use a less naive design? Maybe moodycamel
-	std::vector<TaskItem> _tasks;
+	BucketedTaskQueue _tasks;
 	Mutex _tasks_mutex;
 	Semaphore _tasks_semaphore;
 
+	// Latency-critical tasks, see `set_qos_reservation_enabled`.
+	// Reserved workers wait on the dedicated semaphore so a wakeup meant for a bulk task is
+	// never consumed by a worker that won't take it.
+	BucketedTaskQueue _critical_tasks;
+	Mutex _critical_tasks_mutex;
+	Semaphore _critical_tasks_semaphore;
+	bool _qos_reservation_enabled = false;
+
 	std::vector<IThreadedTask *> _completed_tasks;
 	Mutex _completed_tasks_mutex;
 
-	uint32_t _batch_count = 1;
-	uint32_t _priority_update_period = 32;
+	// Atomic because the auto-tuner adjusts them while workers read them; exact timing of the
+	// change being observed doesn't matter
+	std::atomic_uint32_t _batch_count = { 1 };
+	std::atomic_uint32_t _priority_update_period = { 32 };
+
+	// Service-time accumulation for the auto-tuner, written by workers with relaxed atomics
+	std::atomic_uint64_t _service_time_accum_usec = { 0 };
+	std::atomic_uint64_t _service_task_count = { 0 };
+	std::atomic_uint32_t _mean_task_time_usec = { 0 };
+	bool _auto_tuning_enabled = false;
+
+	bool _work_stealing_enabled = false;
+	bool _thread_pinning_enabled = false;
+	bool _priority_refresh_thread_enabled = false;
+	// Owned by the refresh thread; set to ask it to exit
+	std::atomic_bool _priority_refresh_thread_stop = { false };
+	Thread _priority_refresh_thread;
+	bool _priority_refresh_thread_running = false;
+	// Round-robin cursor for distributing incoming tasks over per-thread queues
+	std::atomic_uint32_t _next_enqueue_thread_index = { 0 };
 
 	std::string _name;
 
-	unsigned int _debug_received_tasks = 0;
-	unsigned int _debug_completed_tasks = 0;
+	// Atomic: enqueues increment it under different locks (per-thread queues in work-stealing
+	// mode) or none at all, and the auto-tuner reads the derived pending count concurrently
+	std::atomic_uint32_t _debug_received_tasks = { 0 };
+	// Incremented concurrently by workers outside any lock since ring delivery, so it's atomic
+	std::atomic_uint32_t _debug_completed_tasks = { 0 };
+	std::atomic_uint32_t _consumed_completed_tasks = { 0 };
+
+	std::atomic_uint64_t _executed_task_count = { 0 };
+	std::atomic_uint64_t _dropped_task_count = { 0 };
+	std::atomic_uint64_t _starved_task_count = { 0 };
+
+	// Accumulated service per fairness group; only touched under the queue lock during pickup
+	std::unordered_map<uint32_t, uint64_t> _group_service_counts;
+	bool _fair_grouping_enabled = false;
 };
 
 } // namespace zylann
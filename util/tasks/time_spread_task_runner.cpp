@@ -10,55 +10,87 @@ TimeSpreadTaskRunner::~TimeSpreadTaskRunner() {
 	flush();
 }
 
-void TimeSpreadTaskRunner::push(ITimeSpreadTask *task) {
+void TimeSpreadTaskRunner::push(ITimeSpreadTask *task, Priority priority) {
 	MutexLock lock(_tasks_mutex);
-	_tasks.push(task);
+	_lanes[priority].tasks.push(task);
 }
 
-void TimeSpreadTaskRunner::push(Span<ITimeSpreadTask *> tasks) {
+void TimeSpreadTaskRunner::push(Span<ITimeSpreadTask *> tasks, Priority priority) {
 	MutexLock lock(_tasks_mutex);
 	for (unsigned int i = 0; i < tasks.size(); ++i) {
-		_tasks.push(tasks[i]);
+		_lanes[priority].tasks.push(tasks[i]);
 	}
 }
 
-void TimeSpreadTaskRunner::process(uint64_t time_budget_usec) {
+uint64_t TimeSpreadTaskRunner::process(uint64_t time_budget_usec) {
 	ZN_PROFILE_SCOPE();
 	const Time &time = *Time::get_singleton();
 
-	static thread_local std::vector<ITimeSpreadTask *> tls_postponed_tasks;
-	ZN_ASSERT(tls_postponed_tasks.size() == 0);
+	static thread_local FixedArray<std::vector<ITimeSpreadTask *>, PRIORITY_COUNT> tls_postponed_tasks;
 
 	const uint64_t time_before = time.get_ticks_usec();
 
-	// Do at least one task
-	do {
-		ITimeSpreadTask *task;
-		{
-			MutexLock lock(_tasks_mutex);
-			if (_tasks.size() == 0) {
+	// Lanes run in priority order, each getting what remains of the budget. Under a burst, the
+	// high lane is served first, so it's the low lanes whose tasks slip to the next frames.
+	for (unsigned int lane_index = 0; lane_index < PRIORITY_COUNT; ++lane_index) {
+		Lane &lane = _lanes[lane_index];
+		ZN_ASSERT(tls_postponed_tasks[lane_index].size() == 0);
+		bool lane_task_done = false;
+
+		while (true) {
+			const uint64_t time_spent = time.get_ticks_usec() - time_before;
+			// Don't start a task when past the budget, but also don't start one when the lane's
+			// average task is expected to blow past it: overshooting by one heavy task is exactly
+			// the hitch this runner exists to avoid. Each non-empty lane still runs at least one
+			// task per call, so low lanes can't be starved forever by a saturated high lane; the
+			// resulting overshoot is the caller's to account for (see the returned value).
+			if (lane_task_done && time_spent + lane.mean_task_time_usec >= time_budget_usec) {
 				break;
 			}
-			task = _tasks.front();
-			_tasks.pop();
-		}
 
-		TimeSpreadTaskContext ctx;
-		task->run(ctx);
+			ITimeSpreadTask *task;
+			{
+				MutexLock lock(_tasks_mutex);
+				if (lane.tasks.size() == 0) {
+					break;
+				}
+				task = lane.tasks.front();
+				lane.tasks.pop();
+			}
 
-		if (ctx.postpone) {
-			tls_postponed_tasks.push_back(task);
-		} else {
-			// TODO Call recycling function instead?
-			ZN_DELETE(task);
-		}
+			const uint64_t task_time_before = time.get_ticks_usec();
+
+			TimeSpreadTaskContext ctx;
+			task->run(ctx);
+
+			if (ctx.postpone) {
+				tls_postponed_tasks[lane_index].push_back(task);
+			} else {
+				// TODO Call recycling function instead?
+				ZN_DELETE(task);
+			}
 
-	} while (time.get_ticks_usec() - time_before < time_budget_usec);
+			const uint64_t task_duration = time.get_ticks_usec() - task_time_before;
+			lane.time_spent_usec += task_duration;
+			// Not locked: only written here and only read for diagnostics and budget prediction
+			if (lane.mean_task_time_usec == 0) {
+				lane.mean_task_time_usec = task_duration;
+			} else {
+				lane.mean_task_time_usec += (int64_t(task_duration) - int64_t(lane.mean_task_time_usec)) / 4;
+			}
+			lane_task_done = true;
+		}
+	}
 
-	if (tls_postponed_tasks.size() > 0) {
-		push(to_span(tls_postponed_tasks));
-		tls_postponed_tasks.clear();
+	for (unsigned int lane_index = 0; lane_index < PRIORITY_COUNT; ++lane_index) {
+		std::vector<ITimeSpreadTask *> &postponed_tasks = tls_postponed_tasks[lane_index];
+		if (postponed_tasks.size() > 0) {
+			push(to_span(postponed_tasks), Priority(lane_index));
+			postponed_tasks.clear();
+		}
 	}
+
+	return time.get_ticks_usec() - time_before;
 }
 
 void TimeSpreadTaskRunner::flush() {
@@ -72,7 +104,24 @@ void TimeSpreadTaskRunner::flush() {
 
 unsigned int TimeSpreadTaskRunner::get_pending_count() const {
 	MutexLock lock(_tasks_mutex);
-	return _tasks.size();
+	unsigned int count = 0;
+	for (unsigned int lane_index = 0; lane_index < PRIORITY_COUNT; ++lane_index) {
+		count += _lanes[lane_index].tasks.size();
+	}
+	return count;
+}
+
+unsigned int TimeSpreadTaskRunner::get_pending_count(Priority priority) const {
+	MutexLock lock(_tasks_mutex);
+	return _lanes[priority].tasks.size();
+}
+
+uint64_t TimeSpreadTaskRunner::get_lane_time_spent_usec(Priority priority) const {
+	return _lanes[priority].time_spent_usec;
+}
+
+unsigned int TimeSpreadTaskRunner::get_lane_mean_task_time_usec(Priority priority) const {
+	return _lanes[priority].mean_task_time_usec;
 }
 
 } // namespace zylann
@@ -1,6 +1,7 @@
 #ifndef ZYLANN_TIME_SPREAD_TASK_RUNNER_H
 #define ZYLANN_TIME_SPREAD_TASK_RUNNER_H
 
+#include "../fixed_array.h"
 #include "../span.h"
 #include "../thread/mutex.h"
 #include <cstdint>
@@ -24,19 +25,44 @@ public:
 // Runs tasks in the caller thread, within a time budget per call. Kind of like coroutines.
 class TimeSpreadTaskRunner {
 public:
+	// Lanes are drained in order, so when the budget runs out under a burst of tasks, low-priority
+	// work is what gets delayed to later frames.
+	enum Priority { //
+		PRIORITY_HIGH = 0,
+		PRIORITY_NORMAL,
+		PRIORITY_LOW,
+		PRIORITY_COUNT
+	};
+
 	~TimeSpreadTaskRunner();
 
 	// Pushing is thread-safe.
-	void push(ITimeSpreadTask *task);
-	void push(Span<ITimeSpreadTask *> tasks);
+	void push(ITimeSpreadTask *task, Priority priority = PRIORITY_NORMAL);
+	void push(Span<ITimeSpreadTask *> tasks, Priority priority = PRIORITY_NORMAL);
 
-	void process(uint64_t time_budget_usec);
+	// Returns how much time was actually spent, which can exceed the budget (by up to one task
+	// per lane, since non-empty lanes are never starved completely).
+	uint64_t process(uint64_t time_budget_usec);
 	void flush();
 	unsigned int get_pending_count() const;
+	unsigned int get_pending_count(Priority priority) const;
+
+	// Total time spent running tasks of that lane, over the runner's lifetime
+	uint64_t get_lane_time_spent_usec(Priority priority) const;
+	// Exponential moving average of one task's duration in that lane. Used to predict whether
+	// starting one more task would overrun the budget, instead of only noticing afterward.
+	unsigned int get_lane_mean_task_time_usec(Priority priority) const;
 
 private:
+	struct Lane {
+		std::queue<ITimeSpreadTask *> tasks;
+		uint64_t time_spent_usec = 0;
+		// EMA of task durations. Integer microseconds are plenty of resolution here.
+		unsigned int mean_task_time_usec = 0;
+	};
+
 	// TODO Optimization: naive thread safety. Should be enough for now.
-	std::queue<ITimeSpreadTask *> _tasks;
+	FixedArray<Lane, PRIORITY_COUNT> _lanes;
 	BinaryMutex _tasks_mutex;
 };
 
@@ -0,0 +1,58 @@
+#ifndef ZYLANN_SPSC_RING_H
+#define ZYLANN_SPSC_RING_H
+
+#include "../fixed_array.h"
+#include <atomic>
+
+namespace zylann {
+
+// Bounded wait-free single-producer single-consumer ring buffer.
+// One thread may push, one (other) thread may pop; no locks are taken on either side.
+// Head and tail live on their own cache lines so the producer and consumer don't false-share.
+// Capacity must be a power of two.
+template <typename T, unsigned int CAPACITY_T>
+class SpscRing {
+public:
+	static const unsigned int CAPACITY = CAPACITY_T;
+	static_assert((CAPACITY & (CAPACITY - 1)) == 0, "Capacity must be a power of two");
+
+	// May only be called from the producer thread. Returns false when the ring is full.
+	bool try_push(const T &value) {
+		const uint32_t head = _head.load(std::memory_order_relaxed);
+		const uint32_t tail = _tail.load(std::memory_order_acquire);
+		if (head - tail == CAPACITY) {
+			return false;
+		}
+		_items[head & (CAPACITY - 1)] = value;
+		_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// May only be called from the consumer thread. Returns false when the ring is empty.
+	bool try_pop(T &out_value) {
+		const uint32_t tail = _tail.load(std::memory_order_relaxed);
+		const uint32_t head = _head.load(std::memory_order_acquire);
+		if (tail == head) {
+			return false;
+		}
+		out_value = _items[tail & (CAPACITY - 1)];
+		_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Approximate when called while the producer is active
+	bool is_empty() const {
+		return _tail.load(std::memory_order_acquire) == _head.load(std::memory_order_acquire);
+	}
+
+private:
+	FixedArray<T, CAPACITY> _items;
+	// Written by the producer, read by the consumer
+	alignas(64) std::atomic_uint32_t _head = { 0 };
+	// Written by the consumer, read by the producer
+	alignas(64) std::atomic_uint32_t _tail = { 0 };
+};
+
+} // namespace zylann
+
+#endif // ZYLANN_SPSC_RING_H